@@ -39,7 +39,9 @@ public class AsyncLoadingScreen : ModuleRules
 				"Slate",
 				"SlateCore",
 				"MoviePlayer",
-				"DeveloperSettings"
+				"DeveloperSettings",
+				"RHI",
+				"RenderCore"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
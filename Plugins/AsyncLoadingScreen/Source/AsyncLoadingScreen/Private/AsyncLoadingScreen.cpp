@@ -15,14 +15,39 @@
 #include "SSidebarLayout.h"
 #include "SDualSidebarLayout.h"
 #include "Framework/Application/SlateApplication.h"
+#include "Fonts/FontCache.h"
+#include "Rendering/SlateRenderer.h"
 #include "AsyncLoadingScreenLibrary.h"
 #include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "CanvasItem.h"
+#include "CanvasTypes.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "Tasks/Task.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "UObject/UObjectGlobals.h"
 
 #define LOCTEXT_NAMESPACE "FAsyncLoadingScreenModule"
 
+DECLARE_STATS_GROUP(TEXT("AsyncLoadingScreen"), STATGROUP_AsyncLoadingScreen, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Setup Loading Screen"), STAT_SetupLoadingScreen, STATGROUP_AsyncLoadingScreen);
+DECLARE_CYCLE_STAT(TEXT("Construct Widgets"), STAT_ConstructLoadingWidgets, STATGROUP_AsyncLoadingScreen);
+DECLARE_CYCLE_STAT(TEXT("Wait For Background Image"), STAT_WaitForBackgroundImage, STATGROUP_AsyncLoadingScreen);
+DECLARE_CYCLE_STAT(TEXT("Setup Movie Player"), STAT_SetupMoviePlayer, STATGROUP_AsyncLoadingScreen);
+DECLARE_CYCLE_STAT(TEXT("Prewarm Font Cache"), STAT_PrewarmFontCache, STATGROUP_AsyncLoadingScreen);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Setup (ms)"), STAT_LastSetupTime, STATGROUP_AsyncLoadingScreen);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Map Load (ms)"), STAT_LastMapLoadTime, STATGROUP_AsyncLoadingScreen);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Screen Shown (ms)"), STAT_LastScreenShownTime, STATGROUP_AsyncLoadingScreen);
+
 void FAsyncLoadingScreenModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	TRACE_CPUPROFILER_EVENT_SCOPE(PluginStartup_AsyncLoadingScreen);
+
 	if (!IsRunningDedicatedServer() && FSlateApplication::IsInitialized())
 	{
 		const ULoadingScreenSettings* Settings = GetDefault<ULoadingScreenSettings>();
@@ -30,18 +55,35 @@ void FAsyncLoadingScreenModule::StartupModule()
 		if (IsMoviePlayerEnabled())
 		{
 			GetMoviePlayer()->OnPrepareLoadingScreen().AddRaw(this, &FAsyncLoadingScreenModule::PreSetupLoadingScreen);				
+			GetMoviePlayer()->OnMoviePlaybackFinished().AddRaw(this, &FAsyncLoadingScreenModule::OnLoadingScreenFinished);
 		}		
+
+		FCoreUObjectDelegates::PreLoadMap.AddRaw(this, &FAsyncLoadingScreenModule::OnPreLoadMap);
+		FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FAsyncLoadingScreenModule::OnPostLoadMap);
 		
-		// If PreloadBackgroundImages option is check, load all background images into memory
+		StreamableManager = MakeUnique<FStreamableManager>();
+
+		// Only the startup screen's image is needed now, the default screen's one streams in while the game starts
+		StartupBackgroundIndex = PickBackgroundIndex(Settings->StartupLoadingScreen.Background);
+		RequestBackgroundImage(GetPickedImagePath(true), true);
+		SelectNextBackgroundImage();
+
+		// If PreloadBackgroundImages option is check, stream all background images into memory
 		if (Settings->bPreloadBackgroundImages)
 		{
 			LoadBackgroundImages();
 		}
 
+		// Before the startup screen is set up, once the movie player runs the loading thread uses the font cache too
+		PrewarmFontCache(Settings->StartupLoadingScreen);
+		PrewarmFontCache(Settings->DefaultLoadingScreen);
+
 		// Prepare the startup screen, the PreSetupLoadingScreen callback won't be called
 		// if we've already explicitly setup the loading screen
 		bIsStartupLoadingScreen = true;
 		SetupLoadingScreen(Settings->StartupLoadingScreen);
+
+		PrefetchNextMovies();
 	}	
 }
 
@@ -53,7 +95,16 @@ void FAsyncLoadingScreenModule::ShutdownModule()
 	{
 		// TODO: Unregister later
 		GetMoviePlayer()->OnPrepareLoadingScreen().RemoveAll(this);
+		GetMoviePlayer()->OnMoviePlaybackFinished().RemoveAll(this);
 	}
+	FCoreUObjectDelegates::PreLoadMap.RemoveAll(this);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
+
+	BackgroundImages.Empty();
+	PreloadHandle.Reset();
+	StreamableManager.Reset();
+	ImageSequenceAtlases.Empty();
+	LayoutWidgets.Empty();
 }
 
 bool FAsyncLoadingScreenModule::IsGameModule() const
@@ -61,9 +112,125 @@ bool FAsyncLoadingScreenModule::IsGameModule() const
 	return true;
 }
 
-TArray<UTexture2D*> FAsyncLoadingScreenModule::GetBackgroundImages()
+UTexture2D* FAsyncLoadingScreenModule::GetSelectedBackgroundImage(const FBackgroundSettings& Settings)
 {
-	return bIsStartupLoadingScreen ? StartupBackgroundImages : DefaultBackgroundImages;
+	int32& SelectedIndex = bIsStartupLoadingScreen ? StartupBackgroundIndex : DefaultBackgroundIndex;
+	if (!Settings.Images.IsValidIndex(SelectedIndex))
+	{
+		SelectedIndex = PickBackgroundIndex(Settings);
+		if (SelectedIndex == INDEX_NONE)
+		{
+			return nullptr;
+		}
+	}
+
+	const FSoftObjectPath& ImagePath = Settings.Images[SelectedIndex];
+	RequestBackgroundImage(ImagePath, true);
+	const int32 Found = BackgroundImages.IndexOfByPredicate([&ImagePath](const FBackgroundImage& Image) { return Image.Path == ImagePath; });
+	// A copy, the completion callback may reorder the images while this waits
+	const TSharedPtr<FStreamableHandle> Handle = Found != INDEX_NONE ? BackgroundImages[Found].Handle : nullptr;
+	if (!Handle.IsValid())
+	{
+		return nullptr;
+	}
+	if (Handle->IsLoadingInProgress())
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(AsyncLoadingScreen_WaitForBackgroundImage);
+		SCOPE_CYCLE_COUNTER(STAT_WaitForBackgroundImage);
+		const double WaitStart = FPlatformTime::Seconds();
+		Handle->WaitUntilComplete();
+		Timing.ImageSeconds += FPlatformTime::Seconds() - WaitStart;
+	}
+	return Cast<UTexture2D>(Handle->GetLoadedAsset());
+}
+
+UTextureRenderTarget2D* FAsyncLoadingScreenModule::GetImageSequenceAtlas(const FImageSequenceSettings& Settings, int32& OutColumns, int32& OutRows)
+{
+	TArray<UTexture2D*> Frames;
+	FString Key;
+	for (UTexture2D* Image : Settings.Images)
+	{
+		if (Image && Image->GetResource())
+		{
+			Frames.Add(Image);
+			Key += Image->GetPathName() + TEXT(";");
+		}
+	}
+	if (Frames.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	if (const FImageSequenceAtlas* Found = ImageSequenceAtlases.Find(Key))
+	{
+		OutColumns = Found->Columns;
+		OutRows = Found->Rows;
+		return Found->Texture.Get();
+	}
+
+	// A grid as close to square as the frame count allows, every cell the size of the first frame
+	const int32 CellWidth = FMath::Max(FMath::RoundToInt(Frames[0]->GetSurfaceWidth()), 1);
+	const int32 CellHeight = FMath::Max(FMath::RoundToInt(Frames[0]->GetSurfaceHeight()), 1);
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Frames.Num())));
+	const int32 Rows = FMath::DivideAndRoundUp(Frames.Num(), Columns);
+	const int32 MaxSize = static_cast<int32>(GetMax2DTextureDimension());
+	if (Columns * CellWidth > MaxSize || Rows * CellHeight > MaxSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Loading icon image sequence is too large for one %d x %d texture, it plays frame by frame"), MaxSize, MaxSize);
+		return nullptr;
+	}
+
+	UTextureRenderTarget2D* Atlas = NewObject<UTextureRenderTarget2D>(GetTransientPackage());
+	Atlas->RenderTargetFormat = RTF_RGBA8_SRGB;
+	Atlas->ClearColor = FLinearColor::Transparent;
+	Atlas->InitAutoFormat(Columns * CellWidth, Rows * CellHeight);
+	Atlas->UpdateResourceImmediate(true);
+
+	// Drawn once on the GPU, the frames never have to be read back on the CPU
+	FCanvas Canvas(Atlas->GameThread_GetRenderTargetResource(), nullptr, FGameTime::GetTimeSinceAppStart(), GMaxRHIFeatureLevel);
+	for (int32 Index = 0; Index < Frames.Num(); ++Index)
+	{
+		const FVector2D Position((Index % Columns) * CellWidth, (Index / Columns) * CellHeight);
+		FCanvasTileItem Tile(Position, Frames[Index]->GetResource(), FVector2D(CellWidth, CellHeight), FLinearColor::White);
+		Tile.BlendMode = SE_BLEND_Opaque;
+		Canvas.DrawItem(Tile);
+	}
+	Canvas.Flush_GameThread(true);
+
+	FImageSequenceAtlas& Entry = ImageSequenceAtlases.Add(Key);
+	Entry.Texture.Reset(Atlas);
+	Entry.Columns = Columns;
+	Entry.Rows = Rows;
+	OutColumns = Columns;
+	OutRows = Rows;
+	return Atlas;
+}
+
+void FAsyncLoadingScreenModule::SelectNextBackgroundImage()
+{
+	DefaultBackgroundIndex = PickBackgroundIndex(GetDefault<ULoadingScreenSettings>()->DefaultLoadingScreen.Background);
+	RequestBackgroundImage(GetPickedImagePath(false), false);
+}
+
+int32 FAsyncLoadingScreenModule::PickBackgroundIndex(const FBackgroundSettings& Settings) const
+{
+	if (Settings.Images.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+	if (Settings.bSetDisplayBackgroundManually && Settings.Images.IsValidIndex(UAsyncLoadingScreenLibrary::GetDisplayBackgroundIndex()))
+	{
+		return UAsyncLoadingScreenLibrary::GetDisplayBackgroundIndex();
+	}
+	return FMath::RandRange(0, Settings.Images.Num() - 1);
+}
+
+FSoftObjectPath FAsyncLoadingScreenModule::GetPickedImagePath(bool bIsStartup) const
+{
+	const ULoadingScreenSettings* Settings = GetDefault<ULoadingScreenSettings>();
+	const TArray<FSoftObjectPath>& Images = bIsStartup ? Settings->StartupLoadingScreen.Background.Images : Settings->DefaultLoadingScreen.Background.Images;
+	const int32 Index = bIsStartup ? StartupBackgroundIndex : DefaultBackgroundIndex;
+	return Images.IsValidIndex(Index) ? Images[Index] : FSoftObjectPath();
 }
 
 void FAsyncLoadingScreenModule::PreSetupLoadingScreen()
@@ -75,10 +242,318 @@ void FAsyncLoadingScreenModule::PreSetupLoadingScreen()
 		const ULoadingScreenSettings* Settings = GetDefault<ULoadingScreenSettings>();
 		bIsStartupLoadingScreen = false;
 		SetupLoadingScreen(Settings->DefaultLoadingScreen);
+
+		// The widget holds its image now; pick the next screen's one and give it the whole level to stream in
+		SelectNextBackgroundImage();
 	}	
 }
 
 void FAsyncLoadingScreenModule::SetupLoadingScreen(const FALoadingScreenSettings& LoadingScreenSettings)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AsyncLoadingScreen_SetupLoadingScreen);
+	SCOPE_CYCLE_COUNTER(STAT_SetupLoadingScreen);
+	TRACE_BOOKMARK(TEXT("Loading screen shown"));
+
+	// The map name may already be known from PreLoadMap, everything else starts over
+	const FString MapName = bIsTimingLoadingScreen ? Timing.MapName : FString();
+	Timing = FLoadingScreenTiming();
+	Timing.MapName = MapName;
+	Timing.bIsStartup = bIsStartupLoadingScreen;
+	Timing.StartTime = FPlatformTime::Seconds();
+	bIsTimingLoadingScreen = true;
+
+	// The default screen's order may have been decided, and its first movie read, while the last level was playing
+	TArray<FString> MoviesList;
+	if (!bIsStartupLoadingScreen && bHasNextMoviesList && LoadingScreenSettings.bPrefetchMovies)
+	{
+		MoviesList = MoveTemp(NextMoviesList);
+	}
+	else
+	{
+		MoviesList = ResolveMoviesList(LoadingScreenSettings);
+	}
+	bHasNextMoviesList = false;
+
+	FLoadingScreenAttributes LoadingScreen;
+	LoadingScreen.MinimumLoadingScreenDisplayTime = LoadingScreenSettings.MinimumLoadingScreenDisplayTime;
+	LoadingScreen.bAutoCompleteWhenLoadingCompletes = LoadingScreenSettings.bAutoCompleteWhenLoadingCompletes;
+	LoadingScreen.bMoviesAreSkippable = LoadingScreenSettings.bMoviesAreSkippable;
+	LoadingScreen.bWaitForManualStop = LoadingScreenSettings.bWaitForManualStop;
+	LoadingScreen.bAllowInEarlyStartup = LoadingScreenSettings.bAllowInEarlyStartup;
+	LoadingScreen.bAllowEngineTick = LoadingScreenSettings.bAllowEngineTick;
+	LoadingScreen.MoviePaths = MoviesList;
+	LoadingScreen.PlaybackType = LoadingScreenSettings.PlaybackType;
+
+	if (LoadingScreenSettings.bShowWidgetOverlay)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(AsyncLoadingScreen_ConstructWidgets);
+		SCOPE_CYCLE_COUNTER(STAT_ConstructLoadingWidgets);
+		const double WidgetStart = FPlatformTime::Seconds();
+		LoadingScreen.WidgetLoadingScreen = GetLayoutWidget(LoadingScreenSettings);
+		
+		// Includes waiting for the background image, which is also reported on its own
+		Timing.WidgetSeconds = FPlatformTime::Seconds() - WidgetStart;
+	}
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(AsyncLoadingScreen_SetupMoviePlayer);
+		SCOPE_CYCLE_COUNTER(STAT_SetupMoviePlayer);
+		const double MovieStart = FPlatformTime::Seconds();
+		GetMoviePlayer()->SetupLoadingScreen(LoadingScreen);
+		Timing.MovieSeconds = FPlatformTime::Seconds() - MovieStart;
+	}
+
+	SET_FLOAT_STAT(STAT_LastSetupTime, (FPlatformTime::Seconds() - Timing.StartTime) * 1000.0);
+}
+
+void FAsyncLoadingScreenModule::PrewarmFontCache(const FALoadingScreenSettings& LoadingScreenSettings) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AsyncLoadingScreen_PrewarmFontCache);
+	SCOPE_CYCLE_COUNTER(STAT_PrewarmFontCache);
+
+	FSlateRenderer* Renderer = FSlateApplication::Get().GetRenderer();
+	if (!Renderer || !LoadingScreenSettings.bShowWidgetOverlay)
+	{
+		return;
+	}
+
+	const TSharedRef<FSlateFontCache> FontCache = Renderer->GetFontCache();
+	const float FontScale = FSlateApplication::Get().GetApplicationScale();
+
+	auto PrewarmText = [&FontCache, FontScale](const FString& Text, const FSlateFontInfo& Font)
+	{
+		if (Text.IsEmpty() || !Font.HasValidFont())
+		{
+			return;
+		}
+
+		const FShapedGlyphSequenceRef ShapedText = FontCache->ShapeBidirectionalText(Text, Font, FontScale, TextBiDi::ComputeBaseDirection(Text), GetDefaultTextShapingMethod());
+		for (const FShapedGlyphEntry& Glyph : ShapedText->GetGlyphsToRender())
+		{
+			if (!Glyph.bIsVisible)
+			{
+				continue;
+			}
+
+			FontCache->GetShapedGlyphFontAtlasData(Glyph, FFontOutlineSettings::NoOutline);
+
+			// Outlined text is drawn from glyphs of their own under the plain ones
+			if (Font.OutlineSettings.OutlineSize > 0)
+			{
+				FontCache->GetShapedGlyphFontAtlasData(Glyph, Font.OutlineSettings);
+			}
+		}
+	};
+
+	// Any tip may be picked, so all of them are shaped, as one string since they share a font
+	const FString AllTips = FString::JoinBy(LoadingScreenSettings.TipWidget.TipText, TEXT(" "), [](const FText& Tip) { return Tip.ToString(); });
+	PrewarmText(AllTips, LoadingScreenSettings.TipWidget.Appearance.Font);
+	PrewarmText(LoadingScreenSettings.LoadingWidget.LoadingText.ToString(), LoadingScreenSettings.LoadingWidget.Appearance.Font);
+
+	if (LoadingScreenSettings.bShowLoadingCompleteText)
+	{
+		PrewarmText(LoadingScreenSettings.LoadingCompleteTextSettings.LoadingCompleteText.ToString(), LoadingScreenSettings.LoadingCompleteTextSettings.Appearance.Font);
+	}
+}
+
+TSharedPtr<SLoadingScreenLayout> FAsyncLoadingScreenModule::GetLayoutWidget(const FALoadingScreenSettings& LoadingScreenSettings)
+{
+	const ULoadingScreenSettings* Settings = GetDefault<ULoadingScreenSettings>();
+
+	// The exported text covers every property, so any edit to the screen or its layout builds a new tree
+	auto HashSettings = [](const UScriptStruct* Struct, const void* Data)
+	{
+		FString Text;
+		Struct->ExportText(Text, Data, nullptr, nullptr, PPF_None, nullptr);
+		return GetTypeHash(Text);
+	};
+	uint32 Hash = HashCombine(HashSettings(FALoadingScreenSettings::StaticStruct(), &LoadingScreenSettings), GetTypeHash(LoadingScreenSettings.Layout));
+	switch (LoadingScreenSettings.Layout)
+	{
+	case EAsyncLoadingScreenLayout::ALSL_Classic:
+		Hash = HashCombine(Hash, HashSettings(FClassicLayoutSettings::StaticStruct(), &Settings->Classic));
+		break;
+	case EAsyncLoadingScreenLayout::ALSL_Center:
+		Hash = HashCombine(Hash, HashSettings(FCenterLayoutSettings::StaticStruct(), &Settings->Center));
+		break;
+	case EAsyncLoadingScreenLayout::ALSL_Letterbox:
+		Hash = HashCombine(Hash, HashSettings(FLetterboxLayoutSettings::StaticStruct(), &Settings->Letterbox));
+		break;
+	case EAsyncLoadingScreenLayout::ALSL_Sidebar:
+		Hash = HashCombine(Hash, HashSettings(FSidebarLayoutSettings::StaticStruct(), &Settings->Sidebar));
+		break;
+	case EAsyncLoadingScreenLayout::ALSL_DualSidebar:
+		Hash = HashCombine(Hash, HashSettings(FDualSidebarLayoutSettings::StaticStruct(), &Settings->DualSidebar));
+		break;
+	}
+
+	// Reuse the tree, only the background image and the tip are picked again
+	if (const TSharedRef<SLoadingScreenLayout>* Found = LayoutWidgets.Find(Hash))
+	{
+		(*Found)->Refresh(LoadingScreenSettings);
+		return *Found;
+	}
+
+	TSharedPtr<SLoadingScreenLayout> Layout;
+	switch (LoadingScreenSettings.Layout)
+	{
+	case EAsyncLoadingScreenLayout::ALSL_Classic:
+		Layout = SNew(SClassicLayout, LoadingScreenSettings, Settings->Classic);
+		break;
+	case EAsyncLoadingScreenLayout::ALSL_Center:
+		Layout = SNew(SCenterLayout, LoadingScreenSettings, Settings->Center);
+		break;
+	case EAsyncLoadingScreenLayout::ALSL_Letterbox:
+		Layout = SNew(SLetterboxLayout, LoadingScreenSettings, Settings->Letterbox);
+		break;
+	case EAsyncLoadingScreenLayout::ALSL_Sidebar:
+		Layout = SNew(SSidebarLayout, LoadingScreenSettings, Settings->Sidebar);
+		break;
+	case EAsyncLoadingScreenLayout::ALSL_DualSidebar:
+		Layout = SNew(SDualSidebarLayout, LoadingScreenSettings, Settings->DualSidebar);
+		break;
+	}
+
+	if (Layout.IsValid())
+	{
+		LayoutWidgets.Add(Hash, Layout.ToSharedRef());
+	}
+	return Layout;
+}
+
+void FAsyncLoadingScreenModule::OnPreLoadMap(const FString& MapName)
+{
+	if (!bIsTimingLoadingScreen)
+	{
+		// The loading screen is set up right after this; keep the name for it
+		Timing = FLoadingScreenTiming();
+		bIsTimingLoadingScreen = true;
+	}
+	Timing.MapName = MapName;
+
+	// A transition nobody preloaded for: let go of the last level's assets, and load the configured ones alongside the map,
+	// the map load waits for them so they are in before the first frame
+	if (StreamableManager.IsValid() && (!PreloadHandle.IsValid() || PreloadLevelName != MapName))
+	{
+		if (PreloadHandle.IsValid())
+		{
+			PreloadHandle->ReleaseHandle();
+			PreloadHandle.Reset();
+		}
+
+		PreloadLevelName = MapName;
+
+		const TArray<FSoftObjectPath>& PreloadAssets = GetDefault<ULoadingScreenSettings>()->PreloadAssets;
+		if (PreloadAssets.Num() > 0)
+		{
+			PreloadHandle = StreamableManager->RequestAsyncLoad(PreloadAssets, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+		}
+	}
+}
+
+void FAsyncLoadingScreenModule::PreloadLevel(FName LevelName, const TArray<FSoftObjectPath>& Assets, FStreamableDelegate OnPreloaded)
+{
+	if (!StreamableManager.IsValid())
+	{
+		OnPreloaded.ExecuteIfBound();
+		return;
+	}
+
+	TArray<FSoftObjectPath> ToLoad = Assets;
+	ToLoad.Append(GetDefault<ULoadingScreenSettings>()->PreloadAssets);
+
+	// The map package as its world object, LoadMap then finds it in memory
+	const FString LevelPackage = LevelName.ToString();
+	if (FPackageName::IsValidLongPackageName(LevelPackage))
+	{
+		ToLoad.Add(FSoftObjectPath(LevelPackage + TEXT(".") + FPackageName::GetShortName(LevelPackage)));
+	}
+	else if (!LevelName.IsNone())
+	{
+		UE_LOG(LogTemp, Log, TEXT("PreloadLevel: %s is not a long package name, only its assets are preloaded"), *LevelPackage);
+	}
+
+	ToLoad.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
+
+	// The current level's assets are referenced by the level itself for as long as it needs them
+	if (PreloadHandle.IsValid())
+	{
+		PreloadHandle->ReleaseHandle();
+		PreloadHandle.Reset();
+	}
+
+	PreloadLevelName = LevelPackage;
+
+	if (ToLoad.Num() > 0)
+	{
+		PreloadHandle = StreamableManager->RequestAsyncLoad(ToLoad, OnPreloaded, FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	if (!PreloadHandle.IsValid())
+	{
+		OnPreloaded.ExecuteIfBound();
+	}
+}
+
+float FAsyncLoadingScreenModule::GetPreloadProgress() const
+{
+	return PreloadHandle.IsValid() && PreloadHandle->IsLoadingInProgress() ? PreloadHandle->GetProgress() : 1.0f;
+}
+
+void FAsyncLoadingScreenModule::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	if (bIsTimingLoadingScreen && Timing.StartTime > 0.0 && Timing.MapLoadSeconds < 0.0)
+	{
+		Timing.MapLoadSeconds = FPlatformTime::Seconds() - Timing.StartTime;
+		SET_FLOAT_STAT(STAT_LastMapLoadTime, Timing.MapLoadSeconds * 1000.0);
+		TRACE_BOOKMARK(TEXT("Loading screen map loaded"));
+	}
+}
+
+void FAsyncLoadingScreenModule::OnLoadingScreenFinished()
+{
+	// The next default screen's first movie is read while this level plays
+	PrefetchNextMovies();
+
+	// The cached layouts wait for the next load without holding on to their background images
+	for (const TPair<uint32, TSharedRef<SLoadingScreenLayout>>& Layout : LayoutWidgets)
+	{
+		Layout.Value->ReleaseBackgroundImage();
+	}
+
+	if (!bIsTimingLoadingScreen || Timing.StartTime <= 0.0)
+	{
+		return;
+	}
+	bIsTimingLoadingScreen = false;
+
+	const double ShownSeconds = FPlatformTime::Seconds() - Timing.StartTime;
+	SET_FLOAT_STAT(STAT_LastScreenShownTime, ShownSeconds * 1000.0);
+	TRACE_BOOKMARK(TEXT("Loading screen finished"));
+	UE_LOG(LogTemp, Log, TEXT("Loading screen for %s: widgets %.1f ms (background image %.1f ms), movie player %.1f ms, map load %.1f ms, shown %.1f ms"),
+		Timing.MapName.IsEmpty() ? (Timing.bIsStartup ? TEXT("startup") : TEXT("unknown map")) : *Timing.MapName,
+		Timing.WidgetSeconds * 1000.0, Timing.ImageSeconds * 1000.0, Timing.MovieSeconds * 1000.0, Timing.MapLoadSeconds * 1000.0, ShownSeconds * 1000.0);
+
+	if (!GetDefault<ULoadingScreenSettings>()->bLogLoadingTimes)
+	{
+		return;
+	}
+
+	const FString Filename = FPaths::ProjectLogDir() / TEXT("LoadingScreenTimes.csv");
+	FString Row;
+	if (!FPaths::FileExists(Filename))
+	{
+		Row = TEXT("Date,Map,Startup,WidgetsMs,BackgroundImageMs,MoviePlayerMs,MapLoadMs,ShownMs\n");
+	}
+	Row += FString::Printf(TEXT("%s,%s,%d,%.2f,%.2f,%.2f,%s,%.2f\n"),
+		*FDateTime::Now().ToString(), *Timing.MapName, Timing.bIsStartup ? 1 : 0,
+		Timing.WidgetSeconds * 1000.0, Timing.ImageSeconds * 1000.0, Timing.MovieSeconds * 1000.0,
+		Timing.MapLoadSeconds >= 0.0 ? *FString::Printf(TEXT("%.2f"), Timing.MapLoadSeconds * 1000.0) : TEXT(""),
+		ShownSeconds * 1000.0);
+	FFileHelper::SaveStringToFile(Row, *Filename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+TArray<FString> FAsyncLoadingScreenModule::ResolveMoviesList(const FALoadingScreenSettings& LoadingScreenSettings)
 {
 	TArray<FString> MoviesList = LoadingScreenSettings.MoviePaths;
 
@@ -103,42 +578,56 @@ void FAsyncLoadingScreenModule::SetupLoadingScreen(const FALoadingScreenSettings
 		}
 	}
 
-	FLoadingScreenAttributes LoadingScreen;
-	LoadingScreen.MinimumLoadingScreenDisplayTime = LoadingScreenSettings.MinimumLoadingScreenDisplayTime;
-	LoadingScreen.bAutoCompleteWhenLoadingCompletes = LoadingScreenSettings.bAutoCompleteWhenLoadingCompletes;
-	LoadingScreen.bMoviesAreSkippable = LoadingScreenSettings.bMoviesAreSkippable;
-	LoadingScreen.bWaitForManualStop = LoadingScreenSettings.bWaitForManualStop;
-	LoadingScreen.bAllowInEarlyStartup = LoadingScreenSettings.bAllowInEarlyStartup;
-	LoadingScreen.bAllowEngineTick = LoadingScreenSettings.bAllowEngineTick;
-	LoadingScreen.MoviePaths = MoviesList;
-	LoadingScreen.PlaybackType = LoadingScreenSettings.PlaybackType;
+	return MoviesList;
+}
 
-	if (LoadingScreenSettings.bShowWidgetOverlay)
+void FAsyncLoadingScreenModule::PrefetchNextMovies()
+{
+	const FALoadingScreenSettings& LoadingScreenSettings = GetDefault<ULoadingScreenSettings>()->DefaultLoadingScreen;
+	if (!LoadingScreenSettings.bPrefetchMovies)
 	{
-		const ULoadingScreenSettings* Settings = GetDefault<ULoadingScreenSettings>();
+		return;
+	}
 
-		switch (LoadingScreenSettings.Layout)
-		{
-		case EAsyncLoadingScreenLayout::ALSL_Classic:
-			LoadingScreen.WidgetLoadingScreen = SNew(SClassicLayout, LoadingScreenSettings, Settings->Classic);
-			break;
-		case EAsyncLoadingScreenLayout::ALSL_Center:
-			LoadingScreen.WidgetLoadingScreen = SNew(SCenterLayout, LoadingScreenSettings, Settings->Center);
-			break;
-		case EAsyncLoadingScreenLayout::ALSL_Letterbox:
-			LoadingScreen.WidgetLoadingScreen = SNew(SLetterboxLayout, LoadingScreenSettings, Settings->Letterbox);
-			break;
-		case EAsyncLoadingScreenLayout::ALSL_Sidebar:
-			LoadingScreen.WidgetLoadingScreen = SNew(SSidebarLayout, LoadingScreenSettings, Settings->Sidebar);
-			break;
-		case EAsyncLoadingScreenLayout::ALSL_DualSidebar:
-			LoadingScreen.WidgetLoadingScreen = SNew(SDualSidebarLayout, LoadingScreenSettings, Settings->DualSidebar);
-			break;
-		}
-		
+	// A manually set index may still change before the level opens, only a shuffled or fixed order is safe to decide now
+	if (LoadingScreenSettings.bSetDisplayMovieIndexManually)
+	{
+		bHasNextMoviesList = false;
+		return;
 	}
+	NextMoviesList = ResolveMoviesList(LoadingScreenSettings);
+	bHasNextMoviesList = true;
+	if (NextMoviesList.Num() == 0)
+	{
+		return;
+	}
+
+	// Reading the start of the file is enough for the player to open it and show its first frames without a seek on cold storage
+	const FString MovieName = NextMoviesList[0];
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [MovieName]()
+	{
+		const int64 PrefetchBytes = 4 * 1024 * 1024;
+		const FString MoviesDir = FPaths::ProjectContentDir() / TEXT("Movies");
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(MoviesDir / MovieName + TEXT(".*")), true, false);
+		if (Files.Num() == 0)
+		{
+			return;
+		}
 
-	GetMoviePlayer()->SetupLoadingScreen(LoadingScreen);
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*(MoviesDir / FPaths::GetPath(MovieName) / Files[0])));
+		if (!Reader.IsValid())
+		{
+			return;
+		}
+		TArray<uint8> Buffer;
+		Buffer.SetNumUninitialized(256 * 1024);
+		const int64 Size = FMath::Min(Reader->TotalSize(), PrefetchBytes);
+		for (int64 Offset = 0; Offset < Size; Offset += Buffer.Num())
+		{
+			Reader->Serialize(Buffer.GetData(), FMath::Min<int64>(Buffer.Num(), Size - Offset));
+		}
+	}, LowLevelTasks::ETaskPriority::BackgroundLow);
 }
 
 void FAsyncLoadingScreenModule::ShuffleMovies(TArray<FString>& MoviesList)
@@ -159,36 +648,161 @@ void FAsyncLoadingScreenModule::ShuffleMovies(TArray<FString>& MoviesList)
 
 void FAsyncLoadingScreenModule::LoadBackgroundImages()
 {
-	// Empty all background images array
-	RemoveAllBackgroundImages();
-
 	const ULoadingScreenSettings* Settings = GetDefault<ULoadingScreenSettings>();
-	
-	// Preload startup background images
-	for (auto& Image : Settings->StartupLoadingScreen.Background.Images)
+	bKeepAllBackgroundImages = true;
+
+	// Stream in startup and default background images, none of them blocks
+	for (const FSoftObjectPath& Image : Settings->StartupLoadingScreen.Background.Images)
+	{
+		RequestBackgroundImage(Image, false);
+	}
+	for (const FSoftObjectPath& Image : Settings->DefaultLoadingScreen.Background.Images)
+	{
+		RequestBackgroundImage(Image, false);
+	}
+}
+
+void FAsyncLoadingScreenModule::RemoveAllBackgroundImages()
+{
+	bKeepAllBackgroundImages = false;
+
+	const FSoftObjectPath StartupImage = bIsStartupLoadingScreen ? GetPickedImagePath(true) : FSoftObjectPath();
+	const FSoftObjectPath DefaultImage = GetPickedImagePath(false);
+	for (int32 i = BackgroundImages.Num() - 1; i >= 0; --i)
+	{
+		const FSoftObjectPath& Path = BackgroundImages[i].Path;
+		if (Path != StartupImage && Path != DefaultImage)
+		{
+			if (BackgroundImages[i].Handle.IsValid())
+			{
+				BackgroundImages[i].Handle->ReleaseHandle();
+			}
+			BackgroundImages.RemoveAt(i);
+		}
+	}
+}
+
+void FAsyncLoadingScreenModule::RequestBackgroundImage(const FSoftObjectPath& ImagePath, bool bIsUrgent)
+{
+	if (ImagePath.IsNull() || !StreamableManager.IsValid())
+	{
+		return;
+	}
+
+	const int32 Found = BackgroundImages.IndexOfByPredicate([&ImagePath](const FBackgroundImage& Image) { return Image.Path == ImagePath; });
+	if (Found != INDEX_NONE)
+	{
+		// Most recently used goes last, so the budget releases it last
+		FBackgroundImage Image = MoveTemp(BackgroundImages[Found]);
+		BackgroundImages.RemoveAt(Found);
+		BackgroundImages.Add(MoveTemp(Image));
+		return;
+	}
+
+	StartLoadingBackgroundImage(ImagePath, bIsUrgent ? FStreamableManager::AsyncLoadHighPriority : FStreamableManager::DefaultAsyncLoadPriority, false);
+}
+
+void FAsyncLoadingScreenModule::StartLoadingBackgroundImage(const FSoftObjectPath& ImagePath, int32 Priority, bool bIsPrefetch)
+{
+	// The entry goes in before the request, whose callback may run right away and must not request the image a second time
+	FBackgroundImage Image;
+	Image.Path = ImagePath;
+	if (bIsPrefetch)
+	{
+		BackgroundImages.Insert(MoveTemp(Image), 0);
+	}
+	else
 	{
-		UTexture2D* LoadedImage = Cast<UTexture2D>(Image.TryLoad());
-		if (LoadedImage)
+		BackgroundImages.Add(MoveTemp(Image));
+	}
+
+	const TSharedPtr<FStreamableHandle> Handle = StreamableManager->RequestAsyncLoad(ImagePath, FStreamableDelegate::CreateRaw(this, &FAsyncLoadingScreenModule::OnBackgroundImageLoaded), Priority);
+	const int32 Found = BackgroundImages.IndexOfByPredicate([&ImagePath](const FBackgroundImage& Entry) { return Entry.Path == ImagePath; });
+	if (Found != INDEX_NONE)
+	{
+		BackgroundImages[Found].Handle = Handle;
+	}
+}
+
+void FAsyncLoadingScreenModule::OnBackgroundImageLoaded()
+{
+	TrimBackgroundImages();
+	PrefetchBackgroundImage();
+}
+
+void FAsyncLoadingScreenModule::TrimBackgroundImages()
+{
+	const int32 BudgetMB = GetDefault<ULoadingScreenSettings>()->BackgroundImagesBudgetMB;
+	if (BudgetMB <= 0 || bKeepAllBackgroundImages)
+	{
+		return;
+	}
+
+	int64 ResidentBytes = 0;
+	for (const FBackgroundImage& Image : BackgroundImages)
+	{
+		if (const UTexture2D* Texture = Image.Handle.IsValid() ? Cast<UTexture2D>(Image.Handle->GetLoadedAsset()) : nullptr)
 		{
-			StartupBackgroundImages.Add(LoadedImage);
+			ResidentBytes += Texture->CalcTextureMemorySizeEnum(TMC_ResidentMips);
 		}
 	}
 
-	// Preload default background images
-	for (auto& Image : Settings->DefaultLoadingScreen.Background.Images)
+	const FSoftObjectPath StartupImage = bIsStartupLoadingScreen ? GetPickedImagePath(true) : FSoftObjectPath();
+	const FSoftObjectPath DefaultImage = GetPickedImagePath(false);
+	const int64 BudgetBytes = static_cast<int64>(BudgetMB) * 1024 * 1024;
+	for (int32 i = 0; i < BackgroundImages.Num() && ResidentBytes > BudgetBytes;)
 	{
-		UTexture2D* LoadedImage = Cast<UTexture2D> (Image.TryLoad());
-		if (LoadedImage)
+		const FBackgroundImage& Image = BackgroundImages[i];
+		const UTexture2D* Texture = Image.Handle.IsValid() ? Cast<UTexture2D>(Image.Handle->GetLoadedAsset()) : nullptr;
+		if (Texture == nullptr || Image.Path == StartupImage || Image.Path == DefaultImage)
 		{
-			DefaultBackgroundImages.Add(LoadedImage);
-		}		
+			++i;
+			continue;
+		}
+		ResidentBytes -= Texture->CalcTextureMemorySizeEnum(TMC_ResidentMips);
+		Image.Handle->ReleaseHandle();
+		BackgroundImages.RemoveAt(i);
 	}
 }
 
-void FAsyncLoadingScreenModule::RemoveAllBackgroundImages()
+void FAsyncLoadingScreenModule::PrefetchBackgroundImage()
 {
-	StartupBackgroundImages.Empty();
-	DefaultBackgroundImages.Empty();
+	const ULoadingScreenSettings* Settings = GetDefault<ULoadingScreenSettings>();
+	const int32 BudgetMB = Settings->BackgroundImagesBudgetMB;
+
+	int64 ResidentBytes = 0;
+	for (const FBackgroundImage& Image : BackgroundImages)
+	{
+		// A missing handle is a request still being made
+		if (!Image.Handle.IsValid() || Image.Handle->IsLoadingInProgress())
+		{
+			return;
+		}
+		if (const UTexture2D* Texture = Image.Handle.IsValid() ? Cast<UTexture2D>(Image.Handle->GetLoadedAsset()) : nullptr)
+		{
+			ResidentBytes += Texture->CalcTextureMemorySizeEnum(TMC_ResidentMips);
+		}
+	}
+	// Prefetching stops at the first image that would not fit, so the budget never has to release a prefetched one
+	if (BudgetMB > 0 && ResidentBytes * 2 > static_cast<int64>(BudgetMB) * 1024 * 1024)
+	{
+		return;
+	}
+
+	if (!StreamableManager.IsValid())
+	{
+		return;
+	}
+	for (const FSoftObjectPath& ImagePath : Settings->DefaultLoadingScreen.Background.Images)
+	{
+		const bool bIsRequested = BackgroundImages.ContainsByPredicate([&ImagePath](const FBackgroundImage& Image) { return Image.Path == ImagePath; });
+		if (!bIsRequested && !ImagePath.IsNull())
+		{
+			// Below every picked image in priority, and first in the eviction order
+			StartLoadingBackgroundImage(ImagePath, FStreamableManager::DefaultAsyncLoadPriority - 1, true);
+			return;
+		}
+	}
 }
 
 bool FAsyncLoadingScreenModule::IsPreloadBackgroundImagesEnabled()
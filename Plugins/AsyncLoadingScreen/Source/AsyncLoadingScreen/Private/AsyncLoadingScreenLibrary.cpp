@@ -19,6 +19,12 @@ bool  UAsyncLoadingScreenLibrary::bShowLoadingScreen = true;
 void UAsyncLoadingScreenLibrary::SetDisplayBackgroundIndex(int32 BackgroundIndex)
 {
 	UAsyncLoadingScreenLibrary::DisplayBackgroundIndex = BackgroundIndex;
+
+	// Start streaming the newly chosen image in before the level opens
+	if (FAsyncLoadingScreenModule::IsAvailable())
+	{
+		FAsyncLoadingScreenModule::Get().SelectNextBackgroundImage();
+	}
 }
 
 void UAsyncLoadingScreenLibrary::SetDisplayTipTextIndex(int32 TipTextIndex)
@@ -53,6 +59,25 @@ void UAsyncLoadingScreenLibrary::PreloadBackgroundImages()
 	}
 }
 
+void UAsyncLoadingScreenLibrary::PreloadLevel(FName LevelName, const TArray<FSoftObjectPath>& Assets, FOnLevelPreloaded OnPreloaded)
+{
+	if (!FAsyncLoadingScreenModule::IsAvailable())
+	{
+		OnPreloaded.ExecuteIfBound();
+		return;
+	}
+
+	FAsyncLoadingScreenModule::Get().PreloadLevel(LevelName, Assets, FStreamableDelegate::CreateLambda([OnPreloaded]()
+	{
+		OnPreloaded.ExecuteIfBound();
+	}));
+}
+
+float UAsyncLoadingScreenLibrary::GetPreloadProgress()
+{
+	return FAsyncLoadingScreenModule::IsAvailable() ? FAsyncLoadingScreenModule::Get().GetPreloadProgress() : 1.0f;
+}
+
 void UAsyncLoadingScreenLibrary::RemovePreloadedBackgroundImages()
 {
 	if (FAsyncLoadingScreenModule::IsAvailable())
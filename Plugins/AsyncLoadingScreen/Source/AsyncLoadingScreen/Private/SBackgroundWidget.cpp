@@ -16,38 +16,24 @@
 #include "AsyncLoadingScreen.h"
 
 void SBackgroundWidget::Construct(const FArguments& InArgs, const FBackgroundSettings& Settings)
+{
+	Refresh(Settings);
+}
+
+void SBackgroundWidget::Refresh(const FBackgroundSettings& Settings)
 {
 	// If there's an image defined
 	if (Settings.Images.Num() > 0)
 	{
-		int32 ImageIndex = FMath::RandRange(0, Settings.Images.Num() - 1);
-
-		if (Settings.bSetDisplayBackgroundManually == true)
-		{
-			if (Settings.Images.IsValidIndex(UAsyncLoadingScreenLibrary::GetDisplayBackgroundIndex()))
-			{
-				ImageIndex = UAsyncLoadingScreenLibrary::GetDisplayBackgroundIndex();
-			}
-		}		
+		// The module picked the image and streamed it in ahead of time, only the picked one is ever loaded here
+		UTexture2D* LoadingImage = FAsyncLoadingScreenModule::Get().GetSelectedBackgroundImage(Settings);
 		
-		// Load background from settings
-		UTexture2D* LoadingImage = nullptr;
-		const FSoftObjectPath& ImageAsset = Settings.Images[ImageIndex];
-		UObject* ImageObject = ImageAsset.TryLoad();
-		LoadingImage = Cast<UTexture2D>(ImageObject);
-
-		// If IsPreloadBackgroundImagesEnabled is enabled, load from images array
-		FAsyncLoadingScreenModule& LoadingScreenModule = FAsyncLoadingScreenModule::Get();
-		if (LoadingScreenModule.IsPreloadBackgroundImagesEnabled())
+		if (LoadingImage && Image.IsValid())
 		{
-			TArray<UTexture2D*> BackgroundImages = LoadingScreenModule.GetBackgroundImages();
-			if (!BackgroundImages.IsEmpty() && BackgroundImages.IsValidIndex(ImageIndex))
-			{
-				LoadingImage = BackgroundImages[ImageIndex];
-			}
-		}		
-		
-		if (LoadingImage)
+			ImageBrush = FDeferredCleanupSlateBrush::CreateBrush(LoadingImage);
+			Image->SetImage(ImageBrush.IsValid() ? ImageBrush->GetSlateBrush() : nullptr);
+		}
+		else if (LoadingImage)
 		{
 			ImageBrush = FDeferredCleanupSlateBrush::CreateBrush(LoadingImage);
 			ChildSlot
@@ -62,11 +48,20 @@ void SBackgroundWidget::Construct(const FArguments& InArgs, const FBackgroundSet
 					SNew(SScaleBox)
 					.Stretch(Settings.ImageStretch)
 					[
-						SNew(SImage)						
+						SAssignNew(Image, SImage)						
 						.Image(ImageBrush.IsValid() ? ImageBrush->GetSlateBrush() : nullptr)						
 					]
 				]
 			];			
 		}
 	}
+}
+
+void SBackgroundWidget::ReleaseImage()
+{
+	if (Image.IsValid())
+	{
+		Image->SetImage(nullptr);
+	}
+	ImageBrush.Reset();
 }
\ No newline at end of file
@@ -27,7 +27,7 @@ void SCenterLayout::Construct(const FArguments& InArgs, const FALoadingScreenSet
 		.HAlign(HAlign_Fill)
 		.VAlign(VAlign_Fill)
 		[
-			SNew(SBackgroundWidget, Settings.Background)
+			SAssignNew(BackgroundWidget, SBackgroundWidget, Settings.Background)
 		];
 
 	// Placeholder for loading widget
@@ -73,7 +73,7 @@ void SCenterLayout::Construct(const FArguments& InArgs, const FALoadingScreenSet
 						SNew(SDPIScaler)
 						.DPIScale(this, &SCenterLayout::GetDPIScale)
 						[					
-							SNew(STipWidget, Settings.TipWidget)
+							SAssignNew(TipWidget, STipWidget, Settings.TipWidget)
 						]
 					]					
 				]
@@ -102,7 +102,7 @@ void SCenterLayout::Construct(const FArguments& InArgs, const FALoadingScreenSet
 						SNew(SDPIScaler)
 						.DPIScale(this, &SCenterLayout::GetDPIScale)
 						[					
-							SNew(STipWidget, Settings.TipWidget)
+							SAssignNew(TipWidget, STipWidget, Settings.TipWidget)
 						]						
 					]					
 				]
@@ -26,7 +26,7 @@ void SDualSidebarLayout::Construct(const FArguments& InArgs, const FALoadingScre
 		.HAlign(HAlign_Fill)
 		.VAlign(VAlign_Fill)
 		[
-			SNew(SBackgroundWidget, Settings.Background)
+			SAssignNew(BackgroundWidget, SBackgroundWidget, Settings.Background)
 		];
 
 	// Placeholder for loading widget
@@ -90,7 +90,7 @@ void SDualSidebarLayout::Construct(const FArguments& InArgs, const FALoadingScre
 					SNew(SDPIScaler)
 					.DPIScale(this, &SDualSidebarLayout::GetDPIScale)
 					[
-						SNew(STipWidget, Settings.TipWidget)
+						SAssignNew(TipWidget, STipWidget, Settings.TipWidget)
 					]
 				]
 			]
@@ -119,7 +119,7 @@ void SDualSidebarLayout::Construct(const FArguments& InArgs, const FALoadingScre
 					SNew(SDPIScaler)
 					.DPIScale(this, &SDualSidebarLayout::GetDPIScale)
 					[
-						SNew(STipWidget, Settings.TipWidget)						
+						SAssignNew(TipWidget, STipWidget, Settings.TipWidget)						
 					]
 				]
 			]
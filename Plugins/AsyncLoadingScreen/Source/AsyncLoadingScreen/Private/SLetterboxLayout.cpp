@@ -24,7 +24,7 @@ void SLetterboxLayout::Construct(const FArguments& InArgs, const FALoadingScreen
 		.HAlign(HAlign_Fill)
 		.VAlign(VAlign_Fill)
 		[
-			SNew(SBackgroundWidget, Settings.Background)
+			SAssignNew(BackgroundWidget, SBackgroundWidget, Settings.Background)
 		];
 
 	// Placeholder for loading widget
@@ -87,7 +87,7 @@ void SLetterboxLayout::Construct(const FArguments& InArgs, const FALoadingScreen
 						SNew(SDPIScaler)
 						.DPIScale(this, &SLetterboxLayout::GetDPIScale)
 						[
-							SNew(STipWidget, Settings.TipWidget)
+							SAssignNew(TipWidget, STipWidget, Settings.TipWidget)
 						]						
 					]
 				]
@@ -115,7 +115,7 @@ void SLetterboxLayout::Construct(const FArguments& InArgs, const FALoadingScreen
 						SNew(SDPIScaler)
 						.DPIScale(this, &SLetterboxLayout::GetDPIScale)
 						[					
-							SNew(STipWidget, Settings.TipWidget)
+							SAssignNew(TipWidget, STipWidget, Settings.TipWidget)
 						]						
 					]
 				]
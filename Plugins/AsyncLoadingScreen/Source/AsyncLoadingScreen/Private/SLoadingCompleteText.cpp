@@ -16,6 +16,7 @@ void SLoadingCompleteText::Construct(const FArguments& InArgs, const FLoadingCom
 {
 	CompleteTextColor = CompleteTextSettings.Appearance.ColorAndOpacity.GetSpecifiedColor();
 	CompleteTextAnimationSpeed = CompleteTextSettings.AnimationSpeed;
+	bFadeInOutAnim = CompleteTextSettings.bFadeInOutAnim;
 
 	ChildSlot
 	[
@@ -28,13 +29,6 @@ void SLoadingCompleteText::Construct(const FArguments& InArgs, const FLoadingCom
 		.ColorAndOpacity(this, &SLoadingCompleteText::GetLoadingCompleteTextColor)
 		.Visibility(this, &SLoadingCompleteText::GetLoadingCompleteTextVisibility)
 	];	
-
-	// Register animated image sequence active timer event
-	if (CompleteTextSettings.bFadeInOutAnim && !bIsActiveTimerRegistered)
-	{
-		bIsActiveTimerRegistered = true;
-		RegisterActiveTimer(0.f, FWidgetActiveTimerDelegate::CreateSP(this, &SLoadingCompleteText::AnimateText));
-	}
 }
 
 EVisibility SLoadingCompleteText::GetLoadingCompleteTextVisibility() const
@@ -44,35 +38,19 @@ EVisibility SLoadingCompleteText::GetLoadingCompleteTextVisibility() const
 
 FSlateColor SLoadingCompleteText::GetLoadingCompleteTextColor() const
 {
-	return CompleteTextColor;
-}
-
-EActiveTimerReturnType SLoadingCompleteText::AnimateText(double InCurrentTime, float InDeltaTime)
-{
-	const float MinAlpha = 0.1f;
-	const float MaxAlpha = 1.0f;
-
-	float TextAlpha = CompleteTextColor.A;
-
-	if (TextAlpha >= MaxAlpha)
-	{
-		bCompleteTextReverseAnim = true;
-	}
-	else if (TextAlpha <= MinAlpha)
+	if (!bFadeInOutAnim || CompleteTextAnimationSpeed <= 0.0f)
 	{
-		bCompleteTextReverseAnim = false;
+		return CompleteTextColor;
 	}
 
-	if (!bCompleteTextReverseAnim)
-	{
-		TextAlpha += InDeltaTime * CompleteTextAnimationSpeed;
-	}
-	else
-	{
-		TextAlpha -= InDeltaTime * CompleteTextAnimationSpeed;
-	}
+	const float MinAlpha = 0.1f;
+	const float MaxAlpha = 1.0f;
+	const float AlphaRange = MaxAlpha - MinAlpha;
 
-	CompleteTextColor.A = TextAlpha;
+	// Fades out then back in at AnimationSpeed alpha per second, only evaluated when the text is painted
+	const float Phase = FMath::Fmod(FPlatformTime::Seconds() * CompleteTextAnimationSpeed, 2.0 * AlphaRange);
 
-	return EActiveTimerReturnType::Continue;
+	FLinearColor Color = CompleteTextColor;
+	Color.A = MinAlpha + FMath::Abs(AlphaRange - Phase);
+	return Color;
 }
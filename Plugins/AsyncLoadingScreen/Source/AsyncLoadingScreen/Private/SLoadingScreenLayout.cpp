@@ -8,6 +8,9 @@
 
 #include "SLoadingScreenLayout.h"
 #include "Engine/UserInterfaceSettings.h"
+#include "LoadingScreenSettings.h"
+#include "SBackgroundWidget.h"
+#include "STipWidget.h"
 
 float SLoadingScreenLayout::PointSizeToSlateUnits(float PointSize)
 {
@@ -17,6 +20,26 @@ float SLoadingScreenLayout::PointSizeToSlateUnits(float PointSize)
 	return PixelSize;
 }
 
+void SLoadingScreenLayout::Refresh(const FALoadingScreenSettings& Settings)
+{
+	if (BackgroundWidget.IsValid())
+	{
+		BackgroundWidget->Refresh(Settings.Background);
+	}
+	if (TipWidget.IsValid())
+	{
+		TipWidget->Refresh(Settings.TipWidget);
+	}
+}
+
+void SLoadingScreenLayout::ReleaseBackgroundImage()
+{
+	if (BackgroundWidget.IsValid())
+	{
+		BackgroundWidget->ReleaseImage();
+	}
+}
+
 float SLoadingScreenLayout::GetDPIScale() const
 {
 	const FVector2D DrawSize = GetTickSpaceGeometry().ToPaintGeometry().GetLocalSize();
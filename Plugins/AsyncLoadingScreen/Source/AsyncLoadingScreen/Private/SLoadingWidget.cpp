@@ -11,41 +11,29 @@
 #include "Slate/DeferredCleanupSlateBrush.h"
 #include "Widgets/Layout/SSpacer.h"
 #include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "AsyncLoadingScreen.h"
 #include "MoviePlayer.h"
 #include "Widgets/SCompoundWidget.h"
 
 int32 SLoadingWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
 {		
-	TotalDeltaTime += Args.GetDeltaTime();
-
-	if (TotalDeltaTime >= Interval)
+	const int32 FrameCount = AtlasFrameCount > 1 ? AtlasFrameCount : CleanupBrushList.Num();
+	if (FrameCount > 1)
 	{
-		if (CleanupBrushList.Num() > 1)
+		// The frame follows from the time, nothing accumulates between paints and the image is only touched when the frame changes.
+		// A zero interval still steps one frame per paint
+		const int32 Step = Interval > 0.0f
+			? static_cast<int32>(FMath::Fmod(FMath::FloorToDouble(Args.GetCurrentTime() / Interval), static_cast<double>(FrameCount)))
+			: (bPlayReverse ? FrameCount - ImageIndex : ImageIndex + 1) % FrameCount;
+		const int32 NewIndex = bPlayReverse ? (FrameCount - 1 - Step) : Step;
+
+		if (NewIndex != ImageIndex)
 		{
-			if (bPlayReverse)
-			{
-				ImageIndex--;
-			}
-			else
-			{
-				ImageIndex++;
-			}
-
-			if (ImageIndex >= CleanupBrushList.Num())
-			{
-				ImageIndex = 0;
-			}
-			else if (ImageIndex < 0)
-			{
-				ImageIndex = CleanupBrushList.Num() - 1;
-			}
-
-			StaticCastSharedRef<SImage>(LoadingIcon)->SetImage(CleanupBrushList[ImageIndex].IsValid() ? CleanupBrushList[ImageIndex]->GetSlateBrush() : nullptr);			
+			ImageIndex = NewIndex;
+			ShowFrame(ImageIndex);
 		}
-
-		TotalDeltaTime = 0.0f;
 	}
-	
 
 	return SCompoundWidget::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
 }
@@ -64,10 +52,40 @@ void SLoadingWidget::ConstructLoadingIcon(const FLoadingWidgetSettings& Settings
 	if (Settings.LoadingIconType == ELoadingIconType::LIT_ImageSequence)
 	{
 		// Loading Widget is image sequence
-		if (Settings.ImageSequenceSettings.Images.Num() > 0)
+		int32 Columns = 0;
+		int32 Rows = 0;
+		UTextureRenderTarget2D* Atlas = Settings.ImageSequenceSettings.bUseAtlas && FAsyncLoadingScreenModule::IsAvailable()
+			? FAsyncLoadingScreenModule::Get().GetImageSequenceAtlas(Settings.ImageSequenceSettings, Columns, Rows)
+			: nullptr;
+
+		if (Atlas)
+		{
+			CleanupBrushList.Empty();
+			ImageIndex = 0;
+			AtlasColumns = Columns;
+			AtlasRows = Rows;
+			AtlasFrameCount = 0;
+			for (const UTexture2D* Image : Settings.ImageSequenceSettings.Images)
+			{
+				AtlasFrameCount += Image && Image->GetResource() ? 1 : 0;
+			}
+
+			// The module keeps the atlas alive, the brush only points at it
+			const FVector2D Scale = Settings.ImageSequenceSettings.Scale;
+			AtlasBrush.SetResourceObject(Atlas);
+			AtlasBrush.ImageSize = FVector2D(Atlas->SizeX / Columns * Scale.X, Atlas->SizeY / Rows * Scale.Y);
+			SetAtlasFrame(ImageIndex);
+
+			LoadingIcon = SNew(SImage)
+				.Image(&AtlasBrush);
+
+			Interval = Settings.ImageSequenceSettings.Interval;
+		}
+		else if (Settings.ImageSequenceSettings.Images.Num() > 0)
 		{
 			CleanupBrushList.Empty();
 			ImageIndex = 0;
+			AtlasFrameCount = 0;
 
 			FVector2D Scale = Settings.ImageSequenceSettings.Scale;
 
@@ -122,6 +140,26 @@ void SLoadingWidget::ConstructLoadingIcon(const FLoadingWidgetSettings& Settings
 	}	
 }
 
+void SLoadingWidget::SetAtlasFrame(int32 Index) const
+{
+	const FVector2f CellSize(1.0f / AtlasColumns, 1.0f / AtlasRows);
+	const FVector2f Min((Index % AtlasColumns) * CellSize.X, (Index / AtlasColumns) * CellSize.Y);
+	AtlasBrush.SetUVRegion(FBox2f(Min, Min + CellSize));
+}
+
+void SLoadingWidget::ShowFrame(int32 Index) const
+{
+	if (AtlasFrameCount > 1)
+	{
+		SetAtlasFrame(Index);
+		LoadingIcon->Invalidate(EInvalidateWidgetReason::Paint);
+	}
+	else if (CleanupBrushList.IsValidIndex(Index))
+	{
+		StaticCastSharedRef<SImage>(LoadingIcon)->SetImage(CleanupBrushList[Index].IsValid() ? CleanupBrushList[Index]->GetSlateBrush() : nullptr);
+	}
+}
+
 EVisibility SLoadingWidget::GetLoadingWidgetVisibility() const
 {
 	return GetMoviePlayer()->IsLoadingFinished() ? EVisibility::Hidden : EVisibility::Visible;
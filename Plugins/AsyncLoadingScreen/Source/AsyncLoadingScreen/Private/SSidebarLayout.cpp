@@ -26,7 +26,7 @@ void SSidebarLayout::Construct(const FArguments& InArgs, const FALoadingScreenSe
 		.HAlign(HAlign_Fill)
 		.VAlign(VAlign_Fill)
 		[
-			SNew(SBackgroundWidget, Settings.Background)
+			SAssignNew(BackgroundWidget, SBackgroundWidget, Settings.Background)
 		];
 
 	// Placeholder for loading widget
@@ -69,7 +69,7 @@ void SSidebarLayout::Construct(const FArguments& InArgs, const FALoadingScreenSe
 			.HAlign(LayoutSettings.TipAlignment.HorizontalAlignment)
 			.VAlign(LayoutSettings.TipAlignment.VerticalAlignment)
 			[
-				SNew(STipWidget, Settings.TipWidget)
+				SAssignNew(TipWidget, STipWidget, Settings.TipWidget)
 			];
 	}
 	else
@@ -80,7 +80,7 @@ void SSidebarLayout::Construct(const FArguments& InArgs, const FALoadingScreenSe
 			.HAlign(LayoutSettings.TipAlignment.HorizontalAlignment)
 			.VAlign(LayoutSettings.TipAlignment.VerticalAlignment)
 			[
-				SNew(STipWidget, Settings.TipWidget)
+				SAssignNew(TipWidget, STipWidget, Settings.TipWidget)
 			];
 
 		// Add SSpacer at middle
@@ -15,19 +15,11 @@ void STipWidget::Construct(const FArguments& InArgs, const FTipSettings& Setting
 {
 	if (Settings.TipText.Num() > 0)
 	{
-		int32 TipIndex = FMath::RandRange(0, Settings.TipText.Num() - 1);
-		
-		if (Settings.bSetDisplayTipTextManually == true)
-		{			
-			if (Settings.TipText.IsValidIndex(UAsyncLoadingScreenLibrary::GetDisplayTipTextIndex()))
-			{
-				TipIndex = UAsyncLoadingScreenLibrary::GetDisplayTipTextIndex();
-			}
-		}
+		const int32 TipIndex = PickTipIndex(Settings);
 
 		ChildSlot
 		[
-			SNew(STextBlock)		
+			SAssignNew(TipTextBlock, STextBlock)		
 			.ColorAndOpacity(Settings.Appearance.ColorAndOpacity)
 			.Font(Settings.Appearance.Font)
 			.ShadowOffset(Settings.Appearance.ShadowOffset)
@@ -39,3 +31,25 @@ void STipWidget::Construct(const FArguments& InArgs, const FTipSettings& Setting
 		
 	}
 }
+
+void STipWidget::Refresh(const FTipSettings& Settings)
+{
+	if (TipTextBlock.IsValid() && Settings.TipText.Num() > 0)
+	{
+		TipTextBlock->SetText(Settings.TipText[PickTipIndex(Settings)]);
+	}
+}
+
+int32 STipWidget::PickTipIndex(const FTipSettings& Settings)
+{
+	int32 TipIndex = FMath::RandRange(0, Settings.TipText.Num() - 1);
+	
+	if (Settings.bSetDisplayTipTextManually == true)
+	{			
+		if (Settings.TipText.IsValidIndex(UAsyncLoadingScreenLibrary::GetDisplayTipTextIndex()))
+		{
+			TipIndex = UAsyncLoadingScreenLibrary::GetDisplayTipTextIndex();
+		}
+	}
+	return TipIndex;
+}
@@ -9,8 +9,16 @@
 #pragma once
 
 #include "Modules/ModuleManager.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/StrongObjectPtr.h"
 
 struct FALoadingScreenSettings;
+struct FBackgroundSettings;
+struct FImageSequenceSettings;
+class UTexture2D;
+class UTextureRenderTarget2D;
+class UWorld;
+class SLoadingScreenLayout;
 
 class FAsyncLoadingScreenModule : public IModuleInterface
 {
@@ -56,7 +64,22 @@ public:
 		return FModuleManager::Get().IsModuleLoaded("AsyncLoadingScreen");
 	}
 
-	TArray<UTexture2D*> GetBackgroundImages();
+	/**
+	 * The background image picked for the loading screen being set up, loaded by now unless it is still streaming in,
+	 * in which case this waits for that one image only.
+	 */
+	UTexture2D* GetSelectedBackgroundImage(const FBackgroundSettings& Settings);
+
+	/**
+	 * One texture holding every image of the sequence in a grid of Columns x Rows cells, drawn the first time it is asked for and kept
+	 * until shutdown. Null if the sequence has no image or does not fit in one texture.
+	 */
+	UTextureRenderTarget2D* GetImageSequenceAtlas(const FImageSequenceSettings& Settings, int32& OutColumns, int32& OutRows);
+
+	/**
+	 * Picks the background of the next default loading screen again and starts streaming it in, after the display index changed
+	 */
+	void SelectNextBackgroundImage();
 
 	/**
 	 * Check if "bPreloadBackgroundImages" option is enabled
@@ -69,15 +92,27 @@ public:
 	bool IsStartupLoadingScreen() { return bIsStartupLoadingScreen; }
 
 	/**
-	 * Load all background images from settings into array
+	 * Stream in all background images from settings and keep them regardless of the memory budget
 	 */
 	void LoadBackgroundImages();
 
 	/**
-	 * Remove all background images from array
+	 * Release all background images except the ones picked for the loading screens
 	 */
 	void RemoveAllBackgroundImages();
 
+	/**
+	 * Start loading a level's map package and assets, plus the "PreloadAssets" of the settings, in the background.
+	 * OnPreloaded is called on the game thread once everything is in memory; open the level then and it only has to
+	 * finish what is loaded. Level names that are not long package names only preload the assets.
+	 */
+	void PreloadLevel(FName LevelName, const TArray<FSoftObjectPath>& Assets, FStreamableDelegate OnPreloaded);
+
+	/**
+	 * How much of the last preload is in memory, from 0 to 1; 1 when nothing is preloading
+	 */
+	float GetPreloadProgress() const;
+
 private:
 	/**
 	 * Loading screen callback, it won't be called if we've already explicitly setup the loading screen
@@ -89,18 +124,131 @@ private:
 	 */
 	void SetupLoadingScreen(const FALoadingScreenSettings& LoadingScreenSettings);
 
+	/**
+	 * Rasterize the glyphs of the screen's texts into the Slate font atlas, so the loading thread does not have to on the first frame
+	 */
+	void PrewarmFontCache(const FALoadingScreenSettings& LoadingScreenSettings) const;
+
+	/**
+	 * The layout widget for these settings: built the first time, then kept and only refreshed on later loads
+	 */
+	TSharedPtr<SLoadingScreenLayout> GetLayoutWidget(const FALoadingScreenSettings& LoadingScreenSettings);
+
+	/**
+	 * The movies to play in order, shuffled or picked by index as the settings ask
+	 */
+	TArray<FString> ResolveMoviesList(const FALoadingScreenSettings& LoadingScreenSettings);
+
+	/**
+	 * Decide the default screen's movie order now and read the start of its first movie in the background
+	 */
+	void PrefetchNextMovies();
+
 	/**
 	 * Shuffle the movies list
 	 */
 	void ShuffleMovies(TArray<FString>& MoviesList);
+
+	/**
+	 * Random index into the images, or the display index when it is set manually and valid; INDEX_NONE without images
+	 */
+	int32 PickBackgroundIndex(const FBackgroundSettings& Settings) const;
+
+	/**
+	 * Start streaming an image in, or move it to the back of the eviction order if it is already requested
+	 */
+	void RequestBackgroundImage(const FSoftObjectPath& ImagePath, bool bIsUrgent);
+
+	/**
+	 * Add an image at the back of the eviction order, or at the front for a prefetch, and request it
+	 */
+	void StartLoadingBackgroundImage(const FSoftObjectPath& ImagePath, int32 Priority, bool bIsPrefetch);
+
+	/**
+	 * Called whenever a requested image finished loading: trims to the budget, then prefetches the next image
+	 */
+	void OnBackgroundImageLoaded();
+
+	/**
+	 * Release the least recently used images that are not picked for a screen until the resident ones fit the budget
+	 */
+	void TrimBackgroundImages();
+
+	/**
+	 * Stream in one more image of the default loading screen, if none is loading and the budget has room
+	 */
+	void PrefetchBackgroundImage();
+
+	FSoftObjectPath GetPickedImagePath(bool bIsStartup) const;
+
+	/**
+	 * Map load callbacks, they bound the load the loading screen is timed over
+	 */
+	void OnPreLoadMap(const FString& MapName);
+	void OnPostLoadMap(UWorld* LoadedWorld);
+
+	/**
+	 * The loading screen went away: publish its timings and append them to the CSV log if enabled
+	 */
+	void OnLoadingScreenFinished();
+
 private:
-	// Startup background images array
-	UPROPERTY()
-	TArray<class UTexture2D*> StartupBackgroundImages;
-	
-	// Default background images array
-	UPROPERTY()
-	TArray<class UTexture2D*> DefaultBackgroundImages;
+	struct FLoadingScreenTiming
+	{
+		FString MapName;
+		bool bIsStartup = false;
+		double StartTime = 0.0;
+		double WidgetSeconds = 0.0;
+		double ImageSeconds = 0.0;
+		double MovieSeconds = 0.0;
+		// Until the map finished loading, which is when IsLoadingFinished() turns true; negative if no map was loaded
+		double MapLoadSeconds = -1.0;
+	};
+
+	// The default screen's movie order decided ahead of time by PrefetchNextMovies, used by the next setup
+	TArray<FString> NextMoviesList;
+	bool bHasNextMoviesList = false;
+
+	// Layout widgets already built, by the hash of the settings they were built from
+	TMap<uint32, TSharedRef<SLoadingScreenLayout>> LayoutWidgets;
+
+	// The loading screen being shown, valid from its setup until the movie player finishes it
+	FLoadingScreenTiming Timing;
+	bool bIsTimingLoadingScreen = false;
+
+	struct FBackgroundImage
+	{
+		FSoftObjectPath Path;
+		// keeps the texture referenced until the handle is released
+		TSharedPtr<FStreamableHandle> Handle;
+	};
+
+	// Created in StartupModule, once the object system is up; never on a dedicated server
+	TUniquePtr<FStreamableManager> StreamableManager;
+
+	// requested images, least recently used first
+	TArray<FBackgroundImage> BackgroundImages;
+
+	// the assets of the level being transitioned to, held until the next transition begins
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+	FString PreloadLevelName;
+
+	// the images picked for the startup screen and for the next default screen, never released by the budget
+	int32 StartupBackgroundIndex = INDEX_NONE;
+	int32 DefaultBackgroundIndex = INDEX_NONE;
+
+	struct FImageSequenceAtlas
+	{
+		TStrongObjectPtr<UTextureRenderTarget2D> Texture;
+		int32 Columns = 0;
+		int32 Rows = 0;
+	};
+
+	// Atlases already drawn, by the path names of the images they hold
+	TMap<FString, FImageSequenceAtlas> ImageSequenceAtlases;
+
+	// LoadBackgroundImages was called: every image stays resident until RemoveAllBackgroundImages
+	bool bKeepAllBackgroundImages = false;
 
 	bool bIsStartupLoadingScreen = false;
 };
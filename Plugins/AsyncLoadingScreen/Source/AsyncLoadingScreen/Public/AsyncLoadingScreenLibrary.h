@@ -12,6 +12,8 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "AsyncLoadingScreenLibrary.generated.h"
 
+DECLARE_DYNAMIC_DELEGATE(FOnLevelPreloaded);
+
 /**
  * Async Loading Screen Function Library
  */
@@ -108,4 +110,20 @@ public:
 	 **/
 	UFUNCTION(BlueprintCallable, Category = "Async Loading Screen")
 	static void RemovePreloadedBackgroundImages();
+
+	/**
+	 * Load a level's map and assets in the background while the current level keeps playing, then open the level
+	 * from "OnPreloaded": the loading screen only shows for what is left. The "PreloadAssets" of the settings are loaded too.
+	 *
+	 * @param LevelName Long package name of the level, e.g. /Game/Maps/Match; a short name only preloads the assets
+	 * @param Assets Assets the level needs, e.g. the ones it spawns later; they stay in memory until the next level transition
+	 **/
+	UFUNCTION(BlueprintCallable, Category = "Async Loading Screen", meta = (AutoCreateRefTerm = "Assets"))
+	static void PreloadLevel(FName LevelName, const TArray<FSoftObjectPath>& Assets, FOnLevelPreloaded OnPreloaded);
+
+	/**
+	 * How much of the level started by "PreloadLevel" is loaded, from 0 to 1; 1 when nothing is preloading
+	 **/
+	UFUNCTION(BlueprintPure, Category = "Async Loading Screen")
+	static float GetPreloadProgress();
 };
@@ -184,6 +184,13 @@ struct FImageSequenceSettings
 	/** Play the image sequence in reverse.*/
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Loading Widget Setting")
 	bool bPlayReverse = false;
+
+	/**
+	 * Pack all images into one texture the first time the sequence is shown, and animate by moving the brush's UV region over it.
+	 * Memory and draw cost then stay the same however many images there are. Every image is drawn at the size of the first one.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Loading Widget Setting")
+	bool bUseAtlas = false;
 };
 
 /**
@@ -421,6 +428,13 @@ struct ASYNCLOADINGSCREEN_API FALoadingScreenSettings
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Movies Settings")
 	bool bSetDisplayMovieIndexManually = false;
 
+	/**
+	 * If true, the movie order of the next loading screen is decided ahead of time, and the beginning of its first movie is read
+	 * in the background so the file system has it cached. The first frame then does not wait on slow storage.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Movies Settings")
+	bool bPrefetchMovies = false;
+
 
 	/** 
 	 * Should we show the loading screen widgets (background/tips/loading widget)? Generally you'll want to set this to false if you just want to show a movie.
@@ -699,6 +713,30 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "General")
 	bool bPreloadBackgroundImages = false;
 
+	/**
+	 * Only the background image picked for a loading screen is loaded before it shows, streamed in ahead of time.
+	 * The other images are prefetched one at a time while the resident images stay within this many megabytes,
+	 * and the least recently used ones are released beyond it. 0 means no limit.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "General", meta = (ClampMin = "0"))
+	int32 BackgroundImagesBudgetMB = 64;
+
+	/**
+	 * Assets loaded asynchronously with every level: from "PreloadLevel" before the level opens, or alongside the map
+	 * while the loading screen shows otherwise. They stay in memory until the next level transition,
+	 * so assets the level only spawns later do not hitch its first frames.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "General")
+	TArray<FSoftObjectPath> PreloadAssets;
+
+	/**
+	 * Append every loading screen's timings to Saved/Logs/LoadingScreenTimes.csv: widget construction, background image load,
+	 * movie player setup, map load and how long the screen was shown. The same timings are always available as stats
+	 * ("stat AsyncLoadingScreen") and Insights events.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "General")
+	bool bLogLoadingTimes = false;
+
 	/**
 	 * The startup loading screen when you first open the game. Setup any studio logo movies here.
 	 */
@@ -12,6 +12,7 @@
 
 struct FBackgroundSettings;
 class FDeferredCleanupSlateBrush;
+class SImage;
 
 /**
  * Background widget
@@ -25,6 +26,17 @@ public:
 
 	void Construct(const FArguments& InArgs, const FBackgroundSettings& Settings);
 
+	/**
+	 * Show the image picked for this showing of a cached layout, the tree is only built if there was no image before
+	 */
+	void Refresh(const FBackgroundSettings& Settings);
+
+	/**
+	 * Drop the brush so the texture can be released, until the next Refresh
+	 */
+	void ReleaseImage();
+
 private:
 	TSharedPtr<FDeferredCleanupSlateBrush> ImageBrush;
+	TSharedPtr<SImage> Image;
 };
@@ -20,15 +20,12 @@ private:
 	// Complete text color
 	FLinearColor CompleteTextColor = FLinearColor::White;
 
-	// Complete text fade in or fade out animation
-	bool bCompleteTextReverseAnim = false;
+	// Complete text fade in and fade out animation
+	bool bFadeInOutAnim = false;
 
 	// Complete text animation speed
 	float CompleteTextAnimationSpeed = 1.0f;
 
-	// Active timer registered flag
-	bool bIsActiveTimerRegistered = false;
-
 public:
 	SLATE_BEGIN_ARGS(SLoadingCompleteText) {}
 
@@ -39,9 +36,6 @@ public:
 	// Getter for text visibility
 	EVisibility GetLoadingCompleteTextVisibility() const;
 
-	// Getter for complete text color and opacity
+	// Getter for complete text color and opacity, the fade follows from the time so nothing runs while the text is hidden
 	FSlateColor GetLoadingCompleteTextColor() const;
-
-	/** Active timer event for animating the image sequence */
-	EActiveTimerReturnType AnimateText(double InCurrentTime, float InDeltaTime);
 };
@@ -10,6 +10,10 @@
 
 #include "Widgets/SCompoundWidget.h"
 
+struct FALoadingScreenSettings;
+class SBackgroundWidget;
+class STipWidget;
+
 /**
  * Loading screen base theme
  */
@@ -17,6 +21,21 @@ class SLoadingScreenLayout : public SCompoundWidget
 {
 public:	
 	static float PointSizeToSlateUnits(float PointSize);
+
+	/**
+	 * Prepare a cached layout to be shown again: pick the background image and the tip text anew, the rest of the tree is kept
+	 */
+	void Refresh(const FALoadingScreenSettings& Settings);
+
+	/**
+	 * Let go of the background image while the layout waits in the cache, so it does not count against the image budget
+	 */
+	void ReleaseBackgroundImage();
+
 protected:
 	float GetDPIScale() const;	
+
+	// The parts that change from one showing to the next, assigned by the layouts when they build their tree
+	TSharedPtr<SBackgroundWidget> BackgroundWidget;
+	TSharedPtr<STipWidget> TipWidget;
 };
@@ -37,15 +37,24 @@ protected:
 	// Image slate brush list
 	TArray<TSharedPtr<FDeferredCleanupSlateBrush>> CleanupBrushList;	
 
+	// Atlas mode: one brush over the packed images, its UV region picks the frame
+	mutable FSlateBrush AtlasBrush;
+	int32 AtlasFrameCount = 0;
+	int32 AtlasColumns = 1;
+	int32 AtlasRows = 1;
+
+	// Point the atlas brush at one frame's cell
+	void SetAtlasFrame(int32 Index) const;
+
+	// Show a frame of the image sequence, from the atlas or its own brush
+	void ShowFrame(int32 Index) const;
+
 	// Play image sequence in reverse
 	bool bPlayReverse = false;
 
 	// Current image sequence index
 	mutable int32 ImageIndex = 0;
 
-	// Current total delta time
-	mutable float TotalDeltaTime = 0.0f;
-
 	//Time in second to update the images, the smaller value the faster of the animation. A zero value will update the images every frame.
 	float Interval = 0.05f;	
 	
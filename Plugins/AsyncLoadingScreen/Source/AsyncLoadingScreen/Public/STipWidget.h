@@ -11,6 +11,7 @@
 #include "Widgets/SCompoundWidget.h"
 
 struct FTipSettings;
+class STextBlock;
 
 /**
  * Tip widget
@@ -23,4 +24,14 @@ public:
 	SLATE_END_ARGS()
 
 	void Construct(const FArguments& InArgs, const FTipSettings& Settings);
+
+	/**
+	 * Pick the tip to show again, for a cached layout shown once more
+	 */
+	void Refresh(const FTipSettings& Settings);
+
+private:
+	static int32 PickTipIndex(const FTipSettings& Settings);
+
+	TSharedPtr<STextBlock> TipTextBlock;
 };
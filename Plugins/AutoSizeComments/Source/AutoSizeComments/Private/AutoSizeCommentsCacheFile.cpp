@@ -5,24 +5,38 @@
 #include "AutoSizeCommentsGraphHandler.h"
 #include "AutoSizeCommentsGraphNode.h"
 #include "AutoSizeCommentsModule.h"
+#include "AutoSizeCommentsNotifications.h"
 #include "AutoSizeCommentsSettings.h"
 #include "AutoSizeCommentsUtils.h"
 #include "EdGraphNode_Comment.h"
 #include "GeneralProjectSettings.h"
 #include "JsonObjectConverter.h"
+#include "Async/Async.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetRegistry/AssetRegistryState.h"
 #include "EdGraph/EdGraph.h"
 #include "EdGraph/EdGraphNode.h"
+#include "HAL/FileManager.h"
 #include "HAL/PlatformFileManager.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/CoreDelegates.h"
 #include "Misc/FileHelper.h"
 #include "Misc/LazySingleton.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "UObject/MetaData.h"
 
+// bump when the layout of FASCPackageData's binary serialization changes
+#define ASC_PACKAGE_CACHE_VERSION 1
+#define ASC_PACKAGE_CACHE_MAGIC 0x41534331 // "ASC1"
+
 static FName NAME_ASC_GRAPH_DATA = FName("ASCGraphData");
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cache Reads"), STAT_ASC_CacheReads, STATGROUP_AutoSizeComments);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cache Writes"), STAT_ASC_CacheWrites, STATGROUP_AutoSizeComments);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cache Package Files Read"), STAT_ASC_CachePackageFilesRead, STATGROUP_AutoSizeComments);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cache Package Files Written"), STAT_ASC_CachePackageFilesWritten, STATGROUP_AutoSizeComments);
+
 FAutoSizeCommentsCacheFile& FAutoSizeCommentsCacheFile::Get()
 {
 	return TLazySingleton<FAutoSizeCommentsCacheFile>::Get();
@@ -40,7 +54,7 @@ void FAutoSizeCommentsCacheFile::Init()
 		AssetRegistryModule->Get().OnFilesLoaded().AddRaw(this, &FAutoSizeCommentsCacheFile::LoadCacheFromFile);
 	}
 
-	FCoreDelegates::OnPreExit.AddRaw(this, &FAutoSizeCommentsCacheFile::SaveCacheToFile);
+	FCoreDelegates::OnPreExit.AddRaw(this, &FAutoSizeCommentsCacheFile::SaveCacheToFileAndWait);
 	FCoreUObjectDelegates::OnAssetLoaded.AddRaw(this, &FAutoSizeCommentsCacheFile::OnObjectLoaded);
 }
 
@@ -53,6 +67,11 @@ void FAutoSizeCommentsCacheFile::Cleanup()
 
 	FCoreDelegates::OnPreExit.RemoveAll(this);
 	FCoreUObjectDelegates::OnAssetLoaded.RemoveAll(this);
+
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
 }
 
 void FAutoSizeCommentsCacheFile::LoadCacheFromFile()
@@ -64,35 +83,24 @@ void FAutoSizeCommentsCacheFile::LoadCacheFromFile()
 
 	bHasLoaded = true;
 
-	const FString CachePath = GetCachePath();
-	const FString OldCachePath = GetAlternateCachePath();
-
-	FString FileData;
-	if (FPlatformFileManager::Get().GetPlatformFile().FileExists(*CachePath))
+	// packages are read from their own file when first used, only a json cache from before the per package files is
+	// read here. its packages are written out as package files on the next save
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (PlatformFile.FileExists(*GetCachePath()) || PlatformFile.FileExists(*GetAlternateCachePath()))
 	{
-		FFileHelper::LoadFileToString(FileData, *CachePath);
-
-		if (FJsonObjectConverter::JsonObjectStringToUStruct(FileData, &CacheData, 0, 0))
-		{
-			UE_LOG(LogAutoSizeComments, Log, TEXT("Loaded auto size comments cache: %s"), *GetCachePath(true));
-		}
-		else
+		FASCCacheData JsonCacheData = CreateCacheFromFile();
+		for (TPair<FName, FASCPackageData>& Package : JsonCacheData.PackageData)
 		{
-			UE_LOG(LogAutoSizeComments, Log, TEXT("Failed to load auto size comments cache: %s"), *GetCachePath(true));
+			// packages already read from their own file are newer
+			if (!LoadedPackages.Contains(Package.Key))
+			{
+				CacheData.PackageData.Add(Package.Key, MoveTemp(Package.Value));
+				LoadedPackages.Add(Package.Key);
+				DirtyPackages.Add(Package.Key);
+			}
 		}
-	}
-	else
-	{
-		FFileHelper::LoadFileToString(FileData, *OldCachePath);
 
-		if (FJsonObjectConverter::JsonObjectStringToUStruct(FileData, &CacheData, 0, 0))
-		{
-			UE_LOG(LogAutoSizeComments, Log, TEXT("Loaded auto size comments cache from old cache path: %s"), *GetAlternateCachePath(true));
-		}
-		else
-		{
-			UE_LOG(LogAutoSizeComments, Log, TEXT("Failed to load auto size comments cache from old cache path: %s"), *GetAlternateCachePath(true));
-		}
+		bImportedJsonCache = true;
 	}
 
 	CleanupFiles();
@@ -163,16 +171,103 @@ void FAutoSizeCommentsCacheFile::SaveCacheToFile()
 		CacheGraphData.CleanupGraph(Graph);
 	}
 
+	// one write at a time, so an older file never lands after a newer one
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+
 	const double StartTime = FPlatformTime::Seconds();
 
-	const auto CachePath = GetCachePath();
+	// only the packages handed out since the last save can have changed
+	TArray<TPair<FString, TArray<uint8>>> Files;
+	TSet<FName> LockedPackages;
+	for (FName PackageName : DirtyPackages)
+	{
+		FASCPackageData* PackageData = CacheData.PackageData.Find(PackageName);
+		if (!PackageData)
+		{
+			continue;
+		}
+
+		// the status is from an earlier asynchronous update, a slow source control server never holds up the save
+		const FString Filename = GetPackageCacheFilename(PackageName);
+		if (FAutoSizeCommentsNotifications::Get().IsFileLockedBySourceControl(Filename))
+		{
+			LockedPackages.Add(PackageName);
+			continue;
+		}
+
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		uint32 Magic = ASC_PACKAGE_CACHE_MAGIC;
+		int32 Version = ASC_PACKAGE_CACHE_VERSION;
+		FString Name = PackageName.ToString();
+		Writer << Magic << Version << Name << *PackageData;
+		Files.Emplace(Filename, MoveTemp(Bytes));
+	}
+
+	// locked packages are tried again on the next save
+	DirtyPackages = MoveTemp(LockedPackages);
+	INC_DWORD_STAT_BY(STAT_ASC_CachePackageFilesWritten, Files.Num());
+
+	if (DirtyPackages.Num() > 0)
+	{
+		FAutoSizeCommentsNotifications::Get().ShowCacheFilesLockedNotification(DirtyPackages.Num());
+	}
+
+	// once its packages are written the json cache must not be imported again over newer data
+	TArray<FString> JsonCachePaths;
+	if (bImportedJsonCache && DirtyPackages.Num() == 0)
+	{
+		JsonCachePaths.Add(GetCachePath());
+		JsonCachePaths.Add(GetAlternateCachePath());
+		bImportedJsonCache = false;
+	}
+
+	const FString PackageCacheDir = GetPackageCacheDir();
+
+	// the game thread only pays for serializing the changed packages, the writes happen on the thread pool
+	PendingWrite = Async(EAsyncExecution::ThreadPool, [Files = MoveTemp(Files), JsonCachePaths = MoveTemp(JsonCachePaths), PackageCacheDir]()
+	{
+		const double WriteStartTime = FPlatformTime::Seconds();
+
+		bool bWroteAll = true;
+		for (const TPair<FString, TArray<uint8>>& File : Files)
+		{
+			// Write data to a temp file and move it over the cache, so a crash mid write never leaves a truncated cache
+			const FString TempPath = File.Key + TEXT(".tmp");
+			if (!FFileHelper::SaveArrayToFile(File.Value, *TempPath) || !IFileManager::Get().Move(*File.Key, *TempPath, true, true))
+			{
+				UE_LOG(LogAutoSizeComments, Warning, TEXT("Failed to save package cache %s"), *File.Key);
+				bWroteAll = false;
+			}
+		}
+
+		if (bWroteAll)
+		{
+			for (const FString& JsonCachePath : JsonCachePaths)
+			{
+				IFileManager::Get().Delete(*JsonCachePath, false, false, true);
+			}
+		}
+
+		const double WriteTime = (FPlatformTime::Seconds() - WriteStartTime) * 1000.0f;
+		UE_LOG(LogAutoSizeComments, Log, TEXT("Saved %d package caches to %s took %6.2fms"), Files.Num(), *FPaths::ConvertRelativePathToFull(PackageCacheDir), WriteTime);
+	});
 
-	// Write data to file
-	FString JsonAsString;
-	FJsonObjectConverter::UStructToJsonObjectString(CacheData, JsonAsString, 0, 0, 0, nullptr, UAutoSizeCommentsSettings::Get().bPrettyPrintCommentCacheJSON);
-	FFileHelper::SaveStringToFile(JsonAsString, *CachePath);
 	const double TimeTaken = (FPlatformTime::Seconds() - StartTime) * 1000.0f;
-	UE_LOG(LogAutoSizeComments, Log, TEXT("Saved cache to %s took %6.2fms"), *GetCachePath(true), TimeTaken);
+	UE_LOG(LogAutoSizeComments, Verbose, TEXT("Serialized cache for saving in %6.2fms"), TimeTaken);
+}
+
+void FAutoSizeCommentsCacheFile::SaveCacheToFileAndWait()
+{
+	SaveCacheToFile();
+
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
 }
 
 void FAutoSizeCommentsCacheFile::DeleteCache()
@@ -180,7 +275,18 @@ void FAutoSizeCommentsCacheFile::DeleteCache()
 	const FString ProjectCachePath = GetProjectCachePath();
 	const FString PluginCachePath = GetPluginCachePath();
 
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+
 	CacheData.PackageData.Reset();
+	LoadedPackages.Reset();
+	DirtyPackages.Reset();
+	bImportedJsonCache = false;
+
+	IFileManager::Get().DeleteDirectory(*GetPackageCacheDir(), false, true);
+	IFileManager::Get().DeleteDirectory(*GetPackageCacheDir(true), false, true);
 
 	if (FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*ProjectCachePath))
 	{
@@ -234,6 +340,19 @@ void FAutoSizeCommentsCacheFile::CleanupFiles()
 			CacheData.PackageData.Remove(PackageGuid);
 		}
 	}
+
+	// the file names map back to the package names, so this needs no file to be read
+	const FString PackageCacheDir = GetPackageCacheDir();
+	TArray<FString> PackageFiles;
+	IFileManager::Get().FindFiles(PackageFiles, *(PackageCacheDir / TEXT("*.asccache")), true, false);
+	for (const FString& PackageFile : PackageFiles)
+	{
+		const FName PackageName(TEXT("/") + FPaths::GetBaseFilename(PackageFile).Replace(TEXT("@"), TEXT("/")));
+		if (!CurrentPackageNames.Contains(PackageName))
+		{
+			IFileManager::Get().Delete(*(PackageCacheDir / PackageFile), false, false, true);
+		}
+	}
 }
 
 FASCCommentData& FAutoSizeCommentsCacheFile::GetCommentData(UEdGraphNode_Comment* Comment)
@@ -244,6 +363,7 @@ FASCCommentData& FAutoSizeCommentsCacheFile::GetCommentData(UEdGraphNode_Comment
 FASCGraphData& FAutoSizeCommentsCacheFile::GetGraphData(UEdGraph* Graph)
 {
 	check(Graph);
+	INC_DWORD_STAT(STAT_ASC_CacheReads);
 
 	// load from cache file class
 	if (UAutoSizeCommentsSettings::Get().CacheSaveMethod == EASCCacheSaveMethod::File)
@@ -295,6 +415,9 @@ FASCGraphData& FAutoSizeCommentsCacheFile::GetGraphData(UEdGraph* Graph)
 bool FAutoSizeCommentsCacheFile::RemoveGraphData(UEdGraph* Graph)
 {
 	UPackage* Package = Graph->GetOutermost();
+	EnsurePackageLoaded(Package->GetFName());
+	DirtyPackages.Add(Package->GetFName());
+
 	FASCPackageData& PackageData = CacheData.PackageData.FindOrAdd(Package->GetFName());
 	return PackageData.GraphData.Remove(Graph->GraphGuid) > 0;
 }
@@ -315,6 +438,75 @@ void FAutoSizeCommentsCacheFile::ClearPackageMetaData(UEdGraph* Graph)
 	}
 }
 
+FString FAutoSizeCommentsCacheFile::GetPackageCacheDir(bool bAlternate)
+{
+	const FString CachePath = bAlternate ? GetAlternateCachePath() : GetCachePath();
+	return FPaths::GetPath(CachePath) / FPaths::GetBaseFilename(CachePath) + TEXT("_Packages");
+}
+
+FString FAutoSizeCommentsCacheFile::GetPackageCacheFilename(FName PackageName, bool bAlternate)
+{
+	// '@' is not allowed in package names, so it can stand in for the path separators
+	FString FileName = PackageName.ToString();
+	FileName.RemoveFromStart(TEXT("/"));
+	FileName.ReplaceInline(TEXT("/"), TEXT("@"));
+	return GetPackageCacheDir(bAlternate) / FileName + TEXT(".asccache");
+}
+
+bool FAutoSizeCommentsCacheFile::LoadPackageData(FName PackageName)
+{
+	if (UAutoSizeCommentsSettings::Get().CacheSaveMethod != EASCCacheSaveMethod::File)
+	{
+		return false;
+	}
+
+	// the file may still be being written
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+
+	INC_DWORD_STAT(STAT_ASC_CachePackageFilesRead);
+
+	// fall back to the other save location, the data moves over on the next save
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *GetPackageCacheFilename(PackageName), FILEREAD_Silent)
+		&& !FFileHelper::LoadFileToArray(Bytes, *GetPackageCacheFilename(PackageName, true), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Reader << Magic << Version;
+	if (Magic != ASC_PACKAGE_CACHE_MAGIC || Version != ASC_PACKAGE_CACHE_VERSION)
+	{
+		return false;
+	}
+
+	FString Name;
+	FASCPackageData PackageData;
+	Reader << Name << PackageData;
+	if (Reader.IsError() || Name != PackageName.ToString())
+	{
+		UE_LOG(LogAutoSizeComments, Log, TEXT("Failed to load package cache: %s"), *GetPackageCacheFilename(PackageName));
+		return false;
+	}
+
+	CacheData.PackageData.Add(PackageName, MoveTemp(PackageData));
+	return true;
+}
+
+void FAutoSizeCommentsCacheFile::EnsurePackageLoaded(FName PackageName)
+{
+	if (!LoadedPackages.Contains(PackageName))
+	{
+		LoadedPackages.Add(PackageName);
+		LoadPackageData(PackageName);
+	}
+}
+
 FString FAutoSizeCommentsCacheFile::GetProjectCachePath(bool bFullPath)
 {
 	return FPaths::ProjectDir() / TEXT("Saved") / TEXT("AutoSizeComments") / TEXT("AutoSizeCommentsCache.json");
@@ -400,6 +592,9 @@ void FAutoSizeCommentsCacheFile::PrintCache()
 
 void FAutoSizeCommentsCacheFile::OnObjectLoaded(UObject* Obj)
 {
+	// read the package's cache while the asset loads instead of when its first comment is drawn
+	EnsurePackageLoaded(Obj->GetPackage()->GetFName());
+
 	// when a package is reloaded, we want to make the comment read the latest
 	// data from this cache (for when you revert commit or file)
 	if (FASCPackageData* PackageData = FindPackageData(Obj->GetPackage()))
@@ -414,6 +609,11 @@ void FAutoSizeCommentsCacheFile::OnObjectLoaded(UObject* Obj)
 FASCGraphData& FAutoSizeCommentsCacheFile::GetCacheFileGraphData(UEdGraph* Graph)
 {
 	UPackage* Package = Graph->GetOutermost();
+	EnsurePackageLoaded(Package->GetFName());
+
+	// the caller gets a mutable reference, so assume it changes the package
+	DirtyPackages.Add(Package->GetFName());
+
 	FASCPackageData& PackageData = CacheData.PackageData.FindOrAdd(Package->GetFName());
 	FASCGraphData& GraphData = PackageData.GraphData.FindOrAdd(Graph->GraphGuid);
 	return GraphData;
@@ -434,6 +634,8 @@ void FASCCommentData::UpdateNodesUnderComment(UEdGraphNode_Comment* Comment)
 		return;
 	}
 
+	INC_DWORD_STAT(STAT_ASC_CacheWrites);
+
 	const TArray<UEdGraphNode*> NodesUnder = FASCUtils::GetNodesUnderComment(Comment);
 	NodeGuids.Reset(NodesUnder.Num());
 
@@ -0,0 +1,203 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "AutoSizeCommentsGraphChanges.h"
+
+#include "AutoSizeCommentsGraphNode.h"
+#include "AutoSizeCommentsMacros.h"
+#include "GraphEditAction.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphNode.h"
+
+#if ASC_UE_VERSION_OR_LATER(5, 1)
+#include "Misc/TransactionObjectEvent.h"
+#endif
+
+bool FASCGraphDiff::IsEmpty() const
+{
+	return AddedNodes.Num() == 0
+		&& RemovedNodes.Num() == 0
+		&& MovedNodes.Num() == 0
+		&& ResizedNodes.Num() == 0
+		&& ModifiedNodes.Num() == 0;
+}
+
+void FASCGraphDiff::Reset()
+{
+	AddedNodes.Reset();
+	RemovedNodes.Reset();
+	MovedNodes.Reset();
+	ResizedNodes.Reset();
+	ModifiedNodes.Reset();
+	bUndoRedo = false;
+}
+
+FASCGraphChanges::FNodeState::FNodeState(const UEdGraphNode* Node)
+	: X(Node->NodePosX)
+	, Y(Node->NodePosY)
+	, Width(Node->NodeWidth)
+	, Height(Node->NodeHeight)
+{
+}
+
+void FASCGraphChanges::Bind(UEdGraph* InGraph)
+{
+	Reset();
+
+	Graph = InGraph;
+	if (!InGraph)
+	{
+		return;
+	}
+
+	KnownNodes.Reserve(InGraph->Nodes.Num());
+	for (UEdGraphNode* Node : InGraph->Nodes)
+	{
+		if (Node)
+		{
+			KnownNodes.Add(Node, FNodeState(Node));
+		}
+	}
+}
+
+void FASCGraphChanges::Reset()
+{
+	Graph.Reset();
+	KnownNodes.Reset();
+	TouchedNodes.Reset();
+	bNodeListChanged = false;
+	bUndoRedo = false;
+}
+
+void FASCGraphChanges::RecordGraphChanged(const FEdGraphEditAction& Action)
+{
+	if (Action.Graph && Action.Graph != Graph.Get())
+	{
+		return;
+	}
+
+	// a plain notify carries no action, so anything may have been added or removed
+	if ((Action.Action & (GRAPHACTION_AddNode | GRAPHACTION_RemoveNode)) != 0 || Action.Action == GRAPHACTION_Default)
+	{
+		bNodeListChanged = true;
+	}
+}
+
+void FASCGraphChanges::RecordTransacted(UObject* Object, const FTransactionObjectEvent& Event)
+{
+	if (!Graph.IsValid())
+	{
+		return;
+	}
+
+	const bool bUndoRedoEvent = Event.GetEventType() == ETransactionObjectEventType::UndoRedo;
+
+	if (UEdGraphNode* Node = Cast<UEdGraphNode>(Object))
+	{
+		if (Node->GetGraph() == Graph.Get())
+		{
+			TouchedNodes.Add(Node);
+			bUndoRedo |= bUndoRedoEvent;
+		}
+	}
+	else if (Object == Graph.Get())
+	{
+		// undo and redo restore the node list without a graph action
+		bNodeListChanged = true;
+		bUndoRedo |= bUndoRedoEvent;
+	}
+}
+
+void FASCGraphChanges::IgnoreNode(UEdGraphNode* Node)
+{
+	if (Node)
+	{
+		KnownNodes.Add(Node, FNodeState(Node));
+	}
+}
+
+bool FASCGraphChanges::Flush(FASCGraphDiff& OutDiff)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FASCGraphChanges::Flush"), STAT_ASC_GraphChangesFlush, STATGROUP_AutoSizeComments);
+
+	OutDiff.Reset();
+
+	UEdGraph* MyGraph = Graph.Get();
+	if (!MyGraph)
+	{
+		TouchedNodes.Reset();
+		bNodeListChanged = false;
+		bUndoRedo = false;
+		return false;
+	}
+
+	OutDiff.bUndoRedo = bUndoRedo;
+
+	if (bNodeListChanged)
+	{
+		TSet<TWeakObjectPtr<UEdGraphNode>> CurrentNodes;
+		CurrentNodes.Reserve(MyGraph->Nodes.Num());
+		for (UEdGraphNode* Node : MyGraph->Nodes)
+		{
+			if (!Node)
+			{
+				continue;
+			}
+
+			CurrentNodes.Add(Node);
+
+			if (!KnownNodes.Contains(Node))
+			{
+				KnownNodes.Add(Node, FNodeState(Node));
+				OutDiff.AddedNodes.Add(Node);
+			}
+		}
+
+		for (auto It = KnownNodes.CreateIterator(); It; ++It)
+		{
+			if (!CurrentNodes.Contains(It->Key))
+			{
+				OutDiff.RemovedNodes.Add(It->Key);
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	for (const TWeakObjectPtr<UEdGraphNode>& NodePtr : TouchedNodes)
+	{
+		UEdGraphNode* Node = NodePtr.Get();
+		FNodeState* KnownState = Node ? KnownNodes.Find(Node) : nullptr;
+
+		// removed, or added and already reported above
+		if (!KnownState || OutDiff.AddedNodes.Contains(Node))
+		{
+			continue;
+		}
+
+		const FNodeState NewState(Node);
+		const bool bMoved = NewState.X != KnownState->X || NewState.Y != KnownState->Y;
+		const bool bResized = NewState.Width != KnownState->Width || NewState.Height != KnownState->Height;
+
+		if (bMoved)
+		{
+			OutDiff.MovedNodes.Add(Node);
+		}
+
+		if (bResized)
+		{
+			OutDiff.ResizedNodes.Add(Node);
+		}
+
+		if (!bMoved && !bResized)
+		{
+			OutDiff.ModifiedNodes.Add(Node);
+		}
+
+		*KnownState = NewState;
+	}
+
+	TouchedNodes.Reset();
+	bNodeListChanged = false;
+	bUndoRedo = false;
+
+	return !OutDiff.IsEmpty();
+}
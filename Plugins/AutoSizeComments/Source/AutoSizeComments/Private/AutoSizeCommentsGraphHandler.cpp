@@ -12,6 +12,7 @@
 #include "GraphEditAction.h"
 #include "K2Node_Knot.h"
 #include "SGraphPanel.h"
+#include "Framework/Application/SlateApplication.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Misc/LazySingleton.h"
 #include "Widgets/Notifications/SNotificationList.h"
@@ -135,6 +136,11 @@ void FAutoSizeCommentGraphHandler::BindDelegates()
 #endif
 
 	FCoreUObjectDelegates::OnObjectTransacted.AddRaw(this, &FAutoSizeCommentGraphHandler::OnObjectTransacted);
+
+	if (FSlateApplication::IsInitialized())
+	{
+		PostTickDelegateHandle = FSlateApplication::Get().OnPostTick().AddRaw(this, &FAutoSizeCommentGraphHandler::ProcessQueuedComments);
+	}
 }
 
 void FAutoSizeCommentGraphHandler::UnbindDelegates()
@@ -155,6 +161,13 @@ void FAutoSizeCommentGraphHandler::UnbindDelegates()
 	}
 
 	GraphDatas.Empty();
+	PanelSpatialHashes.Empty();
+	QueuedComments.Empty();
+
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnPostTick().Remove(PostTickDelegateHandle);
+	}
 
 #if ASC_UE_VERSION_OR_LATER(5, 0)
 	FTSTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
@@ -172,16 +185,20 @@ void FAutoSizeCommentGraphHandler::BindToGraph(UEdGraph* Graph)
 
 	GraphDatas.Remove(nullptr);
 
-	FASCGraphHandlerData GraphData;
+	FASCGraphHandlerData& GraphData = GraphDatas.Add(Graph);
 	GraphData.OnGraphChangedHandle = Graph->AddOnGraphChangedHandler(FOnGraphChanged::FDelegate::CreateRaw(this, &FAutoSizeCommentGraphHandler::OnGraphChanged));
-
-	GraphDatas.Add(Graph, GraphData);
+	GraphData.GraphChanges.Bind(Graph);
 
 	CheckCacheDataError(Graph);
 }
 
 void FAutoSizeCommentGraphHandler::OnGraphChanged(const FEdGraphEditAction& Action)
 {
+	if (FASCGraphHandlerData* GraphData = GraphDatas.Find(Action.Graph))
+	{
+		GraphData->GraphChanges.RecordGraphChanged(Action);
+	}
+
 	if ((Action.Action & GRAPHACTION_AddNode) != 0 && Action.bUserInvoked)
 	{
 		// only handle single node added 
@@ -241,6 +258,8 @@ void FAutoSizeCommentGraphHandler::AutoInsertIntoCommentNodes(TWeakObjectPtr<UEd
 			{
 				CommentNode->AddNodeUnderComment(Node);
 			}
+
+			FAutoSizeCommentGraphHandler::Get().MarkCommentTreeDirty(Graph);
 		};
 	};
 
@@ -316,39 +335,86 @@ void FAutoSizeCommentGraphHandler::RegisterActiveGraphPanel(TSharedPtr<SGraphPan
 	}
 }
 
-void FAutoSizeCommentGraphHandler::RequestGraphVisualRefresh(TSharedPtr<SGraphPanel> GraphPanel)
+void FAutoSizeCommentGraphHandler::RequestSortDepthUpdate(UEdGraphNode_Comment* Comment)
 {
-	if (bPendingGraphVisualRequest)
+	if (!Comment)
 	{
 		return;
 	}
 
-	bPendingGraphVisualRequest = true;
+	// every request made this frame is handled by the same update
+	if (PendingSortDepthComments.Num() == 0)
+	{
+		GEditor->GetTimerManager()->SetTimerForNextTick(FTimerDelegate::CreateRaw(this, &FAutoSizeCommentGraphHandler::UpdateSortDepths));
+	}
 
-	const auto Delegate = FTimerDelegate::CreateRaw(this, &FAutoSizeCommentGraphHandler::RefreshGraphVisualRefresh, TWeakPtr<SGraphPanel>(GraphPanel));
-	GEditor->GetTimerManager()->SetTimerForNextTick(Delegate);
+	PendingSortDepthComments.Add(Comment);
 }
 
-void FAutoSizeCommentGraphHandler::RefreshGraphVisualRefresh(TWeakPtr<SGraphPanel> GraphPanel)
+void FAutoSizeCommentGraphHandler::UpdateSortDepths()
 {
-	bPendingGraphVisualRequest = false;
-
-	if (!GraphPanel.IsValid())
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FAutoSizeCommentGraphHandler::UpdateSortDepths"), STAT_ASC_UpdateSortDepths, STATGROUP_AutoSizeComments);
+
+	// the panel sorts its widgets by the comment depth every tick, so a nested comment only has to be given a higher
+	// depth than the comments containing it. the comments around a changed comment are the only ones whose depth can
+	// change: the comment itself and everything containing it
+	TSet<UEdGraphNode_Comment*> CommentsToUpdate;
+	TArray<UEdGraphNode_Comment*> Stack;
+	for (const TWeakObjectPtr<UEdGraphNode_Comment>& Comment : PendingSortDepthComments)
 	{
-		return;
+		if (Comment.IsValid())
+		{
+			Stack.Add(Comment.Get());
+		}
 	}
 
-	GraphPanel.Pin()->PurgeVisualRepresentation();
+	PendingSortDepthComments.Reset();
+
+	while (Stack.Num() > 0)
+	{
+		UEdGraphNode_Comment* Comment = Stack.Pop();
+		if (!CommentsToUpdate.Contains(Comment))
+		{
+			CommentsToUpdate.Add(Comment);
+			Stack.Append(GetContainingComments(Comment));
+		}
+	}
 
-	const auto UpdateGraphPanel = [](TWeakPtr<SGraphPanel> LocalPanel)
+	// a comment sits behind each comment it contains: its depth is one less than the lowest of theirs
+	struct FLocal
 	{
-		if (LocalPanel.IsValid())
+		static int32 GetDepth(UEdGraphNode_Comment* Comment, TMap<UEdGraphNode_Comment*, int32>& Depths, TSet<UEdGraphNode_Comment*>& Visiting)
 		{
-			LocalPanel.Pin()->Update();
+			if (const int32* Depth = Depths.Find(Comment))
+			{
+				return *Depth;
+			}
+
+			int32 Depth = -1;
+
+			// comments can end up containing each other, don't follow the cycle
+			Visiting.Add(Comment);
+			for (UObject* Obj : Comment->GetNodesUnderComment())
+			{
+				UEdGraphNode_Comment* Nested = Cast<UEdGraphNode_Comment>(Obj);
+				if (Nested && Nested != Comment && !Visiting.Contains(Nested))
+				{
+					Depth = FMath::Min(Depth, GetDepth(Nested, Depths, Visiting) - 1);
+				}
+			}
+			Visiting.Remove(Comment);
+
+			Depths.Add(Comment, Depth);
+			return Depth;
 		}
 	};
 
-	GEditor->GetTimerManager()->SetTimerForNextTick(FTimerDelegate::CreateLambda(UpdateGraphPanel, GraphPanel));
+	TMap<UEdGraphNode_Comment*, int32> Depths;
+	TSet<UEdGraphNode_Comment*> Visiting;
+	for (UEdGraphNode_Comment* Comment : CommentsToUpdate)
+	{
+		Comment->CommentDepth = FLocal::GetDepth(Comment, Depths, Visiting);
+	}
 }
 
 EASCResizingMode FAutoSizeCommentGraphHandler::GetResizingMode(UEdGraph* Graph) const
@@ -570,6 +636,7 @@ void FAutoSizeCommentGraphHandler::ProcessAltReleased(TSharedPtr<SGraphPanel> Gr
 			if (bChanged)
 			{
 				CommentNode->ClearNodesUnderComment();
+				MarkCommentTreeDirty(CommentNode->GetGraph());
 				ASCGraphNode->AddAllNodesUnderComment(NewSelection.Array(), false);
 				ChangedGraphNodes.Add(ASCGraphNode);
 			}
@@ -628,6 +695,78 @@ bool FAutoSizeCommentGraphHandler::HasCommentChanged(UEdGraphNode_Comment* Comme
 	return false;
 }
 
+TArray<UEdGraphNode_Comment*> FAutoSizeCommentGraphHandler::GetContainingComments(UEdGraphNode* Node)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FAutoSizeCommentGraphHandler::GetContainingComments"), STAT_ASC_GetContainingComments, STATGROUP_AutoSizeComments);
+
+	TArray<UEdGraphNode_Comment*> OutComments;
+
+	UEdGraph* Graph = Node ? Node->GetGraph() : nullptr;
+	if (!Graph)
+	{
+		return OutComments;
+	}
+
+	FASCGraphHandlerData& GraphData = GraphDatas.FindOrAdd(Graph);
+
+	// comments can also be edited without going through ASC (undo, other editors), so rebuild every frame as well
+	if (GraphData.bContainingCommentsDirty || GraphData.ContainingCommentsFrame != GFrameCounter)
+	{
+		GraphData.ContainingComments.Reset();
+		for (UEdGraphNode* GraphNode : Graph->Nodes)
+		{
+			if (UEdGraphNode_Comment* Comment = Cast<UEdGraphNode_Comment>(GraphNode))
+			{
+				for (UObject* Obj : Comment->GetNodesUnderComment())
+				{
+					if (UEdGraphNode* NodeUnderComment = Cast<UEdGraphNode>(Obj))
+					{
+						if (NodeUnderComment != Comment)
+						{
+							GraphData.ContainingComments.FindOrAdd(NodeUnderComment).Add(Comment);
+						}
+					}
+				}
+			}
+		}
+
+		GraphData.ContainingCommentsFrame = GFrameCounter;
+		GraphData.bContainingCommentsDirty = false;
+	}
+
+	if (const TArray<TWeakObjectPtr<UEdGraphNode_Comment>>* Comments = GraphData.ContainingComments.Find(Node))
+	{
+		for (const TWeakObjectPtr<UEdGraphNode_Comment>& Comment : *Comments)
+		{
+			if (Comment.IsValid())
+			{
+				OutComments.Add(Comment.Get());
+			}
+		}
+	}
+
+	return OutComments;
+}
+
+void FAutoSizeCommentGraphHandler::MarkCommentTreeDirty(UEdGraph* Graph)
+{
+	if (FASCGraphHandlerData* GraphData = GraphDatas.Find(Graph))
+	{
+		GraphData->bContainingCommentsDirty = true;
+
+		// the selected comments may have gained or lost nodes
+		GraphData->bRelatedNodesDirty = true;
+	}
+}
+
+void FAutoSizeCommentGraphHandler::InvalidateRelatedNodes(UEdGraph* Graph)
+{
+	if (FASCGraphHandlerData* GraphData = GraphDatas.Find(Graph))
+	{
+		GraphData->bUnrelatedStateApplied = false;
+	}
+}
+
 TArray<UEdGraph*> FAutoSizeCommentGraphHandler::GetActiveGraphs()
 {
 	TArray<TWeakObjectPtr<UEdGraph>> GraphWeakPtrs;
@@ -648,11 +787,87 @@ TArray<UEdGraph*> FAutoSizeCommentGraphHandler::GetActiveGraphs()
 
 bool FAutoSizeCommentGraphHandler::Tick(float DeltaTime)
 {
+	ProcessGraphChanges();
+
 	UpdateNodeUnrelatedState();
 
+	RemoveInvalidSpatialHashes();
+
 	return true;
 }
 
+void FAutoSizeCommentGraphHandler::ProcessQueuedComments(float DeltaTime)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FAutoSizeCommentGraphHandler::ProcessQueuedComments"), STAT_ASC_ProcessQueuedComments, STATGROUP_AutoSizeComments);
+
+	if (QueuedComments.Num() == 0)
+	{
+		return;
+	}
+
+	struct FQueuedComment
+	{
+		TSharedPtr<SAutoSizeCommentsGraphNode> Comment;
+		bool bVisible;
+		float Area;
+	};
+
+	TArray<FQueuedComment> Comments;
+	Comments.Reserve(QueuedComments.Num());
+	for (const TWeakPtr<SAutoSizeCommentsGraphNode>& CommentPtr : QueuedComments)
+	{
+		if (TSharedPtr<SAutoSizeCommentsGraphNode> Comment = CommentPtr.Pin())
+		{
+			const TSharedPtr<SGraphPanel> OwnerPanel = Comment->GetOwnerPanel();
+			const FVector2D Position = Comment->GetPosition();
+			const FVector2D Size = Comment->GetDesiredSize();
+
+			Comments.Add({ Comment, OwnerPanel.IsValid() && OwnerPanel->IsRectVisible(Position, Position + Size), Size.X * Size.Y });
+		}
+	}
+
+	QueuedComments.Reset();
+
+	// comments on screen first, then the smallest first: a comment nested inside another is always smaller, resizing
+	// it first lets the outer comment fit around its new size in the same frame
+	Comments.Sort([](const FQueuedComment& A, const FQueuedComment& B)
+	{
+		if (A.bVisible != B.bVisible)
+		{
+			return A.bVisible;
+		}
+
+		return A.Area < B.Area;
+	});
+
+	const double EndTime = FPlatformTime::Seconds() + CommentUpdateBudget;
+	for (int32 i = 0; i < Comments.Num(); ++i)
+	{
+		if (i > 0 && FPlatformTime::Seconds() > EndTime)
+		{
+			for (int32 Remaining = i; Remaining < Comments.Num(); ++Remaining)
+			{
+				QueuedComments.Add(Comments[Remaining].Comment);
+			}
+
+			break;
+		}
+
+		Comments[i].Comment->UpdateQueuedComment();
+	}
+}
+
+void FAutoSizeCommentGraphHandler::RemoveInvalidSpatialHashes()
+{
+	for (auto It = PanelSpatialHashes.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 void FAutoSizeCommentGraphHandler::UpdateNodeUnrelatedState()
 {
 	if (!UAutoSizeCommentsSettings::Get().bHighlightContainingNodesOnSelection)
@@ -693,18 +908,25 @@ void FAutoSizeCommentGraphHandler::UpdateNodeUnrelatedState()
 			}
 
 			// clear the unrelated nodes and empty the last selection set
-			if (bSelectedNonComment || (SelectedComments.Num() == 0 && GraphData->LastSelectionSet.Num() != 0))
+			if (bSelectedNonComment || SelectedComments.Num() == 0)
 			{
-				for (UEdGraphNode* Node : Graph->Nodes)
+				if (GraphData->bUnrelatedStateApplied || GraphData->LastSelectionSet.Num() != 0)
 				{
-					Node->SetNodeUnrelated(false);
+					for (UEdGraphNode* Node : Graph->Nodes)
+					{
+						Node->SetNodeUnrelated(false);
+					}
+
+					GraphData->RelatedNodes.Empty();
+					GraphData->bUnrelatedStateApplied = false;
 				}
 
 				GraphData->LastSelectionSet.Empty();
 				continue;
 			}
 
-			bool bRefreshSelectedNodes = false;
+			bool bRefreshSelectedNodes = GraphData->bRelatedNodesDirty;
+			GraphData->bRelatedNodesDirty = false;
 
 			// check if we need to refresh the selected nodes by seeing if we have deselected any nodes
 			for (TWeakObjectPtr<UEdGraphNode_Comment> LastSelected : GraphData->LastSelectionSet)
@@ -735,20 +957,49 @@ void FAutoSizeCommentGraphHandler::UpdateNodeUnrelatedState()
 
 			if (bRefreshSelectedNodes)
 			{
-				for (UEdGraphNode* Node : Graph->Nodes)
+				TSet<TWeakObjectPtr<UEdGraphNode>> RelatedNodes;
+				for (TWeakObjectPtr<UEdGraphNode_Comment> Comment : GraphData->LastSelectionSet)
 				{
-					Node->SetNodeUnrelated(true);
+					RelatedNodes.Add(Comment);
+
+					for (UObject* Obj : Comment->GetNodesUnderComment())
+					{
+						if (UEdGraphNode* Node = Cast<UEdGraphNode>(Obj))
+						{
+							RelatedNodes.Add(Node);
+						}
+					}
 				}
 
-				for (TWeakObjectPtr<UEdGraphNode_Comment> Comment : GraphData->LastSelectionSet)
+				if (!GraphData->bUnrelatedStateApplied)
+				{
+					for (UEdGraphNode* Node : Graph->Nodes)
+					{
+						Node->SetNodeUnrelated(!RelatedNodes.Contains(Node));
+					}
+				}
+				else
 				{
-					Comment->SetNodeUnrelated(false);
+					// only touch the nodes which changed state since the last selection
+					for (const TWeakObjectPtr<UEdGraphNode>& Node : GraphData->RelatedNodes)
+					{
+						if (Node.IsValid() && !RelatedNodes.Contains(Node))
+						{
+							Node->SetNodeUnrelated(true);
+						}
+					}
 
-					for (UEdGraphNode* Node : FASCUtils::GetNodesUnderComment(Comment.Get()))
+					for (const TWeakObjectPtr<UEdGraphNode>& Node : RelatedNodes)
 					{
-						Node->SetNodeUnrelated(false);
+						if (!GraphData->RelatedNodes.Contains(Node))
+						{
+							Node->SetNodeUnrelated(false);
+						}
 					}
 				}
+
+				GraphData->RelatedNodes = MoveTemp(RelatedNodes);
+				GraphData->bUnrelatedStateApplied = true;
 			}
 		}
 	}
@@ -823,19 +1074,26 @@ void FAutoSizeCommentGraphHandler::OnNodeDeleted(const FEdGraphEditAction& Actio
 	// remove any deleted nodes from their containing comments
 	if (Action.Graph)
 	{
-		TArray<UEdGraphNode_Comment*> Comments;
-		Action.Graph->GetNodesOfClass<UEdGraphNode_Comment>(Comments);
-
 		// is there a better way of converting this set of const ptrs to non-const ptrs?
 		TSet<UObject*> NodeToRemove;
+
+		// only the comments containing a deleted node need updating. collect them all before removing anything, since
+		// each removal marks the containing comments map dirty
+		TSet<UEdGraphNode_Comment*> CommentsToUpdate;
 		for (const UEdGraphNode* Node : Action.Nodes)
 		{
-			NodeToRemove.Add(const_cast<UEdGraphNode*>(Node));
+			UEdGraphNode* MutableNode = const_cast<UEdGraphNode*>(Node);
+			NodeToRemove.Add(MutableNode);
+			CommentsToUpdate.Append(GetContainingComments(MutableNode));
 		}
 
-		for (UEdGraphNode_Comment* Comment : Comments)
+		for (UEdGraphNode_Comment* Comment : CommentsToUpdate)
 		{
-			FASCUtils::RemoveNodesFromComment(Comment, NodeToRemove);
+			// a deleted comment is not in the graph any more, leave it as it was
+			if (!NodeToRemove.Contains(Comment))
+			{
+				FASCUtils::RemoveNodesFromComment(Comment, NodeToRemove);
+			}
 		}
 	}
 
@@ -863,6 +1121,8 @@ void FAutoSizeCommentGraphHandler::OnNodeDeleted(const FEdGraphEditAction& Actio
 
 	if (bResetUnrelatedNodes)
 	{
+		InvalidateRelatedNodes(Action.Graph);
+
 		for (UEdGraphNode* NodeToUpdate : Action.Graph->Nodes)
 		{
 			NodeToUpdate->SetNodeUnrelated(false);
@@ -900,7 +1160,8 @@ void FAutoSizeCommentGraphHandler::OnObjectSaved(UObject* Object)
 		if (!bPendingSave)
 		{
 			bPendingSave = true;
-			GEditor->GetTimerManager()->SetTimerForNextTick(FTimerDelegate::CreateRaw(this, &FAutoSizeCommentGraphHandler::SaveSizeCache));
+			// wait a little so a save all, which saves graph after graph, writes the cache once
+			GEditor->GetTimerManager()->SetTimer(SaveTimerHandle, FTimerDelegate::CreateRaw(this, &FAutoSizeCommentGraphHandler::SaveSizeCache), 2.0f, false);
 		}
 
 		if (UAutoSizeCommentsSettings::Get().CacheSaveMethod == EASCCacheSaveMethod::MetaData)
@@ -932,14 +1193,26 @@ void FAutoSizeCommentGraphHandler::OnObjectTransacted(UObject* Object, const FTr
 	if (Event.GetEventType() == ETransactionObjectEventType::UndoRedo ||
 		Event.GetEventType() == ETransactionObjectEventType::Finalized)
 	{
+		if (UEdGraphNode_Comment* Comment = Cast<UEdGraphNode_Comment>(Object))
+		{
+			MarkCommentTreeDirty(Comment->GetGraph());
+		}
+
+		// the comments containing the node are updated once for all of the tick's changes, see ProcessGraphChanges
 		if (UEdGraphNode* Node = Cast<UEdGraphNode>(Object))
 		{
-			if (GetResizingMode(Node->GetGraph()) != EASCResizingMode::Disabled)
+			if (FASCGraphHandlerData* GraphData = GraphDatas.Find(Node->GetGraph()))
 			{
-				GEditor->GetTimerManager()->SetTimerForNextTick(FTimerDelegate::CreateRaw(this, &FAutoSizeCommentGraphHandler::UpdateContainingComments, TWeakObjectPtr<UEdGraphNode>(Node)));
+				GraphData->GraphChanges.RecordTransacted(Object, Event);
+			}
+		}
+		else if (UEdGraph* Graph = Cast<UEdGraph>(Object))
+		{
+			if (FASCGraphHandlerData* GraphData = GraphDatas.Find(Graph))
+			{
+				GraphData->GraphChanges.RecordTransacted(Object, Event);
 			}
 		}
-		
 	}
 }
 
@@ -949,14 +1222,40 @@ void FAutoSizeCommentGraphHandler::SaveSizeCache()
 	bPendingSave = false;
 }
 
-void FAutoSizeCommentGraphHandler::UpdateContainingComments(TWeakObjectPtr<UEdGraphNode> Node)
+void FAutoSizeCommentGraphHandler::ProcessGraphChanges()
 {
-	if (!Node.IsValid() || !IsValid(Node.Get()))
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FAutoSizeCommentGraphHandler::ProcessGraphChanges"), STAT_ASC_ProcessGraphChanges, STATGROUP_AutoSizeComments);
+
+	FASCGraphDiff Diff;
+	TSet<UEdGraphNode*> ChangedNodes;
+	for (auto& Kvp : GraphDatas)
 	{
-		return;
+		UEdGraph* Graph = Kvp.Key.Get();
+		if (!Graph || !Kvp.Value.GraphChanges.Flush(Diff))
+		{
+			continue;
+		}
+
+		if (GetResizingMode(Graph) == EASCResizingMode::Disabled)
+		{
+			continue;
+		}
+
+		ChangedNodes.Reset();
+		ChangedNodes.Append(Diff.AddedNodes);
+		ChangedNodes.Append(Diff.MovedNodes);
+		ChangedNodes.Append(Diff.ResizedNodes);
+		ChangedNodes.Append(Diff.ModifiedNodes);
+
+		if (ChangedNodes.Num() > 0)
+		{
+			UpdateContainingComments(Graph, ChangedNodes);
+		}
 	}
+}
 
-	UEdGraph* Graph = Node->GetGraph();
+void FAutoSizeCommentGraphHandler::UpdateContainingComments(UEdGraph* Graph, const TSet<UEdGraphNode*>& Nodes)
+{
 	if (!IsValid(Graph))
 	{
 		return;
@@ -964,7 +1263,7 @@ void FAutoSizeCommentGraphHandler::UpdateContainingComments(TWeakObjectPtr<UEdGr
 
 	TArray<UEdGraphNode_Comment*> Comments;
 
-	// check if any node on the graph contains the new node
+	// check if any node on the graph contains one of the changed nodes
 	Graph->GetNodesOfClass<UEdGraphNode_Comment>(Comments);
 	for (UEdGraphNode_Comment* Comment : Comments)
 	{
@@ -972,8 +1271,16 @@ void FAutoSizeCommentGraphHandler::UpdateContainingComments(TWeakObjectPtr<UEdGr
 		{
 			TArray<UEdGraphNode*> NodesUnderComment;
 			FAutoSizeCommentsCacheFile::Get().GetNodesUnderComment(ASCComment, NodesUnderComment);
-			if (NodesUnderComment.Contains(Node))
+
+			const bool bContainsChangedNode = NodesUnderComment.ContainsByPredicate([&Nodes](UEdGraphNode* Node)
+			{
+				return Nodes.Contains(Node);
+			});
+
+			if (bContainsChangedNode)
 			{
+				// undo can restore a node's size without moving it, fit the comment again regardless
+				ASCComment->MarkBoundsDirty();
 				ASCComment->ResizeToFit();
 			}
 		}
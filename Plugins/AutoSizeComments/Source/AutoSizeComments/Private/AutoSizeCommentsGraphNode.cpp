@@ -17,6 +17,7 @@
 #include "TutorialMetaData.h"
 #include "Framework/Application/SlateApplication.h"
 #include "Runtime/Engine/Classes/EdGraph/EdGraph.h"
+#include "Styling/CoreStyle.h"
 #include "Widgets/SBoxPanel.h"
 #include "Widgets/Images/SImage.h"
 #include "Widgets/Input/SButton.h"
@@ -192,6 +193,9 @@ void SAutoSizeCommentsGraphNode::MoveTo(const FVector2D& NewPosition, FNodeSet&
 	SGraphNode::MoveTo(NewPos, NodeFilter);
 #endif
 
+	// the node bounds cached this frame are out of date
+	FAutoSizeCommentGraphHandler::Get().GetSpatialHash(GetOwnerPanel()).Invalidate();
+
 	FModifierKeysState KeysState = FSlateApplication::Get().GetModifierKeys();
 
 	const ECommentCollisionMethod AltCollisionMethod = UAutoSizeCommentsSettings::Get().AltCollisionMethod;
@@ -239,6 +243,8 @@ void SAutoSizeCommentsGraphNode::MoveTo(const FVector2D& NewPosition, FNodeSet&
 					}
 				}
 			}
+
+			FAutoSizeCommentGraphHandler::Get().GetSpatialHash(Panel).Invalidate();
 		}
 	}
 }
@@ -402,9 +408,36 @@ FReply SAutoSizeCommentsGraphNode::OnMouseButtonDoubleClick(const FGeometry& InM
 	return FReply::Unhandled();
 }
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Queries"), STAT_ASC_CollisionQueries, STATGROUP_AutoSizeComments);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Nodes Tested"), STAT_ASC_CollisionNodesTested, STATGROUP_AutoSizeComments);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resize Calls"), STAT_ASC_ResizeCalls, STATGROUP_AutoSizeComments);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resize Fits"), STAT_ASC_ResizeFits, STATGROUP_AutoSizeComments);
+
+// adds the time spent in the scope to the comment's debug cost, only measured while the overlay is shown
+struct FASCCommentCostScope
+{
+	FASCCommentCostScope(SAutoSizeCommentsGraphNode& InComment)
+		: Comment(UAutoSizeCommentsSettings::Get().bShowCommentCostOverlay ? &InComment : nullptr)
+		, StartTime(Comment ? FPlatformTime::Seconds() : 0.0)
+	{
+	}
+
+	~FASCCommentCostScope()
+	{
+		if (Comment)
+		{
+			Comment->AddDebugCost(FPlatformTime::Seconds() - StartTime);
+		}
+	}
+
+	SAutoSizeCommentsGraphNode* Comment;
+	double StartTime;
+};
+
 void SAutoSizeCommentsGraphNode::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("SAutoSizeCommentsGraphNode::Tick"), STAT_ASC_Tick, STATGROUP_AutoSizeComments);
+	FASCCommentCostScope CostScope(*this);
 
 	if (!bInitialized)
 	{
@@ -421,11 +454,24 @@ void SAutoSizeCommentsGraphNode::Tick(const FGeometry& AllottedGeometry, const d
 
 	const UAutoSizeCommentsSettings& ASCSettings = UAutoSizeCommentsSettings::Get();
 
-	bAreControlsEnabled = !AreResizeModifiersDown(false) && (!UAutoSizeCommentsSettings::Get().EnableCommentControlsKey.Key.IsValid() || bAreControlsEnabled);
+	const bool bDeferUpdates = ShouldDeferUpdates();
+	if (bDeferredUpdates && !bDeferUpdates)
+	{
+		// catch up on what changed while we were deferred, the queued update below fits us again
+		MarkBoundsDirty();
+		FAutoSizeCommentGraphHandler::Get().GetSpatialHash(GetOwnerPanel()).Invalidate();
+	}
+
+	bDeferredUpdates = bDeferUpdates;
+
+	if (!bDeferUpdates)
+	{
+		bAreControlsEnabled = !AreResizeModifiersDown(false) && (!UAutoSizeCommentsSettings::Get().EnableCommentControlsKey.Key.IsValid() || bAreControlsEnabled);
 
-	// We need to call this on tick since there are quite a few methods of deleting
-	// nodes without any callbacks (undo, collapse to function / macro...)
-	RemoveInvalidNodes();
+		// We need to call this on tick since there are quite a few methods of deleting
+		// nodes without any callbacks (undo, collapse to function / macro...)
+		RemoveInvalidNodes();
+	}
 
 	const EASCResizingMode ResizingMode = GetResizingMode();
 
@@ -435,9 +481,12 @@ void SAutoSizeCommentsGraphNode::Tick(const FGeometry& AllottedGeometry, const d
 		UserSize.Y = CommentNode->NodeHeight;
 	}
 
-	UpdateRefreshDelay();
+	if (!bDeferUpdates)
+	{
+		UpdateRefreshDelay();
+	}
 
-	if (RefreshNodesDelay == 0 && !IsHeaderComment() && !bUserIsDragging)
+	if (!bDeferUpdates && RefreshNodesDelay == 0 && !IsHeaderComment() && !bUserIsDragging)
 	{
 		const FModifierKeysState& KeysState = FSlateApplication::Get().GetModifierKeys();
 
@@ -455,18 +504,8 @@ void SAutoSizeCommentsGraphNode::Tick(const FGeometry& AllottedGeometry, const d
 				OnAltReleased();
 			}
 
-			if (ResizingMode == EASCResizingMode::Always)
-			{
-				ResizeToFit();
-			}
-			else if (ResizingMode == EASCResizingMode::Reactive &&
-				FAutoSizeCommentGraphHandler::Get().HasCommentChanged(CommentNode))
-			{
-				FAutoSizeCommentGraphHandler::Get().UpdateCommentChangeState(CommentNode);
-				ResizeToFit();
-			}
-
-			MoveEmptyCommentBoxes();
+			// the graph handler updates the queued comments of every graph within a time budget
+			FAutoSizeCommentGraphHandler::Get().QueueCommentUpdate(SharedThis(this));
 
 			// if (ResizeTransaction.IsValid())
 			// {
@@ -538,6 +577,9 @@ void SAutoSizeCommentsGraphNode::Tick(const FGeometry& AllottedGeometry, const d
 
 void SAutoSizeCommentsGraphNode::UpdateGraphNode()
 {
+	// the font size or style changed, the title bar might have a new height
+	MarkBoundsDirty();
+
 	const UAutoSizeCommentsSettings& ASCSettings = UAutoSizeCommentsSettings::Get();
 
 	// No pins in a comment box
@@ -944,6 +986,59 @@ FCursorReply SAutoSizeCommentsGraphNode::OnCursorQuery(const FGeometry& MyGeomet
 	return FCursorReply::Unhandled();
 }
 
+int32 SAutoSizeCommentsGraphNode::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const int32 MaxLayerId = SGraphNode::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+
+	if (!UAutoSizeCommentsSettings::Get().bShowCommentCostOverlay)
+	{
+		return MaxLayerId;
+	}
+
+	const FString CostText = FString::Printf(TEXT("%.3f ms | %.1f fits/s"), DebugAverageSeconds * 1000.0, DebugFitsPerSecond);
+
+	// above the title bar, where it doesn't cover the comment text
+	const FVector2D TextOffset(0, -16);
+	const FVector2D TextSize(AllottedGeometry.GetLocalSize().X, 16);
+#if ASC_UE_VERSION_OR_LATER(5, 2)
+	const FPaintGeometry PaintGeometry = AllottedGeometry.ToPaintGeometry(TextSize, FSlateLayoutTransform(TextOffset));
+#else
+	const FPaintGeometry PaintGeometry = AllottedGeometry.ToPaintGeometry(TextOffset, TextSize);
+#endif
+
+	FSlateDrawElement::MakeText(
+		OutDrawElements,
+		MaxLayerId + 1,
+		PaintGeometry,
+		CostText,
+		FCoreStyle::GetDefaultFontStyle("Regular", 10),
+		ESlateDrawEffect::None,
+		FLinearColor::Yellow);
+
+	return MaxLayerId + 1;
+}
+
+void SAutoSizeCommentsGraphNode::AddDebugCost(double Seconds)
+{
+	if (DebugCostFrame != GFrameCounter)
+	{
+		// smooth over the last frames so the number is readable
+		DebugAverageSeconds = FMath::Lerp(DebugAverageSeconds, DebugFrameSeconds, 0.1);
+		DebugFrameSeconds = 0;
+		DebugCostFrame = GFrameCounter;
+
+		const double Now = FPlatformTime::Seconds();
+		if (Now - DebugFitWindowStart >= 1.0)
+		{
+			DebugFitsPerSecond = DebugFitWindowStart > 0 ? DebugFitCount / (Now - DebugFitWindowStart) : 0;
+			DebugFitCount = 0;
+			DebugFitWindowStart = Now;
+		}
+	}
+
+	DebugFrameSeconds += Seconds;
+}
+
 int32 SAutoSizeCommentsGraphNode::GetSortDepth() const
 {
 	if (!CommentNode)
@@ -1220,7 +1315,7 @@ void SAutoSizeCommentsGraphNode::UpdateRefreshDelay()
 
 			if (UAutoSizeCommentsSettings::Get().bEnableFixForSortDepthIssue)
 			{
-				FAutoSizeCommentGraphHandler::Get().RequestGraphVisualRefresh(GetOwnerPanel());
+				FAutoSizeCommentGraphHandler::Get().RequestSortDepthUpdate(CommentNode);
 			}
 		}
 	}
@@ -1322,7 +1417,7 @@ void SAutoSizeCommentsGraphNode::UpdateExistingCommentNodes(const TArray<UEdGrap
 		return;
 	}
 
-	bool bNeedsPurging = false;
+	bool bNeedsSortDepthUpdate = false;
 	for (TSharedPtr<SAutoSizeCommentsGraphNode> OtherCommentNode : OtherCommentNodes)
 	{
 		UEdGraphNode_Comment* OtherComment = OtherCommentNode->GetCommentNodeObj();
@@ -1365,7 +1460,7 @@ void SAutoSizeCommentsGraphNode::UpdateExistingCommentNodes(const TArray<UEdGrap
 		{
 			// add the other comment into ourself
 			FASCUtils::AddNodeIntoComment(CommentNode, OtherComment);
-			bNeedsPurging = true;
+			bNeedsSortDepthUpdate = true;
 		}
 		else
 		{
@@ -1380,14 +1475,14 @@ void SAutoSizeCommentsGraphNode::UpdateExistingCommentNodes(const TArray<UEdGrap
 			{
 				// add the ourselves into the other comment
 				FASCUtils::AddNodeIntoComment(OtherComment, CommentNode);
-				bNeedsPurging = true;
+				bNeedsSortDepthUpdate = true;
 			}
 		}
 	}
 
-	if (bNeedsPurging && UAutoSizeCommentsSettings::Get().bEnableFixForSortDepthIssue)
+	if (bNeedsSortDepthUpdate && UAutoSizeCommentsSettings::Get().bEnableFixForSortDepthIssue)
 	{
-		FAutoSizeCommentGraphHandler::Get().RequestGraphVisualRefresh(GetOwnerPanel());
+		FAutoSizeCommentGraphHandler::Get().RequestSortDepthUpdate(CommentNode);
 	}
 }
 
@@ -1463,6 +1558,7 @@ FASCCommentData& SAutoSizeCommentsGraphNode::GetCommentData() const
 void SAutoSizeCommentsGraphNode::ResizeToFit()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("SAutoSizeCommentsGraphNode::ResizeToFit"), STAT_ASC_ResizeToFit, STATGROUP_AutoSizeComments);
+	INC_DWORD_STAT(STAT_ASC_ResizeCalls);
 
 	// resize to fit the bounds of the nodes under the comment
 	if (CommentNode->GetNodesUnderComment().Num() > 0)
@@ -1478,10 +1574,21 @@ void SAutoSizeCommentsGraphNode::ResizeToFit()
 
 		const float BottomPadding = !ASCSettings.bHideCommentBoxControls ? VerticalPadding : Padding.Y;
 
-		const FSlateRect Bounds = GetBoundsForNodesInside().ExtendBy(FMargin(Padding.X, TopPadding, Padding.X, BottomPadding));
-
 		const float TitleBarHeight = GetTitleBarHeight();
 
+		// skip fitting when nothing inside moved or resized and the comment is where we left it
+		const FMargin FitPadding(Padding.X, TopPadding + TitleBarHeight, Padding.X, BottomPadding);
+		const bool bNodeBoundsChanged = UpdateCachedNodeBounds();
+		if (!bNodeBoundsChanged && FitPadding == LastFitPadding && GetPosition().Equals(LastFitPosition, .1f) && UserSize.Equals(LastFitSize, .1f))
+		{
+			return;
+		}
+
+		INC_DWORD_STAT(STAT_ASC_ResizeFits);
+		++DebugFitCount;
+
+		const FSlateRect Bounds = GetBoundsForNodesInside().ExtendBy(FMargin(Padding.X, TopPadding, Padding.X, BottomPadding));
+
 		// check if size has changed
 		FVector2D CurrSize = Bounds.GetSize();
 		CurrSize.Y += TitleBarHeight;
@@ -1502,6 +1609,10 @@ void SAutoSizeCommentsGraphNode::ResizeToFit()
 			GraphNode->NodePosX = DesiredPos.X;
 			GraphNode->NodePosY = DesiredPos.Y;
 		}
+
+		LastFitPadding = FitPadding;
+		LastFitPosition = GetPosition();
+		LastFitSize = UserSize;
 	}
 	else
 	{
@@ -1525,6 +1636,58 @@ void SAutoSizeCommentsGraphNode::ResizeToFit()
 	}
 }
 
+void SAutoSizeCommentsGraphNode::UpdateQueuedComment()
+{
+	FASCCommentCostScope CostScope(*this);
+
+	if (!CommentNode || !OwnerGraphPanelPtr.IsValid())
+	{
+		return;
+	}
+
+	const FVector2D OldPosition = GetPosition();
+	const FVector2D OldSize = UserSize;
+
+	const EASCResizingMode ResizingMode = GetResizingMode();
+	if (ResizingMode == EASCResizingMode::Always)
+	{
+		ResizeToFit();
+	}
+	else if (ResizingMode == EASCResizingMode::Reactive &&
+		FAutoSizeCommentGraphHandler::Get().HasCommentChanged(CommentNode))
+	{
+		FAutoSizeCommentGraphHandler::Get().UpdateCommentChangeState(CommentNode);
+		ResizeToFit();
+	}
+
+	if (!GetPosition().Equals(OldPosition) || !UserSize.Equals(OldSize))
+	{
+		ResizeParentComments();
+	}
+
+	MoveEmptyCommentBoxes();
+}
+
+void SAutoSizeCommentsGraphNode::ResizeParentComments()
+{
+	TArray<UEdGraphNode_Comment*> ParentComments = GetParentComments();
+
+	// a parent contains all of its children so it is always bigger than them
+	ParentComments.Sort([](const UEdGraphNode_Comment& A, const UEdGraphNode_Comment& B)
+	{
+		return static_cast<int64>(A.NodeWidth) * A.NodeHeight < static_cast<int64>(B.NodeWidth) * B.NodeHeight;
+	});
+
+	for (UEdGraphNode_Comment* ParentComment : ParentComments)
+	{
+		TSharedPtr<SAutoSizeCommentsGraphNode> ASCParent = FASCState::Get().GetASCComment(ParentComment);
+		if (ASCParent.IsValid() && ASCParent->GetResizingMode() != EASCResizingMode::Disabled)
+		{
+			ASCParent->ResizeToFit();
+		}
+	}
+}
+
 void SAutoSizeCommentsGraphNode::ApplyHeaderStyle()
 {
 	FPresetCommentStyle Style = UAutoSizeCommentsSettings::Get().HeaderStyle;
@@ -1859,20 +2022,7 @@ TSet<TSharedPtr<SAutoSizeCommentsGraphNode>> SAutoSizeCommentsGraphNode::GetOthe
 TArray<UEdGraphNode_Comment*> SAutoSizeCommentsGraphNode::GetParentComments() const
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("SAutoSizeCommentsGraphNode::GetParentComments"), STAT_ASC_GetParentComments, STATGROUP_AutoSizeComments);
-	TArray<UEdGraphNode_Comment*> ParentComments;
-
-	for (UEdGraphNode* OtherNode : CommentNode->GetGraph()->Nodes)
-	{
-		if (auto OtherComment = Cast<UEdGraphNode_Comment>(OtherNode))
-		{
-			if (OtherComment != CommentNode && OtherComment->GetNodesUnderComment().Contains(CommentNode))
-			{
-				ParentComments.Add(OtherComment);
-			}
-		}
-	}
-
-	return ParentComments;
+	return FAutoSizeCommentGraphHandler::Get().GetContainingComments(CommentNode);
 }
 
 FSlateRect SAutoSizeCommentsGraphNode::GetCommentBounds(UEdGraphNode_Comment* InCommentNode)
@@ -2064,6 +2214,8 @@ bool SAutoSizeCommentsGraphNode::IsNodeUnrelated() const
 void SAutoSizeCommentsGraphNode::SetNodesRelated(const TArray<UEdGraphNode*>& Nodes, bool bIncludeSelf)
 {
 #if ASC_UE_VERSION_OR_LATER(4, 23)
+	FAutoSizeCommentGraphHandler::Get().InvalidateRelatedNodes(GetNodeObj()->GetGraph());
+
 	const TArray<UEdGraphNode*>& AllNodes = GetNodeObj()->GetGraph()->Nodes;
 	for (UEdGraphNode* Node : AllNodes)
 	{
@@ -2087,6 +2239,8 @@ void SAutoSizeCommentsGraphNode::ResetNodesUnrelated()
 #if ASC_UE_VERSION_OR_LATER(4, 23)
 	if (UEdGraph* Graph = GetNodeObj()->GetGraph())
 	{
+		FAutoSizeCommentGraphHandler::Get().InvalidateRelatedNodes(Graph);
+
 		for (UEdGraphNode* Node : Graph->Nodes)
 		{
 			Node->SetNodeUnrelated(false);
@@ -2111,6 +2265,36 @@ FASCCommentData& SAutoSizeCommentsGraphNode::GetCommentData()
 	return FAutoSizeCommentsCacheFile::Get().GetCommentData(CommentNode);
 }
 
+bool SAutoSizeCommentsGraphNode::ShouldDeferUpdates() const
+{
+	TSharedPtr<SGraphPanel> OwnerPanel = OwnerGraphPanelPtr.Pin();
+	if (!OwnerPanel)
+	{
+		return false;
+	}
+
+	// never hold back the comment the user is working with
+	if (bUserIsDragging || bIsDragging || bIsMoving || OwnerPanel->SelectionManager.IsNodeSelected(GraphNode))
+	{
+		return false;
+	}
+
+	const UAutoSizeCommentsSettings& ASCSettings = UAutoSizeCommentsSettings::Get();
+
+	if (ASCSettings.bDeferCommentUpdatesWhenZoomedOut && GetLOD() <= EGraphRenderingLOD::LowestDetail)
+	{
+		return true;
+	}
+
+	if (ASCSettings.bDeferOffscreenCommentUpdates)
+	{
+		const FVector2D NodePosition = GetPosition();
+		return !OwnerPanel->IsRectVisible(NodePosition, NodePosition + UserSize);
+	}
+
+	return false;
+}
+
 EGraphRenderingLOD::Type SAutoSizeCommentsGraphNode::GetLOD() const
 {
 	return FAutoSizeCommentGraphHandler::Get().GetGraphLOD(OwnerGraphPanelPtr.Pin());
@@ -2137,6 +2321,7 @@ bool SAutoSizeCommentsGraphNode::IsPresetStyle()
 bool SAutoSizeCommentsGraphNode::LoadCache()
 {
 	CommentNode->ClearNodesUnderComment();
+	FAutoSizeCommentGraphHandler::Get().MarkCommentTreeDirty(CommentNode->GetGraph());
 
 	TArray<UEdGraphNode*> OutNodesUnder;
 	if (FAutoSizeCommentsCacheFile::Get().GetNodesUnderComment(SharedThis(this), OutNodesUnder))
@@ -2177,6 +2362,8 @@ void SAutoSizeCommentsGraphNode::QueryNodesUnderComment(TArray<TSharedPtr<SGraph
 		return;
 	}
 
+	INC_DWORD_STAT(STAT_ASC_CollisionQueries);
+
 	TSharedPtr<SGraphPanel> OwnerPanel = GetOwnerPanel();
 
 	float TitleBarHeight = GetTitleBarHeight();
@@ -2189,14 +2376,14 @@ void SAutoSizeCommentsGraphNode::QueryNodesUnderComment(TArray<TSharedPtr<SGraph
 
 	const FSlateRect CommentRect = FSlateRect::FromPointAndExtent(NodePosition, NodeSize).ExtendBy(1);
 
-	FChildren* PanelChildren = OwnerPanel->GetAllChildren();
-	int32 NumChildren = PanelChildren->Num();
+	// only test the nodes near the comment, the hash is shared by all comments on the panel
+	TArray<FASCNodeGeometry> NearbyNodes;
+	FAutoSizeCommentGraphHandler::Get().GetSpatialHash(OwnerPanel).QueryNodes(OwnerPanel, CommentRect, NearbyNodes);
+	INC_DWORD_STAT_BY(STAT_ASC_CollisionNodesTested, NearbyNodes.Num());
 
-	// Iterate across all nodes in the graph
-	for (int32 NodeIndex = 0; NodeIndex < NumChildren; ++NodeIndex)
+	for (const FASCNodeGeometry& SomeNode : NearbyNodes)
 	{
-		const TSharedRef<SGraphNode> SomeNodeWidget = StaticCastSharedRef<SGraphNode>(PanelChildren->GetChildAt(NodeIndex));
-
+		const TSharedPtr<SGraphNode>& SomeNodeWidget = SomeNode.Widget;
 		UObject* GraphObject = SomeNodeWidget->GetObjectBeingDisplayed();
 		if (GraphObject == nullptr || GraphObject == CommentNode)
 		{
@@ -2204,8 +2391,8 @@ void SAutoSizeCommentsGraphNode::QueryNodesUnderComment(TArray<TSharedPtr<SGraph
 		}
 
 		// check if the node bounds collides with our bounds
-		const FVector2D SomeNodePosition = SomeNodeWidget->GetPosition();
-		const FVector2D SomeNodeSize = SomeNodeWidget->GetDesiredSize();
+		const FVector2D SomeNodePosition = SomeNode.Position;
+		const FVector2D SomeNodeSize = SomeNode.Size;
 		const FSlateRect NodeGeometryGraphSpace = FSlateRect::FromPointAndExtent(SomeNodePosition, SomeNodeSize);
 
 		bool bIsOverlapping = false;
@@ -2335,11 +2522,20 @@ FSlateRect SAutoSizeCommentsGraphNode::GetNodeBounds(UEdGraphNode* Node)
 	FVector2D Pos(Node->NodePosX, Node->NodePosY);
 	FVector2D Size(300, 150);
 
-	TSharedPtr<SGraphNode> LocalGraphNode = FASCUtils::GetGraphNode(GetOwnerPanel(), Node);
-	if (LocalGraphNode.IsValid())
+	// read from the panel's hash, the comments containing a node all ask for its bounds in the same frame
+	TSharedPtr<SGraphPanel> OwnerPanel = GetOwnerPanel();
+	FASCNodeGeometry Geometry;
+	if (OwnerPanel.IsValid() && FAutoSizeCommentGraphHandler::Get().GetSpatialHash(OwnerPanel).FindNode(OwnerPanel, Node, Geometry))
 	{
-		Pos = LocalGraphNode->GetPosition();
-		Size = LocalGraphNode->GetDesiredSize();
+		TSharedPtr<SGraphNode> LocalGraphNode = Geometry.Widget;
+		Pos = Geometry.Position;
+		Size = Geometry.Size;
+
+		// a comment resized this frame is only laid out next frame, its desired size would be out of date
+		if (UEdGraphNode_Comment* OtherComment = Cast<UEdGraphNode_Comment>(Node))
+		{
+			Size = FVector2D(OtherComment->NodeWidth, OtherComment->NodeHeight);
+		}
 
 		if (UAutoSizeCommentsSettings::Get().bUseCommentBubbleBounds && Node->bCommentBubbleVisible)
 		{
@@ -2367,8 +2563,10 @@ bool SAutoSizeCommentsGraphNode::AnySelectedNodes()
 	return OwnerPanel->SelectionManager.GetSelectedNodes().Num() > 0;
 }
 
-FSlateRect SAutoSizeCommentsGraphNode::GetBoundsForNodesInside()
+bool SAutoSizeCommentsGraphNode::UpdateCachedNodeBounds()
 {
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("SAutoSizeCommentsGraphNode::UpdateCachedNodeBounds"), STAT_ASC_UpdateCachedNodeBounds, STATGROUP_AutoSizeComments);
+
 	TArray<UEdGraphNode*> Nodes;
 	for (UObject* Obj : CommentNode->GetNodesUnderComment())
 	{
@@ -2388,26 +2586,42 @@ FSlateRect SAutoSizeCommentsGraphNode::GetBoundsForNodesInside()
 		}
 	}
 
-	bool bBoundsInit = false;
-	FSlateRect Bounds;
-	for (int i = 0; i < Nodes.Num(); i++)
+	bool bChanged = bBoundsDirty || Nodes.Num() != CachedNodeBounds.Num();
+
+	TMap<TWeakObjectPtr<UEdGraphNode>, FSlateRect> NewNodeBounds;
+	NewNodeBounds.Reserve(Nodes.Num());
+	for (UEdGraphNode* Node : Nodes)
 	{
-		UEdGraphNode* Node = Nodes[i];
+		const FSlateRect NodeBounds = GetNodeBounds(Node);
+		NewNodeBounds.Add(Node, NodeBounds);
 
-		if (!Node)
+		if (!bChanged)
 		{
-			continue;
+			const FSlateRect* OldBounds = CachedNodeBounds.Find(Node);
+			bChanged = !OldBounds || *OldBounds != NodeBounds;
 		}
+	}
+
+	CachedNodeBounds = MoveTemp(NewNodeBounds);
+	bBoundsDirty = false;
+	return bChanged;
+}
 
+FSlateRect SAutoSizeCommentsGraphNode::GetBoundsForNodesInside() const
+{
+	bool bBoundsInit = false;
+	FSlateRect Bounds;
+	for (const auto& Kvp : CachedNodeBounds)
+	{
 		// initialize bounds from first valid node
 		if (!bBoundsInit)
 		{
-			Bounds = GetNodeBounds(Node);
+			Bounds = Kvp.Value;
 			bBoundsInit = true;
 		}
 		else
 		{
-			Bounds = Bounds.Expand(GetNodeBounds(Node));
+			Bounds = Bounds.Expand(Kvp.Value);
 		}
 	}
 
@@ -10,6 +10,7 @@
 #include "AutoSizeCommentsSettings.h"
 #include "AutoSizeCommentsStyle.h"
 #include "ISettingsModule.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 #define LOCTEXT_NAMESPACE "FAutoSizeCommentsModule"
 
@@ -26,6 +27,8 @@ void FAutoSizeCommentsModule::StartupModule()
 
 void FAutoSizeCommentsModule::OnPostEngineInit()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(PluginStartup_AutoSizeComments);
+
 	UE_LOG(LogAutoSizeComments, Log, TEXT("Startup AutoSizeComments"));
 
 	FAutoSizeCommentsCacheFile::Get().Init();
@@ -7,6 +7,8 @@
 #include "AutoSizeCommentsSettings.h"
 #include "ISourceControlModule.h"
 #include "ISourceControlProvider.h"
+#include "ISourceControlState.h"
+#include "SourceControlOperations.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
@@ -250,6 +252,104 @@ void FAutoSizeCommentsNotifications::ShowBlueprintAssistNotification()
 	BlueprintAssistNotification.Pin()->SetCompletionState(SNotificationItem::CS_Pending);
 }
 
+bool FAutoSizeCommentsNotifications::IsFileLockedBySourceControl(const FString& Filename)
+{
+	// a file's status is trusted for this long before it is asked for again
+	constexpr double FileStatusLifetime = 60.0;
+
+	ISourceControlModule* SourceControlModule = GetSourceControlModule();
+	if (!SourceControlModule || !SourceControlModule->IsEnabled())
+	{
+		return false;
+	}
+
+	const FString FullPath = FPaths::ConvertRelativePathToFull(Filename);
+
+	const FFileStatus* Status = FileStatuses.Find(FullPath);
+	if (!Status || FPlatformTime::Seconds() - Status->UpdateTime > FileStatusLifetime)
+	{
+		FilesAwaitingStatus.Add(FullPath);
+		UpdateFileStatus();
+	}
+
+	return Status && Status->bLocked;
+}
+
+void FAutoSizeCommentsNotifications::UpdateFileStatus()
+{
+	// one update at a time, the files asked for meanwhile go with the next one
+	if (bUpdatingFileStatus || FilesAwaitingStatus.Num() == 0)
+	{
+		return;
+	}
+
+	ISourceControlModule* SourceControlModule = GetSourceControlModule();
+	if (!SourceControlModule || !SourceControlModule->IsEnabled() || !SourceControlModule->GetProvider().IsAvailable())
+	{
+		FilesAwaitingStatus.Reset();
+		return;
+	}
+
+	TArray<FString> Files = FilesAwaitingStatus.Array();
+	FilesAwaitingStatus.Reset();
+	bUpdatingFileStatus = true;
+
+	SourceControlModule->GetProvider().Execute(
+		ISourceControlOperation::Create<FUpdateStatus>(),
+		Files,
+		EConcurrency::Asynchronous,
+		FSourceControlOperationComplete::CreateRaw(this, &FAutoSizeCommentsNotifications::HandleFileStatusUpdated, Files));
+}
+
+void FAutoSizeCommentsNotifications::HandleFileStatusUpdated(const FSourceControlOperationRef& Operation, ECommandResult::Type Result, TArray<FString> Files)
+{
+	bUpdatingFileStatus = false;
+
+	ISourceControlModule* SourceControlModule = GetSourceControlModule();
+	if (!SourceControlModule || !SourceControlModule->IsEnabled())
+	{
+		return;
+	}
+
+	ISourceControlProvider& Provider = SourceControlModule->GetProvider();
+	const double Now = FPlatformTime::Seconds();
+
+	for (const FString& File : Files)
+	{
+		FFileStatus& Status = FileStatuses.FindOrAdd(File);
+		Status.UpdateTime = Now;
+
+		// the update just filled the provider's state cache, reading it does not query the server again
+		const FSourceControlStatePtr State = Result == ECommandResult::Succeeded ? Provider.GetState(File, EStateCacheUsage::Use) : nullptr;
+		Status.bLocked = State.IsValid() && State->IsSourceControlled() && !State->IsCheckedOut() && !State->IsAdded();
+	}
+
+	UpdateFileStatus();
+}
+
+void FAutoSizeCommentsNotifications::ShowCacheFilesLockedNotification(int32 NumFiles)
+{
+	if (bShownCacheFilesLockedNotification)
+	{
+		return;
+	}
+
+	bShownCacheFilesLockedNotification = true;
+
+	const FString Message = FString::Printf(TEXT("%d cache files are under source control and not checked out, they were not saved. Check them out or set 'Cache Save Location' to 'Plugin'"), NumFiles);
+
+#if ASC_UE_VERSION_OR_LATER(5, 0)
+	FNotificationInfo Info(FText::FromString("Auto Size Comments"));
+	Info.SubText = FText::FromString(Message);
+#else
+	FNotificationInfo Info(FText::FromString("[AutoSizeComments] " + Message));
+#endif
+	Info.ExpireDuration = 8.0f;
+	Info.bUseSuccessFailIcons = false;
+
+	FSlateNotificationManager::Get().AddNotification(Info);
+}
+
 ISourceControlModule* FAutoSizeCommentsNotifications::GetSourceControlModule()
 {
 	return FModuleManager::GetModulePtr<ISourceControlModule>("SourceControl");
@@ -3,10 +3,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ISourceControlProvider.h"
 #include "Misc/LazySingleton.h"
 
 class ISourceControlModule;
-class ISourceControlProvider;
 
 class AUTOSIZECOMMENTS_API FAutoSizeCommentsNotifications
 {
@@ -17,6 +17,15 @@ public:
 	void Initialize();
 	void Shutdown();
 
+	/**
+	 * Whether the last status update found the file under source control and not checked out, so writing it would fail.
+	 * Never waits on the provider: unknown or stale files are queued for an asynchronous update and read as not locked until it completes.
+	 */
+	bool IsFileLockedBySourceControl(const FString& Filename);
+
+	/** Tell the user once per session that cache files could not be written because source control has them locked */
+	void ShowCacheFilesLockedNotification(int32 NumFiles);
+
 protected:
 	// ~~ Source control related
 	TWeakPtr<SNotificationItem> SourceControlNotification;
@@ -26,6 +35,22 @@ protected:
 	bool ShouldShowSourceControlNotification();
 	// ~~ Source control related
 
+	// ~~ Source control file status
+	struct FFileStatus
+	{
+		bool bLocked = false;
+		double UpdateTime = 0.0;
+	};
+
+	TMap<FString, FFileStatus> FileStatuses;
+	TSet<FString> FilesAwaitingStatus;
+	bool bUpdatingFileStatus = false;
+	bool bShownCacheFilesLockedNotification = false;
+
+	void UpdateFileStatus();
+	void HandleFileStatusUpdated(const FSourceControlOperationRef& Operation, ECommandResult::Type Result, TArray<FString> Files);
+	// ~~ Source control file status
+
 	// ~~ Blueprint Assist related
 	TWeakPtr<SNotificationItem> BlueprintAssistNotification;
 	void ShowBlueprintAssistNotification();
@@ -62,7 +62,6 @@ UAutoSizeCommentsSettings::UAutoSizeCommentsSettings(const FObjectInitializer& O
 	CacheSaveLocation = EASCCacheSaveLocation::Project;
 	bSaveCommentDataOnSavingGraph = true;
 	bSaveCommentDataOnExit = true;
-	bPrettyPrintCommentCacheJSON = false;
 	bDetectNodesContainedForNewComments = true;
 	ResizeChord = FInputChord(EKeys::LeftMouseButton, EModifierKey::Shift);
 	ResizeCollisionMethod = ECommentCollisionMethod::Contained;
@@ -79,6 +78,8 @@ UAutoSizeCommentsSettings::UAutoSizeCommentsSettings(const FObjectInitializer& O
 	bDisableTooltip = true;
 	bHighlightContainingNodesOnSelection = true;
 	bUseMaxDetailNodes = ASC_UE_VERSION_OR_LATER(5, 0);
+	bDeferOffscreenCommentUpdates = true;
+	bDeferCommentUpdatesWhenZoomedOut = true;
 	IgnoredGraphs.Add("ControlRigGraph");
 	bSuppressSuggestedSettings = false;
 	bSuppressSourceControlNotification = false;
@@ -93,6 +94,7 @@ UAutoSizeCommentsSettings::UAutoSizeCommentsSettings(const FObjectInitializer& O
 
 	bDebugGraph_ASC = false;
 	bDisablePackageCleanup = false;
+	bShowCommentCostOverlay = false;
 	bDisableASCGraphNode = false;
 }
 
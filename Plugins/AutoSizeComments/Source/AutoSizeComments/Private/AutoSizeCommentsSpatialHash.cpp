@@ -0,0 +1,155 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "AutoSizeCommentsSpatialHash.h"
+
+#include "AutoSizeCommentsGraphNode.h"
+#include "SGraphNode.h"
+#include "SGraphPanel.h"
+
+void FASCNodeSpatialHash::QueryNodes(TSharedPtr<SGraphPanel> GraphPanel, const FSlateRect& Rect, TArray<FASCNodeGeometry>& OutNodes)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FASCNodeSpatialHash::QueryNodes"), STAT_ASC_SpatialHashQueryNodes, STATGROUP_AutoSizeComments);
+
+	if (!GraphPanel.IsValid())
+	{
+		return;
+	}
+
+	if (NeedsRebuild(GraphPanel))
+	{
+		Rebuild(GraphPanel);
+	}
+
+	const FIntPoint MinCell = GetCell(Rect.GetTopLeft());
+	const FIntPoint MaxCell = GetCell(Rect.GetBottomRight());
+	const int64 NumQueryCells = static_cast<int64>(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1);
+
+	TArray<int32> FoundIndices;
+
+	// looking up more cells than there are nodes is slower than returning all of them
+	if (NumQueryCells > Nodes.Num())
+	{
+		FoundIndices.Reserve(Nodes.Num());
+		for (int32 i = 0; i < Nodes.Num(); ++i)
+		{
+			FoundIndices.Add(i);
+		}
+	}
+	else
+	{
+		FoundIndices = LargeNodes;
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				if (const TArray<int32>* Cell = Cells.Find(FIntPoint(X, Y)))
+				{
+					FoundIndices.Append(*Cell);
+				}
+			}
+		}
+
+		// a node is in every cell it overlaps, sorting also keeps the panel order
+		FoundIndices.Sort();
+	}
+
+	int32 LastIndex = INDEX_NONE;
+	for (int32 Index : FoundIndices)
+	{
+		if (Index == LastIndex)
+		{
+			continue;
+		}
+
+		LastIndex = Index;
+
+		FASCNodeGeometry Geometry;
+		if (GetGeometry(Index, Geometry))
+		{
+			OutNodes.Add(MoveTemp(Geometry));
+		}
+	}
+}
+
+bool FASCNodeSpatialHash::FindNode(TSharedPtr<SGraphPanel> GraphPanel, const UEdGraphNode* Node, FASCNodeGeometry& OutGeometry)
+{
+	if (!GraphPanel.IsValid() || !Node)
+	{
+		return false;
+	}
+
+	if (NeedsRebuild(GraphPanel))
+	{
+		Rebuild(GraphPanel);
+	}
+
+	const int32* Index = NodeLookup.Find(Node);
+	return Index && GetGeometry(*Index, OutGeometry);
+}
+
+bool FASCNodeSpatialHash::GetGeometry(int32 Index, FASCNodeGeometry& OutGeometry) const
+{
+	const FNodeEntry& Entry = Nodes[Index];
+	OutGeometry.Widget = Entry.Widget.Pin();
+	OutGeometry.Position = Entry.Position;
+	OutGeometry.Size = Entry.Size;
+	return OutGeometry.Widget.IsValid();
+}
+
+bool FASCNodeSpatialHash::NeedsRebuild(TSharedPtr<SGraphPanel> GraphPanel) const
+{
+	return bDirty || BuiltFrame != GFrameCounter || BuiltNumChildren != GraphPanel->GetAllChildren()->Num();
+}
+
+void FASCNodeSpatialHash::Rebuild(TSharedPtr<SGraphPanel> GraphPanel)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FASCNodeSpatialHash::Rebuild"), STAT_ASC_SpatialHashRebuild, STATGROUP_AutoSizeComments);
+
+	Nodes.Reset();
+	NodeLookup.Reset();
+	Cells.Reset();
+	LargeNodes.Reset();
+
+	FChildren* PanelChildren = GraphPanel->GetAllChildren();
+	const int32 NumChildren = PanelChildren->Num();
+	Nodes.Reserve(NumChildren);
+
+	for (int32 NodeIndex = 0; NodeIndex < NumChildren; ++NodeIndex)
+	{
+		const TSharedRef<SGraphNode> NodeWidget = StaticCastSharedRef<SGraphNode>(PanelChildren->GetChildAt(NodeIndex));
+		const FVector2D NodePosition = NodeWidget->GetPosition();
+		const FVector2D NodeSize = NodeWidget->GetDesiredSize();
+		const int32 Index = Nodes.Add(FNodeEntry { NodeWidget, NodePosition, NodeSize });
+
+		if (const UEdGraphNode* Node = NodeWidget->GetNodeObj())
+		{
+			NodeLookup.Add(Node, Index);
+		}
+
+		const FIntPoint MinCell = GetCell(NodePosition);
+		const FIntPoint MaxCell = GetCell(NodePosition + NodeSize);
+
+		if ((MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) > MaxCellsPerNode)
+		{
+			LargeNodes.Add(Index);
+			continue;
+		}
+
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				Cells.FindOrAdd(FIntPoint(X, Y)).Add(Index);
+			}
+		}
+	}
+
+	BuiltFrame = GFrameCounter;
+	BuiltNumChildren = NumChildren;
+	bDirty = false;
+}
+
+FIntPoint FASCNodeSpatialHash::GetCell(const FVector2D& Point)
+{
+	return FIntPoint(FMath::FloorToInt(static_cast<float>(Point.X) / CellSize), FMath::FloorToInt(static_cast<float>(Point.Y) / CellSize));
+}
@@ -1,6 +1,7 @@
 #include "AutoSizeCommentsUtils.h"
 
 #include "AutoSizeCommentsCacheFile.h"
+#include "AutoSizeCommentsGraphHandler.h"
 #include "AutoSizeCommentsGraphNode.h"
 #include "EdGraphNode_Comment.h"
 #include "SGraphPanel.h"
@@ -380,6 +381,7 @@ void FASCUtils::ClearCommentNodes(UEdGraphNode_Comment* Comment, bool bUpdateCac
 	}
 
 	Comment->ClearNodesUnderComment();
+	FAutoSizeCommentGraphHandler::Get().MarkCommentTreeDirty(Comment->GetGraph());
 
 	if (bUpdateCache)
 	{
@@ -405,6 +407,7 @@ bool FASCUtils::RemoveNodesFromComment(UEdGraphNode_Comment* Comment, const TSet
 
 	// Clear all nodes under comment
 	Comment->ClearNodesUnderComment();
+	FAutoSizeCommentGraphHandler::Get().MarkCommentTreeDirty(Comment->GetGraph());
 
 	// Add back the nodes under comment while filtering out any which are to be removed
 	for (UObject* NodeUnderComment : NodesUnderComment)
@@ -454,6 +457,7 @@ bool FASCUtils::AddNodeIntoComment(UEdGraphNode_Comment* Comment, UObject* NewNo
 	}
 
 	Comment->AddNodeUnderComment(NewNode);
+	FAutoSizeCommentGraphHandler::Get().MarkCommentTreeDirty(Comment->GetGraph());
 
 	if (bUpdateCache)
 	{
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 #include "SGraphPin.h"
 #include "AutoSizeCommentsCacheFile.generated.h"
 
@@ -26,6 +27,11 @@ struct AUTOSIZECOMMENTS_API FASCCommentData
 
 	void UpdateNodesUnderComment(UEdGraphNode_Comment* Comment);
 
+	friend FArchive& operator<<(FArchive& Ar, FASCCommentData& Data)
+	{
+		return Ar << Data.NodeGuids << Data.bHeader << Data.bInit;
+	}
+
 private:
 	/* Is this node a header node */
 	UPROPERTY()
@@ -54,6 +60,11 @@ struct AUTOSIZECOMMENTS_API FASCGraphData
 	bool IsEmpty() const { return CommentData.Num() == 0; }
 
 	FASCCommentData& GetCommentData(UEdGraphNode_Comment* Comment);
+
+	friend FArchive& operator<<(FArchive& Ar, FASCGraphData& Data)
+	{
+		return Ar << Data.CommentData;
+	}
 };
 
 USTRUCT()
@@ -63,6 +74,11 @@ struct AUTOSIZECOMMENTS_API FASCPackageData
 
 	UPROPERTY()
 	TMap<FGuid, FASCGraphData> GraphData; // graph guid -> graph data
+
+	friend FArchive& operator<<(FArchive& Ar, FASCPackageData& Data)
+	{
+		return Ar << Data.GraphData;
+	}
 };
 
 USTRUCT()
@@ -70,6 +86,7 @@ struct AUTOSIZECOMMENTS_API FASCCacheData
 {
 	GENERATED_USTRUCT_BODY()
 
+	// only packages loaded this session, each one is stored in its own binary file (see FAutoSizeCommentsCacheFile::GetPackageCacheDir)
 	UPROPERTY()
 	TMap<FName, FASCPackageData> PackageData; // package -> graph data
 };
@@ -88,14 +105,20 @@ public:
 
 	void Cleanup();
 
+	// imports the json cache from before the per package files, packages are otherwise read when first used
 	void LoadCacheFromFile();
 
+	// reads the old json cache, which holds every package
 	FASCCacheData CreateCacheFromFile();
 
 	void InitMetaData();
 
+	// serializes the packages used since the last save, then writes them on a background thread
 	void SaveCacheToFile();
 
+	// save and wait for the file to be written, for exiting the editor
+	void SaveCacheToFileAndWait();
+
 	void DeleteCache();
 
 	void CleanupFiles();
@@ -114,6 +137,9 @@ public:
 	FString GetCachePath(bool bFullPath = false);
 	FString GetAlternateCachePath(bool bFullPath = false);
 
+	// the directory holding one binary file per package, next to the cache file
+	FString GetPackageCacheDir(bool bAlternate = false);
+
 	bool GetNodesUnderComment(TSharedPtr<SAutoSizeCommentsGraphNode> ASCNode, TArray<UEdGraphNode*>& OutNodesUnderComment);
 
 	FASCCommentData& GetCommentData(UEdGraphNode* CommentNode);
@@ -129,5 +155,20 @@ protected:
 
 	FASCCacheData CacheData;
 
+	// packages whose file was read (or found missing), so the disk is only touched once per package
+	TSet<FName> LoadedPackages;
+
+	// packages handed out since the last save, the caller may have changed them
+	TSet<FName> DirtyPackages;
+
+	// the json cache was imported this session and is deleted once the package files are written
+	bool bImportedJsonCache = false;
+
+	TFuture<void> PendingWrite;
+
+	FString GetPackageCacheFilename(FName PackageName, bool bAlternate = false);
+	bool LoadPackageData(FName PackageName);
+	void EnsurePackageLoaded(FName PackageName);
+
 	void OnPreExit();
 };
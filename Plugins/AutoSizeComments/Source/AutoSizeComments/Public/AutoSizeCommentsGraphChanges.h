@@ -0,0 +1,77 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UEdGraph;
+class UEdGraphNode;
+struct FEdGraphEditAction;
+class FTransactionObjectEvent;
+
+/** The changes to a graph's nodes since the last flush */
+struct FASCGraphDiff
+{
+	TArray<UEdGraphNode*> AddedNodes;
+	TArray<TWeakObjectPtr<UEdGraphNode>> RemovedNodes;
+	TArray<UEdGraphNode*> MovedNodes;
+	TArray<UEdGraphNode*> ResizedNodes;
+
+	// transacted without moving or resizing, e.g. their pins or title changed
+	TArray<UEdGraphNode*> ModifiedNodes;
+
+	// an undo or redo changed the graph, its added and removed nodes were not made by the user
+	bool bUndoRedo = false;
+
+	bool IsEmpty() const;
+
+	void Reset();
+};
+
+/**
+ * @brief Collects the graph edit actions and transacted objects of one graph into a single diff
+ *		- Recording only remembers what was touched, the nodes are compared against the last flush when flushing
+ *		- The node list is only walked when nodes were added or removed, the other changes only look at the touched nodes
+ *		- Any number of events between two flushes give one diff, so a burst of events is handled once
+ */
+class FASCGraphChanges
+{
+public:
+	/** Start collecting for the graph, its current nodes are the baseline of the first diff */
+	void Bind(UEdGraph* InGraph);
+
+	void Reset();
+
+	UEdGraph* GetGraph() const { return Graph.Get(); }
+
+	void RecordGraphChanged(const FEdGraphEditAction& Action);
+
+	void RecordTransacted(UObject* Object, const FTransactionObjectEvent& Event);
+
+	/** Treat a node as already known, it is not reported as added by the next flush */
+	void IgnoreNode(UEdGraphNode* Node);
+
+	/** The changes since the last flush, returns false when nothing changed */
+	bool Flush(FASCGraphDiff& OutDiff);
+
+private:
+	struct FNodeState
+	{
+		int32 X = 0;
+		int32 Y = 0;
+		int32 Width = 0;
+		int32 Height = 0;
+
+		FNodeState() = default;
+		explicit FNodeState(const UEdGraphNode* Node);
+	};
+
+	TWeakObjectPtr<UEdGraph> Graph;
+
+	// the state of the graph's nodes at the last flush
+	TMap<TWeakObjectPtr<UEdGraphNode>, FNodeState> KnownNodes;
+
+	TSet<TWeakObjectPtr<UEdGraphNode>> TouchedNodes;
+	bool bNodeListChanged = false;
+	bool bUndoRedo = false;
+};
@@ -3,11 +3,14 @@
 #pragma once
 
 #include "AutoSizeCommentsCacheFile.h"
+#include "AutoSizeCommentsGraphChanges.h"
 #include "AutoSizeCommentsMacros.h"
 #include "AutoSizeCommentsNodeChangeData.h"
+#include "AutoSizeCommentsSpatialHash.h"
 
 enum class EASCResizingMode : uint8;
 class UEdGraphNode_Comment;
+class SAutoSizeCommentsGraphNode;
 class SGraphPanel;
 
 struct FASCGraphHandlerData
@@ -15,9 +18,23 @@ struct FASCGraphHandlerData
 	TArray<TWeakObjectPtr<UEdGraphNode_Comment>> LastSelectionSet;
 	FDelegateHandle OnGraphChangedHandle;
 
+	// nodes moved, resized or edited since the last tick
+	FASCGraphChanges GraphChanges;
+
 	TMap<FGuid, FASCCommentChangeData> CommentChangeData;
 	FASCGraphData GraphCacheData;
 
+	// comments containing each node, rebuilt at most once a frame or after a comment's nodes change
+	TMap<TWeakObjectPtr<UEdGraphNode>, TArray<TWeakObjectPtr<UEdGraphNode_Comment>>> ContainingComments;
+	uint64 ContainingCommentsFrame = 0;
+	bool bContainingCommentsDirty = true;
+
+	// nodes left highlighted by the selected comments, every other node is unrelated while bUnrelatedStateApplied.
+	// cleared when something else sets the unrelated state, the next update then sets every node
+	TSet<TWeakObjectPtr<UEdGraphNode>> RelatedNodes;
+	bool bUnrelatedStateApplied = false;
+	bool bRelatedNodesDirty = false;
+
 	float LastZoomLevel = -1;
 	EGraphRenderingLOD::Type LastLOD = EGraphRenderingLOD::Type::DefaultDetail;
 };
@@ -39,7 +56,8 @@ public:
 
 	void RegisterActiveGraphPanel(TSharedPtr<SGraphPanel> GraphPanel);
 
-	void RequestGraphVisualRefresh(TSharedPtr<SGraphPanel> GraphPanel);
+	// fix the draw order of the comment and the comments around it on the next tick, see UpdateSortDepths
+	void RequestSortDepthUpdate(UEdGraphNode_Comment* Comment);
 
 	void ProcessAltReleased(TSharedPtr<SGraphPanel> GraphPanel);
 
@@ -50,13 +68,34 @@ public:
 
 	TArray<UEdGraph*> GetActiveGraphs();
 
+	TArray<UEdGraphNode_Comment*> GetContainingComments(UEdGraphNode* Node);
+
+	void MarkCommentTreeDirty(UEdGraph* Graph);
+
+	// the unrelated state of the graph's nodes was set outside UpdateNodeUnrelatedState
+	void InvalidateRelatedNodes(UEdGraph* Graph);
+
 	EGraphRenderingLOD::Type GetGraphLOD(TSharedPtr<SGraphPanel> GraphPanel);
 
+	// resize the comment after slate has ticked this frame, see ProcessQueuedComments
+	void QueueCommentUpdate(TSharedPtr<SAutoSizeCommentsGraphNode> Comment) { QueuedComments.Add(Comment); }
+
+	FASCNodeSpatialHash& GetSpatialHash(TSharedPtr<SGraphPanel> GraphPanel) { return PanelSpatialHashes.FindOrAdd(GraphPanel); }
+
 private:
 	TMap<TWeakObjectPtr<UEdGraph>, FASCGraphHandlerData> GraphDatas;
 
 	TArray<TWeakPtr<SGraphPanel>> ActiveGraphPanels;
 
+	TMap<TWeakPtr<SGraphPanel>, FASCNodeSpatialHash> PanelSpatialHashes;
+
+	TSet<TWeakPtr<SAutoSizeCommentsGraphNode>> QueuedComments;
+
+	// time per frame for updating queued comments, the rest carry over to the next frame
+	static constexpr double CommentUpdateBudget = 0.002;
+
+	FDelegateHandle PostTickDelegateHandle;
+
 #if ASC_UE_VERSION_OR_LATER(5, 0)
 	FTSTicker::FDelegateHandle TickDelegateHandle;
 #else
@@ -65,7 +104,10 @@ private:
 
 	bool bPendingSave = false;
 
-	bool bPendingGraphVisualRequest = false;
+	// a burst of asset saves collects into one cache save when this timer fires
+	FTimerHandle SaveTimerHandle;
+
+	TSet<TWeakObjectPtr<UEdGraphNode_Comment>> PendingSortDepthComments;
 
 	bool bProcessedAltReleased = false;
 
@@ -73,6 +115,10 @@ private:
 
 	void UpdateNodeUnrelatedState();
 
+	void RemoveInvalidSpatialHashes();
+
+	void ProcessQueuedComments(float DeltaTime);
+
 	void OnNodeAdded(TWeakObjectPtr<UEdGraphNode> NewNodePtr);
 
 	void OnNodeDeleted(const FEdGraphEditAction& Action);
@@ -87,9 +133,11 @@ private:
 
 	void SaveSizeCache();
 
-	void UpdateContainingComments(TWeakObjectPtr<UEdGraphNode> Node);
+	void ProcessGraphChanges();
+
+	void UpdateContainingComments(UEdGraph* Graph, const TSet<UEdGraphNode*>& Nodes);
 
-	void RefreshGraphVisualRefresh(TWeakPtr<SGraphPanel> GraphPanel);
+	void UpdateSortDepths();
 
 	EASCResizingMode GetResizingMode(UEdGraph* Graph) const;
 
@@ -54,6 +54,16 @@ public:
 
 	bool bRequireUpdate = false;
 
+	/** Set while updates are skipped for being offscreen or zoomed out, see ShouldDeferUpdates */
+	bool bDeferredUpdates = false;
+
+	/** Bounds of the nodes inside the last time the comment was resized, the comment is only fit again when these change */
+	TMap<TWeakObjectPtr<UEdGraphNode>, FSlateRect> CachedNodeBounds;
+	FMargin LastFitPadding;
+	FVector2D LastFitPosition = FVector2D::ZeroVector;
+	FVector2D LastFitSize = FVector2D::ZeroVector;
+	bool bBoundsDirty = true;
+
 #if ASC_UE_VERSION_OR_LATER(4, 27)
 	virtual void MoveTo(const FVector2D& NewPosition, FNodeSet& NodeFilter, bool bMarkDirty = true) override;
 #else
@@ -76,6 +86,7 @@ public:
 	virtual FReply OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
 	virtual FReply OnMouseButtonDoubleClick(const FGeometry& InMyGeometry, const FPointerEvent& InMouseEvent) override;
 	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
 	virtual FReply OnDrop( const FGeometry& MyGeometry, const FDragDropEvent& DragDropEvent ) override { return FReply::Unhandled(); }
 	//~ End SWidget Interface
 
@@ -108,6 +119,18 @@ public:
 
 	void ResizeToFit();
 
+	// force the next ResizeToFit to fit the comment even if the nodes inside look unchanged
+	void MarkBoundsDirty() { bBoundsDirty = true; }
+
+	// resize and move away from other comments, called by the graph handler for comments queued on tick
+	void UpdateQueuedComment();
+
+	// fit the comments containing this one, innermost first, so nested comments settle in the same frame
+	void ResizeParentComments();
+
+	// time spent updating this comment, shown by bShowCommentCostOverlay
+	void AddDebugCost(double Seconds);
+
 	void ApplyHeaderStyle();
 	void ApplyPresetStyle(const FPresetCommentStyle& Style);
 
@@ -139,6 +162,8 @@ protected:
 
 	void UpdateColors(const float InDeltaTime);
 
+	bool ShouldDeferUpdates() const;
+
 private:
 	/** @return the color to tint the comment body */
 	FSlateColor GetCommentBodyColor() const;
@@ -219,6 +244,14 @@ private:
 	FName CachedGraphClassName;
 	FString OldNodeTitle;
 
+	/** Per frame cost and fit rate of this comment for the debug overlay */
+	uint64 DebugCostFrame = 0;
+	double DebugFrameSeconds = 0;
+	double DebugAverageSeconds = 0;
+	int32 DebugFitCount = 0;
+	double DebugFitWindowStart = 0;
+	float DebugFitsPerSecond = 0;
+
 public:
 	/** Update the nodes */
 	void UpdateRefreshDelay();
@@ -228,7 +261,8 @@ public:
 	float GetTitleBarHeight() const;
 
 	/** Util functions */
-	FSlateRect GetBoundsForNodesInside();
+	bool UpdateCachedNodeBounds();
+	FSlateRect GetBoundsForNodesInside() const;
 	FSlateRect GetNodeBounds(UEdGraphNode* Node);
 	TSet<TSharedPtr<SAutoSizeCommentsGraphNode>> GetOtherCommentNodes();
 	TArray<UEdGraphNode_Comment*> GetParentComments() const;
@@ -242,10 +242,6 @@ public:
 	UPROPERTY(EditAnywhere, config, Category = CommentCache, meta = (EditCondition = "bSaveCommentNodeDataToFile"))
 	bool bSaveCommentDataOnExit;
 
-	/** If enabled, cache file JSON text will be made more human-readable, but increases file size */
-	UPROPERTY(EditAnywhere, config, Category = CommentCache, AdvancedDisplay)
-	bool bPrettyPrintCommentCacheJSON;
-
 	/** Commments will detect and add nodes are underneath on creation */
 	UPROPERTY(EditAnywhere, config, Category = Misc)
 	bool bDetectNodesContainedForNewComments;
@@ -302,6 +298,14 @@ public:
 	UPROPERTY(EditAnywhere, config, Category = Misc)
 	bool bUseMaxDetailNodes;
 
+	/** Comments outside the view do not update their nodes or resize until they are scrolled into view */
+	UPROPERTY(EditAnywhere, config, Category = Misc)
+	bool bDeferOffscreenCommentUpdates;
+
+	/** Comments do not update their nodes or resize while the graph is zoomed out to the lowest detail level */
+	UPROPERTY(EditAnywhere, config, Category = Misc)
+	bool bDeferCommentUpdatesWhenZoomedOut;
+
 	/** Do not use ASC node for these graphs, turn on DebugClass_ASC and open graph to find graph class name */
 	UPROPERTY(EditAnywhere, config, Category = Misc, AdvancedDisplay)
 	TArray<FString> IgnoredGraphs;
@@ -361,6 +365,10 @@ public:
 	UPROPERTY(EditAnywhere, config, Category = Debug)
 	bool bDisablePackageCleanup;
 
+	/** Draw the average time each comment takes to update per frame and how often it is resized above the comment */
+	UPROPERTY(EditAnywhere, config, Category = Debug)
+	bool bShowCommentCostOverlay;
+
 	/** Use the default Unreal comment node */
 	UPROPERTY(EditAnywhere, config, Category = Debug)
 	bool bDisableASCGraphNode;
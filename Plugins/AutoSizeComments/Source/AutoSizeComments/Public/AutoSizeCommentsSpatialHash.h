@@ -0,0 +1,65 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class SGraphNode;
+class SGraphPanel;
+class UEdGraphNode;
+
+// a node widget with the position and desired size it had when the hash was built
+struct FASCNodeGeometry
+{
+	TSharedPtr<SGraphNode> Widget;
+	FVector2D Position = FVector2D::ZeroVector;
+	FVector2D Size = FVector2D::ZeroVector;
+};
+
+/**
+ * Buckets the node widgets of a graph panel into a grid by their bounds, so a comment only has to test the nodes near
+ * it instead of every node on the panel. One hash is shared by all the comments on a panel. It is rebuilt lazily: at
+ * most once a frame, or on the next query after a node was added, removed or invalidated it by moving or resizing.
+ * The geometry read while building is kept, so the comments of a panel read each node widget once a frame.
+ */
+class FASCNodeSpatialHash
+{
+public:
+	// nodes whose bounds overlap a cell touched by the rect, in the same order as the panel children
+	void QueryNodes(TSharedPtr<SGraphPanel> GraphPanel, const FSlateRect& Rect, TArray<FASCNodeGeometry>& OutNodes);
+
+	// the widget and geometry of a node on the panel, false if the panel has no widget for it
+	bool FindNode(TSharedPtr<SGraphPanel> GraphPanel, const UEdGraphNode* Node, FASCNodeGeometry& OutGeometry);
+
+	void Invalidate() { bDirty = true; }
+
+private:
+	struct FNodeEntry
+	{
+		TWeakPtr<SGraphNode> Widget;
+		FVector2D Position;
+		FVector2D Size;
+	};
+
+	static constexpr float CellSize = 256.0f;
+
+	// nodes covering more cells than this (usually big comments) are returned by every query instead of filling the grid
+	static constexpr int32 MaxCellsPerNode = 64;
+
+	TArray<FNodeEntry> Nodes;
+	TMap<const UEdGraphNode*, int32> NodeLookup;
+	TMap<FIntPoint, TArray<int32>> Cells;
+	TArray<int32> LargeNodes;
+
+	uint64 BuiltFrame = 0;
+	int32 BuiltNumChildren = INDEX_NONE;
+	bool bDirty = true;
+
+	bool NeedsRebuild(TSharedPtr<SGraphPanel> GraphPanel) const;
+
+	bool GetGeometry(int32 Index, FASCNodeGeometry& OutGeometry) const;
+
+	void Rebuild(TSharedPtr<SGraphPanel> GraphPanel);
+
+	static FIntPoint GetCell(const FVector2D& Point);
+};
@@ -380,7 +380,7 @@ void FBANodeActions::SmartWireNode(UEdGraphNode* Node)
 
 	TSet<UEdGraphNode*> LHSNodes, RHSNodes;
 	TSet<UEdGraphPin*> LHSPins, RHSPins;
-	FBAUtils::SortNodesOnGraphByDistance(Node, Graph, LHSNodes, RHSNodes, LHSPins, RHSPins);
+	FBAUtils::SortNodesOnGraphByDistance(Node, GraphHandler, LHSNodes, RHSNodes, LHSPins, RHSPins);
 
 	TArray<TArray<UEdGraphPin*>> PinsByType;
 	TArray<UEdGraphPin*> ExecPins = FBAUtils::GetExecPins(Node);
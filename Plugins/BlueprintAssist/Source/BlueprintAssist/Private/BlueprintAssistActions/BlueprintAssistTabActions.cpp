@@ -92,7 +92,7 @@ void FBATabActions::Init()
 	);
 }
 
-void FBATabActions::SelectNodeInDirection(const TArray<UEdGraphNode*>& Nodes, int X, int Y, float DistLimit) const
+void FBATabActions::SelectNodeInDirection(int X, int Y, float DistLimit) const
 {
 	TSharedPtr<FBAGraphHandler> GraphHandler = GetGraphHandler();
 	if (!GraphHandler)
@@ -100,11 +100,6 @@ void FBATabActions::SelectNodeInDirection(const TArray<UEdGraphNode*>& Nodes, in
 		return;
 	}
 
-	if (Nodes.Num() == 0)
-	{
-		return;
-	}
-
 	TSharedPtr<SGraphPanel> Panel = GraphHandler->GetGraphPanel();
 	if (!Panel.IsValid())
 	{
@@ -124,21 +119,32 @@ void FBATabActions::SelectNodeInDirection(const TArray<UEdGraphNode*>& Nodes, in
 		? FVector2D(SelectedNode->NodePosX, SelectedNode->NodePosY)
 		: Panel->GetPastePosition();
 
-	// filter all nodes on the graph towards our direction
-	TArray<UEdGraphNode*> FilteredNodes;
-	bool bIsXDirection = X != 0;
-	for (UEdGraphNode* Other : Nodes)
+	// only the part of the graph towards our direction is searched
+	const bool bIsXDirection = X != 0;
+	const float AlongLimit = DistLimit > 0 ? DistLimit : TNumericLimits<float>::Max();
+	const float AcrossLimit = DistLimit > 0 ? DistLimit * 0.5f : TNumericLimits<float>::Max();
+	const FVector2D Along = bIsXDirection ? FVector2D(X * AlongLimit, 0) : FVector2D(0, Y * AlongLimit);
+	const FVector2D Across = bIsXDirection ? FVector2D(0, AcrossLimit) : FVector2D(AcrossLimit, 0);
+	const FVector2D CornerA = StartPosition - Across;
+	const FVector2D CornerB = StartPosition + Along + Across;
+	const FSlateRect SearchRect(
+		FMath::Min(CornerA.X, CornerB.X),
+		FMath::Min(CornerA.Y, CornerB.Y),
+		FMath::Max(CornerA.X, CornerB.X),
+		FMath::Max(CornerA.Y, CornerB.Y));
+
+	const auto& Filter = [SelectedNode, StartPosition, bIsXDirection, X, Y, DistLimit](UEdGraphNode* Other) -> bool
 	{
 		// skip the currently selected
 		if (Other == SelectedNode)
 		{
-			continue;
+			return false;
 		}
 
 		// skip comment nodes and knot nodes
 		if (!FBAUtils::IsGraphNode(Other) || FBAUtils::IsCommentNode(Other) || FBAUtils::IsKnotNode(Other))
 		{
-			continue;
+			return false;
 		}
 
 		const float DeltaX = Other->NodePosX - StartPosition.X;
@@ -146,55 +152,19 @@ void FBATabActions::SelectNodeInDirection(const TArray<UEdGraphNode*>& Nodes, in
 
 		if (bIsXDirection)
 		{
-			if (FMath::Sign(DeltaX) == X)
-			{
-				if (DistLimit <= 0 || (FMath::Abs(DeltaX) < DistLimit && FMath::Abs(DeltaY) < DistLimit * 0.5f))
-				{
-					FilteredNodes.Add(Other);
-				}
-			}
+			return FMath::Sign(DeltaX) == X && (DistLimit <= 0 || (FMath::Abs(DeltaX) < DistLimit && FMath::Abs(DeltaY) < DistLimit * 0.5f));
 		}
-		else // y direction
-		{
-			if (FMath::Sign(DeltaY) == Y)
-			{
-				if (DistLimit <= 0 || (FMath::Abs(DeltaY) < DistLimit && FMath::Abs(DeltaX) < DistLimit * 0.5f))
-				{
-					FilteredNodes.Add(Other);
-				}
-			}
-		}
-	}
 
-	// no nodes found stop
-	if (FilteredNodes.Num() == 0)
-	{
-		return;
-	}
-
-	// sort nodes by distance
-	const auto& Sorter = [StartPosition, bIsXDirection](UEdGraphNode& A, UEdGraphNode& B)-> bool
-	{
-		const float XWeight = bIsXDirection ? 1 : 5;
-		const float YWeight = bIsXDirection ? 5 : 1;
-
-		float DeltaX = A.NodePosX - StartPosition.X;
-		float DeltaY = A.NodePosY - StartPosition.Y;
-		const float DistA = XWeight * DeltaX * DeltaX + YWeight * DeltaY * DeltaY;
-
-		DeltaX = B.NodePosX - StartPosition.X;
-		DeltaY = B.NodePosY - StartPosition.Y;
-		const float DistB = XWeight * DeltaX * DeltaX + YWeight * DeltaY * DeltaY;
-
-		return DistA < DistB;
+		// y direction
+		return FMath::Sign(DeltaY) == Y && (DistLimit <= 0 || (FMath::Abs(DeltaY) < DistLimit && FMath::Abs(DeltaX) < DistLimit * 0.5f));
 	};
-	FilteredNodes.Sort(Sorter);
-
-	TSharedPtr<SGraphPanel> GraphPanel = GraphHandler->GetGraphPanel();
 
-	// now that we have sorted the nodes we get the closest node and select it
-	UEdGraphNode* NodeToSelect = FilteredNodes[0];
-	GraphHandler->SelectNode(NodeToSelect);
+	// the closest node by distance, weighted against straying from our direction
+	const FVector2D Weights = bIsXDirection ? FVector2D(1, 5) : FVector2D(5, 1);
+	if (UEdGraphNode* NodeToSelect = GraphHandler->GetNodeKdTree().FindNearest(StartPosition, Weights, SearchRect, Filter))
+	{
+		GraphHandler->SelectNode(NodeToSelect);
+	}
 }
 
 void FBATabActions::SelectAnyNodeInDirection(const int X, const int Y) const
@@ -211,7 +181,7 @@ void FBATabActions::SelectAnyNodeInDirection(const int X, const int Y) const
 		return;
 	}
 
-	SelectNodeInDirection(Graph->Nodes, X, Y, 5000);
+	SelectNodeInDirection(X, Y, 5000);
 }
 
 void FBATabActions::ShiftCameraInDirection(int X, int Y) const
@@ -9,18 +9,25 @@
 #include "BlueprintAssistUtils.h"
 #include "Editor.h"
 #include "GeneralProjectSettings.h"
+#include "HAL/FileManager.h"
 #include "JsonObjectConverter.h"
+#include "Async/Async.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetRegistry/AssetRegistryState.h"
 #include "EdGraph/EdGraph.h"
 #include "EdGraph/EdGraphNode.h"
 #include "HAL/PlatformFileManager.h"
 #include "Interfaces/IPluginManager.h"
+#include "Misc/Base64.h"
 #include "Misc/CoreDelegates.h"
 #include "Misc/FileHelper.h"
 #include "Misc/LazySingleton.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "Stats/StatsMisc.h"
 #include "UObject/MetaData.h"
+#include "UObject/UObjectHash.h"
 
 #if BA_UE_VERSION_OR_LATER(5, 0)
 #include "UObject/ObjectSaveContext.h"
@@ -28,8 +35,68 @@
 
 #define CACHE_VERSION 2
 
+// the first per package files, serialized FBAPackageData; still read so their data moves to the index format on the next save
+#define PACKAGE_CACHE_VERSION 1
+#define PACKAGE_CACHE_MAGIC 0x42414331 // "BAC1"
+
 static FName NAME_BA_GRAPH_DATA = FName("BAGraphData");
 
+namespace BACacheMetaData
+{
+	// the graph's data as a one graph package index, so a lookup decodes only the node it asks for.
+	// older meta data is the graph data as json, it is still read and replaced on the next save
+	const TCHAR* CompactPrefix = TEXT("BAI:");
+
+	// the blob belongs to the graph object it is stored on, so neither the package nor the graph guid is kept;
+	// a renamed or duplicated asset then still reads it
+	const FGuid StoredGraphGuid;
+
+	FString Encode(const FBAGraphData& GraphData)
+	{
+		FBAPackageData PackageData;
+		PackageData.GraphData.Add(StoredGraphGuid, GraphData);
+		return CompactPrefix + FBase64::Encode(FBAPackageIndex::Write(NAME_BA_GRAPH_DATA, PackageData));
+	}
+
+	const FString* FindValue(UEdGraph* Graph)
+	{
+		UMetaData* MetaData = Graph->GetPackage() ? Graph->GetPackage()->GetMetaData() : nullptr;
+		return MetaData ? MetaData->FindValue(Graph, NAME_BA_GRAPH_DATA) : nullptr;
+	}
+
+	TSharedPtr<FBAPackageIndex> Decode(const FString& Value)
+	{
+		if (!Value.StartsWith(CompactPrefix, ESearchCase::CaseSensitive))
+		{
+			return nullptr;
+		}
+
+		TArray<uint8> Bytes;
+		if (!FBase64::Decode(Value.RightChop(FCString::Strlen(CompactPrefix)), Bytes))
+		{
+			return nullptr;
+		}
+
+		return FBAPackageIndex::FromBytes(MoveTemp(Bytes), NAME_BA_GRAPH_DATA);
+	}
+}
+
+namespace BACacheFile
+{
+	// write next to the file and move it over, so a crash mid write never leaves a truncated cache
+	bool SaveAtomically(const TArray<uint8>& Bytes, const FString& Path)
+	{
+		const FString TempPath = Path + TEXT(".tmp");
+		return FFileHelper::SaveArrayToFile(Bytes, *TempPath) && IFileManager::Get().Move(*Path, *TempPath, true, true);
+	}
+
+	bool SaveAtomically(const FString& Text, const FString& Path)
+	{
+		const FString TempPath = Path + TEXT(".tmp");
+		return FFileHelper::SaveStringToFile(Text, *TempPath) && IFileManager::Get().Move(*Path, *TempPath, true, true);
+	}
+}
+
 FBACache& FBACache::Get()
 {
 	return TLazySingleton<FBACache>::Get();
@@ -45,7 +112,7 @@ void FBACache::Init()
 	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
 	AssetRegistry.OnFilesLoaded().AddRaw(this, &FBACache::LoadCache);
 
-	FCoreDelegates::OnPreExit.AddRaw(this, &FBACache::SaveCache);
+	FCoreDelegates::OnPreExit.AddRaw(this, &FBACache::SaveCacheAndWait);
 
 #if BA_UE_VERSION_OR_LATER(5, 0)
 	FCoreUObjectDelegates::OnObjectPreSave.AddRaw(this, &FBACache::OnObjectPreSave);
@@ -68,49 +135,85 @@ void FBACache::LoadCache()
 
 	bHasLoaded = true;
 
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.OnFilesLoaded().RemoveAll(this);
+
 	const FString CachePath = GetCachePath();
 	const FString OldCachePath = GetAlternateCachePath();
+	const FString CacheDisplayPath = GetCachePath(true);
+	const FString OldCacheDisplayPath = GetAlternateCachePath(true);
 
-	FString FileData;
-	if (FPlatformFileManager::Get().GetPlatformFile().FileExists(*CachePath))
+	// the index only holds the bookmarks now, packages are read one at a time by GetGraphData
+	// an index from before the per package files may still hold every package, those are moved over on the next save
+	// reading and parsing it is left to the thread pool, the editor only waits for it when something needs the cache first
+	PendingLoad = Async(EAsyncExecution::ThreadPool, [CachePath, OldCachePath, CacheDisplayPath, OldCacheDisplayPath]()
 	{
-		FFileHelper::LoadFileToString(FileData, *CachePath);
+		TRACE_CPUPROFILER_EVENT_SCOPE(PluginStartup_BlueprintAssistCacheIndex);
 
-		if (FJsonObjectConverter::JsonObjectStringToUStruct(FileData, &CacheData, 0, 0))
+		FBACacheData IndexData;
+		FString FileData;
+		if (FPlatformFileManager::Get().GetPlatformFile().FileExists(*CachePath))
 		{
-			UE_LOG(LogBlueprintAssist, Log, TEXT("Loaded blueprint assist cache: %s"), *GetCachePath(true));
+			FFileHelper::LoadFileToString(FileData, *CachePath);
+
+			if (FJsonObjectConverter::JsonObjectStringToUStruct(FileData, &IndexData, 0, 0))
+			{
+				UE_LOG(LogBlueprintAssist, Log, TEXT("Loaded blueprint assist cache: %s"), *CacheDisplayPath);
+			}
+			else
+			{
+				UE_LOG(LogBlueprintAssist, Log, TEXT("Failed to load node size cache: %s"), *CacheDisplayPath);
+			}
 		}
-		else
+		else if (FPlatformFileManager::Get().GetPlatformFile().FileExists(*OldCachePath))
 		{
-			UE_LOG(LogBlueprintAssist, Log, TEXT("Failed to load node size cache: %s"), *GetCachePath(true));
+			FFileHelper::LoadFileToString(FileData, *OldCachePath);
+
+			if (FJsonObjectConverter::JsonObjectStringToUStruct(FileData, &IndexData, 0, 0))
+			{
+				UE_LOG(LogBlueprintAssist, Log, TEXT("Loaded blueprint assist cache from old cache path: %s"), *OldCacheDisplayPath);
+			}
+			else
+			{
+				UE_LOG(LogBlueprintAssist, Log, TEXT("Failed to load node size cache from old cache path: %s"), *OldCacheDisplayPath);
+			}
 		}
-	}
-	else if (FPlatformFileManager::Get().GetPlatformFile().FileExists(*OldCachePath))
+
+		return IndexData;
+	});
+}
+
+void FBACache::FinishLoadingCache()
+{
+	if (!PendingLoad.IsValid())
 	{
-		FFileHelper::LoadFileToString(FileData, *OldCachePath);
+		return;
+	}
 
-		if (FJsonObjectConverter::JsonObjectStringToUStruct(FileData, &CacheData, 0, 0))
-		{
-			UE_LOG(LogBlueprintAssist, Log, TEXT("Loaded blueprint assist cache from old cache path: %s"), *GetAlternateCachePath(true));
-		}
-		else
+	TRACE_CPUPROFILER_EVENT_SCOPE(BlueprintAssist_FinishLoadingCache);
+
+	FBACacheData IndexData = MoveTemp(PendingLoad.Get());
+	PendingLoad.Reset();
+
+	if (IndexData.CacheVersion == CACHE_VERSION)
+	{
+		for (TPair<FName, FBAPackageData>& Package : IndexData.PackageData)
 		{
-			UE_LOG(LogBlueprintAssist, Log, TEXT("Failed to load node size cache from old cache path: %s"), *GetAlternateCachePath(true));
+			// packages already read from their own file by GetGraphData are newer
+			if (!LoadedPackages.Contains(Package.Key))
+			{
+				CacheData.PackageData.Add(Package.Key, MoveTemp(Package.Value));
+				LoadedPackages.Add(Package.Key);
+				DirtyPackages.Add(Package.Key);
+			}
 		}
 	}
 
-	if (CacheData.CacheVersion != CACHE_VERSION)
-	{
-		// clear the cache if our version doesn't match
-		CacheData.PackageData.Empty();
-
-		CacheData.CacheVersion = CACHE_VERSION;
-	}
+	CacheData.BookmarkedFolders = MoveTemp(IndexData.BookmarkedFolders);
+	CacheData.PackageLastUsed = MoveTemp(IndexData.PackageLastUsed);
+	CacheData.CacheVersion = CACHE_VERSION;
 
 	CleanupFiles();
-
-	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
-	AssetRegistry.OnFilesLoaded().RemoveAll(this);
 }
 
 void FBACache::SaveCache()
@@ -120,26 +223,201 @@ void FBACache::SaveCache()
 		return;
 	}
 
+	FinishLoadingCache();
+
+	// one write at a time, so an older file never lands after a newer one
+	if (PendingWrite.IsValid())
+	{
+		for (FName EvictedPackage : PendingWrite.Get())
+		{
+			CacheData.PackageLastUsed.Remove(EvictedPackage);
+		}
+	}
+
 	const FString CachePath = GetCachePath();
 
 	double SaveTime = 0;
 
+	TArray<TPair<FString, TArray<uint8>>> Files;
+	FString JsonAsString;
+
 	{
 		SCOPE_SECONDS_COUNTER(SaveTime);
 
+		// only the packages handed out since the last save can have changed
+		for (FName PackageName : DirtyPackages)
+		{
+			FBAPackageData* PackageData = CacheData.PackageData.Find(PackageName);
+			if (!PackageData)
+			{
+				continue;
+			}
+
+			// the graphs nobody edited are only in the mapped file, which has to be let go before it is written over
+			if (TSharedPtr<FBAPackageIndex> Index = PackageIndices.FindRef(PackageName))
+			{
+				Index->ReadPackage(*PackageData);
+				PackageIndices.Remove(PackageName);
+			}
+
+			CompactPackageData(PackageName, *PackageData);
+
+			Files.Emplace(GetPackageCacheFilename(PackageName), FBAPackageIndex::Write(PackageName, *PackageData));
+		}
+
+		DirtyPackages.Reset();
+
+		const FDateTime Now = FDateTime::UtcNow();
+		const double NowSeconds = FPlatformTime::Seconds();
+		for (const TPair<FName, double>& Access : PackageAccessTime)
+		{
+			CacheData.PackageLastUsed.Add(Access.Key, (Now - FTimespan::FromSeconds(NowSeconds - Access.Value)).GetTicks());
+		}
+
+		FBACacheData IndexData;
+		IndexData.BookmarkedFolders = CacheData.BookmarkedFolders;
+		IndexData.PackageLastUsed = CacheData.PackageLastUsed;
+		IndexData.CacheVersion = CacheData.CacheVersion;
+		FJsonObjectConverter::UStructToJsonObjectString(IndexData, JsonAsString, 0, 0, 0, nullptr, UBASettings_Advanced::Get().bPrettyPrintCacheJSON);
+	}
+
+	// files of packages in use are mapped or about to be written, the size limit never deletes those
+	TSet<FString> FilesInUse;
+	for (FName PackageName : LoadedPackages)
+	{
+		FilesInUse.Add(FPaths::GetCleanFilename(GetPackageCacheFilename(PackageName)));
+	}
+
+	const int64 SizeLimit = static_cast<int64>(UBASettings_Advanced::Get().CacheSizeLimitMB) * 1024 * 1024;
+	const FString PackageCacheDir = GetPackageCacheDir();
+
+	PendingWrite = Async(EAsyncExecution::ThreadPool, [CachePath, JsonAsString = MoveTemp(JsonAsString), Files = MoveTemp(Files), FilesInUse = MoveTemp(FilesInUse), PackageLastUsed = CacheData.PackageLastUsed, SizeLimit, PackageCacheDir]()
+	{
 		// Write data to file
-		FString JsonAsString;
-		FJsonObjectConverter::UStructToJsonObjectString(CacheData, JsonAsString, 0, 0, 0, nullptr, UBASettings_Advanced::Get().bPrettyPrintCacheJSON);
-		FFileHelper::SaveStringToFile(JsonAsString, *CachePath);
+		if (!BACacheFile::SaveAtomically(JsonAsString, CachePath))
+		{
+			UE_LOG(LogBlueprintAssist, Warning, TEXT("Failed to save cache %s"), *CachePath);
+		}
+
+		for (const TPair<FString, TArray<uint8>>& File : Files)
+		{
+			if (!BACacheFile::SaveAtomically(File.Value, File.Key))
+			{
+				UE_LOG(LogBlueprintAssist, Warning, TEXT("Failed to save package cache %s"), *File.Key);
+			}
+		}
+
+		TArray<FName> EvictedPackages;
+		if (SizeLimit <= 0)
+		{
+			return EvictedPackages;
+		}
+
+		struct FPackageFile
+		{
+			FString FileName;
+			FName PackageName;
+			int64 Size;
+			int64 LastUsed;
+		};
+
+		TArray<FPackageFile> PackageFiles;
+		int64 TotalSize = 0;
+		IFileManager::Get().IterateDirectoryStat(*PackageCacheDir, [&](const TCHAR* FilenameOrDirectory, const FFileStatData& StatData)
+		{
+			const FString FileName = FPaths::GetCleanFilename(FilenameOrDirectory);
+			if (StatData.bIsDirectory || !FileName.EndsWith(TEXT(".bacache")))
+			{
+				return true;
+			}
+
+			TotalSize += StatData.FileSize;
+			if (!FilesInUse.Contains(FileName))
+			{
+				// packages never used since the tracking began fall back to when their file was written
+				const FName PackageName(TEXT("/") + FPaths::GetBaseFilename(FileName).Replace(TEXT("@"), TEXT("/")));
+				const int64* LastUsed = PackageLastUsed.Find(PackageName);
+				PackageFiles.Add({ FilenameOrDirectory, PackageName, StatData.FileSize, LastUsed ? *LastUsed : StatData.ModificationTime.GetTicks() });
+			}
+			return true;
+		});
+
+		if (TotalSize <= SizeLimit)
+		{
+			return EvictedPackages;
+		}
+
+		PackageFiles.Sort([](const FPackageFile& A, const FPackageFile& B) { return A.LastUsed < B.LastUsed; });
+		for (const FPackageFile& PackageFile : PackageFiles)
+		{
+			if (TotalSize <= SizeLimit)
+			{
+				break;
+			}
+
+			if (IFileManager::Get().Delete(*PackageFile.FileName, false, false, true))
+			{
+				TotalSize -= PackageFile.Size;
+				EvictedPackages.Add(PackageFile.PackageName);
+			}
+		}
+
+		UE_LOG(LogBlueprintAssist, Log, TEXT("Deleted %d least recently used package caches to stay under %lld MB"), EvictedPackages.Num(), SizeLimit / (1024 * 1024));
+		return EvictedPackages;
+	});
+
+	ReleaseUnusedPackages();
+
+	UE_LOG(LogBlueprintAssist, Log, TEXT("Saving cache to %s (%d packages) took %.2fms"), *GetCachePath(true), Files.Num(), SaveTime * 1000);
+}
+
+void FBACache::RequestSave()
+{
+	if (!GEditor)
+	{
+		SaveCache();
+		return;
+	}
+
+	FTimerManager& TimerManager = *GEditor->GetTimerManager();
+	if (!TimerManager.IsTimerActive(SaveTimerHandle))
+	{
+		TimerManager.SetTimer(SaveTimerHandle, FTimerDelegate::CreateRaw(this, &FBACache::SaveCache), 2.0f, false);
+	}
+}
+
+void FBACache::SaveCacheAndWait()
+{
+	if (GEditor)
+	{
+		GEditor->GetTimerManager()->ClearTimer(SaveTimerHandle);
 	}
 
-	UE_LOG(LogBlueprintAssist, Log, TEXT("Saved cache to %s took %.2fms"), *GetCachePath(true), SaveTime * 1000);
+	SaveCache();
+
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
 }
 
 void FBACache::DeleteCache()
 {
+	// the index read in the background would otherwise bring the deleted packages back
+	FinishLoadingCache();
+
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+
 	FString CachePath = GetCachePath();
 	CacheData.PackageData.Empty();
+	PackageIndices.Empty();
+	LoadedPackages.Empty();
+	DirtyPackages.Empty();
+
+	IFileManager::Get().DeleteDirectory(*GetPackageCacheDir(), false, true);
 
 	if (FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*CachePath))
 	{
@@ -185,6 +463,29 @@ void FBACache::CleanupFiles()
 			CacheData.PackageData.Remove(PackageGuid);
 		}
 	}
+
+	TArray<FName> IndexedPackageNames;
+	PackageIndices.GetKeys(IndexedPackageNames);
+	for (FName PackageName : IndexedPackageNames)
+	{
+		if (!CurrentPackageNames.Contains(PackageName))
+		{
+			PackageIndices.Remove(PackageName);
+		}
+	}
+
+	// the file names map back to the package names, so this needs no file to be read
+	const FString PackageCacheDir = GetPackageCacheDir();
+	TArray<FString> PackageFiles;
+	IFileManager::Get().FindFiles(PackageFiles, *(PackageCacheDir / TEXT("*.bacache")), true, false);
+	for (const FString& PackageFile : PackageFiles)
+	{
+		const FName PackageName(TEXT("/") + FPaths::GetBaseFilename(PackageFile).Replace(TEXT("@"), TEXT("/")));
+		if (!CurrentPackageNames.Contains(PackageName))
+		{
+			IFileManager::Get().Delete(*(PackageCacheDir / PackageFile), false, false, true);
+		}
+	}
 }
 
 FBAGraphData& FBACache::GetGraphData(UEdGraph* Graph)
@@ -192,9 +493,28 @@ FBAGraphData& FBACache::GetGraphData(UEdGraph* Graph)
 	check(Graph);
 	UPackage* Package = Graph->GetOutermost();
 
-	FBAPackageData& PackageData = CacheData.PackageData.FindOrAdd(Package->GetFName());
+	const FName PackageName = Package->GetFName();
+	EnsurePackageLoaded(PackageName);
+
+	// the caller gets a mutable reference, so assume it changes the package
+	DirtyPackages.Add(PackageName);
+
+	FBAPackageData& PackageData = CacheData.PackageData.FindOrAdd(PackageName);
+
+	const FGuid GraphGuid = FBAUtils::GetGraphGuid(Graph);
+	FBAGraphData* FoundGraphData = PackageData.GraphData.Find(GraphGuid);
+	if (!FoundGraphData)
+	{
+		// from here on the graph is edited in memory, the index only still answers for the package's other graphs
+		FoundGraphData = &PackageData.GraphData.Add(GraphGuid);
+		const TSharedPtr<FBAPackageIndex> Index = PackageIndices.FindRef(PackageName);
+		if (const FBAPackageIndex::FGraphRecord* GraphRecord = Index.IsValid() ? Index->FindGraph(GraphGuid) : nullptr)
+		{
+			Index->ReadGraph(*GraphRecord, *FoundGraphData);
+		}
+	}
 
-	FBAGraphData& GraphData = PackageData.GraphData.FindOrAdd(FBAUtils::GetGraphGuid(Graph));
+	FBAGraphData& GraphData = *FoundGraphData;
 	if (!GraphData.bTriedLoadingMetaData)
 	{
 		LoadGraphDataFromPackageMetaData(Graph, GraphData);
@@ -203,6 +523,311 @@ FBAGraphData& FBACache::GetGraphData(UEdGraph* Graph)
 	return GraphData;
 }
 
+FBAGraphData* FBACache::FindEditedGraphData(UEdGraph* Graph)
+{
+	if (!Graph)
+	{
+		return nullptr;
+	}
+
+	FBAPackageData* PackageData = CacheData.PackageData.Find(Graph->GetOutermost()->GetFName());
+	return PackageData ? PackageData->GraphData.Find(FBAUtils::GetGraphGuid(Graph)) : nullptr;
+}
+
+const FBANodeData* FBACache::FindEditedNodeData(UEdGraph* Graph, UEdGraphNode* Node, bool& bOutGraphEdited)
+{
+	EnsurePackageLoaded(Graph->GetOutermost()->GetFName());
+
+	const FBAGraphData* GraphData = FindEditedGraphData(Graph);
+
+	// edited data which has not taken in the package meta data yet needs GetGraphData to merge it
+	if (GraphData && !GraphData->bTriedLoadingMetaData && GetDefault<UBASettings_Advanced>()->bStoreCacheDataInPackageMetaData)
+	{
+		GraphData = &GetGraphData(Graph);
+	}
+
+	// json meta data from older versions can only be read whole
+	if (!GraphData && GetDefault<UBASettings_Advanced>()->bStoreCacheDataInPackageMetaData && !FindMetaDataIndex(Graph) && BACacheMetaData::FindValue(Graph))
+	{
+		GraphData = &GetGraphData(Graph);
+	}
+
+	bOutGraphEdited = GraphData != nullptr;
+	return GraphData ? GraphData->NodeData.Find(FBAUtils::GetNodeGuid(Node)) : nullptr;
+}
+
+const FBAPackageIndex::FNodeRecord* FBACache::FindIndexedNode(UEdGraph* Graph, UEdGraphNode* Node, const FBAPackageIndex*& OutIndex)
+{
+	// the package meta data wins over the cache file, as in GetGraphData
+	if (GetDefault<UBASettings_Advanced>()->bStoreCacheDataInPackageMetaData)
+	{
+		if (const FBAPackageIndex* MetaDataIndex = FindMetaDataIndex(Graph))
+		{
+			if (const FBAPackageIndex::FGraphRecord* GraphRecord = MetaDataIndex->FindGraph(BACacheMetaData::StoredGraphGuid))
+			{
+				OutIndex = MetaDataIndex;
+				return MetaDataIndex->FindNode(*GraphRecord, FBAUtils::GetNodeGuid(Node));
+			}
+		}
+	}
+
+	const TSharedPtr<FBAPackageIndex> Index = PackageIndices.FindRef(Graph->GetOutermost()->GetFName());
+	if (!Index.IsValid())
+	{
+		return nullptr;
+	}
+
+	const FBAPackageIndex::FGraphRecord* GraphRecord = Index->FindGraph(FBAUtils::GetGraphGuid(Graph));
+	OutIndex = Index.Get();
+	return GraphRecord ? Index->FindNode(*GraphRecord, FBAUtils::GetNodeGuid(Node)) : nullptr;
+}
+
+const FBAPackageIndex* FBACache::FindMetaDataIndex(UEdGraph* Graph)
+{
+	if (const TSharedPtr<FBAPackageIndex>* Found = MetaDataIndices.Find(Graph))
+	{
+		return Found->Get();
+	}
+
+	TSharedPtr<FBAPackageIndex> Index;
+	if (const FString* GraphDataAsString = BACacheMetaData::FindValue(Graph))
+	{
+		Index = BACacheMetaData::Decode(*GraphDataAsString);
+	}
+
+	// forget the graphs which were unloaded since
+	for (auto It = MetaDataIndices.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	MetaDataIndices.Add(Graph, Index);
+	return Index.Get();
+}
+
+bool FBACache::FindNodeSize(UEdGraph* Graph, UEdGraphNode* Node, FVector2D& OutSize)
+{
+	if (!Graph || !Node)
+	{
+		return false;
+	}
+
+	bool bGraphEdited = false;
+	if (const FBANodeData* NodeData = FindEditedNodeData(Graph, Node, bGraphEdited))
+	{
+		OutSize = NodeData->CachedNodeSize;
+		return NodeData->HasSize();
+	}
+
+	const FBAPackageIndex* Index = nullptr;
+	const FBAPackageIndex::FNodeRecord* NodeRecord = bGraphEdited ? nullptr : FindIndexedNode(Graph, Node, Index);
+	if (NodeRecord && (NodeRecord->SizeX != 0 || NodeRecord->SizeY != 0))
+	{
+		OutSize = FVector2D(NodeRecord->SizeX, NodeRecord->SizeY);
+		return true;
+	}
+
+	return false;
+}
+
+bool FBACache::FindPinOffset(UEdGraph* Graph, UEdGraphNode* Node, const FGuid& PinId, float& OutOffset)
+{
+	if (!Graph || !Node)
+	{
+		return false;
+	}
+
+	bool bGraphEdited = false;
+	if (const FBANodeData* NodeData = FindEditedNodeData(Graph, Node, bGraphEdited))
+	{
+		const float* FoundOffset = NodeData->CachedPins.Find(PinId);
+		OutOffset = FoundOffset ? *FoundOffset : 0.0f;
+		return FoundOffset != nullptr;
+	}
+
+	const FBAPackageIndex* Index = nullptr;
+	if (const FBAPackageIndex::FNodeRecord* NodeRecord = bGraphEdited ? nullptr : FindIndexedNode(Graph, Node, Index))
+	{
+		if (const float* FoundOffset = Index->FindPinOffset(*NodeRecord, PinId))
+		{
+			OutOffset = *FoundOffset;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+FGuid FBACache::FindNodeGroup(UEdGraph* Graph, UEdGraphNode* Node)
+{
+	if (!Graph || !Node)
+	{
+		return FGuid();
+	}
+
+	bool bGraphEdited = false;
+	if (const FBANodeData* NodeData = FindEditedNodeData(Graph, Node, bGraphEdited))
+	{
+		return NodeData->NodeGroup;
+	}
+
+	const FBAPackageIndex* Index = nullptr;
+	const FBAPackageIndex::FNodeRecord* NodeRecord = bGraphEdited ? nullptr : FindIndexedNode(Graph, Node, Index);
+	return NodeRecord ? NodeRecord->NodeGroup : FGuid();
+}
+
+void FBACache::EnsurePackageLoaded(FName PackageName)
+{
+	// a package in the old index is only known once the index was read
+	FinishLoadingCache();
+
+	PackageAccessTime.Add(PackageName, FPlatformTime::Seconds());
+
+	if (!LoadedPackages.Contains(PackageName))
+	{
+		LoadedPackages.Add(PackageName);
+		LoadPackageData(PackageName);
+	}
+}
+
+void FBACache::CompactPackageData(FName PackageName, FBAPackageData& PackageData)
+{
+	// which graphs and pins still exist is only known while the package is loaded
+	UPackage* Package = FindPackage(nullptr, *PackageName.ToString());
+	if (Package)
+	{
+		TMap<FGuid, UEdGraph*> Graphs;
+		ForEachObjectWithPackage(Package, [&Graphs](UObject* Object)
+		{
+			if (UEdGraph* Graph = Cast<UEdGraph>(Object))
+			{
+				Graphs.Add(FBAUtils::GetGraphGuid(Graph), Graph);
+			}
+			return true;
+		});
+
+		for (auto It = PackageData.GraphData.CreateIterator(); It; ++It)
+		{
+			if (UEdGraph* Graph = Graphs.FindRef(It.Key()))
+			{
+				It.Value().CleanupGraph(Graph);
+			}
+			else
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// GetNodeData adds an entry for every node it is asked about, most of them never get a size
+	for (TPair<FGuid, FBAGraphData>& Graph : PackageData.GraphData)
+	{
+		for (auto It = Graph.Value.NodeData.CreateIterator(); It; ++It)
+		{
+			const FBANodeData& NodeData = It.Value();
+			if (!NodeData.HasSize() && NodeData.CachedPins.Num() == 0 && !NodeData.bLocked && !NodeData.NodeGroup.IsValid() && NodeData.NodeGroups.Num() == 0)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void FBACache::ReleaseUnusedPackages()
+{
+	const float ReleaseMinutes = UBASettings_Advanced::Get().ReleaseUnusedCacheDataMinutes;
+	if (ReleaseMinutes <= 0.0f)
+	{
+		return;
+	}
+
+	// a package released here was just saved, reading it back waits for that write
+	const double ReleaseBefore = FPlatformTime::Seconds() - ReleaseMinutes * 60.0;
+	for (auto It = PackageAccessTime.CreateIterator(); It; ++It)
+	{
+		if (It.Value() < ReleaseBefore && !DirtyPackages.Contains(It.Key()))
+		{
+			CacheData.PackageData.Remove(It.Key());
+			PackageIndices.Remove(It.Key());
+			LoadedPackages.Remove(It.Key());
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FBACache::LoadPackageData(FName PackageName)
+{
+	if (!UBASettings::Get().bSaveBlueprintAssistCacheToFile)
+	{
+		return false;
+	}
+
+	// the file may still be being written
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+	}
+
+	// map the index, falling back to the other save location; the data moves over on the next save
+	for (const bool bAlternate : { false, true })
+	{
+		if (TSharedPtr<FBAPackageIndex> Index = FBAPackageIndex::Open(GetPackageCacheFilename(PackageName, bAlternate), PackageName))
+		{
+			PackageIndices.Add(PackageName, Index);
+			return true;
+		}
+	}
+
+	// a file from before the index format is read whole and written back as an index
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *GetPackageCacheFilename(PackageName), FILEREAD_Silent)
+		&& !FFileHelper::LoadFileToArray(Bytes, *GetPackageCacheFilename(PackageName, true), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	FString Name;
+	Reader << Magic << Version;
+	if (Magic != PACKAGE_CACHE_MAGIC || Version != PACKAGE_CACHE_VERSION)
+	{
+		return false;
+	}
+
+	Reader << Name;
+	FBAPackageData PackageData;
+	Reader << PackageData;
+	if (Reader.IsError() || Name != PackageName.ToString())
+	{
+		UE_LOG(LogBlueprintAssist, Log, TEXT("Failed to load package cache: %s"), *GetPackageCacheFilename(PackageName));
+		return false;
+	}
+
+	CacheData.PackageData.Add(PackageName, MoveTemp(PackageData));
+	DirtyPackages.Add(PackageName);
+	return true;
+}
+
+FString FBACache::GetPackageCacheDir(bool bAlternate)
+{
+	const FString CachePath = bAlternate ? GetAlternateCachePath() : GetCachePath();
+	return FPaths::GetPath(CachePath) / FPaths::GetBaseFilename(CachePath) + TEXT("_Packages");
+}
+
+FString FBACache::GetPackageCacheFilename(FName PackageName, bool bAlternate)
+{
+	// '@' is not allowed in package names, so it can stand in for the path separators
+	FString FileName = PackageName.ToString();
+	FileName.RemoveFromStart(TEXT("/"));
+	FileName.ReplaceInline(TEXT("/"), TEXT("@"));
+	return GetPackageCacheDir(bAlternate) / FileName + TEXT(".bacache");
+}
+
 FString FBACache::GetProjectSavedCachePath(bool bFullPath)
 {
 	return FPaths::ProjectDir() / TEXT("Saved") / TEXT("BlueprintAssist") / TEXT("BlueprintAssistCache.json");
@@ -268,12 +893,11 @@ void FBACache::SaveGraphDataToPackageMetaData(UEdGraph* Graph)
 			FBAGraphData& GraphData = GetGraphData(Graph);
 
 			GraphData.CleanupGraph(Graph);
-			
-			FString GraphDataAsString;
-			if (FJsonObjectConverter::UStructToJsonObjectString(GraphData, GraphDataAsString))
-			{
-				MetaData->SetValue(Graph, NAME_BA_GRAPH_DATA, *GraphDataAsString);
-			}
+
+			MetaData->SetValue(Graph, NAME_BA_GRAPH_DATA, *BACacheMetaData::Encode(GraphData));
+
+			// the edited data answers for the graph from now on
+			MetaDataIndices.Remove(Graph);
 		}
 	}
 }
@@ -290,19 +914,25 @@ bool FBACache::LoadGraphDataFromPackageMetaData(UEdGraph* Graph, FBAGraphData& G
 		return false;
 	}
 
-	if (UPackage* AssetPackage = Graph->GetPackage())
+	// whether or not there is any, the meta data is only read once
+	GraphData.bTriedLoadingMetaData = true;
+	MetaDataIndices.Remove(Graph);
+
+	if (const FString* GraphDataAsString = BACacheMetaData::FindValue(Graph))
 	{
-		if (UMetaData* MetaData = AssetPackage->GetMetaData())
+		if (TSharedPtr<FBAPackageIndex> Index = BACacheMetaData::Decode(*GraphDataAsString))
 		{
-			if (const FString* GraphDataAsString = MetaData->FindValue(Graph, NAME_BA_GRAPH_DATA))
+			if (const FBAPackageIndex::FGraphRecord* GraphRecord = Index->FindGraph(BACacheMetaData::StoredGraphGuid))
 			{
-				if (FJsonObjectConverter::JsonObjectStringToUStruct(*GraphDataAsString, &GraphData, 0, 0))
-				{
-					GraphData.bTriedLoadingMetaData = true;
-					return true;
-				}
+				GraphData.NodeData.Reset();
+				Index->ReadGraph(*GraphRecord, GraphData);
+				return true;
 			}
 		}
+		else if (FJsonObjectConverter::JsonObjectStringToUStruct(*GraphDataAsString, &GraphData, 0, 0))
+		{
+			return true;
+		}
 	}
 
 	return false;
@@ -316,6 +946,8 @@ void FBACache::ClearPackageMetaData(UEdGraph* Graph)
 		{
 			MetaData->RemoveValue(Graph, NAME_BA_GRAPH_DATA);
 		}
+
+		MetaDataIndices.Remove(Graph);
 	}
 }
 
@@ -333,28 +965,7 @@ void FBAGraphData::CleanupGraph(UEdGraph* Graph)
 		// Collect all node guids from the graph
 		CurrentNodes.Add(FBAUtils::GetNodeGuid(Node));
 
-		if (FBANodeData* FoundNode = NodeData.Find(FBAUtils::GetNodeGuid(Node)))
-		{
-			// Collect current pin guids
-			TSet<FGuid> CurrentPins;
-			for (UEdGraphPin* Pin : Node->Pins)
-			{
-				CurrentPins.Add(Pin->PinId);
-			}
-
-			// Collect cached pin guids
-			TArray<FGuid> CachedPinGuids;
-			FoundNode->CachedPins.GetKeys(CachedPinGuids);
-
-			// Cleanup missing guids
-			for (FGuid PinGuid : CachedPinGuids)
-			{
-				if (!CurrentPins.Contains(PinGuid))
-				{
-					FoundNode->CachedPins.Remove(PinGuid);
-				}
-			}
-		}
+		CleanupNodePins(Node);
 	}
 
 	// Remove any missing guids from the cached nodes
@@ -370,11 +981,107 @@ void FBAGraphData::CleanupGraph(UEdGraph* Graph)
 	}
 }
 
+void FBAGraphData::CleanupNodePins(UEdGraphNode* Node)
+{
+	FBANodeData* FoundNode = NodeData.Find(FBAUtils::GetNodeGuid(Node));
+	if (!FoundNode || FoundNode->CachedPins.Num() == 0)
+	{
+		return;
+	}
+
+	// Collect current pin guids
+	TSet<FGuid> CurrentPins;
+	for (UEdGraphPin* Pin : Node->Pins)
+	{
+		CurrentPins.Add(Pin->PinId);
+	}
+
+	// Cleanup missing guids
+	for (auto It = FoundNode->CachedPins.CreateIterator(); It; ++It)
+	{
+		if (!CurrentPins.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 FBANodeData& FBAGraphData::GetNodeData(UEdGraphNode* Node)
 {
 	return NodeData.FindOrAdd(FBAUtils::GetNodeGuid(Node));
 }
 
+void FBAGraphCleanup::Start(UEdGraph* InGraph)
+{
+	Reset();
+
+	Graph = InGraph;
+	NumGraphNodes = InGraph ? InGraph->Nodes.Num() : 0;
+	CurrentNodes.Reserve(NumGraphNodes);
+}
+
+void FBAGraphCleanup::Reset()
+{
+	Graph.Reset();
+	NumGraphNodes = 0;
+	NextIndex = 0;
+	bCollectedNodes = false;
+	CurrentNodes.Reset();
+	CachedNodeGuids.Reset();
+}
+
+bool FBAGraphCleanup::Step(FBAGraphData& GraphData, int32 Budget)
+{
+	UEdGraph* MyGraph = Graph.Get();
+	if (!MyGraph)
+	{
+		Reset();
+		return true;
+	}
+
+	if (MyGraph->Nodes.Num() != NumGraphNodes)
+	{
+		Start(MyGraph);
+	}
+
+	if (!bCollectedNodes)
+	{
+		for (; NextIndex < MyGraph->Nodes.Num() && Budget > 0; ++NextIndex, --Budget)
+		{
+			if (UEdGraphNode* Node = MyGraph->Nodes[NextIndex])
+			{
+				CurrentNodes.Add(FBAUtils::GetNodeGuid(Node));
+				GraphData.CleanupNodePins(Node);
+			}
+		}
+
+		if (NextIndex < MyGraph->Nodes.Num())
+		{
+			return false;
+		}
+
+		bCollectedNodes = true;
+		NextIndex = 0;
+		GraphData.NodeData.GetKeys(CachedNodeGuids);
+	}
+
+	for (; NextIndex < CachedNodeGuids.Num() && Budget > 0; ++NextIndex, --Budget)
+	{
+		if (!CurrentNodes.Contains(CachedNodeGuids[NextIndex]))
+		{
+			GraphData.NodeData.Remove(CachedNodeGuids[NextIndex]);
+		}
+	}
+
+	if (NextIndex < CachedNodeGuids.Num())
+	{
+		return false;
+	}
+
+	Reset();
+	return true;
+}
+
 #if BA_UE_VERSION_OR_LATER(5, 0)
 void FBACache::OnObjectPreSave(UObject* Object, FObjectPreSaveContext Context)
 {
@@ -398,7 +1105,7 @@ void FBACache::OnObjectSaved(UObject* Object)
 
 	if (!bHasSavedThisFrame)
 	{
-		SaveCache();
+		RequestSave();
 		bHasSavedThisFrame = true;
 	}
 
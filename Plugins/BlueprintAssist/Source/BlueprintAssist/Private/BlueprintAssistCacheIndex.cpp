@@ -0,0 +1,300 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistCacheIndex.h"
+
+#include "BlueprintAssistCache.h"
+#include "BlueprintAssistGlobals.h"
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+#define PACKAGE_INDEX_MAGIC 0x42414932 // "BAI2"
+#define PACKAGE_INDEX_VERSION 1
+
+namespace BAPackageIndex
+{
+	struct FHeader
+	{
+		uint32 Magic;
+		int32 Version;
+		int32 NameBytes;
+		int32 NumGraphs;
+		int32 NumNodes;
+		int32 NumPins;
+		int32 NumGroups;
+		int32 Padding;
+	};
+
+	// every record is made of 4 byte fields, keeping each array 4 byte aligned keeps the mapped records readable in place
+	int64 Align4(int64 Offset)
+	{
+		return (Offset + 3) & ~int64(3);
+	}
+
+	template <typename T>
+	void Append(TArray<uint8>& Bytes, const T* Items, int32 Num)
+	{
+		const int64 NumBytes = static_cast<int64>(sizeof(T)) * Num;
+		Bytes.Append(reinterpret_cast<const uint8*>(Items), NumBytes);
+	}
+
+	template <typename T>
+	TArray<FGuid> GetSortedKeys(const TMap<FGuid, T>& Map)
+	{
+		TArray<FGuid> Keys;
+		Map.GetKeys(Keys);
+		Keys.Sort();
+		return Keys;
+	}
+}
+
+FBAPackageIndex::~FBAPackageIndex()
+{
+	// the region has to go before the handle it was mapped from
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
+
+TSharedPtr<FBAPackageIndex> FBAPackageIndex::Open(const FString& Path, FName PackageName)
+{
+	TSharedPtr<FBAPackageIndex> Index = MakeShareable(new FBAPackageIndex());
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Path))
+	{
+		return nullptr;
+	}
+
+#if BA_UE_VERSION_OR_LATER(5, 3)
+	FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*Path);
+	if (!MappedResult.HasError())
+	{
+		Index->MappedHandle = MappedResult.StealValue();
+	}
+#else
+	Index->MappedHandle.Reset(PlatformFile.OpenMapped(*Path));
+#endif
+
+	if (Index->MappedHandle.IsValid())
+	{
+		Index->MappedRegion.Reset(Index->MappedHandle->MapRegion());
+	}
+
+	if (Index->MappedRegion.IsValid())
+	{
+		Index->Data = Index->MappedRegion->GetMappedPtr();
+		Index->Size = Index->MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// no mapping on this platform, the file is small enough to read whole
+		Index->MappedHandle.Reset();
+		if (!FFileHelper::LoadFileToArray(Index->LoadedBytes, *Path, FILEREAD_Silent))
+		{
+			return nullptr;
+		}
+
+		Index->Data = Index->LoadedBytes.GetData();
+		Index->Size = Index->LoadedBytes.Num();
+	}
+
+	if (!Index->Parse(PackageName))
+	{
+		return nullptr;
+	}
+
+	return Index;
+}
+
+TSharedPtr<FBAPackageIndex> FBAPackageIndex::FromBytes(TArray<uint8>&& Bytes, FName PackageName)
+{
+	TSharedPtr<FBAPackageIndex> Index = MakeShareable(new FBAPackageIndex());
+	Index->LoadedBytes = MoveTemp(Bytes);
+	Index->Data = Index->LoadedBytes.GetData();
+	Index->Size = Index->LoadedBytes.Num();
+
+	if (!Index->Parse(PackageName))
+	{
+		return nullptr;
+	}
+
+	return Index;
+}
+
+bool FBAPackageIndex::Parse(FName PackageName)
+{
+	using namespace BAPackageIndex;
+
+	if (Size < static_cast<int64>(sizeof(FHeader)))
+	{
+		return false;
+	}
+
+	const FHeader& Header = *reinterpret_cast<const FHeader*>(Data);
+	if (Header.Magic != PACKAGE_INDEX_MAGIC || Header.Version != PACKAGE_INDEX_VERSION
+		|| Header.NameBytes < 0 || Header.NumGraphs < 0 || Header.NumNodes < 0 || Header.NumPins < 0 || Header.NumGroups < 0)
+	{
+		return false;
+	}
+
+	int64 Offset = sizeof(FHeader);
+	const int64 GraphsOffset = Align4(Offset + Header.NameBytes);
+	const int64 NodesOffset = GraphsOffset + static_cast<int64>(sizeof(FGraphRecord)) * Header.NumGraphs;
+	const int64 PinsOffset = NodesOffset + static_cast<int64>(sizeof(FNodeRecord)) * Header.NumNodes;
+	const int64 GroupsOffset = PinsOffset + static_cast<int64>(sizeof(FPinRecord)) * Header.NumPins;
+	const int64 EndOffset = GroupsOffset + static_cast<int64>(sizeof(FGuid)) * Header.NumGroups;
+	if (EndOffset > Size)
+	{
+		return false;
+	}
+
+	// the file name is derived from the package name, the stored one guards against two names mapping to the same file
+	const FUTF8ToTCHAR StoredName(reinterpret_cast<const ANSICHAR*>(Data + Offset), Header.NameBytes);
+	if (FString(StoredName.Length(), StoredName.Get()) != PackageName.ToString())
+	{
+		return false;
+	}
+
+	Graphs = MakeArrayView(reinterpret_cast<const FGraphRecord*>(Data + GraphsOffset), Header.NumGraphs);
+	Nodes = MakeArrayView(reinterpret_cast<const FNodeRecord*>(Data + NodesOffset), Header.NumNodes);
+	Pins = MakeArrayView(reinterpret_cast<const FPinRecord*>(Data + PinsOffset), Header.NumPins);
+	Groups = MakeArrayView(reinterpret_cast<const FGuid*>(Data + GroupsOffset), Header.NumGroups);
+
+	// a corrupt range would read past the arrays, check them once here so lookups need not
+	for (const FGraphRecord& Graph : Graphs)
+	{
+		if (Graph.FirstNode < 0 || Graph.NumNodes < 0 || Graph.FirstNode + Graph.NumNodes > Nodes.Num())
+		{
+			return false;
+		}
+	}
+
+	for (const FNodeRecord& Node : Nodes)
+	{
+		if (Node.FirstPin < 0 || Node.NumPins < 0 || Node.FirstPin + Node.NumPins > Pins.Num()
+			|| Node.FirstGroup < 0 || Node.NumGroups < 0 || Node.FirstGroup + Node.NumGroups > Groups.Num())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+TArray<uint8> FBAPackageIndex::Write(FName PackageName, const FBAPackageData& PackageData)
+{
+	using namespace BAPackageIndex;
+
+	TArray<FGraphRecord> GraphRecords;
+	TArray<FNodeRecord> NodeRecords;
+	TArray<FPinRecord> PinRecords;
+	TArray<FGuid> GroupRecords;
+
+	for (const FGuid& GraphGuid : GetSortedKeys(PackageData.GraphData))
+	{
+		const FBAGraphData& GraphData = PackageData.GraphData[GraphGuid];
+
+		FGraphRecord& GraphRecord = GraphRecords.AddZeroed_GetRef();
+		GraphRecord.GraphGuid = GraphGuid;
+		GraphRecord.FirstNode = NodeRecords.Num();
+		GraphRecord.NumNodes = GraphData.NodeData.Num();
+
+		for (const FGuid& NodeGuid : GetSortedKeys(GraphData.NodeData))
+		{
+			const FBANodeData& NodeData = GraphData.NodeData[NodeGuid];
+
+			FNodeRecord& NodeRecord = NodeRecords.AddZeroed_GetRef();
+			NodeRecord.NodeGuid = NodeGuid;
+			NodeRecord.NodeGroup = NodeData.NodeGroup;
+			NodeRecord.SizeX = NodeData.CachedNodeSize.X;
+			NodeRecord.SizeY = NodeData.CachedNodeSize.Y;
+			NodeRecord.bLocked = NodeData.bLocked ? 1 : 0;
+
+			NodeRecord.FirstPin = PinRecords.Num();
+			NodeRecord.NumPins = NodeData.CachedPins.Num();
+			for (const FGuid& PinGuid : GetSortedKeys(NodeData.CachedPins))
+			{
+				FPinRecord& PinRecord = PinRecords.AddZeroed_GetRef();
+				PinRecord.PinGuid = PinGuid;
+				PinRecord.Offset = NodeData.CachedPins[PinGuid];
+			}
+
+			NodeRecord.FirstGroup = GroupRecords.Num();
+			NodeRecord.NumGroups = NodeData.NodeGroups.Num();
+			GroupRecords.Append(NodeData.NodeGroups);
+		}
+	}
+
+	const FTCHARToUTF8 Name(*PackageName.ToString());
+
+	FHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = PACKAGE_INDEX_MAGIC;
+	Header.Version = PACKAGE_INDEX_VERSION;
+	Header.NameBytes = Name.Length();
+	Header.NumGraphs = GraphRecords.Num();
+	Header.NumNodes = NodeRecords.Num();
+	Header.NumPins = PinRecords.Num();
+	Header.NumGroups = GroupRecords.Num();
+
+	TArray<uint8> Bytes;
+	Append(Bytes, &Header, 1);
+	Append(Bytes, reinterpret_cast<const uint8*>(Name.Get()), Name.Length());
+	Bytes.AddZeroed(Align4(Bytes.Num()) - Bytes.Num());
+	Append(Bytes, GraphRecords.GetData(), GraphRecords.Num());
+	Append(Bytes, NodeRecords.GetData(), NodeRecords.Num());
+	Append(Bytes, PinRecords.GetData(), PinRecords.Num());
+	Append(Bytes, GroupRecords.GetData(), GroupRecords.Num());
+	return Bytes;
+}
+
+const FBAPackageIndex::FGraphRecord* FBAPackageIndex::FindGraph(const FGuid& GraphGuid) const
+{
+	const int32 Found = Algo::BinarySearchBy(Graphs, GraphGuid, &FGraphRecord::GraphGuid);
+	return Found != INDEX_NONE ? &Graphs[Found] : nullptr;
+}
+
+const FBAPackageIndex::FNodeRecord* FBAPackageIndex::FindNode(const FGraphRecord& Graph, const FGuid& NodeGuid) const
+{
+	const TArrayView<const FNodeRecord> GraphNodes = Nodes.Slice(Graph.FirstNode, Graph.NumNodes);
+	const int32 Found = Algo::BinarySearchBy(GraphNodes, NodeGuid, &FNodeRecord::NodeGuid);
+	return Found != INDEX_NONE ? &GraphNodes[Found] : nullptr;
+}
+
+const float* FBAPackageIndex::FindPinOffset(const FNodeRecord& Node, const FGuid& PinGuid) const
+{
+	const TArrayView<const FPinRecord> NodePins = Pins.Slice(Node.FirstPin, Node.NumPins);
+	const int32 Found = Algo::BinarySearchBy(NodePins, PinGuid, &FPinRecord::PinGuid);
+	return Found != INDEX_NONE ? &NodePins[Found].Offset : nullptr;
+}
+
+void FBAPackageIndex::ReadGraph(const FGraphRecord& Graph, FBAGraphData& OutGraphData) const
+{
+	OutGraphData.NodeData.Reserve(OutGraphData.NodeData.Num() + Graph.NumNodes);
+	for (const FNodeRecord& Node : Nodes.Slice(Graph.FirstNode, Graph.NumNodes))
+	{
+		FBANodeData& NodeData = OutGraphData.NodeData.Add(Node.NodeGuid);
+		NodeData.CachedNodeSize = FVector2D(Node.SizeX, Node.SizeY);
+		NodeData.bLocked = Node.bLocked != 0;
+		NodeData.NodeGroup = Node.NodeGroup;
+		NodeData.NodeGroups = TArray<FGuid>(Groups.Slice(Node.FirstGroup, Node.NumGroups));
+
+		NodeData.CachedPins.Reserve(Node.NumPins);
+		for (const FPinRecord& Pin : Pins.Slice(Node.FirstPin, Node.NumPins))
+		{
+			NodeData.CachedPins.Add(Pin.PinGuid, Pin.Offset);
+		}
+	}
+}
+
+void FBAPackageIndex::ReadPackage(FBAPackageData& OutPackageData) const
+{
+	for (const FGraphRecord& Graph : Graphs)
+	{
+		if (!OutPackageData.GraphData.Contains(Graph.GraphGuid))
+		{
+			ReadGraph(Graph, OutPackageData.GraphData.Add(Graph.GraphGuid));
+		}
+	}
+}
@@ -0,0 +1,301 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistFormatters/BAFormatterBenchmark.h"
+
+#include "BlueprintAssistGlobals.h"
+#include "BlueprintAssistGraphHandler.h"
+#include "BlueprintAssistSettings.h"
+#include "BlueprintAssistUtils.h"
+#include "Editor.h"
+#include "EdGraph/EdGraph.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace BAFormatterBenchmark
+{
+	struct FNodePosition
+	{
+		uint32 GuidHash;
+		int32 X;
+		int32 Y;
+	};
+
+	// a median may get this much slower than the baseline's before it is reported
+	constexpr double BaselineTolerance = 0.2;
+
+	FString GetBaselinePath()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("BlueprintAssist") / TEXT("FormatAllBaseline.json");
+	}
+
+	void RunFromConsole(const TArray<FString>& Args)
+	{
+		TSharedPtr<FBAGraphHandler> GraphHandler = FBAUtils::GetCurrentGraphHandler();
+		if (!GraphHandler)
+		{
+			UE_LOG(LogBlueprintAssist, Warning, TEXT("BenchmarkFormatAll: open a blueprint graph first"));
+			return;
+		}
+
+		int32 NumIterations = 5;
+		bool bSaveBaseline = false;
+		for (const FString& Arg : Args)
+		{
+			if (Arg.Equals(TEXT("-SaveBaseline"), ESearchCase::IgnoreCase))
+			{
+				bSaveBaseline = true;
+			}
+			else
+			{
+				NumIterations = FMath::Max(1, FCString::Atoi(*Arg));
+			}
+		}
+
+		TArray<FBAFormatterBenchmarkResult> Results;
+		if (FBAFormatterBenchmark::Run(GraphHandler, NumIterations, Results))
+		{
+			FBAFormatterBenchmark::LogResults(GraphHandler->GetFocusedEdGraph(), Results);
+			FBAFormatterBenchmark::CheckBaseline(GraphHandler->GetFocusedEdGraph(), Results, bSaveBaseline);
+		}
+	}
+
+	FAutoConsoleCommand BenchmarkFormatAllCommand(
+		TEXT("BlueprintAssist.BenchmarkFormatAll"),
+		TEXT("Times format all on the focused graph with each format all style and checks it against its baseline. Args: [Iterations] [-SaveBaseline]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunFromConsole));
+}
+
+double FBAFormatterBenchmarkResult::GetMedianSeconds() const
+{
+	if (Seconds.Num() == 0)
+	{
+		return 0.0;
+	}
+
+	TArray<double> Sorted = Seconds;
+	Sorted.Sort();
+	return Sorted[Sorted.Num() / 2];
+}
+
+bool FBAFormatterBenchmarkResult::IsDeterministic() const
+{
+	for (uint32 Hash : PositionHashes)
+	{
+		if (Hash != PositionHashes[0])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FBAFormatterBenchmark::Run(TSharedPtr<FBAGraphHandler> GraphHandler, int32 NumIterations, TArray<FBAFormatterBenchmarkResult>& OutResults)
+{
+	UEdGraph* Graph = GraphHandler ? GraphHandler->GetFocusedEdGraph() : nullptr;
+	if (!Graph || !GEditor)
+	{
+		return false;
+	}
+
+	if (GraphHandler->IsCalculatingNodeSize() || GraphHandler->HasActiveTransaction() || GraphHandler->IsFormatAllPending())
+	{
+		UE_LOG(LogBlueprintAssist, Warning, TEXT("BenchmarkFormatAll: wait for the current formatting to finish"));
+		return false;
+	}
+
+	// the benchmark measures the formatters, not slate, every size has to come from the cache
+	for (UEdGraphNode* Node : Graph->Nodes)
+	{
+		if (FBAUtils::IsGraphNode(Node) && !FBAUtils::IsKnotNode(Node) && !GraphHandler->HasCachedNodeSize(Node))
+		{
+			UE_LOG(LogBlueprintAssist, Warning, TEXT("BenchmarkFormatAll: %s has no cached size, run format all once first"), *FBAUtils::GetNodeName(Node));
+			return false;
+		}
+	}
+
+	UBASettings& Settings = UBASettings::GetMutable();
+	const EBAFormatAllStyle OriginalStyle = Settings.FormatAllStyle;
+
+	const UEnum* StyleEnum = StaticEnum<EBAFormatAllStyle>();
+	for (int32 StyleIndex = 0; StyleIndex < StyleEnum->NumEnums() - 1; ++StyleIndex)
+	{
+		FBAFormatterBenchmarkResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Style = static_cast<EBAFormatAllStyle>(StyleEnum->GetValueByIndex(StyleIndex));
+		Settings.FormatAllStyle = Result.Style;
+
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			// a formatter kept from the last iteration would skip straight to moving the nodes relative to the root
+			GraphHandler->ClearFormatters();
+
+			const double StartTime = FPlatformTime::Seconds();
+			GraphHandler->FormatAllEvents();
+
+			// format all only opens its transaction when there is something to format, undoing without one would undo the user's last edit
+			if (!GraphHandler->HasActiveTransaction())
+			{
+				UE_LOG(LogBlueprintAssist, Warning, TEXT("BenchmarkFormatAll: the graph has no nodes to format"));
+				Settings.FormatAllStyle = OriginalStyle;
+				return false;
+			}
+
+			GraphHandler->UpdateNodesRequiringFormatting();
+			const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+			if (GraphHandler->IsFormatAllPending())
+			{
+				// some sizes changed while refreshing them, the format will finish on tick once they are measured
+				UE_LOG(LogBlueprintAssist, Warning, TEXT("BenchmarkFormatAll: node sizes changed during the benchmark, run it again once formatting finishes"));
+				Settings.FormatAllStyle = OriginalStyle;
+				return false;
+			}
+
+			Result.Seconds.Add(Seconds);
+			Result.PositionHashes.Add(HashNodePositions(Graph));
+
+			GEditor->UndoTransaction();
+		}
+	}
+
+	Settings.FormatAllStyle = OriginalStyle;
+	GraphHandler->ClearFormatters();
+	return true;
+}
+
+uint32 FBAFormatterBenchmark::HashNodePositions(UEdGraph* Graph)
+{
+	using namespace BAFormatterBenchmark;
+
+	TArray<FNodePosition> Positions;
+	Positions.Reserve(Graph->Nodes.Num());
+	for (UEdGraphNode* Node : Graph->Nodes)
+	{
+		if (Node)
+		{
+			const uint32 GuidHash = FBAUtils::IsKnotNode(Node) ? 0 : GetTypeHash(Node->NodeGuid);
+			Positions.Add({ GuidHash, Node->NodePosX, Node->NodePosY });
+		}
+	}
+
+	Positions.Sort([](const FNodePosition& A, const FNodePosition& B)
+	{
+		if (A.GuidHash != B.GuidHash)
+		{
+			return A.GuidHash < B.GuidHash;
+		}
+
+		return A.X != B.X ? A.X < B.X : A.Y < B.Y;
+	});
+
+	uint32 Hash = GetTypeHash(Positions.Num());
+	for (const FNodePosition& Position : Positions)
+	{
+		Hash = HashCombine(Hash, HashCombine(Position.GuidHash, HashCombine(GetTypeHash(Position.X), GetTypeHash(Position.Y))));
+	}
+
+	return Hash;
+}
+
+void FBAFormatterBenchmark::LogResults(UEdGraph* Graph, const TArray<FBAFormatterBenchmarkResult>& Results)
+{
+	const UEnum* StyleEnum = StaticEnum<EBAFormatAllStyle>();
+
+	UE_LOG(LogBlueprintAssist, Log, TEXT("BenchmarkFormatAll: %s (%d nodes)"), *GetPathNameSafe(Graph), Graph ? Graph->Nodes.Num() : 0);
+	for (const FBAFormatterBenchmarkResult& Result : Results)
+	{
+		UE_LOG(LogBlueprintAssist, Log, TEXT("\t%-10s median %8.3f ms over %d runs | positions %08x%s"),
+			*StyleEnum->GetNameStringByValue(static_cast<int64>(Result.Style)),
+			Result.GetMedianSeconds() * 1000.0,
+			Result.Seconds.Num(),
+			Result.PositionHashes.Num() > 0 ? Result.PositionHashes[0] : 0,
+			Result.IsDeterministic() ? TEXT("") : TEXT(" | NOT DETERMINISTIC"));
+	}
+}
+
+bool FBAFormatterBenchmark::CheckBaseline(UEdGraph* Graph, const TArray<FBAFormatterBenchmarkResult>& Results, bool bSaveBaseline)
+{
+	if (!Graph)
+	{
+		return false;
+	}
+
+	const FString Path = BAFormatterBenchmark::GetBaselinePath();
+	const FString GraphPath = Graph->GetPathName();
+	const UEnum* StyleEnum = StaticEnum<EBAFormatAllStyle>();
+
+	// one object for every benchmarked graph, each holding its styles' medians and position hashes
+	TSharedPtr<FJsonObject> Baselines;
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *Path) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonText), Baselines) || !Baselines.IsValid())
+	{
+		Baselines = MakeShared<FJsonObject>();
+	}
+
+	const TSharedPtr<FJsonObject>* GraphBaseline = nullptr;
+	const bool bHasBaseline = Baselines->TryGetObjectField(GraphPath, GraphBaseline);
+
+	if (bSaveBaseline || !bHasBaseline)
+	{
+		TSharedRef<FJsonObject> NewBaseline = MakeShared<FJsonObject>();
+		for (const FBAFormatterBenchmarkResult& Result : Results)
+		{
+			TSharedRef<FJsonObject> StyleBaseline = MakeShared<FJsonObject>();
+			StyleBaseline->SetNumberField(TEXT("MedianMs"), Result.GetMedianSeconds() * 1000.0);
+			StyleBaseline->SetNumberField(TEXT("Positions"), Result.PositionHashes.Num() > 0 ? Result.PositionHashes[0] : 0);
+			NewBaseline->SetObjectField(StyleEnum->GetNameStringByValue(static_cast<int64>(Result.Style)), StyleBaseline);
+		}
+
+		Baselines->SetObjectField(GraphPath, NewBaseline);
+
+		FString NewJsonText;
+		FJsonSerializer::Serialize(Baselines.ToSharedRef(), TJsonWriterFactory<>::Create(&NewJsonText));
+		if (!FFileHelper::SaveStringToFile(NewJsonText, *Path))
+		{
+			UE_LOG(LogBlueprintAssist, Warning, TEXT("BenchmarkFormatAll: could not write the baseline %s"), *Path);
+			return false;
+		}
+
+		UE_LOG(LogBlueprintAssist, Log, TEXT("BenchmarkFormatAll: stored the baseline of %s in %s"), *GraphPath, *Path);
+		return true;
+	}
+
+	bool bRegressed = false;
+	for (const FBAFormatterBenchmarkResult& Result : Results)
+	{
+		const FString StyleName = StyleEnum->GetNameStringByValue(static_cast<int64>(Result.Style));
+
+		const TSharedPtr<FJsonObject>* StyleBaseline = nullptr;
+		if (!(*GraphBaseline)->TryGetObjectField(StyleName, StyleBaseline))
+		{
+			continue;
+		}
+
+		const double MedianMs = Result.GetMedianSeconds() * 1000.0;
+		const double BaselineMs = (*StyleBaseline)->GetNumberField(TEXT("MedianMs"));
+		if (MedianMs > BaselineMs * (1.0 + BAFormatterBenchmark::BaselineTolerance))
+		{
+			UE_LOG(LogBlueprintAssist, Warning, TEXT("BenchmarkFormatAll: %s got slower, median %.3f ms against %.3f ms in the baseline"), *StyleName, MedianMs, BaselineMs);
+			bRegressed = true;
+		}
+
+		// json numbers are doubles, which hold a 32 bit hash exactly
+		const uint32 BaselinePositions = static_cast<uint32>((*StyleBaseline)->GetNumberField(TEXT("Positions")));
+		if (Result.PositionHashes.Num() > 0 && Result.PositionHashes[0] != BaselinePositions)
+		{
+			UE_LOG(LogBlueprintAssist, Warning, TEXT("BenchmarkFormatAll: %s ended on different positions than the baseline (%08x against %08x)"), *StyleName, Result.PositionHashes[0], BaselinePositions);
+			bRegressed = true;
+		}
+	}
+
+	if (!bRegressed)
+	{
+		UE_LOG(LogBlueprintAssist, Log, TEXT("BenchmarkFormatAll: within %.0f%% of the baseline"), BAFormatterBenchmark::BaselineTolerance * 100.0);
+	}
+
+	return !bRegressed;
+}
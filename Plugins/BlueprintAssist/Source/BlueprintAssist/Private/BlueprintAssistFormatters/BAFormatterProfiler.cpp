@@ -0,0 +1,166 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistFormatters/BAFormatterProfiler.h"
+
+#include "BlueprintAssistUtils.h"
+#include "EdGraph/EdGraph.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/LazySingleton.h"
+#include "Misc/Paths.h"
+
+int32 FBAFormatterPhaseScope::PhaseDepth[static_cast<int32>(EBAFormatterPhase::Num)] = {};
+
+FBAFormatterProfiler& FBAFormatterProfiler::Get()
+{
+	return TLazySingleton<FBAFormatterProfiler>::Get();
+}
+
+void FBAFormatterProfiler::TearDown()
+{
+	TLazySingleton<FBAFormatterProfiler>::TearDown();
+}
+
+void FBAFormatterProfiler::BeginRun(UEdGraph* Graph, UEdGraphNode* RootNode)
+{
+	// format all runs its formatters from inside another format, keep timing the outer run
+	if (ActiveRunDepth++ > 0)
+	{
+		return;
+	}
+
+	ActiveRun = MakeShared<FBAFormatterRun>();
+	ActiveRun->Time = FDateTime::Now();
+	ActiveRun->GraphName = Graph ? Graph->GetName() : FString("None");
+	ActiveRun->RootNodeName = RootNode ? FBAUtils::GetNodeName(RootNode) : FString("None");
+	ActiveRun->PhaseSeconds[static_cast<int32>(EBAFormatterPhase::NodeSize)] = PendingNodeSizeSeconds;
+	PendingNodeSizeSeconds = 0.0;
+
+	ActiveRunStartMemory = FPlatformMemory::GetStats().UsedPhysical;
+	ActiveRunStartTime = FPlatformTime::Seconds();
+}
+
+void FBAFormatterProfiler::EndRun(int32 NumNodes)
+{
+	if (ActiveRunDepth == 0 || --ActiveRunDepth > 0)
+	{
+		return;
+	}
+
+	ActiveRun->TotalSeconds = FPlatformTime::Seconds() - ActiveRunStartTime;
+	ActiveRun->MemoryDelta = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(ActiveRunStartMemory);
+	ActiveRun->NumNodes = NumNodes;
+
+	Runs.Insert(ActiveRun, 0);
+	if (Runs.Num() > MaxRuns)
+	{
+		Runs.SetNum(MaxRuns);
+	}
+
+	ActiveRun.Reset();
+}
+
+void FBAFormatterProfiler::AddPhaseTime(EBAFormatterPhase Phase, double Seconds)
+{
+	if (ActiveRun.IsValid())
+	{
+		ActiveRun->PhaseSeconds[static_cast<int32>(Phase)] += Seconds;
+	}
+	else if (Phase == EBAFormatterPhase::NodeSize)
+	{
+		PendingNodeSizeSeconds += Seconds;
+	}
+}
+
+void FBAFormatterProfiler::ClearRuns()
+{
+	Runs.Reset();
+	PendingNodeSizeSeconds = 0.0;
+}
+
+FString FBAFormatterProfiler::MakeCSV() const
+{
+	FString CSV = TEXT("Time,Graph,Root Node,Nodes,Total (ms)");
+	for (int32 i = 0; i < static_cast<int32>(EBAFormatterPhase::Num); ++i)
+	{
+		CSV += FString::Printf(TEXT(",%s (ms)"), *GetPhaseName(static_cast<EBAFormatterPhase>(i)));
+	}
+	CSV += TEXT(",Memory Delta (KB)\n");
+
+	const auto Escape = [](const FString& Value)
+	{
+		return FString::Printf(TEXT("\"%s\""), *Value.Replace(TEXT("\""), TEXT("\"\"")));
+	};
+
+	// oldest first reads better in a spreadsheet
+	for (int32 RunIndex = Runs.Num() - 1; RunIndex >= 0; --RunIndex)
+	{
+		const FBAFormatterRun& Run = *Runs[RunIndex];
+		CSV += FString::Printf(TEXT("%s,%s,%s,%d,%.3f"),
+			*Run.Time.ToString(),
+			*Escape(Run.GraphName),
+			*Escape(Run.RootNodeName),
+			Run.NumNodes,
+			Run.TotalSeconds * 1000.0);
+
+		for (double Seconds : Run.PhaseSeconds)
+		{
+			CSV += FString::Printf(TEXT(",%.3f"), Seconds * 1000.0);
+		}
+
+		CSV += FString::Printf(TEXT(",%lld\n"), Run.MemoryDelta / 1024);
+	}
+
+	return CSV;
+}
+
+FString FBAFormatterProfiler::ExportCSV() const
+{
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("BlueprintAssist") / FString::Printf(TEXT("FormatterRuns-%s.csv"), *FDateTime::Now().ToString());
+	if (!FFileHelper::SaveStringToFile(MakeCSV(), *Path))
+	{
+		return FString();
+	}
+
+	return FPaths::ConvertRelativePathToFull(Path);
+}
+
+FString FBAFormatterProfiler::GetPhaseName(EBAFormatterPhase Phase)
+{
+	switch (Phase)
+	{
+		case EBAFormatterPhase::NodeSize:
+			return TEXT("Node Size");
+		case EBAFormatterPhase::FormatX:
+			return TEXT("Format X");
+		case EBAFormatterPhase::FormatY:
+			return TEXT("Format Y");
+		case EBAFormatterPhase::Parameters:
+			return TEXT("Parameters");
+		case EBAFormatterPhase::KnotTracks:
+			return TEXT("Knot Tracks");
+		case EBAFormatterPhase::CommentTree:
+			return TEXT("Comment Tree");
+		case EBAFormatterPhase::CommentPadding:
+			return TEXT("Comment Padding");
+		default:
+			return TEXT("Unknown");
+	}
+}
+
+FBAFormatterPhaseScope::FBAFormatterPhaseScope(EBAFormatterPhase InPhase)
+	: Phase(InPhase)
+	, StartTime(FPlatformTime::Seconds())
+{
+	bOutermost = PhaseDepth[static_cast<int32>(Phase)]++ == 0;
+}
+
+FBAFormatterPhaseScope::~FBAFormatterPhaseScope()
+{
+	--PhaseDepth[static_cast<int32>(Phase)];
+
+	if (bOutermost)
+	{
+		FBAFormatterProfiler::Get().AddPhaseTime(Phase, FPlatformTime::Seconds() - StartTime);
+	}
+}
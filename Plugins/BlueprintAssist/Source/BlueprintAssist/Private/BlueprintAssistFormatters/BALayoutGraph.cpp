@@ -0,0 +1,41 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistFormatters/BALayoutGraph.h"
+
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
+
+int32 FBALayoutGraph::FindNode(const UEdGraphNode* Node) const
+{
+	// knots are deleted and made during a pass, a new node can land on the address of a deleted one
+	const int32* Found = NodeIndices.Find(Node);
+	return Found && NodeGuids[*Found] == Node->NodeGuid ? *Found : INDEX_NONE;
+}
+
+int32 FBALayoutGraph::AddNode(const UEdGraphNode* Node, const FVector2D& Size, const FVector2D& CommentBubbleSize)
+{
+	const int32 NodeIndex = NodeSizes.Add(Size);
+	NodeGuids.Add(Node->NodeGuid);
+	CommentBubbleSizes.Add(CommentBubbleSize);
+	NodeIndices.Add(Node, NodeIndex);
+	return NodeIndex;
+}
+
+bool FBALayoutGraph::FindPinOffset(const UEdGraphPin* Pin, float& OutOffset) const
+{
+	const int32* Found = PinIndices.Find(Pin);
+	if (Found && PinIds[*Found] == Pin->PinId)
+	{
+		OutOffset = PinOffsets[*Found];
+		return true;
+	}
+
+	return false;
+}
+
+void FBALayoutGraph::AddPinOffset(const UEdGraphPin* Pin, float Offset)
+{
+	const int32 PinIndex = PinOffsets.Add(Offset);
+	PinIds.Add(Pin->PinId);
+	PinIndices.Add(Pin, PinIndex);
+}
@@ -0,0 +1,130 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistFormatters/BANodeBoundsGrid.h"
+
+#include "BlueprintAssistGraphHandler.h"
+#include "BlueprintAssistUtils.h"
+
+void FBANodeBoundsGrid::Build(TSharedPtr<FBAGraphHandler> GraphHandler, const TSet<UEdGraphNode*>& Nodes)
+{
+	Reset();
+
+	Entries.Reserve(Nodes.Num());
+	for (UEdGraphNode* Node : Nodes)
+	{
+		const int32 EntryIndex = Entries.Add({ Node, FBAUtils::GetCachedNodeBounds(GraphHandler, Node) });
+		const FSlateRect& Bounds = Entries[EntryIndex].Bounds;
+
+		const FIntPoint MinCell = GetCell(Bounds.GetTopLeft());
+		const FIntPoint MaxCell = GetCell(Bounds.GetBottomRight());
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				Cells.FindOrAdd(FIntPoint(X, Y)).Add(EntryIndex);
+			}
+		}
+	}
+
+	EntryQueryIds.SetNumZeroed(Entries.Num());
+}
+
+void FBANodeBoundsGrid::Reset()
+{
+	Entries.Reset();
+	Cells.Reset();
+	EntryQueryIds.Reset();
+	QueryId = 0;
+}
+
+void FBANodeBoundsGrid::ForEachLineIntersection(
+	const FVector2D& Start,
+	const FVector2D& End,
+	const FMargin& Padding,
+	TFunctionRef<bool(UEdGraphNode* Node, const FSlateRect& PaddedBounds)> Visitor) const
+{
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	// any bounds the padded line can touch overlap the line's box grown by the largest padding
+	const float MaxPadding = FMath::Max(FMath::Max(Padding.Left, Padding.Right), FMath::Max(Padding.Top, Padding.Bottom));
+	const FIntPoint MinCell = GetCell(FVector2D(FMath::Min(Start.X, End.X) - MaxPadding, FMath::Min(Start.Y, End.Y) - MaxPadding));
+	const FIntPoint MaxCell = GetCell(FVector2D(FMath::Max(Start.X, End.X) + MaxPadding, FMath::Max(Start.Y, End.Y) + MaxPadding));
+
+	TArray<int32> Candidates;
+	const int64 NumCells = static_cast<int64>(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1);
+	if (NumCells > Entries.Num())
+	{
+		// a line spanning most of the graph, walking the cells would cost more than testing every node
+		Candidates.Reserve(Entries.Num());
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			Candidates.Add(EntryIndex);
+		}
+	}
+	else
+	{
+		++QueryId;
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				if (const TArray<int32>* CellEntries = Cells.Find(FIntPoint(X, Y)))
+				{
+					for (int32 EntryIndex : *CellEntries)
+					{
+						if (EntryQueryIds[EntryIndex] != QueryId)
+						{
+							EntryQueryIds[EntryIndex] = QueryId;
+							Candidates.Add(EntryIndex);
+						}
+					}
+				}
+			}
+		}
+
+		// callers like the knot track height search depend on the order the nodes are visited
+		Candidates.Sort();
+	}
+
+	for (int32 EntryIndex : Candidates)
+	{
+		const FEntry& Entry = Entries[EntryIndex];
+		const FSlateRect PaddedBounds = Entry.Bounds.ExtendBy(Padding);
+		if (FBAUtils::LineRectIntersection(PaddedBounds, Start, End))
+		{
+			if (!Visitor(Entry.Node, PaddedBounds))
+			{
+				return;
+			}
+		}
+	}
+}
+
+bool FBANodeBoundsGrid::AnyLineIntersection(
+	const FVector2D& Start,
+	const FVector2D& End,
+	const FMargin& Padding,
+	TFunctionRef<bool(UEdGraphNode* Node)> IsIgnored) const
+{
+	bool bAnyIntersection = false;
+	ForEachLineIntersection(Start, End, Padding, [&](UEdGraphNode* Node, const FSlateRect&)
+	{
+		if (IsIgnored(Node))
+		{
+			return true;
+		}
+
+		bAnyIntersection = true;
+		return false;
+	});
+
+	return bAnyIntersection;
+}
+
+FIntPoint FBANodeBoundsGrid::GetCell(const FVector2D& Point) const
+{
+	return FIntPoint(FMath::FloorToInt(Point.X / CellSize), FMath::FloorToInt(Point.Y / CellSize));
+}
@@ -0,0 +1,176 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistFormatters/BANodeReachability.h"
+
+void FBANodeReachability::Build(const TArray<UEdGraphNode*>& InitialNodes, TFunctionRef<TArray<UEdGraphNode*>(UEdGraphNode*)> GetLinkedNodes)
+{
+	Reset();
+
+	TArray<UEdGraphNode*> Nodes;
+	const auto AddNode = [this, &Nodes](UEdGraphNode* Node)
+	{
+		if (const int32* Found = NodeIndices.Find(Node))
+		{
+			return *Found;
+		}
+
+		const int32 NodeIndex = Nodes.Add(Node);
+		NodeIndices.Add(Node, NodeIndex);
+		return NodeIndex;
+	};
+
+	for (UEdGraphNode* Node : InitialNodes)
+	{
+		AddNode(Node);
+	}
+
+	// nodes found through the links are appended, so this walks everything reachable from the initial nodes
+	TArray<TArray<int32>> Links;
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		TArray<int32> NodeLinks;
+		for (UEdGraphNode* LinkedNode : GetLinkedNodes(Nodes[NodeIndex]))
+		{
+			NodeLinks.Add(AddNode(LinkedNode));
+		}
+
+		Links.Add(MoveTemp(NodeLinks));
+	}
+
+	// find the cycles (tarjan), a cycle is only finished once every cycle it links to has been
+	const int32 NumNodes = Nodes.Num();
+	TArray<int32> VisitOrder;
+	VisitOrder.Init(INDEX_NONE, NumNodes);
+	TArray<int32> LowestReachableOrder;
+	LowestReachableOrder.Init(INDEX_NONE, NumNodes);
+	TArray<bool> IsOnStack;
+	IsOnStack.Init(false, NumNodes);
+	NodeComponents.Init(INDEX_NONE, NumNodes);
+
+	struct FVisit
+	{
+		int32 Node;
+		int32 NextLink;
+	};
+
+	TArray<int32> OpenNodes;
+	TArray<FVisit> VisitStack;
+	int32 NextVisitOrder = 0;
+	int32 NumComponents = 0;
+
+	const auto StartVisit = [&](int32 Node)
+	{
+		VisitOrder[Node] = NextVisitOrder;
+		LowestReachableOrder[Node] = NextVisitOrder;
+		++NextVisitOrder;
+
+		OpenNodes.Add(Node);
+		IsOnStack[Node] = true;
+		VisitStack.Add({ Node, 0 });
+	};
+
+	for (int32 StartNode = 0; StartNode < NumNodes; ++StartNode)
+	{
+		if (VisitOrder[StartNode] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		StartVisit(StartNode);
+
+		while (VisitStack.Num() > 0)
+		{
+			const int32 Node = VisitStack.Last().Node;
+			const int32 LinkIndex = VisitStack.Last().NextLink++;
+
+			if (Links[Node].IsValidIndex(LinkIndex))
+			{
+				const int32 LinkedNode = Links[Node][LinkIndex];
+				if (VisitOrder[LinkedNode] == INDEX_NONE)
+				{
+					StartVisit(LinkedNode);
+				}
+				else if (IsOnStack[LinkedNode])
+				{
+					LowestReachableOrder[Node] = FMath::Min(LowestReachableOrder[Node], VisitOrder[LinkedNode]);
+				}
+
+				continue;
+			}
+
+			// every link has been visited, close the cycle if this node started it
+			if (LowestReachableOrder[Node] == VisitOrder[Node])
+			{
+				int32 CycleNode;
+				do
+				{
+					CycleNode = OpenNodes.Pop(false);
+					IsOnStack[CycleNode] = false;
+					NodeComponents[CycleNode] = NumComponents;
+				}
+				while (CycleNode != Node);
+
+				++NumComponents;
+			}
+
+			VisitStack.Pop(false);
+			if (VisitStack.Num() > 0)
+			{
+				const int32 ParentNode = VisitStack.Last().Node;
+				LowestReachableOrder[ParentNode] = FMath::Min(LowestReachableOrder[ParentNode], LowestReachableOrder[Node]);
+			}
+		}
+	}
+
+	TArray<TArray<int32>> ComponentNodes;
+	ComponentNodes.SetNum(NumComponents);
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		ComponentNodes[NodeComponents[Node]].Add(Node);
+	}
+
+	// linked cycles are numbered lower, so they are complete by the time a cycle takes them in
+	ComponentReach.SetNum(NumComponents);
+	for (int32 Component = 0; Component < NumComponents; ++Component)
+	{
+		TBitArray<>& Reach = ComponentReach[Component];
+		Reach.Init(false, NumComponents);
+		Reach[Component] = true;
+
+		for (int32 Node : ComponentNodes[Component])
+		{
+			for (int32 LinkedNode : Links[Node])
+			{
+				const int32 LinkedComponent = NodeComponents[LinkedNode];
+				if (LinkedComponent != Component && !Reach[LinkedComponent])
+				{
+					Reach.CombineWithBitwiseOR(ComponentReach[LinkedComponent], EBitwiseOperatorFlags::MaintainSize);
+				}
+			}
+		}
+	}
+}
+
+void FBANodeReachability::Reset()
+{
+	NodeIndices.Reset();
+	NodeComponents.Reset();
+	ComponentReach.Reset();
+}
+
+bool FBANodeReachability::CanReach(UEdGraphNode* From, UEdGraphNode* To) const
+{
+	if (From == To)
+	{
+		return true;
+	}
+
+	const int32* FromIndex = NodeIndices.Find(From);
+	const int32* ToIndex = NodeIndices.Find(To);
+	if (!FromIndex || !ToIndex)
+	{
+		return false;
+	}
+
+	return ComponentReach[NodeComponents[*FromIndex]][NodeComponents[*ToIndex]];
+}
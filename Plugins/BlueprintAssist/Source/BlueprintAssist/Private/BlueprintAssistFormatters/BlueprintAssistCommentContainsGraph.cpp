@@ -125,20 +125,24 @@ void FBACommentContainsGraph::BuildCommentTree()
 		}
 	}
 
+	// start from each pending node in sorted order, skipping the ones an earlier node reached
 	{
 		TSet<TSharedPtr<FBACommentContainsNode>> PendingNodes(SortedCommentNodes);
-		while (PendingNodes.Num())
+		for (TSharedPtr<FBACommentContainsNode> SortedNode : SortedCommentNodes)
 		{
-			AssignParentsAndChildren(PendingNodes.Array()[0], PendingNodes);
+			AssignParentsAndChildren(SortedNode, PendingNodes);
 		}
 	}
 
 	{
 		TSet<TSharedPtr<FBACommentContainsNode>> PendingNodes(SortedCommentNodes);
-		while (PendingNodes.Num())
+		for (TSharedPtr<FBACommentContainsNode> SortedNode : SortedCommentNodes)
 		{
-			TSet<UEdGraphNode*> Visited;
-			AssignOwnedNodes(PendingNodes.Array()[0], PendingNodes, Visited);
+			if (PendingNodes.Contains(SortedNode))
+			{
+				TSet<UEdGraphNode*> Visited;
+				AssignOwnedNodes(SortedNode, PendingNodes, Visited);
+			}
 		}
 	}
 
@@ -432,11 +436,14 @@ TSharedPtr<FBACommentContainsGraph> FBACommentContainsGraph::BuildSubsetGraph(co
 	}
 
 	// assign parents and children for new graph
-	TArray<TSharedPtr<FBACommentContainsNode>> PendingNodes = SortedCommentNodes;
-	while (PendingNodes.Num())
+	FContainsNodeSet PendingNodes(SortedCommentNodes);
+	for (TSharedPtr<FBACommentContainsNode> SortedNode : SortedCommentNodes)
 	{
-		FContainsNodeSet Visited;
-		AssignSubsetParentsAndChildren(PendingNodes[0], nullptr, PendingNodes, SubsetGraph, Visited);
+		if (PendingNodes.Contains(SortedNode))
+		{
+			FContainsNodeSet Visited;
+			AssignSubsetParentsAndChildren(SortedNode, nullptr, PendingNodes, SubsetGraph, Visited);
+		}
 	}
 
 	// init node containing map
@@ -471,7 +478,7 @@ TSet<UEdGraphNode_Comment*> FBACommentContainsGraph::GetContainingCommentsForNod
 void FBACommentContainsGraph::AssignSubsetParentsAndChildren(
 	TSharedPtr<FBACommentContainsNode> CurrentNode,
 	TSharedPtr<FBACommentContainsNode> LastValidParent,
-	TArray<TSharedPtr<FBACommentContainsNode>>& PendingNodes,
+	FContainsNodeSet& PendingNodes,
 	TSharedPtr<FBACommentContainsGraph> SubsetGraph,
 	FContainsNodeSet& VisitedNodes)
 {
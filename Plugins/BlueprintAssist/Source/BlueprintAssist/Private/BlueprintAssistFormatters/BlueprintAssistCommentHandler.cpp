@@ -7,6 +7,7 @@
 #include "BlueprintAssistStats.h"
 #include "BlueprintAssistUtils.h"
 #include "EdGraphNode_Comment.h"
+#include "BlueprintAssistFormatters/BAFormatterProfiler.h"
 #include "BlueprintAssistFormatters/FormatterInterface.h"
 #include "BlueprintAssistWidgets/BlueprintAssistGraphOverlay.h"
 
@@ -30,6 +31,7 @@ void FCommentHandler::Init(TSharedPtr<FBAGraphHandler> InGraphHandler, TSharedPt
 void FCommentHandler::BuildTree()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FCommentHandler::BuildTree"), STAT_CommentHandler_BuildTree, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::CommentTree);
 
 	if (!MasterContainsGraph)
 	{
@@ -83,6 +85,20 @@ void FCommentHandler::BuildTree()
 		}
 
 		// remove intersecting comments
+		// only comments sharing a node can intersect, find them through the master graph's node containing map
+		TMap<UEdGraphNode_Comment*, int32> CommentIndices;
+		CommentIndices.Reserve(CommentNodes.Num());
+		for (int i = 0; i < CommentNodes.Num(); ++i)
+		{
+			CommentIndices.Add(CommentNodes[i], i);
+		}
+
+		const auto DoesContainComment = [&](TSharedPtr<FBACommentContainsNode> ContainsNode, UEdGraphNode_Comment* Comment)
+		{
+			const FBACommentContainsGraph::FContainsNodeArray* Containing = MasterContainsGraph->NodeContainingMap.Find(Comment);
+			return Containing && Containing->Contains(ContainsNode);
+		};
+
 		TSet<UEdGraphNode_Comment*> IntersectingComments;
 		for (int i = 0; i < CommentNodes.Num(); ++i)
 		{
@@ -93,36 +109,31 @@ void FCommentHandler::BuildTree()
 
 			TSharedPtr<FBACommentContainsNode> ContainsA = MasterContainsGraph->GetNode(CommentNodes[i]);
 
-			for (int j = i + 1; j < CommentNodes.Num(); ++j)
+			for (UEdGraphNode* Node : ContainsA->AllContainedNodes)
 			{
-				if (IntersectingComments.Contains(CommentNodes[j]))
-				{
-					continue;
-				}
-
-				TSharedPtr<FBACommentContainsNode> ContainsB = MasterContainsGraph->GetNode(CommentNodes[j]);
-
-				// if the comment
-				if (ContainsA->AllContainedNodesWithComments.Contains(ContainsB->Comment))
+				const FBACommentContainsGraph::FContainsNodeArray* ContainingNode = MasterContainsGraph->NodeContainingMap.Find(Node);
+				if (!ContainingNode)
 				{
 					continue;
 				}
 
-				// if the comment contain each other continue
-				if (ContainsB->AllContainedNodesWithComments.Contains(ContainsA->Comment))
-				{
-					continue;
-				}
-
-				bool bAreIntersecting = ContainsA->AllContainedNodes.ContainsByPredicate([&ContainsB](UEdGraphNode* Node)
-				{
-					return ContainsB->AllContainedNodes.Contains(Node);
-				});
-
-				if (bAreIntersecting)
+				for (TSharedPtr<FBACommentContainsNode> ContainsB : *ContainingNode)
 				{
-					IntersectingComments.Add(CommentNodes[j]);
-					// UE_LOG(LogTemp, Warning, TEXT("INTERSECTING COMMENTS %s %s"), *FBAUtils::GetNodeName(CommentNodes[i]), *FBAUtils::GetNodeName(CommentNodes[j]));
+					// only check the comments after this one, like comparing each pair once
+					const int32* IndexB = CommentIndices.Find(ContainsB->Comment);
+					if (!IndexB || *IndexB <= i || IntersectingComments.Contains(ContainsB->Comment))
+					{
+						continue;
+					}
+
+					// if the comment contain each other continue
+					if (DoesContainComment(ContainsA, ContainsB->Comment) || DoesContainComment(ContainsB, ContainsA->Comment))
+					{
+						continue;
+					}
+
+					IntersectingComments.Add(ContainsB->Comment);
+					// UE_LOG(LogTemp, Warning, TEXT("INTERSECTING COMMENTS %s %s"), *FBAUtils::GetNodeName(CommentNodes[i]), *FBAUtils::GetNodeName(ContainsB->Comment));
 				}
 			}
 		}
@@ -11,6 +11,8 @@
 #include "SGraphNodeComment.h"
 #include "SGraphPanel.h"
 #include "Algo/Transform.h"
+#include "BlueprintAssistFormatters/BAFormatterProfiler.h"
+#include "BlueprintAssistFormatters/BANodeReachability.h"
 #include "BlueprintAssistFormatters/BlueprintAssistCommentContainsGraph.h"
 #include "BlueprintAssistFormatters/EdGraphParameterFormatter.h"
 #include "BlueprintAssistFormatters/GraphFormatterTypes.h"
@@ -96,18 +98,23 @@ bool FNodeChangeInfo::HasChanged(UEdGraphNode* NodeToKeepStill, FCommentHandler*
 		return true;
 	}
 
-	TSet<FGuid> NewContainingComments;
-	for (UEdGraphNode_Comment* Comment : CommentHandler->ContainsGraph->GetContainingCommentsForNode(Node.Get()))
+	return HaveContainingCommentsChanged(CommentHandler);
+}
+
+bool FNodeChangeInfo::HaveContainingCommentsChanged(FCommentHandler* CommentHandler)
+{
+	if (!Node.IsValid())
 	{
-		NewContainingComments.Add(Comment->NodeGuid);
+		return false;
 	}
 
-	if (NewContainingComments.Difference(ContainingComments).Num())
+	TSet<FGuid> NewContainingComments;
+	for (UEdGraphNode_Comment* Comment : CommentHandler->ContainsGraph->GetContainingCommentsForNode(Node.Get()))
 	{
-		return true;
+		NewContainingComments.Add(Comment->NodeGuid);
 	}
 
-	return false;
+	return NewContainingComments.Difference(ContainingComments).Num() > 0;
 }
 
 FString ChildBranch::ToString() const
@@ -169,6 +176,9 @@ void FEdGraphFormatter::FormatNode(UEdGraphNode* InitialNode)
 		return;
 	}
 
+	// the whole tree is laid out again, but parameter branches which have not changed keep their last layout
+	CollectReusableParameterFormatters();
+
 	KnotTrackCreator.Reset();
 	CommentHandler.Reset();
 	NodeChangeInfos.Reset();
@@ -490,6 +500,7 @@ void FEdGraphFormatter::SimpleRelativeFormatting()
 void FEdGraphFormatter::FormatX(const bool bUseParameter)
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphFormatter::FormatX"), STAT_EdGraphFormatter_FormatX, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::FormatX);
 	UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("========== FORMAT X =========="));
 	const FPinLink RootNodeLink(nullptr, nullptr, RootNode);
 
@@ -914,6 +925,9 @@ TArray<FPinLink> FEdGraphFormatter::GetNodesToExpand()
 	TArray<FPinLink> InputStack;
 	OutputStack.Push(RootInfo);
 
+	// answers whether an input node executes back into the current node, built on the first check
+	FBANodeReachability InputExecReachability;
+
 	EEdGraphPinDirection LastDirection = EGPD_Output;
 
 	while (OutputStack.Num() > 0 || InputStack.Num() > 0)
@@ -972,7 +986,15 @@ TArray<FPinLink> FEdGraphFormatter::GetNodesToExpand()
 				{
 					if (UBASettings::Get().FormattingStyle == EBANodeFormattingStyle::Expanded)
 					{
-						const bool bHasCycle = PendingNodes.Contains(LinkedNode) || FBAUtils::GetExecTree(LinkedNode, EGPD_Input).Contains(CurrentInfo.GetNode());
+						if (!InputExecReachability.IsBuilt())
+						{
+							InputExecReachability.Build(NodePool, [](UEdGraphNode* Node)
+							{
+								return FBAUtils::GetLinkedNodesFromPins(FBAUtils::GetExecPins(Node, EGPD_Input));
+							});
+						}
+
+						const bool bHasCycle = PendingNodes.Contains(LinkedNode) || InputExecReachability.CanReach(LinkedNode, CurrentInfo.GetNode());
 						if (!bHasCycle)
 						{
 							if (CurrentInfo.GetDirection() == EGPD_Output)
@@ -1107,12 +1129,50 @@ void FEdGraphFormatter::ExpandNodesAheadOfParameters()
 	}
 }
 
-void FEdGraphFormatter::FormatY_Recursive(
-	const FPinLink& CurrentLink,
-	TSet<UEdGraphNode*>& NodesToCollisionCheck,
-	TSet<FPinLink>& VisitedLinks,
-	const bool bSameRow,
-	TSet<UEdGraphNode*>& Children)
+struct FEdGraphFormatter::FFormatYFrame
+{
+	FPinLink Link;
+	bool bSameRow = false;
+
+	// the nodes of this node's branch, handed to the parent frame once it is done
+	TSet<UEdGraphNode*> Children;
+
+	bool bFirstPin = true;
+	bool bCenteredParent = false;
+
+	// 0 for the parent link's direction, 1 for the other one
+	int32 DirectionIndex = 0;
+
+	// INDEX_NONE until the pins of the current direction are gathered
+	int32 LinkIndex = INDEX_NONE;
+	TArray<UEdGraphPin*> AllPins;
+	TArray<FPinLink> PinLinks;
+	UEdGraphPin* LastLinked = nullptr;
+	UEdGraphPin* LastProcessed = nullptr;
+	TArray<ChildBranch> ChildBranches;
+
+	// whether PinLinks[LinkIndex], whose branch the frame above formats, is on this node's row
+	bool bChildIsSameRow = false;
+
+	void Reset(const FPinLink& InLink, bool bInSameRow)
+	{
+		Link = InLink;
+		bSameRow = bInSameRow;
+		Children.Reset();
+		bFirstPin = true;
+		bCenteredParent = false;
+		DirectionIndex = 0;
+		LinkIndex = INDEX_NONE;
+		AllPins.Reset();
+		PinLinks.Reset();
+		LastLinked = nullptr;
+		LastProcessed = nullptr;
+		ChildBranches.Reset();
+		bChildIsSameRow = false;
+	}
+};
+
+void FEdGraphFormatter::FormatY_EnterNode(FFormatYFrame& Frame, TSet<UEdGraphNode*>& NodesToCollisionCheck)
 {
 	// const FString NodeNameA = CurrentNode == nullptr
 	// 	? FString("nullptr")
@@ -1127,6 +1187,7 @@ void FEdGraphFormatter::FormatY_Recursive(
 	//        *NodeNameA, *PinNameA,
 	//        *NodeNameB, *PinNameB);
 
+	const FPinLink& CurrentLink = Frame.Link;
 	UEdGraphNode* CurrentNode = CurrentLink.GetNode();
 	// GraphHandler->GetGraphOverlay()->DrawNodeInQueue(CurrentNode);
 
@@ -1191,37 +1252,41 @@ void FEdGraphFormatter::FormatY_Recursive(
 	}
 
 	NodesToCollisionCheck.Emplace(CurrentNode);
+}
 
+bool FEdGraphFormatter::FormatY_NextChild(FFormatYFrame& Frame, TSet<UEdGraphNode*>& NodesToCollisionCheck, TSet<FPinLink>& VisitedLinks)
+{
+	const FPinLink& CurrentLink = Frame.Link;
+	UEdGraphNode* CurrentNode = CurrentLink.GetNode();
 	const EEdGraphPinDirection ParentDirection = CurrentLink.GetDirection();
 
-	bool bFirstPin = true;
-
-	UEdGraphPin* MainPin = CurrentLink.To;
-
-	bool bCenteredParent = false;
-
-	TArray<EEdGraphPinDirection> Directions = { ParentDirection, UEdGraphPin::GetComplementaryDirection(ParentDirection) };
-	for (EEdGraphPinDirection CurrentDirection : Directions)
+	while (Frame.DirectionIndex < 2)
 	{
-		TArray<UEdGraphPin*> AllPins = FBAUtils::GetPinsByDirection(CurrentNode, CurrentDirection);
-		AllPins.StableSort([&GraphHandler = GraphHandler](const UEdGraphPin& A, const UEdGraphPin& B)
-		{
-			return GraphHandler->GetPinY(&A) < GraphHandler->GetPinY(&B);
-		});
+		const EEdGraphPinDirection CurrentDirection = Frame.DirectionIndex == 0 ? ParentDirection : UEdGraphPin::GetComplementaryDirection(ParentDirection);
 
-		TArray<FPinLink> PinLinks = FBAUtils::GetPinLinks(CurrentNode, CurrentDirection);
-		PinLinks.StableSort([&GraphHandler = GraphHandler](const FPinLink& A, const FPinLink& B)
+		if (Frame.LinkIndex == INDEX_NONE)
 		{
-			return GraphHandler->GetPinY(A.From) < GraphHandler->GetPinY(B.From);
-		});
+			Frame.AllPins = FBAUtils::GetPinsByDirection(CurrentNode, CurrentDirection);
+			Frame.AllPins.StableSort([&GraphHandler = GraphHandler](const UEdGraphPin& A, const UEdGraphPin& B)
+			{
+				return GraphHandler->GetPinY(&A) < GraphHandler->GetPinY(&B);
+			});
 
-		UEdGraphPin* LastLinked = CurrentLink.To;
-		UEdGraphPin* LastProcessed = nullptr;
+			Frame.PinLinks = FBAUtils::GetPinLinks(CurrentNode, CurrentDirection);
+			Frame.PinLinks.StableSort([&GraphHandler = GraphHandler](const FPinLink& A, const FPinLink& B)
+			{
+				return GraphHandler->GetPinY(A.From) < GraphHandler->GetPinY(B.From);
+			});
 
-		TArray<ChildBranch> ChildBranches;
+			Frame.LastLinked = CurrentLink.To;
+			Frame.LastProcessed = nullptr;
+			Frame.ChildBranches.Reset();
+			Frame.LinkIndex = 0;
+		}
 
-		for (FPinLink& Link : PinLinks)
+		for (; Frame.LinkIndex < Frame.PinLinks.Num(); ++Frame.LinkIndex)
 		{
+			const FPinLink& Link = Frame.PinLinks[Frame.LinkIndex];
 			UEdGraphNode* ToNode = Link.GetToNodeUnsafe();
 
 			const bool bIsSameLink = Path.Contains(Link);
@@ -1249,22 +1314,22 @@ void FEdGraphFormatter::FormatY_Recursive(
 			FBAUtils::StraightenPin(GraphHandler, Link.From, Link.To);
 
 			// bool bChildIsSameRow = false;
-			bool bChildIsSameRow = IsSameRow(Link);
+			Frame.bChildIsSameRow = IsSameRow(Link);
 
-			if (bFirstPin && (CurrentLink.From == nullptr || Link.GetDirection() == CurrentLink.GetDirection()))
+			if (Frame.bFirstPin && (CurrentLink.From == nullptr || Link.GetDirection() == CurrentLink.GetDirection()))
 			{
 				// bChildIsSameRow = true;
-				bFirstPin = false;
+				Frame.bFirstPin = false;
 				// UE_LOG(LogBlueprintAssist, Error, TEXT("\t\tNode %s is same row as %s"),
 				//        *FBAUtils::GetNodeName(OtherNode),
 				//        *FBAUtils::GetNodeName(CurrentNode));
 			}
 			else
 			{
-				if (LastProcessed != nullptr)
+				if (Frame.LastProcessed != nullptr)
 				{
 					//UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("Moved node %s to %s"), *FBAUtils::GetNodeName(OtherNode), *FBAUtils::GetNodeName(LastPinOther->GetOwningNode()));
-					int32 NewNodePosY = FMath::Max(ToNode->NodePosY, LastProcessed->GetOwningNode()->NodePosY);
+					int32 NewNodePosY = FMath::Max(ToNode->NodePosY, Frame.LastProcessed->GetOwningNode()->NodePosY);
 					NewNodePosY = FBAUtils::SnapToGrid(NewNodePosY, EBARoundingMethod::Round, 8); 
 					FBAUtils::SetNodePosY(GraphHandler, ToNode, NewNodePosY);
 				}
@@ -1272,117 +1337,138 @@ void FEdGraphFormatter::FormatY_Recursive(
 
 			RefreshParameters(ToNode);
 
-			TSet<UEdGraphNode*> LocalChildren;
-			FormatY_Recursive(Link, NodesToCollisionCheck, VisitedLinks, bChildIsSameRow, LocalChildren);
-			Children.Append(LocalChildren);
+			// the caller formats the child's branch on the next frame, then hands it back to FormatY_ChildFormatted
+			return true;
+		}
 
-			if (FormatXInfoMap[CurrentNode]->GetImmediateChildren().Contains(ToNode))
+		if (bCenterBranches && Frame.ChildBranches.Num() >= NumRequiredBranches && ParentDirection == EGPD_Output)
+		{
+			if (CurrentDirection != ParentDirection)
 			{
-				ChildBranches.Add(ChildBranch(Link.To, Link.From, LocalChildren));
+				Frame.bCenteredParent = true;
 			}
 
-			//UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("Local children for %s"), *FBAUtils::GetNodeName(CurrentNode));
-			//for (UEdGraphNode* Node : LocalChildren)
-			//{
-			//	UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("\tChild %s"), *FBAUtils::GetNodeName(Node));
-			//}
+			CenterBranches(CurrentNode, Frame.ChildBranches, NodesToCollisionCheck);
+		}
 
-			if (!bChildIsSameRow && LocalChildren.Num() > 0)
-			{
-				UEdGraphPin* PinToAvoid = nullptr;
-				if (!PinToAvoid)
-				{
-					// check *all* our pins when avoiding, not just the exec pins
-					UEdGraphPin* LastLinkedAllPin = nullptr;
+		Frame.DirectionIndex++;
+		Frame.LinkIndex = INDEX_NONE;
+	}
 
-					for (int i = 0; i < AllPins.Num(); ++i)
-					{
-						UEdGraphPin* Pin = AllPins[i];
+	return false;
+}
 
-						// avoid our incoming pin from the parent link
-						if (CurrentLink.To == Pin)
-						{
-							LastLinkedAllPin = Pin;
-						}
+void FEdGraphFormatter::FormatY_ChildFormatted(FFormatYFrame& Frame, const TSet<UEdGraphNode*>& LocalChildren)
+{
+	const FPinLink& CurrentLink = Frame.Link;
+	UEdGraphNode* CurrentNode = CurrentLink.GetNode();
+	const FPinLink& Link = Frame.PinLinks[Frame.LinkIndex];
+	UEdGraphNode* ToNode = Link.GetToNodeUnsafe();
+	UEdGraphPin* MainPin = CurrentLink.To;
 
-						// avoid the last linked that comes from the recursive iteration
-						// this is useful since it has the correct ordering
-						if (LastLinked == Pin)
-						{
-							LastLinkedAllPin = Pin;
-						}
+	Frame.Children.Append(LocalChildren);
 
-						if (Link.From == Pin)
-						{
-							if (LastLinkedAllPin)
-							{
-								PinToAvoid = LastLinkedAllPin;
-							}
+	if (FormatXInfoMap[CurrentNode]->GetImmediateChildren().Contains(ToNode))
+	{
+		Frame.ChildBranches.Add(ChildBranch(Link.To, Link.From, LocalChildren));
+	}
 
-							break;
-						}
+	//UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("Local children for %s"), *FBAUtils::GetNodeName(CurrentNode));
+	//for (UEdGraphNode* Node : LocalChildren)
+	//{
+	//	UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("\tChild %s"), *FBAUtils::GetNodeName(Node));
+	//}
 
-						if (Pin->LinkedTo.Num())
-						{
-							LastLinkedAllPin = Pin;
-						}
-					}
-				}
+	if (!Frame.bChildIsSameRow && LocalChildren.Num() > 0)
+	{
+		UEdGraphPin* PinToAvoid = nullptr;
+		if (!PinToAvoid)
+		{
+			// check *all* our pins when avoiding, not just the exec pins
+			UEdGraphPin* LastLinkedAllPin = nullptr;
+
+			for (int i = 0; i < Frame.AllPins.Num(); ++i)
+			{
+				UEdGraphPin* Pin = Frame.AllPins[i];
 
-				// also check our main pin
-				if (MainPin)
+				// avoid our incoming pin from the parent link
+				if (CurrentLink.To == Pin)
 				{
-					if (PinToAvoid)
-					{
-						if (GraphHandler->GetPinY(MainPin) > GraphHandler->GetPinY(PinToAvoid))
-						{
-							PinToAvoid = MainPin;
-						}
-					}
-					else
-					{
-						PinToAvoid = MainPin;
-					}
+					LastLinkedAllPin = Pin;
 				}
 
-				if (PinToAvoid != nullptr && !UBASettings::HasDebugSetting("SkipAvoidPin"))
+				// avoid the last linked that comes from the previous child branch
+				// this is useful since it has the correct ordering
+				if (Frame.LastLinked == Pin)
 				{
-					FSlateRect Bounds = FBAUtils::GetCachedNodeArrayBounds(GraphHandler, LocalChildren.Array());
-					const float PinPos = GraphHandler->GetPinY(PinToAvoid) + VerticalPinSpacing;
-					const float Delta = PinPos - Bounds.Top;
-
-					// GraphHandler->GetGraphOverlay()->DrawBounds(FBAUtils::GetPinBounds(GraphHandler->GetGraphPanel(), PinToAvoid), FLinearColor::Yellow, 5.0f);
-					// GraphHandler->GetGraphOverlay()->DrawBounds(FBAUtils::GetPinBounds(GraphHandler->GetGraphPanel(), Link.From), FLinearColor::Red, 5.0f);
+					LastLinkedAllPin = Pin;
+				}
 
-					if (Delta > 0)
+				if (Link.From == Pin)
+				{
+					if (LastLinkedAllPin)
 					{
-						for (UEdGraphNode* Child : LocalChildren)
-						{
-							Child->NodePosY += Delta;
-							RefreshParameters(Child);
-						}
+						PinToAvoid = LastLinkedAllPin;
 					}
+
+					break;
 				}
-			}
 
-			LastProcessed = Link.To;
-			LastLinked = Link.From;
+				if (Pin->LinkedTo.Num())
+				{
+					LastLinkedAllPin = Pin;
+				}
+			}
 		}
 
-		if (bCenterBranches && ChildBranches.Num() >= NumRequiredBranches && ParentDirection == EGPD_Output)
+		// also check our main pin
+		if (MainPin)
 		{
-			if (CurrentDirection != ParentDirection)
+			if (PinToAvoid)
+			{
+				if (GraphHandler->GetPinY(MainPin) > GraphHandler->GetPinY(PinToAvoid))
+				{
+					PinToAvoid = MainPin;
+				}
+			}
+			else
 			{
-				bCenteredParent = true;
+				PinToAvoid = MainPin;
 			}
+		}
 
-			CenterBranches(CurrentNode, ChildBranches, NodesToCollisionCheck);
+		if (PinToAvoid != nullptr && !UBASettings::HasDebugSetting("SkipAvoidPin"))
+		{
+			FSlateRect Bounds = FBAUtils::GetCachedNodeArrayBounds(GraphHandler, LocalChildren.Array());
+			const float PinPos = GraphHandler->GetPinY(PinToAvoid) + VerticalPinSpacing;
+			const float Delta = PinPos - Bounds.Top;
+
+			// GraphHandler->GetGraphOverlay()->DrawBounds(FBAUtils::GetPinBounds(GraphHandler->GetGraphPanel(), PinToAvoid), FLinearColor::Yellow, 5.0f);
+			// GraphHandler->GetGraphOverlay()->DrawBounds(FBAUtils::GetPinBounds(GraphHandler->GetGraphPanel(), Link.From), FLinearColor::Red, 5.0f);
+
+			if (Delta > 0)
+			{
+				for (UEdGraphNode* Child : LocalChildren)
+				{
+					Child->NodePosY += Delta;
+					RefreshParameters(Child);
+				}
+			}
 		}
 	}
 
-	Children.Add(CurrentNode);
+	Frame.LastProcessed = Link.To;
+	Frame.LastLinked = Link.From;
+	++Frame.LinkIndex;
+}
+
+void FEdGraphFormatter::FormatY_ExitNode(FFormatYFrame& Frame)
+{
+	const FPinLink& CurrentLink = Frame.Link;
+
+	Frame.Children.Add(CurrentLink.GetNode());
 
-	if (bSameRow && CurrentLink.From != nullptr && !bCenteredParent)
+	if (Frame.bSameRow && CurrentLink.From != nullptr && !Frame.bCenteredParent)
 	{
 		// UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("\t\t\tStraightening pin from %s to %s"),
 		//        *FBAUtils::GetPinName(CurrentPin),
@@ -1393,19 +1479,42 @@ void FEdGraphFormatter::FormatY_Recursive(
 	}
 }
 
-void FEdGraphFormatter::GetPinsOfSameHeight_Recursive(
-	UEdGraphNode* CurrentNode,
-	UEdGraphPin* CurrentPin,
-	UEdGraphPin* ParentPin,
-	TSet<UEdGraphNode*>& NodesToCollisionCheck,
-	TSet<FPinLink>& VisitedLinks)
+struct FEdGraphFormatter::FSameHeightFrame
 {
-	NodesToCollisionCheck.Emplace(CurrentNode);
+	UEdGraphNode* Node = nullptr;
+	UEdGraphPin* ParentPin = nullptr;
+	bool bFirstPin = true;
 
-	TArray<TArray<UEdGraphPin*>> OutputInput;
+	// 0 for the parent pin's direction, 1 for the other one
+	int32 DirectionIndex = 0;
 
-	bool bFirstPin = true;
+	// INDEX_NONE until the linked exec pins of the current direction are gathered
+	int32 PinIndex = INDEX_NONE;
+	TArray<UEdGraphPin*> Pins;
+
+	// INDEX_NONE until the links of Pins[PinIndex] are gathered
+	int32 LinkedIndex = INDEX_NONE;
+	TArray<UEdGraphPin*> LinkedPins;
 
+	void Reset(UEdGraphNode* InNode, UEdGraphPin* InParentPin)
+	{
+		Node = InNode;
+		ParentPin = InParentPin;
+		bFirstPin = true;
+		DirectionIndex = 0;
+		PinIndex = INDEX_NONE;
+		Pins.Reset();
+		LinkedIndex = INDEX_NONE;
+		LinkedPins.Reset();
+	}
+};
+
+bool FEdGraphFormatter::GetPinsOfSameHeight_NextLink(
+	FSameHeightFrame& Frame,
+	TSet<UEdGraphNode*>& NodesToCollisionCheck,
+	TSet<FPinLink>& VisitedLinks,
+	FPinLink& OutLink)
+{
 	auto& GraphHandlerCapture = GraphHandler;
 
 	auto LinkedToSorter = [&GraphHandlerCapture, &NodesToCollisionCheck](UEdGraphPin& PinA, UEdGraphPin& PinB)
@@ -1494,32 +1603,47 @@ void FEdGraphFormatter::GetPinsOfSameHeight_Recursive(
 		return PinPosA.Y < PinPosB.Y;
 	};
 
+	UEdGraphNode* CurrentNode = Frame.Node;
+	UEdGraphPin* ParentPin = Frame.ParentPin;
 	const EEdGraphPinDirection ParentDirection = ParentPin == nullptr ? EGPD_Output : ParentPin->Direction.GetValue();
-	TArray<EEdGraphPinDirection> Directions = { ParentDirection, UEdGraphPin::GetComplementaryDirection(ParentDirection) };
-	for (auto CurrentDirection : Directions)
+	while (Frame.DirectionIndex < 2)
 	{
-		TArray<UEdGraphPin*> Pins = FBAUtils::GetLinkedPins(CurrentNode, CurrentDirection)
-			.FilterByPredicate(FBAUtils::IsExecOrDelegatePin)
-			.FilterByPredicate(FBAUtils::IsPinLinked);
-
-		Pins.StableSort([&GraphHandler = GraphHandler](const UEdGraphPin& A, const UEdGraphPin& B)
+		if (Frame.PinIndex == INDEX_NONE)
 		{
-			return GraphHandler->GetPinY(&A) < GraphHandler->GetPinY(&B);
-		});
+			const EEdGraphPinDirection CurrentDirection = Frame.DirectionIndex == 0 ? ParentDirection : UEdGraphPin::GetComplementaryDirection(ParentDirection);
+			Frame.Pins = FBAUtils::GetLinkedPins(CurrentNode, CurrentDirection)
+				.FilterByPredicate(FBAUtils::IsExecOrDelegatePin)
+				.FilterByPredicate(FBAUtils::IsPinLinked);
+
+			Frame.Pins.StableSort([&GraphHandler = GraphHandler](const UEdGraphPin& A, const UEdGraphPin& B)
+			{
+				return GraphHandler->GetPinY(&A) < GraphHandler->GetPinY(&B);
+			});
 
-		TArray<FPinLink> LinksToIterate;
-		for (UEdGraphPin* MyPin : Pins)
+			Frame.PinIndex = 0;
+			Frame.LinkedIndex = INDEX_NONE;
+		}
+
+		for (; Frame.PinIndex < Frame.Pins.Num(); ++Frame.PinIndex, Frame.LinkedIndex = INDEX_NONE)
 		{
-			TArray<UEdGraphPin*> LinkedPins = MyPin->LinkedTo;
+			UEdGraphPin* MyPin = Frame.Pins[Frame.PinIndex];
 
-			if (MyPin->Direction == EGPD_Input && UBASettings::Get().FormattingStyle == EBANodeFormattingStyle::Expanded)
+			// sorted only once the earlier links' nodes are visited, the sort looks at which nodes are
+			if (Frame.LinkedIndex == INDEX_NONE)
 			{
-				LinkedPins.StableSort(LinkedToSorter);
+				Frame.LinkedPins = MyPin->LinkedTo;
+
+				if (MyPin->Direction == EGPD_Input && UBASettings::Get().FormattingStyle == EBANodeFormattingStyle::Expanded)
+				{
+					Frame.LinkedPins.StableSort(LinkedToSorter);
+				}
+
+				Frame.LinkedIndex = 0;
 			}
 
-			for (int i = 0; i < LinkedPins.Num(); ++i)
+			while (Frame.LinkedIndex < Frame.LinkedPins.Num())
 			{
-				UEdGraphPin* OtherPin = LinkedPins[i];
+				UEdGraphPin* OtherPin = Frame.LinkedPins[Frame.LinkedIndex++];
 				UEdGraphNode* OtherNode = OtherPin->GetOwningNode();
 				FPinLink Link(MyPin, OtherPin);
 
@@ -1548,24 +1672,26 @@ void FEdGraphFormatter::GetPinsOfSameHeight_Recursive(
 				// UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("INITIAL Iterating (%s) %s"), *FBAUtils::GetNodeName(CurrentNode), *Link.ToString());
 
 				VisitedLinks.Add(Link);
-				if (bFirstPin && (ParentPin == nullptr || MyPin->Direction == ParentPin->Direction))
+				if (Frame.bFirstPin && (ParentPin == nullptr || MyPin->Direction == ParentPin->Direction))
 				{
-					// for (auto& VisitedLink : VisitedLinks)
-					// {
-					// 	UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("\t\t\t\t%s"), *VisitedLink.ToString());
-					// }
 					// UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("\tSame row? %s"), *Link.ToString());
 					SameRowMapping.Add(Link, true);
 					SameRowMapping.Add(FPinLink(OtherPin, MyPin), true);
 					SameRowMappingDirect.Add(OtherPin, MyPin);
 					SameRowMappingDirect.Add(MyPin, OtherPin);
-					bFirstPin = false;
+					Frame.bFirstPin = false;
 				}
 
-				GetPinsOfSameHeight_Recursive(OtherNode, OtherPin, MyPin, NodesToCollisionCheck, VisitedLinks);
+				OutLink = Link;
+				return true;
 			}
 		}
+
+		++Frame.DirectionIndex;
+		Frame.PinIndex = INDEX_NONE;
 	}
+
+	return false;
 }
 
 bool FEdGraphFormatter::LinkToSort(UEdGraphPin& PinA, UEdGraphPin& PinB, TSet<UEdGraphNode*>& VisitedNodes)
@@ -1700,6 +1826,7 @@ void FEdGraphFormatter::WrapNodes()
 void FEdGraphFormatter::ApplyCommentPaddingY()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphFormatter::ApplyCommentPaddingY"), STAT_EdGraphFormatter_ApplyCommentPaddingY, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::CommentPadding);
 
 	if (CommentHandler.GetComments().Num() == 0)
 	{
@@ -1840,6 +1967,7 @@ void FEdGraphFormatter::ApplyCommentPaddingY_Recursive(TArray<UEdGraphNode*> Nod
 void FEdGraphFormatter::ApplyCommentPaddingAfterKnots()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphFormatter::ApplyCommentPaddingAfterKnots"), STAT_EdGraphFormatter_ApplyCommentPaddingAfterKnots, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::CommentPadding);
 
 	if (CommentHandler.GetComments().Num() == 0)
 	{
@@ -2056,9 +2184,20 @@ void FEdGraphFormatter::ApplyCommentPaddingAfterKnots_Recursive(TArray<UEdGraphN
 	}
 }
 
+struct FEdGraphFormatter::FCommentPaddingXFrame
+{
+	TArray<UEdGraphNode*> NodeSet;
+	const TArray<TSharedPtr<FBACommentContainsNode>>* ContainsNodes = nullptr;
+	int32 ChildIndex = 0;
+
+	// the leaf links of the nested levels, gathered before this level is padded
+	TArray<FPinLink> LeafLinks;
+};
+
 void FEdGraphFormatter::ApplyCommentPaddingX()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphFormatter::ApplyCommentPaddingX"), STAT_EdGraphFormatter_ApplyCommentPaddingX, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::CommentPadding);
 	// UE_LOG(LogTemp, Error, TEXT("EXPAND COMMENTS X"));
 
 	TArray<FPinLink> LeafLinks;
@@ -2071,14 +2210,48 @@ void FEdGraphFormatter::ApplyCommentPaddingX()
 		}
 	}
 
-	ApplyCommentPaddingX_Recursive(Contains, CommentHandler.GetRootNodes().Array(), LeafLinks);
+	// the nested comments are padded before the comment around them, a frame per nesting level instead of a call
+	// popped frames keep their containers for the next comment at the same level
+	const TArray<TSharedPtr<FBACommentContainsNode>> RootNodes = CommentHandler.GetRootNodes().Array();
+	TArray<FCommentPaddingXFrame> Stack;
+	int32 Depth = 0;
+	const auto PushFrame = [&](const TArray<UEdGraphNode*>& NodeSet, const TArray<TSharedPtr<FBACommentContainsNode>>& ContainsNodes)
+	{
+		if (Stack.Num() == Depth)
+		{
+			Stack.AddDefaulted();
+		}
+
+		FCommentPaddingXFrame& Frame = Stack[Depth++];
+		Frame.NodeSet = NodeSet;
+		Frame.ContainsNodes = &ContainsNodes;
+		Frame.ChildIndex = 0;
+		Frame.LeafLinks.Reset();
+		ApplyCommentPaddingX_SortNodeSet(Frame.NodeSet, ContainsNodes);
+	};
+
+	PushFrame(Contains, RootNodes);
+	while (Depth > 0)
+	{
+		FCommentPaddingXFrame& Frame = Stack[Depth - 1];
+		if (Frame.ChildIndex < Frame.ContainsNodes->Num())
+		{
+			const TSharedPtr<FBACommentContainsNode> ContainsNode = (*Frame.ContainsNodes)[Frame.ChildIndex++];
+			PushFrame(ContainsNode->OwnedNodes, ContainsNode->Children);
+			continue;
+		}
+
+		// the outermost level's leaf links go nowhere
+		TArray<FPinLink>& OutLeafLinks = Depth > 1 ? Stack[Depth - 2].LeafLinks : LeafLinks;
+		ApplyCommentPaddingX_Level(Frame.NodeSet, *Frame.ContainsNodes, Frame.LeafLinks, OutLeafLinks);
+		--Depth;
+	}
 	// UE_LOG(LogTemp, Error, TEXT("END EXPAND COMMENTS X"));
 }
 
-void FEdGraphFormatter::ApplyCommentPaddingX_Recursive(
-	TArray<UEdGraphNode*> NodeSet,
-	TArray<TSharedPtr<FBACommentContainsNode>> ContainsNodes,
-	TArray<FPinLink>& OutLeafLinks)
+void FEdGraphFormatter::ApplyCommentPaddingX_SortNodeSet(
+	TArray<UEdGraphNode*>& NodeSet,
+	const TArray<TSharedPtr<FBACommentContainsNode>>& ContainsNodes)
 {
 	NodeSet.RemoveAll([&NodePool = NodePool](UEdGraphNode* Node)
 	{
@@ -2098,15 +2271,14 @@ void FEdGraphFormatter::ApplyCommentPaddingX_Recursive(
 	};
 
 	NodeSet.StableSort(LeftMost);
+}
 
-	TArray<FPinLink> LeafLinks;
-	for (TSharedPtr<FBACommentContainsNode> ContainsNode : ContainsNodes)
-	{
-		ApplyCommentPaddingX_Recursive(ContainsNode->OwnedNodes, ContainsNode->Children, LeafLinks);
-	}
-
-	TArray<UEdGraphNode*> AllNodes = NodeSet;
-
+void FEdGraphFormatter::ApplyCommentPaddingX_Level(
+	const TArray<UEdGraphNode*>& NodeSet,
+	const TArray<TSharedPtr<FBACommentContainsNode>>& ContainsNodes,
+	const TArray<FPinLink>& LeafLinks,
+	TArray<FPinLink>& OutLeafLinks)
+{
 	// UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("Format SubGraph"));
 	// for (UEdGraphNode* Node : NodeSet)
 	// {
@@ -2180,7 +2352,7 @@ void FEdGraphFormatter::ApplyCommentPaddingX_Recursive(
 				continue;
 			}
 
-			if (AllNodes.Contains(Info->Link.GetNode()))
+			if (NodeSet.Contains(Info->Link.GetNode()))
 			{
 				LinksInNodeSet.Add(Info->Link);
 			}
@@ -2819,13 +2991,40 @@ void FEdGraphFormatter::GetPinsOfSameHeight()
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphFormatter::GetPinsOfSameHeight"), STAT_EdGraphFormatter_GetPinsOfSameHeight, STATGROUP_BA_EdGraphFormatter);
 	TSet<UEdGraphNode*> NodesToCollisionCheck;
 	TSet<FPinLink> VisitedLinks;
-	TSet<UEdGraphNode*> TempChildren;
-	GetPinsOfSameHeight_Recursive(RootNode, nullptr, nullptr, NodesToCollisionCheck, VisitedLinks);
+
+	// depth first along the exec chain on an explicit stack, popped frames keep their containers for the next node
+	TArray<FSameHeightFrame> Stack;
+	int32 Depth = 0;
+	const auto PushFrame = [&](UEdGraphNode* Node, UEdGraphPin* ParentPin)
+	{
+		if (Stack.Num() == Depth)
+		{
+			Stack.AddDefaulted();
+		}
+
+		Stack[Depth++].Reset(Node, ParentPin);
+		NodesToCollisionCheck.Emplace(Node);
+	};
+
+	PushFrame(RootNode, nullptr);
+	FPinLink Link;
+	while (Depth > 0)
+	{
+		if (GetPinsOfSameHeight_NextLink(Stack[Depth - 1], NodesToCollisionCheck, VisitedLinks, Link))
+		{
+			PushFrame(Link.To->GetOwningNode(), Link.From);
+		}
+		else
+		{
+			--Depth;
+		}
+	}
 }
 
 void FEdGraphFormatter::FormatParameterNodes()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphFormatter::FormatParameterNodes"), STAT_EdGraphFormatter_FormatParameterNodes, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::Parameters);
 	TArray<UEdGraphNode*> IgnoredNodes = GetFormatterParameters().IgnoredNodes;
 
 	TArray<UEdGraphNode*> NodePoolCopy = NodePool;
@@ -2843,11 +3042,19 @@ void FEdGraphFormatter::FormatParameterNodes()
 
 	ParameterParentMap.Reset();
 
+	// reused formatters only move their nodes back into place and were already expanded last time
+	TSet<TSharedPtr<FEdGraphParameterFormatter>> ReusedFormatters;
+
 	for (UEdGraphNode* MainNode : NodePoolCopy)
 	{
 		// UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("Format parameters for node %s"), *FBAUtils::GetNodeName(MainNode));
 
 		TSharedPtr<FEdGraphParameterFormatter> ParameterFormatter = GetParameterFormatter(MainNode);
+		if (ParameterFormatter->bInitialized)
+		{
+			ReusedFormatters.Add(ParameterFormatter);
+		}
+
 		ParameterFormatter->SetIgnoredNodes(IgnoredNodes);
 		ParameterFormatter->FormatNode(MainNode);
 
@@ -2886,7 +3093,10 @@ void FEdGraphFormatter::FormatParameterNodes()
 		for (UEdGraphNode* MainNode : NodePoolCopy)
 		{
 			TSharedPtr<FEdGraphParameterFormatter> ParameterFormatter = GetParameterFormatter(MainNode);
-			ParameterFormatter->ExpandByHeight();
+			if (!ReusedFormatters.Contains(ParameterFormatter))
+			{
+				ParameterFormatter->ExpandByHeight();
+			}
 		}
 	}
 
@@ -2904,6 +3114,9 @@ void FEdGraphFormatter::FormatParameterNodes()
 		// 	UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("\tNode %s"), *FBAUtils::GetNodeName(Child));
 		// }
 	}
+
+	ReusableParameterFormatters.Reset();
+	ResizedNodes.Reset();
 }
 
 TSet<UEdGraphNode*> FEdGraphFormatter::GetFormattedGraphNodes()
@@ -2933,7 +3146,7 @@ void FEdGraphFormatter::RefreshParameters(UEdGraphNode* Node)
 
 bool FEdGraphFormatter::IsFormattingRequired(const TArray<UEdGraphNode*>& NewNodeTree)
 {
-	if (!NewNodeTree.Contains(NodeToKeepStill))
+	if (!NewNodeTree.Contains(NodeToKeepStill) || ResizedNodes.Num() > 0)
 	{
 		return true;
 	}
@@ -2980,6 +3193,90 @@ bool FEdGraphFormatter::IsFormattingRequired(const TArray<UEdGraphNode*>& NewNod
 	return false;
 }
 
+void FEdGraphFormatter::CollectReusableParameterFormatters()
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphFormatter::CollectReusableParameterFormatters"), STAT_EdGraphFormatter_CollectReusableParameterFormatters, STATGROUP_BA_EdGraphFormatter);
+
+	ReusableParameterFormatters.Reset();
+
+	// the last layout is only kept around by a formatter which is reused between formats
+	if (!UBASettings::Get().bEnableFasterFormatting)
+	{
+		return;
+	}
+
+	for (const auto& Kvp : ParameterFormatterMap)
+	{
+		if (Kvp.Value.IsValid() && Kvp.Value->bInitialized && CanReuseParameterFormatter(Kvp.Key, Kvp.Value))
+		{
+			ReusableParameterFormatters.Add(Kvp.Key, Kvp.Value);
+		}
+	}
+}
+
+bool FEdGraphFormatter::CanReuseParameterFormatter(UEdGraphNode* MainNode, TSharedPtr<FEdGraphParameterFormatter> ParamFormatter)
+{
+	if (FBAUtils::IsNodeDeleted(MainNode) || FBAUtils::IsNodePure(MainNode))
+	{
+		return false;
+	}
+
+	const TSet<UEdGraphNode*> BranchNodes = ParamFormatter->GetFormattedNodes();
+	for (UEdGraphNode* Node : BranchNodes)
+	{
+		if (FBAUtils::IsNodeDeleted(Node) || FormatterParameters.IgnoredNodes.Contains(Node) || ResizedNodes.Contains(Node))
+		{
+			return false;
+		}
+
+		FNodeChangeInfo* ChangeInfo = NodeChangeInfos.Find(Node);
+		if (!ChangeInfo)
+		{
+			return false;
+		}
+
+		if (Node == MainNode)
+		{
+			// the main node is moved and relinked along with the exec nodes, the branch is placed relative to it
+			if (ChangeInfo->NodeSizeChangeData.HasNodeChanged(Node) || ChangeInfo->HaveContainingCommentsChanged(&CommentHandler))
+			{
+				return false;
+			}
+		}
+		else if (ChangeInfo->HasChanged(NodeToKeepStill, &CommentHandler))
+		{
+			return false;
+		}
+
+		// a node shared with another branch goes to whichever main node is formatted first, which depends on the new exec layout
+		for (UEdGraphPin* Pin : Node->Pins)
+		{
+			if (Node == MainNode && FBAUtils::IsExecPin(Pin))
+			{
+				continue;
+			}
+
+			for (UEdGraphPin* LinkedPin : Pin->LinkedTo)
+			{
+				UEdGraphNode* LinkedNode = LinkedPin->GetOwningNode();
+				if (BranchNodes.Contains(LinkedNode))
+				{
+					continue;
+				}
+
+				if (Node == MainNode && FBAUtils::IsNodeImpure(LinkedNode) && !FBAUtils::IsKnotNode(LinkedNode))
+				{
+					continue;
+				}
+
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 void FEdGraphFormatter::SaveFormattingEndInfo()
 {
 	// Save the position so we can move relative to this the next time we format
@@ -3097,12 +3394,25 @@ TSharedPtr<FEdGraphParameterFormatter> FEdGraphFormatter::GetParameterFormatter(
 	
 	if (!ParameterFormatterMap.Contains(Node))
 	{
-		ParameterFormatterMap.Add(Node, MakeShared<FEdGraphParameterFormatter>(GraphHandler, Node, SharedThis(this)));
+		TSharedPtr<FEdGraphParameterFormatter> ReusedFormatter;
+		if (ReusableParameterFormatters.RemoveAndCopyValue(Node, ReusedFormatter))
+		{
+			ParameterFormatterMap.Add(Node, ReusedFormatter);
+		}
+		else
+		{
+			ParameterFormatterMap.Add(Node, MakeShared<FEdGraphParameterFormatter>(GraphHandler, Node, SharedThis(this)));
+		}
 	}
 
 	return ParameterFormatterMap[Node];
 }
 
+void FEdGraphFormatter::MarkNodeResized(UEdGraphNode* Node)
+{
+	ResizedNodes.Add(Node);
+}
+
 TSharedPtr<FFormatterInterface> FEdGraphFormatter::GetChildFormatter(UEdGraphNode* Node)
 {
 	return GetParameterParent(Node);
@@ -3300,13 +3610,49 @@ TSet<UEdGraphNode*> FEdGraphFormatter::GetFormattedNodes()
 void FEdGraphFormatter::FormatY()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphFormatter::FormatY"), STAT_EdGraphFormatter_FormatY, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::FormatY);
 
 	// UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("-------Format Y-------- NO COMMENTS"));
 
 	TSet<UEdGraphNode*> NodesToCollisionCheck;
 	TSet<FPinLink> VisitedLinks;
-	TSet<UEdGraphNode*> TempChildren;
-	FormatY_Recursive(FPinLink(nullptr, nullptr, RootNode), NodesToCollisionCheck, VisitedLinks, true, TempChildren);
+
+	// a frame per node along the exec chain instead of a call per node, so long chains cannot overflow the stack;
+	// popped frames keep their containers for the next node at the same depth
+	TArray<FFormatYFrame> Stack;
+	int32 Depth = 0;
+	const auto PushFrame = [&](const FPinLink& Link, bool bSameRow)
+	{
+		if (Stack.Num() == Depth)
+		{
+			Stack.AddDefaulted();
+		}
+
+		FFormatYFrame& Frame = Stack[Depth++];
+		Frame.Reset(Link, bSameRow);
+		FormatY_EnterNode(Frame, NodesToCollisionCheck);
+	};
+
+	PushFrame(FPinLink(nullptr, nullptr, RootNode), true);
+	while (Depth > 0)
+	{
+		FFormatYFrame& Frame = Stack[Depth - 1];
+		if (FormatY_NextChild(Frame, NodesToCollisionCheck, VisitedLinks))
+		{
+			// copied out, pushing may move the frames
+			const FPinLink ChildLink = Frame.PinLinks[Frame.LinkIndex];
+			const bool bChildIsSameRow = Frame.bChildIsSameRow;
+			PushFrame(ChildLink, bChildIsSameRow);
+			continue;
+		}
+
+		FormatY_ExitNode(Frame);
+		--Depth;
+		if (Depth > 0)
+		{
+			FormatY_ChildFormatted(Stack[Depth - 1], Stack[Depth].Children);
+		}
+	}
 
 	// UE_LOG(LogBlueprintAssist, VeryVerbose, TEXT("-------Format Y-------- COMMENTS"));
 }
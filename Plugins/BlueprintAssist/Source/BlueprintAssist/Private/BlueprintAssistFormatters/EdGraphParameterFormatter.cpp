@@ -8,6 +8,7 @@
 #include "BlueprintAssistStats.h"
 #include "BlueprintAssistUtils.h"
 #include "EdGraphNode_Comment.h"
+#include "BlueprintAssistFormatters/BAFormatterProfiler.h"
 #include "BlueprintAssistFormatters/EdGraphFormatter.h"
 #include "BlueprintAssistFormatters/GraphFormatterTypes.h"
 #include "BlueprintAssistWidgets/BlueprintAssistGraphOverlay.h"
@@ -44,6 +45,7 @@ FEdGraphParameterFormatter::FEdGraphParameterFormatter(
 void FEdGraphParameterFormatter::FormatNode(UEdGraphNode* InNode)
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FEdGraphParameterFormatter::FormatNode"), STAT_EdGraphParameterFormatter_FormatNode, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::Parameters);
 	if (!FBAUtils::IsGraphNode(RootNode))
 	{
 		return;
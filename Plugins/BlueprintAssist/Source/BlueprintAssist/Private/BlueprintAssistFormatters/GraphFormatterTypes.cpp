@@ -566,3 +566,36 @@ bool FFormatterConnectionValidator::CheckChanged(const TArray<UEdGraphNode*>& No
 
 	return false;
 }
+
+FBAFormatAllTree::FBAFormatAllTree(TSharedPtr<FBAGraphHandler> GraphHandler, TSharedPtr<FFormatterInterface> InFormatter)
+	: Formatter(InFormatter)
+	, Nodes(InFormatter->GetFormattedNodes().Array())
+	, RootNode(InFormatter->GetRootNode())
+{
+	NodeBounds = FBAUtils::GetCachedNodeArrayBounds(GraphHandler, Nodes);
+	Bounds = FBAUtils::GetCachedNodeArrayBoundsWithComments(GraphHandler, Formatter->GetCommentHandler(), Nodes);
+}
+
+void FBAFormatAllTree::Translate(int32 DeltaX, int32 DeltaY)
+{
+	for (UEdGraphNode* Node : Nodes)
+	{
+		Node->NodePosX += DeltaX;
+		Node->NodePosY += DeltaY;
+	}
+
+	const FVector2D Delta(DeltaX, DeltaY);
+	NodeBounds = NodeBounds.OffsetBy(Delta);
+	Bounds = Bounds.OffsetBy(Delta);
+}
+
+FSlateRect FBAFormatAllTree::GetGroupedBounds(const TArray<FBAFormatAllTree*>& Trees)
+{
+	TArray<FSlateRect> BoundsArray;
+	for (const FBAFormatAllTree* Tree : Trees)
+	{
+		BoundsArray.Add(Tree->Bounds);
+	}
+
+	return FBAUtils::GetGroupedBounds(BoundsArray);
+}
@@ -6,6 +6,7 @@
 #include "BlueprintAssistGraphHandler.h"
 #include "BlueprintAssistUtils.h"
 #include "K2Node_Knot.h"
+#include "BlueprintAssistFormatters/BANodeBoundsGrid.h"
 #include "BlueprintAssistFormatters/FormatterInterface.h"
 
 DEFINE_LOG_CATEGORY(LogKnotTrackCreator);
@@ -102,7 +103,7 @@ float FKnotNodeTrack::GetTrackHeight()
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 FKnotNodeTrack::FKnotNodeTrack(
-	TSharedPtr<FFormatterInterface> Formatter,
+	const FBANodeBoundsGrid& NodeGrid,
 	TSharedPtr<FBAGraphHandler> InGraphHandler,
 	UEdGraphPin* InParentPin,
 	TArray<UEdGraphPin*> InLinkedTo,
@@ -114,7 +115,7 @@ FKnotNodeTrack::FKnotNodeTrack(
 {
 	ParentPinPos = FBAUtils::GetPinPos(GraphHandler, InParentPin);
 
-	SetTrackHeight(Formatter);
+	SetTrackHeight(NodeGrid);
 }
 
 UEdGraphPin* FKnotNodeTrack::GetParentPin()
@@ -146,10 +147,9 @@ FSlateRect FKnotNodeTrack::GetTrackBounds()
 					FVector2D(TrackXRight, LocalTrackY + (TrackSpacing - 1) * 0.5f));
 }
 
-void FKnotNodeTrack::SetTrackHeight(TSharedPtr<FFormatterInterface> Formatter)
+void FKnotNodeTrack::SetTrackHeight(const FBANodeBoundsGrid& NodeGrid)
 {
 	const float TrackSpacing = UBASettings::Get().BlueprintKnotTrackSpacing;
-	const TArray<UEdGraphNode*>& AllNodes = Formatter->GetFormattedNodes().Array();
 
 	UEdGraphPin* LastPin = GetLastPin();
 
@@ -165,7 +165,7 @@ void FKnotNodeTrack::SetTrackHeight(TSharedPtr<FFormatterInterface> Formatter)
 		for (UEdGraphPin* Pin : { ParentPin.GetPin(), LastPin })
 		{
 			const float PinHeight = GraphHandler->GetPinY(Pin);
-			if (TryAlignTrack(Formatter, TrackStart, TrackEnd, PinHeight))
+			if (TryAlignTrack(NodeGrid, TrackStart, TrackEnd, PinHeight))
 			{
 				UpdateTrackHeight(PinHeight);
 				return;
@@ -192,25 +192,19 @@ void FKnotNodeTrack::SetTrackHeight(TSharedPtr<FFormatterInterface> Formatter)
 		FVector2D StartPoint(TrackStart, TestSolution);
 		FVector2D EndPoint(TrackEnd, TestSolution);
 	
-		for (UEdGraphNode* NodeToCollisionCheck : AllNodes)
+		UEdGraphNode* ParentNode = GetParentPin()->GetOwningNode();
+		UEdGraphNode* LastNode = LastPin->GetOwningNode();
+		NodeGrid.ForEachLineIntersection(StartPoint, EndPoint, FMargin(0, TrackSpacing - 1), [&](UEdGraphNode* NodeToCollisionCheck, const FSlateRect& NodeBounds)
 		{
-			FSlateRect NodeBounds = FBAUtils::GetCachedNodeBounds(GraphHandler, NodeToCollisionCheck).ExtendBy(FMargin(0, TrackSpacing - 1));
-
-			const bool bSkipNode = NodeToCollisionCheck == GetParentPin()->GetOwningNode() || NodeToCollisionCheck == LastPin->GetOwningNode();
-			if (!bSkipNode)
+			if (NodeToCollisionCheck != ParentNode && NodeToCollisionCheck != LastNode)
 			{
-				// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Checking collision for node %s | %f %f  | %f"), *FBAUtils::GetNodeName(NodeToCollisionCheck), TrackStart, TrackEnd, TestSolution);
-				// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\t%s"), *NodeBounds.ToString());
-				// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\t%f %f | %f"), TrackStart, TrackEnd, TestSolution);
-	
-				if (FBAUtils::LineRectIntersection(NodeBounds, StartPoint, EndPoint))
-				{
-					// UE_LOG(LogKnotTrackCreator, Error, TEXT("\tNode collision  (%s) (%f) | %s"), *FBAUtils::GetNodeName(NodeToCollisionCheck), TestSolution, *NodeBounds.ToString());
-					bNoCollisionInDirection = false;
-					TestSolution = NodeBounds.Bottom + 1;
-				}
+				// UE_LOG(LogKnotTrackCreator, Error, TEXT("\tNode collision  (%s) (%f) | %s"), *FBAUtils::GetNodeName(NodeToCollisionCheck), TestSolution, *NodeBounds.ToString());
+				bNoCollisionInDirection = false;
+				TestSolution = NodeBounds.Bottom + 1;
 			}
-		}
+
+			return true;
+		});
 	
 		if (bNoCollisionInDirection)
 		{
@@ -270,38 +264,22 @@ bool FKnotNodeTrack::HasPinToAlignTo()
 	return PinToAlignTo.GetPin() != nullptr;
 }
 
-bool FKnotNodeTrack::TryAlignTrack(TSharedPtr<FFormatterInterface> Formatter, float TrackStart, float TrackEnd, float TestHeight)
+bool FKnotNodeTrack::TryAlignTrack(const FBANodeBoundsGrid& NodeGrid, float TrackStart, float TrackEnd, float TestHeight)
 {
 	const float TrackSpacing = UBASettings::Get().BlueprintKnotTrackSpacing;
 
-	UEdGraphPin* MyPin = GetParentPin();
-	UEdGraphPin* LastPin = GetLastPin();
-
-	const TArray<UEdGraphNode*>& AllNodes = Formatter->GetFormattedNodes().Array();
-	for (UEdGraphNode* NodeToCollisionCheck : AllNodes)
-	{
-		FSlateRect NodeBounds = FBAUtils::GetCachedNodeBounds(GraphHandler, NodeToCollisionCheck).ExtendBy(FVector2D(0, TrackSpacing - 1));
-
-		FVector2D StartPoint(TrackStart, TestHeight);
-		FVector2D EndPoint(TrackEnd, TestHeight);
+	UEdGraphNode* MyNode = GetParentPin()->GetOwningNode();
+	UEdGraphNode* LastNode = GetLastPin()->GetOwningNode();
 
-		const bool bSkipNode = NodeToCollisionCheck == MyPin->GetOwningNode() || NodeToCollisionCheck == LastPin->GetOwningNode();
-		if (!bSkipNode)
-		{
-			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Checking collision for node %s | %f %f  | %f"), *FBAUtils::GetNodeName(NodeToCollisionCheck), TrackStart, TrackEnd, TestHeight);
-			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\t%s"), *NodeBounds.ToString());
-			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\t%f %f | %f"), TrackStart, TrackEnd, TestHeight);
+	const FVector2D StartPoint(TrackStart, TestHeight);
+	const FVector2D EndPoint(TrackEnd, TestHeight);
 
-			if (FBAUtils::LineRectIntersection(NodeBounds, StartPoint, EndPoint))
-			{
-				// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\t\tCollision!"));
-				return false;
-			}
-		}
-	}
+	const bool bAnyCollision = NodeGrid.AnyLineIntersection(StartPoint, EndPoint, FMargin(0, TrackSpacing - 1), [MyNode, LastNode](UEdGraphNode* Node)
+	{
+		return Node == MyNode || Node == LastNode;
+	});
 
-	// UE_LOG(LogKnotTrackCreator, Warning, TEXT("No collision!"));
-	return true;
+	return !bAnyCollision;
 }
 
 TArray<UEdGraphNode*> FKnotNodeTrack::GetRelatedNodes()
@@ -7,6 +7,8 @@
 #include "BlueprintAssistUtils.h"
 #include "EdGraphNode_Comment.h"
 #include "K2Node_Knot.h"
+#include "Algo/BinarySearch.h"
+#include "BlueprintAssistFormatters/BAFormatterProfiler.h"
 #include "BlueprintAssistFormatters/BlueprintAssistCommentHandler.h"
 #include "BlueprintAssistFormatters/FormatterInterface.h"
 #include "BlueprintAssistWidgets/BlueprintAssistGraphOverlay.h"
@@ -27,6 +29,7 @@ void FKnotTrackCreator::Init(TSharedPtr<FFormatterInterface> InFormatter, TShare
 void FKnotTrackCreator::FormatKnotNodes()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FKnotTrackCreator::FormatKnotNodes"), STAT_KnotTrackCreator_FormatNode, STATGROUP_BA_EdGraphFormatter);
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::KnotTracks);
 	//UE_LOG(LogKnotTrackCreator, Warning, TEXT("### Format Knot Nodes"));
 
 	MakeKnotTrack();
@@ -254,7 +257,7 @@ void FKnotTrackCreator::CreateKnotTracks()
 
 	FBlueprintEditorUtils::MarkBlueprintAsModified(GraphHandler->GetBlueprint());
 
-	// Cleanup knot node pool
+	// Cleanup knot node pool, only the knots which weren't reused are removed from the graph
 	for (auto KnotNode : KnotNodePool)
 	{
 		if (FBAUtils::GetLinkedNodes(KnotNode).Num() == 0)
@@ -352,7 +355,20 @@ void FKnotTrackCreator::ExpandKnotTracks()
 	TArray<TSharedPtr<FKnotNodeTrack>> SortedTracks = KnotTracks;
 	SortedTracks.StableSort(ExpandTrackSorter);
 
-	TArray<TSharedPtr<FKnotNodeTrack>> PendingTracks = SortedTracks;
+	// only tracks of the same kind collide with each other, keep the unplaced ones of each kind in sorted order
+	const auto GetTrackKind = [](TSharedPtr<FKnotNodeTrack> Track)
+	{
+		return (Track->bIsLoopingTrack ? 2 : 0) + (FBAUtils::IsExecPin(Track->GetParentPin()) ? 1 : 0);
+	};
+
+	TArray<TSharedPtr<FKnotNodeTrack>> UnplacedTracksByKind[4];
+	for (TSharedPtr<FKnotNodeTrack> Track : SortedTracks)
+	{
+		UnplacedTracksByKind[GetTrackKind(Track)].Add(Track);
+	}
+
+	// the formatted nodes do not change while expanding, only their positions
+	const TSet<UEdGraphNode*> FormattedNodes = Formatter->GetFormattedNodes();
 
 	// for (auto Track : SortedTracks)
 	// {
@@ -365,11 +381,25 @@ void FKnotTrackCreator::ExpandKnotTracks()
 
 	TSet<TSharedPtr<FGroupedTracks>> PlacedGroups;
 	TSet<TSharedPtr<FKnotNodeTrack>> PlacedTracks;
-	while (PendingTracks.Num() > 0)
+	int32 NextTrackIndex = 0;
+	while (true)
 	{
-		TSharedPtr<FKnotNodeTrack> CurrentTrack = PendingTracks[0];
+		// the next pending track is the first unplaced one in sorted order
+		while (NextTrackIndex < SortedTracks.Num() && PlacedTracks.Contains(SortedTracks[NextTrackIndex]))
+		{
+			++NextTrackIndex;
+		}
+
+		if (NextTrackIndex >= SortedTracks.Num())
+		{
+			break;
+		}
+
+		TSharedPtr<FKnotNodeTrack> CurrentTrack = SortedTracks[NextTrackIndex];
 		PlacedTracks.Add(CurrentTrack);
 
+		TArray<TSharedPtr<FKnotNodeTrack>>& CandidateTracks = UnplacedTracksByKind[GetTrackKind(CurrentTrack)];
+
 		// const float TrackY = CurrentTrack->GetTrackHeight();
 
 		// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Process pending Track %s (%s)"), *FBAUtils::GetPinName(CurrentTrack->GetParentPin()), *FBAUtils::GetNodeName(CurrentTrack->GetParentPin()->GetOwningNode()));
@@ -380,47 +410,35 @@ void FKnotTrackCreator::ExpandKnotTracks()
 
 		float CurrentLowestTrackHeight = CurrentTrack->GetTrackHeight();
 		FSlateRect OverlappingBounds = CurrentTrack->GetTrackBounds();
+
+		// related nodes of the overlapping tracks, only looping tracks check these
+		TSet<UEdGraphNode*> OverlappingRelatedNodes;
+		if (CurrentTrack->bIsLoopingTrack)
+		{
+			OverlappingRelatedNodes.Append(CurrentTrack->GetRelatedNodes());
+		}
+
 		// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Current Track bounds %s"), *CurrentTrack->GetTrackBounds().ToString());
 		bool bFoundCollision = true;
 		do
 		{
 			bFoundCollision = false;
-			for (TSharedPtr<FKnotNodeTrack> Track : SortedTracks)
+			for (TSharedPtr<FKnotNodeTrack> Track : CandidateTracks)
 			{
+				// also skips the tracks already overlapping, they are placed as they are found
 				if (PlacedTracks.Contains(Track))
 				{
 					continue;
 				}
 
-				if (OverlappingTracks.Contains(Track))
-				{
-					continue;
-				}
-
-				if (Track->bIsLoopingTrack != CurrentTrack->bIsLoopingTrack)
-				{
-					continue;
-				}
-
-				if (FBAUtils::IsExecPin(Track->GetParentPin()) != FBAUtils::IsExecPin(CurrentTrack->GetParentPin()))
-				{
-					continue;
-				}
-
 				// if looping tracks share the same related nodes then they should count as 'overlapping'
 				if (Track->bIsLoopingTrack) // TODO: maybe we should do this for normal tracks too?
 				{
-					TSet<UEdGraphNode*> OverlappingSet;
-					for (TSharedPtr<FKnotNodeTrack> Overlapping : OverlappingTracks)
-					{
-						OverlappingSet.Append(Overlapping->GetRelatedNodes());
-					}
-
-					TSet<UEdGraphNode*> TrackSet(Track->GetRelatedNodes());
-
-					if (OverlappingSet.Intersect(TrackSet).Num() > 0)
+					const TArray<UEdGraphNode*> TrackRelatedNodes = Track->GetRelatedNodes();
+					if (TrackRelatedNodes.ContainsByPredicate([&OverlappingRelatedNodes](UEdGraphNode* Node) { return OverlappingRelatedNodes.Contains(Node); }))
 					{
 						OverlappingTracks.Add(Track);
+						OverlappingRelatedNodes.Append(TrackRelatedNodes);
 						PlacedTracks.Add(Track);
 						bFoundCollision = true;
 						continue;
@@ -434,6 +452,12 @@ void FKnotTrackCreator::ExpandKnotTracks()
 				{
 					OverlappingTracks.Add(Track);
 					PlacedTracks.Add(Track);
+
+					if (Track->bIsLoopingTrack)
+					{
+						OverlappingRelatedNodes.Append(Track->GetRelatedNodes());
+					}
+
 					bFoundCollision = true;
 
 					OverlappingBounds.Top = FMath::Min(Track->GetTrackHeight(), OverlappingBounds.Top);
@@ -457,6 +481,11 @@ void FKnotTrackCreator::ExpandKnotTracks()
 		}
 		while (bFoundCollision);
 
+		CandidateTracks.RemoveAll([&PlacedTracks](TSharedPtr<FKnotNodeTrack> Track)
+		{
+			return PlacedTracks.Contains(Track);
+		});
+
 		// if (OverlappingTracks.Num() == 1)
 		// {
 		// 	PendingTracks.Remove(CurrentTrack);
@@ -645,12 +674,6 @@ void FKnotTrackCreator::ExpandKnotTracks()
 		// }
 		// UE_LOG(LogKnotTrackCreator, Warning, TEXT("TRACK GROUP END"));
 
-		for (TSharedPtr<FKnotNodeTrack> Track : PlacedTracks)
-		{
-			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\tPlaced track %s"), *Track->ToString());
-			PendingTracks.Remove(Track);
-		}
-
 		TSet<UEdGraphNode*> TrackNodes = CurrentTrack->GetNodes(GraphHandler->GetFocusedEdGraph());
 
 		FSlateRect ExpandedBounds = AllGroup->GetBounds();// OverlappingBounds;
@@ -703,34 +726,27 @@ void FKnotTrackCreator::ExpandKnotTracks()
 		// find the top of the tallest node the track block is colliding with
 		TOptional<float> CollisionTop;
 
-		// collide against nodes
-		for (UEdGraphNode* Node : Formatter->GetFormattedNodes())
+		// the nodes the tracks start, end or align at, non looping tracks do not collide with these
+		TSet<UEdGraphNode*> SkippedNodes;
+		if (!CurrentTrack->bIsLoopingTrack)
 		{
-			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Collision check for node %s"), *FBAUtils::GetNodeName(Node));
-			bool bSkipNode = false;
-			// for (TSharedPtr<FKnotNodeTrack> Track : PlacedTracks)
 			for (TSharedPtr<FKnotNodeTrack> Track : AllGroup->Tracks)
 			{
-				// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\tAGAINST track %s"), *Track->ToString());
-				if (Node == Track->GetParentPin()->GetOwningNode() || Node == Track->GetLastPin()->GetOwningNode())
-				{
-					// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\t\tSkipping node %s"), *FBAUtils::GetNodeName(Node));
-					bSkipNode = true;
-					break;
-				}
+				SkippedNodes.Add(Track->GetParentPin()->GetOwningNode());
+				SkippedNodes.Add(Track->GetLastPin()->GetOwningNode());
 
 				if (auto AlignedPin = Track->GetPinToAlignTo())
 				{
-					if (Node == AlignedPin->GetOwningNode())
-					{
-						// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\t\tSkipping node aligned %s"), *FBAUtils::GetNodeName(Node));
-						bSkipNode = true;
-						break;
-					}
+					SkippedNodes.Add(AlignedPin->GetOwningNode());
 				}
 			}
+		}
 
-			if (bSkipNode && !CurrentTrack->bIsLoopingTrack)
+		// collide against nodes
+		for (UEdGraphNode* Node : FormattedNodes)
+		{
+			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Collision check for node %s"), *FBAUtils::GetNodeName(Node));
+			if (SkippedNodes.Contains(Node))
 			{
 				continue;
 			}
@@ -876,6 +892,13 @@ void FKnotTrackCreator::RemoveKnotNodes(const TArray<UEdGraphNode*>& NodeTree)
 				}
 			}
 
+			// a pooled knot is relinked at a new position, it no longer belongs to the comment it was in
+			if (FCommentHandler* CH = Formatter->GetCommentHandler())
+			{
+				CH->DeleteNode(KnotNode);
+			}
+
+			// reusing the knot skips removing it from the graph and adding it back, which notifies the graph and every listener each time
 			if (UBASettings::Get().bUseKnotNodePool &&
 				UBASettings::Get().bCreateKnotNodes) // if we don't create knot nodes, no point reusing them
 			{
@@ -884,11 +907,6 @@ void FKnotTrackCreator::RemoveKnotNodes(const TArray<UEdGraphNode*>& NodeTree)
 			else
 			{
 				FBAUtils::DeleteNode(KnotNode);
-
-				if (FCommentHandler* CH = Formatter->GetCommentHandler())
-				{
-					CH->DeleteNode(KnotNode);
-				}
 			}
 		}
 	}
@@ -922,7 +940,7 @@ UK2Node_Knot* FKnotTrackCreator::CreateKnotNode(FKnotNodeCreation* Creation, con
 	return CreatedNode; //Creation->CreateKnotNode(Position, ParentPin, OptionalNodeToReuse, GraphHandler->GetFocusedEdGraph());
 }
 
-bool FKnotTrackCreator::TryAlignTrackToEndPins(TSharedPtr<FKnotNodeTrack> Track, const TArray<UEdGraphNode*>& AllNodes)
+bool FKnotTrackCreator::TryAlignTrackToEndPins(TSharedPtr<FKnotNodeTrack> Track)
 {
 	const float ParentPinY = GraphHandler->GetPinY(Track->GetParentPin());
 	const float LastPinY = GraphHandler->GetPinY(Track->GetLastPin());
@@ -961,30 +979,20 @@ bool FKnotTrackCreator::TryAlignTrackToEndPins(TSharedPtr<FKnotNodeTrack> Track,
 
 		// UE_LOG(LogKnotTrackCreator, Error, TEXT("Checking Point %s | %s"), *Point.ToString(), *FBAUtils::GetNodeName(SourcePin->GetOwningNode()));
 
-		bool bAnyCollision = false;
-
-		for (UEdGraphNode* NodeToCollisionCheck : AllNodes)
+		UEdGraphNode* SourceNode = SourcePin->GetOwningNode();
+		UEdGraphNode* OtherNode = OtherPin->GetOwningNode();
+		bool bAnyCollision = NodeGrid.AnyLineIntersection(SourcePinPos, Point, FMargin(0, TrackSpacing - 1), [SourceNode, OtherNode](UEdGraphNode* Node)
 		{
-			FSlateRect CollisionBounds = FBAUtils::GetCachedNodeBounds(GraphHandler, NodeToCollisionCheck).ExtendBy(FMargin(0, TrackSpacing - 1));
-
-			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Collision check against %s | %s | %s"), *FBAUtils::GetNodeName(NodeToCollisionCheck), *CollisionBounds.ToString(), *Point.ToString());
-
-			if (NodeToCollisionCheck == SourcePin->GetOwningNode() || NodeToCollisionCheck == OtherPin->GetOwningNode())
-			{
-				// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\tSkipping node"));
-				continue;
-			}
+			return Node == SourceNode || Node == OtherNode;
+		});
 
-			if (FBAUtils::LineRectIntersection(CollisionBounds, SourcePinPos, Point))
+		for (TSharedPtr<FKnotNodeTrack> OtherTrack : KnotTracks)
+		{
+			if (bAnyCollision)
 			{
-				// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\tFound collision"));
-				bAnyCollision = true;
 				break;
 			}
-		}
 
-		for (TSharedPtr<FKnotNodeTrack> OtherTrack : KnotTracks)
-		{
 			if (OtherTrack == Track)
 			{
 				continue;
@@ -1037,8 +1045,6 @@ bool FKnotTrackCreator::DoesPinNeedTrack(UEdGraphPin* Pin, const TArray<UEdGraph
 
 bool FKnotTrackCreator::AnyCollisionBetweenPins(UEdGraphPin* Pin, UEdGraphPin* OtherPin)
 {
-	TSet<UEdGraphNode*> FormattedNodes = Formatter->GetFormattedNodes();
-
 	const FVector2D PinPos = FBAUtils::GetPinPos(GraphHandler, Pin);
 	const FVector2D OtherPinPos = FBAUtils::GetPinPos(GraphHandler, OtherPin);
 
@@ -1049,24 +1055,10 @@ bool FKnotTrackCreator::AnyCollisionBetweenPins(UEdGraphPin* Pin, UEdGraphPin* O
 
 bool FKnotTrackCreator::NodeCollisionBetweenLocation(FVector2D Start, FVector2D End, TSet<UEdGraphNode*> IgnoredNodes)
 {
-	TSet<UEdGraphNode*> FormattedNodes = Formatter->GetFormattedNodes();
-
-	for (UEdGraphNode* NodeToCollisionCheck : FormattedNodes)
+	return NodeGrid.AnyLineIntersection(Start, End, FMargin(0), [&IgnoredNodes](UEdGraphNode* Node)
 	{
-		if (IgnoredNodes.Contains(NodeToCollisionCheck))
-		{
-			continue;
-		}
-
-		FSlateRect NodeBounds = FBAUtils::GetCachedNodeBounds(GraphHandler, NodeToCollisionCheck);//.ExtendBy(FMargin(0, TrackSpacing - 1));
-		if (FBAUtils::LineRectIntersection(NodeBounds, Start, End))
-		{
-			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("\tNode collision! %s"), *FBAUtils::GetNodeName(NodeToCollisionCheck));
-			return true;
-		}
-	}
-
-	return false;
+		return IgnoredNodes.Contains(Node);
+	});
 }
 
 void FKnotTrackCreator::Reset()
@@ -1074,6 +1066,7 @@ void FKnotTrackCreator::Reset()
 	KnotNodesSet.Reset();
 	KnotTracks.Reset();
 	KnotNodeOwners.Reset();
+	NodeGrid.Reset();
 }
 
 void FKnotTrackCreator::AddNomadKnotsIntoComments()
@@ -1105,6 +1098,7 @@ void FKnotTrackCreator::MakeKnotTrack()
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FKnotTrackCreator::MakeKnotTrack"), STAT_KnotTrackCreator_MakeKnotTrack, STATGROUP_BA_EdGraphFormatter);
 	const TSet<UEdGraphNode*> FormattedNodes = Formatter->GetFormattedNodes();
+	NodeGrid.Build(GraphHandler, FormattedNodes);
 
 	const auto& NotFormatted = [FormattedNodes](UEdGraphPin* Pin)
 	{
@@ -1196,7 +1190,7 @@ TSharedPtr<FKnotNodeTrack> FKnotTrackCreator::MakeKnotTracksForLinkedExecPins(UE
 	for (UEdGraphPin* OtherPin : LoopingPins)
 	{
 		TArray<UEdGraphPin*> TrackPins = { OtherPin };
-		TSharedPtr<FKnotNodeTrack> KnotTrack = MakeShared<FKnotNodeTrack>(Formatter, GraphHandler, ParentPin, TrackPins, true);
+		TSharedPtr<FKnotNodeTrack> KnotTrack = MakeShared<FKnotNodeTrack>(NodeGrid, GraphHandler, ParentPin, TrackPins, true);
 		KnotTracks.Add(KnotTrack);
 
 		const FVector2D OtherPinPos = FBAUtils::GetPinPos(GraphHandler, OtherPin);
@@ -1270,9 +1264,9 @@ TSharedPtr<FKnotNodeTrack> FKnotTrackCreator::MakeKnotTracksForLinkedExecPins(UE
 		return nullptr;
 	}
 
-	TSharedPtr<FKnotNodeTrack> KnotTrack = MakeShared<FKnotNodeTrack>(Formatter, GraphHandler, ParentPin, LinkedPins, false);
+	TSharedPtr<FKnotNodeTrack> KnotTrack = MakeShared<FKnotNodeTrack>(NodeGrid, GraphHandler, ParentPin, LinkedPins, false);
 
-	TryAlignTrackToEndPins(KnotTrack, Formatter->GetFormattedNodes().Array());
+	TryAlignTrackToEndPins(KnotTrack);
 
 	// remove the first linked pins which has the same height and no collision
 	const bool bSameHeightAsParentPin = FMath::Abs(KnotTrack->GetTrackHeight() - ParentPinPos.Y) < 5.f;
@@ -1389,7 +1383,7 @@ TSharedPtr<FKnotNodeTrack> FKnotTrackCreator::MakeKnotTracksForParameterPins(UEd
 	for (UEdGraphPin* OtherPin : LoopingPins)
 	{
 		TArray<UEdGraphPin*> TrackPins = { OtherPin };
-		TSharedPtr<FKnotNodeTrack> KnotTrack = MakeShared<FKnotNodeTrack>(Formatter, GraphHandler, ParentPin, TrackPins, true);
+		TSharedPtr<FKnotNodeTrack> KnotTrack = MakeShared<FKnotNodeTrack>(NodeGrid, GraphHandler, ParentPin, TrackPins, true);
 		KnotTracks.Add(KnotTrack);
 
 		const FVector2D OtherPinPos = FBAUtils::GetPinPos(GraphHandler, OtherPin);
@@ -1459,10 +1453,10 @@ TSharedPtr<FKnotNodeTrack> FKnotTrackCreator::MakeKnotTracksForParameterPins(UEd
 	}
 
 	// init the knot track
-	TSharedPtr<FKnotNodeTrack> KnotTrack = MakeShared<FKnotNodeTrack>(Formatter, GraphHandler, ParentPin, LinkedPins, false);
+	TSharedPtr<FKnotNodeTrack> KnotTrack = MakeShared<FKnotNodeTrack>(NodeGrid, GraphHandler, ParentPin, LinkedPins, false);
 
 	// check if the track height can simply be set to one of it's pin's height
-	if (TryAlignTrackToEndPins(KnotTrack, Formatter->GetFormattedNodes().Array()))
+	if (TryAlignTrackToEndPins(KnotTrack))
 	{
 		// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Found a pin to align to for %s"), *FBAUtils::GetPinName(KnotTrack->GetParentPin()));
 	}
@@ -1560,45 +1554,91 @@ void FKnotTrackCreator::MergeNearbyKnotTracks()
 		return Track->bIsLoopingTrack;
 	});
 
-	while (PendingTracks.Num() > 0)
+	// only tracks with the same parent and the same height merge, group them instead of testing every pair
+	TMap<TTuple<UEdGraphPin*, float>, TArray<TSharedPtr<FKnotNodeTrack>>> TrackGroups;
+	TArray<TTuple<UEdGraphPin*, float>> GroupOrder;
+	for (TSharedPtr<FKnotNodeTrack> Track : PendingTracks)
+	{
+		// + 0.0f so -0 and 0 fall in the same group, they compare equal but hash differently
+		const TTuple<UEdGraphPin*, float> Key(Track->GetParentPin(), Track->GetTrackHeight() + 0.0f);
+		TArray<TSharedPtr<FKnotNodeTrack>>* Group = TrackGroups.Find(Key);
+		if (!Group)
+		{
+			Group = &TrackGroups.Add(Key);
+			GroupOrder.Add(Key);
+		}
+
+		Group->Add(Track);
+	}
+
+	TSet<TSharedPtr<FKnotNodeTrack>> MergedTracks;
+	for (const TTuple<UEdGraphPin*, float>& Key : GroupOrder)
 	{
-		auto CurrentTrack = PendingTracks.Pop();
-		auto Tracks = PendingTracks;
+		const TArray<TSharedPtr<FKnotNodeTrack>>& Group = TrackGroups[Key];
+		if (Group.Num() < 2)
+		{
+			continue;
+		}
+
+		// the last track of the group takes in the others, in the order they were created
+		TSharedPtr<FKnotNodeTrack> CurrentTrack = Group.Last();
+
+		// the creations of the current track sorted by x, so the ones within range of a creation are found by binary search
+		TArray<TSharedPtr<FKnotNodeCreation>> SortedCreations = CurrentTrack->KnotCreations;
+		SortedCreations.StableSort([](const TSharedPtr<FKnotNodeCreation>& A, const TSharedPtr<FKnotNodeCreation>& B)
+		{
+			return A->KnotPos.X < B->KnotPos.X;
+		});
+
+		const auto GetCreationX = [](const TSharedPtr<FKnotNodeCreation>& Creation)
+		{
+			return Creation->KnotPos.X;
+		};
 
-		for (TSharedPtr<FKnotNodeTrack> Track : Tracks)
+		for (int32 TrackIndex = 0; TrackIndex < Group.Num() - 1; ++TrackIndex)
 		{
+			TSharedPtr<FKnotNodeTrack> Track = Group[TrackIndex];
+
 			// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Merging track %s"), *FBAUtils::GetPinName(Track->GetParentPin()));
 
-			// merge if they have the same parent and same height
-			if (Track->GetParentPin() == CurrentTrack->GetParentPin() &&
-				Track->GetTrackHeight() == CurrentTrack->GetTrackHeight())
+			for (TSharedPtr<FKnotNodeCreation> Creation : Track->KnotCreations)
 			{
-				for (TSharedPtr<FKnotNodeCreation> Creation : Track->KnotCreations)
+				const float CreationX = Creation->KnotPos.X;
+
+				bool bShouldAddCreation = true;
+				for (int32 Index = Algo::UpperBoundBy(SortedCreations, CreationX - 50, GetCreationX); Index < SortedCreations.Num(); ++Index)
 				{
-					bool bShouldAddCreation = true;
-					for (TSharedPtr<FKnotNodeCreation> CurrentCreation : CurrentTrack->KnotCreations)
+					TSharedPtr<FKnotNodeCreation> CurrentCreation = SortedCreations[Index];
+					if (CurrentCreation->KnotPos.X - CreationX >= 50)
 					{
-						if (FMath::Abs(CurrentCreation->KnotPos.X - Creation->KnotPos.X) < 50)
-						{
-							bShouldAddCreation = false;
-							CurrentCreation->PinHandlesToConnectTo.Append(Creation->PinHandlesToConnectTo);
-						}
+						break;
 					}
 
-					if (bShouldAddCreation)
-					{
-						CurrentTrack->KnotCreations.Add(Creation);
-						CurrentTrack->PinToAlignTo.SetPin(nullptr);
-
-						// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Cancelled pin to align to for track %s"), *FBAUtils::GetPinName(CurrentTrack->GetParentPin()));
-					}
+					bShouldAddCreation = false;
+					CurrentCreation->PinHandlesToConnectTo.Append(Creation->PinHandlesToConnectTo);
 				}
 
-				KnotTracks.Remove(Track);
-				PendingTracks.Remove(Track);
+				if (bShouldAddCreation)
+				{
+					CurrentTrack->KnotCreations.Add(Creation);
+					SortedCreations.Insert(Creation, Algo::UpperBoundBy(SortedCreations, CreationX, GetCreationX));
+					CurrentTrack->PinToAlignTo.SetPin(nullptr);
+
+					// UE_LOG(LogKnotTrackCreator, Warning, TEXT("Cancelled pin to align to for track %s"), *FBAUtils::GetPinName(CurrentTrack->GetParentPin()));
+				}
 			}
+
+			MergedTracks.Add(Track);
 		}
 	}
+
+	if (MergedTracks.Num() > 0)
+	{
+		KnotTracks.RemoveAll([&MergedTracks](TSharedPtr<FKnotNodeTrack> Track)
+		{
+			return MergedTracks.Contains(Track);
+		});
+	}
 }
 
 void FKnotTrackCreator::AddKnotNodesToComments()
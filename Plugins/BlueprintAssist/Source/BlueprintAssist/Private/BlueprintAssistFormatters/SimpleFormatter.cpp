@@ -3,6 +3,7 @@
 #include "BlueprintAssistFormatters/SimpleFormatter.h"
 
 #include "BlueprintAssistFormatters/BAFormatterUtils.h"
+#include "BlueprintAssistFormatters/BANodeReachability.h"
 #include "BlueprintAssistUtils.h"
 #include "EdGraphNode_Comment.h"
 #include "BlueprintAssistWidgets/BlueprintAssistGraphOverlay.h"
@@ -276,6 +277,9 @@ void FSimpleFormatter::FormatX()
 
 	EEdGraphPinDirection LastDirection = FormatterSettings.FormatterDirection;
 
+	// answers whether an input node executes back into the current node, built on the first check
+	FBANodeReachability InputExecReachability;
+
 	NodesToExpand.Reset();
 
 	while (OutputStack.Num() > 0 || InputStack.Num() > 0)
@@ -458,7 +462,15 @@ void FSimpleFormatter::FormatX()
 
 						if (CurrentInfo->Link.GetDirection() == FormatterSettings.FormatterDirection)
 						{
-							const bool bHasCycle = PendingNodes.Contains(LinkedNode) || FBAUtils::GetExecTree(LinkedNode, OppositeDirection).Contains(CurrentInfo->GetNode());
+							if (!InputExecReachability.IsBuilt())
+							{
+								InputExecReachability.Build(FBAUtils::GetNodeTree(RootNode).Array(), [OppositeDirection](UEdGraphNode* Node)
+								{
+									return FBAUtils::GetLinkedNodesFromPins(FBAUtils::GetExecPins(Node, OppositeDirection));
+								});
+							}
+
+							const bool bHasCycle = PendingNodes.Contains(LinkedNode) || InputExecReachability.CanReach(LinkedNode, CurrentInfo->GetNode());
 
 							if (!bHasCycle)
 							{
@@ -655,43 +667,107 @@ void FSimpleFormatter::ExpandPendingNodes()
 	}
 }
 
+struct FSimpleFormatter::FFormatYFrame
+{
+	UEdGraphNode* Node = nullptr;
+	UEdGraphPin* Pin = nullptr;
+	UEdGraphPin* ParentPin = nullptr;
+	bool bSameRow = false;
+
+	// the nodes of this node's branch, handed to the parent frame once it is done
+	TSet<UEdGraphNode*> Children;
+
+	// the linked pins in the parent pin's direction, then the other direction's
+	TArray<UEdGraphPin*> OutputInput[2];
+	int32 DirectionIndex = 0;
+	int32 PinIndex = 0;
+
+	// INDEX_NONE until the links of the current pin are copied
+	int32 LinkIndex = INDEX_NONE;
+	TArray<UEdGraphPin*> LinkedPins;
+
+	bool bFirstPin = true;
+	UEdGraphPin* MainPin = nullptr;
+	UEdGraphPin* LastLinked = nullptr;
+	UEdGraphPin* LastProcessed = nullptr;
+
+	// whether LinkedPins[LinkIndex], whose branch the frame above formats, is on this node's row
+	bool bChildIsSameRow = false;
+
+	void Reset(UEdGraphNode* InNode, UEdGraphPin* InPin, UEdGraphPin* InParentPin, bool bInSameRow)
+	{
+		Node = InNode;
+		Pin = InPin;
+		ParentPin = InParentPin;
+		bSameRow = bInSameRow;
+		Children.Reset();
+		OutputInput[0].Reset();
+		OutputInput[1].Reset();
+		DirectionIndex = 0;
+		PinIndex = 0;
+		LinkIndex = INDEX_NONE;
+		LinkedPins.Reset();
+		bFirstPin = true;
+		MainPin = InPin;
+		LastLinked = InPin;
+		LastProcessed = nullptr;
+		bChildIsSameRow = false;
+	}
+};
+
 void FSimpleFormatter::FormatY()
 {
 	// UE_LOG(LogBlueprintAssist, Warning, TEXT("Format y?!?!?"));
 
 	TSet<UEdGraphNode*> NodesToCollisionCheck;
 	TSet<FPinLink> VisitedLinks;
-	TSet<UEdGraphNode*> TempChildren;
-	FormatY_Recursive(RootNode, nullptr, nullptr, NodesToCollisionCheck, VisitedLinks, true, TempChildren);
+
+	// a frame per node along the exec chain instead of a call per node, so long chains cannot overflow the stack;
+	// popped frames keep their containers for the next node at the same depth
+	TArray<FFormatYFrame> Stack;
+	int32 Depth = 0;
+	const auto PushFrame = [&](UEdGraphNode* Node, UEdGraphPin* Pin, UEdGraphPin* ParentPin, bool bSameRow)
+	{
+		if (Stack.Num() == Depth)
+		{
+			Stack.AddDefaulted();
+		}
+
+		FFormatYFrame& Frame = Stack[Depth++];
+		Frame.Reset(Node, Pin, ParentPin, bSameRow);
+		FormatY_EnterNode(Frame, NodesToCollisionCheck);
+	};
+
+	PushFrame(RootNode, nullptr, nullptr, true);
+	while (Depth > 0)
+	{
+		FFormatYFrame& Frame = Stack[Depth - 1];
+		if (FormatY_NextChild(Frame, NodesToCollisionCheck, VisitedLinks))
+		{
+			// copied out, pushing may move the frames
+			UEdGraphPin* MyPin = Frame.OutputInput[Frame.DirectionIndex][Frame.PinIndex];
+			UEdGraphPin* OtherPin = Frame.LinkedPins[Frame.LinkIndex];
+			const bool bChildIsSameRow = Frame.bChildIsSameRow;
+			PushFrame(OtherPin->GetOwningNode(), OtherPin, MyPin, bChildIsSameRow);
+			continue;
+		}
+
+		FormatY_ExitNode(Frame);
+		--Depth;
+		if (Depth > 0)
+		{
+			FormatY_ChildFormatted(Stack[Depth - 1], Stack[Depth].Children);
+		}
+	}
 }
 
-void FSimpleFormatter::FormatY_Recursive(
-	UEdGraphNode* CurrentNode,
-	UEdGraphPin* CurrentPin,
-	UEdGraphPin* ParentPin,
-	TSet<UEdGraphNode*>& NodesToCollisionCheck,
-	TSet<FPinLink>& VisitedLinks,
-	bool bSameRow,
-	TSet<UEdGraphNode*>& Children)
+void FSimpleFormatter::FormatY_EnterNode(FFormatYFrame& Frame, TSet<UEdGraphNode*>& NodesToCollisionCheck)
 {
-	// 	const FString NodeNameA = CurrentNode == nullptr
-	// 	? FString("nullptr")
-	// 	: FBAUtils::GetNodeName(CurrentNode);
-	// const FString PinNameA = CurrentPin == nullptr ? FString("nullptr") : FBAUtils::GetPinName(CurrentPin);
-	// const FString NodeNameB = ParentPin == nullptr
-	// 	? FString("nullptr")
-	// 	: FBAUtils::GetNodeName(ParentPin->GetOwningNode());
-	// const FString PinNameB = ParentPin == nullptr ? FString("nullptr") : FBAUtils::GetPinName(ParentPin);
-	//
-	// UE_LOG(LogBlueprintAssist, Warning, TEXT("FormatY Next : %s | %s || %s | %s"),
-	//        *NodeNameA, *PinNameA,
-	//        *NodeNameB, *PinNameB);
-
-	if (ParentPin)
+	if (Frame.ParentPin)
 	{
-		if (UEdGraphNode* ParentNode = ParentPin->GetOwningNode())
+		if (UEdGraphNode* ParentNode = Frame.ParentPin->GetOwningNode())
 		{
-			NodeRelativeMapping.UpdateRelativeY(CurrentNode, ParentNode);
+			NodeRelativeMapping.UpdateRelativeY(Frame.Node, ParentNode);
 		}
 	}
 
@@ -709,12 +785,12 @@ void FSimpleFormatter::FormatY_Recursive(
 		bool bNoCollision = true;
 		for (UEdGraphNode* NodeToCollisionCheck : NodesToCollisionCheck)
 		{
-			if (NodeToCollisionCheck == CurrentNode)
+			if (NodeToCollisionCheck == Frame.Node)
 			{
 				continue;
 			}
 
-			FSlateRect MyBounds = GetNodeBounds(CurrentNode);
+			FSlateRect MyBounds = GetNodeBounds(Frame.Node);
 			const FMargin CollisionPadding(0, 0, FormatterSettings.Padding.X * 0.75f, FormatterSettings.Padding.Y);
 
 			FSlateRect OtherBounds = GetNodeBounds(NodeToCollisionCheck);
@@ -728,12 +804,12 @@ void FSimpleFormatter::FormatY_Recursive(
 
 				// UE_LOG(LogBlueprintAssist, Warning, TEXT("Collision between %d | %s (%s) and %s (%s)"),
 				// 	Delta + 1,
-				// 	*FBAUtils::GetNodeName(CurrentNode), *MyBounds.ToString(),
+				// 	*FBAUtils::GetNodeName(Frame.Node), *MyBounds.ToString(),
 				// 	*FBAUtils::GetNodeName(NodeToCollisionCheck), *OtherBounds.ToString());
 
-				// UE_LOG(LogBlueprintAssist, Warning, TEXT("\tMoved node single %s"), *FBAUtils::GetNodeName(CurrentNode));
-				CurrentNode->NodePosY += Delta + 1;
-				NodeRelativeMapping.UpdateRelativeY(CurrentNode, NodeToCollisionCheck);
+				// UE_LOG(LogBlueprintAssist, Warning, TEXT("\tMoved node single %s"), *FBAUtils::GetNodeName(Frame.Node));
+				Frame.Node->NodePosY += Delta + 1;
+				NodeRelativeMapping.UpdateRelativeY(Frame.Node, NodeToCollisionCheck);
 			}
 		}
 
@@ -743,50 +819,40 @@ void FSimpleFormatter::FormatY_Recursive(
 		}
 	}
 
-	NodesToCollisionCheck.Emplace(CurrentNode);
+	NodesToCollisionCheck.Emplace(Frame.Node);
 
-	TArray<TArray<UEdGraphPin*>> OutputInput;
-
-	const EEdGraphPinDirection Direction = ParentPin == nullptr ? EGPD_Input : ParentPin->Direction.GetValue();
+	const EEdGraphPinDirection Direction = Frame.ParentPin == nullptr ? EGPD_Input : Frame.ParentPin->Direction.GetValue();
 
 	// UE_LOG(LogBlueprintAssist, Warning, TEXT("Pin Direction: %d"), Direction);
 
-	OutputInput.Add(FBAUtils::GetLinkedPins(CurrentNode, Direction));
-	OutputInput.Add(FBAUtils::GetLinkedPins(CurrentNode, UEdGraphPin::GetComplementaryDirection(Direction)));
-
-	bool bFirstPin = true;
-
-	UEdGraphPin* MainPin = CurrentPin;
-
-	auto& GraphHandlerCapture = GraphHandler;
+	Frame.OutputInput[0] = FBAUtils::GetLinkedPins(Frame.Node, Direction);
+	Frame.OutputInput[1] = FBAUtils::GetLinkedPins(Frame.Node, UEdGraphPin::GetComplementaryDirection(Direction));
+}
 
-	for (TArray<UEdGraphPin*>& Pins : OutputInput)
+bool FSimpleFormatter::FormatY_NextChild(FFormatYFrame& Frame, TSet<UEdGraphNode*>& NodesToCollisionCheck, TSet<FPinLink>& VisitedLinks)
+{
+	while (Frame.DirectionIndex < 2)
 	{
-		UEdGraphPin* LastLinked = CurrentPin;
-		UEdGraphPin* LastProcessed = nullptr;
-
-		int DeltaY = 0;
-		for (UEdGraphPin* MyPin : Pins)
+		const TArray<UEdGraphPin*>& Pins = Frame.OutputInput[Frame.DirectionIndex];
+		while (Frame.PinIndex < Pins.Num())
 		{
-			TArray<UEdGraphPin*> LinkedPins = MyPin->LinkedTo;
+			UEdGraphPin* MyPin = Pins[Frame.PinIndex];
+			if (Frame.LinkIndex == INDEX_NONE)
+			{
+				Frame.LinkedPins = MyPin->LinkedTo;
+			}
 
-			for (int i = 0; i < LinkedPins.Num(); ++i)
+			while (++Frame.LinkIndex < Frame.LinkedPins.Num())
 			{
-				UEdGraphPin* OtherPin = LinkedPins[i];
+				UEdGraphPin* OtherPin = Frame.LinkedPins[Frame.LinkIndex];
 				UEdGraphNode* OtherNode = OtherPin->GetOwningNode();
 				FPinLink Link(MyPin, OtherPin);
 
 				bool bIsSameLink = Path.Contains(Link);
 
 				// UE_LOG(LogBlueprintAssist, Warning, TEXT("\tIter Child %s"), *FBAUtils::GetNodeName(OtherNode));
-				//
-				// if (!bIsSameLink)
-				// {
-				// 	UE_LOG(LogBlueprintAssist, Warning, TEXT("\t\tNot same link!"));
-				// }
 
 				if (VisitedLinks.Contains(Link)
-					// || !NodePool.Contains(OtherNode)
 					|| NodesToCollisionCheck.Contains(OtherNode)
 					|| !bIsSameLink)
 				{
@@ -799,85 +865,90 @@ void FSimpleFormatter::FormatY_Recursive(
 
 				FBAUtils::StraightenPin(GraphHandler, MyPin, OtherPin);
 
-				bool bChildIsSameRow = IsSameRow(Link);
+				Frame.bChildIsSameRow = IsSameRow(Link);
 
-				if (bFirstPin && (ParentPin == nullptr || MyPin->Direction == ParentPin->Direction))
+				if (Frame.bFirstPin && (Frame.ParentPin == nullptr || MyPin->Direction == Frame.ParentPin->Direction))
 				{
-					// bChildIsSameRow = true;
-					bFirstPin = false;
-					// UE_LOG(LogBlueprintAssist, Error, TEXT("\t\tNode %s is same row as %s"),
-					//        *FBAUtils::GetNodeName(OtherNode),
-					//        *FBAUtils::GetNodeName(CurrentNode));
+					Frame.bFirstPin = false;
 				}
-				else
+				else if (Frame.LastProcessed != nullptr)
 				{
-					if (LastProcessed != nullptr)
-					{
-						//UE_LOG(LogBlueprintAssist, Warning, TEXT("Moved node %s to %s"), *FBAUtils::GetNodeName(OtherNode), *FBAUtils::GetNodeName(LastPinOther->GetOwningNode()));
-						const int32 NewNodePosY = FMath::Max(OtherNode->NodePosY, LastProcessed->GetOwningNode()->NodePosY);
-						FBAUtils::SetNodePosY(GraphHandler, OtherNode, NewNodePosY);
-					}
+					const int32 NewNodePosY = FMath::Max(OtherNode->NodePosY, Frame.LastProcessed->GetOwningNode()->NodePosY);
+					FBAUtils::SetNodePosY(GraphHandler, OtherNode, NewNodePosY);
 				}
 
-				TSet<UEdGraphNode*> LocalChildren;
-				FormatY_Recursive(OtherNode, OtherPin, MyPin, NodesToCollisionCheck, VisitedLinks, bChildIsSameRow, LocalChildren);
-				Children.Append(LocalChildren);
+				return true;
+			}
 
-				//UE_LOG(LogBlueprintAssist, Warning, TEXT("Local children for %s"), *FBAUtils::GetNodeName(CurrentNode));
-				//for (UEdGraphNode* Node : LocalChildren)
-				//{
-				//	UE_LOG(LogBlueprintAssist, Warning, TEXT("\tChild %s"), *FBAUtils::GetNodeName(Node));
-				//}
+			Frame.LastLinked = MyPin;
+			Frame.LinkIndex = INDEX_NONE;
+			++Frame.PinIndex;
+		}
 
-				if (!bChildIsSameRow && LocalChildren.Num() > 0)
-				{
-					UEdGraphPin* PinToAvoid = LastLinked;
-					if (MainPin != nullptr)
-					{
-						PinToAvoid = MainPin;
-						MainPin = nullptr;
-					}
+		++Frame.DirectionIndex;
+		Frame.PinIndex = 0;
+		Frame.LastLinked = Frame.Pin;
+		Frame.LastProcessed = nullptr;
+	}
 
-					if (PinToAvoid != nullptr)
-					{
-						FSlateRect Bounds = GetNodeArrayBounds(LocalChildren.Array());
+	return false;
+}
 
-						//UE_LOG(LogBlueprintAssist, Warning, TEXT("\t\t\tPin to avoid %s (%s)"), *FBAUtils::GetPinName(PinToAvoid), *FBAUtils::GetPinName(OtherPin));
-						const float PinPos = GraphHandler->GetPinY(PinToAvoid) + TrackSpacing;
-						const float Delta = PinPos - Bounds.Top;
+void FSimpleFormatter::FormatY_ChildFormatted(FFormatYFrame& Frame, const TSet<UEdGraphNode*>& LocalChildren)
+{
+	Frame.Children.Append(LocalChildren);
 
-						if (Delta > 0)
-						{
-							for (UEdGraphNode* Child : LocalChildren)
-							{
-								Child->NodePosY += Delta;
-							}
-						}
-					}
-				}
+	//UE_LOG(LogBlueprintAssist, Warning, TEXT("Local children for %s"), *FBAUtils::GetNodeName(Frame.Node));
+	//for (UEdGraphNode* Node : LocalChildren)
+	//{
+	//	UE_LOG(LogBlueprintAssist, Warning, TEXT("\tChild %s"), *FBAUtils::GetNodeName(Node));
+	//}
 
-				LastProcessed = OtherPin;
-			}
+	if (!Frame.bChildIsSameRow && LocalChildren.Num() > 0)
+	{
+		UEdGraphPin* PinToAvoid = Frame.LastLinked;
+		if (Frame.MainPin != nullptr)
+		{
+			PinToAvoid = Frame.MainPin;
+			Frame.MainPin = nullptr;
+		}
 
-			LastLinked = MyPin;
+		if (PinToAvoid != nullptr)
+		{
+			FSlateRect Bounds = GetNodeArrayBounds(LocalChildren.Array());
+
+			//UE_LOG(LogBlueprintAssist, Warning, TEXT("\t\t\tPin to avoid %s (%s)"), *FBAUtils::GetPinName(PinToAvoid), *FBAUtils::GetPinName(OtherPin));
+			const float PinPos = GraphHandler->GetPinY(PinToAvoid) + TrackSpacing;
+			const float Delta = PinPos - Bounds.Top;
 
-			DeltaY += 1;
+			if (Delta > 0)
+			{
+				for (UEdGraphNode* Child : LocalChildren)
+				{
+					Child->NodePosY += Delta;
+				}
+			}
 		}
 	}
 
-	Children.Add(CurrentNode);
+	Frame.LastProcessed = Frame.LinkedPins[Frame.LinkIndex];
+}
+
+void FSimpleFormatter::FormatY_ExitNode(FFormatYFrame& Frame)
+{
+	Frame.Children.Add(Frame.Node);
 
-	if (bSameRow && ParentPin != nullptr)
+	if (Frame.bSameRow && Frame.ParentPin != nullptr)
 	{
 		//UE_LOG(LogBlueprintAssist, Warning, TEXT("\t\t\tStraightening pin from %s to %s"),
-		//       *FBAUtils::GetPinName(CurrentPin),
-		//       *FBAUtils::GetPinName(ParentPin));
-		// SameRowMapping.Add(FPinLink(CurrentPin, ParentPin));
-		// SameRowMapping.Add(FPinLink(ParentPin, CurrentPin));
-		// SameRowMappingDirect.Add(CurrentPin, ParentPin);
-		// SameRowMappingDirect.Add(ParentPin, CurrentPin);
-
-		FBAUtils::StraightenPin(GraphHandler, CurrentPin, ParentPin);
+		//       *FBAUtils::GetPinName(Frame.Pin),
+		//       *FBAUtils::GetPinName(Frame.ParentPin));
+		// SameRowMapping.Add(FPinLink(Frame.Pin, Frame.ParentPin));
+		// SameRowMapping.Add(FPinLink(Frame.ParentPin, Frame.Pin));
+		// SameRowMappingDirect.Add(Frame.Pin, Frame.ParentPin);
+		// SameRowMappingDirect.Add(Frame.ParentPin, Frame.Pin);
+
+		FBAUtils::StraightenPin(GraphHandler, Frame.Pin, Frame.ParentPin);
 	}
 }
 
@@ -2,9 +2,11 @@
 
 #include "BlueprintAssistGraphHandler.h"
 
+#include "BlueprintActionDatabase.h"
 #include "BlueprintAssistCache.h"
 #include "BlueprintAssistGlobals.h"
 #include "BlueprintAssistInputProcessor.h"
+#include "BlueprintAssistNodeSizeEstimator.h"
 #include "BlueprintAssistSettings.h"
 #include "BlueprintAssistSettings_Advanced.h"
 #include "BlueprintAssistSettings_EditorFeatures.h"
@@ -20,7 +22,9 @@
 #include "ScopedTransaction.h"
 #include "SGraphPanel.h"
 #include "Algo/Transform.h"
+#include "BlueprintAssistFormatters/BAFormatterProfiler.h"
 #include "BlueprintAssistFormatters/BAFormatterUtils.h"
+#include "BlueprintAssistFormatters/BALayoutGraph.h"
 #include "BlueprintAssistFormatters/BehaviorTreeGraphFormatter.h"
 #include "BlueprintAssistFormatters/EdGraphFormatter.h"
 #include "BlueprintAssistFormatters/SimpleFormatter.h"
@@ -52,6 +56,7 @@ FBAGraphHandler::FBAGraphHandler(
 	check(GetWindow().IsValid());
 
 	FCoreUObjectDelegates::OnObjectTransacted.AddRaw(this, &FBAGraphHandler::OnObjectTransacted);
+	OnActionDatabaseUpdatedHandle = FBlueprintActionDatabase::Get().OnEntryUpdated().AddRaw(this, &FBAGraphHandler::OnActionDatabaseUpdated);
 }
 
 FBAGraphHandler::~FBAGraphHandler()
@@ -68,10 +73,11 @@ FBAGraphHandler::~FBAGraphHandler()
 	SelectedPinHandle = nullptr;
 	FocusedNode = nullptr;
 	LastSelectedNode = nullptr;
-	LastNodes.Empty();
+	GraphChanges.Reset();
 	ResetTransactions();
 
 	FCoreUObjectDelegates::OnObjectTransacted.RemoveAll(this);
+	FBlueprintActionDatabase::Get().OnEntryUpdated().Remove(OnActionDatabaseUpdatedHandle);
 }
 
 void FBAGraphHandler::InitGraphHandler()
@@ -97,6 +103,7 @@ void FBAGraphHandler::InitGraphHandler()
 
 	FormatterParameters.Reset();
 	PendingFormatting.Reset();
+	EstimatedSizeNodes.Reset();
 	PendingSize.Reset();
 	CommentBubbleSizeCache.Reset();
 	FormatAllColumns.Reset();
@@ -108,8 +115,19 @@ void FBAGraphHandler::InitGraphHandler()
 
 	CachedEdGraph.Reset();
 	CachedEdGraph = GetFocusedEdGraph();
+	NodeKdTree.MarkDirty();
+	++GraphChangeCount;
+	ActionMenuCache.Reset();
 
-	GetGraphData().CleanupGraph(GetFocusedEdGraph());
+	// only graphs already being edited are in memory, the others are cleaned up when they are first edited and saved
+	if (FBACache::Get().FindEditedGraphData(GetFocusedEdGraph()))
+	{
+		GraphCleanup.Start(GetFocusedEdGraph());
+	}
+	else
+	{
+		GraphCleanup.Reset();
+	}
 
 	GetGraphEditor()->GetViewLocation(LastGraphView, LastZoom);
 
@@ -149,7 +167,7 @@ void FBAGraphHandler::AddGraphPanelOverlay()
 
 void FBAGraphHandler::OnGraphInitializedDelayed()
 {
-	LastNodes = GetFocusedEdGraph()->Nodes;
+	GraphChanges.Bind(GetFocusedEdGraph());
 
 	if (UBASettings::Get().bDetectNewNodesAndCacheNodeSizes)
 	{
@@ -160,11 +178,11 @@ void FBAGraphHandler::OnGraphInitializedDelayed()
 	{
 		NodeSizeChangeDataMap.Add(Node->NodeGuid, FBANodeSizeChangeData(Node));
 
-		const FBANodeData& NodeData = GetNodeData(Node);
-		if (NodeData.NodeGroup.IsValid())
+		const FGuid NodeGroup = FBACache::Get().FindNodeGroup(GetFocusedEdGraph(), Node);
+		if (NodeGroup.IsValid())
 		{
 			// initialize the node groups
-			NodeGroups.FindOrAdd(NodeData.NodeGroup).Add(Node);
+			NodeGroups.FindOrAdd(NodeGroup).Add(Node);
 		}
 	}
 }
@@ -206,9 +224,11 @@ void FBAGraphHandler::Cleanup()
 
 	FormatterParameters.Reset();
 	FormatterMap.Reset();
+	GraphCleanup.Reset();
 	NodeToReplace = nullptr;
 	bLerpViewport = false;
 	NodeSizeChangeDataMap.Reset();
+	GraphChanges.Reset();
 
 	DelayedGraphInitialized.Cancel();
 	DelayedViewportZoomIn.Cancel();
@@ -458,6 +478,8 @@ void FBAGraphHandler::Tick(float DeltaTime)
 
 	UpdateCachedNodeSize(DeltaTime);
 
+	UpdateGraphCleanup();
+
 	UpdateSelectedNode();
 
 	UpdateSelectedPin();
@@ -574,8 +596,19 @@ bool FBAGraphHandler::IsGraphPanelFocused()
 		// check if the focused widget is a child of the graph panel
 		if (TSharedPtr<SWidget> FocusedWidget = FSlateApplication::Get().GetUserFocusedWidget(0))
 		{
-			TSharedPtr<SWidget> FoundGraphPanel = FBAUtils::ScanParentContainersForTypes(FocusedWidget, { "SGraphPanel" }, "SDockingTabStack");
-			if (FoundGraphPanel == Panel)
+			if (FBAUtils::IsWidgetInside(FocusedWidget, Panel))
+			{
+				return true;
+			}
+
+			// focus stays on the same widget across many key presses, only search around it when it changes
+			if (LastFocusedWidget != FocusedWidget)
+			{
+				LastFocusedWidget = FocusedWidget;
+				bLastFocusedWidgetInGraphPanel = FBAUtils::ScanParentContainersForTypes(FocusedWidget, { "SGraphPanel" }, "SDockingTabStack") == Panel;
+			}
+
+			if (bLastFocusedWidgetInGraphPanel)
 			{
 				return true;
 			}
@@ -808,27 +841,37 @@ void FBAGraphHandler::MoveUnrelatedNodes(TSharedPtr<FFormatterInterface> Formatt
 
 void FBAGraphHandler::OnGraphChanged(const FEdGraphEditAction& Action)
 {
+	NodeKdTree.MarkDirty();
+	++GraphChangeCount;
+	GraphChanges.RecordGraphChanged(Action);
 	DelayedDetectGraphChanges.StartDelay(1);
 }
 
 void FBAGraphHandler::DetectGraphChanges()
 {
+	FBAGraphDiff Diff;
+	if (!GraphChanges.Flush(Diff))
+	{
+		return;
+	}
+
+	// nodes brought back by undo were already handled when they were first added
+	if (Diff.bUndoRedo)
+	{
+		return;
+	}
+
 	TArray<UEdGraphNode*> NewNodes;
-	for (UEdGraphNode* NewNode : GetFocusedEdGraph()->Nodes)
+	for (UEdGraphNode* NewNode : Diff.AddedNodes)
 	{
 		if (FBAUtils::IsCommentNode(NewNode) || FBAUtils::IsKnotNode(NewNode))
 		{
 			continue;
 		}
 
-		if (!LastNodes.Contains(NewNode))
-		{
-			NewNodes.Add(NewNode);
-		}
+		NewNodes.Add(NewNode);
 	}
 
-	LastNodes = GetFocusedEdGraph()->Nodes;
-
 	if (NewNodes.Num() > 0)
 	{
 		OnNodesAdded(NewNodes);
@@ -965,7 +1008,7 @@ void FBAGraphHandler::CacheNodeSizes(const TArray<UEdGraphNode*>& Nodes)
 		}
 
 		// if the node size hasn't been cached, add the node to be calculated
-		if (!PendingSize.Contains(Node) && (GetNodeData(Node).CachedNodeSize.SizeSquared() == 0))
+		if (!PendingSize.Contains(Node) && !HasCachedNodeSize(Node))
 		{
 			PendingSize.Emplace(Node);
 		}
@@ -1157,8 +1200,8 @@ void FBAGraphHandler::AutoAddParentNode(UEdGraphNode* NewNode)
 				}
 			}
 
-			// We don't want to process the parent node as a new node, add it to last nodes so it will be ignored in the next check
-			LastNodes.Add(ParentFunctionNode);
+			// We don't want to process the parent node as a new node, so it will be ignored in the next check
+			GraphChanges.IgnoreNode(ParentFunctionNode);
 
 			// Always format this new custom event node (even if auto formatting is disabled)
 			AddPendingFormatNodes(NewNode);
@@ -1246,20 +1289,21 @@ FText FBAGraphHandler::GetSizeTimeoutMessage() const
 
 void FBAGraphHandler::OnObjectTransacted(UObject* Object, const FTransactionObjectEvent& Event)
 {
-	static const FName NodesChangedName(TEXT("Nodes"));
+	// dragging, formatting and undoing all move nodes inside a transaction
+	const UEdGraphNode* Node = Cast<UEdGraphNode>(Object);
+	if ((Node && Node->GetGraph() == GetFocusedEdGraph()) || Object == GetFocusedEdGraph())
+	{
+		NodeKdTree.MarkDirty();
+
+		// undo can restore the node list without the graph telling us, so flush the diff as for a graph change
+		GraphChanges.RecordTransacted(Object, Event);
+		DelayedDetectGraphChanges.StartDelay(1);
+	}
 
 	if (Event.GetEventType() == ETransactionObjectEventType::UndoRedo)
 	{
-		if ((Event.GetChangedProperties().Num() == 1) && Event.GetChangedProperties()[0].IsEqual(NodesChangedName))
-		{
-			if (UEdGraph* Graph = Cast<UEdGraph>(Object))
-			{
-				if (Graph == GetFocusedEdGraph())
-				{
-					LastNodes = GetFocusedEdGraph()->Nodes;
-				}
-			}
-		}
+		// undoing can bring back links and pins without the graph telling us
+		++GraphChangeCount;
 	}
 }
 
@@ -1311,7 +1355,7 @@ bool FBAGraphHandler::UpdateNodeSizesChanges(const TArray<UEdGraphNode*>& Nodes)
 		}
 
 		// calculate size for all connected nodes which don't have a valid size
-		const bool bHasValidSize = GetNodeData(Node).CachedNodeSize.SizeSquared() > 0;
+		const bool bHasValidSize = HasCachedNodeSize(Node);
 		if (!bHasValidSize && !PendingSize.Contains(Node))
 		{
 			PendingSize.Add(Node);
@@ -1436,6 +1480,9 @@ UEdGraphNode* FBAGraphHandler::GetRootNode(UEdGraphNode* InitialNode, const TArr
 	TArray<UEdGraphNode*> RootNodes;
 	TArray<UEdGraphNode*> ImpureNodes;
 
+	// walk the execution from the initial node once, instead of once for each node in the tree
+	const TSet<UEdGraphNode*> ExecutionFromInitialNode = FBAUtils::GetExecutionReachableNodes(InitialNode);
+
 	for (UEdGraphNode* Node : NodeTree)
 	{
 		// UE_LOG(LogTemp, Warning, TEXT("Checking Node %s"), *FBAUtils::GetNodeName(Node));
@@ -1444,7 +1491,7 @@ UEdGraphNode* FBAGraphHandler::GetRootNode(UEdGraphNode* InitialNode, const TArr
 			continue;
 		}
 
-		if (FBAUtils::IsExtraRootNode(Node) && FBAUtils::DoesNodeHaveExecutionTo(InitialNode, Node))
+		if (FBAUtils::IsExtraRootNode(Node) && FBAUtils::DoesNodeHaveExecutionTo(ExecutionFromInitialNode, Node))
 		{
 			// UE_LOG(LogTemp, Warning, TEXT("\tRoot node EXTRA %s"), *FBAUtils::GetNodeName(Node));
 			RootNodes.Add(Node);
@@ -1455,7 +1502,7 @@ UEdGraphNode* FBAGraphHandler::GetRootNode(UEdGraphNode* InitialNode, const TArr
 		{
 			ImpureNodes.Add(Node);
 
-			if (FBAUtils::IsEventNode(Node, FormatterDirection) && FBAUtils::DoesNodeHaveExecutionTo(InitialNode, Node))
+			if (FBAUtils::IsEventNode(Node, FormatterDirection) && FBAUtils::DoesNodeHaveExecutionTo(ExecutionFromInitialNode, Node))
 			{
 				// UE_LOG(LogTemp, Warning, TEXT("\tRoot node EVENT %s"), *FBAUtils::GetNodeName(Node));
 				EventNodes.Add(Node);
@@ -1464,7 +1511,7 @@ UEdGraphNode* FBAGraphHandler::GetRootNode(UEdGraphNode* InitialNode, const TArr
 
 			TArray<UEdGraphPin*> LinkedInputPins = FBAUtils::GetLinkedPins(Node, OppositeDirection).FilterByPredicate(FBAUtils::IsExecPin);
 
-			if ((LinkedInputPins.Num() == 0) && FBAUtils::DoesNodeHaveExecutionTo(InitialNode, Node))
+			if ((LinkedInputPins.Num() == 0) && FBAUtils::DoesNodeHaveExecutionTo(ExecutionFromInitialNode, Node))
 			{
 				// UE_LOG(LogTemp, Warning, TEXT("\tRoot node UNLINKED %s"), *FBAUtils::GetNodeName(Node));
 				UnlinkedNodes.Emplace(Node);
@@ -1662,6 +1709,7 @@ void FBAGraphHandler::PostFormatting(const TArray<TSharedPtr<FFormatterInterface
 	PostFormatComments(Formatters);
 
 	FormatterParameters.Reset();
+	NodeKdTree.MarkDirty();
 }
 
 void FBAGraphHandler::PostFormatComments(const TArray<TSharedPtr<FFormatterInterface>>& Formatters)
@@ -1780,6 +1828,41 @@ bool FBAGraphHandler::FilterDelegatePin(const FPinLink& PinLink, const TArray<UE
 	return FBAUtils::IsNodePure(PinLink.From->GetOwningNode()) || FBAUtils::IsNodePure(PinLink.To->GetOwningNode());
 }
 
+const FBANodeKdTree& FBAGraphHandler::GetNodeKdTree()
+{
+	UEdGraph* Graph = GetFocusedEdGraph();
+	if (Graph == nullptr)
+	{
+		static const FBANodeKdTree EmptyTree;
+		return EmptyTree;
+	}
+
+	// a node moved outside of a transaction is only noticed once the node count changes
+	if (NodeKdTree.IsDirty() || NodeKdTree.Num() != Graph->Nodes.Num())
+	{
+		NodeKdTree.Build(Graph->Nodes);
+	}
+
+	return NodeKdTree;
+}
+
+FBAPinCompatibilityIndex& FBAGraphHandler::GetPinCompatibilityIndex()
+{
+	if (PinCompatibilityIndexChangeCount != GraphChangeCount)
+	{
+		PinCompatibilityIndex.Build(GetFocusedEdGraph());
+		PinCompatibilityIndexChangeCount = GraphChangeCount;
+	}
+
+	return PinCompatibilityIndex;
+}
+
+void FBAGraphHandler::OnActionDatabaseUpdated(UObject* Object)
+{
+	// new variables, functions and events change the actions, not the graph
+	++GraphChangeCount;
+}
+
 FBAGraphData& FBAGraphHandler::GetGraphData()
 {
 	return FBACache::Get().GetGraphData(GetFocusedEdGraph());
@@ -1790,6 +1873,12 @@ FBANodeData& FBAGraphHandler::GetNodeData(UEdGraphNode* Node)
 	return GetGraphData().GetNodeData(Node);
 }
 
+bool FBAGraphHandler::HasCachedNodeSize(UEdGraphNode* Node)
+{
+	FVector2D CachedNodeSize;
+	return FBACache::Get().FindNodeSize(GetFocusedEdGraph(), Node, CachedNodeSize);
+}
+
 TSet<UEdGraphNode*> FBAGraphHandler::GetNodeGroup(const FGuid& GroupID)
 {
 	TSet<UEdGraphNode*> OutNodeGroup;
@@ -1985,6 +2074,41 @@ FSlateRect FBAGraphHandler::GetCachedNodeBounds(UEdGraphNode* Node, bool bWithCo
 
 	FVector2D Pos(Node->NodePosX, Node->NodePosY);
 
+	FVector2D Size;
+	FVector2D CommentBubbleSize;
+
+	const int32 LayoutIndex = FormatterLayout ? FormatterLayout->FindNode(Node) : INDEX_NONE;
+	if (LayoutIndex != INDEX_NONE)
+	{
+		Size = FormatterLayout->GetNodeSize(LayoutIndex);
+		CommentBubbleSize = FormatterLayout->GetCommentBubbleSize(LayoutIndex);
+	}
+	else
+	{
+		Size = ReadNodeSize(Node);
+
+		// skip comment bubbles since when we access this function for comments, we are actually grabbing the title bar bounds 
+		const FVector2D* CommentBubbleSizePtr = !FBAUtils::IsCommentNode(Node) ? CommentBubbleSizeCache.Find(Node) : nullptr;
+		CommentBubbleSize = CommentBubbleSizePtr ? *CommentBubbleSizePtr : FVector2D::ZeroVector;
+
+		if (FormatterLayout)
+		{
+			FormatterLayout->AddNode(Node, Size, CommentBubbleSize);
+		}
+	}
+
+	if (bWithCommentBubble && !CommentBubbleSize.IsZero() && Node->bCommentBubbleVisible)
+	{
+		Pos.Y -= CommentBubbleSize.Y;
+		Size.Y += CommentBubbleSize.Y;
+		Size.X = FMath::Max(Size.X, CommentBubbleSize.X);
+	}
+
+	return FSlateRect::FromPointAndExtent(Pos, Size);
+}
+
+FVector2D FBAGraphHandler::ReadNodeSize(UEdGraphNode* Node)
+{
 	FVector2D Size(300, 150);
 	if (FBAUtils::IsKnotNode(Node))
 	{
@@ -1993,11 +2117,11 @@ FSlateRect FBAGraphHandler::GetCachedNodeBounds(UEdGraphNode* Node, bool bWithCo
 	}
 	else
 	{
-		FBANodeData& FoundNodeData = GetNodeData(Node);
-		if (!FoundNodeData.CachedNodeSize.IsZero())
+		FVector2D CachedNodeSize;
+		if (FBACache::Get().FindNodeSize(GetFocusedEdGraph(), Node, CachedNodeSize))
 		{
-			Size.X = FoundNodeData.CachedNodeSize.X;
-			Size.Y = FoundNodeData.CachedNodeSize.Y;
+			Size.X = CachedNodeSize.X;
+			Size.Y = CachedNodeSize.Y;
 		}
 		else
 		{
@@ -2005,23 +2129,14 @@ FSlateRect FBAGraphHandler::GetCachedNodeBounds(UEdGraphNode* Node, bool bWithCo
 			{
 				Size = GraphNode->GetDesiredSize();
 			}
+			else
+			{
+				Size = FBANodeSizeEstimator::EstimateNodeSize(Node);
+			}
 		}
 	}
 
-	// skip comment bubbles since when we access this function for comments, we are actually grabbing the title bar bounds 
-	if (!FBAUtils::IsCommentNode(Node))
-	{
-		FVector2D* CommentBubbleSizePtr = CommentBubbleSizeCache.Find(Node);
-		if (bWithCommentBubble && CommentBubbleSizePtr != nullptr && Node->bCommentBubbleVisible)
-		{
-			const FVector2D CommentBubbleSize = *CommentBubbleSizePtr;
-			Pos.Y -= CommentBubbleSize.Y;
-			Size.Y += CommentBubbleSize.Y;
-			Size.X = FMath::Max(Size.X, CommentBubbleSize.X);
-		}
-	}
-
-	return FSlateRect::FromPointAndExtent(Pos, Size);
+	return Size;
 }
 
 UEdGraphPin* FBAGraphHandler::GetSelectedPin()
@@ -2147,10 +2262,27 @@ float FBAGraphHandler::GetPinY(const UEdGraphPin* Pin)
 		return 0;
 	}
 
-	const FBANodeData& FoundNodeData = GetNodeData(OwningNode);
-	if (const float* FoundPinOffset = FoundNodeData.CachedPins.Find(Pin->PinId))
+	float PinOffset = 0.0f;
+	if (FormatterLayout && FormatterLayout->FindPinOffset(Pin, PinOffset))
+	{
+		return OwningNode->NodePosY + PinOffset;
+	}
+
+	PinOffset = ReadPinOffset(OwningNode, Pin);
+	if (FormatterLayout)
 	{
-		return OwningNode->NodePosY + *FoundPinOffset;
+		FormatterLayout->AddPinOffset(Pin, PinOffset);
+	}
+
+	return OwningNode->NodePosY + PinOffset;
+}
+
+float FBAGraphHandler::ReadPinOffset(UEdGraphNode* OwningNode, const UEdGraphPin* Pin)
+{
+	float FoundPinOffset = 0.0f;
+	if (FBACache::Get().FindPinOffset(GetFocusedEdGraph(), OwningNode, Pin->PinId, FoundPinOffset))
+	{
+		return FoundPinOffset;
 	}
 
 	// cache pin offset
@@ -2165,13 +2297,35 @@ float FBAGraphHandler::GetPinY(const UEdGraphPin* Pin)
 			{
 				if (GraphPin->GetPinObj() != nullptr)
 				{
-					return OwningNode->NodePosY + GraphPin->GetNodeOffset().Y;
+					return GraphPin->GetNodeOffset().Y;
 				}
 			}
 		}
 	}
 
-	return OwningNode->NodePosY;
+	return FBANodeSizeEstimator::EstimatePinOffset(OwningNode, Pin);
+}
+
+void FBAGraphHandler::UpdateGraphCleanup()
+{
+	if (!GraphCleanup.IsRunning())
+	{
+		return;
+	}
+
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FBAGraphHandler::UpdateGraphCleanup"), STAT_BA_UpdateGraphCleanup, STATGROUP_BA_EdGraphFormatter);
+
+	// nodes and cached entries visited per frame
+	constexpr int32 CleanupBudget = 512;
+
+	if (FBAGraphData* EditedGraphData = FBACache::Get().FindEditedGraphData(GraphCleanup.GetGraph()))
+	{
+		GraphCleanup.Step(*EditedGraphData, CleanupBudget);
+	}
+	else
+	{
+		GraphCleanup.Reset();
+	}
 }
 
 void FBAGraphHandler::UpdateCachedNodeSize(float DeltaTime)
@@ -2186,6 +2340,8 @@ void FBAGraphHandler::UpdateCachedNodeSize(float DeltaTime)
 		return;
 	}
 
+	FBAFormatterPhaseScope PhaseScope(EBAFormatterPhase::NodeSize);
+
 	TSharedPtr<SGraphEditor> GraphEditor = GetGraphEditor();
 	if (!GraphEditor.IsValid())
 	{
@@ -2304,6 +2460,12 @@ void FBAGraphHandler::UpdateCachedNodeSize(float DeltaTime)
 		return;
 	}
 
+	// every node widget is at full detail now, measure all of them instead of only those in view
+	if (!UBASettings::Get().bSlowButAccurateSizeCaching)
+	{
+		CacheNodeSizesInPrepass();
+	}
+
 	// cache node sizes
 	TArray<UEdGraphNode*> NodesCalculated;
 	for (UEdGraphNode* Node : PendingSize)
@@ -2398,6 +2560,28 @@ void FBAGraphHandler::UpdateCachedNodeSize(float DeltaTime)
 
 void FBAGraphHandler::UpdateNodesRequiringFormatting()
 {
+	// every size is measured now, redo the layouts which were made with estimated sizes
+	if (PendingSize.Num() == 0 && EstimatedSizeNodes.Num() > 0)
+	{
+		for (TWeakObjectPtr<UEdGraphNode> WeakNode : EstimatedSizeNodes)
+		{
+			UEdGraphNode* Node = WeakNode.Get();
+			if (!Node || FBAUtils::IsNodeDeleted(Node))
+			{
+				continue;
+			}
+
+			if (TSharedPtr<FFormatterInterface>* Formatter = FormatterMap.Find(GetRootNode(Node, TArray<UEdGraphNode*>())))
+			{
+				StaticCastSharedPtr<FEdGraphFormatter>(*Formatter)->MarkNodeResized(Node);
+			}
+
+			PendingFormatting.Add(Node);
+		}
+
+		EstimatedSizeNodes.Reset();
+	}
+
 	if ((PendingFormatting.Num() == 0) && (FormatAllColumns.Num() == 0))
 	{
 		return;
@@ -2409,30 +2593,44 @@ void FBAGraphHandler::UpdateNodesRequiringFormatting()
 		PendingFormatting.Remove(Node);
 	}
 
-	if (PendingSize.Num() > 0)
+	// format all still waits for every size, it can move far more nodes than a later pass would want to fix up
+	const bool bUseEstimatedSizes = UBASettings::Get().bFormatWithEstimatedNodeSizes && FormatAllColumns.Num() == 0;
+
+	if (PendingSize.Num() > 0 && !bUseEstimatedSizes)
 	{
 		return;
 	}
 
-	TArray<UEdGraphNode*> NodesWithoutSize = PendingFormatting.Array().FilterByPredicate([&](UEdGraphNode* Node) { return !GetNodeData(Node).HasSize(); });
+	TArray<UEdGraphNode*> NodesWithoutSize = PendingFormatting.Array().FilterByPredicate([&](UEdGraphNode* Node) { return !HasCachedNodeSize(Node); });
 
 	if (NodesWithoutSize.Num() > 0)
 	{
 		bool bPendingSize = false;
+		TSet<UEdGraphNode*> CheckedNodes;
 		for (UEdGraphNode* Pending : PendingFormatting)
 		{
+			// pending nodes in a tree already checked share the same tree
+			if (CheckedNodes.Contains(Pending))
+			{
+				continue;
+			}
+
 			TSet<UEdGraphNode*> NodeTree = FBAUtils::GetNodeTree(Pending);
+			CheckedNodes.Append(NodeTree);
 			bPendingSize |= UpdateNodeSizesChanges(NodeTree.Array());
 		}
 
-		if (bPendingSize)
+		if (bPendingSize && !bUseEstimatedSizes)
 		{
 			return;
 		}
 	}
 
+	// sizes and pin offsets hold still while formatting, read each from the cache once for the whole pass
+	FormatterLayout = MakeUnique<FBALayoutGraph>();
+
 	// format dirty nodes
-	TArray<UEdGraphNode*> NodesToFormatCopy = PendingFormatting.Array().FilterByPredicate([&](UEdGraphNode* Node) { return GetNodeData(Node).HasSize(); });
+	TArray<UEdGraphNode*> NodesToFormatCopy = PendingFormatting.Array().FilterByPredicate([&](UEdGraphNode* Node) { return bUseEstimatedSizes || HasCachedNodeSize(Node); });
 
 	int CountError = NodesToFormatCopy.Num();
 
@@ -2463,6 +2661,11 @@ void FBAGraphHandler::UpdateNodesRequiringFormatting()
 			{
 				PendingFormatting.Remove(Node);
 				NodesToFormatCopy.Remove(Node);
+
+				if (bUseEstimatedSizes && (PendingSize.Contains(Node) || !HasCachedNodeSize(Node)))
+				{
+					EstimatedSizeNodes.Add(Node);
+				}
 			}
 		}
 
@@ -2492,6 +2695,7 @@ void FBAGraphHandler::UpdateNodesRequiringFormatting()
 		}
 	}
 
+	FormatterLayout.Reset();
 	FormatterParameters.Reset();
 	PendingTransaction.Reset();
 }
@@ -2542,27 +2746,34 @@ void FBAGraphHandler::SimpleFormatAll()
 			continue;
 		}
 
-		// offset column x by the comment
-		float CommentOffset = 0;
+		TArray<FBAFormatAllTree> ColumnTrees;
+		ColumnTrees.Reserve(ColumnFormatters.Num());
 		for (TSharedPtr<FFormatterInterface> Formatter : ColumnFormatters)
 		{
-			TSet<UEdGraphNode*> FormatterNodes = Formatter->GetFormattedNodes();
-			FSlateRect CommentBounds = FBAUtils::GetCachedNodeArrayBoundsWithComments(AsShared(), Formatter->GetCommentHandler(), Formatter->GetFormattedNodes().Array());
-			FSlateRect NodeBounds = FBAUtils::GetCachedNodeArrayBounds(AsShared(), Formatter->GetFormattedNodes().Array());
+			ColumnTrees.Emplace(AsShared(), Formatter);
+		}
+
+		TArray<FBAFormatAllTree*> CurrentColumn;
 
+		// offset column x by the comment
+		float CommentOffset = 0;
+		for (FBAFormatAllTree& Tree : ColumnTrees)
+		{
 			if (!bFirstColumn) // don't use comment offset on the first column 
 			{
-				CommentOffset = FMath::Max(CommentOffset, NodeBounds.Left - CommentBounds.Left);
+				CommentOffset = FMath::Max(CommentOffset, Tree.NodeBounds.Left - Tree.Bounds.Left);
 			}
+
+			CurrentColumn.Add(&Tree);
 		}
 
 		ColumnX += CommentOffset;
 
 		// position the formatters at the correctly column X
-		FormatColumn(ColumnFormatters, ColumnX);
+		FormatColumn(CurrentColumn, ColumnX);
 
 		// calculate the new x position for the next column
-		FSlateRect ColumnBounds = FBAFormatterUtils::GetFormatterArrayBounds(ColumnFormatters, AsShared(), UBASettings::Get().bApplyCommentPadding);
+		FSlateRect ColumnBounds = FBAFormatAllTree::GetGroupedBounds(CurrentColumn);
 		ColumnX = ColumnBounds.Right + UBASettings::Get().FormatAllPadding.X;
 		ColumnX = FBAUtils::AlignTo8x8Grid(ColumnX, EBARoundingMethod::Ceil);
 
@@ -2588,12 +2799,7 @@ void FBAGraphHandler::SimpleFormatAll()
 
 void FBAGraphHandler::SmartFormatAll()
 {
-	TSharedPtr<FBACommentContainsGraph> MasterContainsGraph = MakeShared<FBACommentContainsGraph>();
-	MasterContainsGraph->Init(AsShared());
-	MasterContainsGraph->BuildCommentTree();
-
 	TArray<TSharedPtr<FFormatterInterface>> AllFormatterSaved;
-	TArray<TSharedPtr<FFormatterInterface>> AllFormatters;
 
 	// format all the nodes
 	TSet<UEdGraphNode*> PreviouslyFormattedNodes;
@@ -2613,71 +2819,77 @@ void FBAGraphHandler::SmartFormatAll()
 		PreviouslyFormattedNodes.Append(Formatter->GetFormattedNodes());
 	}
 
-	AllFormatters = AllFormatterSaved;
-
-	int NumColumns = 0;
-	float ColumnX = 0;
+	// measure each node-tree once, placing the columns below only moves them
+	TArray<FBAFormatAllTree> AllTrees;
+	AllTrees.Reserve(AllFormatterSaved.Num());
+	for (TSharedPtr<FFormatterInterface> Formatter : AllFormatterSaved)
+	{
+		AllTrees.Emplace(AsShared(), Formatter);
+	}
 
-	while (AllFormatters.Num() > 0)
+	TArray<FBAFormatAllTree*> PendingTrees;
+	for (FBAFormatAllTree& Tree : AllTrees)
 	{
-		TArray<TSharedPtr<FFormatterInterface>> AllFormattersCopy = AllFormatters;
+		PendingTrees.Add(&Tree);
+	}
 
-		// sort formatted nodes by left most
-		AllFormattersCopy.Sort([](TSharedPtr<FFormatterInterface> FormatterA, TSharedPtr<FFormatterInterface> FormatterB)
+	// sort formatted nodes by left most, trees only move once they are placed so this order holds for every column
+	PendingTrees.Sort([](const FBAFormatAllTree& TreeA, const FBAFormatAllTree& TreeB)
+	{
+		if (TreeA.RootNode->NodePosX != TreeB.RootNode->NodePosX)
 		{
-			UEdGraphNode* RootA = FormatterA->GetRootNode();
-			UEdGraphNode* RootB = FormatterB->GetRootNode();
-			if (RootA->NodePosX != RootB->NodePosX)
-			{
-				return RootA->NodePosX < RootB->NodePosX;
-			}
+			return TreeA.RootNode->NodePosX < TreeB.RootNode->NodePosX;
+		}
 
-			return RootA->NodePosY < RootB->NodePosY;
-		});
+		return TreeA.RootNode->NodePosY < TreeB.RootNode->NodePosY;
+	});
 
+	int NumColumns = 0;
+	float ColumnX = 0;
+
+	while (PendingTrees.Num() > 0)
+	{
 		TOptional<float> RightMost;
-		TArray<TSharedPtr<FFormatterInterface>> CurrentColumn;
+		TArray<FBAFormatAllTree*> CurrentColumn;
+		TArray<FBAFormatAllTree*> RemainingTrees;
 
 		float CommentOffset = 0;
 
 		// create columns by checking for overlapping formatted node-trees
-		for (TSharedPtr<FFormatterInterface> Formatter : AllFormattersCopy)
+		for (FBAFormatAllTree* Tree : PendingTrees)
 		{
-			TSet<UEdGraphNode*> FormatterNodes = Formatter->GetFormattedNodes();
-			FSlateRect CommentBounds = FBAUtils::GetCachedNodeArrayBoundsWithComments(AsShared(), Formatter->GetCommentHandler(), Formatter->GetFormattedNodes().Array());
-			FSlateRect NodeBounds = FBAUtils::GetCachedNodeArrayBounds(AsShared(), Formatter->GetFormattedNodes().Array());
-			FSlateRect Bounds = UBASettings::Get().bApplyCommentPadding ? CommentBounds : NodeBounds;
-
 			if (!RightMost.IsSet())
 			{
-				RightMost = Bounds.Right;
+				RightMost = Tree->Bounds.Right;
 			}
-			else if (Bounds.Left < RightMost.GetValue())
+			else if (Tree->Bounds.Left < RightMost.GetValue())
 			{
-				RightMost = FMath::Max(RightMost.GetValue(), Bounds.Right);
+				RightMost = FMath::Max(RightMost.GetValue(), Tree->Bounds.Right);
 			}
 			else
 			{
 				// this node is not in this column, skip it
+				RemainingTrees.Add(Tree);
 				continue;
 			}
 
 			if (NumColumns > 0)
 			{
-				CommentOffset = FMath::Max(CommentOffset, NodeBounds.Left - CommentBounds.Left);
+				CommentOffset = FMath::Max(CommentOffset, Tree->NodeBounds.Left - Tree->Bounds.Left);
 			}
 
-			CurrentColumn.Add(Formatter);
-			AllFormatters.Remove(Formatter);
+			CurrentColumn.Add(Tree);
 		}
 
-		GraphOverlay->DrawBounds(FBAFormatterUtils::GetFormatterArrayBounds(CurrentColumn, AsShared(), true));
+		PendingTrees = MoveTemp(RemainingTrees);
+
+		GraphOverlay->DrawBounds(FBAFormatAllTree::GetGroupedBounds(CurrentColumn));
 
 		ColumnX += CommentOffset;
 
 		FormatColumn(CurrentColumn, ColumnX);
 
-		FSlateRect ColumnBounds = FBAFormatterUtils::GetFormatterArrayBounds(CurrentColumn, AsShared(), UBASettings::Get().bApplyCommentPadding);
+		FSlateRect ColumnBounds = FBAFormatAllTree::GetGroupedBounds(CurrentColumn);
 		ColumnX = ColumnBounds.Right + UBASettings::Get().FormatAllPadding.X;
 		ColumnX = FBAUtils::AlignTo8x8Grid(ColumnX, EBARoundingMethod::Ceil);
 		NumColumns += 1;
@@ -2700,37 +2912,27 @@ void FBAGraphHandler::SmartFormatAll()
 	PostFormatting(AllFormatterSaved);
 }
 
-void FBAGraphHandler::FormatColumn(TArray<TSharedPtr<FFormatterInterface>>& CurrentColumn, float ColumnX)
+void FBAGraphHandler::FormatColumn(TArray<FBAFormatAllTree*>& CurrentColumn, float ColumnX)
 {
 	ColumnX = FBAUtils::SnapToGrid(ColumnX);
 	ColumnX = FBAUtils::AlignTo8x8Grid(ColumnX);
-	
-
-	// UE_LOG(LogTemp, Warning, TEXT("Column X %f"), ColumnX);
 
 	// Sort the column by height
-	CurrentColumn.Sort([](TSharedPtr<FFormatterInterface> FormatterA, TSharedPtr<FFormatterInterface> FormatterB)
+	CurrentColumn.Sort([](const FBAFormatAllTree& TreeA, const FBAFormatAllTree& TreeB)
 	{
-		UEdGraphNode* RootA = FormatterA->GetRootNode();
-		UEdGraphNode* RootB = FormatterB->GetRootNode();
-		if (RootA->NodePosY != RootB->NodePosY)
+		if (TreeA.RootNode->NodePosY != TreeB.RootNode->NodePosY)
 		{
-			return RootA->NodePosY < RootB->NodePosY;
+			return TreeA.RootNode->NodePosY < TreeB.RootNode->NodePosY;
 		}
 
-		return RootA->NodePosX < RootB->NodePosX;
+		return TreeA.RootNode->NodePosX < TreeB.RootNode->NodePosX;
 	});
 
 	TOptional<FSlateRect> FormattedBounds;
 
 	// position the node-trees into columns
-	for (TSharedPtr<FFormatterInterface> Formatter : CurrentColumn)
+	for (FBAFormatAllTree* Tree : CurrentColumn)
 	{
-		FSlateRect CommentBounds = FBAUtils::GetCachedNodeArrayBoundsWithComments(AsShared(), Formatter->GetCommentHandler(), Formatter->GetFormattedNodes().Array());
-		FSlateRect NodeBounds = FBAUtils::GetCachedNodeArrayBounds(AsShared(), Formatter->GetFormattedNodes().Array());
-
-		FSlateRect CurrentBounds = UBASettings::Get().bApplyCommentPadding ? CommentBounds : NodeBounds;
-
 		// align the position of the formatted nodes to the column
 		float Left = 0;
 		float Top = 0;
@@ -2739,65 +2941,36 @@ void FBAGraphHandler::FormatColumn(TArray<TSharedPtr<FFormatterInterface>>& Curr
 		{
 			case EBAFormatAllHorizontalAlignment::RootNode:
 			{
-				Left = NodeBounds.Left;
-				Top = NodeBounds.Top;
+				Left = Tree->NodeBounds.Left;
+				Top = Tree->NodeBounds.Top;
 				break;
 			}
 			case EBAFormatAllHorizontalAlignment::Comment:
 			{
-				Left = CurrentBounds.Left;
-				Top = CurrentBounds.Top;
+				Left = Tree->Bounds.Left;
+				Top = Tree->Bounds.Top;
 			}
 			break;
 			default: ;
 		}
 
-		int32 DeltaX = ColumnX - Left;
-		// DeltaX = FBAUtils::SnapToGrid(Left + DeltaX) - Left;
-
-		// offset the first formatted node's Y position to zero
-		const int32 DeltaY = !FormattedBounds.IsSet() ? 0 - Top : 0;
-
-		for (auto FormattedNode : Formatter->GetFormattedNodes())
-		{
-			FormattedNode->NodePosX += DeltaX;
-			FormattedNode->NodePosY += DeltaY;
-		}
-
-		CurrentBounds = UBASettings::Get().bApplyCommentPadding
-			? FBAUtils::GetCachedNodeArrayBoundsWithComments(AsShared(), Formatter->GetCommentHandler(), Formatter->GetFormattedNodes().Array())
-			: FBAUtils::GetCachedNodeArrayBounds(AsShared(), Formatter->GetFormattedNodes().Array());
+		const int32 DeltaX = ColumnX - Left;
 
-		NodeBounds = FBAUtils::GetCachedNodeArrayBounds(AsShared(), Formatter->GetFormattedNodes().Array());
-
-		if (!FormattedBounds.IsSet())
-		{
-			FormattedBounds = CurrentBounds;
-		}
-		else
+		// offset the first formatted node's Y position to zero, stack the rest below it
+		int32 DeltaY = 0 - Top;
+		if (FormattedBounds.IsSet())
 		{
 			float Bottom = FormattedBounds->Bottom + UBASettings::Get().FormatAllPadding.Y;
 			Bottom = FBAUtils::AlignTo8x8Grid(Bottom, EBARoundingMethod::Ceil);
 
-			float Delta = Bottom - CurrentBounds.Top;
-
-			float OldRootPos = Formatter->GetRootNode()->NodePosY;
-			const float RootNewPos = FBAUtils::AlignTo8x8Grid(OldRootPos + Delta, EBARoundingMethod::Ceil);
-			Delta = RootNewPos - OldRootPos;
-
-			for (UEdGraphNode* FormattedNode : Formatter->GetFormattedNodes())
-			{
-				FormattedNode->NodePosY += Delta;
-			}
-
-			CurrentBounds = UBASettings::Get().bApplyCommentPadding
-				? FBAUtils::GetCachedNodeArrayBoundsWithComments(AsShared(), Formatter->GetCommentHandler(), Formatter->GetFormattedNodes().Array())
-				: FBAUtils::GetCachedNodeArrayBounds(AsShared(), Formatter->GetFormattedNodes().Array());
-
-			FormattedBounds = FormattedBounds->Expand(CurrentBounds);
+			const float OldRootPos = Tree->RootNode->NodePosY;
+			const float RootNewPos = FBAUtils::AlignTo8x8Grid(OldRootPos + Bottom - Tree->Bounds.Top, EBARoundingMethod::Ceil);
+			DeltaY = RootNewPos - OldRootPos;
 		}
 
-		// UE_LOG(LogBlueprintAssist, Warning, TEXT("\t%s"), *FBAUtils::GetNodeName(Formatter->GetRootNode()));
+		Tree->Translate(DeltaX, DeltaY);
+
+		FormattedBounds = FormattedBounds.IsSet() ? FormattedBounds->Expand(Tree->Bounds) : Tree->Bounds;
 	}
 }
 
@@ -2908,10 +3081,11 @@ void FBAGraphHandler::RefreshNodeSize(UEdGraphNode* Node)
 
 		UEdGraphNode* NodeToFormat = GetRootNode(Node, TArray<UEdGraphNode*>());
 
-		if (FormatterMap.Contains(NodeToFormat))
+		// keep the formatter so the parameter branches which do not hold this node keep their last layout
+		if (TSharedPtr<FFormatterInterface>* Formatter = FormatterMap.Find(NodeToFormat))
 		{
-			FormatterMap[NodeToFormat].Reset();
-			FormatterMap.Remove(NodeToFormat);
+			// only blueprint graphs store their formatters
+			StaticCastSharedPtr<FEdGraphFormatter>(*Formatter)->MarkNodeResized(Node);
 		}
 	}
 	else if (FBAUtils::IsCommentNode(Node))
@@ -3019,15 +3193,17 @@ void FBAGraphHandler::FormatAllEvents()
 
 	bool bHasNodeToFormat = false;
 
+	TSet<UEdGraphNode*> RefreshedNodes;
 	for (int i = 0; i < FormatAllColumns.Num(); ++i)
 	{
 		TArray<UEdGraphNode*>& Column = FormatAllColumns[i];
 
 		for (UEdGraphNode* Node : Column)
 		{
-			if (UBASettings::Get().bRefreshNodeSizeBeforeFormatting)
+			if (UBASettings::Get().bRefreshNodeSizeBeforeFormatting && !RefreshedNodes.Contains(Node))
 			{
 				TSet<UEdGraphNode*> NodeTree = FBAUtils::GetNodeTree(Node);
+				RefreshedNodes.Append(NodeTree);
 				UpdateNodeSizesChanges(NodeTree.Array());
 			}
 		}
@@ -3174,6 +3350,8 @@ TSharedPtr<FFormatterInterface> FBAGraphHandler::FormatNodes(UEdGraphNode* Node,
 
 	if (Formatter.IsValid())
 	{
+		FBAFormatterProfiler::Get().BeginRun(EdGraph, NodeToFormat);
+
 		if (!bUsingFormatAll)
 		{
 			PreFormatting();
@@ -3190,6 +3368,8 @@ TSharedPtr<FFormatterInterface> FBAGraphHandler::FormatNodes(UEdGraphNode* Node,
 		{
 			PostFormatting({ Formatter });
 		}
+
+		FBAFormatterProfiler::Get().EndRun(Formatter->GetFormattedNodes().Num());
 	}
 
 	return Formatter;
@@ -3199,6 +3379,7 @@ void FBAGraphHandler::CancelActiveFormatting()
 {
 	PendingSize.Reset();
 	PendingFormatting.Reset();
+	EstimatedSizeNodes.Reset();
 	ResetTransactions();
 
 	CancelSizeTimeoutNotification(false);
@@ -3264,23 +3445,103 @@ bool FBAGraphHandler::CacheNodeSize(UEdGraphNode* Node)
 
 	if (bAllPinsCached)
 	{
-		if (!Node->IsAutomaticallyPlacedGhostNode() && Node->bCommentBubbleVisible)
+		CacheCommentBubbleSize(Node, GraphNode);
+
+		NodeData.CachedNodeSize = Size;
+		return true;
+	}
+
+	return false;
+}
+
+void FBAGraphHandler::CacheNodeSizesInPrepass()
+{
+	TSet<UEdGraphNode*> NodesCalculated;
+	for (UEdGraphNode* Node : PendingSize)
+	{
+		// comment sizes are only reliable for the focused node, leave them to the regular pass
+		if (FBAUtils::IsNodeDeleted(Node) || FBAUtils::IsCommentNode(Node))
+		{
+			continue;
+		}
+
+		TSharedPtr<SGraphNode> GraphNode = GetGraphNode(Node);
+		if (!GraphNode.IsValid() || FBAUtils::IsNodeBeingRenamed(GraphNode))
+		{
+			continue;
+		}
+
+		// nodes out of view are not painted so their desired size may be stale, the prepass updates it
+		GraphNode->SlatePrepass(1.0f);
+
+		const FVector2D Size = GraphNode->GetDesiredSize();
+		if (Size.SizeSquared() <= 0)
+		{
+			continue;
+		}
+
+		// the pins' cached offsets are also only updated when painted, instead lay the node out at its origin
+		// and read the pin offsets from the arranged geometry
+		TArray<TSharedRef<SWidget>> PinWidgets;
+		GraphNode->GetPins(PinWidgets);
+
+		TSet<TSharedRef<SWidget>> PinsToFind;
+		PinsToFind.Append(PinWidgets);
+
+		TMap<TSharedRef<SWidget>, FArrangedWidget> PinGeometries;
+		GraphNode->FindChildGeometries(FGeometry::MakeRoot(Size, FSlateLayoutTransform()), PinsToFind, PinGeometries);
+
+		ApplyCommentBubblePinned(Node);
+
+		FBANodeData& NodeData = GetNodeData(Node);
+		NodeData.ResetSize();
+
+		// hidden pins are not arranged and keep no offset, same as a pin which was never drawn
+		for (const auto& Elem : PinGeometries)
 		{
-			SNodePanel::SNode::FNodeSlot* CommentSlot = GraphNode->GetSlot(ENodeZone::TopCenter);
-			if (CommentSlot != nullptr)
+			if (UEdGraphPin* Pin = StaticCastSharedRef<SGraphPin>(Elem.Key)->GetPinObj())
 			{
-				TSharedPtr<SCommentBubble> CommentBubble = StaticCastSharedRef<SCommentBubble>(CommentSlot->GetWidget());
-				if (CommentBubble.IsValid() && CommentBubble->IsBubbleVisible())
-				{
-					FVector2D CommentBubbleSize = CommentBubble->GetDesiredSize();
-					CommentBubbleSizeCache.Add(Node, CommentBubbleSize);
-				}
+				NodeData.CachedPins.Add(Pin->PinId, Elem.Value.Geometry.GetAbsolutePosition().Y);
 			}
 		}
 
+		CacheCommentBubbleSize(Node, GraphNode);
+
 		NodeData.CachedNodeSize = Size;
-		return true;
+		NodesCalculated.Add(Node);
 	}
 
-	return false;
+	if (NodesCalculated.Num() == 0)
+	{
+		return;
+	}
+
+	PendingSize.RemoveAll([&NodesCalculated](UEdGraphNode* Node)
+	{
+		return NodesCalculated.Contains(Node);
+	});
+
+	if (NodesCalculated.Contains(FocusedNode) && SizeTimeoutNotification.IsValid())
+	{
+		SizeTimeoutNotification.Pin()->SetText(FText::FromString("Successfully calculated size"));
+		SizeTimeoutNotification.Pin()->ExpireAndFadeout();
+		SizeTimeoutNotification.Pin()->SetCompletionState(SNotificationItem::CS_Success);
+	}
+}
+
+void FBAGraphHandler::CacheCommentBubbleSize(UEdGraphNode* Node, TSharedPtr<SGraphNode> GraphNode)
+{
+	if (!Node->IsAutomaticallyPlacedGhostNode() && Node->bCommentBubbleVisible)
+	{
+		SNodePanel::SNode::FNodeSlot* CommentSlot = GraphNode->GetSlot(ENodeZone::TopCenter);
+		if (CommentSlot != nullptr)
+		{
+			TSharedPtr<SCommentBubble> CommentBubble = StaticCastSharedRef<SCommentBubble>(CommentSlot->GetWidget());
+			if (CommentBubble.IsValid() && CommentBubble->IsBubbleVisible())
+			{
+				FVector2D CommentBubbleSize = CommentBubble->GetDesiredSize();
+				CommentBubbleSizeCache.Add(Node, CommentBubbleSize);
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -52,6 +52,10 @@ FBAInputProcessor::FBAInputProcessor()
 
 	FSlateApplication::Get().OnApplicationActivationStateChanged().AddRaw(this, &FBAInputProcessor::OnWindowFocusChanged);
 
+	OnUserDefinedChordChangedHandle = FInputBindingManager::Get().RegisterUserDefinedChordChanged(
+		FOnUserDefinedChordChanged::FDelegate::CreateRaw(this, &FBAInputProcessor::OnUserDefinedChordChanged));
+	OnCommandsChangedHandle = FBindingContext::CommandsChanged.AddRaw(this, &FBAInputProcessor::OnCommandsChanged);
+
 	CommandLists = {
 		GlobalActions.GlobalCommands,
 		TabActions.TabCommands,
@@ -78,6 +82,9 @@ void FBAInputProcessor::Cleanup()
 		FSlateApplication::Get().UnregisterInputPreProcessor(BAInputProcessorInstance);
 	}
 
+	FInputBindingManager::Get().UnregisterUserDefinedChordChanged(OnUserDefinedChordChangedHandle);
+	FBindingContext::CommandsChanged.Remove(OnCommandsChangedHandle);
+
 	BAInputProcessorInstance.Reset();
 }
 
@@ -417,7 +424,8 @@ bool FBAInputProcessor::HandleMouseButtonUpEvent(FSlateApplication& SlateApp, co
 
 bool FBAInputProcessor::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
 {
-	if (IsDisabled())
+	// nothing to drag, skip the graph lookups (the anchor seeds LastMousePos when it is set)
+	if (IsDisabled() || !AnchorNode.IsValid())
 	{
 		return false;
 	}
@@ -535,6 +543,8 @@ bool FBAInputProcessor::BeginGroupMovement(const FKey& Key)
 			// set the anchor node for group movement
 			AnchorNode = HoveredNodeObj;
 			LastAnchorPos = HoveredNode->GetPosition();
+			GroupMoveCache.Reset();
+			LastMousePos = FBAUtils::SnapToGrid(FBAUtils::ScreenSpaceToPanelCoord(GraphPanel, FSlateApplication::Get().GetCursorPos()));
 			DragNodeTransaction.Begin(NodesToMove, INVTEXT("Move Node(s)"), EBADragMethod::LMB);
 		}
 	}
@@ -557,6 +567,8 @@ bool FBAInputProcessor::BeginGroupMovement(const FKey& Key)
 			// also set the anchor node for group movement
 			AnchorNode = HoveredNodeObj;
 			LastAnchorPos = HoveredNode->GetPosition();
+			GroupMoveCache.Reset();
+			LastMousePos = FBAUtils::SnapToGrid(FBAUtils::ScreenSpaceToPanelCoord(GraphPanel, FSlateApplication::Get().GetCursorPos()));
 
 			if (!SelectedNodes.Contains(HoveredNodeObj))
 			{
@@ -717,7 +729,6 @@ void FBAInputProcessor::UpdateGroupMovement()
 		return;
 	}
 	
-	TSet<UEdGraphNode*> NodesToMove;
 	EEdGraphPinDirection Direction = EGPD_MAX;
 	bool bMoveGroupOrSubtree = false;
 	bool bMoveGraphHandledGroup = false;
@@ -751,7 +762,25 @@ void FBAInputProcessor::UpdateGroupMovement()
 	{
 		return;
 	}
-	
+
+	// the nodes to move only change with the selection or movement key, so gather them once per drag
+	if (!GroupMoveCache.Matches(AnchorNode, SelectedNodes, Direction, bMoveGroupOrSubtree))
+	{
+		CacheGroupMoveNodes(GraphHandler, SelectedNodes, Direction, bMoveGroupOrSubtree);
+	}
+
+	// Move nodes
+	GroupMoveNodes(Delta);
+}
+
+void FBAInputProcessor::CacheGroupMoveNodes(
+	TSharedPtr<FBAGraphHandler> GraphHandler,
+	const TSet<UEdGraphNode*>& SelectedNodes,
+	EEdGraphPinDirection Direction,
+	bool bMoveGroupOrSubtree)
+{
+	TSet<UEdGraphNode*> NodesToMove;
+
 	// Group/subtree movement
 	if (bMoveGroupOrSubtree)
 	{
@@ -788,13 +817,39 @@ void FBAInputProcessor::UpdateGroupMovement()
 		}
 	}
 	// Group movement using graph handler
-	else if (bMoveGraphHandledGroup)
+	else
 	{
 		NodesToMove = GraphHandler->GetGroupedNodes(SelectedNodes);
 	}
-	
-	// Move nodes
-	GroupMoveNodes(Delta, NodesToMove);
+
+	// the selected nodes are already moved by the graph panel
+	TSet<UEdGraphNode*> IgnoredNodes(SelectedNodes);
+	if (SelectedNodes.Num() == 1)
+	{
+		if (UEdGraphNode_Comment* DraggedComment = Cast<UEdGraphNode_Comment>(SelectedNodes.Array()[0]))
+		{
+			for (UEdGraphNode* Node : FBAUtils::GetNodesUnderComment(DraggedComment))
+			{
+				IgnoredNodes.Add(Node);
+			}
+		}
+	}
+
+	GroupMoveCache.AnchorNode = AnchorNode;
+	GroupMoveCache.SelectedNodes = SelectedNodes;
+	GroupMoveCache.Direction = Direction;
+	GroupMoveCache.bMoveGroupOrSubtree = bMoveGroupOrSubtree;
+	GroupMoveCache.NodesToMove.Reset(NodesToMove.Num());
+
+	for (UEdGraphNode* Node : NodesToMove)
+	{
+		if (!IgnoredNodes.Contains(Node))
+		{
+			// the drag transaction only needs each node recorded once
+			Node->Modify(false);
+			GroupMoveCache.NodesToMove.Add(Node);
+		}
+	}
 }
 
 void FBAInputProcessor::GroupMoveSelectedNodes(const FVector2D& Delta)
@@ -821,34 +876,50 @@ void FBAInputProcessor::GroupMoveSelectedNodes(const FVector2D& Delta)
 	}
 }
 
-void FBAInputProcessor::GroupMoveNodes(const FVector2D& Delta, TSet<UEdGraphNode*>& Nodes)
+void FBAInputProcessor::GroupMoveNodes(const FVector2D& Delta)
 {
-	TSharedPtr<FBAGraphHandler> GraphHandler = FBATabHandler::Get().GetActiveGraphHandler();
-	TSet<UEdGraphNode*> SelectedNodes = GraphHandler->GetSelectedNodes();
-	TSet<UEdGraphNode*> IgnoredNodes(SelectedNodes);
-
-	if (SelectedNodes.Num() == 1)
+	for (const TWeakObjectPtr<UEdGraphNode>& WeakNode : GroupMoveCache.NodesToMove)
 	{
-		if (UEdGraphNode_Comment* DraggedComment = Cast<UEdGraphNode_Comment>(SelectedNodes.Array()[0]))
+		if (UEdGraphNode* Node = WeakNode.Get())
 		{
-			for (UEdGraphNode* Node : FBAUtils::GetNodesUnderComment(DraggedComment))
-			{
-				IgnoredNodes.Add(Node);
-			}
+			Node->NodePosX += Delta.X;
+			Node->NodePosY += Delta.Y;
 		}
 	}
+}
 
-	for (UEdGraphNode* Node : Nodes)
+bool FBAInputProcessor::FGroupMoveCache::Matches(
+	const TWeakObjectPtr<UEdGraphNode>& InAnchorNode,
+	const TSet<UEdGraphNode*>& InSelectedNodes,
+	EEdGraphPinDirection InDirection,
+	bool bInMoveGroupOrSubtree) const
+{
+	if (AnchorNode != InAnchorNode || Direction != InDirection || bMoveGroupOrSubtree != bInMoveGroupOrSubtree)
 	{
-		if (IgnoredNodes.Contains(Node))
+		return false;
+	}
+
+	if (SelectedNodes.Num() != InSelectedNodes.Num())
+	{
+		return false;
+	}
+
+	for (UEdGraphNode* Node : InSelectedNodes)
+	{
+		if (!SelectedNodes.Contains(Node))
 		{
-			continue;
+			return false;
 		}
-
-		Node->Modify(false);
-		Node->NodePosX += Delta.X;
-		Node->NodePosY += Delta.Y;
 	}
+
+	return true;
+}
+
+void FBAInputProcessor::FGroupMoveCache::Reset()
+{
+	AnchorNode.Reset();
+	SelectedNodes.Reset();
+	NodesToMove.Reset();
 }
 
 bool FBAInputProcessor::IsInputChordDown(const FInputChord& Chord)
@@ -1066,43 +1137,76 @@ bool FBAInputProcessor::ProcessCommandBindings(TSharedPtr<FUICommandList> Comman
 		ModifierKeysState.IsShiftDown(),
 		ModifierKeysState.IsCommandDown()));
 
-	const auto& DisabledCommands = GetDefault<UBASettings_Advanced>()->DisabledCommands;
+	if (bChordCommandsDirty)
+	{
+		BuildChordCommands();
+	}
 
-	const FInputBindingManager& InputBindingManager = FInputBindingManager::Get();
+	const auto* Commands = ChordCommands.Find(CheckChord);
+	if (!Commands)
+	{
+		return false;
+	}
 
-	TArray<TSharedPtr<FUICommandInfo>> LocalCommandInfos;
-	InputBindingManager.GetCommandInfosFromContext(FBACommands::Get().GetContextName(), LocalCommandInfos);
+	// Check to see if there is any command in the context activated by the chord
+	for (const TSharedPtr<FUICommandInfo>& Command : *Commands)
+	{
+		// Find the bound action for this command
+		const FUIAction* Action = CommandList->GetActionForCommand(Command);
 
-	// Only active chords process commands
-	constexpr bool bCheckDefault = false;
+		// If there is no Action mapped to this command list, continue to the next context
+		if (Action)
+		{
+			if (Action->CanExecute() && (!KeyEvent.IsRepeat() || Action->CanRepeat()))
+			{
+				// Block the command if we have disabled it in the settings
+				if (!GetDefault<UBASettings_Advanced>()->DisabledCommands.Contains(Command->GetCommandName()))
+				{
+					// If the action was found and can be executed, do so now
+					return Action->Execute();
+				}
+			}
+		}
+	}
 
-	static const TArray<FName> ContextNames = { FBACommands::Get().GetContextName(), FBAToolbarCommands::Get().GetContextName() };
+	return false;
+}
 
-	// Check to see if there is any command in the context activated by the chord
+void FBAInputProcessor::OnUserDefinedChordChanged(const FUICommandInfo& CommandInfo)
+{
+	bChordCommandsDirty = true;
+}
+
+void FBAInputProcessor::OnCommandsChanged(const FBindingContext& BindingContext)
+{
+	bChordCommandsDirty = true;
+}
+
+void FBAInputProcessor::BuildChordCommands()
+{
+	ChordCommands.Reset();
+
+	const FInputBindingManager& InputBindingManager = FInputBindingManager::Get();
+
+	// same order as the contexts were searched before, so the first context still wins a shared chord
+	const FName ContextNames[] = { FBACommands::Get().GetContextName(), FBAToolbarCommands::Get().GetContextName() };
 	for (const FName& ContextName : ContextNames)
 	{
-		TSharedPtr<FUICommandInfo> Command = FInputBindingManager::Get().FindCommandInContext(ContextName, CheckChord, bCheckDefault);
+		TArray<TSharedPtr<FUICommandInfo>> CommandInfos;
+		InputBindingManager.GetCommandInfosFromContext(ContextName, CommandInfos);
 
-		if (Command.IsValid() && Command->HasActiveChord(CheckChord))
+		for (const TSharedPtr<FUICommandInfo>& CommandInfo : CommandInfos)
 		{
-			// Find the bound action for this command
-			const FUIAction* Action = CommandList->GetActionForCommand(Command);
-
-			// If there is no Action mapped to this command list, continue to the next context
-			if (Action)
+			for (int32 ChordIndex = 0; ChordIndex < static_cast<int32>(EMultipleKeyBindingIndex::NumChords); ++ChordIndex)
 			{
-				if (Action->CanExecute() && (!KeyEvent.IsRepeat() || Action->CanRepeat()))
+				const TSharedRef<const FInputChord> Chord = CommandInfo->GetActiveChord(static_cast<EMultipleKeyBindingIndex>(ChordIndex));
+				if (Chord->IsValidChord())
 				{
-					// Block the command if we have disabled it in the settings
-					if (!DisabledCommands.Contains(Command->GetCommandName()))
-					{
-						// If the action was found and can be executed, do so now
-						return Action->Execute();
-					}
+					ChordCommands.FindOrAdd(*Chord).AddUnique(CommandInfo);
 				}
 			}
 		}
 	}
 
-	return false;
-}
\ No newline at end of file
+	bChordCommandsDirty = false;
+}
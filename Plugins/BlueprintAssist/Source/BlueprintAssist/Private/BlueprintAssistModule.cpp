@@ -17,11 +17,16 @@
 #include "BlueprintAssistToolbar.h"
 #include "BlueprintEditorModule.h"
 #include "PropertyEditorModule.h"
+#include "BlueprintAssistFormatters/BAFormatterProfiler.h"
 #include "BlueprintAssistObjects/BARootObject.h"
 #include "BlueprintAssistWidgets/BADebugMenu.h"
+#include "BlueprintAssistWidgets/BlueprintAssistOpenFileMenu.h"
+#include "BlueprintAssistWidgets/GoToSymbolMenu.h"
+#include "BlueprintAssistWidgets/OpenWindowMenu.h"
 #include "Developer/Settings/Public/ISettingsModule.h"
 #include "Framework/Application/SlateApplication.h"
 #include "Modules/ModuleManager.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 #if WITH_EDITOR
 #include "MessageLogInitializationOptions.h"
@@ -59,6 +64,8 @@ void FBlueprintAssistModule::StartupModule()
 
 void FBlueprintAssistModule::OnPostEngineInit()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(PluginStartup_BlueprintAssist);
+
 	if (!FSlateApplication::IsInitialized())
 	{
 		UE_LOG(LogBlueprintAssist, Log, TEXT("FBlueprintAssistModule: Slate App is not initialized, not loading the plugin"));
@@ -118,6 +125,11 @@ void FBlueprintAssistModule::ShutdownModule()
 
 	FBAToolbar::Get().Cleanup();
 
+	FBAOpenFileItems::TearDown();
+	FBAOpenWindowItemCache::TearDown();
+	FBAGoToSymbolCache::TearDown();
+	FBAFormatterProfiler::TearDown();
+
 	if (RootObject.IsValid())
 	{
 		UE_LOG(LogBlueprintAssist, Log, TEXT("Remove BlueprintAssist Root Object"));
@@ -0,0 +1,166 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistNodeKdTree.h"
+
+#include "BlueprintAssistStats.h"
+#include "EdGraph/EdGraphNode.h"
+
+namespace BANodeKdTree
+{
+	float GetAxis(const FVector2D& Position, int32 Depth)
+	{
+		return (Depth & 1) == 0 ? Position.X : Position.Y;
+	}
+
+	bool IsInside(const FSlateRect& Rect, const FVector2D& Position)
+	{
+		return Position.X >= Rect.Left && Position.X <= Rect.Right && Position.Y >= Rect.Top && Position.Y <= Rect.Bottom;
+	}
+}
+
+void FBANodeKdTree::Build(const TArray<UEdGraphNode*>& Nodes)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FBANodeKdTree::Build"), STAT_BA_NodeKdTreeBuild, STATGROUP_BA_EdGraphFormatter);
+
+	Entries.Reset(Nodes.Num());
+	for (UEdGraphNode* Node : Nodes)
+	{
+		if (Node != nullptr)
+		{
+			Entries.Add(FEntry { FVector2D(Node->NodePosX, Node->NodePosY), Node });
+		}
+	}
+
+	Build_Range(0, Entries.Num(), 0);
+	bDirty = false;
+}
+
+void FBANodeKdTree::Build_Range(int32 Begin, int32 End, int32 Depth)
+{
+	if (End - Begin <= 1)
+	{
+		return;
+	}
+
+	// sorting the whole range puts the median in the middle and each half on its side of it
+	TArrayView<FEntry>(Entries.GetData() + Begin, End - Begin).Sort([Depth](const FEntry& A, const FEntry& B)
+	{
+		return BANodeKdTree::GetAxis(A.Position, Depth) < BANodeKdTree::GetAxis(B.Position, Depth);
+	});
+
+	const int32 Mid = Begin + (End - Begin) / 2;
+	Build_Range(Begin, Mid, Depth + 1);
+	Build_Range(Mid + 1, End, Depth + 1);
+}
+
+void FBANodeKdTree::QueryRect(const FSlateRect& Rect, TArray<UEdGraphNode*>& OutNodes) const
+{
+	QueryRect_Range(0, Entries.Num(), 0, Rect, OutNodes);
+}
+
+void FBANodeKdTree::QueryRect_Range(int32 Begin, int32 End, int32 Depth, const FSlateRect& Rect, TArray<UEdGraphNode*>& OutNodes) const
+{
+	if (Begin >= End)
+	{
+		return;
+	}
+
+	const int32 Mid = Begin + (End - Begin) / 2;
+	const FEntry& Entry = Entries[Mid];
+	if (BANodeKdTree::IsInside(Rect, Entry.Position))
+	{
+		if (UEdGraphNode* Node = Entry.Node.Get())
+		{
+			OutNodes.Add(Node);
+		}
+	}
+
+	const float Split = BANodeKdTree::GetAxis(Entry.Position, Depth);
+	const bool bXAxis = (Depth & 1) == 0;
+	if ((bXAxis ? Rect.Left : Rect.Top) <= Split)
+	{
+		QueryRect_Range(Begin, Mid, Depth + 1, Rect, OutNodes);
+	}
+
+	if ((bXAxis ? Rect.Right : Rect.Bottom) >= Split)
+	{
+		QueryRect_Range(Mid + 1, End, Depth + 1, Rect, OutNodes);
+	}
+}
+
+UEdGraphNode* FBANodeKdTree::FindNearest(
+	const FVector2D& Origin,
+	const FVector2D& Weights,
+	const FSlateRect& Rect,
+	TFunctionRef<bool(UEdGraphNode*)> Filter) const
+{
+	UEdGraphNode* Nearest = nullptr;
+	float NearestDistance = TNumericLimits<float>::Max();
+	FindNearest_Range(0, Entries.Num(), 0, Origin, Weights, Rect, Filter, Nearest, NearestDistance);
+	return Nearest;
+}
+
+void FBANodeKdTree::FindNearest_Range(
+	int32 Begin,
+	int32 End,
+	int32 Depth,
+	const FVector2D& Origin,
+	const FVector2D& Weights,
+	const FSlateRect& Rect,
+	TFunctionRef<bool(UEdGraphNode*)> Filter,
+	UEdGraphNode*& OutNode,
+	float& OutDistance) const
+{
+	if (Begin >= End)
+	{
+		return;
+	}
+
+	const int32 Mid = Begin + (End - Begin) / 2;
+	const FEntry& Entry = Entries[Mid];
+	if (BANodeKdTree::IsInside(Rect, Entry.Position))
+	{
+		const FVector2D Delta = Entry.Position - Origin;
+		const float Distance = Weights.X * Delta.X * Delta.X + Weights.Y * Delta.Y * Delta.Y;
+		if (Distance < OutDistance)
+		{
+			UEdGraphNode* Node = Entry.Node.Get();
+			if (Node != nullptr && Filter(Node))
+			{
+				OutNode = Node;
+				OutDistance = Distance;
+			}
+		}
+	}
+
+	const bool bXAxis = (Depth & 1) == 0;
+	const float Split = BANodeKdTree::GetAxis(Entry.Position, Depth);
+	const float OriginDelta = BANodeKdTree::GetAxis(Origin, Depth) - Split;
+	const bool bCanGoLow = (bXAxis ? Rect.Left : Rect.Top) <= Split;
+	const bool bCanGoHigh = (bXAxis ? Rect.Right : Rect.Bottom) >= Split;
+
+	// the origin's side first, the other side only while it can still hold something closer
+	const bool bLowFirst = OriginDelta < 0;
+	for (int32 Pass = 0; Pass < 2; ++Pass)
+	{
+		const bool bLow = (Pass == 0) == bLowFirst;
+		if (!(bLow ? bCanGoLow : bCanGoHigh))
+		{
+			continue;
+		}
+
+		if (Pass == 1 && (bXAxis ? Weights.X : Weights.Y) * OriginDelta * OriginDelta >= OutDistance)
+		{
+			continue;
+		}
+
+		if (bLow)
+		{
+			FindNearest_Range(Begin, Mid, Depth + 1, Origin, Weights, Rect, Filter, OutNode, OutDistance);
+		}
+		else
+		{
+			FindNearest_Range(Mid + 1, End, Depth + 1, Origin, Weights, Rect, Filter, OutNode, OutDistance);
+		}
+	}
+}
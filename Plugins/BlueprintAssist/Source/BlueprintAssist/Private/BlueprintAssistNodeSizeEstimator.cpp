@@ -0,0 +1,197 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistNodeSizeEstimator.h"
+
+#include "BlueprintAssistGlobals.h"
+#include "BlueprintAssistUtils.h"
+#include "EdGraphNode_Comment.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node.h"
+#include "K2Node_VariableGet.h"
+#include "Fonts/FontMeasure.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/SlateRenderer.h"
+
+namespace BANodeSizeEstimator
+{
+	// measured from the default graph node widget at 1:1 zoom
+	constexpr float TitlePaddingX = 40.0f; // node icon and the padding around the title
+	constexpr float TitlePaddingY = 14.0f;
+	constexpr float PinRowHeight = 24.0f;
+	constexpr float PinAreaPaddingY = 4.0f;
+	constexpr float BottomPadding = 8.0f;
+	constexpr float AdvancedPinsExpanderHeight = 20.0f;
+	constexpr float PinIconWidth = 24.0f;
+	constexpr float PinRowPaddingX = 16.0f;
+	constexpr float PinColumnSpacing = 20.0f;
+	constexpr float MinNodeWidth = 80.0f;
+	constexpr float CompactTitleWidth = 40.0f;
+
+	const FName TitleStyle("Graph.Node.NodeTitle");
+	const FName PinNameStyle("Graph.Node.PinName");
+}
+
+FVector2D FBANodeSizeEstimator::EstimateNodeSize(UEdGraphNode* Node)
+{
+	using namespace BANodeSizeEstimator;
+
+	if (UEdGraphNode_Comment* Comment = Cast<UEdGraphNode_Comment>(Node))
+	{
+		// the cached size of a comment is its title bar
+		return FVector2D(Comment->NodeWidth, Comment->FontSize * 1.6f + TitlePaddingY);
+	}
+
+	float InputsWidth = 0.0f;
+	float OutputsWidth = 0.0f;
+	int32 NumInputs = 0;
+	int32 NumOutputs = 0;
+	bool bHasAdvancedPins = false;
+
+	for (UEdGraphPin* Pin : Node->Pins)
+	{
+		bHasAdvancedPins |= Pin->bAdvancedView;
+		if (!IsPinVisible(Node, Pin))
+		{
+			continue;
+		}
+
+		if (Pin->Direction == EGPD_Input)
+		{
+			InputsWidth = FMath::Max(InputsWidth, GetPinRowWidth(Pin));
+			++NumInputs;
+		}
+		else
+		{
+			OutputsWidth = FMath::Max(OutputsWidth, GetPinRowWidth(Pin));
+			++NumOutputs;
+		}
+	}
+
+	const float PinsHeight = FMath::Max(NumInputs, NumOutputs) * PinRowHeight;
+
+	if (!HasTitle(Node))
+	{
+		// compact nodes draw their title between the pin columns
+		const UK2Node* K2Node = Cast<UK2Node>(Node);
+		const float CenterWidth = K2Node && K2Node->ShouldDrawCompact()
+			? FMath::Max(CompactTitleWidth, GetTextSize(K2Node->GetCompactNodeTitle(), TitleStyle).X)
+			: 0.0f;
+
+		return FVector2D(
+			FMath::Max(MinNodeWidth, InputsWidth + CenterWidth + OutputsWidth),
+			PinsHeight + 2 * PinAreaPaddingY);
+	}
+
+	const FVector2D TitleSize = GetTextSize(Node->GetNodeTitle(ENodeTitleType::FullTitle), TitleStyle);
+
+	float Height = TitleSize.Y + TitlePaddingY + PinAreaPaddingY + PinsHeight + BottomPadding;
+	if (bHasAdvancedPins)
+	{
+		Height += AdvancedPinsExpanderHeight;
+	}
+
+	const float Width = FMath::Max3(MinNodeWidth, TitleSize.X + TitlePaddingX, InputsWidth + PinColumnSpacing + OutputsWidth);
+	return FVector2D(Width, Height);
+}
+
+float FBANodeSizeEstimator::EstimatePinOffset(UEdGraphNode* Node, const UEdGraphPin* Pin)
+{
+	using namespace BANodeSizeEstimator;
+
+	float Offset = PinAreaPaddingY;
+	if (HasTitle(Node))
+	{
+		Offset += GetTextSize(Node->GetNodeTitle(ENodeTitleType::FullTitle), TitleStyle).Y + TitlePaddingY;
+	}
+
+	// each side stacks its visible pins in order
+	for (UEdGraphPin* Other : Node->Pins)
+	{
+		if (Other == Pin)
+		{
+			break;
+		}
+
+		if (Other->Direction == Pin->Direction && IsPinVisible(Node, Other))
+		{
+			Offset += PinRowHeight;
+		}
+	}
+
+	return Offset;
+}
+
+bool FBANodeSizeEstimator::IsPinVisible(UEdGraphNode* Node, const UEdGraphPin* Pin)
+{
+	if (Pin->bHidden)
+	{
+		return false;
+	}
+
+	return !Pin->bAdvancedView || Node->AdvancedPinDisplay != ENodeAdvancedPins::Hidden;
+}
+
+bool FBANodeSizeEstimator::HasTitle(UEdGraphNode* Node)
+{
+	if (const UK2Node* K2Node = Cast<UK2Node>(Node))
+	{
+		return !K2Node->ShouldDrawCompact() && !Node->IsA(UK2Node_VariableGet::StaticClass());
+	}
+
+	return true;
+}
+
+FVector2D FBANodeSizeEstimator::GetTextSize(const FText& Text, FName StyleName)
+{
+	if (Text.IsEmpty())
+	{
+		return FVector2D::ZeroVector;
+	}
+
+	if (!FSlateApplication::IsInitialized())
+	{
+		// roughly the average glyph size of the graph fonts
+		return FVector2D(Text.ToString().Len() * 7.0f, 16.0f);
+	}
+
+	const FSlateFontInfo& Font = BA_STYLE_CLASS::Get().GetWidgetStyle<FTextBlockStyle>(StyleName).Font;
+	return FSlateApplication::Get().GetRenderer()->GetFontMeasureService()->Measure(Text, Font);
+}
+
+float FBANodeSizeEstimator::GetPinRowWidth(const UEdGraphPin* Pin)
+{
+	using namespace BANodeSizeEstimator;
+
+	float Width = PinIconWidth + PinRowPaddingX;
+
+	const bool bIsExec = FBAUtils::IsExecPin(Pin);
+	const bool bUnnamedExec = bIsExec && (Pin->PinName == UEdGraphSchema_K2::PN_Execute || Pin->PinName == UEdGraphSchema_K2::PN_Then);
+	if (!bUnnamedExec)
+	{
+		Width += GetTextSize(Pin->GetDisplayName(), PinNameStyle).X;
+	}
+
+	// unlinked inputs show a widget to edit their default value
+	if (Pin->Direction == EGPD_Input && !bIsExec && Pin->LinkedTo.Num() == 0 && !Pin->bDefaultValueIsIgnored)
+	{
+		const FName Category = Pin->PinType.PinCategory;
+		if (Category == UEdGraphSchema_K2::PC_Boolean)
+		{
+			Width += 20.0f;
+		}
+		else if (Category == UEdGraphSchema_K2::PC_Struct)
+		{
+			Width += 150.0f;
+		}
+		else if (Category == UEdGraphSchema_K2::PC_Object || Category == UEdGraphSchema_K2::PC_Class || Category == UEdGraphSchema_K2::PC_SoftObject || Category == UEdGraphSchema_K2::PC_SoftClass)
+		{
+			Width += 120.0f;
+		}
+		else if (Category != UEdGraphSchema_K2::PC_Wildcard && Category != UEdGraphSchema_K2::PC_Delegate)
+		{
+			Width += FMath::Max(40.0f, GetTextSize(FText::FromString(Pin->DefaultValue), PinNameStyle).X + 20.0f);
+		}
+	}
+
+	return Width;
+}
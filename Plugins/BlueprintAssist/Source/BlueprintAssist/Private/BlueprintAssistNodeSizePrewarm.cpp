@@ -0,0 +1,213 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistNodeSizePrewarm.h"
+
+#include "BlueprintAssistCache.h"
+#include "BlueprintAssistGlobals.h"
+#include "BlueprintAssistSettings_Advanced.h"
+#include "BlueprintAssistUtils.h"
+#include "SGraphNode.h"
+#include "SGraphPanel.h"
+#include "SGraphPin.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopedSlowTask.h"
+
+namespace BANodeSizePrewarm
+{
+	// loaded blueprints are released every so often, a whole project would not fit in memory
+	constexpr int32 BlueprintsPerGarbageCollection = 50;
+
+	void RunFromConsole(const TArray<FString>& Args)
+	{
+		FString PackagePath = TEXT("/Game");
+		bool bForce = false;
+		for (const FString& Arg : Args)
+		{
+			if (Arg.Equals(TEXT("-Force"), ESearchCase::IgnoreCase))
+			{
+				bForce = true;
+			}
+			else
+			{
+				PackagePath = Arg;
+			}
+		}
+
+		FBANodeSizePrewarmStats Stats;
+		if (FBANodeSizePrewarm::Run(PackagePath, bForce, Stats))
+		{
+			UE_LOG(LogBlueprintAssist, Log, TEXT("PrewarmNodeSizes: measured %d nodes (%d already cached) in %d graphs of %d blueprints under %s in %.1fs"),
+				Stats.NumMeasuredNodes,
+				Stats.NumSkippedNodes,
+				Stats.NumGraphs,
+				Stats.NumBlueprints,
+				*PackagePath,
+				Stats.Seconds);
+		}
+	}
+
+	FAutoConsoleCommand PrewarmNodeSizesCommand(
+		TEXT("BlueprintAssist.PrewarmNodeSizes"),
+		TEXT("Measures the nodes of every blueprint under a path and stores their sizes in the cache. Args: [Path=/Game] [-Force]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunFromConsole));
+}
+
+bool FBANodeSizePrewarm::Run(const FString& PackagePath, bool bForce, FBANodeSizePrewarmStats& OutStats)
+{
+	if (!FSlateApplication::IsInitialized())
+	{
+		UE_LOG(LogBlueprintAssist, Warning, TEXT("PrewarmNodeSizes: node sizes can only be measured with slate running"));
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	FARFilter Filter;
+	Filter.PackagePaths.Add(*PackagePath);
+	Filter.bRecursivePaths = true;
+	Filter.bRecursiveClasses = true;
+#if BA_UE_VERSION_OR_LATER(5, 1)
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+#else
+	Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+#endif
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	FScopedSlowTask SlowTask(Assets.Num(), FText::FromString(TEXT("Measuring blueprint nodes")));
+	SlowTask.MakeDialog(true);
+
+	const bool bStoreInMetaData = GetDefault<UBASettings_Advanced>()->bStoreCacheDataInPackageMetaData;
+
+	for (int32 AssetIndex = 0; AssetIndex < Assets.Num(); ++AssetIndex)
+	{
+		if (SlowTask.ShouldCancel())
+		{
+			break;
+		}
+
+		const FAssetData& Asset = Assets[AssetIndex];
+		SlowTask.EnterProgressFrame(1, FText::FromName(Asset.AssetName));
+
+		UBlueprint* Blueprint = Cast<UBlueprint>(Asset.GetAsset());
+		if (!Blueprint)
+		{
+			continue;
+		}
+
+		++OutStats.NumBlueprints;
+
+		TArray<UEdGraph*> Graphs;
+		Blueprint->GetAllGraphs(Graphs);
+
+		bool bMeasuredAny = false;
+		for (UEdGraph* Graph : Graphs)
+		{
+			const int32 NumMeasured = PrewarmGraph(Graph, bForce, OutStats.NumSkippedNodes);
+			if (NumMeasured > 0)
+			{
+				++OutStats.NumGraphs;
+				OutStats.NumMeasuredNodes += NumMeasured;
+				bMeasuredAny = true;
+
+				FBACache::Get().SaveGraphDataToPackageMetaData(Graph);
+			}
+		}
+
+		// the meta data only reaches the disk with the package
+		if (bMeasuredAny && bStoreInMetaData)
+		{
+			Blueprint->MarkPackageDirty();
+		}
+
+		if ((AssetIndex + 1) % BANodeSizePrewarm::BlueprintsPerGarbageCollection == 0)
+		{
+			FBACache::Get().SaveCacheAndWait();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+	}
+
+	FBACache::Get().SaveCacheAndWait();
+
+	OutStats.Seconds = FPlatformTime::Seconds() - StartTime;
+	return true;
+}
+
+int32 FBANodeSizePrewarm::PrewarmGraph(UEdGraph* Graph, bool bForce, int32& OutNumSkipped)
+{
+	if (!Graph || !Graph->GetSchema())
+	{
+		return 0;
+	}
+
+	// an offscreen panel makes the same node widgets as the graph editor, with itself as their owner
+	TSharedRef<SGraphPanel> GraphPanel = SNew(SGraphPanel).GraphObj(Graph);
+	GraphPanel->Update();
+	GraphPanel->SlatePrepass(1.0f);
+
+	FBAGraphData* GraphData = nullptr;
+	int32 NumMeasured = 0;
+
+	FChildren* PanelChildren = GraphPanel->GetAllChildren();
+	for (int32 ChildIndex = 0; ChildIndex < PanelChildren->Num(); ++ChildIndex)
+	{
+		const TSharedRef<SGraphNode> GraphNode = StaticCastSharedRef<SGraphNode>(PanelChildren->GetChildAt(ChildIndex));
+		UEdGraphNode* Node = GraphNode->GetNodeObj();
+
+		// comments are sized by the user, only their title is measured and that is done when they are focused
+		if (!Node || !FBAUtils::IsGraphNode(Node) || FBAUtils::IsCommentNode(Node))
+		{
+			continue;
+		}
+
+		FVector2D CachedSize;
+		if (!bForce && FBACache::Get().FindNodeSize(Graph, Node, CachedSize))
+		{
+			++OutNumSkipped;
+			continue;
+		}
+
+		const FVector2D Size = GraphNode->GetDesiredSize();
+		if (Size.SizeSquared() <= 0)
+		{
+			continue;
+		}
+
+		// same as FBAGraphHandler::CacheNodeSizesInPrepass, lay the node out at its origin and read the pins from it
+		TArray<TSharedRef<SWidget>> PinWidgets;
+		GraphNode->GetPins(PinWidgets);
+
+		TSet<TSharedRef<SWidget>> PinsToFind;
+		PinsToFind.Append(PinWidgets);
+
+		TMap<TSharedRef<SWidget>, FArrangedWidget> PinGeometries;
+		GraphNode->FindChildGeometries(FGeometry::MakeRoot(Size, FSlateLayoutTransform()), PinsToFind, PinGeometries);
+
+		if (!GraphData)
+		{
+			GraphData = &FBACache::Get().GetGraphData(Graph);
+		}
+
+		FBANodeData& NodeData = GraphData->GetNodeData(Node);
+		NodeData.ResetSize();
+
+		for (const auto& Elem : PinGeometries)
+		{
+			if (UEdGraphPin* Pin = StaticCastSharedRef<SGraphPin>(Elem.Key)->GetPinObj())
+			{
+				NodeData.CachedPins.Add(Pin->PinId, Elem.Value.Geometry.GetAbsolutePosition().Y);
+			}
+		}
+
+		NodeData.CachedNodeSize = Size;
+		++NumMeasured;
+	}
+
+	return NumMeasured;
+}
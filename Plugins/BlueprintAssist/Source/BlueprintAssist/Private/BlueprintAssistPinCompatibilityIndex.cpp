@@ -0,0 +1,177 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistPinCompatibilityIndex.h"
+
+#include "BlueprintAssistStats.h"
+#include "EdGraphSchema_K2.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphSchema.h"
+
+void FBAPinCompatibilityIndex::Build(UEdGraph* Graph)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FBAPinCompatibilityIndex::Build"), STAT_BA_PinCompatibilityIndexBuild, STATGROUP_BA_EdGraphFormatter);
+
+	Reset();
+
+	if (Graph == nullptr)
+	{
+		return;
+	}
+
+	const UEdGraphSchema* Schema = Graph->GetSchema();
+	bGroupByType = Schema != nullptr && Schema->IsA<UEdGraphSchema_K2>();
+
+	int32 Order = 0;
+	for (UEdGraphNode* Node : Graph->Nodes)
+	{
+		if (Node == nullptr)
+		{
+			continue;
+		}
+
+		for (UEdGraphPin* Pin : Node->Pins)
+		{
+			if (Pin == nullptr || Pin->bHidden)
+			{
+				continue;
+			}
+
+			FPinEntry Entry;
+			Entry.Pin = FEdGraphPinReference(Pin);
+			Entry.Order = Order++;
+
+			FPinTypeKey Key;
+			if (!GetPinTypeKey(Pin, Key))
+			{
+				UngroupedPins.Add(MoveTemp(Entry));
+				continue;
+			}
+
+			int32* GroupIndex = GroupLookup.Find(Key);
+			if (GroupIndex == nullptr)
+			{
+				GroupIndex = &GroupLookup.Add(Key, Groups.Num());
+				Groups.AddDefaulted_GetRef().Key = Key;
+			}
+
+			Groups[*GroupIndex].Pins.Add(MoveTemp(Entry));
+		}
+	}
+}
+
+void FBAPinCompatibilityIndex::Reset()
+{
+	bGroupByType = false;
+	Groups.Reset();
+	GroupLookup.Reset();
+	UngroupedPins.Reset();
+	SourceResponses.Reset();
+}
+
+void FBAPinCompatibilityIndex::GetConnectablePins(UEdGraphPin* SourcePin, TArray<UEdGraphPin*>& OutPins)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FBAPinCompatibilityIndex::GetConnectablePins"), STAT_BA_PinCompatibilityIndexQuery, STATGROUP_BA_EdGraphFormatter);
+
+	if (SourcePin == nullptr)
+	{
+		return;
+	}
+
+	const UEdGraphNode* SourceNode = SourcePin->GetOwningNode();
+
+	TArray<TPair<int32, UEdGraphPin*>> Found;
+
+	FPinTypeKey SourceKey;
+	TArray<int8>* Responses = nullptr;
+	if (GetPinTypeKey(SourcePin, SourceKey))
+	{
+		Responses = &SourceResponses.FindOrAdd(SourceKey);
+		if (Responses->Num() != Groups.Num())
+		{
+			Responses->Init(INDEX_NONE, Groups.Num());
+		}
+	}
+
+	for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+	{
+		for (const FPinEntry& Entry : Groups[GroupIndex].Pins)
+		{
+			UEdGraphPin* Pin = Entry.Pin.Get();
+			if (Pin == nullptr)
+			{
+				continue;
+			}
+
+			bool bCanConnect;
+			if (Responses == nullptr || Pin->GetOwningNode() == SourceNode)
+			{
+				bCanConnect = CanConnect(SourcePin, Pin);
+			}
+			else
+			{
+				// the first pin of the group off the source node answers for all of them
+				int8& Response = (*Responses)[GroupIndex];
+				if (Response == INDEX_NONE)
+				{
+					Response = CanConnect(SourcePin, Pin) ? 1 : 0;
+				}
+
+				bCanConnect = Response == 1;
+			}
+
+			if (bCanConnect)
+			{
+				Found.Emplace(Entry.Order, Pin);
+			}
+		}
+	}
+
+	for (const FPinEntry& Entry : UngroupedPins)
+	{
+		UEdGraphPin* Pin = Entry.Pin.Get();
+		if (Pin != nullptr && CanConnect(SourcePin, Pin))
+		{
+			Found.Emplace(Entry.Order, Pin);
+		}
+	}
+
+	Found.Sort([](const TPair<int32, UEdGraphPin*>& A, const TPair<int32, UEdGraphPin*>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	OutPins.Reserve(OutPins.Num() + Found.Num());
+	for (const TPair<int32, UEdGraphPin*>& Pair : Found)
+	{
+		OutPins.Add(Pair.Value);
+	}
+}
+
+bool FBAPinCompatibilityIndex::GetPinTypeKey(const UEdGraphPin* Pin, FPinTypeKey& OutKey) const
+{
+	if (!bGroupByType)
+	{
+		return false;
+	}
+
+	// these take their type from what they connect to or from the blueprint of their node
+	if (Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Wildcard || Pin->PinType.PinSubCategory == UEdGraphSchema_K2::PSC_Self)
+	{
+		return false;
+	}
+
+	OutKey.PinType = Pin->PinType;
+	OutKey.Direction = Pin->Direction;
+	OutKey.NodeClass = Pin->GetOwningNode()->GetClass();
+	OutKey.bNotConnectable = Pin->bNotConnectable;
+	OutKey.bOrphanedPin = Pin->bOrphanedPin;
+	return true;
+}
+
+bool FBAPinCompatibilityIndex::CanConnect(const UEdGraphPin* SourcePin, const UEdGraphPin* Pin)
+{
+	const UEdGraphSchema* Schema = Pin->GetSchema();
+	const FPinConnectionResponse Response = Schema->CanCreateConnection(SourcePin, Pin);
+	return Response.Response != CONNECT_RESPONSE_DISALLOW;
+}
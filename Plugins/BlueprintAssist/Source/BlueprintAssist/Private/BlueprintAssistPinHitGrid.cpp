@@ -0,0 +1,132 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistPinHitGrid.h"
+
+#include "BlueprintAssistStats.h"
+#include "BlueprintAssistUtils.h"
+#include "SGraphNode.h"
+#include "SGraphPanel.h"
+#include "SGraphPin.h"
+
+const FBAPinHitGrid& FBAPinHitGrid::Get(TSharedPtr<SGraphPanel> GraphPanel)
+{
+	// the hover queries of a frame are all for the panel under the cursor
+	static FBAPinHitGrid Grid;
+
+	if (Grid.BuiltFrame != GFrameCounter || Grid.BuiltPanel.Pin() != GraphPanel)
+	{
+		Grid.Rebuild(GraphPanel);
+	}
+
+	return Grid;
+}
+
+void FBAPinHitGrid::QueryPoint(const FVector2D& GraphPoint, TArray<TSharedPtr<SGraphPin>>& OutPins) const
+{
+	const TArray<int32>* Cell = Cells.Find(GetCell(GraphPoint));
+	if (Cell == nullptr)
+	{
+		return;
+	}
+
+	for (int32 Index : *Cell)
+	{
+		const FPinEntry& Entry = Pins[Index];
+		if (Entry.Bounds.ContainsPoint(GraphPoint))
+		{
+			if (TSharedPtr<SGraphPin> GraphPin = Entry.GraphPin.Pin())
+			{
+				OutPins.Add(GraphPin);
+			}
+		}
+	}
+}
+
+void FBAPinHitGrid::GetLinkedPins(TArray<TSharedPtr<SGraphPin>>& OutPins) const
+{
+	for (const FPinEntry& Entry : Pins)
+	{
+		if (Entry.bLinked)
+		{
+			if (TSharedPtr<SGraphPin> GraphPin = Entry.GraphPin.Pin())
+			{
+				OutPins.Add(GraphPin);
+			}
+		}
+	}
+}
+
+void FBAPinHitGrid::Rebuild(TSharedPtr<SGraphPanel> GraphPanel)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FBAPinHitGrid::Rebuild"), STAT_BA_PinHitGridRebuild, STATGROUP_BA_EdGraphFormatter);
+
+	Pins.Reset();
+	Cells.Reset();
+	BuiltPanel = GraphPanel;
+	BuiltFrame = GFrameCounter;
+
+	if (!GraphPanel.IsValid())
+	{
+		return;
+	}
+
+	const FSlateRect PanelBounds = FBAUtils::GetGraphPanelBounds(GraphPanel);
+
+	FChildren* PanelChildren = GraphPanel->GetAllChildren();
+	TArray<TSharedRef<SWidget>> PinWidgets;
+	for (int32 NodeIndex = 0; NodeIndex < PanelChildren->Num(); ++NodeIndex)
+	{
+		const TSharedRef<SGraphNode> GraphNode = StaticCastSharedRef<SGraphNode>(PanelChildren->GetChildAt(NodeIndex));
+
+		const FVector2D NodePosition = GraphNode->GetPosition();
+		const FSlateRect NodeBounds = FSlateRect::FromPointAndExtent(NodePosition, GraphNode->GetDesiredSize());
+		const bool bNodeVisible = FSlateRect::DoRectanglesIntersect(NodeBounds, PanelBounds);
+
+		PinWidgets.Reset();
+		GraphNode->GetPins(PinWidgets);
+		for (const TSharedRef<SWidget>& PinWidget : PinWidgets)
+		{
+			const TSharedRef<SGraphPin> GraphPin = StaticCastSharedRef<SGraphPin>(PinWidget);
+			UEdGraphPin* Pin = GraphPin->GetPinObj();
+			if (Pin == nullptr || Pin->bHidden)
+			{
+				continue;
+			}
+
+			const bool bLinked = Pin->LinkedTo.Num() > 0;
+
+			// only a visible pin can be under the cursor, only a linked one can be hovered through its wire
+			if (!bNodeVisible && !bLinked)
+			{
+				continue;
+			}
+
+			FPinEntry& Entry = Pins.AddDefaulted_GetRef();
+			Entry.GraphPin = GraphPin;
+			Entry.bLinked = bLinked;
+
+			if (!bNodeVisible)
+			{
+				continue;
+			}
+
+			Entry.Bounds = FBAUtils::GetPinBounds(GraphPin).ExtendBy(BoundsPadding);
+
+			const int32 Index = Pins.Num() - 1;
+			const FIntPoint MinCell = GetCell(Entry.Bounds.GetTopLeft());
+			const FIntPoint MaxCell = GetCell(Entry.Bounds.GetBottomRight());
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+				{
+					Cells.FindOrAdd(FIntPoint(X, Y)).Add(Index);
+				}
+			}
+		}
+	}
+}
+
+FIntPoint FBAPinHitGrid::GetCell(const FVector2D& Point)
+{
+	return FIntPoint(FMath::FloorToInt(static_cast<float>(Point.X) / CellSize), FMath::FloorToInt(static_cast<float>(Point.Y) / CellSize));
+}
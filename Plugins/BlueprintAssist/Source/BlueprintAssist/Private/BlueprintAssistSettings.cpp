@@ -250,7 +250,9 @@ UBASettings::UBASettings(const FObjectInitializer& ObjectInitializer)
 
 	bEnableFasterFormatting = false;
 
-	bUseKnotNodePool = false;
+	bFormatWithEstimatedNodeSizes = false;
+
+	bUseKnotNodePool = true;
 
 	bSlowButAccurateSizeCaching = false;
 
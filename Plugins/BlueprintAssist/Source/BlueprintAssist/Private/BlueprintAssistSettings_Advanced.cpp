@@ -14,6 +14,8 @@ UBASettings_Advanced::UBASettings_Advanced(const FObjectInitializer& ObjectIniti
 	//~~~ Cache
 	bStoreCacheDataInPackageMetaData = false;
 	bPrettyPrintCacheJSON = false;
+	CacheSizeLimitMB = 64;
+	ReleaseUnusedCacheDataMinutes = 10.0f;
 
 	//~~~ Misc
 	bUseCustomBlueprintActionMenu = false;
@@ -33,6 +33,9 @@ void FBATabHandler::Init()
 		// Add delegate for tab foregrounded
 		const auto& TabForegroundedDelegate = FOnActiveTabChanged::FDelegate::CreateRaw(this, &FBATabHandler::OnTabForegrounded);
 		OnTabForegroundedDelegateHandle = TabManager->OnTabForegrounded_Subscribe(TabForegroundedDelegate);
+
+		// window activation and most tab content changes move the keyboard focus
+		OnFocusChangingDelegateHandle = FSlateApplication::Get().OnFocusChanging().AddRaw(this, &FBATabHandler::OnFocusChanging);
 	}
 	else
 	{
@@ -42,11 +45,24 @@ void FBATabHandler::Init()
 
 void FBATabHandler::Tick(const float DeltaTime)
 {
-	CheckActiveTabContentChanged();
+	// the active graph handler expects its tab to be alive, check the tabs right away if it closed
+	if (ActiveGraphHandler.IsValid() && !ActiveGraphHandler.Pin()->GetTab().IsValid())
+	{
+		bTabStateDirty = true;
+	}
 
-	RemoveInvalidTabs();
+	TimeSinceTabCheck += DeltaTime;
+	if (bTabStateDirty || TimeSinceTabCheck >= TabCheckInterval)
+	{
+		bTabStateDirty = false;
+		TimeSinceTabCheck = 0.0f;
+
+		CheckActiveTabContentChanged();
 
-	CheckWindowFocusChanged();
+		RemoveInvalidTabs();
+
+		CheckWindowFocusChanged();
+	}
 
 	if (ActiveGraphHandler.IsValid())
 	{
@@ -73,6 +89,7 @@ void FBATabHandler::OnTabForegrounded(TSharedPtr<SDockTab> NewTab, TSharedPtr<SD
 
 	TWeakPtr<SDockTab> NewTabObserver(NewTab);
 	TabsToProcess.Emplace(NewTabObserver);
+	bTabStateDirty = true;
 
 	if (!ProcessTabsTimerHandle.IsValid())
 	{
@@ -91,6 +108,7 @@ void FBATabHandler::OnActiveTabChanged(TSharedPtr<SDockTab> PreviousTab, TShared
 
 	TWeakPtr<SDockTab> NewTabObserver(NewTab);
 	TabsToProcess.Emplace(NewTabObserver);
+	bTabStateDirty = true;
 
 	if (!ProcessTabsTimerHandle.IsValid())
 	{
@@ -98,6 +116,16 @@ void FBATabHandler::OnActiveTabChanged(TSharedPtr<SDockTab> PreviousTab, TShared
 	}
 }
 
+void FBATabHandler::OnFocusChanging(
+	const FFocusEvent& FocusEvent,
+	const FWeakWidgetPath& OldFocusedWidgetPath,
+	const TSharedPtr<SWidget>& OldFocusedWidget,
+	const FWidgetPath& NewFocusedWidgetPath,
+	const TSharedPtr<SWidget>& NewFocusedWidget)
+{
+	bTabStateDirty = true;
+}
+
 void FBATabHandler::CheckActiveTabContentChanged()
 {
 	TSharedRef<FGlobalTabmanager> TabManager = FGlobalTabmanager::Get();
@@ -188,6 +216,11 @@ void FBATabHandler::Cleanup()
 	TabManager->OnTabForegrounded_Unsubscribe(OnTabForegroundedDelegateHandle);
 	TabManager->OnActiveTabChanged_Unsubscribe(OnActiveTabChangedDelegateHandle);
 
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnFocusChanging().Remove(OnFocusChangingDelegateHandle);
+	}
+
 	for (auto& Elem : GraphHandlerMap)
 	{
 		Elem.Value->Cleanup();
@@ -198,6 +231,8 @@ void FBATabHandler::Cleanup()
 	TabsToProcess.Reset();
 	LastMajorTab.Reset();
 	ProcessTabsTimerHandle.Invalidate();
+	ChildTabWithGraphEditorCache.Reset();
+	GraphEditorCache.Reset();
 }
 
 void FBATabHandler::RemoveInvalidTabs()
@@ -228,6 +263,23 @@ void FBATabHandler::RemoveInvalidTabs()
 			GraphHandlerMap.Remove(Tab);
 		}
 	}
+
+	// drop cached lookups for closed tabs
+	for (auto It = ChildTabWithGraphEditorCache.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = GraphEditorCache.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
 }
 
 TSharedPtr<SDockTab> FBATabHandler::GetChildTabWithGraphEditor(TSharedPtr<SWidget> Widget) const
@@ -272,6 +324,42 @@ TSharedPtr<SDockTab> FBATabHandler::GetChildTabWithGraphEditor(TSharedPtr<SWidge
 	return nullptr;
 }
 
+TSharedPtr<SDockTab> FBATabHandler::FindChildTabWithGraphEditor(TSharedPtr<SDockTab> MajorTab)
+{
+	// reuse the last tab found while it is still a visible foreground graph tab inside the major tab
+	if (TSharedPtr<SDockTab> CachedChildTab = ChildTabWithGraphEditorCache.FindRef(MajorTab).Pin())
+	{
+		if (CachedChildTab->IsForeground() &&
+			FBAUtils::IsWidgetOfType(CachedChildTab->GetContent(), "SGraphEditor") &&
+			FBAUtils::IsWidgetInside(CachedChildTab, MajorTab->GetContent(), true))
+		{
+			return CachedChildTab;
+		}
+	}
+
+	TSharedPtr<SDockTab> ChildTab = GetChildTabWithGraphEditor(MajorTab->GetContent());
+	ChildTabWithGraphEditorCache.Add(MajorTab, ChildTab);
+	return ChildTab;
+}
+
+TSharedPtr<SGraphEditor> FBATabHandler::FindGraphEditor(TSharedPtr<SDockTab> Tab)
+{
+	TSharedRef<SWidget> TabContent = Tab->GetContent();
+
+	// the content is swapped out when the tab shows another graph, the cached editor is then no longer inside it
+	if (TSharedPtr<SGraphEditor> CachedGraphEditor = GraphEditorCache.FindRef(Tab).Pin())
+	{
+		if (FBAUtils::IsWidgetInside(CachedGraphEditor, TabContent))
+		{
+			return CachedGraphEditor;
+		}
+	}
+
+	TSharedPtr<SGraphEditor> GraphEditor = FBAUtils::GetChildWidgetByTypesCasted<SGraphEditor>(TabContent, UBASettings::Get().SupportedGraphEditors);
+	GraphEditorCache.Add(Tab, GraphEditor);
+	return GraphEditor;
+}
+
 void FBATabHandler::ProcessTabs()
 {
 	ProcessTabsTimerHandle.Invalidate();
@@ -332,15 +420,13 @@ bool FBATabHandler::ProcessTab(TSharedPtr<SDockTab> Tab)
 
 	TSharedPtr<SDockTab> TabWithGraphEditor
 		= bIsMajorTab
-		? GetChildTabWithGraphEditor(Tab->GetContent())
+		? FindChildTabWithGraphEditor(Tab)
 		: Tab;
 
 	UnsupportedGraphEditor.Reset();
 	if (TabWithGraphEditor.IsValid())
 	{
-		TSharedRef<SWidget> TabContent = TabWithGraphEditor->GetContent();
-
-		TSharedPtr<SGraphEditor> GraphEditor = FBAUtils::GetChildWidgetByTypesCasted<SGraphEditor>(TabContent, UBASettings::Get().SupportedGraphEditors);
+		TSharedPtr<SGraphEditor> GraphEditor = FindGraphEditor(TabWithGraphEditor);
 
 		// use the tab if it contains a graph editor
 		if (GraphEditor.IsValid())
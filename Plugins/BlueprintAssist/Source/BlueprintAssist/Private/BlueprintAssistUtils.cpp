@@ -5,6 +5,7 @@
 #include "BlueprintAssistGlobals.h"
 #include "BlueprintAssistGraphHandler.h"
 #include "BlueprintAssistModule.h"
+#include "BlueprintAssistPinHitGrid.h"
 #include "BlueprintAssistSettings.h"
 #include "BlueprintAssistSettings_Advanced.h"
 #include "BlueprintAssistStats.h"
@@ -421,19 +422,26 @@ FVector2D FBAUtils::GetPinPos(TSharedPtr<SGraphPin> Pin)
 
 void FBAUtils::SortNodesOnGraphByDistance(
 	UEdGraphNode* RelativeNode,
-	const UEdGraph* Graph,
+	TSharedPtr<FBAGraphHandler> GraphHandler,
 	TSet<UEdGraphNode*>& LHSNodes,
 	TSet<UEdGraphNode*>& RHSNodes,
 	TSet<UEdGraphPin*>& LHSPins,
 	TSet<UEdGraphPin*>& RHSPins)
 {
-	if (Graph == nullptr || RelativeNode == nullptr)
+	if (!GraphHandler.IsValid() || RelativeNode == nullptr)
 	{
 		return;
 	}
 
+	// ignore nodes too far away
+	// TODO: make this an option parameter
+	const FVector2D RelativePos(RelativeNode->NodePosX, RelativeNode->NodePosY);
+	const FVector2D MaxDelta(600, 400);
+	TArray<UEdGraphNode*> NearbyNodes;
+	GraphHandler->GetNodeKdTree().QueryRect(FSlateRect(RelativePos - MaxDelta, RelativePos + MaxDelta), NearbyNodes);
+
 	// Add nodes to LHS or RHS depending on X position
-	for (UEdGraphNode* Other : Graph->Nodes)
+	for (UEdGraphNode* Other : NearbyNodes)
 	{
 		// ignore the same node
 		if (Other == RelativeNode)
@@ -441,15 +449,6 @@ void FBAUtils::SortNodesOnGraphByDistance(
 			continue;
 		}
 
-		// ignore nodes too far away
-		// TODO: make this an option parameter
-		const float DeltaX = FMath::Abs(Other->NodePosX - RelativeNode->NodePosX);
-		const float DeltaY = FMath::Abs(Other->NodePosY - RelativeNode->NodePosY);
-		if (DeltaX > 600 || DeltaY > 400)
-		{
-			continue;
-		}
-
 		(RelativeNode->NodePosX >= Other->NodePosX ? LHSNodes : RHSNodes).Add(Other);
 	}
 
@@ -881,6 +880,79 @@ bool FBAUtils::DoesNodeHaveExecutionTo(UEdGraphNode* InNodeA, UEdGraphNode* InNo
 	return false;
 }
 
+TSet<UEdGraphNode*> FBAUtils::GetExecutionReachableNodes(UEdGraphNode* InNode, EEdGraphPinDirection Direction)
+{
+	TSet<UEdGraphNode*> NodeTree;
+	if (!InNode)
+	{
+		return NodeTree;
+	}
+
+	TSet<FPinLink> VisitedLinks;
+	TQueue<UEdGraphNode*> NodeQueue;
+
+	UEdGraphNode* Node = InNode;
+	if (FBAUtils::IsNodePure(Node))
+	{
+		if (UEdGraphNode* ExecNode = GetExecutingNode(Node))
+		{
+			Node = ExecNode;
+		}
+	}
+
+	NodeQueue.Enqueue(Node);
+
+	while (!NodeQueue.IsEmpty())
+	{
+		UEdGraphNode* NextNode;
+		NodeQueue.Dequeue(NextNode);
+		NodeTree.Add(NextNode);
+
+		TArray<UEdGraphPin*> MyLinkedPins = FBAUtils::GetLinkedPins(NextNode, Direction);
+		if (IsNodeImpure(NextNode))
+		{
+			MyLinkedPins = MyLinkedPins.FilterByPredicate(FBAUtils::IsExecOrDelegatePin);
+		}
+
+		for (auto Pin : MyLinkedPins)
+		{
+			for (UEdGraphPin* LinkedPin : Pin->LinkedTo)
+			{
+				FPinLink Link(Pin, LinkedPin);
+
+				if (VisitedLinks.Contains(Link))
+				{
+					continue;
+				}
+
+				VisitedLinks.Add(Link);
+				NodeQueue.Enqueue(LinkedPin->GetOwningNode());
+			}
+		}
+	}
+
+	return NodeTree;
+}
+
+bool FBAUtils::DoesNodeHaveExecutionTo(const TSet<UEdGraphNode*>& ExecutionReachableNodes, UEdGraphNode* InNode)
+{
+	if (!InNode)
+	{
+		return false;
+	}
+
+	UEdGraphNode* Node = InNode;
+	if (FBAUtils::IsNodePure(Node))
+	{
+		if (UEdGraphNode* ExecNode = GetExecutingNode(Node))
+		{
+			Node = ExecNode;
+		}
+	}
+
+	return ExecutionReachableNodes.Contains(Node);
+}
+
 bool FBAUtils::IsLoopingPinLink(FPinLink& PinLink, EEdGraphPinDirection Direction)
 {
 	return FBAUtils::DoesNodeHaveExecutionTo(PinLink.GetToNode(), PinLink.GetFromNode(), Direction);
@@ -2018,6 +2090,37 @@ TSharedPtr<SWidget> FBAUtils::GetParentWidgetOfType(
 	return nullptr;
 }
 
+bool FBAUtils::IsWidgetInside(TSharedPtr<SWidget> Widget, TSharedPtr<SWidget> Ancestor, bool bVisibleOnly)
+{
+	if (!Ancestor.IsValid())
+	{
+		return false;
+	}
+
+	TSharedPtr<SWidget> Current = Widget;
+	while (Current.IsValid())
+	{
+		if (bVisibleOnly && (Current->GetVisibility() == EVisibility::Hidden || Current->GetVisibility() == EVisibility::Collapsed))
+		{
+			return false;
+		}
+
+		if (Current == Ancestor)
+		{
+			return true;
+		}
+
+		if (!Current->IsParentValid())
+		{
+			return false;
+		}
+
+		Current = Current->GetParentWidget();
+	}
+
+	return false;
+}
+
 TSharedPtr<SWidget> FBAUtils::ScanParentContainersForTypes(TSharedPtr<SWidget> Widget, const TArray<FName>& Types, const FName& StopAtParent)
 {
 	struct FLocal
@@ -2125,6 +2228,16 @@ TSharedPtr<SGraphPanel> FBAUtils::GetHoveredGraphPanel()
 	FWidgetPath Path = SlateApp.LocateWindowUnderMouse(SlateApp.GetCursorPos(), SlateApp.GetInteractiveTopLevelWindows());
 	if (Path.IsValid())
 	{
+		// usually the mouse is over the graph panel itself, which is on the path and needs no search of the children
+		for (int32 PathIndex = Path.Widgets.Num() - 1; PathIndex >= 0; PathIndex--)
+		{
+			TSharedRef<SWidget> Widget = Path.Widgets[PathIndex].Widget;
+			if (IsWidgetOfTypeFast(Widget, "SGraphPanel"))
+			{
+				return StaticCastSharedRef<SGraphPanel>(Widget);
+			}
+		}
+
 		for (int32 PathIndex = Path.Widgets.Num() - 1; PathIndex >= 0; PathIndex--)
 		{
 			TSharedRef<SWidget> Widget = Path.Widgets[PathIndex].Widget;
@@ -2143,135 +2256,86 @@ TSharedPtr<SGraphPanel> FBAUtils::GetHoveredGraphPanel()
 	return nullptr;
 }
 
-TSharedPtr<SGraphPin> FBAUtils::GetHoveredGraphPin(TSharedPtr<SGraphPanel> GraphPanel)
+namespace BAHoveredPins
 {
-	if (!GraphPanel.IsValid())
+	// the pins under the cursor come from the panel's pin grid, a wire hovers one of its pins wherever the cursor is
+	void Collect(TSharedPtr<SGraphPanel> GraphPanel, int32 MaxPins, TArray<TSharedPtr<SGraphPin>>& OutPins)
 	{
-		return nullptr;
-	}
+		if (!GraphPanel.IsValid())
+		{
+			return;
+		}
 
-	UEdGraph* Graph = GraphPanel->GetGraphObj();
-	if (Graph == nullptr)
-	{
-		return nullptr;
-	}
+		UEdGraph* Graph = GraphPanel->GetGraphObj();
+		if (Graph == nullptr)
+		{
+			return;
+		}
 
-	const bool bIsMaterialGraph = Graph->GetClass()->GetFName() == "MaterialGraph";
-	const bool bUseDirectlyHovered = UBASettings_Advanced::Get().bEnableMaterialGraphPinHoverFix && bIsMaterialGraph;
+		const bool bIsMaterialGraph = Graph->GetClass()->GetFName() == "MaterialGraph";
+		const bool bUseDirectlyHovered = UBASettings_Advanced::Get().bEnableMaterialGraphPinHoverFix && bIsMaterialGraph;
 
-	// check if graph pin "IsHovered" function
-	for (UEdGraphNode* Node : Graph->Nodes)
-	{
-		for (UEdGraphPin* Pin : Node->Pins)
+		// TODO: annoying bug where hover state can get locked if the panel is frozen and you move the cursor too fast
+		const auto IsHovered = [bUseDirectlyHovered](const TSharedPtr<SGraphPin>& GraphPin)
+		{
+			return bUseDirectlyHovered ? GraphPin->IsDirectlyHovered() : GraphPin->IsHovered();
+		};
+
+		const FBAPinHitGrid& Grid = FBAPinHitGrid::Get(GraphPanel);
+		const FVector2D CursorInGraph = FBAUtils::ScreenSpaceToPanelCoord(GraphPanel, FSlateApplication::Get().GetCursorPos());
+
+		TArray<TSharedPtr<SGraphPin>> Candidates;
+		Grid.QueryPoint(CursorInGraph, Candidates);
+		for (const TSharedPtr<SGraphPin>& GraphPin : Candidates)
 		{
-			if (!Pin->bHidden)
+			if (IsHovered(GraphPin))
 			{
-				TSharedPtr<SGraphPin> GraphPin = GetGraphPin(GraphPanel, Pin);
-				if (GraphPin.IsValid())
+				OutPins.Add(GraphPin);
+				if (OutPins.Num() >= MaxPins)
 				{
-					// TODO: annoying bug where hover state can get locked if the panel is frozen and you move the cursor too fast
-					const bool bIsHovered = bUseDirectlyHovered ? GraphPin->IsDirectlyHovered() : GraphPin->IsHovered();
-					if (bIsHovered)
-					{
-						return GraphPin;
-					}
+					return;
 				}
 			}
 		}
-	}
-
-	return nullptr;
-}
 
-TArray<TSharedPtr<SGraphPin>> FBAUtils::GetHoveredGraphPins(TSharedPtr<SGraphPanel> GraphPanel)
-{
-	TArray<TSharedPtr<SGraphPin>> OutPins;
-	if (!GraphPanel.IsValid())
-	{
-		return OutPins;
-	}
-
-	UEdGraph* Graph = GraphPanel->GetGraphObj();
-	if (Graph == nullptr)
-	{
-		return OutPins;
-	}
-
-	const bool bIsMaterialGraph = Graph->GetClass()->GetFName() == "MaterialGraph";
-	const bool bUseDirectlyHovered = UBASettings_Advanced::Get().bEnableMaterialGraphPinHoverFix && bIsMaterialGraph;
-
-	// check if graph pin "IsHovered" function
-	for (UEdGraphNode* Node : Graph->Nodes)
-	{
-		for (UEdGraphPin* Pin : Node->Pins)
+		Candidates.Reset();
+		Grid.GetLinkedPins(Candidates);
+		for (const TSharedPtr<SGraphPin>& GraphPin : Candidates)
 		{
-			if (!Pin->bHidden)
+			if (IsHovered(GraphPin) && !OutPins.Contains(GraphPin))
 			{
-				TSharedPtr<SGraphPin> GraphPin = GetGraphPin(GraphPanel, Pin);
-				if (GraphPin.IsValid())
+				OutPins.Add(GraphPin);
+				if (OutPins.Num() >= MaxPins)
 				{
-					// TODO: annoying bug where hover state can get locked if the panel is frozen and you move the cursor too fast
-					const bool bIsHovered = bUseDirectlyHovered ? GraphPin->IsDirectlyHovered() : GraphPin->IsHovered();
-					if (bIsHovered)
-					{
-						OutPins.Add(GraphPin);
-					}
+					return;
 				}
 			}
 		}
 	}
+}
 
-	return OutPins;
+TSharedPtr<SGraphPin> FBAUtils::GetHoveredGraphPin(TSharedPtr<SGraphPanel> GraphPanel)
+{
+	TArray<TSharedPtr<SGraphPin>> HoveredPins;
+	BAHoveredPins::Collect(GraphPanel, 1, HoveredPins);
+	return HoveredPins.Num() > 0 ? HoveredPins[0] : nullptr;
 }
 
-FPinLink FBAUtils::GetHoveredPinLink(TSharedPtr<SGraphPanel> GraphPanel)
+TArray<TSharedPtr<SGraphPin>> FBAUtils::GetHoveredGraphPins(TSharedPtr<SGraphPanel> GraphPanel)
 {
 	TArray<TSharedPtr<SGraphPin>> OutPins;
-	if (!GraphPanel.IsValid())
-	{
-		return FPinLink();
-	}
-
-	UEdGraph* Graph = GraphPanel->GetGraphObj();
-	if (Graph == nullptr)
-	{
-		return FPinLink();
-	}
-
-	UEdGraphPin* FirstPin = nullptr;
-
-	const bool bIsMaterialGraph = Graph->GetClass()->GetFName() == "MaterialGraph";
-	const bool bUseDirectlyHovered = UBASettings_Advanced::Get().bEnableMaterialGraphPinHoverFix && bIsMaterialGraph;
+	BAHoveredPins::Collect(GraphPanel, MAX_int32, OutPins);
+	return OutPins;
+}
 
-	// check if graph pin "IsHovered" function
-	for (UEdGraphNode* Node : Graph->Nodes)
-	{
-		for (UEdGraphPin* Pin : Node->Pins)
-		{
-			if (!Pin->bHidden)
-			{
-				TSharedPtr<SGraphPin> GraphPin = GetGraphPin(GraphPanel, Pin);
-				if (GraphPin.IsValid())
-				{
-					// TODO: annoying bug where hover state can get locked if the panel is frozen and you move the cursor too fast
-					const bool bIsHovered = bUseDirectlyHovered ? GraphPin->IsDirectlyHovered() : GraphPin->IsHovered();
-					if (bIsHovered)
-					{
-						if (!FirstPin)
-						{
-							FirstPin = Pin;
-						}
-						else
-						{
-							return FPinLink(FirstPin, Pin);
-						}
-					}
-				}
-			}
-		}
-	}
+FPinLink FBAUtils::GetHoveredPinLink(TSharedPtr<SGraphPanel> GraphPanel)
+{
+	TArray<TSharedPtr<SGraphPin>> HoveredPins;
+	BAHoveredPins::Collect(GraphPanel, 2, HoveredPins);
 
-	return FPinLink(FirstPin, nullptr);
+	UEdGraphPin* FirstPin = HoveredPins.Num() > 0 ? HoveredPins[0]->GetPinObj() : nullptr;
+	UEdGraphPin* SecondPin = HoveredPins.Num() > 1 ? HoveredPins[1]->GetPinObj() : nullptr;
+	return FPinLink(FirstPin, SecondPin);
 }
 
 UEdGraphPin* FBAUtils::GetHoveredPin(TSharedPtr<SGraphPanel> GraphPanel)
@@ -182,6 +182,7 @@ void SBABlueprintActionMenu::Construct(const FArguments& InArgs)
 			[
 				SAssignNew(FilteredList, SBAFilteredList<TSharedPtr<FBAActionMenuItem>>)
 				.InitListItems(this, &SBABlueprintActionMenu::InitListItems)
+				.GetSearchIndex(this, &SBABlueprintActionMenu::GetSearchIndex)
 				.OnGenerateRow(this, &SBABlueprintActionMenu::CreateItemWidget)
 				.OnSelectItem(this, &SBABlueprintActionMenu::SelectItem)
 				.WidgetSize(GetWidgetSize())
@@ -204,6 +205,21 @@ void SBABlueprintActionMenu::Construct(const FArguments& InArgs)
 
 void SBABlueprintActionMenu::InitListItems(TArray<TSharedPtr<FBAActionMenuItem>>& Items)
 {
+	ItemsSearchIndex.Reset();
+
+	UEdGraphPin* ContextPin = bUseSelectedPin ? GraphHandler->GetSelectedPin() : nullptr;
+
+	TSharedPtr<FBAActionMenuCache>& Cache = GraphHandler->GetActionMenuCache();
+	if (Cache.IsValid()
+		&& Cache->GraphChangeCount == GraphHandler->GetGraphChangeCount()
+		&& Cache->bContextSensitive == bContextSensitive
+		&& Cache->ContextPin.Get() == ContextPin)
+	{
+		Items = Cache->Items;
+		ItemsSearchIndex = Cache->SearchIndex;
+		return;
+	}
+
 	double ThisTime = 0;
 	{
 		SCOPE_SECONDS_COUNTER(ThisTime);
@@ -229,12 +245,9 @@ void SBABlueprintActionMenu::InitListItems(TArray<TSharedPtr<FBAActionMenuItem>>
 		FilterContext.Graphs.Add(GraphHandler->GetFocusedEdGraph());
 		FilterContext.Blueprints.Add(GraphHandler->GetBlueprint());
 
-		if (bUseSelectedPin)
+		if (ContextPin != nullptr)
 		{
-			if (UEdGraphPin* SelectedPin = GraphHandler->GetSelectedPin())
-			{
-				FilterContext.Pins.Add(SelectedPin);
-			}
+			FilterContext.Pins.Add(ContextPin);
 		}
 
 		constexpr uint32 OriginalFlagsMask = EContextTargetFlags::TARGET_Blueprint
@@ -246,7 +259,8 @@ void SBABlueprintActionMenu::InitListItems(TArray<TSharedPtr<FBAActionMenuItem>>
 			| EContextTargetFlags::TARGET_NonImportedTypes;
 
 		// NOTE: cannot call GetGraphContextActions() during serialization and GC due to its use of FindObject()
-		if (!GIsSavingPackage && !IsGarbageCollecting() && FilterContext.Blueprints.Num() > 0)
+		const bool bCanMakeMenu = !GIsSavingPackage && !IsGarbageCollecting() && FilterContext.Blueprints.Num() > 0;
+		if (bCanMakeMenu)
 		{
 			FBlueprintActionMenuUtils::MakeContextMenu(FilterContext, bContextSensitive, OriginalFlagsMask, MenuBuilder);
 		}
@@ -259,6 +273,17 @@ void SBABlueprintActionMenu::InitListItems(TArray<TSharedPtr<FBAActionMenuItem>>
 				Items.Add(MakeShared<FBAActionMenuItem>(EdGraphSchemaAction));
 			}
 		}
+
+		if (bCanMakeMenu)
+		{
+			Cache = MakeShared<FBAActionMenuCache>();
+			Cache->GraphChangeCount = GraphHandler->GetGraphChangeCount();
+			Cache->bContextSensitive = bContextSensitive;
+			Cache->ContextPin = FEdGraphPinReference(ContextPin);
+			Cache->Items = Items;
+			Cache->SearchIndex = MakeShared<FBAFilteredListSearchIndex>();
+			ItemsSearchIndex = Cache->SearchIndex;
+		}
 	}
 	UE_LOG(LogBlueprintAssist, Verbose, TEXT("Get all actions took %.2f"), ThisTime);
 }
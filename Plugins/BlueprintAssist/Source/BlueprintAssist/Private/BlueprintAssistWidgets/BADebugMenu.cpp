@@ -9,6 +9,7 @@
 #include "MaterialGraph/MaterialGraphNode.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "Widgets/Input/SEditableText.h"
+#include "Widgets/Layout/SBox.h"
 
 void SBADebugMenuRow::Construct(const FArguments& InArgs)
 {
@@ -23,6 +24,76 @@ void SBADebugMenuRow::Construct(const FArguments& InArgs)
 	];
 }
 
+namespace BADebugMenu
+{
+	const FName Column_Time("Time");
+	const FName Column_Graph("Graph");
+	const FName Column_Root("Root");
+	const FName Column_Nodes("Nodes");
+	const FName Column_Total("Total");
+	const FName Column_Memory("Memory");
+
+	FName GetPhaseColumn(EBAFormatterPhase Phase)
+	{
+		return FName(FBAFormatterProfiler::GetPhaseName(Phase));
+	}
+
+	FText FormatMilliseconds(double Seconds)
+	{
+		return FText::FromString(FString::Printf(TEXT("%.2f"), Seconds * 1000.0));
+	}
+}
+
+void SBAFormatterRunRow::Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FBAFormatterRun> InRun)
+{
+	Run = InRun;
+	SMultiColumnTableRow<TSharedPtr<FBAFormatterRun>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+}
+
+TSharedRef<SWidget> SBAFormatterRunRow::GenerateWidgetForColumn(const FName& ColumnName)
+{
+	using namespace BADebugMenu;
+
+	FText Text;
+	if (ColumnName == Column_Time)
+	{
+		Text = FText::FromString(Run->Time.ToString(TEXT("%H:%M:%S")));
+	}
+	else if (ColumnName == Column_Graph)
+	{
+		Text = FText::FromString(Run->GraphName);
+	}
+	else if (ColumnName == Column_Root)
+	{
+		Text = FText::FromString(Run->RootNodeName);
+	}
+	else if (ColumnName == Column_Nodes)
+	{
+		Text = FText::AsNumber(Run->NumNodes);
+	}
+	else if (ColumnName == Column_Total)
+	{
+		Text = FormatMilliseconds(Run->TotalSeconds);
+	}
+	else if (ColumnName == Column_Memory)
+	{
+		Text = FText::AsNumber(Run->MemoryDelta / 1024);
+	}
+	else
+	{
+		for (int32 i = 0; i < static_cast<int32>(EBAFormatterPhase::Num); ++i)
+		{
+			if (ColumnName == GetPhaseColumn(static_cast<EBAFormatterPhase>(i)))
+			{
+				Text = FormatMilliseconds(Run->PhaseSeconds[i]);
+				break;
+			}
+		}
+	}
+
+	return SNew(STextBlock).Text(Text);
+}
+
 void SBADebugMenu::Construct(const FArguments& InArgs)
 {
 	FocusedAssetEditor = FText::FromString("None");
@@ -146,11 +217,114 @@ void SBADebugMenu::Construct(const FArguments& InArgs)
 				return FReply::Handled();
 			})
 		]
+		+ SVerticalBox::Slot().AutoHeight().Padding(0, 8, 0, 0)
+		[
+			MakeFormatterRunsPanel()
+		]
 	];
 }
 
+TSharedRef<SWidget> SBADebugMenu::MakeFormatterRunsPanel()
+{
+	using namespace BADebugMenu;
+
+	TSharedRef<SHeaderRow> HeaderRow = SNew(SHeaderRow)
+		+ SHeaderRow::Column(Column_Time).DefaultLabel(INVTEXT("Time")).FillWidth(1.0f)
+		+ SHeaderRow::Column(Column_Graph).DefaultLabel(INVTEXT("Graph")).FillWidth(1.5f)
+		+ SHeaderRow::Column(Column_Root).DefaultLabel(INVTEXT("Root Node")).FillWidth(2.0f)
+		+ SHeaderRow::Column(Column_Nodes).DefaultLabel(INVTEXT("Nodes")).FillWidth(0.75f)
+		+ SHeaderRow::Column(Column_Total).DefaultLabel(INVTEXT("Total (ms)")).FillWidth(1.0f);
+
+	for (int32 i = 0; i < static_cast<int32>(EBAFormatterPhase::Num); ++i)
+	{
+		const EBAFormatterPhase Phase = static_cast<EBAFormatterPhase>(i);
+		HeaderRow->AddColumn(SHeaderRow::Column(GetPhaseColumn(Phase))
+			.DefaultLabel(FText::FromString(FBAFormatterProfiler::GetPhaseName(Phase)))
+			.FillWidth(1.0f));
+	}
+
+	HeaderRow->AddColumn(SHeaderRow::Column(Column_Memory)
+		.DefaultLabel(INVTEXT("Memory (KB)"))
+		.DefaultTooltip(INVTEXT("Change in used physical memory over the run, includes anything else the editor allocated meanwhile"))
+		.FillWidth(1.0f));
+
+	FormatterRuns = FBAFormatterProfiler::Get().GetRuns();
+
+	return SNew(SVerticalBox)
+		+ SVerticalBox::Slot().AutoHeight()
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(1.0f).VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(INVTEXT("Formatter Runs"))
+				.ToolTipText(INVTEXT("Phases are inclusive: parameters formatted while placing exec nodes also count towards Format X / Format Y"))
+			]
+			+ SHorizontalBox::Slot().AutoWidth()
+			[
+				SNew(SButton)
+				.Text(INVTEXT("Clear"))
+				.OnClicked_Lambda([&]()
+				{
+					FBAFormatterProfiler::Get().ClearRuns();
+					RefreshFormatterRuns();
+					return FReply::Handled();
+				})
+			]
+			+ SHorizontalBox::Slot().AutoWidth()
+			[
+				SNew(SButton)
+				.Text(INVTEXT("Export CSV"))
+				.OnClicked_Lambda([]()
+				{
+					const FString Path = FBAFormatterProfiler::Get().ExportCSV();
+					if (Path.IsEmpty())
+					{
+						UE_LOG(LogBlueprintAssist, Warning, TEXT("Failed to export formatter runs"));
+					}
+					else
+					{
+						UE_LOG(LogBlueprintAssist, Log, TEXT("Exported formatter runs to %s"), *Path);
+					}
+
+					return FReply::Handled();
+				})
+			]
+		]
+		+ SVerticalBox::Slot().AutoHeight()
+		[
+			SNew(SBox)
+			.MaxDesiredHeight(300.0f)
+			[
+				SAssignNew(FormatterRunsView, SListView<TSharedPtr<FBAFormatterRun>>)
+				.ListItemsSource(&FormatterRuns)
+				.HeaderRow(HeaderRow)
+				.OnGenerateRow_Lambda([](TSharedPtr<FBAFormatterRun> Run, const TSharedRef<STableViewBase>& OwnerTable)
+				{
+					return SNew(SBAFormatterRunRow, OwnerTable, Run);
+				})
+			]
+		];
+}
+
+void SBADebugMenu::RefreshFormatterRuns()
+{
+	FormatterRuns = FBAFormatterProfiler::Get().GetRuns();
+	if (FormatterRunsView)
+	{
+		FormatterRunsView->RequestListRefresh();
+	}
+}
+
 void SBADebugMenu::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
 {
+	// runs are only ever added at the front
+	const TArray<TSharedPtr<FBAFormatterRun>>& Runs = FBAFormatterProfiler::Get().GetRuns();
+	if (Runs.Num() != FormatterRuns.Num() || (Runs.Num() > 0 && Runs[0] != FormatterRuns[0]))
+	{
+		RefreshFormatterRuns();
+	}
+
 	if (IAssetEditorInstance* Editor = FBAUtils::GetEditorFromActiveTab())
 	{
 		FocusedAssetEditor = FText::FromString(Editor->GetEditorName().ToString());
@@ -0,0 +1,113 @@
+﻿// Copyright 2021 fpwong. All Rights Reserved.
+
+#include "BlueprintAssistWidgets/BAFilteredList.h"
+
+void FBAFilteredListSearchIndex::Reset(int32 NumItems)
+{
+	SearchTexts.Reset(NumItems);
+	KeySearchTexts.Reset(NumItems);
+	TrigramPostings.Reset();
+}
+
+void FBAFilteredListSearchIndex::AddItem(const FString& SearchText, const FString& KeySearchText)
+{
+	const int32 ItemIndex = SearchTexts.Num();
+
+	FString& LowerSearchText = SearchTexts.Add_GetRef(SearchText.Replace(TEXT(" "), TEXT("")).ToLower());
+	KeySearchTexts.Add(KeySearchText.ToLower());
+
+	for (int32 CharIndex = 0; CharIndex + 3 <= LowerSearchText.Len(); ++CharIndex)
+	{
+		// the item's own postings are added last, checking the tail is enough to skip repeated trigrams
+		TArray<int32>& Postings = TrigramPostings.FindOrAdd(GetTrigram(*LowerSearchText + CharIndex));
+		if (Postings.Num() == 0 || Postings.Last() != ItemIndex)
+		{
+			Postings.Add(ItemIndex);
+		}
+	}
+}
+
+void FBAFilteredListSearchIndex::Filter(const TArray<FString>& Terms, const TArray<int32>* Candidates, TArray<int32>& OutMatches) const
+{
+	OutMatches.Reset();
+
+	// walk the shortest list of items which may match, then check the terms on each of them
+	const TArray<int32>* ItemsToCheck = Candidates;
+	for (const FString& Term : Terms)
+	{
+		for (int32 CharIndex = 0; CharIndex + 3 <= Term.Len(); ++CharIndex)
+		{
+			const TArray<int32>* Postings = TrigramPostings.Find(GetTrigram(*Term + CharIndex));
+			if (!Postings)
+			{
+				return;
+			}
+
+			if (!ItemsToCheck || Postings->Num() < ItemsToCheck->Num())
+			{
+				ItemsToCheck = Postings;
+			}
+		}
+	}
+
+	const auto MatchesAllTerms = [&](int32 ItemIndex)
+	{
+		for (const FString& Term : Terms)
+		{
+			if (!SearchTexts[ItemIndex].Contains(Term, ESearchCase::CaseSensitive))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	if (ItemsToCheck)
+	{
+		for (int32 ItemIndex : *ItemsToCheck)
+		{
+			if (MatchesAllTerms(ItemIndex))
+			{
+				OutMatches.Add(ItemIndex);
+			}
+		}
+	}
+	else
+	{
+		// only terms shorter than a trigram, nothing narrows the search
+		for (int32 ItemIndex = 0; ItemIndex < SearchTexts.Num(); ++ItemIndex)
+		{
+			if (MatchesAllTerms(ItemIndex))
+			{
+				OutMatches.Add(ItemIndex);
+			}
+		}
+	}
+}
+
+void FBAFilteredListSearchIndex::SortMatches(const FString& FilterString, TArray<int32>& Matches) const
+{
+	const FString LowerFilterString = FilterString.ToLower();
+	Matches.StableSort([&](int32 IndexA, int32 IndexB)
+	{
+		const FString& KeyA = KeySearchTexts[IndexA];
+		const FString& KeyB = KeySearchTexts[IndexB];
+
+		const bool bExactA = KeyA.Equals(LowerFilterString, ESearchCase::CaseSensitive);
+		const bool bExactB = KeyB.Equals(LowerFilterString, ESearchCase::CaseSensitive);
+		if (bExactA != bExactB)
+		{
+			return bExactA;
+		}
+
+		return KeyA.Len() < KeyB.Len();
+	});
+}
+
+uint64 FBAFilteredListSearchIndex::GetTrigram(const TCHAR* Chars)
+{
+	return static_cast<uint64>(static_cast<uint16>(Chars[0]))
+		| static_cast<uint64>(static_cast<uint16>(Chars[1])) << 16
+		| static_cast<uint64>(static_cast<uint16>(Chars[2])) << 32;
+}
@@ -8,6 +8,67 @@
 #include "BlueprintAssistUtils.h"
 #include "SGraphPanel.h"
 #include "EdGraph/EdGraph.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/DrawElements.h"
+#include "Rendering/SlateRenderer.h"
+#include "Styling/CoreStyle.h"
+
+namespace BAGraphOverlay
+{
+	// lines and bounds kept at most, a big format all draws thousands and the oldest are dropped past this
+	constexpr int32 MaxPrimitives = 4096;
+
+	// lines and bounds painted per frame
+	constexpr int32 MaxPrimitivesPerFrame = 1024;
+
+	// seconds over which a line or bounds fades out before it expires
+	constexpr float FadeOutTime = 0.5f;
+
+	constexpr float LineThickness = 5.0f;
+	constexpr float BoundsThickness = 2.0f;
+
+	FColor GetFadedColor(const FLinearColor& Color, float TimeRemaining)
+	{
+		FLinearColor Faded = Color;
+		Faded.A *= FMath::Clamp(TimeRemaining / FadeOutTime, 0.0f, 1.0f);
+		return Faded.ToFColor(true);
+	}
+
+	struct FPrimitiveBatch
+	{
+		FSlateRenderTransform RenderTransform;
+		TArray<FSlateVertex> Vertices;
+		TArray<SlateIndex> Indices;
+
+		void AddSegment(const FVector2D& Start, const FVector2D& End, float Thickness, const FColor& Color)
+		{
+			const FVector2D Direction = (End - Start).GetSafeNormal();
+			const FVector2D Normal = FVector2D(-Direction.Y, Direction.X) * Thickness * 0.5f;
+
+			// extend along the segment too, so the corners of bounds are closed
+			const FVector2D Extent = Direction * Thickness * 0.5f;
+
+			const int32 FirstVertex = Vertices.Num();
+			AddVertex(Start - Extent + Normal, Color);
+			AddVertex(Start - Extent - Normal, Color);
+			AddVertex(End + Extent + Normal, Color);
+			AddVertex(End + Extent - Normal, Color);
+
+			Indices.Append({
+				static_cast<SlateIndex>(FirstVertex), static_cast<SlateIndex>(FirstVertex + 1), static_cast<SlateIndex>(FirstVertex + 2),
+				static_cast<SlateIndex>(FirstVertex + 2), static_cast<SlateIndex>(FirstVertex + 1), static_cast<SlateIndex>(FirstVertex + 3) });
+		}
+
+		void AddVertex(const FVector2D& Position, const FColor& Color)
+		{
+#if BA_UE_VERSION_OR_LATER(5, 0)
+			Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(Position), FVector4f(0.5f, 0.5f, 1.0f, 1.0f), FVector2f(1.0f, 1.0f), Color));
+#else
+			Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, Position, FVector4(0.5f, 0.5f, 1.0f, 1.0f), FVector2D(1.0f, 1.0f), Color));
+#endif
+		}
+	};
+}
 
 void FBADebugDraw_Line::Draw(TSharedPtr<SBlueprintAssistGraphOverlay> Overlay)
 {
@@ -21,6 +82,7 @@ void SBlueprintAssistGraphOverlay::Construct(const FArguments& InArgs, TSharedPt
 
 	CachedBorderBrush = FBAStyle::GetBrush("BlueprintAssist.WhiteBorder");
 	CachedLockBrush = FBAStyle::GetPluginBrush("BlueprintAssist.Lock");
+	CachedWhiteBrush = FCoreStyle::Get().GetBrush("GenericWhiteBox");
 
 	SetCanTick(true);
 
@@ -109,46 +171,7 @@ int32 SBlueprintAssistGraphOverlay::OnPaint(const FPaintArgs& Args, const FGeome
 		}
 	}
 
-	// draw lines
-	for (const FBAGraphOverlayLineParams& ToDraw : LinesToDraw)
-	{
-		const FVector2D Start = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Start);
-		const FVector2D End = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.End);
-		TArray<FVector2D> LinePoints = { Start, End };
-
-		FSlateDrawElement::MakeLines(
-			OutDrawElements,
-			LayerId,
-			AllottedGeometry.ToPaintGeometry(),
-			LinePoints,
-			ESlateDrawEffect::None,
-			ToDraw.Color,
-			true,
-			5.0f);
-	}
-
-	// draw bounds
-	for (const FBAGraphOverlayBounds& ToDraw : BoundsToDraw)
-	{
-		if (GraphPanel->IsRectVisible(ToDraw.Bounds.GetBottomRight(), ToDraw.Bounds.GetTopLeft()))
-		{
-			const FVector2D TL = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Bounds.GetTopLeft());
-			const FVector2D TR = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Bounds.GetTopRight());
-			const FVector2D BL = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Bounds.GetBottomLeft());
-			const FVector2D BR = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Bounds.GetBottomRight());
-			TArray<FVector2D> LinePoints = { TL, TR, BR, BL, TL };
-
-			FSlateDrawElement::MakeLines(
-				OutDrawElements,
-				LayerId,
-				AllottedGeometry.ToPaintGeometry(),
-				LinePoints,
-				ESlateDrawEffect::None,
-				ToDraw.Color,
-				true,
-				2.0f);
-		}
-	}
+	DrawDebugPrimitives(OutDrawElements, AllottedGeometry, LayerId, GraphPanel);
 
 	DrawNodeGroups(OutDrawElements, AllottedGeometry, OutgoingLayer, GraphPanel);
 
@@ -181,22 +204,28 @@ int32 SBlueprintAssistGraphOverlay::OnPaint(const FPaintArgs& Args, const FGeome
 
 void SBlueprintAssistGraphOverlay::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
 {
-	for (int i = LinesToDraw.Num() - 1; i >= 0; --i)
+	for (FBAGraphOverlayLineParams& Line : LinesToDraw)
 	{
-		LinesToDraw[i].TimeRemaining -= InDeltaTime;
-		if (LinesToDraw[i].TimeRemaining <= 0)
-		{
-			LinesToDraw.RemoveAt(i);
-		}
+		Line.TimeRemaining -= InDeltaTime;
 	}
 
-	for (int i = BoundsToDraw.Num() - 1; i >= 0; --i)
+	for (FBAGraphOverlayBounds& Bounds : BoundsToDraw)
 	{
-		BoundsToDraw[i].TimeRemaining -= InDeltaTime;
-		if (BoundsToDraw[i].TimeRemaining <= 0)
-		{
-			BoundsToDraw.RemoveAt(i);
-		}
+		Bounds.TimeRemaining -= InDeltaTime;
+	}
+
+	// one pass each, removing expired entries one at a time is quadratic with thousands of them
+	LinesToDraw.RemoveAll([](const FBAGraphOverlayLineParams& Line) { return Line.TimeRemaining <= 0; });
+	BoundsToDraw.RemoveAll([](const FBAGraphOverlayBounds& Bounds) { return Bounds.TimeRemaining <= 0; });
+
+	if (LinesToDraw.Num() > BAGraphOverlay::MaxPrimitives)
+	{
+		LinesToDraw.RemoveAt(0, LinesToDraw.Num() - BAGraphOverlay::MaxPrimitives);
+	}
+
+	if (BoundsToDraw.Num() > BAGraphOverlay::MaxPrimitives)
+	{
+		BoundsToDraw.RemoveAt(0, BoundsToDraw.Num() - BAGraphOverlay::MaxPrimitives);
 	}
 
 	if (NextItem <= 0)
@@ -260,6 +289,66 @@ void SBlueprintAssistGraphOverlay::DrawWidgetAsBox(
 	);
 }
 
+void SBlueprintAssistGraphOverlay::DrawDebugPrimitives(
+	FSlateWindowElementList& OutDrawElements,
+	const FGeometry& AllottedGeometry,
+	const int32 LayerId,
+	TSharedPtr<SGraphPanel> GraphPanel) const
+{
+	if ((LinesToDraw.Num() == 0 && BoundsToDraw.Num() == 0) || !FSlateApplication::IsInitialized())
+	{
+		return;
+	}
+
+	BAGraphOverlay::FPrimitiveBatch Batch;
+	Batch.RenderTransform = AllottedGeometry.GetAccumulatedRenderTransform();
+
+	int32 Budget = BAGraphOverlay::MaxPrimitivesPerFrame;
+
+	// newest first, those are the ones being looked at
+	for (int32 i = BoundsToDraw.Num() - 1; i >= 0 && Budget > 0; --i)
+	{
+		const FBAGraphOverlayBounds& ToDraw = BoundsToDraw[i];
+		if (!GraphPanel->IsRectVisible(ToDraw.Bounds.GetBottomRight(), ToDraw.Bounds.GetTopLeft()))
+		{
+			continue;
+		}
+
+		const FVector2D TL = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Bounds.GetTopLeft());
+		const FVector2D TR = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Bounds.GetTopRight());
+		const FVector2D BL = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Bounds.GetBottomLeft());
+		const FVector2D BR = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Bounds.GetBottomRight());
+		const FColor Color = BAGraphOverlay::GetFadedColor(ToDraw.Color, ToDraw.TimeRemaining);
+
+		Batch.AddSegment(TL, TR, BAGraphOverlay::BoundsThickness, Color);
+		Batch.AddSegment(TR, BR, BAGraphOverlay::BoundsThickness, Color);
+		Batch.AddSegment(BR, BL, BAGraphOverlay::BoundsThickness, Color);
+		Batch.AddSegment(BL, TL, BAGraphOverlay::BoundsThickness, Color);
+		--Budget;
+	}
+
+	for (int32 i = LinesToDraw.Num() - 1; i >= 0 && Budget > 0; --i)
+	{
+		const FBAGraphOverlayLineParams& ToDraw = LinesToDraw[i];
+		const FVector2D Start = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.Start);
+		const FVector2D End = FBAUtils::GraphCoordToPanelCoord(GraphPanel, ToDraw.End);
+
+		Batch.AddSegment(Start, End, BAGraphOverlay::LineThickness, BAGraphOverlay::GetFadedColor(ToDraw.Color, ToDraw.TimeRemaining));
+		--Budget;
+	}
+
+	if (Batch.Indices.Num() == 0)
+	{
+		return;
+	}
+
+	const FSlateResourceHandle ResourceHandle = FSlateApplication::Get().GetRenderer()->GetResourceHandle(*CachedWhiteBrush);
+	if (ResourceHandle.IsValid())
+	{
+		FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, ResourceHandle, Batch.Vertices, Batch.Indices, nullptr, 0, 0);
+	}
+}
+
 void SBlueprintAssistGraphOverlay::DrawBoundsAsLines(
 	FSlateWindowElementList& OutDrawElements,
 	const FGeometry& AllottedGeometry,
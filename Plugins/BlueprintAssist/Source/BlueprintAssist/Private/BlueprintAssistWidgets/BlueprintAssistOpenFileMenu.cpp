@@ -4,9 +4,10 @@
 
 #include "Editor.h"
 #include "SlateOptMacros.h"
+#include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/LazySingleton.h"
 #include "Modules/ModuleManager.h"
-#include "Stats/StatsMisc.h"
 #include "Subsystems/AssetEditorSubsystem.h"
 
 BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
@@ -28,24 +29,7 @@ END_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
 void SBAOpenFileMenu::InitListItems(TArray<TSharedPtr<FBAFileItem>>& Items)
 {
-	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
-
-	TArray<FAssetData> OutAssetData;
-
-	double ThisTime = 0;
-	{
-		SCOPE_SECONDS_COUNTER(ThisTime);
-		AssetRegistry.GetAllAssets(OutAssetData, false);
-	}
-	UE_LOG(LogTemp, Warning, TEXT("Get all assets took %.2f"), ThisTime);
-
-	for (FAssetData& AssetData : OutAssetData)
-	{
-		if (!AssetData.IsRedirector() && AssetData.IsUAsset())
-		{
-			Items.Add(MakeShared<FBAFileItem>(AssetData.AssetName.ToString()));
-		}
-	}
+	FBAOpenFileItems::Get().GetItems(Items);
 }
 
 TSharedRef<ITableRow> SBAOpenFileMenu::CreateItemWidget(TSharedPtr<FBAFileItem> Item, const TSharedRef<STableViewBase>& OwnerTable) const
@@ -72,3 +56,107 @@ void SBAOpenFileMenu::SelectItem(TSharedPtr<FBAFileItem> Item)
 		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(Item->FilePath);
 	}
 }
+
+FBAOpenFileItems& FBAOpenFileItems::Get()
+{
+	return TLazySingleton<FBAOpenFileItems>::Get();
+}
+
+void FBAOpenFileItems::TearDown()
+{
+	TLazySingleton<FBAOpenFileItems>::TearDown();
+}
+
+FBAOpenFileItems::~FBAOpenFileItems()
+{
+	if (!bInitialized)
+	{
+		return;
+	}
+
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnAssetAdded().RemoveAll(this);
+		AssetRegistry.OnAssetRemoved().RemoveAll(this);
+		AssetRegistry.OnAssetRenamed().RemoveAll(this);
+	}
+}
+
+void FBAOpenFileItems::GetItems(TArray<TSharedPtr<FBAFileItem>>& OutItems)
+{
+	if (!bInitialized)
+	{
+		Init();
+	}
+
+	if (bItemsDirty)
+	{
+		ItemsByObjectPath.GenerateValueArray(Items);
+		bItemsDirty = false;
+	}
+
+	OutItems.Append(Items);
+}
+
+void FBAOpenFileItems::Init()
+{
+	bInitialized = true;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	TArray<FAssetData> OutAssetData;
+	AssetRegistry.GetAllAssets(OutAssetData, false);
+
+	ItemsByObjectPath.Reserve(OutAssetData.Num());
+	for (const FAssetData& AssetData : OutAssetData)
+	{
+		OnAssetAdded(AssetData);
+	}
+
+	// assets the registry is still discovering arrive through these
+	AssetRegistry.OnAssetAdded().AddRaw(this, &FBAOpenFileItems::OnAssetAdded);
+	AssetRegistry.OnAssetRemoved().AddRaw(this, &FBAOpenFileItems::OnAssetRemoved);
+	AssetRegistry.OnAssetRenamed().AddRaw(this, &FBAOpenFileItems::OnAssetRenamed);
+}
+
+bool FBAOpenFileItems::IsListedAsset(const FAssetData& AssetData)
+{
+	return !AssetData.IsRedirector() && AssetData.IsUAsset();
+}
+
+FString FBAOpenFileItems::GetObjectPath(const FAssetData& AssetData)
+{
+#if BA_UE_VERSION_OR_LATER(5, 1)
+	return AssetData.GetObjectPathString();
+#else
+	return AssetData.ObjectPath.ToString();
+#endif
+}
+
+void FBAOpenFileItems::OnAssetAdded(const FAssetData& AssetData)
+{
+	if (IsListedAsset(AssetData))
+	{
+		ItemsByObjectPath.Add(GetObjectPath(AssetData), MakeShared<FBAFileItem>(AssetData.AssetName.ToString()));
+		bItemsDirty = true;
+	}
+}
+
+void FBAOpenFileItems::OnAssetRemoved(const FAssetData& AssetData)
+{
+	if (ItemsByObjectPath.Remove(GetObjectPath(AssetData)) > 0)
+	{
+		bItemsDirty = true;
+	}
+}
+
+void FBAOpenFileItems::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (ItemsByObjectPath.Remove(OldObjectPath) > 0)
+	{
+		bItemsDirty = true;
+	}
+
+	OnAssetAdded(AssetData);
+}
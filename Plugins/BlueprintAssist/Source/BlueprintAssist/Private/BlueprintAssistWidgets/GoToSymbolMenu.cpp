@@ -11,6 +11,7 @@
 #include "EdGraph/EdGraph.h"
 #include "EdGraph/EdGraphNode.h"
 #include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/LazySingleton.h"
 #include "Widgets/Images/SImage.h"
 #include "Widgets/Input/SSearchBox.h"
 #include "Widgets/Views/STableRow.h"
@@ -34,54 +35,9 @@ void SGoToSymbolMenu::InitListItems(TArray<TSharedPtr<FGoToSymbolStruct>>& Items
 	UBlueprint* Blueprint = FBAMiscUtils::GetAssetForActiveTab<UBlueprint>();
 	check(Blueprint)
 
-	TArray<UEdGraph*> BlueprintGraphs;
-	Blueprint->GetAllGraphs(BlueprintGraphs);
-
 	Items.Empty();
 
-	for (UEdGraph* Graph : BlueprintGraphs)
-	{
-		const EGraphType GraphType = FBAUtils::GetGraphType(Graph);
-
-		if (Blueprint->DelegateSignatureGraphs.Contains(Graph))
-		{
-			continue;
-		}
-
-		// add all event nodes on the graph for ubergraphs
-		if (GraphType == GT_Ubergraph)
-		{
-			TArray<UEdGraphNode*> EventNodes;
-			Graph->GetNodesOfClass(EventNodes);
-
-			EventNodes = EventNodes.FilterByPredicate(
-				[](UEdGraphNode* Node)
-				{
-					return Node->GetClass()->ImplementsInterface(UK2Node_EventNodeInterface::StaticClass());
-				});
-
-			EventNodes.Sort([](const UEdGraphNode& NodeA, const UEdGraphNode& NodeB)
-			{
-				const bool bIsEventA = NodeA.GetClass() == UK2Node_Event::StaticClass();
-				const bool bIsEventB = NodeB.GetClass() == UK2Node_Event::StaticClass();
-				if (bIsEventA != bIsEventB) return bIsEventA > bIsEventB;
-
-				const bool bIsCustomEventA = NodeA.GetClass() == UK2Node_CustomEvent::StaticClass();
-				const bool bIsCustomEventB = NodeB.GetClass() == UK2Node_CustomEvent::StaticClass();
-				if (bIsCustomEventA != bIsCustomEventB) return bIsCustomEventA > bIsCustomEventB;
-
-				return true;
-			});
-
-			for (UEdGraphNode* Node : EventNodes)
-			{
-				Items.Add(MakeShareable(new FGoToSymbolStruct(Node, Graph)));
-			}
-		}
-
-		// add the graph itself
-		Items.Add(MakeShareable(new FGoToSymbolStruct(nullptr, Graph)));
-	}
+	FBAGoToSymbolCache::Get().GetSymbols(Blueprint, Items);
 }
 
 TSharedRef<ITableRow> SGoToSymbolMenu::CreateItemWidget(TSharedPtr<FGoToSymbolStruct> Item, const TSharedRef<STableViewBase>& OwnerTable) const
@@ -183,3 +139,133 @@ FString FGoToSymbolStruct::GetTypeDescription() const
 		? FString("Event")
 		: FBAUtils::GraphTypeToString(FBAUtils::GetGraphType(Graph));
 }
+
+/**********************/
+/* FBAGoToSymbolCache */
+/**********************/
+
+FBAGoToSymbolCache& FBAGoToSymbolCache::Get()
+{
+	return TLazySingleton<FBAGoToSymbolCache>::Get();
+}
+
+void FBAGoToSymbolCache::TearDown()
+{
+	TLazySingleton<FBAGoToSymbolCache>::TearDown();
+}
+
+FBAGoToSymbolCache::~FBAGoToSymbolCache()
+{
+	for (const auto& Elem : SymbolsByBlueprint)
+	{
+		if (UBlueprint* Blueprint = Elem.Key.Get())
+		{
+			Blueprint->OnChanged().RemoveAll(this);
+			Blueprint->OnCompiled().RemoveAll(this);
+		}
+	}
+}
+
+void FBAGoToSymbolCache::GetSymbols(UBlueprint* Blueprint, TArray<TSharedPtr<FGoToSymbolStruct>>& OutItems)
+{
+	// drop the blueprints which have since been unloaded
+	for (auto It = SymbolsByBlueprint.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	FBlueprintSymbols* Symbols = SymbolsByBlueprint.Find(Blueprint);
+	if (!Symbols)
+	{
+		Symbols = &SymbolsByBlueprint.Add(Blueprint);
+		Blueprint->OnChanged().AddRaw(this, &FBAGoToSymbolCache::OnBlueprintChanged);
+		Blueprint->OnCompiled().AddRaw(this, &FBAGoToSymbolCache::OnBlueprintChanged);
+	}
+
+	if (Symbols->bDirty || Symbols->IsStale())
+	{
+		CollectSymbols(Blueprint, *Symbols);
+	}
+
+	OutItems.Append(Symbols->Items);
+}
+
+bool FBAGoToSymbolCache::FBlueprintSymbols::IsStale() const
+{
+	for (const TWeakObjectPtr<UObject>& Object : Objects)
+	{
+		if (!Object.IsValid())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FBAGoToSymbolCache::CollectSymbols(UBlueprint* Blueprint, FBlueprintSymbols& OutSymbols)
+{
+	OutSymbols.Items.Reset();
+	OutSymbols.Objects.Reset();
+	OutSymbols.bDirty = false;
+
+	TArray<UEdGraph*> BlueprintGraphs;
+	Blueprint->GetAllGraphs(BlueprintGraphs);
+
+	for (UEdGraph* Graph : BlueprintGraphs)
+	{
+		const EGraphType GraphType = FBAUtils::GetGraphType(Graph);
+
+		if (Blueprint->DelegateSignatureGraphs.Contains(Graph))
+		{
+			continue;
+		}
+
+		// add all event nodes on the graph for ubergraphs
+		if (GraphType == GT_Ubergraph)
+		{
+			TArray<UEdGraphNode*> EventNodes;
+			Graph->GetNodesOfClass(EventNodes);
+
+			EventNodes = EventNodes.FilterByPredicate(
+				[](UEdGraphNode* Node)
+				{
+					return Node->GetClass()->ImplementsInterface(UK2Node_EventNodeInterface::StaticClass());
+				});
+
+			EventNodes.StableSort([](const UEdGraphNode& NodeA, const UEdGraphNode& NodeB)
+			{
+				const bool bIsEventA = NodeA.GetClass() == UK2Node_Event::StaticClass();
+				const bool bIsEventB = NodeB.GetClass() == UK2Node_Event::StaticClass();
+				if (bIsEventA != bIsEventB) return bIsEventA > bIsEventB;
+
+				const bool bIsCustomEventA = NodeA.GetClass() == UK2Node_CustomEvent::StaticClass();
+				const bool bIsCustomEventB = NodeB.GetClass() == UK2Node_CustomEvent::StaticClass();
+				if (bIsCustomEventA != bIsCustomEventB) return bIsCustomEventA > bIsCustomEventB;
+
+				return false;
+			});
+
+			for (UEdGraphNode* Node : EventNodes)
+			{
+				OutSymbols.Items.Add(MakeShareable(new FGoToSymbolStruct(Node, Graph)));
+				OutSymbols.Objects.Add(Node);
+			}
+		}
+
+		// add the graph itself
+		OutSymbols.Items.Add(MakeShareable(new FGoToSymbolStruct(nullptr, Graph)));
+		OutSymbols.Objects.Add(Graph);
+	}
+}
+
+void FBAGoToSymbolCache::OnBlueprintChanged(UBlueprint* Blueprint)
+{
+	if (FBlueprintSymbols* Symbols = SymbolsByBlueprint.Find(Blueprint))
+	{
+		Symbols->bDirty = true;
+	}
+}
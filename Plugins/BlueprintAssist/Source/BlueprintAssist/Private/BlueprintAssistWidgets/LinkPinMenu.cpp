@@ -79,15 +79,14 @@ SLinkPinMenu::~SLinkPinMenu()
 
 void SLinkPinMenu::InitListItems(TArray<TSharedPtr<FPinLinkerStruct>>& Items)
 {
-	// sort pins by output then input
-	UEdGraph* Graph = GraphHandler->GetFocusedEdGraph();
-
 	UEdGraphNode* SourceNode = SourcePin->GetOwningNode();
 
-	TArray<UEdGraphNode*> AllNodes = Graph->Nodes;
+	// the graph's pins we can connect to, the schema is only asked once per pin type
+	TArray<UEdGraphPin*> ConnectablePins;
+	GraphHandler->GetPinCompatibilityIndex().GetConnectablePins(SourcePin, ConnectablePins);
 
-	// sort nodes by distance to pin
-	const auto Sorter = [MySourcePin = SourcePin, SourceNode](UEdGraphNode& NodeA, UEdGraphNode& NodeB)
+	// sort pins by the distance of their node to the pin
+	const auto Sorter = [MySourcePin = SourcePin, SourceNode](const UEdGraphNode& NodeA, const UEdGraphNode& NodeB)
 	{
 		int DistA = FBAUtils::DistanceSquaredBetweenNodes(SourceNode, &NodeA);
 		int DistB = FBAUtils::DistanceSquaredBetweenNodes(SourceNode, &NodeB);
@@ -114,34 +113,37 @@ void SLinkPinMenu::InitListItems(TArray<TSharedPtr<FPinLinkerStruct>>& Items)
 		return DistA < DistB;
 	};
 
-	AllNodes.Sort(Sorter);
+	// stable, the pins of a node keep their order
+	ConnectablePins.StableSort([&Sorter](const UEdGraphPin& PinA, const UEdGraphPin& PinB)
+	{
+		return Sorter(*PinA.GetOwningNode(), *PinB.GetOwningNode());
+	});
 
 	TMap<FName, int> SeenPinNames;
 
 	// grab pins from the graph for the user to select
-	for (UEdGraphNode* Node : AllNodes)
+	for (UEdGraphPin* Pin : ConnectablePins)
 	{
-		for (UEdGraphPin* Pin : Node->Pins)
+		// skip pins which we are already linked to
+		if (SourcePin->LinkedTo.Contains(Pin))
 		{
-			// skip hidden | pins which we are already linked to | pins we can't connect to
-			if (!Pin->bHidden && !SourcePin->LinkedTo.Contains(Pin) && CanConnectSourceToPin(Pin))
-			{
-				FName PinName = Pin->GetFName();
-				SeenPinNames.FindOrAdd(PinName, 0) += 1;
-
-				FString PinUniqueName = FString::Printf(TEXT("%s_%d"), *PinName.ToString(), SeenPinNames[PinName]);
-
-				auto Item = MakeShareable(new FPinLinkerStruct(Pin,PinUniqueName));
-				Items.Add(Item);
-
-				TSharedPtr<SGraphPin> GraphPin = FBAUtils::GetGraphPin(GraphHandler->GetGraphPanel(), Pin);
-				FBAGraphOverlayTextParams Params;
-				Params.Text = FText::FromString(PinUniqueName);
-				Params.Widget = GraphPin;
-				Params.WidgetBounds = FBAUtils::GetPinBounds(GraphPin);
-				GraphHandler->GetGraphOverlay()->DrawTextOverWidget(Params);
-			}
+			continue;
 		}
+
+		FName PinName = Pin->GetFName();
+		SeenPinNames.FindOrAdd(PinName, 0) += 1;
+
+		FString PinUniqueName = FString::Printf(TEXT("%s_%d"), *PinName.ToString(), SeenPinNames[PinName]);
+
+		auto Item = MakeShareable(new FPinLinkerStruct(Pin,PinUniqueName));
+		Items.Add(Item);
+
+		TSharedPtr<SGraphPin> GraphPin = FBAUtils::GetGraphPin(GraphHandler->GetGraphPanel(), Pin);
+		FBAGraphOverlayTextParams Params;
+		Params.Text = FText::FromString(PinUniqueName);
+		Params.Widget = GraphPin;
+		Params.WidgetBounds = FBAUtils::GetPinBounds(GraphPin);
+		GraphHandler->GetGraphOverlay()->DrawTextOverWidget(Params);
 	}
 }
 
@@ -211,13 +213,6 @@ void SLinkPinMenu::MarkActiveSuggestion(TSharedPtr<FPinLinkerStruct> Item)
 	LastSelectedItem = Item;
 }
 
-bool SLinkPinMenu::CanConnectSourceToPin(UEdGraphPin* Pin)
-{
-	const UEdGraphSchema* Schema = Pin->GetSchema();
-	const FPinConnectionResponse Response = Schema->CanCreateConnection(SourcePin, Pin);
-	return Response.Response != CONNECT_RESPONSE_DISALLOW;
-}
-
 void SLinkPinMenu::Tick(
 	const FGeometry& AllottedGeometry,
 	const double InCurrentTime,
@@ -23,6 +23,7 @@
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetRegistry/IAssetRegistry.h"
 #include "Engine/DeveloperSettings.h"
+#include "Misc/LazySingleton.h"
 #include "UObject/UObjectIterator.h"
 #include "Widgets/Images/SImage.h"
 #include "Widgets/Input/SButton.h"
@@ -137,14 +138,16 @@ FString FOpenSettingItem::ToString() const
 
 FString FOpenSettingItem::GetSearchText() const
 {
-	return ToString() + " " + GetCategoryString();
+	return SearchText;
 }
 
-FString FOpenSettingItem::GetCategoryString() const
+void FOpenSettingItem::CacheStrings()
 {
-	return FString::Printf(TEXT("%s | %s"),
+	CategoryString = FString::Printf(TEXT("%s | %s"),
 		*ContainerName.ToString(),
 		*CategoryName.ToString());
+
+	SearchText = ToString() + " " + CategoryString;
 }
 
 const FSlateBrush* FOpenSettingItem::GetIcon()
@@ -624,46 +627,19 @@ void SOpenWindowMenu::AddOpenSettingsItems(TArray<TSharedPtr<FOpenWindowItem_Bas
 		}
 	}
 
-	for (TObjectIterator<UDeveloperSettings> SettingsIt(RF_NoFlags); SettingsIt; ++SettingsIt)
+	TSet<TTuple<FName, FName, FName>> SettingsSections;
+	for (TSharedPtr<FOpenSettingItem> Item : OpenSettingsItems)
 	{
-		if (UDeveloperSettings* Settings = *SettingsIt)
-		{
-			// Only Add the CDO of any UDeveloperSettings objects.
-			if (Settings->HasAnyFlags(RF_ClassDefaultObject) && !Settings->GetClass()->HasAnyClassFlags(CLASS_Deprecated | CLASS_Abstract))
-			{
-				// Ignore the setting if it's specifically the UDeveloperSettings or other abstract settings classes
-				if (Settings->GetClass()->HasAnyClassFlags(CLASS_Abstract) || !Settings->SupportsAutoRegistration())
-				{
-					continue;
-				}
-
-				FName ContainerName = Settings->GetContainerName();
-				FName CategoryName = Settings->GetCategoryName();
-				FName SectionName = Settings->GetSectionName();
-
-				bool bDuplicate = false;
-				for (TSharedPtr<FOpenSettingItem> OpenSettingsItem : OpenSettingsItems)
-				{
-					if (OpenSettingsItem->SectionName == SectionName &&
-						OpenSettingsItem->CategoryName == CategoryName &&
-						OpenSettingsItem->ContainerName == ContainerName)
-					{
-						bDuplicate = true;
-						break;
-					}
-				}
-
-				if (!bDuplicate)
-				{
-					OpenSettingsItems.Add(MakeShareable(new FOpenSettingItem(ContainerName, CategoryName, SectionName)));
-				}
-			}
-		}
+		SettingsSections.Add(MakeTuple(Item->ContainerName, Item->CategoryName, Item->SectionName));
+		Items.Add(Item);
 	}
 
-	for (TSharedPtr<FOpenSettingItem> Item : OpenSettingsItems)
+	for (const TSharedPtr<FOpenSettingItem>& Item : FBAOpenWindowItemCache::Get().GetDeveloperSettingsItems())
 	{
-		Items.Add(Item);
+		if (!SettingsSections.Contains(MakeTuple(Item->ContainerName, Item->CategoryName, Item->SectionName)))
+		{
+			Items.Add(Item);
+		}
 	}
 }
 
@@ -850,31 +826,7 @@ void SOpenWindowMenu::AddMenuEntryBlocks(TArray<TSharedPtr<FOpenWindowItem_Base>
 
 void SOpenWindowMenu::AddEditorUtilityWidgets(TArray<TSharedPtr<FOpenWindowItem_Base>>& Items)
 {
-	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
-
-	TArray<FAssetData> EditorUtilsAssets;
-
-#if BA_UE_VERSION_OR_LATER(5, 1)
-	FARFilter ClassFilter;
-	ClassFilter.ClassPaths.Add(UEditorUtilityWidgetBlueprint::StaticClass()->GetClassPathName());
-	AssetRegistry.GetAssets(ClassFilter, EditorUtilsAssets);
-#elif BA_UE_VERSION_OR_LATER(5, 0)
-	FARFilter ClassFilter;
-	ClassFilter.ClassNames.Add(UEditorUtilityWidgetBlueprint::StaticClass()->GetFName());
-	AssetRegistry.GetAssets(ClassFilter, EditorUtilsAssets);
-#else
-	TArray<const FAssetData*> Assets = AssetRegistry.GetAssetRegistryState()->GetAssetsByClassName(UEditorUtilityWidgetBlueprint::StaticClass()->GetFName());
-	for (const FAssetData* Asset : Assets)
-	{
-		FAssetData NewAsset = *Asset;
-		EditorUtilsAssets.Add(NewAsset);
-	}
-#endif
-
-	for (const FAssetData& EditorAsset : EditorUtilsAssets)
-	{
-		Items.Add(MakeShared<FEditorUtilityItem>(EditorAsset));
-	}
+	FBAOpenWindowItemCache::Get().GetEditorUtilityItems(Items);
 }
 
 TSharedRef<ITableRow> SOpenWindowMenu::CreateItemWidget(TSharedPtr<FOpenWindowItem_Base> Item, const TSharedRef<STableViewBase>& OwnerTable) const
@@ -943,3 +895,181 @@ void SOpenWindowMenu::SelectItem(TSharedPtr<FOpenWindowItem_Base> Item)
 {
 	Item->SelectItem();
 }
+
+/**************************/
+/* FBAOpenWindowItemCache */
+/**************************/
+
+FBAOpenWindowItemCache& FBAOpenWindowItemCache::Get()
+{
+	return TLazySingleton<FBAOpenWindowItemCache>::Get();
+}
+
+void FBAOpenWindowItemCache::TearDown()
+{
+	TLazySingleton<FBAOpenWindowItemCache>::TearDown();
+}
+
+FBAOpenWindowItemCache::~FBAOpenWindowItemCache()
+{
+	if (OnModulesChangedHandle.IsValid())
+	{
+		FModuleManager::Get().OnModulesChanged().Remove(OnModulesChangedHandle);
+	}
+
+	if (bEditorUtilityItemsCached)
+	{
+		if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+		{
+			IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+			AssetRegistry.OnAssetAdded().RemoveAll(this);
+			AssetRegistry.OnAssetRemoved().RemoveAll(this);
+			AssetRegistry.OnAssetRenamed().RemoveAll(this);
+		}
+	}
+}
+
+const TArray<TSharedPtr<FOpenSettingItem>>& FBAOpenWindowItemCache::GetDeveloperSettingsItems()
+{
+	if (!OnModulesChangedHandle.IsValid())
+	{
+		// a loaded module may add settings classes
+		OnModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FBAOpenWindowItemCache::OnModulesChanged);
+	}
+
+	if (bDeveloperSettingsDirty)
+	{
+		CacheDeveloperSettingsItems();
+	}
+
+	return DeveloperSettingsItems;
+}
+
+void FBAOpenWindowItemCache::GetEditorUtilityItems(TArray<TSharedPtr<FOpenWindowItem_Base>>& OutItems)
+{
+	if (!bEditorUtilityItemsCached)
+	{
+		CacheEditorUtilityItems();
+	}
+
+	OutItems.Reserve(OutItems.Num() + EditorUtilityItems.Num());
+	for (const auto& Elem : EditorUtilityItems)
+	{
+		OutItems.Add(Elem.Value);
+	}
+}
+
+void FBAOpenWindowItemCache::CacheDeveloperSettingsItems()
+{
+	DeveloperSettingsItems.Reset();
+
+	TSet<TTuple<FName, FName, FName>> AddedSections;
+	for (TObjectIterator<UDeveloperSettings> SettingsIt(RF_NoFlags); SettingsIt; ++SettingsIt)
+	{
+		if (UDeveloperSettings* Settings = *SettingsIt)
+		{
+			// Only Add the CDO of any UDeveloperSettings objects.
+			if (Settings->HasAnyFlags(RF_ClassDefaultObject) && !Settings->GetClass()->HasAnyClassFlags(CLASS_Deprecated | CLASS_Abstract))
+			{
+				// Ignore the setting if it's specifically the UDeveloperSettings or other abstract settings classes
+				if (Settings->GetClass()->HasAnyClassFlags(CLASS_Abstract) || !Settings->SupportsAutoRegistration())
+				{
+					continue;
+				}
+
+				FName ContainerName = Settings->GetContainerName();
+				FName CategoryName = Settings->GetCategoryName();
+				FName SectionName = Settings->GetSectionName();
+
+				bool bAlreadyAdded = false;
+				AddedSections.Add(MakeTuple(ContainerName, CategoryName, SectionName), &bAlreadyAdded);
+				if (!bAlreadyAdded)
+				{
+					DeveloperSettingsItems.Add(MakeShareable(new FOpenSettingItem(ContainerName, CategoryName, SectionName)));
+				}
+			}
+		}
+	}
+
+	bDeveloperSettingsDirty = false;
+}
+
+void FBAOpenWindowItemCache::CacheEditorUtilityItems()
+{
+	bEditorUtilityItemsCached = true;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TArray<FAssetData> EditorUtilsAssets;
+
+#if BA_UE_VERSION_OR_LATER(5, 1)
+	FARFilter ClassFilter;
+	ClassFilter.ClassPaths.Add(UEditorUtilityWidgetBlueprint::StaticClass()->GetClassPathName());
+	AssetRegistry.GetAssets(ClassFilter, EditorUtilsAssets);
+#elif BA_UE_VERSION_OR_LATER(5, 0)
+	FARFilter ClassFilter;
+	ClassFilter.ClassNames.Add(UEditorUtilityWidgetBlueprint::StaticClass()->GetFName());
+	AssetRegistry.GetAssets(ClassFilter, EditorUtilsAssets);
+#else
+	TArray<const FAssetData*> Assets = AssetRegistry.GetAssetRegistryState()->GetAssetsByClassName(UEditorUtilityWidgetBlueprint::StaticClass()->GetFName());
+	for (const FAssetData* Asset : Assets)
+	{
+		FAssetData NewAsset = *Asset;
+		EditorUtilsAssets.Add(NewAsset);
+	}
+#endif
+
+	for (const FAssetData& EditorAsset : EditorUtilsAssets)
+	{
+		OnAssetAdded(EditorAsset);
+	}
+
+	AssetRegistry.OnAssetAdded().AddRaw(this, &FBAOpenWindowItemCache::OnAssetAdded);
+	AssetRegistry.OnAssetRemoved().AddRaw(this, &FBAOpenWindowItemCache::OnAssetRemoved);
+	AssetRegistry.OnAssetRenamed().AddRaw(this, &FBAOpenWindowItemCache::OnAssetRenamed);
+}
+
+bool FBAOpenWindowItemCache::IsEditorUtilityAsset(const FAssetData& AssetData)
+{
+#if BA_UE_VERSION_OR_LATER(5, 1)
+	return AssetData.AssetClassPath == UEditorUtilityWidgetBlueprint::StaticClass()->GetClassPathName();
+#else
+	return AssetData.AssetClass == UEditorUtilityWidgetBlueprint::StaticClass()->GetFName();
+#endif
+}
+
+FString FBAOpenWindowItemCache::GetObjectPath(const FAssetData& AssetData)
+{
+#if BA_UE_VERSION_OR_LATER(5, 1)
+	return AssetData.GetObjectPathString();
+#else
+	return AssetData.ObjectPath.ToString();
+#endif
+}
+
+void FBAOpenWindowItemCache::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	if (Reason == EModuleChangeReason::ModuleLoaded)
+	{
+		bDeveloperSettingsDirty = true;
+	}
+}
+
+void FBAOpenWindowItemCache::OnAssetAdded(const FAssetData& AssetData)
+{
+	if (IsEditorUtilityAsset(AssetData))
+	{
+		EditorUtilityItems.Add(GetObjectPath(AssetData), MakeShared<FEditorUtilityItem>(AssetData));
+	}
+}
+
+void FBAOpenWindowItemCache::OnAssetRemoved(const FAssetData& AssetData)
+{
+	EditorUtilityItems.Remove(GetObjectPath(AssetData));
+}
+
+void FBAOpenWindowItemCache::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	EditorUtilityItems.Remove(OldObjectPath);
+	OnAssetAdded(AssetData);
+}
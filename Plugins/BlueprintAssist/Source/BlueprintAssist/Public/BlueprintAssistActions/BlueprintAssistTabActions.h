@@ -20,7 +20,7 @@ public:
 
 	TSharedPtr<FUICommandList> TabCommands;
 
-	void SelectNodeInDirection(const TArray<UEdGraphNode*>& Nodes, int X, int Y, float DistLimit) const;
+	void SelectNodeInDirection(int X, int Y, float DistLimit) const;
 
 	void SelectAnyNodeInDirection(const int X, const int Y) const;
 
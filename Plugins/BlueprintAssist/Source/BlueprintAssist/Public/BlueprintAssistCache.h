@@ -3,9 +3,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 
 #include "SGraphPin.h"
 #include "BlueprintAssistGlobals.h"
+#include "BlueprintAssistCacheIndex.h"
 
 #include "BlueprintAssistCache.generated.h"
 
@@ -39,6 +41,11 @@ struct BLUEPRINTASSIST_API FBANodeData
 	{
 		return !CachedNodeSize.IsZero();
 	}
+
+	friend FArchive& operator<<(FArchive& Ar, FBANodeData& Data)
+	{
+		return Ar << Data.CachedNodeSize << Data.CachedPins << Data.bLocked << Data.NodeGroup << Data.NodeGroups;
+	}
 };
 
 USTRUCT()
@@ -51,9 +58,45 @@ struct BLUEPRINTASSIST_API FBAGraphData
 
 	void CleanupGraph(UEdGraph* Graph);
 
+	/** Remove the cached pins the node no longer has */
+	void CleanupNodePins(UEdGraphNode* Node);
+
 	FBANodeData& GetNodeData(UEdGraphNode* Node);
 
 	bool bTriedLoadingMetaData = false;
+
+	friend FArchive& operator<<(FArchive& Ar, FBAGraphData& Data)
+	{
+		return Ar << Data.NodeData;
+	}
+};
+
+/**
+ * Does the same as FBAGraphData::CleanupGraph a slice at a time, so opening a large graph does not stall on it.
+ * Restarts when the graph's node count changes, the guids collected so far would be stale.
+ */
+struct BLUEPRINTASSIST_API FBAGraphCleanup
+{
+	void Start(UEdGraph* InGraph);
+
+	void Reset();
+
+	bool IsRunning() const { return Graph.IsValid(); }
+
+	UEdGraph* GetGraph() const { return Graph.Get(); }
+
+	/** Visit up to Budget nodes or cached entries, returns true once the graph data is clean */
+	bool Step(FBAGraphData& GraphData, int32 Budget);
+
+private:
+	TWeakObjectPtr<UEdGraph> Graph;
+	int32 NumGraphNodes = 0;
+	int32 NextIndex = 0;
+
+	// the graph's nodes are collected first, then the cached entries missing from them are removed
+	bool bCollectedNodes = false;
+	TSet<FGuid> CurrentNodes;
+	TArray<FGuid> CachedNodeGuids;
 };
 
 USTRUCT()
@@ -63,6 +106,11 @@ struct BLUEPRINTASSIST_API FBAPackageData
 
 	UPROPERTY()
 	TMap<FGuid, FBAGraphData> GraphData; // graph guid -> graph data
+
+	friend FArchive& operator<<(FArchive& Ar, FBAPackageData& Data)
+	{
+		return Ar << Data.GraphData;
+	}
 };
 
 USTRUCT()
@@ -70,12 +118,16 @@ struct BLUEPRINTASSIST_API FBACacheData
 {
 	GENERATED_USTRUCT_BODY()
 
+	// only packages loaded this session, each one is stored in its own binary file (see FBACache::GetPackageCacheDir)
 	UPROPERTY()
 	TMap<FName, FBAPackageData> PackageData; // package name -> package data
 
 	UPROPERTY()
 	TArray<FString> BookmarkedFolders;
 
+	UPROPERTY()
+	TMap<FName, int64> PackageLastUsed; // package name -> utc ticks of its last use, to evict the least recently used files
+
 	UPROPERTY()
 	int CacheVersion = -1;
 };
@@ -88,29 +140,55 @@ public:
 
 	void Init();
 
-	FBACacheData& GetCacheData() { return CacheData; }
+	FBACacheData& GetCacheData()
+	{
+		FinishLoadingCache();
+		return CacheData;
+	}
 
+	// starts reading the index file on a background thread, once the asset registry finished loading
 	void LoadCache();
 
+	// writes the index and the packages used since the last save on a background thread
 	void SaveCache();
 
+	// save and wait for the files to be written, for exiting the editor
+	void SaveCacheAndWait();
+
+	// save a couple of seconds from now, a burst of asset saves then writes the cache once
+	void RequestSave();
+
 	void DeleteCache();
 
 	void CleanupFiles();
 
+	// the graph's data for editing, read out of the package's index file the first time
 	FBAGraphData& GetGraphData(UEdGraph* Graph);
 
+	// the graph's data if it was already handed out by GetGraphData this session
+	FBAGraphData* FindEditedGraphData(UEdGraph* Graph);
+
+	// read only lookups, answered by the edited data or a binary search of the package's index, neither copies the graph
+	bool FindNodeSize(UEdGraph* Graph, UEdGraphNode* Node, FVector2D& OutSize);
+	bool FindPinOffset(UEdGraph* Graph, UEdGraphNode* Node, const FGuid& PinId, float& OutOffset);
+	FGuid FindNodeGroup(UEdGraph* Graph, UEdGraphNode* Node);
+
 	FString GetProjectSavedCachePath(bool bFullPath = false);
 	FString GetPluginCachePath(bool bFullPath = false);
 	FString GetCachePath(bool bFullPath = false);
 	FString GetAlternateCachePath(bool bFullPath = false);
 
+	// the directory holding one binary file per package, next to the cache file
+	FString GetPackageCacheDir(bool bAlternate = false);
+
 	void SaveGraphDataToPackageMetaData(UEdGraph* Graph);
 	bool LoadGraphDataFromPackageMetaData(UEdGraph* Graph, FBAGraphData& GraphData);
 	void ClearPackageMetaData(UEdGraph* Graph);
 
 	void SetBookmarkedFolder(const FString& FolderPath, int Index)
 	{
+		FinishLoadingCache();
+
 		if (Index >= CacheData.BookmarkedFolders.Num())
 		{
 			CacheData.BookmarkedFolders.SetNum(Index + 1);
@@ -121,6 +199,7 @@ public:
 
 	TOptional<FString> FindBookmarkedFolder(int Index)
 	{
+		FinishLoadingCache();
 		return CacheData.BookmarkedFolders.IsValidIndex(Index) ? CacheData.BookmarkedFolders[Index] : TOptional<FString>();
 	}
 
@@ -129,6 +208,48 @@ private:
 
 	FBACacheData CacheData;
 
+	// packages whose file was read (or found missing), so GetGraphData only touches the disk once per package
+	TSet<FName> LoadedPackages;
+
+	// the mapped files of packages with no edited graph yet, CacheData.PackageData overlays them with the edited graphs
+	TMap<FName, TSharedPtr<FBAPackageIndex>> PackageIndices;
+
+	// packages handed out by GetGraphData since the last save, the caller may have changed them
+	TSet<FName> DirtyPackages;
+
+	// resolves to the packages whose files the size limit deleted after the write
+	TFuture<TArray<FName>> PendingWrite;
+
+	// resolves to the index file's contents, read by LoadCache on the thread pool
+	TFuture<FBACacheData> PendingLoad;
+
+	// platform seconds each package was last used this session
+	TMap<FName, double> PackageAccessTime;
+
+	FTimerHandle SaveTimerHandle;
+
+	// merges the index read by LoadCache into CacheData, waiting for it if it is still being read
+	void FinishLoadingCache();
+
+	FString GetPackageCacheFilename(FName PackageName, bool bAlternate = false);
+	bool LoadPackageData(FName PackageName);
+	void EnsurePackageLoaded(FName PackageName);
+
+	// drops the data of graphs and pins that no longer exist, and of nodes that hold nothing; the package has to be loaded
+	void CompactPackageData(FName PackageName, FBAPackageData& PackageData);
+
+	// forgets the packages not used for a while, they are read from their files again when needed
+	void ReleaseUnusedPackages();
+
+	// the node's data in an edited graph; bOutGraphEdited tells a missing node from a graph that is only in the index
+	const FBANodeData* FindEditedNodeData(UEdGraph* Graph, UEdGraphNode* Node, bool& bOutGraphEdited);
+	const FBAPackageIndex::FNodeRecord* FindIndexedNode(UEdGraph* Graph, UEdGraphNode* Node, const FBAPackageIndex*& OutIndex);
+
+	// the compact meta data of graphs read before they were edited, null for graphs without any
+	TMap<TWeakObjectPtr<UEdGraph>, TSharedPtr<FBAPackageIndex>> MetaDataIndices;
+
+	const FBAPackageIndex* FindMetaDataIndex(UEdGraph* Graph);
+
 	bool bHasSavedThisFrame = false;
 	bool bHasSavedMetaDataThisFrame = false;
 
@@ -0,0 +1,82 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+struct FBAGraphData;
+struct FBAPackageData;
+
+/**
+ * Read only view of one package's cache file, memory mapped where the platform allows it.
+ *
+ * The file is a header, the package name, then four flat arrays: graphs sorted by guid, the nodes of each graph
+ * sorted by guid, the pins of each node sorted by guid, and the node groups of each node. A lookup is a binary
+ * search per level, nothing is copied out until a graph is edited and read into an FBAGraphData.
+ */
+class BLUEPRINTASSIST_API FBAPackageIndex
+{
+public:
+	struct FGraphRecord
+	{
+		FGuid GraphGuid;
+		int32 FirstNode;
+		int32 NumNodes;
+	};
+
+	struct FNodeRecord
+	{
+		FGuid NodeGuid;
+		FGuid NodeGroup;
+		float SizeX;
+		float SizeY;
+		int32 FirstPin;
+		int32 NumPins;
+		int32 FirstGroup;
+		int32 NumGroups;
+		uint32 bLocked;
+	};
+
+	struct FPinRecord
+	{
+		FGuid PinGuid;
+		float Offset;
+	};
+
+	~FBAPackageIndex();
+
+	// maps the file, or reads it when mapping is not supported; null if it is missing or not a valid index of this package
+	static TSharedPtr<FBAPackageIndex> Open(const FString& Path, FName PackageName);
+
+	// an index over bytes already in memory, e.g. decoded from the package meta data
+	static TSharedPtr<FBAPackageIndex> FromBytes(TArray<uint8>&& Bytes, FName PackageName);
+
+	// the bytes of a file that Open reads back as this package
+	static TArray<uint8> Write(FName PackageName, const FBAPackageData& PackageData);
+
+	const FGraphRecord* FindGraph(const FGuid& GraphGuid) const;
+	const FNodeRecord* FindNode(const FGraphRecord& Graph, const FGuid& NodeGuid) const;
+	const float* FindPinOffset(const FNodeRecord& Node, const FGuid& PinGuid) const;
+
+	void ReadGraph(const FGraphRecord& Graph, FBAGraphData& OutGraphData) const;
+	void ReadPackage(FBAPackageData& OutPackageData) const;
+
+private:
+	FBAPackageIndex() = default;
+
+	bool Parse(FName PackageName);
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> LoadedBytes;
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	TArrayView<const FGraphRecord> Graphs;
+	TArrayView<const FNodeRecord> Nodes;
+	TArrayView<const FPinRecord> Pins;
+	TArrayView<const FGuid> Groups;
+};
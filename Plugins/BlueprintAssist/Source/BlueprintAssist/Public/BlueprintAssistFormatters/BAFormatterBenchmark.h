@@ -0,0 +1,46 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EBAFormatAllStyle : uint8;
+class FBAGraphHandler;
+class UEdGraph;
+
+struct BLUEPRINTASSIST_API FBAFormatterBenchmarkResult
+{
+	EBAFormatAllStyle Style;
+	TArray<double> Seconds;
+	TArray<uint32> PositionHashes;
+
+	double GetMedianSeconds() const;
+
+	// every iteration started from the same positions, so they should all end on the same ones
+	bool IsDeterministic() const;
+};
+
+/**
+ * Times format all on the focused graph with each format all style, using the node sizes already in the cache.
+ * Each iteration is undone before the next so every run starts from the same graph, and the resulting node
+ * positions are hashed to catch an optimization which changes the layout.
+ *
+ * Run it on a few blueprints through the console: BlueprintAssist.BenchmarkFormatAll [Iterations] [-SaveBaseline]
+ *
+ * Each graph's medians and layouts are kept as a baseline in Saved/BlueprintAssist/FormatAllBaseline.json, later runs
+ * on the same graph warn when a style got slower than the baseline allows or ended on different positions.
+ */
+class BLUEPRINTASSIST_API FBAFormatterBenchmark
+{
+public:
+	// false if the graph can't be formatted right now, e.g. some node sizes still have to be measured
+	static bool Run(TSharedPtr<FBAGraphHandler> GraphHandler, int32 NumIterations, TArray<FBAFormatterBenchmarkResult>& OutResults);
+
+	// created knot nodes get a new guid every format, they are hashed by position only
+	static uint32 HashNodePositions(UEdGraph* Graph);
+
+	static void LogResults(UEdGraph* Graph, const TArray<FBAFormatterBenchmarkResult>& Results);
+
+	/** Compare the results with the graph's baseline, or store them as its baseline. Returns false on a regression */
+	static bool CheckBaseline(UEdGraph* Graph, const TArray<FBAFormatterBenchmarkResult>& Results, bool bSaveBaseline);
+};
@@ -0,0 +1,92 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UEdGraph;
+class UEdGraphNode;
+
+enum class EBAFormatterPhase : uint8
+{
+	NodeSize,
+	FormatX,
+	FormatY,
+	Parameters,
+	KnotTracks,
+	CommentTree,
+	CommentPadding,
+	Num
+};
+
+// timings of one FBAGraphHandler::FormatNodes call
+struct BLUEPRINTASSIST_API FBAFormatterRun
+{
+	FDateTime Time;
+	FString GraphName;
+	FString RootNodeName;
+	int32 NumNodes = 0;
+	int64 MemoryDelta = 0;
+	double TotalSeconds = 0.0;
+	double PhaseSeconds[static_cast<int32>(EBAFormatterPhase::Num)] = {};
+
+	double GetPhaseSeconds(EBAFormatterPhase Phase) const { return PhaseSeconds[static_cast<int32>(Phase)]; }
+};
+
+/**
+ * Keeps the timings of the last format runs so they can be read in the debug menu or exported,
+ * the STATGROUP_BA_EdGraphFormatter counters only show a live capture.
+ *
+ * Phases are inclusive: parameter nodes formatted while laying out the exec nodes count towards both phases.
+ * Node sizes are cached over the ticks before a format, that time goes to the next run.
+ */
+class BLUEPRINTASSIST_API FBAFormatterProfiler
+{
+public:
+	static FBAFormatterProfiler& Get();
+	static void TearDown();
+
+	void BeginRun(UEdGraph* Graph, UEdGraphNode* RootNode);
+
+	void EndRun(int32 NumNodes);
+
+	void AddPhaseTime(EBAFormatterPhase Phase, double Seconds);
+
+	// newest first
+	const TArray<TSharedPtr<FBAFormatterRun>>& GetRuns() const { return Runs; }
+
+	void ClearRuns();
+
+	FString MakeCSV() const;
+
+	// writes the runs to the saved folder, returns the file written or an empty string
+	FString ExportCSV() const;
+
+	static FString GetPhaseName(EBAFormatterPhase Phase);
+
+	static constexpr int32 MaxRuns = 32;
+
+private:
+	TArray<TSharedPtr<FBAFormatterRun>> Runs;
+
+	TSharedPtr<FBAFormatterRun> ActiveRun;
+	int32 ActiveRunDepth = 0;
+	double ActiveRunStartTime = 0.0;
+	uint64 ActiveRunStartMemory = 0;
+
+	double PendingNodeSizeSeconds = 0.0;
+};
+
+// adds the time spent in its scope to the active run, nested scopes of the same phase are only counted once
+struct BLUEPRINTASSIST_API FBAFormatterPhaseScope
+{
+	explicit FBAFormatterPhaseScope(EBAFormatterPhase InPhase);
+	~FBAFormatterPhaseScope();
+
+private:
+	EBAFormatterPhase Phase;
+	double StartTime;
+	bool bOutermost;
+
+	static int32 PhaseDepth[static_cast<int32>(EBAFormatterPhase::Num)];
+};
@@ -0,0 +1,38 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UEdGraphNode;
+class UEdGraphPin;
+
+/**
+ * Node sizes and pin offsets for one format pass, in flat arrays indexed by node and pin.
+ * Sizes and offsets do not change while formatting, so each is read from the cache once per pass
+ * instead of on every bounds or pin position query. Positions stay on the nodes, the formatters move them.
+ */
+class BLUEPRINTASSIST_API FBALayoutGraph
+{
+public:
+	int32 FindNode(const UEdGraphNode* Node) const;
+	int32 AddNode(const UEdGraphNode* Node, const FVector2D& Size, const FVector2D& CommentBubbleSize);
+
+	const FVector2D& GetNodeSize(int32 NodeIndex) const { return NodeSizes[NodeIndex]; }
+
+	// zero when the node has no comment bubble
+	const FVector2D& GetCommentBubbleSize(int32 NodeIndex) const { return CommentBubbleSizes[NodeIndex]; }
+
+	bool FindPinOffset(const UEdGraphPin* Pin, float& OutOffset) const;
+	void AddPinOffset(const UEdGraphPin* Pin, float Offset);
+
+private:
+	TMap<const UEdGraphNode*, int32> NodeIndices;
+	TArray<FGuid> NodeGuids;
+	TArray<FVector2D> NodeSizes;
+	TArray<FVector2D> CommentBubbleSizes;
+
+	TMap<const UEdGraphPin*, int32> PinIndices;
+	TArray<FGuid> PinIds;
+	TArray<float> PinOffsets;
+};
@@ -0,0 +1,53 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FBAGraphHandler;
+class UEdGraphNode;
+
+/**
+ * Uniform grid over the cached bounds of a set of nodes, so a line query only tests the nodes near the line.
+ * The bounds are read once on Build: rebuild after moving nodes.
+ */
+class BLUEPRINTASSIST_API FBANodeBoundsGrid
+{
+public:
+	void Build(TSharedPtr<FBAGraphHandler> GraphHandler, const TSet<UEdGraphNode*>& Nodes);
+
+	void Reset();
+
+	// calls Visitor with each node whose bounds, extended by Padding, intersect the line, in the order the nodes were added
+	// stops early once Visitor returns false
+	void ForEachLineIntersection(
+		const FVector2D& Start,
+		const FVector2D& End,
+		const FMargin& Padding,
+		TFunctionRef<bool(UEdGraphNode* Node, const FSlateRect& PaddedBounds)> Visitor) const;
+
+	bool AnyLineIntersection(
+		const FVector2D& Start,
+		const FVector2D& End,
+		const FMargin& Padding,
+		TFunctionRef<bool(UEdGraphNode* Node)> IsIgnored) const;
+
+private:
+	struct FEntry
+	{
+		UEdGraphNode* Node;
+		FSlateRect Bounds;
+	};
+
+	FIntPoint GetCell(const FVector2D& Point) const;
+
+	TArray<FEntry> Entries;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	// roughly the size of a node, so each node falls in a few cells
+	float CellSize = 256.0f;
+
+	// dedupes entries found through several cells within one query
+	mutable TArray<uint32> EntryQueryIds;
+	mutable uint32 QueryId = 0;
+};
@@ -0,0 +1,34 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UEdGraphNode;
+
+/**
+ * Which nodes can be reached from which, for every node found walking the links from a set of initial nodes.
+ * Built once with a single walk, cycles are collapsed so each query is a bit test instead of a tree search.
+ * Links are read on Build: rebuild after linking or unlinking nodes.
+ */
+class BLUEPRINTASSIST_API FBANodeReachability
+{
+public:
+	void Build(const TArray<UEdGraphNode*>& InitialNodes, TFunctionRef<TArray<UEdGraphNode*>(UEdGraphNode*)> GetLinkedNodes);
+
+	void Reset();
+
+	bool IsBuilt() const { return NodeComponents.Num() > 0; }
+
+	// true if To is From or is found walking the links from From, nodes which Build did not reach only reach themselves
+	bool CanReach(UEdGraphNode* From, UEdGraphNode* To) const;
+
+private:
+	TMap<UEdGraphNode*, int32> NodeIndices;
+
+	// the cycle each node belongs to, numbered so a cycle only links to lower numbered ones
+	TArray<int32> NodeComponents;
+
+	// the cycles reachable from each cycle, including itself
+	TArray<TBitArray<>> ComponentReach;
+};
@@ -81,7 +81,7 @@ protected:
 	void AssignSubsetParentsAndChildren(
 		TSharedPtr<FBACommentContainsNode> CurrentNode, 
 		TSharedPtr<FBACommentContainsNode> LastValidParent,
-		TArray<TSharedPtr<FBACommentContainsNode>>& PendingNodes,
+		FContainsNodeSet& PendingNodes,
 		TSharedPtr<FBACommentContainsGraph> SubsetGraph,
 		FContainsNodeSet& VisitedNodes);
 };
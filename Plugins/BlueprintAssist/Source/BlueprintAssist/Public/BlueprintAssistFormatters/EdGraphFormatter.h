@@ -39,6 +39,8 @@ struct FNodeChangeInfo
 	void UpdateValues(UEdGraphNode* NodeToKeepStill, FCommentHandler* CommentHandler);
 
 	bool HasChanged(UEdGraphNode* NodeToKeepStill, FCommentHandler* CommentHandler);
+
+	bool HaveContainingCommentsChanged(FCommentHandler* CommentHandler);
 };
 
 struct ChildBranch
@@ -47,7 +49,7 @@ struct ChildBranch
 	UEdGraphPin* ParentPin;
 	TSet<UEdGraphNode*> BranchNodes;
 
-	ChildBranch(UEdGraphPin* InPin, UEdGraphPin* InParentPin, TSet<UEdGraphNode*>& InBranchNodes)
+	ChildBranch(UEdGraphPin* InPin, UEdGraphPin* InParentPin, const TSet<UEdGraphNode*>& InBranchNodes)
 		: Pin(InPin)
 		, ParentPin(InParentPin)
 		, BranchNodes(InBranchNodes) { }
@@ -126,6 +128,9 @@ public:
 
 	virtual void PostFormatting() override;
 
+	// the node's size is being measured again, the parameter branches holding it are laid out again on the next format
+	void MarkNodeResized(UEdGraphNode* Node);
+
 private:
 	FVector2D PinPadding;
 	FVector2D NodePadding;
@@ -160,6 +165,12 @@ private:
 
 	TMap<UEdGraphNode*, TSharedPtr<FEdGraphParameterFormatter>> ParameterParentMap;
 
+	// parameter formatters from the last format whose branch has not changed, handed back out by GetParameterFormatter
+	TMap<UEdGraphNode*, TSharedPtr<FEdGraphParameterFormatter>> ReusableParameterFormatters;
+
+	// nodes resized since the last format, see MarkNodeResized
+	TSet<UEdGraphNode*> ResizedNodes;
+
 	FNodeRelativeMapping NodeRelativeMapping;
 
 	FFormatterConnectionValidator ConnectionValidator;
@@ -168,6 +179,10 @@ private:
 
 	bool IsFormattingRequired(const TArray<UEdGraphNode*>& NewNodeTree);
 
+	void CollectReusableParameterFormatters();
+
+	bool CanReuseParameterFormatter(UEdGraphNode* MainNode, TSharedPtr<FEdGraphParameterFormatter> ParamFormatter);
+
 	void SaveFormattingEndInfo();
 
 	TArray<UEdGraphNode*> GetNodeTree(UEdGraphNode* InitialNode) const;
@@ -195,12 +210,18 @@ private:
 
 	TArray<FPinLink> GetNodesToExpand();
 
-	void FormatY_Recursive(
-		const FPinLink& CurrentLink,
-		TSet<UEdGraphNode*>& NodesToCollisionCheck,
-		TSet<FPinLink>& VisitedLinks,
-		bool bSameRow,
-		TSet<UEdGraphNode*>& Children);
+	// one node of FormatY's explicit stack: the link it was reached by and where it is in its pins
+	struct FFormatYFrame;
+
+	void FormatY_EnterNode(FFormatYFrame& Frame, TSet<UEdGraphNode*>& NodesToCollisionCheck);
+
+	// moves to the node's next child link and places the child; false once every child branch is formatted
+	bool FormatY_NextChild(FFormatYFrame& Frame, TSet<UEdGraphNode*>& NodesToCollisionCheck, TSet<FPinLink>& VisitedLinks);
+
+	// moves the branch just formatted for the current child link clear of the node's pins
+	void FormatY_ChildFormatted(FFormatYFrame& Frame, const TSet<UEdGraphNode*>& LocalChildren);
+
+	void FormatY_ExitNode(FFormatYFrame& Frame);
 
 	void FormatY();
 
@@ -217,12 +238,16 @@ private:
 	void RemoveKnotNodes();
 
 	void GetPinsOfSameHeight();
-	void GetPinsOfSameHeight_Recursive(
-		UEdGraphNode* CurrentNode,
-		UEdGraphPin* CurrentPin,
-		UEdGraphPin* ParentPin,
+
+	// one node of GetPinsOfSameHeight's explicit stack and where it is in its linked pins
+	struct FSameHeightFrame;
+
+	// the node's next link to an unvisited node on the path, recording it as same row when it is the first; false once there is none
+	bool GetPinsOfSameHeight_NextLink(
+		FSameHeightFrame& Frame,
 		TSet<UEdGraphNode*>& NodesToCollisionCheck,
-		TSet<FPinLink>& VisitedLinks);
+		TSet<FPinLink>& VisitedLinks,
+		FPinLink& OutLink);
 
 	bool LinkToSort(UEdGraphPin& PinA, UEdGraphPin& PinB, TSet<UEdGraphNode*>& VisitedNodes);
 
@@ -230,9 +255,19 @@ private:
 
 	void ApplyCommentPaddingX();
 
-	void ApplyCommentPaddingX_Recursive(
-		TArray<UEdGraphNode*> NodeSet,
-		TArray<TSharedPtr<FBACommentContainsNode>> ContainsNodes,
+	// one comment nesting level of ApplyCommentPaddingX's explicit stack
+	struct FCommentPaddingXFrame;
+
+	// keeps the level's nodes in the pool, adds its comments and sorts them left to right, before the nested levels move anything
+	void ApplyCommentPaddingX_SortNodeSet(
+		TArray<UEdGraphNode*>& NodeSet,
+		const TArray<TSharedPtr<FBACommentContainsNode>>& ContainsNodes);
+
+	// pads one level once the levels nested in its comments are done
+	void ApplyCommentPaddingX_Level(
+		const TArray<UEdGraphNode*>& NodeSet,
+		const TArray<TSharedPtr<FBACommentContainsNode>>& ContainsNodes,
+		const TArray<FPinLink>& LeafLinks,
 		TArray<FPinLink>& OutLeafLinks);
 
 	void ApplyCommentPaddingY();
@@ -231,3 +231,22 @@ struct BLUEPRINTASSIST_API FFormatterConnectionValidator
 	TMap<UEdGraphNode*, TSet<FPinLink>> BuildConnections(const TArray<UEdGraphNode*>& Nodes);
 	bool CheckChanged(const TArray<UEdGraphNode*>& Nodes);
 };
+
+// A node-tree laid out by Format All. Its bounds are measured once, placing it in a column only offsets them
+struct BLUEPRINTASSIST_API FBAFormatAllTree
+{
+	TSharedPtr<FFormatterInterface> Formatter;
+	TArray<UEdGraphNode*> Nodes;
+	UEdGraphNode* RootNode = nullptr;
+
+	FSlateRect NodeBounds;
+
+	// includes the comments when comment padding is applied
+	FSlateRect Bounds;
+
+	FBAFormatAllTree(TSharedPtr<FBAGraphHandler> GraphHandler, TSharedPtr<FFormatterInterface> InFormatter);
+
+	void Translate(int32 DeltaX, int32 DeltaY);
+
+	static FSlateRect GetGroupedBounds(const TArray<FBAFormatAllTree*>& Trees);
+};
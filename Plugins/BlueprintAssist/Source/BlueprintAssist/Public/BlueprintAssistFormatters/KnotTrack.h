@@ -10,6 +10,7 @@
 class UK2Node_Knot;
 struct FFormatterInterface;
 class FBAGraphHandler;
+class FBANodeBoundsGrid;
 
 BLUEPRINTASSIST_API DECLARE_LOG_CATEGORY_EXTERN(LogKnotTrackCreator, Log, All);
 
@@ -72,7 +73,7 @@ struct BLUEPRINTASSIST_API FKnotNodeTrack
 	bool bIsLoopingTrack = false;
 
 	FKnotNodeTrack(
-		TSharedPtr<FFormatterInterface> Formatter,
+		const FBANodeBoundsGrid& NodeGrid,
 		TSharedPtr<FBAGraphHandler> InGraphHandler,
 		UEdGraphPin* InParentPin,
 		TArray<UEdGraphPin*> InLinkedTo,
@@ -88,7 +89,7 @@ struct BLUEPRINTASSIST_API FKnotNodeTrack
 
 	FSlateRect GetTrackBounds();
 
-	void SetTrackHeight(TSharedPtr<FFormatterInterface> Formatter);
+	void SetTrackHeight(const FBANodeBoundsGrid& NodeGrid);
 
 	bool IsFloatingTrack();
 
@@ -100,7 +101,7 @@ struct BLUEPRINTASSIST_API FKnotNodeTrack
 
 	bool HasPinToAlignTo();
 
-	bool TryAlignTrack(TSharedPtr<FFormatterInterface> Formatter, float TrackStart, float TrackEnd, float TestHeight);
+	bool TryAlignTrack(const FBANodeBoundsGrid& NodeGrid, float TrackStart, float TrackEnd, float TestHeight);
 
 	TArray<UEdGraphNode*> GetRelatedNodes();
 
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 
+#include "BANodeBoundsGrid.h"
 #include "KnotTrack.h"
 
 struct FCommentHandler;
@@ -24,6 +25,9 @@ class FKnotTrackCreator final
 	TMap<UK2Node_Knot*, TSharedPtr<FKnotNodeCreation>> KnotCreationMap; 
 	TArray<TSharedPtr<FGroupedTracks>> TrackGroups;
 
+	// bounds of the formatted nodes while the tracks are made, nodes do not move until the tracks are expanded
+	FBANodeBoundsGrid NodeGrid;
+
 	FVector2D PinPadding;
 	FVector2D NodePadding;
 	float TrackSpacing;
@@ -63,7 +67,7 @@ private:
 
 	void CreateKnotTracks();
 
-	bool TryAlignTrackToEndPins(TSharedPtr<FKnotNodeTrack> Track, const TArray<UEdGraphNode*>& AllNodes);
+	bool TryAlignTrackToEndPins(TSharedPtr<FKnotNodeTrack> Track);
 
 	bool DoesPinNeedTrack(UEdGraphPin* Pin, const TArray<UEdGraphPin*>& LinkedTo);
 
@@ -44,14 +44,18 @@ public:
 
 	void FormatY();
 
-	void FormatY_Recursive(
-		UEdGraphNode* CurrentNode,
-		UEdGraphPin* CurrentPin,
-		UEdGraphPin* ParentPin,
-		TSet<UEdGraphNode*>& NodesToCollisionCheck,
-		TSet<FPinLink>& VisitedLinks,
-		bool bSameRow,
-		TSet<UEdGraphNode*>& Children);
+	// one node of FormatY's explicit stack: the pins it was reached by and where it is in its linked pins
+	struct FFormatYFrame;
+
+	void FormatY_EnterNode(FFormatYFrame& Frame, TSet<UEdGraphNode*>& NodesToCollisionCheck);
+
+	// moves to the node's next child link and places the child; false once every child branch is formatted
+	bool FormatY_NextChild(FFormatYFrame& Frame, TSet<UEdGraphNode*>& NodesToCollisionCheck, TSet<FPinLink>& VisitedLinks);
+
+	// moves the branch just formatted for the current child link clear of the node's pins
+	void FormatY_ChildFormatted(FFormatYFrame& Frame, const TSet<UEdGraphNode*>& LocalChildren);
+
+	void FormatY_ExitNode(FFormatYFrame& Frame);
 
 	virtual TSet<UEdGraphNode*> GetFormattedNodes() override;
 
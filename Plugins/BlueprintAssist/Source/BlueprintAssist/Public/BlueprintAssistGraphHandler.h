@@ -3,16 +3,22 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "BlueprintAssistCache.h"
 #include "BlueprintAssistDelayedDelegate.h"
+#include "BlueprintAssistGraphChanges.h"
+#include "BlueprintAssistNodeKdTree.h"
+#include "BlueprintAssistPinCompatibilityIndex.h"
 #include "BlueprintAssistNodeSizeChangeData.h"
 #include "BlueprintAssistFormatters/GraphFormatterTypes.h"
 
 class SBlueprintAssistGraphOverlay;
 class SMyBlueprint;
 class FBANodeSizeChangeData;
+class FBALayoutGraph;
 struct FFormatterInterface;
 struct FBAGraphData;
 struct FBANodeData;
+struct FBAActionMenuCache;
 
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnNodeFormatted, UEdGraphNode*, const FFormatterInterface&);
 
@@ -76,13 +82,15 @@ public:
 
 	void UpdateCachedNodeSize(float DeltaTime);
 
+	void UpdateGraphCleanup();
+
 	void UpdateNodesRequiringFormatting();
 
 	void SimpleFormatAll();
 
 	void SmartFormatAll();
 
-	void FormatColumn(TArray<TSharedPtr<FFormatterInterface>>& CurrentColumn, float ColumnX);
+	void FormatColumn(TArray<FBAFormatAllTree*>& CurrentColumn, float ColumnX);
 
 	void SetSelectedPin(UEdGraphPin* Pin, bool bLerpIntoView = false);
 
@@ -119,6 +127,18 @@ public:
 
 	FSlateRect GetCachedNodeBounds(UEdGraphNode* Node, bool bWithCommentBubble = true);
 
+	/** The node positions of the focused graph, rebuilt when a node was added, removed or moved since the last query */
+	const FBANodeKdTree& GetNodeKdTree();
+
+	/** Counts the changes to the graph's nodes, links and available actions, for caches built from them */
+	uint32 GetGraphChangeCount() const { return GraphChangeCount; }
+
+	/** The pins of the focused graph by connection compatibility, rebuilt after the graph changed */
+	FBAPinCompatibilityIndex& GetPinCompatibilityIndex();
+
+	/** Kept by the blueprint action menu between openings, see SBABlueprintActionMenu */
+	TSharedPtr<FBAActionMenuCache>& GetActionMenuCache() { return ActionMenuCache; }
+
 	UEdGraphPin* GetSelectedPin();
 
 	TSharedPtr<SGraphNode> GetGraphNode(UEdGraphNode* Node);
@@ -133,6 +153,8 @@ public:
 
 	void FormatAllEvents();
 
+	bool IsFormatAllPending() const { return FormatAllColumns.Num() > 0; }
+
 	void ApplyGlobalCommentBubblePinned();
 
 	void ApplyCommentBubblePinned(UEdGraphNode* Node);
@@ -167,6 +189,9 @@ public:
 	FBAGraphData& GetGraphData();
 	FBANodeData& GetNodeData(UEdGraphNode* Node);
 
+	// read only, unlike GetNodeData this does not pull the graph out of the cache index
+	bool HasCachedNodeSize(UEdGraphNode* Node);
+
 	TMap<FGuid, TSet<TWeakObjectPtr<UEdGraphNode>>> NodeGroups;
 	TSet<UEdGraphNode*> GetNodeGroup(const FGuid& GroupID); 
 	void AddToNodeGroup(FGuid GroupID, UEdGraphNode* Node);
@@ -185,6 +210,10 @@ private:
 	TWeakPtr<SGraphEditor> CachedGraphEditor;
 	TWeakPtr<SDockTab> CachedTab;
 
+	// result of the last search for the graph panel around the focused widget
+	TWeakPtr<SWidget> LastFocusedWidget;
+	bool bLastFocusedWidgetInGraphPanel = false;
+
 	TWeakObjectPtr<UEdGraph> CachedEdGraph;
 
 	FEdGraphFormatterParameters FormatterParameters;
@@ -206,6 +235,9 @@ private:
 	// update node size
 	float NodeSizeTimeout = 0.f;
 	TSet<UEdGraphNode*> PendingFormatting;
+
+	// formatted before their size was measured, formatted again once it is
+	TSet<TWeakObjectPtr<UEdGraphNode>> EstimatedSizeNodes;
 	UEdGraphNode* FocusedNode = nullptr;
 	bool bFullyZoomed = false;
 	FVector2D ViewCache;
@@ -226,13 +258,33 @@ private:
 	TArray<UEdGraphNode*> PendingSize;
 
 	TArray<TArray<UEdGraphNode*>> FormatAllColumns;
+
+	// set while formatting, see FBALayoutGraph
+	TUniquePtr<FBALayoutGraph> FormatterLayout;
 	TMap<UEdGraphNode*, TSharedPtr<FFormatterInterface>> FormatterMap;
 
 	TSharedPtr<FScopedTransaction> PendingTransaction;
 	TSharedPtr<FScopedTransaction> ReplaceNewNodeTransaction;
 	TSharedPtr<FScopedTransaction> FormatAllTransaction;
 
-	TArray<UEdGraphNode*> LastNodes;
+	// nodes added, moved or resized since the last DetectGraphChanges
+	FBAGraphChanges GraphChanges;
+
+	// removes the cached data of deleted nodes and pins over a few frames after the graph opens
+	FBAGraphCleanup GraphCleanup;
+
+	FBANodeKdTree NodeKdTree;
+
+	uint32 GraphChangeCount = 0;
+
+	FBAPinCompatibilityIndex PinCompatibilityIndex;
+	uint32 PinCompatibilityIndexChangeCount = MAX_uint32;
+
+	TSharedPtr<FBAActionMenuCache> ActionMenuCache;
+
+	FDelegateHandle OnActionDatabaseUpdatedHandle;
+
+	void OnActionDatabaseUpdated(UObject* Object);
 
 	FDelegateHandle OnGraphChangedHandle;
 
@@ -280,6 +332,16 @@ private:
 
 	bool CacheNodeSize(UEdGraphNode* Node);
 
+	FVector2D ReadNodeSize(UEdGraphNode* Node);
+
+	// the pin's offset from the top of its node, zero if it is neither cached nor drawn
+	float ReadPinOffset(UEdGraphNode* OwningNode, const UEdGraphPin* Pin);
+
+	// measures every pending node at once, once the view is at full zoom, and removes the measured nodes from PendingSize
+	void CacheNodeSizesInPrepass();
+
+	void CacheCommentBubbleSize(UEdGraphNode* Node, TSharedPtr<SGraphNode> GraphNode);
+
 	bool UpdateNodeSizesChanges(const TArray<UEdGraphNode*>& Nodes);
 
 	void AutoLerpToNewlyCreatedNode(UEdGraphNode* Node);
@@ -15,6 +15,7 @@
 #include "BlueprintAssistActions/BlueprintAssistToolkitActions.h"
 #include "Framework/Application/IInputProcessor.h"
 
+class FBAGraphHandler;
 class UEdGraphNode;
 class SGraphPanel;
 
@@ -68,7 +69,7 @@ public:
 
 	void UpdateGroupMovement();
 	void GroupMoveSelectedNodes(const FVector2D& Delta);
-	void GroupMoveNodes(const FVector2D& Delta, TSet<UEdGraphNode*>& Nodes);
+	void GroupMoveNodes(const FVector2D& Delta);
 
 	FBANodeMovementTransaction DragNodeTransaction;
 
@@ -107,4 +108,41 @@ private:
 	void OnWindowFocusChanged(bool bIsFocused);
 
 	bool ProcessCommandBindings(TSharedPtr<FUICommandList> CommandList, const FKeyEvent& KeyEvent);
+
+	// commands of our binding contexts by active chord, rebuilt lazily after a binding changes
+	TMap<FInputChord, TArray<TSharedPtr<FUICommandInfo>, TInlineAllocator<2>>> ChordCommands;
+	bool bChordCommandsDirty = true;
+	FDelegateHandle OnUserDefinedChordChangedHandle;
+	FDelegateHandle OnCommandsChangedHandle;
+
+	void OnUserDefinedChordChanged(const FUICommandInfo& CommandInfo);
+	void OnCommandsChanged(const FBindingContext& BindingContext);
+
+	void BuildChordCommands();
+
+	// nodes which follow the anchor node, gathered once per drag rather than every tick
+	struct FGroupMoveCache
+	{
+		TWeakObjectPtr<UEdGraphNode> AnchorNode;
+		TSet<UEdGraphNode*> SelectedNodes;
+		EEdGraphPinDirection Direction = EGPD_MAX;
+		bool bMoveGroupOrSubtree = false;
+		TArray<TWeakObjectPtr<UEdGraphNode>> NodesToMove;
+
+		bool Matches(
+			const TWeakObjectPtr<UEdGraphNode>& InAnchorNode,
+			const TSet<UEdGraphNode*>& InSelectedNodes,
+			EEdGraphPinDirection InDirection,
+			bool bInMoveGroupOrSubtree) const;
+
+		void Reset();
+	};
+
+	FGroupMoveCache GroupMoveCache;
+
+	void CacheGroupMoveNodes(
+		TSharedPtr<FBAGraphHandler> GraphHandler,
+		const TSet<UEdGraphNode*>& SelectedNodes,
+		EEdGraphPinDirection Direction,
+		bool bMoveGroupOrSubtree);
 };
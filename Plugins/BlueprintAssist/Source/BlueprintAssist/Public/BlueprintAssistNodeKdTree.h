@@ -0,0 +1,64 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+
+class UEdGraphNode;
+
+/**
+ * @brief 2D k-d tree over the positions of a graph's nodes, for the nearest node queries of keyboard navigation
+ *		- Positions are copied when it is built, the graph handler marks it dirty when nodes are added, removed or moved
+ *		- Stored implicitly: the median of a range is its node, the halves on either side its children
+ *		- Even depths split on X, odd depths on Y
+ */
+class BLUEPRINTASSIST_API FBANodeKdTree
+{
+public:
+	void Build(const TArray<UEdGraphNode*>& Nodes);
+
+	void MarkDirty() { bDirty = true; }
+
+	bool IsDirty() const { return bDirty; }
+
+	int32 Num() const { return Entries.Num(); }
+
+	/** Collects the nodes whose position is inside the rect, edges included */
+	void QueryRect(const FSlateRect& Rect, TArray<UEdGraphNode*>& OutNodes) const;
+
+	/**
+	 * Finds the node closest to the origin inside the rect which passes the filter
+	 * @param Weights Scales the squared X and Y distances
+	 */
+	UEdGraphNode* FindNearest(
+		const FVector2D& Origin,
+		const FVector2D& Weights,
+		const FSlateRect& Rect,
+		TFunctionRef<bool(UEdGraphNode*)> Filter) const;
+
+private:
+	struct FEntry
+	{
+		FVector2D Position;
+		TWeakObjectPtr<UEdGraphNode> Node;
+	};
+
+	TArray<FEntry> Entries;
+	bool bDirty = true;
+
+	void Build_Range(int32 Begin, int32 End, int32 Depth);
+
+	void QueryRect_Range(int32 Begin, int32 End, int32 Depth, const FSlateRect& Rect, TArray<UEdGraphNode*>& OutNodes) const;
+
+	void FindNearest_Range(
+		int32 Begin,
+		int32 End,
+		int32 Depth,
+		const FVector2D& Origin,
+		const FVector2D& Weights,
+		const FSlateRect& Rect,
+		TFunctionRef<bool(UEdGraphNode*)> Filter,
+		UEdGraphNode*& OutNode,
+		float& OutDistance) const;
+};
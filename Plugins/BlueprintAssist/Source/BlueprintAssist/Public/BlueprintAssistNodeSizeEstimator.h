@@ -0,0 +1,31 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UEdGraphNode;
+class UEdGraphPin;
+
+/**
+ * Predicts the size of a node and the offsets of its pins from its title and pin labels, following the layout of
+ * the default graph node widget. Used when a node has no cached size and no widget to measure yet: the estimate is
+ * close enough to start formatting, the real size replaces it once the node is drawn.
+ */
+class BLUEPRINTASSIST_API FBANodeSizeEstimator
+{
+public:
+	static FVector2D EstimateNodeSize(UEdGraphNode* Node);
+
+	// offset of the top of the pin from the top of the node, like SGraphPin::GetNodeOffset
+	static float EstimatePinOffset(UEdGraphNode* Node, const UEdGraphPin* Pin);
+
+private:
+	static bool IsPinVisible(UEdGraphNode* Node, const UEdGraphPin* Pin);
+
+	static bool HasTitle(UEdGraphNode* Node);
+
+	static FVector2D GetTextSize(const FText& Text, FName StyleName);
+
+	static float GetPinRowWidth(const UEdGraphPin* Pin);
+};
@@ -0,0 +1,34 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UEdGraph;
+
+struct BLUEPRINTASSIST_API FBANodeSizePrewarmStats
+{
+	int32 NumBlueprints = 0;
+	int32 NumGraphs = 0;
+	int32 NumMeasuredNodes = 0;
+	int32 NumSkippedNodes = 0;
+	double Seconds = 0.0;
+};
+
+/**
+ * Measures the nodes of every blueprint under a content path and stores their sizes and pin offsets in the cache, so
+ * the graphs can be formatted without first zooming over each node to measure it.
+ *
+ * Node widgets are built on an offscreen graph panel and laid out with a prepass, which needs a slate renderer to
+ * measure text, so this runs in the editor rather than as a commandlet:
+ *		BlueprintAssist.PrewarmNodeSizes [Path=/Game] [-Force]
+ */
+class BLUEPRINTASSIST_API FBANodeSizePrewarm
+{
+public:
+	/** Measure the blueprints under the path, nodes already in the cache are skipped unless bForce */
+	static bool Run(const FString& PackagePath, bool bForce, FBANodeSizePrewarmStats& OutStats);
+
+	/** Measure the graph's nodes into the cache, returns the number of nodes measured */
+	static int32 PrewarmGraph(UEdGraph* Graph, bool bForce, int32& OutNumSkipped);
+};
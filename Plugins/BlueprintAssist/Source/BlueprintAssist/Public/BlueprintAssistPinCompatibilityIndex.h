@@ -0,0 +1,84 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EdGraph/EdGraphPin.h"
+
+class UEdGraph;
+
+/**
+ * @brief The visible pins of a graph grouped by what decides whether a pin can connect to them
+ *		- In blueprint graphs pins of the same type and direction on nodes of the same class give the same connection
+ *		  response, so the schema is asked once per group for a source pin type and the answers are kept
+ *		- Wildcard and self pins, pins on the source pin's own node and every pin of other schemas are asked one by one
+ *		- The graph handler rebuilds it after the graph changed
+ */
+class BLUEPRINTASSIST_API FBAPinCompatibilityIndex
+{
+public:
+	void Build(UEdGraph* Graph);
+
+	void Reset();
+
+	/** The visible pins of the graph the source pin can connect to, in graph order */
+	void GetConnectablePins(UEdGraphPin* SourcePin, TArray<UEdGraphPin*>& OutPins);
+
+private:
+	struct FPinTypeKey
+	{
+		FEdGraphPinType PinType;
+		EEdGraphPinDirection Direction = EGPD_Input;
+		const UClass* NodeClass = nullptr;
+		bool bNotConnectable = false;
+		bool bOrphanedPin = false;
+
+		bool operator==(const FPinTypeKey& Other) const
+		{
+			return Direction == Other.Direction
+				&& NodeClass == Other.NodeClass
+				&& bNotConnectable == Other.bNotConnectable
+				&& bOrphanedPin == Other.bOrphanedPin
+				&& PinType == Other.PinType;
+		}
+
+		friend uint32 GetTypeHash(const FPinTypeKey& Key)
+		{
+			uint32 Hash = HashCombine(GetTypeHash(Key.PinType.PinCategory), GetTypeHash(Key.PinType.PinSubCategory));
+			Hash = HashCombine(Hash, GetTypeHash(Key.PinType.PinSubCategoryObject.Get()));
+			Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(Key.PinType.ContainerType)));
+			Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(Key.Direction)));
+			return HashCombine(Hash, GetTypeHash(Key.NodeClass));
+		}
+	};
+
+	struct FPinEntry
+	{
+		FEdGraphPinReference Pin;
+
+		// position of the pin in the graph's nodes and their pins
+		int32 Order = 0;
+	};
+
+	struct FPinGroup
+	{
+		FPinTypeKey Key;
+		TArray<FPinEntry> Pins;
+	};
+
+	// false for the graphs of other schemas, where only the schema knows what a response depends on
+	bool bGroupByType = false;
+
+	TArray<FPinGroup> Groups;
+	TMap<FPinTypeKey, int32> GroupLookup;
+
+	// pins whose response depends on more than their type
+	TArray<FPinEntry> UngroupedPins;
+
+	// per source pin type, the response of each group: INDEX_NONE until asked, then 0 or 1
+	TMap<FPinTypeKey, TArray<int8>> SourceResponses;
+
+	bool GetPinTypeKey(const UEdGraphPin* Pin, FPinTypeKey& OutKey) const;
+
+	static bool CanConnect(const UEdGraphPin* SourcePin, const UEdGraphPin* Pin);
+};
@@ -0,0 +1,50 @@
+// Copyright 2021 fpwong. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+
+class SGraphPanel;
+class SGraphPin;
+
+/**
+ * @brief Grid of the pin bounds of a graph panel's visible nodes, for the hovered pin queries
+ *		- Built on the first query of a frame, so any number of queries in the frame read the pin geometry once
+ *		- Hovering a wire hovers one of its pins without the cursor being over it, so the linked pins are listed too
+ */
+class BLUEPRINTASSIST_API FBAPinHitGrid
+{
+public:
+	/** The grid of the panel for the current frame */
+	static const FBAPinHitGrid& Get(TSharedPtr<SGraphPanel> GraphPanel);
+
+	/** The visible pins whose bounds contain a point in graph space, in panel order */
+	void QueryPoint(const FVector2D& GraphPoint, TArray<TSharedPtr<SGraphPin>>& OutPins) const;
+
+	/** The pins with links, in panel order */
+	void GetLinkedPins(TArray<TSharedPtr<SGraphPin>>& OutPins) const;
+
+private:
+	struct FPinEntry
+	{
+		TWeakPtr<SGraphPin> GraphPin;
+		FSlateRect Bounds;
+		bool bLinked = false;
+	};
+
+	static constexpr float CellSize = 128.0f;
+
+	// pin widgets are measured by their desired size, which can be a little smaller than what is drawn
+	static constexpr float BoundsPadding = 4.0f;
+
+	TWeakPtr<SGraphPanel> BuiltPanel;
+	uint64 BuiltFrame = MAX_uint64;
+
+	TArray<FPinEntry> Pins;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	void Rebuild(TSharedPtr<SGraphPanel> GraphPanel);
+
+	static FIntPoint GetCell(const FVector2D& Point);
+};
@@ -258,7 +258,7 @@ public:
 	UPROPERTY(EditAnywhere, config, Category = FormattingOptions)
 	EBAWiringStyle ParameterWiringStyle;
 
-	/* Reuse knot nodes instead of creating new ones every time */
+	/* Reuse knot nodes instead of deleting and creating new ones every time the nodes are formatted */
 	UPROPERTY(EditAnywhere, config, Category = FormattingOptions)
 	bool bUseKnotNodePool;
 
@@ -554,6 +554,10 @@ public:
 	UPROPERTY(EditAnywhere, config, Category = Experimental)
 	bool bEnableFasterFormatting;
 
+	/* Format new nodes right away using node sizes estimated from their title and pins, then format them again once their real size has been measured */
+	UPROPERTY(EditAnywhere, config, Category = Experimental)
+	bool bFormatWithEstimatedNodeSizes;
+
 	/* Align execution nodes to the 8x8 grid when formatting */
 	UPROPERTY(EditAnywhere, config, Category = Experimental)
 	bool bAlignExecNodesTo8x8Grid;
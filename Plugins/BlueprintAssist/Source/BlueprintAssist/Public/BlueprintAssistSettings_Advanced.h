@@ -35,6 +35,14 @@ public:
 	UPROPERTY(EditAnywhere, config, Category = "Cache")
 	bool bPrettyPrintCacheJSON;
 
+	/* Size limit of the cache files in megabytes. Past it, the files of the least recently used packages are deleted after a save. 0 for no limit */
+	UPROPERTY(EditAnywhere, config, Category = "Cache", meta = (ClampMin = 0))
+	int CacheSizeLimitMB;
+
+	/* Cache data of packages not used for this many minutes is released from memory after a save, and read again when needed */
+	UPROPERTY(EditAnywhere, config, Category = "Cache", meta = (ClampMin = 0))
+	float ReleaseUnusedCacheDataMinutes;
+
 	/* Use a custom blueprint action menu for creating nodes (very prototype, not supported in 5.0 or earlier) */
 	UPROPERTY(EditAnywhere, config, Category = "Misc|Experimental")
 	bool bUseCustomBlueprintActionMenu;
@@ -6,6 +6,9 @@
 #include "Engine/EngineTypes.h"
 
 struct FSlateDebuggingFocusEventArgs;
+class FWeakWidgetPath;
+class FWidgetPath;
+struct FFocusEvent;
 class FBAGraphHandler;
 class SDockTab;
 class SWindow;
@@ -45,6 +48,14 @@ private:
 
 	FDelegateHandle OnTabForegroundedDelegateHandle;
 	FDelegateHandle OnActiveTabChangedDelegateHandle;
+	FDelegateHandle OnFocusChangingDelegateHandle;
+
+	// set by tab and focus events, the tab checks run on the next tick instead of every tick
+	bool bTabStateDirty = true;
+
+	// content swapped inside a tab raises no event, so the checks still run every so often
+	float TimeSinceTabCheck = 0.0f;
+	float TabCheckInterval = 0.5f;
 
 	FTimerHandle ProcessTabsTimerHandle;
 	TSet<TWeakPtr<SDockTab>> TabsToProcess;
@@ -61,12 +72,21 @@ private:
 
 	void OnActiveTabChanged(TSharedPtr<SDockTab> PreviousTab, TSharedPtr<SDockTab> NewTab);
 
+	void OnFocusChanging(const FFocusEvent& FocusEvent, const FWeakWidgetPath& OldFocusedWidgetPath, const TSharedPtr<SWidget>& OldFocusedWidget, const FWidgetPath& NewFocusedWidgetPath, const TSharedPtr<SWidget>& NewFocusedWidget);
+
 	void CheckActiveTabContentChanged();
 
 	void RemoveInvalidTabs();
 
 	TSharedPtr<SDockTab> GetChildTabWithGraphEditor(TSharedPtr<SWidget> Widget) const;
 
+	// the widget searches below are cached per tab and checked against the widget tree before use
+	TSharedPtr<SDockTab> FindChildTabWithGraphEditor(TSharedPtr<SDockTab> MajorTab);
+	TSharedPtr<SGraphEditor> FindGraphEditor(TSharedPtr<SDockTab> Tab);
+
+	TMap<TWeakPtr<SDockTab>, TWeakPtr<SDockTab>> ChildTabWithGraphEditorCache;
+	TMap<TWeakPtr<SDockTab>, TWeakPtr<SGraphEditor>> GraphEditorCache;
+
 	void ProcessTabs();
 
 	TWeakPtr<SWidget> LastTabContent; 
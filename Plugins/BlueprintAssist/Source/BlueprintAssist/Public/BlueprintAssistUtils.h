@@ -136,10 +136,10 @@ struct BLUEPRINTASSIST_API FBAUtils
 	static FVector2D GetPinPos(TSharedPtr<FBAGraphHandler> GraphHandler, UEdGraphPin* Pin);
 	static FVector2D GetPinPos(TSharedPtr<SGraphPin> Pin);
 
-	/** Checks all nodes on the graph and sorts them depending on whether they are on the LHS or RHS of a given node */
+	/** Finds the nodes near a given node and sorts them depending on whether they are on the LHS or RHS of it */
 	static void SortNodesOnGraphByDistance(
 		UEdGraphNode* RelativeNode,
-		const UEdGraph* Graph,
+		TSharedPtr<FBAGraphHandler> GraphHandler,
 		TSet<UEdGraphNode*>& LHSNodes,
 		TSet<UEdGraphNode*>& RHSNodes,
 		TSet<UEdGraphPin*>& LHSPins,
@@ -221,6 +221,11 @@ struct BLUEPRINTASSIST_API FBAUtils
 
 	static bool DoesNodeHaveExecutionTo(UEdGraphNode* NodeA, UEdGraphNode* NodeB, EEdGraphPinDirection Direction = EGPD_MAX);
 
+	// every node DoesNodeHaveExecutionTo would find from Node, so many nodes can be tested against one walk
+	static TSet<UEdGraphNode*> GetExecutionReachableNodes(UEdGraphNode* Node, EEdGraphPinDirection Direction = EGPD_MAX);
+
+	static bool DoesNodeHaveExecutionTo(const TSet<UEdGraphNode*>& ExecutionReachableNodes, UEdGraphNode* Node);
+
 	static bool IsLoopingPinLink(FPinLink& PinLink, EEdGraphPinDirection Direction = EGPD_Output);
 
 	static UEdGraphNode* GetExecutingNode(UEdGraphNode* Node);
@@ -428,6 +433,12 @@ struct BLUEPRINTASSIST_API FBAUtils
 		const TArray<FName>& Types,
 		const FName& StopAtParent);
 
+	// walks up from Widget, cheap enough to check a cached widget is still in place before using it
+	static bool IsWidgetInside(
+		TSharedPtr<SWidget> Widget,
+		TSharedPtr<SWidget> Ancestor,
+		bool bVisibleOnly = false);
+
 	static TSharedPtr<SGraphNode> GetGraphNode(
 		TSharedPtr<SGraphPanel> GraphPanel,
 		UEdGraphNode* Node);
@@ -8,6 +8,7 @@
 
 #include "CoreMinimal.h"
 #include "BAFilteredList.h"
+#include "EdGraph/EdGraphPin.h"
 
 class FBAGraphHandler;
 struct FEdGraphSchemaAction;
@@ -21,6 +22,20 @@ struct FBAActionMenuItem final : IBAFilteredListItem
 	TSharedPtr<FEdGraphSchemaAction> Action;
 };
 
+/**
+ * The items and search index of the last opened menu, kept by the graph handler. Gathering the actions from the action
+ * database is the slow part of opening the menu, so they are only gathered again after the graph or the actions changed.
+ */
+struct FBAActionMenuCache
+{
+	uint32 GraphChangeCount = MAX_uint32;
+	bool bContextSensitive = true;
+	FEdGraphPinReference ContextPin;
+
+	TArray<TSharedPtr<FBAActionMenuItem>> Items;
+	TSharedPtr<FBAFilteredListSearchIndex> SearchIndex;
+};
+
 class BLUEPRINTASSIST_API SBABlueprintActionMenu final : public SCompoundWidget
 {
 	// TODO should allow for using any EdGraphPin as context instead of only the selected pin
@@ -38,6 +53,8 @@ class BLUEPRINTASSIST_API SBABlueprintActionMenu final : public SCompoundWidget
 
 	void InitListItems(TArray<TSharedPtr<FBAActionMenuItem>>& Items);
 
+	TSharedPtr<FBAFilteredListSearchIndex> GetSearchIndex() const { return ItemsSearchIndex; }
+
 	TSharedRef<ITableRow> CreateItemWidget(TSharedPtr<FBAActionMenuItem> Item, const TSharedRef<STableViewBase>& OwnerTable) const;
 
 	void SelectItem(TSharedPtr<FBAActionMenuItem> Item);
@@ -52,6 +69,9 @@ protected:
 
 	void OnContextSensitiveChanged(ECheckBoxState NewState);
 
+	// the cached index of the items InitListItems gave, null when they were not cached
+	TSharedPtr<FBAFilteredListSearchIndex> ItemsSearchIndex;
+
 	TSharedPtr<SBAFilteredList<TSharedPtr<FBAActionMenuItem>>> FilteredList;
 };
 
@@ -4,7 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "BlueprintAssistTypes.h"
+#include "BlueprintAssistFormatters/BAFormatterProfiler.h"
 #include "Components/HorizontalBox.h"
+#include "Widgets/Views/SListView.h"
+#include "Widgets/Views/STableRow.h"
 
 class BLUEPRINTASSIST_API SBADebugMenuRow final : public SHorizontalBox
 {
@@ -22,6 +25,19 @@ class BLUEPRINTASSIST_API SBADebugMenuRow final : public SHorizontalBox
 	void Construct(const FArguments& InArgs);
 };
 
+class BLUEPRINTASSIST_API SBAFormatterRunRow final : public SMultiColumnTableRow<TSharedPtr<FBAFormatterRun>>
+{
+	SLATE_BEGIN_ARGS(SBAFormatterRunRow) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FBAFormatterRun> InRun);
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override;
+
+private:
+	TSharedPtr<FBAFormatterRun> Run;
+};
+
 class BLUEPRINTASSIST_API SBADebugMenu final : public SCompoundWidget
 {
 	SLATE_BEGIN_ARGS(SBADebugMenu) {}
@@ -42,5 +58,13 @@ class BLUEPRINTASSIST_API SBADebugMenu final : public SCompoundWidget
 	FText KeyboardFocusWidget;
 	FText UserFocusWidget;
 
+	// copy of the profiler's runs, refreshed on tick when a format finishes
+	TArray<TSharedPtr<FBAFormatterRun>> FormatterRuns;
+	TSharedPtr<SListView<TSharedPtr<FBAFormatterRun>>> FormatterRunsView;
+
+	TSharedRef<SWidget> MakeFormatterRunsPanel();
+
+	void RefreshFormatterRuns();
+
 	static void RegisterNomadTab();
 };
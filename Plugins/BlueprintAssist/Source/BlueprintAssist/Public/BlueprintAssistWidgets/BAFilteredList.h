@@ -31,6 +31,35 @@ public:
 	virtual FString GetKeySearchText() const { return ToString(); }
 };
 
+/**
+ * Lowercased search texts of a filtered list's items, with trigram postings so a filter only checks the items holding
+ * its rarest trigram rather than every item.
+ */
+class BLUEPRINTASSIST_API FBAFilteredListSearchIndex
+{
+public:
+	void Reset(int32 NumItems = 0);
+
+	// items must be added in list order
+	void AddItem(const FString& SearchText, const FString& KeySearchText);
+
+	int32 Num() const { return SearchTexts.Num(); }
+
+	// indices of the items whose search text contains every (lowercase) term, in list order
+	// Candidates, if given, must already contain every match, e.g. the matches of a query these terms narrow
+	void Filter(const TArray<FString>& Terms, const TArray<int32>* Candidates, TArray<int32>& OutMatches) const;
+
+	// exact key matches first, then shorter keys, otherwise keeping the list order
+	void SortMatches(const FString& FilterString, TArray<int32>& Matches) const;
+
+private:
+	static uint64 GetTrigram(const TCHAR* Chars);
+
+	TArray<FString> SearchTexts;
+	TArray<FString> KeySearchTexts;
+	TMap<uint64, TArray<int32>> TrigramPostings;
+};
+
 template<typename ItemType>
 class BLUEPRINTASSIST_API SBAFilteredList final
 	: public SCompoundWidget
@@ -40,6 +69,7 @@ class BLUEPRINTASSIST_API SBAFilteredList final
 	DECLARE_DELEGATE_OneParam(FBAInitListItems, TArray<ItemType>&);
 	DECLARE_DELEGATE_OneParam(FBAOnSelectItem, ItemType);
 	DECLARE_DELEGATE_OneParam(FBAOnMarkActiveSuggestion, ItemType);
+	DECLARE_DELEGATE_RetVal(TSharedPtr<FBAFilteredListSearchIndex>, FBAGetSearchIndex);
 
 public:
 	SLATE_BEGIN_ARGS(SBAFilteredList)
@@ -52,6 +82,9 @@ public:
 		SLATE_EVENT(FBAOnSelectItem, OnSelectItem)
 		SLATE_EVENT(FBAOnMarkActiveSuggestion, OnMarkActiveSuggestion)
 		SLATE_EVENT(FBAOnGenerateRow, OnGenerateRow)
+
+		// an index the owner keeps for the items it inits between openings, filled on the first filter while empty
+		SLATE_EVENT(FBAGetSearchIndex, GetSearchIndex)
 		SLATE_ARGUMENT(FVector2D, WidgetSize)
 		SLATE_ARGUMENT(FString, MenuTitle)
 		SLATE_ARGUMENT(ESelectionMode::Type, SelectionMode)
@@ -73,14 +106,23 @@ public:
 private:
 	FBAOnSelectItem OnSelectItem;
 	FBAOnMarkActiveSuggestion OnMarkActiveSuggestion;
+	FBAGetSearchIndex GetSearchIndex;
 	FText FilterText;
 
+	// built on the first filter after the items are generated, unless the owner's index already holds them
+	TSharedPtr<FBAFilteredListSearchIndex> SearchIndex;
+
+	// the previous query's terms and matches, a query which only extends it searches those matches
+	TArray<FString> LastFilterTerms;
+	TArray<int32> LastMatches;
+
 public:
 	BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 	void Construct(const FArguments& InArgs)
 	{
 		OnSelectItem = InArgs._OnSelectItem;
 		OnMarkActiveSuggestion = InArgs._OnMarkActiveSuggestion;
+		GetSearchIndex = InArgs._GetSearchIndex;
 		WidgetSize = InArgs._WidgetSize;
 		MenuTitle = InArgs._MenuTitle;
 		SelectionMode = InArgs._SelectionMode;
@@ -186,9 +228,17 @@ public:
 	void GenerateItems(bool bRefreshList = true)
 	{
 		AllItems.Empty();
+		LastFilterTerms.Reset();
+		LastMatches.Reset();
 
 		InitListItems.Execute(AllItems);
 
+		SearchIndex = GetSearchIndex.IsBound() ? GetSearchIndex.Execute() : nullptr;
+		if (!SearchIndex.IsValid())
+		{
+			SearchIndex = MakeShared<FBAFilteredListSearchIndex>();
+		}
+
 		FilteredItems = AllItems;
 
 		if (bRefreshList && FilteredItemsListView.IsValid())
@@ -211,48 +261,48 @@ public:
 
 		FilteredItems.Empty();
 
-		const bool bRequiresFiltering = FilterTerms.Num() > 0;
-		for (int32 ItemIndex = 0; ItemIndex < AllItems.Num(); ++ItemIndex)
+		if (FilterTerms.Num() == 0)
 		{
-			ItemType Item = AllItems[ItemIndex];
-
-			// If we're filtering, search check to see if we need to show this action
-			bool bShowAction = true;
-			if (bRequiresFiltering)
+			FilteredItems = AllItems;
+			LastFilterTerms.Reset();
+			LastMatches.Reset();
+		}
+		else
+		{
+			if (SearchIndex->Num() != AllItems.Num())
 			{
-				FString SearchText = Item->GetSearchText();
-				SearchText.ReplaceInline(TEXT(" "), TEXT(""));
-
-				FString EachTermSanitized;
-				for (int32 FilterIndex = 0; FilterIndex < FilterTerms.Num() && bShowAction; ++FilterIndex)
+				SearchIndex->Reset(AllItems.Num());
+				for (const ItemType& Item : AllItems)
 				{
-					const bool bMatchesTerm = SearchText.Contains(FilterTerms[FilterIndex]);
-					bShowAction = bShowAction && bMatchesTerm;
+					SearchIndex->AddItem(Item->GetSearchText(), Item->GetKeySearchText());
 				}
 			}
 
-			if (bShowAction)
+			for (FString& Term : FilterTerms)
 			{
-				FilteredItems.Add(Item);
+				Term.ToLowerInline();
 			}
-		}
 
-		if (!TrimmedFilterString.IsEmpty())
-		{
-			FilteredItems.StableSort([&FilterString](const ItemType ItemA, const ItemType ItemB)
+			// each new term containing the old term in its place can only match fewer items
+			bool bNarrowsLastFilter = LastFilterTerms.Num() > 0 && FilterTerms.Num() >= LastFilterTerms.Num();
+			for (int32 TermIndex = 0; TermIndex < LastFilterTerms.Num() && bNarrowsLastFilter; ++TermIndex)
 			{
-				if (FilterString.Equals(ItemA->GetKeySearchText(), ESearchCase::IgnoreCase))
-				{
-					return true;
-				}
+				bNarrowsLastFilter = FilterTerms[TermIndex].Contains(LastFilterTerms[TermIndex], ESearchCase::CaseSensitive);
+			}
 
-				if (FilterString.Equals(ItemB->GetKeySearchText(), ESearchCase::IgnoreCase))
-				{
-					return false;
-				}
+			TArray<int32> Matches;
+			SearchIndex->Filter(FilterTerms, bNarrowsLastFilter ? &LastMatches : nullptr, Matches);
 
-				return ItemA->GetKeySearchText().Len() < ItemB->GetKeySearchText().Len();
-			});
+			LastFilterTerms = FilterTerms;
+			LastMatches = Matches;
+
+			SearchIndex->SortMatches(FilterString, Matches);
+
+			FilteredItems.Reserve(Matches.Num());
+			for (int32 ItemIndex : Matches)
+			{
+				FilteredItems.Add(AllItems[ItemIndex]);
+			}
 		}
 
 		FilteredItemsListView->RequestListRefresh();
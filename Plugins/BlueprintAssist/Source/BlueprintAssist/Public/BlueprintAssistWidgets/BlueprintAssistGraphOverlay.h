@@ -125,6 +125,14 @@ protected:
 
 	const FSlateBrush* CachedBorderBrush = nullptr;
 	const FSlateBrush* CachedLockBrush = nullptr;
+	const FSlateBrush* CachedWhiteBrush = nullptr;
+
+	/* Lines and bounds are batched into one custom vertex element, the newest first up to a per frame budget */
+	void DrawDebugPrimitives(
+		FSlateWindowElementList& OutDrawElements,
+		const FGeometry& AllottedGeometry,
+		const int32 LayerId,
+		TSharedPtr<SGraphPanel> GraphPanel) const;
 
 	void DrawWidgetAsBox(
 		FSlateWindowElementList& OutDrawElements,
@@ -6,6 +6,8 @@
 #include "BAFilteredList.h"
 #include "Widgets/SCompoundWidget.h"
 
+struct FAssetData;
+
 struct FBAFileItem : IBAFilteredListItem
 {
 	FString FilePath;
@@ -14,6 +16,39 @@ struct FBAFileItem : IBAFilteredListItem
 	virtual FString ToString() const override { return FilePath; }
 };
 
+/**
+ * Items for every listed asset, gathered from the asset registry on first use and kept up to date from its
+ * added, removed and renamed events, so opening the menu does not walk the whole registry.
+ */
+class BLUEPRINTASSIST_API FBAOpenFileItems
+{
+public:
+	static FBAOpenFileItems& Get();
+	static void TearDown();
+
+	~FBAOpenFileItems();
+
+	void GetItems(TArray<TSharedPtr<FBAFileItem>>& OutItems);
+
+private:
+	void Init();
+
+	static bool IsListedAsset(const FAssetData& AssetData);
+	static FString GetObjectPath(const FAssetData& AssetData);
+
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+	bool bInitialized = false;
+
+	TMap<FString, TSharedPtr<FBAFileItem>> ItemsByObjectPath;
+
+	// rebuilt from ItemsByObjectPath when the registry changed since it was last handed out
+	TArray<TSharedPtr<FBAFileItem>> Items;
+	bool bItemsDirty = true;
+};
+
 /**
  * 
  */
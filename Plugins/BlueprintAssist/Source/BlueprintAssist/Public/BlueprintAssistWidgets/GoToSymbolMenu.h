@@ -6,6 +6,7 @@
 
 #include "BAFilteredList.h"
 
+class UBlueprint;
 class UEdGraph;
 class UEdGraphNode;
 
@@ -29,6 +30,39 @@ struct FGoToSymbolStruct final : IBAFilteredListItem
 	FString GetTypeDescription() const;
 };
 
+/**
+ * The symbols of each blueprint the menu was opened for, collected again only after the blueprint changes or compiles.
+ */
+class BLUEPRINTASSIST_API FBAGoToSymbolCache
+{
+public:
+	static FBAGoToSymbolCache& Get();
+	static void TearDown();
+
+	~FBAGoToSymbolCache();
+
+	void GetSymbols(UBlueprint* Blueprint, TArray<TSharedPtr<FGoToSymbolStruct>>& OutItems);
+
+private:
+	struct FBlueprintSymbols
+	{
+		TArray<TSharedPtr<FGoToSymbolStruct>> Items;
+
+		// the nodes and graphs the items point to, a deleted one means the items are stale
+		TArray<TWeakObjectPtr<UObject>> Objects;
+
+		bool bDirty = true;
+
+		bool IsStale() const;
+	};
+
+	static void CollectSymbols(UBlueprint* Blueprint, FBlueprintSymbols& OutSymbols);
+
+	void OnBlueprintChanged(UBlueprint* Blueprint);
+
+	TMap<TWeakObjectPtr<UBlueprint>, FBlueprintSymbols> SymbolsByBlueprint;
+};
+
 class BLUEPRINTASSIST_API SGoToSymbolMenu final : public SBorder
 {
 	// @formatter:off
@@ -52,8 +52,6 @@ protected:
 	FVector2D SavedLocation;
 	TSharedPtr<FPinLinkerStruct> LastSelectedItem;
 
-	bool CanConnectSourceToPin(UEdGraphPin* Pin);
-
 	virtual void Tick(
 		const FGeometry& AllottedGeometry,
 		const double InCurrentTime,
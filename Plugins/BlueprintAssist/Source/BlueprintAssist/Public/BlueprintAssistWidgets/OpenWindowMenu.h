@@ -6,6 +6,7 @@
 #include "BAFilteredList.h"
 #include "AssetRegistry/AssetData.h"
 #include "Framework/Commands/UIAction.h"
+#include "Modules/ModuleManager.h"
 #include "Textures/SlateIcon.h"
 
 class FUICommandInfo;
@@ -130,6 +131,7 @@ struct FOpenSettingItem final : FOpenWindowItem_Base
 		, SectionName(InSection)
 	{
 		SectionDisplayName = SectionName.ToString();
+		CacheStrings();
 	}
 
 	FOpenSettingItem(const FName& InContainer, const FName& InCategory, const FName& InSection, const FString& InSectionDisplayName)
@@ -137,7 +139,9 @@ struct FOpenSettingItem final : FOpenWindowItem_Base
 		, CategoryName(InCategory)
 		, SectionName(InSection)
 		, SectionDisplayName(InSectionDisplayName)
-	{ }
+	{
+		CacheStrings();
+	}
 
 	FOpenSettingItem() = default;
 
@@ -145,11 +149,11 @@ struct FOpenSettingItem final : FOpenWindowItem_Base
 
 	virtual FString GetSearchText() const override;
 
-	FString GetCategoryString() const;
+	const FString& GetCategoryString() const { return CategoryString; }
 
 	virtual const FString* GetDetailsString() override
 	{
-		return new FString(GetCategoryString());
+		return &CategoryString;
 	}
 
 	bool operator==(const FOpenSettingItem& Other);
@@ -157,6 +161,13 @@ struct FOpenSettingItem final : FOpenWindowItem_Base
 
 	virtual const FSlateBrush* GetIcon() override;
 	virtual void SelectItem() override;
+
+private:
+	void CacheStrings();
+
+	// the settings items are kept between menus, so their text is built once
+	FString CategoryString;
+	FString SearchText;
 };
 
 struct FWidgetItem final : FOpenWindowItem_Base
@@ -180,6 +191,42 @@ struct FEditorUtilityItem final : FOpenWindowItem_Base
 	virtual void SelectItem() override;
 };
 
+/**
+ * Window menu items which are slow to discover: the auto registered developer settings and the editor utility widgets.
+ * They are gathered on first use, the settings again after a module loads, the utilities from asset registry events.
+ */
+class BLUEPRINTASSIST_API FBAOpenWindowItemCache
+{
+public:
+	static FBAOpenWindowItemCache& Get();
+	static void TearDown();
+
+	~FBAOpenWindowItemCache();
+
+	const TArray<TSharedPtr<FOpenSettingItem>>& GetDeveloperSettingsItems();
+
+	void GetEditorUtilityItems(TArray<TSharedPtr<FOpenWindowItem_Base>>& OutItems);
+
+private:
+	void CacheDeveloperSettingsItems();
+	void CacheEditorUtilityItems();
+
+	static bool IsEditorUtilityAsset(const FAssetData& AssetData);
+	static FString GetObjectPath(const FAssetData& AssetData);
+
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+	TArray<TSharedPtr<FOpenSettingItem>> DeveloperSettingsItems;
+	bool bDeveloperSettingsDirty = true;
+	FDelegateHandle OnModulesChangedHandle;
+
+	TMap<FString, TSharedPtr<FEditorUtilityItem>> EditorUtilityItems;
+	bool bEditorUtilityItemsCached = false;
+};
+
 class BLUEPRINTASSIST_API SOpenWindowMenu final : public SCompoundWidget
 {
 	// @formatter:off
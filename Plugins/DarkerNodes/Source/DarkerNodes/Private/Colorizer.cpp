@@ -11,6 +11,44 @@
 #include "Runtime/Launch/Resources/Version.h"
 #include "Settings/EditorStyleSettings.h"
 
+const TArray<EStyleColor>& FColorizer::GetThemedStyleColors()
+{
+	static const TArray<EStyleColor> StyleColors = {
+		//EStyleColor::Black,
+		EStyleColor::Background,
+		EStyleColor::Title,
+		EStyleColor::WindowBorder,
+		EStyleColor::Foldout,
+		EStyleColor::Input,
+		EStyleColor::InputOutline,
+		EStyleColor::Recessed,
+		EStyleColor::Panel,
+		EStyleColor::Header,
+		EStyleColor::Dropdown,
+		EStyleColor::DropdownOutline,
+		EStyleColor::Hover,
+		EStyleColor::Hover2,
+		//EStyleColor::White,
+		EStyleColor::White25,
+		EStyleColor::Highlight,
+		EStyleColor::Primary,
+		EStyleColor::PrimaryHover,
+		EStyleColor::PrimaryPress,
+		EStyleColor::Secondary,
+		EStyleColor::Foreground,
+		EStyleColor::ForegroundHover,
+		EStyleColor::ForegroundInverted,
+		EStyleColor::ForegroundHeader,
+		EStyleColor::Select,
+		EStyleColor::SelectInactive,
+		EStyleColor::SelectParent,
+		EStyleColor::SelectHover,
+		EStyleColor::Notifications
+	};
+
+	return StyleColors;
+}
+
 FColorizer::FColorizer()
 {
 	LoadDatabase();
@@ -37,6 +75,7 @@ FColorizer::FColorizer()
 	ThemeDirectory = PluginDirectory + FString("/Resources/Theme");
 	FontsDirectory = PluginDirectory + FString("/Resources/Fonts");
 	GlobalSettingsFile = PluginDirectory + "/Settings.ini";
+	ThemeCacheFile = FPaths::ProjectSavedDir() + "DarkerNodes/ThemeCache.bin";
 
 	if (DarkerNodesSettings->UseGlobalSettings)
 	{
@@ -46,40 +85,7 @@ FColorizer::FColorizer()
 		}
 	}
 
-	EStyleColor StyleColors[] = {
-		//EStyleColor::Black,
-		EStyleColor::Background,
-		EStyleColor::Title,
-		EStyleColor::WindowBorder,
-		EStyleColor::Foldout,
-		EStyleColor::Input,
-		EStyleColor::InputOutline,
-		EStyleColor::Recessed,
-		EStyleColor::Panel,
-		EStyleColor::Header,
-		EStyleColor::Dropdown,
-		EStyleColor::DropdownOutline,
-		EStyleColor::Hover,
-		EStyleColor::Hover2,
-		//EStyleColor::White,
-		EStyleColor::White25,
-		EStyleColor::Highlight,
-		EStyleColor::Primary,
-		EStyleColor::PrimaryHover,
-		EStyleColor::PrimaryPress,
-		EStyleColor::Secondary,
-		EStyleColor::Foreground,
-		EStyleColor::ForegroundHover,
-		EStyleColor::ForegroundInverted,
-		EStyleColor::ForegroundHeader,
-		EStyleColor::Select,
-		EStyleColor::SelectInactive,
-		EStyleColor::SelectParent,
-		EStyleColor::SelectHover,
-		EStyleColor::Notifications
-	};
-	
-	for (auto Color: StyleColors)
+	for (const EStyleColor Color : GetThemedStyleColors())
 	{
 		DefaultColors[(int32)Color] = CurrentTheme->LoadedDefaultColors[(int32)Color];
 	}
@@ -129,14 +135,84 @@ void FColorizer::ResetColors()
 	TextShadow = FColor(10, 10, 10);
 }
 
-void FColorizer::ReloadStyle()
+EColorizerUpdate FColorizer::GetSettingUpdates(FName PropertyName)
+{
+	static const TMap<FName, EColorizerUpdate> SettingUpdates = []
+	{
+		constexpr EColorizerUpdate Theme = EColorizerUpdate::ThemeColors | EColorizerUpdate::DerivedColors | EColorizerUpdate::Parameters;
+		constexpr EColorizerUpdate Derived = EColorizerUpdate::DerivedColors | EColorizerUpdate::Parameters;
+
+		TMap<FName, EColorizerUpdate> Updates;
+
+		// Applied by Reload itself or only on the next editor start
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ReloadDefaultStyle), EColorizerUpdate::None);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ActivatePopupOnUpdate), EColorizerUpdate::None);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, UpdateMaterials), EColorizerUpdate::None);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ReloadTextureResources), EColorizerUpdate::None);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ActivateBlueprintTheme), EColorizerUpdate::None);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, BlueprintVarNodeLine), EColorizerUpdate::None);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, DisableBlueprintGrid), EColorizerUpdate::None);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, KeepDefaultCommentColor), EColorizerUpdate::None);
+
+		// Theme
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, Preset), Theme);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ThemeLuminosity), Theme);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ThemeSaturation), Theme);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ThemeHue), Theme);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, KeepForegroundLuminosity), Theme);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, LightTheme), Theme);
+
+		// Fonts
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, FontSize), EColorizerUpdate::Fonts);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, FontFamily), EColorizerUpdate::Fonts);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, UseCustomRegularFont), EColorizerUpdate::Fonts);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, RegularFont), EColorizerUpdate::Fonts);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, UseCustomBoldFont), EColorizerUpdate::Fonts);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, BoldFont), EColorizerUpdate::Fonts);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, UseCustomItalicFont), EColorizerUpdate::Fonts);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ItalicFont), EColorizerUpdate::Fonts);
+
+		// Node materials
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, BlueprintRegularNodeRadius), EColorizerUpdate::Parameters);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, BlueprintVarNodeRadius), EColorizerUpdate::Parameters);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, BlueprintNodeHeaderOpacity), EColorizerUpdate::Parameters);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, BlueprintNodeHeaderSaturation), EColorizerUpdate::Parameters);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ExtendNodes), EColorizerUpdate::Parameters);
+
+		// Colors computed from the theme
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, BlueprintVarNodeOpacity), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, DisableUMGGrid), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, OriginAxisOpacity), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, OverwriteColors), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, UseColorCustomization), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, TextColor), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, UseWindowCustomization), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, MainWindowColor), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, ChildWindowColor), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, UseBlueprintColorCustomization), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, GridLineColor), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, GridRuleColor), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, GridCenterColor), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, RegularNodeBackground), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, RegularNodeBorder), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, VarNodeBackground), Derived);
+		Updates.Add(GET_MEMBER_NAME_CHECKED(UDarkerNodesSettings, VarNodeBorder), Derived);
+
+		return Updates;
+	}();
+
+	// Anything not listed (MasterActivate, global settings...) reloads the whole style
+	const EColorizerUpdate* Updates = SettingUpdates.Find(PropertyName);
+	return Updates ? *Updates : EColorizerUpdate::All;
+}
+
+void FColorizer::ReloadStyle(EColorizerUpdate Updates)
 {
 	if (!DarkerNodesSettings->MasterActivate)
 	{
 		return;
 	}
 
-	ResetColors();
 	//USlateThemeManager::Get().ValidateActiveTheme();
 	
 	if (DarkerNodesSettings->Preset != EPresets::SelectPreset)
@@ -201,57 +277,92 @@ void FColorizer::ReloadStyle()
 		DarkerNodesSettings->SaveConfig();
 	}
 
-	EStyleColor StyleColors[] = {
-		//EStyleColor::Black,
-		EStyleColor::Background,
-		EStyleColor::Title,
-		EStyleColor::WindowBorder,
-		EStyleColor::Foldout,
-		EStyleColor::Input,
-		EStyleColor::InputOutline,
-		EStyleColor::Recessed,
-		EStyleColor::Panel,
-		EStyleColor::Header,
-		EStyleColor::Dropdown,
-		EStyleColor::DropdownOutline,
-		EStyleColor::Hover,
-		EStyleColor::Hover2,
-		//EStyleColor::White,
-		EStyleColor::White25,
-		EStyleColor::Highlight,
-		EStyleColor::Primary,
-		EStyleColor::PrimaryHover,
-		EStyleColor::PrimaryPress,
-		EStyleColor::Secondary,
-		EStyleColor::Foreground,
-		EStyleColor::ForegroundHover,
-		EStyleColor::ForegroundInverted,
-		EStyleColor::ForegroundHeader,
-		EStyleColor::Select,
-		EStyleColor::SelectInactive,
-		EStyleColor::SelectParent,
-		EStyleColor::SelectHover,
-		EStyleColor::Notifications
-	};
-	
-	const float Shift = FMath::Pow(FMath::Abs((float)DarkerNodesSettings->ThemeLuminosity / 100.0f), 2) * 0.8f * FMath::Sign(DarkerNodesSettings->ThemeLuminosity);
-	
-	for (auto Color: StyleColors)
+	const uint32 ThemeHash = HashThemeSettings();
+	if (ThemeHash == AppliedThemeHash)
 	{
-		FColor ThemeColor = DefaultColors[(int32)Color].ToFColorSRGB();
-		
-		if (Color != EStyleColor::Foreground || !DarkerNodesSettings->KeepForegroundLuminosity)
+		// nothing the theme depends on changed
+		return;
+	}
+
+	// the cache holds the theme and the derived colors, a setting that changes neither keeps the current ones
+	if (EnumHasAnyFlags(Updates, EColorizerUpdate::ThemeColors | EColorizerUpdate::DerivedColors) && !LoadThemeCache(ThemeHash))
+	{
+		CompileTheme(Updates);
+		SaveThemeCache(ThemeHash);
+	}
+
+	if (EnumHasAnyFlags(Updates, EColorizerUpdate::ThemeColors))
+	{
+		for (const EStyleColor Color : GetThemedStyleColors())
 		{
-			ThemeColor = ShiftLight(ThemeColor, Shift);
+			USlateThemeManager::Get().ResetActiveColorToDefault(Color);
 		}
-		
-		ThemeColor = ShiftSaturation(ThemeColor, DarkerNodesSettings->ThemeSaturation/100.0f, DarkerNodesSettings->ThemeHue);
-		if (DarkerNodesSettings->LightTheme)
+	}
+
+	if (EnumHasAnyFlags(Updates, EColorizerUpdate::DerivedColors) && DarkerNodesSettings->OverwriteColors)
+	{
+		if (!DarkerNodesSettings->UseColorCustomization)
+		{
+			DarkerNodesSettings->TextColor = TextColor;
+		}
+
+		if (!DarkerNodesSettings->UseWindowCustomization)
+		{
+			DarkerNodesSettings->MainWindowColor = MainWindowColor;
+			DarkerNodesSettings->ChildWindowColor = ChildWindowColor;
+		}
+
+		if (!DarkerNodesSettings->UseBlueprintColorCustomization)
+		{
+			DarkerNodesSettings->GridLineColor = GridLineColor;
+			DarkerNodesSettings->GridRuleColor = GridRuleColor;
+			DarkerNodesSettings->GridCenterColor = GridCenterColor;
+
+			DarkerNodesSettings->RegularNodeBackground = RegularNodeBackground;
+			DarkerNodesSettings->RegularNodeBorder = RegularNodeBorder;
+			DarkerNodesSettings->VarNodeBackground = VarNodeBackground;
+			DarkerNodesSettings->VarNodeBorder = VarNodeBorder;
+		}
+	}
+
+	AppliedThemeHash = ThemeHash;
+
+	if (EnumHasAnyFlags(Updates, EColorizerUpdate::Fonts))
+	{
+		ApplyFonts();
+	}
+
+	if (EnumHasAnyFlags(Updates, EColorizerUpdate::Parameters))
+	{
+		ApplyParameters();
+	}
+}
+
+void FColorizer::CompileTheme(EColorizerUpdate Updates)
+{
+	ResetColors();
+
+	// the derived colors alone are computed from the theme colors already loaded
+	if (EnumHasAnyFlags(Updates, EColorizerUpdate::ThemeColors))
+	{
+		const float Shift = FMath::Pow(FMath::Abs((float)DarkerNodesSettings->ThemeLuminosity / 100.0f), 2) * 0.8f * FMath::Sign(DarkerNodesSettings->ThemeLuminosity);
+	
+		for (const EStyleColor Color : GetThemedStyleColors())
 		{
-			ThemeColor = InvertLight(ThemeColor);
+			FColor ThemeColor = DefaultColors[(int32)Color].ToFColorSRGB();
+		
+			if (Color != EStyleColor::Foreground || !DarkerNodesSettings->KeepForegroundLuminosity)
+			{
+				ThemeColor = ShiftLight(ThemeColor, Shift);
+			}
+		
+			ThemeColor = ShiftSaturation(ThemeColor, DarkerNodesSettings->ThemeSaturation/100.0f, DarkerNodesSettings->ThemeHue);
+			if (DarkerNodesSettings->LightTheme)
+			{
+				ThemeColor = InvertLight(ThemeColor);
+			}
+			CurrentTheme->LoadedDefaultColors[(int32)Color] = ThemeColor;
 		}
-		CurrentTheme->LoadedDefaultColors[(int32)Color] = ThemeColor;
-		USlateThemeManager::Get().ResetActiveColorToDefault(Color);
 	}
 
 	GreyDark = CurrentTheme->LoadedDefaultColors[(int32)EStyleColor::Background].ToFColorSRGB();
@@ -309,34 +420,6 @@ void FColorizer::ReloadStyle()
 	HoverDark = MixColor(GreyDark, Primary, 0.1);
 	HoverBase = MixColor(GreyBase, Primary, 0.1);
 	HoverBaseBright = MixColor(GreyBase, Primary, 0.5);
-
-	if (DarkerNodesSettings->OverwriteColors)
-	{
-		if (!DarkerNodesSettings->UseColorCustomization)
-		{
-			DarkerNodesSettings->TextColor = TextColor;
-		}
-
-		if (!DarkerNodesSettings->UseWindowCustomization)
-		{
-			DarkerNodesSettings->MainWindowColor = MainWindowColor;
-			DarkerNodesSettings->ChildWindowColor = ChildWindowColor;
-		}
-
-		if (!DarkerNodesSettings->UseBlueprintColorCustomization)
-		{
-			DarkerNodesSettings->GridLineColor = GridLineColor;
-			DarkerNodesSettings->GridRuleColor = GridRuleColor;
-			DarkerNodesSettings->GridCenterColor = GridCenterColor;
-
-			DarkerNodesSettings->RegularNodeBackground = RegularNodeBackground;
-			DarkerNodesSettings->RegularNodeBorder = RegularNodeBorder;
-			DarkerNodesSettings->VarNodeBackground = VarNodeBackground;
-			DarkerNodesSettings->VarNodeBorder = VarNodeBorder;
-		}
-	}
-
-	ApplyParameters();
 }
 
 void FColorizer::Color()
@@ -380,6 +463,10 @@ void FColorizer::ReloadTextureResources()
 void FColorizer::Reload(UObject* Object, struct FPropertyChangedEvent& Property)
 {
 	const FName PropertyName = Property.GetPropertyName();
+	EColorizerUpdate Updates = GetSettingUpdates(Property.GetMemberPropertyName());
+
+	// while a slider is dragged only the style is updated, the config is saved once it is released
+	const bool bInteractive = Property.ChangeType == EPropertyChangeType::Interactive;
 
 	if (DarkerNodesSettings->ReloadDefaultStyle)
 	{
@@ -418,6 +505,7 @@ void FColorizer::Reload(UObject* Object, struct FPropertyChangedEvent& Property)
 			DarkerNodesSettings->LoadConfig(nullptr, *GlobalSettingsFile);
 		}
 		DarkerNodesSettings->LoadGlobalSettings = false;
+		Updates = EColorizerUpdate::All;
 	}
 
 	if (DarkerNodesSettings->ReloadTextureResources)
@@ -437,7 +525,12 @@ void FColorizer::Reload(UObject* Object, struct FPropertyChangedEvent& Property)
 		return;
 	}
 
-	ReloadStyle();
+	ReloadStyle(Updates);
+
+	if (bInteractive)
+	{
+		return;
+	}
 
 	ISettingsEditorModule* SettingsEditorModule = FModuleManager::GetModulePtr<ISettingsEditorModule>("SettingsEditor");
 	if (SettingsEditorModule)
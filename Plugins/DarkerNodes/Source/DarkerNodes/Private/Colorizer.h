@@ -9,9 +9,22 @@
 #include "DarkerNodesSettings.h"
 #include "Lib/BrushDatabase.h"
 #include "Styling/SlateStyle.h"
+#include "Styling/StyleColors.h"
 
 struct FStyleTheme;
 
+// Parts of the style a setting feeds into, a changed setting only updates these
+enum class EColorizerUpdate : uint8
+{
+	None = 0,
+	ThemeColors = 1 << 0,
+	DerivedColors = 1 << 1,
+	Parameters = 1 << 2,
+	Fonts = 1 << 3,
+	All = ThemeColors | DerivedColors | Parameters | Fonts
+};
+ENUM_CLASS_FLAGS(EColorizerUpdate);
+
 class FColorizer
 {
 public:
@@ -19,9 +32,18 @@ public:
 	void Color();
 
 private:
-	void ReloadStyle();
+	void ReloadStyle(EColorizerUpdate Updates = EColorizerUpdate::All);
+	void CompileTheme(EColorizerUpdate Updates);
+	static EColorizerUpdate GetSettingUpdates(FName PropertyName);
 	void ApplyFonts() const;
 
+	// Theme cache, the compiled colors of the last settings are kept on disk
+	uint32 HashThemeSettings() const;
+	bool LoadThemeCache(uint32 Hash);
+	void SaveThemeCache(uint32 Hash);
+	void SerializeThemeColors(FArchive& Ar);
+	static const TArray<EStyleColor>& GetThemedStyleColors();
+
 	// Colorizers
 	void ColorText();
 	void ColorGraph();
@@ -33,6 +55,8 @@ private:
 	FString ThemeDirectory;
 	FString FontsDirectory;
 	FString GlobalSettingsFile;
+	FString ThemeCacheFile;
+	uint32 AppliedThemeHash = 0;
 	FStyleTheme* CurrentTheme;
 	FSlateStyleSet* AppStyle;
 	FSlateStyleSet* NiagaraStyle;
@@ -8,8 +8,6 @@
 
 void FColorizer::ApplyParameters() const
 {
-	ApplyFonts();
-
 	BrushDatabase->GetDynamicMaterial("GreyBase")->SetVectorParameterValue("Color", FLinearColor::FromSRGBColor(GreyBase));
 	BrushDatabase->GetDynamicMaterial("GreyLight")->SetVectorParameterValue("Color", FLinearColor::FromSRGBColor(GreyLight));
 	BrushDatabase->GetDynamicMaterial("GreyDark")->SetVectorParameterValue("Color", FLinearColor::FromSRGBColor(GreyDark));
@@ -30,10 +28,16 @@ void FColorizer::ApplyParameters() const
 	BrushDatabase->SetSlateColor("GridCenter", FLinearColor::FromSRGBColor(GridCenterColor));
 
 
-	GetMutableDefault<UEditorStyleSettings>()->RegularColor = BrushDatabase->GetColor("GridLine").Get();
-	GetMutableDefault<UEditorStyleSettings>()->RuleColor = BrushDatabase->GetColor("GridRule").Get();
-	GetMutableDefault<UEditorStyleSettings>()->CenterColor = BrushDatabase->GetColor("GridCenter").Get();
-	GetMutableDefault<UEditorStyleSettings>()->SaveConfig();
+	UEditorStyleSettings* StyleSettings = GetMutableDefault<UEditorStyleSettings>();
+	if (StyleSettings->RegularColor != BrushDatabase->GetColor("GridLine").Get() ||
+		StyleSettings->RuleColor != BrushDatabase->GetColor("GridRule").Get() ||
+		StyleSettings->CenterColor != BrushDatabase->GetColor("GridCenter").Get())
+	{
+		StyleSettings->RegularColor = BrushDatabase->GetColor("GridLine").Get();
+		StyleSettings->RuleColor = BrushDatabase->GetColor("GridRule").Get();
+		StyleSettings->CenterColor = BrushDatabase->GetColor("GridCenter").Get();
+		StyleSettings->SaveConfig();
+	}
 
 	BrushDatabase->GetDynamicMaterial("RegularNode_body")->SetVectorParameterValue("Background", FLinearColor::FromSRGBColor(RegularNodeBackground));
 	BrushDatabase->GetDynamicMaterial("RegularNode_body")->SetVectorParameterValue("Border", FLinearColor::FromSRGBColor(RegularNodeBorder));
@@ -75,4 +79,6 @@ void FColorizer::ApplyParameters() const
 		BrushDatabase->GetDynamicMaterial("VarNode_shadow_selected")->SetVectorParameterValue("Padding", FLinearColor(14, 12, 14, 12));
 		BrushDatabase->GetDynamicMaterial("RegularNode_color_spill")->SetVectorParameterValue("Padding", FLinearColor(5, 3, 0, 0));
 	}
+
+	BrushDatabase->ShareDynamicMaterials();
 }
@@ -0,0 +1,105 @@
+﻿/* Copyright (C) 2021 Hugo ATTAL - All Rights Reserved
+* This plugin is downloadable from the Unreal Engine Marketplace
+*/
+
+#include "Colorizer.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace DNThemeCache
+{
+	constexpr uint32 Magic = 0x444E5443; // "DNTC"
+	constexpr int32 Version = 1;
+}
+
+uint32 FColorizer::HashThemeSettings() const
+{
+	// every config value can end up in a brush, a color or a font, so the whole settings object is hashed
+	uint32 Hash = GetTypeHash(CurrentPluginVersion);
+	Hash = HashCombine(Hash, GetTypeHash(DNThemeCache::Version));
+
+	for (TFieldIterator<FProperty> It(UDarkerNodesSettings::StaticClass()); It; ++It)
+	{
+		if (!It->HasAnyPropertyFlags(CPF_Config))
+		{
+			continue;
+		}
+
+		FString Value;
+		It->ExportText_InContainer(0, Value, DarkerNodesSettings, nullptr, nullptr, PPF_None);
+		Hash = HashCombine(Hash, GetTypeHash(It->GetFName()));
+		Hash = HashCombine(Hash, GetTypeHash(Value));
+	}
+
+	// the engine theme the colors are derived from
+	for (const EStyleColor Color : GetThemedStyleColors())
+	{
+		Hash = HashCombine(Hash, GetTypeHash(DefaultColors[(int32)Color].ToFColor(false)));
+	}
+
+	return Hash;
+}
+
+bool FColorizer::LoadThemeCache(uint32 Hash)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *ThemeCacheFile, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	uint32 CachedHash = 0;
+	Reader << Magic << Version << CachedHash;
+
+	if (Reader.IsError() || Magic != DNThemeCache::Magic || Version != DNThemeCache::Version || CachedHash != Hash)
+	{
+		return false;
+	}
+
+	for (const EStyleColor Color : GetThemedStyleColors())
+	{
+		Reader << CurrentTheme->LoadedDefaultColors[(int32)Color];
+	}
+	SerializeThemeColors(Reader);
+
+	if (Reader.IsError())
+	{
+		// the theme is compiled again from scratch, it must not start from half read colors
+		ResetColors();
+		return false;
+	}
+
+	return true;
+}
+
+void FColorizer::SaveThemeCache(uint32 Hash)
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = DNThemeCache::Magic;
+	int32 Version = DNThemeCache::Version;
+	Writer << Magic << Version << Hash;
+
+	for (const EStyleColor Color : GetThemedStyleColors())
+	{
+		Writer << CurrentTheme->LoadedDefaultColors[(int32)Color];
+	}
+	SerializeThemeColors(Writer);
+
+	FFileHelper::SaveArrayToFile(Data, *ThemeCacheFile);
+}
+
+void FColorizer::SerializeThemeColors(FArchive& Ar)
+{
+	Ar << GreyDark << GreyBase << GreyLight << Primary;
+	Ar << HoverDark << HoverBase << HoverBaseBright;
+	Ar << TextColor << ScrollbarColor << MainWindowColor << ChildWindowColor;
+	Ar << GridLineColor << GridRuleColor << GridCenterColor;
+	Ar << RegularNodeBackground << RegularNodeBorder << VarNodeBackground << VarNodeBorder;
+}
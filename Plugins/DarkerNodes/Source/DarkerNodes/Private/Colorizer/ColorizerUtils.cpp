@@ -139,14 +139,14 @@ FSlateBrush* FColorizer::CenterIcon(FName Name, FString Location, FVector2D Size
 
 FColor FColorizer::InvertLight(FColor Color)
 {
-	FVector LAB = FColorLib::XYZtoLAB(FColorLib::RGBtoXYZ(Color));
+	FVector LAB = FColorLib::RGBtoLAB(Color);
 	LAB.X = FMath::Clamp(100.0f - LAB.X, 0, 100);
-	return FColorLib::XYZtoRGB(FColorLib::LABtoXYZ(LAB)).WithAlpha(Color.A);
+	return FColorLib::LABtoRGB(LAB).WithAlpha(Color.A);
 }
 
 FColor FColorizer::ShiftLight(FColor Color, float Shift)
 {
-	FVector LAB = FColorLib::XYZtoLAB(FColorLib::RGBtoXYZ(Color));
+	FVector LAB = FColorLib::RGBtoLAB(Color);
 	if (Shift > 0)
 	{
 		LAB.X = FMath::Clamp(LAB.X + Shift * (100.0f-LAB.X), 0, 100);
@@ -156,12 +156,12 @@ FColor FColorizer::ShiftLight(FColor Color, float Shift)
 		LAB.X = FMath::Clamp(LAB.X + Shift * LAB.X, 0, 100);
 	}
 	
-	return FColorLib::XYZtoRGB(FColorLib::LABtoXYZ(LAB)).WithAlpha(Color.A);
+	return FColorLib::LABtoRGB(LAB).WithAlpha(Color.A);
 }
 
 FColor FColorizer::ShiftSaturation(FColor Color, float Shift, float Hue)
 {
-	const float Lightness = FColorLib::XYZtoLAB(FColorLib::RGBtoXYZ(Color)).X;
+	const float Lightness = FColorLib::RGBtoLAB(Color).X;
 	FVector HSL = FColorLib::RGBtoHSL(Color);
 	HSL.X = Hue;
 	if (Shift > 0)
@@ -175,8 +175,8 @@ FColor FColorizer::ShiftSaturation(FColor Color, float Shift, float Hue)
 	
 	Color = FColorLib::HSLtoRGB(HSL).WithAlpha(Color.A);
 
-	FVector LAB = FColorLib::XYZtoLAB(FColorLib::RGBtoXYZ(Color));
+	FVector LAB = FColorLib::RGBtoLAB(Color);
 	LAB.X = Lightness;
 
-	return FColorLib::XYZtoRGB(FColorLib::LABtoXYZ(LAB)).WithAlpha(Color.A);
+	return FColorLib::LABtoRGB(LAB).WithAlpha(Color.A);
 }
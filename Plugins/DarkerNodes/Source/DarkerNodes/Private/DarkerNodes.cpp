@@ -7,11 +7,14 @@
 #include "Interfaces/IPluginManager.h"
 #include "Interfaces/IMainFrameModule.h"
 #include "Popup/DNUpdatePopup.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 #define LOCTEXT_NAMESPACE "FDarkerNodesModule"
 
 void FDarkerNodesModule::StartupModule()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(PluginStartup_DarkerNodes);
+
 	const FString ShaderDirectory =  IPluginManager::Get().FindPlugin(TEXT("DarkerNodes"))->GetBaseDir() + FString("/Shaders");
 	AddShaderSourceDirectoryMapping("/DarkerNodes", ShaderDirectory);
 	
@@ -90,14 +90,27 @@ FSlateBrush* UBrushDatabase::GetCenteredImageBrush(FString Name, FString Path, F
 	FSlateBrush* Brush = new FSlateBrush();
 	Brush->SetImageSize(Size);
 	Brush->TintColor = FLinearColor::FromSRGBColor(Color);
+
+	// The tint lives on the brush, icons with the same image and size share the texture and the material
+	const FString MaterialKey = FString::Printf(TEXT("%s_%gx%g"), *Path, Size.X, Size.Y);
+	if (UMaterialInstanceDynamic** SharedMaterial = CenteredImageMaterials.Find(MaterialKey))
+	{
+		Brush->SetResourceObject(*SharedMaterial);
+		return Brush;
+	}
+
 	SetMaterial(Brush, "CenterUVs.CenterUVs");
 
-	const FString ImagePath = ThemeDirectory + Path;
-	UTexture2D* Image = FImageUtils::ImportFileAsTexture2D(FPaths::ConvertRelativePathToFull(ImagePath));
+	if (!Textures.Contains(Path))
+	{
+		const FString ImagePath = ThemeDirectory + Path;
+		Textures.Add(Path, FImageUtils::ImportFileAsTexture2D(FPaths::ConvertRelativePathToFull(ImagePath)));
+	}
 
 	UMaterialInstanceDynamic* MaterialInstance = GetDynamicMaterial(Name, Brush);
 	MaterialInstance->SetVectorParameterValue("Size", FVector(Size.X, Size.Y, 0));
-	MaterialInstance->SetTextureParameterValue("Image", Image);
+	MaterialInstance->SetTextureParameterValue("Image", Textures[Path]);
+	CenteredImageMaterials.Add(MaterialKey, MaterialInstance);
 
 	return Brush;
 }
@@ -125,6 +138,7 @@ void UBrushDatabase::CreateSlateBrush(FString Name, FString MaterialName)
 	CreateDynamicMaterial(Name, MaterialName);
 	CreateSlateBrush(Name);
 	SetSlateBrushMaterial(Name, Name);
+	MaterialBrushes.Add(Name);
 }
 
 FSlateBrush* UBrushDatabase::GetSlateBrush(FString Name)
@@ -137,6 +151,96 @@ void UBrushDatabase::SetSlateBrushMaterial(FString Name, FString DynamicMaterial
 	SlateBrushes[Name]->SetResourceObject(DynamicMaterials[DynamicMaterialName]);
 }
 
+void UBrushDatabase::ShareDynamicMaterials()
+{
+	// Every brush keeps its own instance to receive its parameters, only the one it is drawn with is shared
+	TMap<uint32, TArray<UMaterialInstanceDynamic*>> SharedMaterials;
+
+	for (const FString& Name : MaterialBrushes)
+	{
+		UMaterialInstanceDynamic* DynamicMaterial = DynamicMaterials[Name];
+		TArray<UMaterialInstanceDynamic*>& Candidates = SharedMaterials.FindOrAdd(HashParameters(DynamicMaterial));
+
+		UMaterialInstanceDynamic* const* SharedMaterial = Candidates.FindByPredicate([DynamicMaterial](const UMaterialInstanceDynamic* Candidate)
+		{
+			return HasSameParameters(Candidate, DynamicMaterial);
+		});
+
+		if (SharedMaterial)
+		{
+			SlateBrushes[Name]->SetResourceObject(*SharedMaterial);
+		}
+		else
+		{
+			Candidates.Add(DynamicMaterial);
+			SlateBrushes[Name]->SetResourceObject(DynamicMaterial);
+		}
+	}
+}
+
+uint32 UBrushDatabase::HashParameters(const UMaterialInstanceDynamic* Material)
+{
+	// Summed so the order the parameters were set in does not matter
+	uint32 ParametersHash = 0;
+
+	for (const FScalarParameterValue& Parameter : Material->ScalarParameterValues)
+	{
+		ParametersHash += HashCombine(GetTypeHash(Parameter.ParameterInfo.Name), GetTypeHash(Parameter.ParameterValue));
+	}
+
+	for (const FVectorParameterValue& Parameter : Material->VectorParameterValues)
+	{
+		ParametersHash += HashCombine(GetTypeHash(Parameter.ParameterInfo.Name), GetTypeHash(Parameter.ParameterValue));
+	}
+
+	for (const FTextureParameterValue& Parameter : Material->TextureParameterValues)
+	{
+		ParametersHash += HashCombine(GetTypeHash(Parameter.ParameterInfo.Name), GetTypeHash(Parameter.ParameterValue));
+	}
+
+	return HashCombine(GetTypeHash(Material->Parent), ParametersHash);
+}
+
+bool UBrushDatabase::HasSameParameters(const UMaterialInstanceDynamic* A, const UMaterialInstanceDynamic* B)
+{
+	if (A->Parent != B->Parent ||
+		A->ScalarParameterValues.Num() != B->ScalarParameterValues.Num() ||
+		A->VectorParameterValues.Num() != B->VectorParameterValues.Num() ||
+		A->TextureParameterValues.Num() != B->TextureParameterValues.Num())
+	{
+		return false;
+	}
+
+	for (const FScalarParameterValue& Parameter : A->ScalarParameterValues)
+	{
+		float Value;
+		if (!B->GetScalarParameterValue(Parameter.ParameterInfo, Value, true) || Value != Parameter.ParameterValue)
+		{
+			return false;
+		}
+	}
+
+	for (const FVectorParameterValue& Parameter : A->VectorParameterValues)
+	{
+		FLinearColor Value;
+		if (!B->GetVectorParameterValue(Parameter.ParameterInfo, Value, true) || Value != Parameter.ParameterValue)
+		{
+			return false;
+		}
+	}
+
+	for (const FTextureParameterValue& Parameter : A->TextureParameterValues)
+	{
+		UTexture* Value;
+		if (!B->GetTextureParameterValue(Parameter.ParameterInfo, Value, true) || Value != Parameter.ParameterValue)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void UBrushDatabase::CreateSlateColor(FString Name)
 {
 	Colors.Add(Name, MakeShared<FLinearColor>());
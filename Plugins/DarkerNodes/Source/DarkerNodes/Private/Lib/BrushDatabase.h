@@ -31,6 +31,9 @@ public:
 	FSlateBrush* GetSlateBrush(FString Name);
 	void SetSlateBrushMaterial(FString Name, FString DynamicMaterialName);
 
+	// Brushes whose materials end up with the same parent and parameters are drawn with a single instance
+	void ShareDynamicMaterials();
+
 	void CreateSlateColor(FString Name);
 	void SetSlateColor(FString Name, FLinearColor Color);
 	FSlateColor* GetSlateColor(FString Name);
@@ -46,6 +49,18 @@ private:
 	UPROPERTY()
 	TMap<FString, UMaterialInstanceDynamic*> DynamicMaterials;
 
+	UPROPERTY()
+	TMap<FString, UMaterialInstanceDynamic*> CenteredImageMaterials;
+
+	UPROPERTY()
+	TMap<FString, UTexture2D*> Textures;
+
+	// Brushes created with their own dynamic material, the ones ShareDynamicMaterials can merge
+	TArray<FString> MaterialBrushes;
+
+	static uint32 HashParameters(const UMaterialInstanceDynamic* Material);
+	static bool HasSameParameters(const UMaterialInstanceDynamic* A, const UMaterialInstanceDynamic* B);
+
 	TMap<FString, FSlateBrush*> SlateBrushes;
 	TMap<FString, FSlateColor*> SlateColors;
 	TMap<FString, const TSharedRef<FLinearColor>> Colors;
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "Algo/BinarySearch.h"
+
 class FColorLib
 {
 public:
@@ -12,6 +14,41 @@ public:
 		return (N > 0.04045f ? FMath::Pow((N + 0.055f) / 1.055f, 2.4f) : N / 12.92f) * 100.0f;
 	}
 
+	// The sRGB transfer function only ever sees 8 bit channels, both directions are looked up instead of calling Pow
+	struct FSRGBTables
+	{
+		// linear value of every channel value, on the 0-100 scale of XYZ
+		float ToLinear[256];
+
+		// linear value from which a channel rounds up to the next channel value
+		float RoundUpThresholds[255];
+
+		FSRGBTables()
+		{
+			for (int32 Index = 0; Index < 256; Index++)
+			{
+				ToLinear[Index] = PivotRGBtoXYZ(Index / 255.0f);
+			}
+
+			for (int32 Index = 0; Index < 255; Index++)
+			{
+				RoundUpThresholds[Index] = PivotRGBtoXYZ((Index + 0.5f) / 255.0f);
+			}
+		}
+	};
+
+	static const FSRGBTables& GetSRGBTables()
+	{
+		static const FSRGBTables Tables;
+		return Tables;
+	}
+
+	// Same as rounding PivotXYZtoRGB to a channel and clamping it, N on the 0-100 scale
+	static uint8 LinearToChannel(float N)
+	{
+		return Algo::UpperBound(GetSRGBTables().RoundUpThresholds, N);
+	}
+
 	static FVector RGBtoXYZ(FColor Color)
 	{
 		const FMatrix Matrix(
@@ -22,9 +59,10 @@ public:
 
 		FVector OutColor;
 
-		OutColor.X = PivotRGBtoXYZ(Color.R / 255.0f);
-		OutColor.Y = PivotRGBtoXYZ(Color.G / 255.0f);
-		OutColor.Z = PivotRGBtoXYZ(Color.B / 255.0f);
+		const FSRGBTables& Tables = GetSRGBTables();
+		OutColor.X = Tables.ToLinear[Color.R];
+		OutColor.Y = Tables.ToLinear[Color.G];
+		OutColor.Z = Tables.ToLinear[Color.B];
 
 		OutColor = Matrix.TransformVector(OutColor);
 
@@ -52,15 +90,7 @@ public:
 		FVector OutColor(Color.X, Color.Y, Color.Z);
 		OutColor = Matrix.TransformVector(OutColor);
 
-		OutColor.X = FMath::RoundToInt(PivotXYZtoRGB(OutColor.X) * 255.0f);
-		OutColor.Y = FMath::RoundToInt(PivotXYZtoRGB(OutColor.Y) * 255.0f);
-		OutColor.Z = FMath::RoundToInt(PivotXYZtoRGB(OutColor.Z) * 255.0f);
-
-		OutColor.X = FMath::Clamp(OutColor.X, 0.0f, 255.0f);
-		OutColor.Y = FMath::Clamp(OutColor.Y, 0.0f, 255.0f);
-		OutColor.Z = FMath::Clamp(OutColor.Z, 0.0f, 255.0f);
-
-		return FColor(OutColor.X, OutColor.Y, OutColor.Z);
+		return FColor(LinearToChannel(OutColor.X), LinearToChannel(OutColor.Y), LinearToChannel(OutColor.Z));
 	}
 
 	static float MathXYZtoLAB(float T)
@@ -121,6 +151,16 @@ public:
 		return OutColor;
 	}
 
+	static FVector RGBtoLAB(FColor Color)
+	{
+		return XYZtoLAB(RGBtoXYZ(Color));
+	}
+
+	static FColor LABtoRGB(FVector Color)
+	{
+		return XYZtoRGB(LABtoXYZ(Color));
+	}
+
 	static FVector RGBtoHSL(FColor Color)
 	{
 		const FVector InColor = FVector(Color.R/255.0f, Color.G/255.0f, Color.B/255.0f);
@@ -5,12 +5,27 @@
 #include "ENConnectionDrawingPolicy.h"
 #include "BlueprintEditorSettings.h"
 #include "ENPathDrawer.h"
+#include "K2Node_Knot.h"
 #include "SGraphPanel.h"
 #include "Framework/Application/SlateApplication.h"
 #include "MaterialGraph/MaterialGraphSchema.h"
+#include "Materials/MaterialInterface.h"
 #include "Policies/ENAnimGraphConnectionDrawingPolicy.h"
 #include "Policies/ENBehaviorTreeConnectionDrawingPolicy.h"
 
+/* Compared as names, so the per wire checks never build strings */
+namespace ENPinNames
+{
+	const FName Exec("exec");
+	const FName KnotOutput("OutputPin");
+	const FName KnotInput("InputPin");
+
+	const FName Vector4("Vector4");
+	const FName Vector("Vector");
+	const FName IntVector("IntVector");
+	const FName Vector2D("Vector2D");
+	const FName IntPoint("IntPoint");
+}
 
 FConnectionDrawingPolicy* FENConnectionDrawingPolicyFactory::CreateConnectionPolicy(const class UEdGraphSchema* Schema, int32 InBackLayerID, int32 InFrontLayerID, float ZoomFactor, const class FSlateRect& InClippingRect, class FSlateWindowElementList& InDrawElements, class UEdGraph* InGraphObj) const
 {
@@ -91,13 +106,32 @@ FConnectionDrawingPolicy* FENConnectionDrawingPolicyFactory::CreateConnectionPol
 	return nullptr;
 }
 
+FENConnectionDrawingPolicy::~FENConnectionDrawingPolicy()
+{
+	/* Preview connectors are drawn without going through Draw */
+	ENFlushWires();
+}
+
+void FENConnectionDrawingPolicy::Draw(TMap<TSharedRef<SWidget>, FArrangedWidget>& InPinGeometries, FArrangedChildren& ArrangedNodes)
+{
+	FKismetConnectionDrawingPolicy::Draw(InPinGeometries, ArrangedNodes);
+	ENFlushWires();
+}
+
 void FENConnectionDrawingPolicy::DrawConnection(int32 LayerId, const FVector2D& Start, const FVector2D& End, const FConnectionParams& Params)
 {
+	const EWireStyle WireStyle = ENGetWireStyle(Params);
+	if (!ENIsWireVisible(Start, End, WireStyle, Params))
+	{
+		return;
+	}
+
 	const bool RightPriority = ENIsRightPriority(Params);
 
 	this->_LayerId = LayerId;
 	this->_Params = &Params;
 	ClosestDistanceSquared = MAX_FLT;
+	ENUpdateBubbleState();
 
 	FENPathDrawer PathDrawer(LayerId, ZoomFactor, RightPriority, &Params, &DrawElementsList, this);
 	FVector2D StartDirection = (Params.StartDirection == EGPD_Output) ? FVector2D(1.0f, 0.0f) : FVector2D(-1.0f, 0.0f);
@@ -129,20 +163,6 @@ void FENConnectionDrawingPolicy::DrawConnection(int32 LayerId, const FVector2D&
 	ENCorrectZoomDisplacement(NewStart, NewEnd);
 	ENProcessRibbon(_LayerId, NewStart, StartDirection, NewEnd, EndDirection, Params);
 
-	EWireStyle WireStyle = ElectronicNodesSettings.WireStyle;
-
-	if (ElectronicNodesSettings.OverwriteExecWireStyle)
-	{
-		if (((Params.AssociatedPin1 != nullptr) && Params.AssociatedPin1->PinType.PinCategory.ToString() == "exec") ||
-			((Params.AssociatedPin2 != nullptr) && Params.AssociatedPin2->PinType.PinCategory.ToString() == "exec"))
-		{
-			if (ElectronicNodesSettings.WireStyleForExec != EWireStyle::Default)
-			{
-				WireStyle = ElectronicNodesSettings.WireStyleForExec;
-			}
-		}
-	}
-
 	/*
 	const int8 MembersCount = this->ENGetPinMembersCount(Params.AssociatedPin1);
 
@@ -186,6 +206,56 @@ void FENConnectionDrawingPolicy::DrawConnection(int32 LayerId, const FVector2D&
 	}
 }
 
+bool FENConnectionDrawingPolicy::ENIsExecWire(const FConnectionParams& Params) const
+{
+	return ((Params.AssociatedPin1 != nullptr) && Params.AssociatedPin1->PinType.PinCategory == ENPinNames::Exec) ||
+		((Params.AssociatedPin2 != nullptr) && Params.AssociatedPin2->PinType.PinCategory == ENPinNames::Exec);
+}
+
+EWireStyle FENConnectionDrawingPolicy::ENGetWireStyle(const FConnectionParams& Params) const
+{
+	if (ElectronicNodesSettings.OverwriteExecWireStyle)
+	{
+		if (ENIsExecWire(Params))
+		{
+			if (ElectronicNodesSettings.WireStyleForExec != EWireStyle::Default)
+			{
+				return ElectronicNodesSettings.WireStyleForExec;
+			}
+		}
+	}
+
+	return ElectronicNodesSettings.WireStyle;
+}
+
+bool FENConnectionDrawingPolicy::ENIsWireVisible(const FVector2D& Start, const FVector2D& End, EWireStyle WireStyle, const FConnectionParams& Params) const
+{
+	/* Ribbons offset the wires drawn after this one, every wire has to be processed in order */
+	if (ElectronicNodesSettings.ActivateRibbon && !IsTree)
+	{
+		return true;
+	}
+
+	/* Routes never leave the start/end box by more than the pin offset plus a U-turn */
+	float Margin = (ElectronicNodesSettings.HorizontalOffset + 2.0f * ElectronicNodesSettings.RoundRadius + 8.0f) * ZoomFactor;
+	Margin += Params.WireThickness * ElectronicNodesSettings.WireThickness;
+	Margin += BubbleImage->ImageSize.GetMax() * ZoomFactor * 0.1f * ElectronicNodesSettings.BubbleSize * FMath::Sqrt(Params.WireThickness) * 1.25f;
+
+	/* Default splines have tangents as long as the wire, their curve stays within a third of it */
+	if (WireStyle == EWireStyle::Default || ElectronicNodesSettings.MinDistanceStyle == EMinDistanceStyle::Spline)
+	{
+		Margin += FVector2D::Distance(Start, End) / 3.0f;
+	}
+
+	const FSlateRect WireRect = FSlateRect(
+		FMath::Min(Start.X, End.X) - Margin,
+		FMath::Min(Start.Y, End.Y) - Margin,
+		FMath::Max(Start.X, End.X) + Margin,
+		FMath::Max(Start.Y, End.Y) + Margin);
+
+	return FSlateRect::DoRectanglesIntersect(WireRect, ClippingRect);
+}
+
 int8 FENConnectionDrawingPolicy::ENGetPinMembersCount(const UEdGraphPin* Pin)
 {
 	if (Pin == nullptr)
@@ -195,18 +265,18 @@ int8 FENConnectionDrawingPolicy::ENGetPinMembersCount(const UEdGraphPin* Pin)
 
 	if (Pin->PinType.PinSubCategoryObject.IsValid())
 	{
-		const auto TypeName = Pin->PinType.PinSubCategoryObject.Get()->GetName();
-		if (TypeName == "Vector4")
+		const FName TypeName = Pin->PinType.PinSubCategoryObject.Get()->GetFName();
+		if (TypeName == ENPinNames::Vector4)
 		{
 			return 4;
 		}
 
-		if (TypeName == "Vector" || TypeName == "IntVector")
+		if (TypeName == ENPinNames::Vector || TypeName == ENPinNames::IntVector)
 		{
 			return 3;
 		}
 
-		if (TypeName == "Vector2D" || TypeName == "IntPoint")
+		if (TypeName == ENPinNames::Vector2D || TypeName == ENPinNames::IntPoint)
 		{
 			return 2;
 		}
@@ -224,11 +294,11 @@ void FENConnectionDrawingPolicy::ENDrawMainWire(FENPathDrawer* PathDrawer, EWire
 
 	if (ElectronicNodesSettings.DisablePinOffset)
 	{
-		if (!((Params.AssociatedPin1 != nullptr) && (Params.AssociatedPin1->GetName() == "OutputPin")))
+		if (!((Params.AssociatedPin1 != nullptr) && (Params.AssociatedPin1->PinName == ENPinNames::KnotOutput)))
 		{
 			PathDrawer->DrawOffset(Start, StartDirection, Offset, false);
 		}
-		if (!((Params.AssociatedPin2 != nullptr) && (Params.AssociatedPin2->GetName() == "InputPin")))
+		if (!((Params.AssociatedPin2 != nullptr) && (Params.AssociatedPin2->PinName == ENPinNames::KnotInput)))
 		{
 			PathDrawer->DrawOffset(End, EndDirection, Offset, true);
 		}
@@ -239,17 +309,7 @@ void FENConnectionDrawingPolicy::ENDrawMainWire(FENPathDrawer* PathDrawer, EWire
 		PathDrawer->DrawOffset(End, EndDirection, Offset, true);
 	}
 
-	switch (WireStyle)
-	{
-	case EWireStyle::Manhattan:
-		PathDrawer->DrawManhattanWire(Start, StartDirection, End, EndDirection);
-		break;
-	case EWireStyle::Subway:
-		PathDrawer->DrawSubwayWire(Start, StartDirection, End, EndDirection);
-		break;
-	default:
-		PathDrawer->DrawDefaultWire(Start, StartDirection, End, EndDirection);
-	}
+	PathDrawer->DrawCachedWire(&FENPathCache::Get(GraphObj), WireStyle, Start, StartDirection, End, EndDirection);
 }
 
 void FENConnectionDrawingPolicy::ENCorrectZoomDisplacement(FVector2D& Start, FVector2D& End) const
@@ -385,8 +445,7 @@ bool FENConnectionDrawingPolicy::ENIsRightPriority(const FConnectionParams& Para
 
 	if (ElectronicNodesSettings.OverwriteExecWireStyle)
 	{
-		if (((Params.AssociatedPin1 != nullptr) && Params.AssociatedPin1->PinType.PinCategory.ToString() == "exec") ||
-			((Params.AssociatedPin2 != nullptr) && Params.AssociatedPin2->PinType.PinCategory.ToString() == "exec"))
+		if (ENIsExecWire(Params))
 		{
 			RightPriority = (ElectronicNodesSettings.WireAlignmentForExec == EWireAlignment::Right);
 			WirePriority = ElectronicNodesSettings.WirePriorityForExec;
@@ -397,8 +456,8 @@ bool FENConnectionDrawingPolicy::ENIsRightPriority(const FConnectionParams& Para
 	{
 		if ((Params.AssociatedPin1 != nullptr) && (Params.AssociatedPin2 != nullptr))
 		{
-			const bool IsOutputPin = (Params.AssociatedPin1->GetName() == "OutputPin");
-			const bool IsInputPin = (Params.AssociatedPin2->GetName() == "InputPin");
+			const bool IsOutputPin = (Params.AssociatedPin1->PinName == ENPinNames::KnotOutput);
+			const bool IsInputPin = (Params.AssociatedPin2->PinName == ENPinNames::KnotInput);
 			if (IsOutputPin ^ IsInputPin)
 			{
 				switch (WirePriority)
@@ -445,13 +504,121 @@ TSharedPtr<SGraphPanel> FENConnectionDrawingPolicy::GetGraphPanel()
 	return nullptr;
 }
 
-void FENConnectionDrawingPolicy::BuildRelatedNodes(UEdGraphNode* Node, TArray<UEdGraphNode*>& RelatedNodes, bool InputCheck = true, bool OutputCheck = true)
+const TMap<const UEdGraphNode*, TSet<const UEdGraphNode*>>* FENConnectionDrawingPolicy::ENGetSelectionRelatedNodes()
+{
+	if (!SelectionRelatedNodesResolved)
+	{
+		SelectionRelatedNodesResolved = true;
+
+		const TSharedPtr<SGraphPanel> GraphPanel = this->GetGraphPanel();
+		if (GraphPanel.IsValid())
+		{
+			FENRelatedNodesCache& Cache = FENRelatedNodesCache::Get(GraphPanel->GetGraphObj());
+			SelectionRelatedNodes = &Cache.GetRelatedNodes(GraphPanel->SelectionManager.SelectedNodes, ElectronicNodesSettings.SelectionRule);
+		}
+	}
+
+	return SelectionRelatedNodes;
+}
+
+FENRelatedNodesCache& FENRelatedNodesCache::Get(const UEdGraph* Graph)
+{
+	static TMap<TWeakObjectPtr<const UEdGraph>, FENRelatedNodesCache> GraphCaches;
+
+	if (!GraphCaches.Contains(Graph))
+	{
+		/* drop the caches of closed graphs */
+		for (auto It = GraphCaches.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	return GraphCaches.FindOrAdd(Graph);
+}
+
+const TMap<const UEdGraphNode*, TSet<const UEdGraphNode*>>& FENRelatedNodesCache::GetRelatedNodes(const TSet<UObject*>& SelectedNodes, ESelectionRule SelectionRule)
+{
+	if (IsUpToDate(SelectedNodes, SelectionRule))
+	{
+		return RelatedNodes;
+	}
+
+	RelatedNodes.Reset();
+	VisitedNodes.Reset();
+
+	for (UObject* SelectedNode : SelectedNodes)
+	{
+		if (UEdGraphNode* SelectedGraphNode = Cast<UEdGraphNode>(SelectedNode))
+		{
+			BuildRelatedNodes(SelectedGraphNode, RelatedNodes.Add(SelectedGraphNode), SelectionRule, true, true);
+		}
+	}
+
+	CachedSelection = SelectedNodes;
+	CachedSelectionRule = SelectionRule;
+	HashLinks(LinksHash);
+	Built = true;
+
+	return RelatedNodes;
+}
+
+bool FENRelatedNodesCache::IsUpToDate(const TSet<UObject*>& SelectedNodes, ESelectionRule SelectionRule) const
 {
-	if (RelatedNodes.Find(Node) != INDEX_NONE && (!InputCheck || !OutputCheck))
+	if (!Built || SelectionRule != CachedSelectionRule || SelectedNodes.Num() != CachedSelection.Num())
+	{
+		return false;
+	}
+
+	for (UObject* SelectedNode : SelectedNodes)
+	{
+		if (!CachedSelection.Contains(SelectedNode))
+		{
+			return false;
+		}
+	}
+
+	/* the related nodes only depend on the links of the visited nodes */
+	uint32 CurrentLinksHash;
+	return HashLinks(CurrentLinksHash) && CurrentLinksHash == LinksHash;
+}
+
+bool FENRelatedNodesCache::HashLinks(uint32& OutHash) const
+{
+	OutHash = 0;
+
+	for (const TWeakObjectPtr<UEdGraphNode>& VisitedNode : VisitedNodes)
+	{
+		const UEdGraphNode* Node = VisitedNode.Get();
+		if (Node == nullptr)
+		{
+			return false;
+		}
+
+		for (const UEdGraphPin* Pin : Node->Pins)
+		{
+			for (const UEdGraphPin* LinkedPin : Pin->LinkedTo)
+			{
+				OutHash = HashCombine(OutHash, GetTypeHash(LinkedPin));
+			}
+			OutHash = HashCombine(OutHash, GetTypeHash(Pin->LinkedTo.Num()));
+		}
+	}
+
+	return true;
+}
+
+void FENRelatedNodesCache::BuildRelatedNodes(UEdGraphNode* Node, TSet<const UEdGraphNode*>& OutRelatedNodes, ESelectionRule SelectionRule, bool InputCheck, bool OutputCheck)
+{
+	if (OutRelatedNodes.Contains(Node) && (!InputCheck || !OutputCheck))
 	{
 		return;
 	}
-	RelatedNodes.Push(Node);
+	OutRelatedNodes.Add(Node);
+	VisitedNodes.Add(Node);
 
 	for (auto Pin : Node->Pins)
 	{
@@ -460,13 +627,13 @@ void FENConnectionDrawingPolicy::BuildRelatedNodes(UEdGraphNode* Node, TArray<UE
 			for (auto LinkedPin : Pin->LinkedTo)
 			{
 				UEdGraphNode* LinkedNode = LinkedPin->GetOwningNode();
-				if (ElectronicNodesSettings.SelectionRule == ESelectionRule::Far || LinkedNode->GetName().StartsWith("K2Node_Knot_"))
+				if (SelectionRule == ESelectionRule::Far || LinkedNode->IsA<UK2Node_Knot>())
 				{
-					BuildRelatedNodes(LinkedNode, RelatedNodes, true, false);
+					BuildRelatedNodes(LinkedNode, OutRelatedNodes, SelectionRule, true, false);
 				}
 				else
 				{
-					RelatedNodes.Push(LinkedNode);
+					OutRelatedNodes.Add(LinkedNode);
 				}
 			}
 		}
@@ -476,108 +643,155 @@ void FENConnectionDrawingPolicy::BuildRelatedNodes(UEdGraphNode* Node, TArray<UE
 			for (auto LinkedPin : Pin->LinkedTo)
 			{
 				UEdGraphNode* LinkedNode = LinkedPin->GetOwningNode();
-				if (ElectronicNodesSettings.SelectionRule == ESelectionRule::Far || LinkedNode->GetName().StartsWith("K2Node_Knot_"))
+				if (SelectionRule == ESelectionRule::Far || LinkedNode->IsA<UK2Node_Knot>())
 				{
-					BuildRelatedNodes(LinkedNode, RelatedNodes, false, true);
+					BuildRelatedNodes(LinkedNode, OutRelatedNodes, SelectionRule, false, true);
 				}
 				else
 				{
-					RelatedNodes.Push(LinkedNode);
+					OutRelatedNodes.Add(LinkedNode);
 				}
 			}
 		}
 	}
 }
 
-void FENConnectionDrawingPolicy::ENDrawBubbles(const FVector2D& Start, const FVector2D& StartTangent, const FVector2D& End, const FVector2D& EndTangent)
+void FENConnectionDrawingPolicy::ENUpdateBubbleState()
 {
+	_DrawBubbles = false;
+	_BubbleSpeed = ElectronicNodesSettings.BubbleSpeed;
+
 	const bool ENDrawBubbles = ElectronicNodesSettings.ForceDrawBubbles && (ElectronicNodesSettings.BubbleZoomThreshold <= ENGetZoomLevel());
-	if (_Params->bDrawBubbles || ENDrawBubbles)
+	if (!_Params->bDrawBubbles && !ENDrawBubbles)
 	{
-		bool LinkedBubbles = true;
+		return;
+	}
 
-		if (!_Params->bDrawBubbles)
-		{
-			LinkedBubbles = false;
+	bool LinkedBubbles = true;
 
-			if (ElectronicNodesSettings.BubbleDisplayRule == EBubbleDisplayRule::DisplayOnSelection ||
-				ElectronicNodesSettings.BubbleDisplayRule == EBubbleDisplayRule::MoveOnSelection)
+	if (!_Params->bDrawBubbles)
+	{
+		LinkedBubbles = false;
+
+		if (ElectronicNodesSettings.BubbleDisplayRule == EBubbleDisplayRule::DisplayOnSelection ||
+			ElectronicNodesSettings.BubbleDisplayRule == EBubbleDisplayRule::MoveOnSelection)
+		{
+			const TMap<const UEdGraphNode*, TSet<const UEdGraphNode*>>* RelatedNodes = this->ENGetSelectionRelatedNodes();
+			if (RelatedNodes != nullptr && _Params->AssociatedPin1 != nullptr && _Params->AssociatedPin2 != nullptr)
 			{
-				TSharedPtr<SGraphPanel> GraphPanel = this->GetGraphPanel();
-				if (GraphPanel.IsValid())
+				const UEdGraphNode* Node1 = _Params->AssociatedPin1->GetOwningNode();
+				const UEdGraphNode* Node2 = _Params->AssociatedPin2->GetOwningNode();
+				for (const auto& SelectedRelatedNodes : *RelatedNodes)
 				{
-					if (_Params->AssociatedPin1 != nullptr && _Params->AssociatedPin2 != nullptr)
+					if (SelectedRelatedNodes.Value.Contains(Node1) && SelectedRelatedNodes.Value.Contains(Node2))
 					{
-						for (auto SelectedNode : GraphPanel->SelectionManager.SelectedNodes)
-						{
-							TArray<UEdGraphNode*> RelatedNodes;
-							UEdGraphNode* SelectedGraphNode = StaticCast<UEdGraphNode*>(SelectedNode);
-							this->BuildRelatedNodes(SelectedGraphNode, RelatedNodes);
-
-							if (RelatedNodes.Find(_Params->AssociatedPin1->GetOwningNode()) != INDEX_NONE && RelatedNodes.Find(_Params->AssociatedPin2->GetOwningNode()) != INDEX_NONE)
-							{
-								LinkedBubbles = true;
-							}
-						}
+						LinkedBubbles = true;
+						break;
 					}
 				}
 			}
 		}
+	}
 
-		if (!LinkedBubbles && ElectronicNodesSettings.BubbleDisplayRule == EBubbleDisplayRule::DisplayOnSelection)
-		{
-			return;
-		}
+	if (!LinkedBubbles && ElectronicNodesSettings.BubbleDisplayRule == EBubbleDisplayRule::DisplayOnSelection)
+	{
+		return;
+	}
+
+	if (!LinkedBubbles && ElectronicNodesSettings.BubbleDisplayRule == EBubbleDisplayRule::MoveOnSelection)
+	{
+		_BubbleSpeed = 0.0f;
+	}
+
+	_DrawBubbles = true;
+}
+
+FVector2D FENConnectionDrawingPolicy::ENGetBubbleSize() const
+{
+	FVector2D BubbleSize = BubbleImage->ImageSize * ZoomFactor * 0.1f * ElectronicNodesSettings.BubbleSize * FMath::Sqrt(_Params->WireThickness);
+	if (_Params->bDrawBubbles)
+	{
+		BubbleSize *= 1.25f;
+	}
+	return BubbleSize;
+}
+
+const FSlateBrush* FENConnectionDrawingPolicy::ENGetBubbleMaterialBrush()
+{
+	static FSlateBrush Brush;
+	static FSoftObjectPath LoadedPath;
 
-		FInterpCurve<float> SplineReparamTable;
-		const float SplineLength = (Start - End).Size();
-		int32 NumBubbles = FMath::CeilToInt(SplineLength / (ElectronicNodesSettings.BubbleSpace * ZoomFactor));
-		NumBubbles = FMath::Min(NumBubbles, 1000);
+	const UElectronicNodesSettings& ElectronicNodesSettings = *GetDefault<UElectronicNodesSettings>();
+	const FSoftObjectPath MaterialPath = ElectronicNodesSettings.BubbleMaterial.ToSoftObjectPath();
 
-		float BubbleSpeed = ElectronicNodesSettings.BubbleSpeed;
-		if (!LinkedBubbles && ElectronicNodesSettings.BubbleDisplayRule == EBubbleDisplayRule::MoveOnSelection)
+	if (MaterialPath != LoadedPath)
+	{
+		/* the brush does not reference its material for the garbage collector */
+		if (UObject* PreviousMaterial = Brush.GetResourceObject())
 		{
-			BubbleSpeed = 0.0f;
+			PreviousMaterial->RemoveFromRoot();
 		}
-		FVector2D BubbleSize = BubbleImage->ImageSize * ZoomFactor * 0.1f * ElectronicNodesSettings.BubbleSize * FMath::Sqrt(_Params->WireThickness);
-		if (_Params->bDrawBubbles)
+		Brush.SetResourceObject(nullptr);
+		LoadedPath = MaterialPath;
+
+		if (UMaterialInterface* Material = ElectronicNodesSettings.BubbleMaterial.LoadSynchronous())
 		{
-			BubbleSize *= 1.25f;
+			Material->AddToRoot();
+			Brush.SetResourceObject(Material);
 		}
-		const float Time = (FPlatformTime::Seconds() - GStartTime);
+	}
+
+	return Brush.GetResourceObject() != nullptr ? &Brush : nullptr;
+}
+
+void FENConnectionDrawingPolicy::ENDrawBubbles(const FVector2D& Start, const FVector2D& StartTangent, const FVector2D& End, const FVector2D& EndTangent)
+{
+	/* the bubble material animates them on the wire itself */
+	if (!_DrawBubbles || AnimatedWireBatcher.IsValid())
+	{
+		return;
+	}
+
+	const float SplineLength = (Start - End).Size();
+	int32 NumBubbles = FMath::CeilToInt(SplineLength / (ElectronicNodesSettings.BubbleSpace * ZoomFactor));
+	NumBubbles = FMath::Min(NumBubbles, 1000);
 
-		const float AlphaOffset = FMath::Frac(Time * BubbleSpeed);
+	const FVector2D BubbleSize = ENGetBubbleSize();
+	const float Time = (FPlatformTime::Seconds() - GStartTime);
 
-		for (int32 i = 0; i < NumBubbles; ++i)
+	const float AlphaOffset = FMath::Frac(Time * _BubbleSpeed);
+
+	ENFlushWires();
+
+	for (int32 i = 0; i < NumBubbles; ++i)
+	{
+		const float Alpha = (AlphaOffset + i) / NumBubbles;
+		FVector2D BubblePos;
+		if (StartTangent != FVector2D::ZeroVector && EndTangent != FVector2D::ZeroVector)
 		{
-			const float Alpha = (AlphaOffset + i) / NumBubbles;
-			FVector2D BubblePos;
-			if (StartTangent != FVector2D::ZeroVector && EndTangent != FVector2D::ZeroVector)
+			if ((StartTangent != EndTangent) && ((StartTangent * EndTangent) == FVector2D::ZeroVector))
 			{
-				if ((StartTangent != EndTangent) && ((StartTangent * EndTangent) == FVector2D::ZeroVector))
-				{
-					BubblePos = Start + StartTangent * FMath::Sin(Alpha * PI / 2.0f) + EndTangent * (1.0f - FMath::Cos(Alpha * PI / 2.0f));
-				}
-				else
-				{
-					BubblePos = FMath::CubicInterp(Start, StartTangent, End, EndTangent, Alpha);
-				}
+				BubblePos = Start + StartTangent * FMath::Sin(Alpha * PI / 2.0f) + EndTangent * (1.0f - FMath::Cos(Alpha * PI / 2.0f));
 			}
 			else
 			{
-				BubblePos = FMath::Lerp(Start, End, Alpha);
+				BubblePos = FMath::CubicInterp(Start, StartTangent, End, EndTangent, Alpha);
 			}
-			BubblePos -= (BubbleSize * 0.5f);
-
-			FSlateDrawElement::MakeBox(
-				DrawElementsList,
-				_LayerId,
-				FPaintGeometry(BubblePos, BubbleSize, ZoomFactor),
-				BubbleImage,
-				ESlateDrawEffect::None,
-				_Params->WireColor
-			);
 		}
+		else
+		{
+			BubblePos = FMath::Lerp(Start, End, Alpha);
+		}
+		BubblePos -= (BubbleSize * 0.5f);
+
+		FSlateDrawElement::MakeBox(
+			DrawElementsList,
+			_LayerId,
+			FPaintGeometry(BubblePos, BubbleSize, ZoomFactor),
+			BubbleImage,
+			ESlateDrawEffect::None,
+			_Params->WireColor
+		);
 	}
 }
 
@@ -589,16 +803,42 @@ void FENConnectionDrawingPolicy::ENDrawArrow(const FVector2D& Start, const FVect
 		const FVector2D SlopeUnnormalized = (End - Start);
 		const float AngleInRadians = FMath::Atan2(SlopeUnnormalized.Y, SlopeUnnormalized.X);
 
+		ENFlushWires();
+
 		FSlateDrawElement::MakeRotatedBox(DrawElementsList, _LayerId, FPaintGeometry(MidpointDrawPos, MidpointImage->ImageSize * ZoomFactor * 0.75f, ZoomFactor * 0.75f),
 		                                  MidpointImage, ESlateDrawEffect::None, AngleInRadians, TOptional<FVector2D>(), FSlateDrawElement::RelativeToElement, _Params->WireColor);
 	}
 }
 
+void FENConnectionDrawingPolicy::ENDrawWireSpline(int32 LayerId, const FVector2D& Start, const FVector2D& StartTangent, const FVector2D& End, const FVector2D& EndTangent, float Thickness, const FLinearColor& Color)
+{
+	if (_DrawBubbles && AnimatedWireBatcher.IsValid())
+	{
+		const FENWireAnimation Animation = {ElectronicNodesSettings.BubbleSpace * ZoomFactor, _BubbleSpeed, ENGetBubbleSize().GetMax()};
+		AnimatedWireBatcher->AddSpline(LayerId, Start, StartTangent, End, EndTangent, Thickness, Color, &Animation);
+		return;
+	}
+
+	WireBatcher.AddSpline(LayerId, Start, StartTangent, End, EndTangent, Thickness, Color);
+}
+
+void FENConnectionDrawingPolicy::ENFlushWires()
+{
+	WireBatcher.Flush();
+
+	if (AnimatedWireBatcher.IsValid())
+	{
+		AnimatedWireBatcher->Flush();
+	}
+}
+
 void FENConnectionDrawingPolicy::DrawDebugPoint(const FVector2D& Position, FLinearColor Color)
 {
 	const FVector2D BubbleSize = BubbleImage->ImageSize * ZoomFactor * 0.1f * ElectronicNodesSettings.BubbleSize * FMath::Sqrt(_Params->WireThickness);
 	const FVector2D BubblePos = Position - (BubbleSize * 0.5f);
 
+	ENFlushWires();
+
 	FSlateDrawElement::MakeBox(
 		DrawElementsList,
 		_LayerId,
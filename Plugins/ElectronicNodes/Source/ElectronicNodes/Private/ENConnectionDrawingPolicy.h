@@ -8,6 +8,7 @@
 #include "EdGraphUtilities.h"
 #include "ConnectionDrawingPolicy.h"
 #include "../Public/ElectronicNodesSettings.h"
+#include "ENWireBatcher.h"
 
 #include "BlueprintConnectionDrawingPolicy.h"
 
@@ -33,6 +34,27 @@ struct ENRibbonConnection
 	}
 };
 
+/* Nodes related to each selected node, kept between paints until the selection or the links of the visited nodes change */
+class FENRelatedNodesCache
+{
+public:
+	static FENRelatedNodesCache& Get(const UEdGraph* Graph);
+
+	const TMap<const UEdGraphNode*, TSet<const UEdGraphNode*>>& GetRelatedNodes(const TSet<UObject*>& SelectedNodes, ESelectionRule SelectionRule);
+
+private:
+	TMap<const UEdGraphNode*, TSet<const UEdGraphNode*>> RelatedNodes;
+	TArray<TWeakObjectPtr<UEdGraphNode>> VisitedNodes;
+	TSet<UObject*> CachedSelection;
+	ESelectionRule CachedSelectionRule = ESelectionRule::Near;
+	uint32 LinksHash = 0;
+	bool Built = false;
+
+	bool IsUpToDate(const TSet<UObject*>& SelectedNodes, ESelectionRule SelectionRule) const;
+	bool HashLinks(uint32& OutHash) const;
+	void BuildRelatedNodes(UEdGraphNode* Node, TSet<const UEdGraphNode*>& OutRelatedNodes, ESelectionRule SelectionRule, bool InputCheck, bool OutputCheck);
+};
+
 struct FENConnectionDrawingPolicyFactory : public FGraphPanelPinConnectionFactory
 {
 	virtual ~FENConnectionDrawingPolicyFactory()
@@ -46,16 +68,25 @@ class FENConnectionDrawingPolicy : public FKismetConnectionDrawingPolicy
 {
 public:
 	FENConnectionDrawingPolicy(int32 InBackLayerID, int32 InFrontLayerID, float ZoomFactor, const FSlateRect& InClippingRect, FSlateWindowElementList& InDrawElements, UEdGraph* InGraphObj, bool IsTree = false)
-		: FKismetConnectionDrawingPolicy(InBackLayerID, InFrontLayerID, ZoomFactor, InClippingRect, InDrawElements, InGraphObj), IsTree(IsTree)
+		: FKismetConnectionDrawingPolicy(InBackLayerID, InFrontLayerID, ZoomFactor, InClippingRect, InDrawElements, InGraphObj), IsTree(IsTree), WireBatcher(InDrawElements)
 	{
+		if (const FSlateBrush* BubbleMaterialBrush = ENGetBubbleMaterialBrush())
+		{
+			this->AnimatedWireBatcher = MakeUnique<FENWireBatcher>(InDrawElements, BubbleMaterialBrush);
+		}
 	}
 
+	virtual ~FENConnectionDrawingPolicy() override;
+
+	virtual void Draw(TMap<TSharedRef<SWidget>, FArrangedWidget>& InPinGeometries, FArrangedChildren& ArrangedNodes) override;
 	virtual void DrawConnection(int32 LayerId, const FVector2D& Start, const FVector2D& End, const FConnectionParams& Params) override;
 
 	void ENComputeClosestPoint(const FVector2D& Start, const FVector2D& End);
 	void ENComputeClosestPointDefault(const FVector2D& Start, const FVector2D& StartTangent, const FVector2D& End, const FVector2D& EndTangent);
 	void ENDrawBubbles(const FVector2D& Start, const FVector2D& StartTangent, const FVector2D& End, const FVector2D& EndTangent);
 	void ENDrawArrow(const FVector2D& Start, const FVector2D& End);
+	void ENDrawWireSpline(int32 LayerId, const FVector2D& Start, const FVector2D& StartTangent, const FVector2D& End, const FVector2D& EndTangent, float Thickness, const FLinearColor& Color);
+	void ENFlushWires();
 
 	void DrawDebugPoint(const FVector2D& Position, FLinearColor Color);
 
@@ -67,10 +98,20 @@ private:
 	FVector2D ClosestPoint;
 	TArray<ENRibbonConnection> RibbonConnections;
 	TMap<FVector2D, int> PinsOffset;
+	const TMap<const UEdGraphNode*, TSet<const UEdGraphNode*>>* SelectionRelatedNodes = nullptr;
+	bool SelectionRelatedNodesResolved = false;
 
 	bool IsTree = false;
+	FENWireBatcher WireBatcher;
+	TUniquePtr<FENWireBatcher> AnimatedWireBatcher;
 
+	bool ENIsExecWire(const FConnectionParams& Params) const;
+	EWireStyle ENGetWireStyle(const FConnectionParams& Params) const;
+	bool ENIsWireVisible(const FVector2D& Start, const FVector2D& End, EWireStyle WireStyle, const FConnectionParams& Params) const;
 	void ENCorrectZoomDisplacement(FVector2D& Start, FVector2D& End) const;
+	void ENUpdateBubbleState();
+	FVector2D ENGetBubbleSize() const;
+	static const FSlateBrush* ENGetBubbleMaterialBrush();
 	void ENProcessRibbon(int32 LayerId, FVector2D& Start, FVector2D& StartDirection, FVector2D& End, FVector2D& EndDirection, const FConnectionParams& Params);
 	bool ENIsRightPriority(const FConnectionParams& Params);
 	int32 ENGetZoomLevel();
@@ -78,8 +119,10 @@ private:
 	void ENDrawMainWire(FENPathDrawer* PathDrawer, EWireStyle WireStyle, FVector2D& Start, FVector2D& StartDirection, FVector2D& End, FVector2D& EndDirection, const FConnectionParams& Params);
 
 	TSharedPtr<SGraphPanel> GetGraphPanel();
-	void BuildRelatedNodes(UEdGraphNode* Node, TArray<UEdGraphNode*>& RelatedNodes, bool InputCheck, bool OutputCheck);
+	const TMap<const UEdGraphNode*, TSet<const UEdGraphNode*>>* ENGetSelectionRelatedNodes();
 
 	int32 _LayerId;
 	const FConnectionParams* _Params;
+	bool _DrawBubbles = false;
+	float _BubbleSpeed = 0.0f;
 };
@@ -4,17 +4,152 @@
 
 #include "ENPathDrawer.h"
 
+FENPathCacheKey::FENPathCacheKey(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection, EWireStyle WireStyle, bool RightPriority, float ZoomFactor, uint32 RoundRadius)
+{
+	/* an eighth of a pixel is below what can be seen, and keeps the key stable when panning moves both ends */
+	const FVector2D Offset = (End - Start) * 8.0f;
+	this->Delta = FIntPoint(FMath::RoundToInt(Offset.X), FMath::RoundToInt(Offset.Y));
+	this->StartDirection = FIntPoint(FMath::RoundToInt(StartDirection.X * 100.0f), FMath::RoundToInt(StartDirection.Y * 100.0f));
+	this->EndDirection = FIntPoint(FMath::RoundToInt(EndDirection.X * 100.0f), FMath::RoundToInt(EndDirection.Y * 100.0f));
+	this->WireStyle = WireStyle;
+	this->RightPriority = RightPriority;
+	this->ZoomFactor = ZoomFactor;
+	this->RoundRadius = RoundRadius;
+}
+
+bool FENPathCacheKey::operator==(const FENPathCacheKey& Other) const
+{
+	return Delta == Other.Delta &&
+		StartDirection == Other.StartDirection &&
+		EndDirection == Other.EndDirection &&
+		WireStyle == Other.WireStyle &&
+		RightPriority == Other.RightPriority &&
+		ZoomFactor == Other.ZoomFactor &&
+		RoundRadius == Other.RoundRadius;
+}
+
+uint32 GetTypeHash(const FENPathCacheKey& Key)
+{
+	uint32 Hash = HashCombine(GetTypeHash(Key.Delta), GetTypeHash(Key.StartDirection));
+	Hash = HashCombine(Hash, GetTypeHash(Key.EndDirection));
+	Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(Key.WireStyle)));
+	Hash = HashCombine(Hash, GetTypeHash(Key.RightPriority));
+	Hash = HashCombine(Hash, GetTypeHash(Key.ZoomFactor));
+	return HashCombine(Hash, GetTypeHash(Key.RoundRadius));
+}
+
+FENPathCache& FENPathCache::Get(const UEdGraph* Graph)
+{
+	static TMap<TWeakObjectPtr<const UEdGraph>, FENPathCache> GraphCaches;
+
+	if (!GraphCaches.Contains(Graph))
+	{
+		/* drop the caches of closed graphs */
+		for (auto It = GraphCaches.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	return GraphCaches.FindOrAdd(Graph);
+}
+
+const TArray<FENPathSegment>* FENPathCache::Find(const FENPathCacheKey& Key)
+{
+	Prune();
+
+	if (FEntry* Entry = Entries.Find(Key))
+	{
+		Entry->LastUsedFrame = GFrameCounter;
+		return &Entry->Segments;
+	}
+
+	return nullptr;
+}
+
+void FENPathCache::Add(const FENPathCacheKey& Key, TArray<FENPathSegment>&& Segments)
+{
+	FEntry& Entry = Entries.Add(Key);
+	Entry.Segments = MoveTemp(Segments);
+	Entry.LastUsedFrame = GFrameCounter;
+}
+
+void FENPathCache::Prune()
+{
+	if (GFrameCounter - LastPruneFrame < PruneFrames)
+	{
+		return;
+	}
+
+	LastPruneFrame = GFrameCounter;
+
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (GFrameCounter - It.Value().LastUsedFrame >= PruneFrames)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 FENPathDrawer::FENPathDrawer(int32& LayerId, float& ZoomFactor, bool RightPriority, const FConnectionParams* Params, FSlateWindowElementList* DrawElementsList, FENConnectionDrawingPolicy* ConnectionDrawingPolicy)
 {
 	this->LayerId = LayerId;
 	this->ZoomFactor = ZoomFactor;
 	this->RightPriority = RightPriority;
 	this->Params = Params;
-	WireColor = Params->WireColor;
 	this->DrawElementsList = DrawElementsList;
 	this->ConnectionDrawingPolicy = ConnectionDrawingPolicy;
 }
 
+void FENPathDrawer::DrawCachedWire(FENPathCache* PathCache, EWireStyle WireStyle, const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection)
+{
+	const FENPathCacheKey Key(Start, StartDirection, End, EndDirection, WireStyle, RightPriority, ZoomFactor, ElectronicNodesSettings.RoundRadius);
+
+	if (PathCache != nullptr)
+	{
+		if (const TArray<FENPathSegment>* Segments = PathCache->Find(Key))
+		{
+			for (const FENPathSegment& Segment : *Segments)
+			{
+				PaintSegment(Segment, Start);
+			}
+			return;
+		}
+	}
+
+	TArray<FENPathSegment> Segments;
+	RecordedSegments = &Segments;
+	RecordOrigin = Start;
+
+	switch (WireStyle)
+	{
+	case EWireStyle::Manhattan:
+		DrawManhattanWire(Start, StartDirection, End, EndDirection);
+		break;
+	case EWireStyle::Subway:
+		DrawSubwayWire(Start, StartDirection, End, EndDirection);
+		break;
+	default:
+		DrawDefaultWire(Start, StartDirection, End, EndDirection);
+	}
+
+	RecordedSegments = nullptr;
+
+	for (const FENPathSegment& Segment : Segments)
+	{
+		PaintSegment(Segment, Start);
+	}
+
+	if (PathCache != nullptr)
+	{
+		PathCache->Add(Key, MoveTemp(Segments));
+	}
+}
+
 void FENPathDrawer::DrawManhattanWire(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection)
 {
 	if (!MaxDepthWire--)
@@ -251,15 +386,7 @@ void FENPathDrawer::DrawSubwayWire(const FVector2D& Start, const FVector2D& Star
 
 void FENPathDrawer::DrawDefaultWire(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection)
 {
-	const float Tangent = (End - Start).Size();
-
-	FSlateDrawElement::MakeDrawSpaceSpline(*DrawElementsList, LayerId,
-	                                       Start, StartDirection * Tangent, End, EndDirection * Tangent,
-	                                       Params->WireThickness * ElectronicNodesSettings.WireThickness, ESlateDrawEffect::None, WireColor);
-
-	ConnectionDrawingPolicy->ENComputeClosestPointDefault(Start, StartDirection, End, EndDirection);
-
-	ConnectionDrawingPolicy->ENDrawBubbles(Start, StartDirection * Tangent, End, EndDirection * Tangent);
+	AddSegment(EENPathSegmentType::Default, Start, StartDirection, End, EndDirection);
 }
 
 void FENPathDrawer::DrawIntersectionRadius(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection)
@@ -504,46 +631,91 @@ void FENPathDrawer::DrawLine(const FVector2D& Start, const FVector2D& End)
 		return;
 	}
 
-	FSlateDrawElement::MakeDrawSpaceSpline(*DrawElementsList, LayerId,
-	                                       Start, FVector2D::ZeroVector, End, FVector2D::ZeroVector,
-	                                       Params->WireThickness * ElectronicNodesSettings.WireThickness, ESlateDrawEffect::None, WireColor);
-
-	ConnectionDrawingPolicy->ENComputeClosestPoint(Start, End);
-	ConnectionDrawingPolicy->ENDrawBubbles(Start, FVector2D::ZeroVector, End, FVector2D::ZeroVector);
-	if (FVector2D::DistSquared(Start, End) > 50.0f)
-	{
-		ConnectionDrawingPolicy->ENDrawArrow(Start, End);
-	}
+	AddSegment(EENPathSegmentType::Line, Start, FVector2D::ZeroVector, End, FVector2D::ZeroVector);
 }
 
 void FENPathDrawer::DrawRadius(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection, const int32& AngleDeg)
 {
-	const float Tangent = GetRadiusTangent(AngleDeg);
-	const float Offset = GetRadiusOffset(AngleDeg);
-
-	FSlateDrawElement::MakeDrawSpaceSpline(*DrawElementsList, LayerId,
-	                                       Start, StartDirection * Tangent, End, EndDirection * Tangent,
-	                                       Params->WireThickness * ElectronicNodesSettings.WireThickness, ESlateDrawEffect::None, WireColor);
-
-	ConnectionDrawingPolicy->ENDrawBubbles(Start, StartDirection * Offset, End, EndDirection * Offset);
+	AddSegment(EENPathSegmentType::Radius, Start, StartDirection, End, EndDirection, AngleDeg);
 }
 
 void FENPathDrawer::DrawSpline(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection)
 {
-	const float Tangent = GetRadiusTangent();
+	AddSegment(EENPathSegmentType::Spline, Start, StartDirection, End, EndDirection);
+}
 
-	FSlateDrawElement::MakeDrawSpaceSpline(*DrawElementsList, LayerId,
-	                                       Start, StartDirection * Tangent, End, EndDirection * Tangent,
-	                                       Params->WireThickness * ElectronicNodesSettings.WireThickness, ESlateDrawEffect::None, WireColor);
+void FENPathDrawer::DebugColor(const FLinearColor& Color)
+{
+	/* kept even when debug is off, so a cached route shows the right colors once it is turned on */
+	CurrentDebugColor = Color;
+}
 
-	ConnectionDrawingPolicy->ENComputeClosestPointDefault(Start, StartDirection * Tangent, End, EndDirection * Tangent);
-	ConnectionDrawingPolicy->ENDrawBubbles(Start, StartDirection * Tangent, End, EndDirection * Tangent);
+void FENPathDrawer::AddSegment(EENPathSegmentType Type, const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection, int32 AngleDeg)
+{
+	if (RecordedSegments != nullptr)
+	{
+		RecordedSegments->Add({Type, Start - RecordOrigin, StartDirection, End - RecordOrigin, EndDirection, AngleDeg, CurrentDebugColor});
+	}
+	else
+	{
+		PaintSegment({Type, Start, StartDirection, End, EndDirection, AngleDeg, CurrentDebugColor}, FVector2D::ZeroVector);
+	}
 }
 
-void FENPathDrawer::DebugColor(const FLinearColor& Color)
+void FENPathDrawer::PaintSegment(const FENPathSegment& Segment, const FVector2D& Origin)
 {
-	if (ElectronicNodesSettings.Debug)
+	const FVector2D Start = Segment.Start + Origin;
+	const FVector2D End = Segment.End + Origin;
+	const FVector2D& StartDirection = Segment.StartDirection;
+	const FVector2D& EndDirection = Segment.EndDirection;
+
+	const FLinearColor WireColor = (ElectronicNodesSettings.Debug && Segment.DebugColor.IsSet()) ? Segment.DebugColor.GetValue() : Params->WireColor;
+	const float WireThickness = Params->WireThickness * ElectronicNodesSettings.WireThickness;
+
+	switch (Segment.Type)
 	{
-		WireColor = Color;
+	case EENPathSegmentType::Line:
+		{
+			ConnectionDrawingPolicy->ENDrawWireSpline(LayerId, Start, FVector2D::ZeroVector, End, FVector2D::ZeroVector, WireThickness, WireColor);
+
+			ConnectionDrawingPolicy->ENComputeClosestPoint(Start, End);
+			ConnectionDrawingPolicy->ENDrawBubbles(Start, FVector2D::ZeroVector, End, FVector2D::ZeroVector);
+			if (FVector2D::DistSquared(Start, End) > 50.0f)
+			{
+				ConnectionDrawingPolicy->ENDrawArrow(Start, End);
+			}
+			break;
+		}
+	case EENPathSegmentType::Radius:
+		{
+			const float Tangent = GetRadiusTangent(Segment.AngleDeg);
+			const float Offset = GetRadiusOffset(Segment.AngleDeg);
+
+			ConnectionDrawingPolicy->ENDrawWireSpline(LayerId, Start, StartDirection * Tangent, End, EndDirection * Tangent, WireThickness, WireColor);
+
+			ConnectionDrawingPolicy->ENDrawBubbles(Start, StartDirection * Offset, End, EndDirection * Offset);
+			break;
+		}
+	case EENPathSegmentType::Spline:
+		{
+			const float Tangent = GetRadiusTangent();
+
+			ConnectionDrawingPolicy->ENDrawWireSpline(LayerId, Start, StartDirection * Tangent, End, EndDirection * Tangent, WireThickness, WireColor);
+
+			ConnectionDrawingPolicy->ENComputeClosestPointDefault(Start, StartDirection * Tangent, End, EndDirection * Tangent);
+			ConnectionDrawingPolicy->ENDrawBubbles(Start, StartDirection * Tangent, End, EndDirection * Tangent);
+			break;
+		}
+	case EENPathSegmentType::Default:
+		{
+			const float Tangent = (End - Start).Size();
+
+			ConnectionDrawingPolicy->ENDrawWireSpline(LayerId, Start, StartDirection * Tangent, End, EndDirection * Tangent, WireThickness, WireColor);
+
+			ConnectionDrawingPolicy->ENComputeClosestPointDefault(Start, StartDirection, End, EndDirection);
+
+			ConnectionDrawingPolicy->ENDrawBubbles(Start, StartDirection * Tangent, End, EndDirection * Tangent);
+			break;
+		}
 	}
 }
@@ -9,11 +9,76 @@
 #include "ENConnectionDrawingPolicy.h"
 #include "../Public/ElectronicNodesSettings.h"
 
+enum class EENPathSegmentType : uint8
+{
+	Line,
+	Radius,
+	Spline,
+	Default
+};
+
+/* One drawn piece of a wire, positions are relative to the wire start when cached */
+struct FENPathSegment
+{
+	EENPathSegmentType Type;
+	FVector2D Start;
+	FVector2D StartDirection;
+	FVector2D End;
+	FVector2D EndDirection;
+	int32 AngleDeg = 0;
+	TOptional<FLinearColor> DebugColor;
+};
+
+/* A route only depends on where the end is relative to the start, so panning reuses it */
+struct FENPathCacheKey
+{
+	FIntPoint Delta;
+	FIntPoint StartDirection;
+	FIntPoint EndDirection;
+	EWireStyle WireStyle;
+	bool RightPriority;
+	float ZoomFactor;
+	uint32 RoundRadius;
+
+	FENPathCacheKey(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection, EWireStyle WireStyle, bool RightPriority, float ZoomFactor, uint32 RoundRadius);
+
+	bool operator==(const FENPathCacheKey& Other) const;
+
+	friend uint32 GetTypeHash(const FENPathCacheKey& Key);
+};
+
+/* Routes computed for the wires of a graph, kept between paints */
+class FENPathCache
+{
+public:
+	static FENPathCache& Get(const UEdGraph* Graph);
+
+	const TArray<FENPathSegment>* Find(const FENPathCacheKey& Key);
+	void Add(const FENPathCacheKey& Key, TArray<FENPathSegment>&& Segments);
+
+private:
+	struct FEntry
+	{
+		TArray<FENPathSegment> Segments;
+		uint64 LastUsedFrame;
+	};
+
+	TMap<FENPathCacheKey, FEntry> Entries;
+	uint64 LastPruneFrame = 0;
+
+	/* routes not drawn for this many frames belong to wires which moved or were removed */
+	static constexpr uint64 PruneFrames = 120;
+
+	void Prune();
+};
+
 class FENPathDrawer
 {
 public:
 	FENPathDrawer(int32& LayerId, float& ZoomFactor, bool RightPriority, const FConnectionParams* Params, FSlateWindowElementList* DrawElementsList, FENConnectionDrawingPolicy* ConnectionDrawingPolicy);
 
+	void DrawCachedWire(FENPathCache* PathCache, EWireStyle WireStyle, const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection);
+
 	void DrawManhattanWire(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection);
 	void DrawSubwayWire(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection);
 	void DrawDefaultWire(const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection);
@@ -43,7 +108,14 @@ private:
 	float ZoomFactor;
 	bool RightPriority;
 
-	FLinearColor WireColor;
+	TOptional<FLinearColor> CurrentDebugColor;
+
+	/* while set, segments are collected relative to RecordOrigin instead of drawn */
+	TArray<FENPathSegment>* RecordedSegments = nullptr;
+	FVector2D RecordOrigin;
+
+	void AddSegment(EENPathSegmentType Type, const FVector2D& Start, const FVector2D& StartDirection, const FVector2D& End, const FVector2D& EndDirection, int32 AngleDeg = 0);
+	void PaintSegment(const FENPathSegment& Segment, const FVector2D& Origin);
 	const FConnectionParams* Params;
 	FSlateWindowElementList* DrawElementsList;
 	FENConnectionDrawingPolicy* ConnectionDrawingPolicy;
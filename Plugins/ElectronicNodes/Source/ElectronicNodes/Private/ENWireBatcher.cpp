@@ -0,0 +1,126 @@
+/* Copyright (C) 2021 Hugo ATTAL - All Rights Reserved
+* This plugin is downloadable from the Unreal Engine Marketplace
+*/
+
+#include "ENWireBatcher.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/DrawElements.h"
+#include "Rendering/SlateRenderer.h"
+#include "Styling/CoreStyle.h"
+
+FENWireBatcher::FENWireBatcher(FSlateWindowElementList& DrawElementsList, const FSlateBrush* Brush)
+	: DrawElementsList(DrawElementsList)
+{
+	if (FSlateApplication::IsInitialized())
+	{
+		this->ResourceHandle = FSlateApplication::Get().GetRenderer()->GetResourceHandle(Brush != nullptr ? *Brush : *FCoreStyle::Get().GetBrush("GenericWhiteBox"));
+	}
+}
+
+void FENWireBatcher::AddSpline(int32 InLayerId, const FVector2D& Start, const FVector2D& StartTangent, const FVector2D& End, const FVector2D& EndTangent, float Thickness, const FLinearColor& Color, const FENWireAnimation* Animation)
+{
+	if (InLayerId != LayerId)
+	{
+		Flush();
+		LayerId = InLayerId;
+	}
+
+	/* Same curve as a Slate spline: hermite, split in steps of at most MaxStepLength along its control polygon */
+	int32 NumSteps = 1;
+	if (!StartTangent.IsZero() || !EndTangent.IsZero())
+	{
+		const FVector2D Control1 = Start + StartTangent / 3.0f;
+		const FVector2D Control2 = End - EndTangent / 3.0f;
+		const float ApproxLength = (Control1 - Start).Size() + (Control2 - Control1).Size() + (End - Control2).Size();
+		NumSteps = FMath::Clamp(FMath::CeilToInt(ApproxLength / MaxStepLength), 1, MaxSteps);
+	}
+
+	const int32 NumPoints = NumSteps + 1;
+	const int32 NumNewVertices = NumPoints * 4;
+	if (Vertices.Num() + NumNewVertices > static_cast<int32>(TNumericLimits<SlateIndex>::Max()))
+	{
+		Flush();
+		LayerId = InLayerId;
+	}
+
+	TArray<FVector2D, TInlineAllocator<MaxSteps + 1>> Points;
+	for (int32 i = 0; i < NumPoints; ++i)
+	{
+		Points.Add(FMath::CubicInterp(Start, StartTangent, End, EndTangent, static_cast<float>(i) / NumSteps));
+	}
+
+	const float HalfThickness = FMath::Max(Thickness * 0.5f, 0.5f);
+
+	/* Animated wires are widened to fit their bubbles, the material draws the wire itself inside */
+	const float HalfWidth = Animation != nullptr ? FMath::Max(HalfThickness, Animation->BubbleSize * 0.5f) : HalfThickness;
+	const float BubbleSpeed = Animation != nullptr ? Animation->BubbleSpeed : 0.0f;
+	const float ThicknessRatio = HalfThickness / (HalfWidth + FeatherWidth);
+
+	/* Outer feather, core edge, core edge, outer feather */
+	const float Offsets[4] = { HalfWidth + FeatherWidth, HalfWidth, -HalfWidth, -(HalfWidth + FeatherWidth) };
+
+	const FColor InnerColor = Color.ToFColor(true);
+	FColor OuterColor = InnerColor;
+	OuterColor.A = 0;
+
+	const int32 FirstVertex = Vertices.Num();
+	float Distance = 0.0f;
+	for (int32 i = 0; i < NumPoints; ++i)
+	{
+		/* Interior points use the direction between their neighbours so consecutive quads share their edge */
+		const FVector2D Direction = (Points[FMath::Min(i + 1, NumSteps)] - Points[FMath::Max(i - 1, 0)]).GetSafeNormal();
+		const FVector2D Normal(-Direction.Y, Direction.X);
+
+		if (i > 0)
+		{
+			Distance += (Points[i] - Points[i - 1]).Size();
+		}
+
+		for (int32 Side = 0; Side < 4; ++Side)
+		{
+			const FVector4 TexCoords = Animation != nullptr
+				? FVector4(Distance / Animation->BubbleSpace, -Offsets[Side] / (HalfWidth + FeatherWidth), BubbleSpeed, ThicknessRatio)
+				: FVector4(0.5f, 0.5f, 1.0f, 1.0f);
+			AddVertex(Points[i] + Normal * Offsets[Side], TexCoords, (Side == 0 || Side == 3) ? OuterColor : InnerColor);
+		}
+	}
+
+	/* Three strips along the wire: outer feather, core, outer feather */
+	for (int32 i = 0; i < NumSteps; ++i)
+	{
+		const int32 Row = FirstVertex + i * 4;
+		const int32 NextRow = Row + 4;
+		for (int32 Strip = 0; Strip < 3; ++Strip)
+		{
+			Indices.Add(Row + Strip);
+			Indices.Add(NextRow + Strip);
+			Indices.Add(Row + Strip + 1);
+
+			Indices.Add(Row + Strip + 1);
+			Indices.Add(NextRow + Strip);
+			Indices.Add(NextRow + Strip + 1);
+		}
+	}
+}
+
+void FENWireBatcher::Flush()
+{
+	if (Indices.Num() > 0 && ResourceHandle.IsValid())
+	{
+		FSlateDrawElement::MakeCustomVerts(DrawElementsList, LayerId, ResourceHandle, Vertices, Indices, nullptr, 0, 0);
+	}
+
+	Vertices.Reset();
+	Indices.Reset();
+	LayerId = INDEX_NONE;
+}
+
+void FENWireBatcher::AddVertex(const FVector2D& Position, const FVector4& TexCoords, const FColor& Color)
+{
+	/* TexCoords.xy is TexCoord0 of a material, the material coordinates TexCoord1 */
+#if ENGINE_MAJOR_VERSION == 5
+	Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(FSlateRenderTransform(), FVector2f(Position), FVector4f(TexCoords), FVector2f(TexCoords.Z, TexCoords.W), Color));
+#else
+	Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(FSlateRenderTransform(), Position, TexCoords, FVector2D(TexCoords.Z, TexCoords.W), Color));
+#endif
+}
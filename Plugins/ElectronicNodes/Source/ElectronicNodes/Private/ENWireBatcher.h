@@ -0,0 +1,48 @@
+/* Copyright (C) 2021 Hugo ATTAL - All Rights Reserved
+* This plugin is downloadable from the Unreal Engine Marketplace
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Rendering/RenderingCommon.h"
+#include "Rendering/SlateResourceHandle.h"
+
+class FSlateWindowElementList;
+struct FSlateBrush;
+
+/* Inputs of the bubble material, in pixels */
+struct FENWireAnimation
+{
+	float BubbleSpace;
+	float BubbleSpeed;
+	float BubbleSize;
+};
+
+/* Tessellates the wires of a layer into one vertex buffer, submitted as a single custom element instead of one spline element per segment */
+class FENWireBatcher
+{
+public:
+	/* Without a brush the wires are drawn plain white tinted by their color */
+	FENWireBatcher(FSlateWindowElementList& DrawElementsList, const FSlateBrush* Brush = nullptr);
+
+	void AddSpline(int32 LayerId, const FVector2D& Start, const FVector2D& StartTangent, const FVector2D& End, const FVector2D& EndTangent, float Thickness, const FLinearColor& Color, const FENWireAnimation* Animation = nullptr);
+
+	/* Must be called before anything else is drawn on the layer, so the wires keep their place in the draw order */
+	void Flush();
+
+private:
+	FSlateWindowElementList& DrawElementsList;
+	FSlateResourceHandle ResourceHandle;
+
+	int32 LayerId = INDEX_NONE;
+	TArray<FSlateVertex> Vertices;
+	TArray<SlateIndex> Indices;
+
+	/* Width of the transparent border used to antialias the edges */
+	static constexpr float FeatherWidth = 1.0f;
+	static constexpr float MaxStepLength = 8.0f;
+	static constexpr int32 MaxSteps = 32;
+
+	void AddVertex(const FVector2D& Position, const FVector4& TexCoords, const FColor& Color);
+};
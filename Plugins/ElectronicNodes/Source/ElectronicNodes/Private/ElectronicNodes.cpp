@@ -12,11 +12,14 @@
 #include "Patch/NodeFactoryPatch.h"
 #include "Popup/ENUpdatePopup.h"
 #include "ISettingsEditorModule.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 #define LOCTEXT_NAMESPACE "FElectronicNodesModule"
 
 void FElectronicNodesModule::StartupModule()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(PluginStartup_ElectronicNodes);
+
 	const TSharedPtr<FENConnectionDrawingPolicyFactory> ENConnectionFactory = MakeShareable(new FENConnectionDrawingPolicyFactory);
 	FEdGraphUtilities::RegisterVisualPinConnectionFactory(ENConnectionFactory);
 
@@ -22,6 +22,7 @@ public:
 	{
 		this->ConnectionDrawingPolicy->SetMousePosition(LocalMousePosition);
 		this->ConnectionDrawingPolicy->DrawConnection(LayerId, Start, End, Params);
+		this->ConnectionDrawingPolicy->ENFlushWires();
 		SplineOverlapResult = FGraphSplineOverlapResult(this->ConnectionDrawingPolicy->SplineOverlapResult);
 	}
 	
@@ -7,6 +7,8 @@
 #include "Engine/DeveloperSettings.h"
 #include "ElectronicNodesSettings.generated.h"
 
+class UMaterialInterface;
+
 UENUM(BlueprintType)
 enum class EWireStyle : uint8
 {
@@ -239,6 +241,10 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "Bubbles Style", meta = (EditCondition = "ForceDrawBubbles", ClampMin = "10.0"))
 	float BubbleSpace = 20.0f;
 
+	/* UI material drawing the wires which have bubbles, so they are animated on the GPU instead of placed every frame. TexCoord0: distance along the wire in bubble spaces, -1 to 1 across the wire. TexCoord1: bubble speed (0 when not moving), wire thickness over the drawn width. Vertex color: wire color. Default: none (bubbles are images) */
+	UPROPERTY(config, EditAnywhere, Category = "Bubbles Style", meta = (EditCondition = "ForceDrawBubbles", AllowedClasses = "/Script/Engine.MaterialInterface"))
+	TSoftObjectPtr<UMaterialInterface> BubbleMaterial;
+
 	bool Debug = false;
 
 	/* Internal value to fix elements on plugin update. */
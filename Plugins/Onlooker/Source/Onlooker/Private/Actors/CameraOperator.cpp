@@ -1,16 +1,34 @@
 #include "Actors/CameraOperator.h"
 
+#include <Camera/PlayerCameraManager.h>
+#include <ContentStreaming.h>
+#include <Curves/CurveFloat.h>
+#include <Engine/World.h>
+#include <Kismet/GameplayStatics.h>
+
+#include "Core/CameraOperatorSubsystem.h"
+
+namespace
+{
+	// a long spline samples coarser rather than growing the table without bound
+	constexpr int32 MaxSplineSamples = 4096;
+}
+
 
 ACameraOperator::ACameraOperator()
 {
 	PrimaryActorTick.bCanEverTick = true;
+	// ticking starts when the operator becomes the active one
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 	SpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArm"));
 	Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("Camera"));
+	Spline = CreateDefaultSubobject<USplineComponent>(TEXT("Spline"));
 
 	SpringArm->SetupAttachment(Root);
 	Camera->SetupAttachment(SpringArm);
+	Spline->SetupAttachment(Root);
 
 	RootComponent = Root;
 }
@@ -18,9 +36,218 @@ ACameraOperator::ACameraOperator()
 void ACameraOperator::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (Settings.Type == EPointOfInterestType::Spline)
+	{
+		BuildSplineSamples();
+		ResetMovement();
+	}
+	if (UCameraOperatorSubsystem* Subsystem = GetWorld()->GetSubsystem<UCameraOperatorSubsystem>())
+	{
+		Subsystem->RegisterOperator(this);
+	}
+}
+
+void ACameraOperator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCameraOperatorSubsystem* Subsystem = GetWorld()->GetSubsystem<UCameraOperatorSubsystem>())
+	{
+		Subsystem->UnregisterOperator(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ACameraOperator::SetOperatorActive(bool InIsActive)
+{
+	IsActive = InIsActive;
+	if (IsActive)
+	{
+		ResetMovement();
+	}
+	// a still camera has nothing to do per frame even while it is the active one
+	const bool IsMoving = (Settings.Type == EPointOfInterestType::Location && Settings.RotationEnabled)
+		|| (Settings.Type == EPointOfInterestType::Spline && SplineSamples.Num() >= 2);
+	SetActorTickEnabled(IsActive && IsMoving);
+}
+
+bool ACameraOperator::IsOperatorActive() const
+{
+	return IsActive;
+}
+
+void ACameraOperator::BuildSplineSamples()
+{
+	SplineSamples.Reset();
+	SplineLength = Spline->GetSplineLength();
+	if (SplineLength <= 0.0f)
+	{
+		return;
+	}
+	// evenly spaced in distance, so a constant speed along the spline is a constant step through the table
+	const int32 Intervals = FMath::Clamp(FMath::CeilToInt(SplineLength / FMath::Max(Settings.SampleSpacing, 1.0f)), 1, MaxSplineSamples - 1);
+	SampleDistance = SplineLength / Intervals;
+	SplineSamples.Reserve(Intervals + 1);
+	for (int32 Index = 0; Index <= Intervals; Index++)
+	{
+		SplineSamples.Add(Spline->GetTransformAtDistanceAlongSpline(Index * SampleDistance, ESplineCoordinateSpace::Local));
+	}
+}
+
+FTransform ACameraOperator::SampleSpline(float Distance) const
+{
+	if (SplineSamples.Num() < 2)
+	{
+		return SplineSamples.Num() == 1 ? SplineSamples[0] : FTransform::Identity;
+	}
+	const float Position = FMath::Clamp(Distance, 0.0f, SplineLength) / SampleDistance;
+	const int32 Index = FMath::Min(FMath::FloorToInt(Position), SplineSamples.Num() - 2);
+	const float Alpha = Position - Index;
+	const FTransform& From = SplineSamples[Index];
+	const FTransform& To = SplineSamples[Index + 1];
+	return FTransform(FQuat::Slerp(From.GetRotation(), To.GetRotation(), Alpha), FMath::Lerp(From.GetLocation(), To.GetLocation(), Alpha));
+}
+
+FTransform ACameraOperator::GetStartViewTransform() const
+{
+	const FTransform ArmTransform = Settings.Type == EPointOfInterestType::Spline && SplineSamples.Num() > 0
+		? SplineSamples[0] * GetActorTransform()
+		: SpringArm->GetComponentTransform();
+	// the arm's end without its collision test, which only ever pulls the camera closer
+	const FVector Location = ArmTransform.TransformPosition(SpringArm->SocketOffset - FVector(SpringArm->TargetArmLength, 0.0f, 0.0f)) + SpringArm->TargetOffset;
+	return FTransform(ArmTransform.GetRotation(), Location);
+}
+
+void ACameraOperator::PrefetchStartView(float Duration) const
+{
+	IStreamingManager::Get().AddViewLocation(GetStartViewTransform().GetLocation(), 1.0f, false, Duration);
+}
+
+void ACameraOperator::ResetMovement()
+{
+	SplinePhase = ESplinePhase::Travelling;
+	PhaseTime = 0.0f;
+	IsTravellingBack = false;
+	IsNextViewPrefetched = false;
+	if (Settings.Type == EPointOfInterestType::Spline && SplineSamples.Num() > 0)
+	{
+		SpringArm->SetRelativeTransform(SplineSamples[0]);
+	}
 }
 
 void ACameraOperator::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	if (Settings.Type == EPointOfInterestType::Location && Settings.RotationEnabled)
+	{
+		SpringArm->AddRelativeRotation(FRotator(0.0f, 360.0f * DeltaTime / FMath::Max(Settings.TimeFor360, 0.1f), 0.0f));
+	}
+	else if (Settings.Type == EPointOfInterestType::Spline)
+	{
+		TickSpline(DeltaTime);
+	}
+}
+
+void ACameraOperator::TickSpline(float DeltaTime)
+{
+	PhaseTime += DeltaTime;
+	switch (SplinePhase)
+	{
+	case ESplinePhase::Travelling:
+	{
+		const float Alpha = FMath::Min(PhaseTime / FMath::Max(Settings.TravelTime, 0.1f), 1.0f);
+		SpringArm->SetRelativeTransform(SampleSpline((IsTravellingBack ? 1.0f - Alpha : Alpha) * SplineLength));
+		if (Alpha >= 1.0f)
+		{
+			SplinePhase = ESplinePhase::WaitingAtEnd;
+			PhaseTime = 0.0f;
+			// the wait at the end is the streaming's head start on the view the chain cuts to
+			if (Settings.TransitionType == EPointOfInterestTransitionType::ChainToNext && Settings.NextPointOfInterest != nullptr && !IsNextViewPrefetched)
+			{
+				IsNextViewPrefetched = true;
+				Settings.NextPointOfInterest->PrefetchStartView(Settings.WaitAtEnd + Settings.MaxStreamingWait + 1.0f);
+			}
+		}
+		break;
+	}
+	case ESplinePhase::WaitingAtEnd:
+		if (PhaseTime < Settings.WaitAtEnd)
+		{
+			break;
+		}
+		// a cut onto mips still streaming pops, so the chain holds on a little longer while anything is still wanted
+		if (IsNextViewPrefetched && PhaseTime < Settings.WaitAtEnd + Settings.MaxStreamingWait && IStreamingManager::Get().GetNumWantingResources() > 0)
+		{
+			break;
+		}
+		PhaseTime = 0.0f;
+		if (Settings.TransitionType == EPointOfInterestTransitionType::PingPong)
+		{
+			IsTravellingBack = !IsTravellingBack;
+			SplinePhase = ESplinePhase::Travelling;
+		}
+		else if (Settings.TransitionType == EPointOfInterestTransitionType::ChainToNext && Settings.NextPointOfInterest != nullptr)
+		{
+			if (UCameraOperatorSubsystem* Subsystem = GetWorld()->GetSubsystem<UCameraOperatorSubsystem>())
+			{
+				Subsystem->SetActiveOperator(Settings.NextPointOfInterest);
+			}
+		}
+		else if (Settings.TransitionType == EPointOfInterestTransitionType::ChainToNext)
+		{
+			ResetMovement();
+		}
+		else
+		{
+			SplinePhase = ESplinePhase::Transitioning;
+			HasCutToStart = false;
+			if (Settings.TransitionType == EPointOfInterestTransitionType::FadeToStart)
+			{
+				if (APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0))
+				{
+					CameraManager->StartCameraFade(0.0f, 1.0f, Settings.TransitionTime * 0.5f, FLinearColor::Black, false, true);
+				}
+			}
+		}
+		break;
+	case ESplinePhase::Transitioning:
+	{
+		const float Alpha = FMath::Min(PhaseTime / FMath::Max(Settings.TransitionTime, 0.01f), 1.0f);
+		if (Settings.TransitionType == EPointOfInterestTransitionType::FadeToStart)
+		{
+			// the cut to the start happens behind the fade, halfway through
+			if (Alpha >= 0.5f && !HasCutToStart)
+			{
+				HasCutToStart = true;
+				SpringArm->SetRelativeTransform(SplineSamples[0]);
+				if (APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0))
+				{
+					CameraManager->StartCameraFade(1.0f, 0.0f, Settings.TransitionTime * 0.5f, FLinearColor::Black, false, false);
+				}
+			}
+		}
+		else
+		{
+			const float Blend = Settings.TransitionCurve != nullptr ? Settings.TransitionCurve->GetFloatValue(Alpha) : Alpha;
+			const FTransform& End = SplineSamples.Last();
+			const FTransform& Start = SplineSamples[0];
+			SpringArm->SetRelativeTransform(FTransform(FQuat::Slerp(End.GetRotation(), Start.GetRotation(), Blend), FMath::Lerp(End.GetLocation(), Start.GetLocation(), Blend)));
+		}
+		if (Alpha >= 1.0f)
+		{
+			SplinePhase = ESplinePhase::WaitingAfterTransition;
+			PhaseTime = 0.0f;
+		}
+		break;
+	}
+	case ESplinePhase::WaitingAfterTransition:
+		if (PhaseTime >= Settings.WaitAfterTransition)
+		{
+			SplinePhase = ESplinePhase::Travelling;
+			PhaseTime = 0.0f;
+			IsTravellingBack = false;
+		}
+		break;
+	}
 }
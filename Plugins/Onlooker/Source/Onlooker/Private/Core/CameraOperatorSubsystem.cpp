@@ -0,0 +1,49 @@
+#include "Core/CameraOperatorSubsystem.h"
+
+#include "Actors/CameraOperator.h"
+
+
+void UCameraOperatorSubsystem::RegisterOperator(ACameraOperator* Operator)
+{
+	Operators.AddUnique(Operator);
+}
+
+void UCameraOperatorSubsystem::UnregisterOperator(ACameraOperator* Operator)
+{
+	Operators.Remove(Operator);
+	if (ActiveOperator.Get() == Operator)
+	{
+		ActiveOperator.Reset();
+	}
+}
+
+void UCameraOperatorSubsystem::SetActiveOperator(ACameraOperator* Operator)
+{
+	if (ActiveOperator.IsValid())
+	{
+		ActiveOperator->SetOperatorActive(false);
+	}
+	ActiveOperator = Operator;
+	if (Operator != nullptr)
+	{
+		Operator->SetOperatorActive(true);
+	}
+}
+
+ACameraOperator* UCameraOperatorSubsystem::GetActiveOperator() const
+{
+	return ActiveOperator.Get();
+}
+
+TArray<ACameraOperator*> UCameraOperatorSubsystem::GetOperators(bool OnlyEnabledInMenu) const
+{
+	TArray<ACameraOperator*> Result;
+	for (ACameraOperator* Operator : Operators)
+	{
+		if (Operator != nullptr && (!OnlyEnabledInMenu || Operator->EnabledInMenu))
+		{
+			Result.Add(Operator);
+		}
+	}
+	return Result;
+}
@@ -0,0 +1,106 @@
+#include "Core/DebouncedConfigSaver.h"
+
+#include <HAL/PlatformTime.h>
+#include <Misc/ConfigCacheIni.h>
+#include <Misc/FileHelper.h>
+
+
+FDebouncedConfigSaver::FDebouncedConfigSaver(float InIdleSeconds)
+	: IdleSeconds(InIdleSeconds)
+{
+}
+
+FDebouncedConfigSaver::~FDebouncedConfigSaver()
+{
+	Flush();
+}
+
+void FDebouncedConfigSaver::RequestSave(UObject* Object, const FString& Filename)
+{
+	if (Object == nullptr)
+	{
+		return;
+	}
+	LastRequestTime = FPlatformTime::Seconds();
+	const bool IsPending = Pending.ContainsByPredicate([Object, &Filename](const FPendingSave& Save)
+	{
+		return Save.Object.Get() == Object && Save.Filename == Filename;
+	});
+	if (!IsPending)
+	{
+		Pending.Add(FPendingSave{Object, Filename});
+	}
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FDebouncedConfigSaver::Tick));
+	}
+}
+
+void FDebouncedConfigSaver::Flush()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	SavePending();
+	Write.Wait();
+}
+
+bool FDebouncedConfigSaver::Tick(float DeltaTime)
+{
+	// still being edited, or the last write has not landed yet
+	if (FPlatformTime::Seconds() - LastRequestTime < IdleSeconds || !Write.IsCompleted())
+	{
+		return true;
+	}
+	SavePending();
+	TickerHandle.Reset();
+	return false;
+}
+
+void FDebouncedConfigSaver::SavePending()
+{
+	if (Pending.Num() == 0 || GConfig == nullptr)
+	{
+		Pending.Reset();
+		return;
+	}
+	Write.Wait();
+
+	// SaveConfig would also flush every file to disk right here; with file operations off it only updates the cache
+	TArray<TPair<FString, FString>> Files;
+	GConfig->DisableFileOperations();
+	for (const FPendingSave& Save : Pending)
+	{
+		UObject* Object = Save.Object.Get();
+		if (Object == nullptr)
+		{
+			continue;
+		}
+		const FString Filename = Save.Filename.IsEmpty() ? Object->GetClass()->GetConfigName() : Save.Filename;
+		Object->SaveConfig(CPF_Config, Save.Filename.IsEmpty() ? nullptr : *Save.Filename);
+		FString Text;
+		FConfigFile* File = GConfig->FindConfigFile(Filename);
+		if (File != nullptr && File->WriteToString(Text, Filename))
+		{
+			Files.Add(TPair<FString, FString>(Filename, MoveTemp(Text)));
+		}
+	}
+	GConfig->EnableFileOperations();
+	Pending.Reset();
+
+	if (Files.Num() > 0)
+	{
+		Write = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Files = MoveTemp(Files)]()
+		{
+			for (const TPair<FString, FString>& File : Files)
+			{
+				if (!FFileHelper::SaveStringToFile(File.Value, *File.Key))
+				{
+					UE_LOG(LogTemp, Warning, TEXT("Could not save settings to %s"), *File.Key);
+				}
+			}
+		}, LowLevelTasks::ETaskPriority::BackgroundNormal);
+	}
+}
@@ -1,6 +1,7 @@
 #include "Core/Onlooker.h"
 
 #include <Interfaces/IPluginManager.h>
+#include <ProfilingDebugging/CpuProfilerTrace.h>
 
 #if WITH_EDITOR
 	#include <ISettingsEditorModule.h>
@@ -11,6 +12,8 @@
 
 void FOnlookerModule::StartupModule()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(PluginStartup_Onlooker);
+
 	PluginDirectory = IPluginManager::Get().FindPlugin(TEXT("Onlooker"))->GetBaseDir();
 	GlobalSettingsFile = PluginDirectory + "/Settings.ini";
 
@@ -23,13 +26,19 @@ void FOnlookerModule::StartupModule()
 
 void FOnlookerModule::ReloadConfiguration(UObject* Object, struct FPropertyChangedEvent& Property)
 {
-	const FName PropertyName = Property.GetPropertyName();
-
-	OnlookerSettings->SaveConfig();
+	SettingsSaver.RequestSave(OnlookerSettings);
 }
 
 void FOnlookerModule::ShutdownModule()
 {
+	#if WITH_EDITOR
+		if (OnlookerSettings != nullptr)
+		{
+			OnlookerSettings->OnSettingChanged().RemoveAll(this);
+		}
+	#endif
+
+	SettingsSaver.Flush();
 }
 
 #undef LOCTEXT_NAMESPACE
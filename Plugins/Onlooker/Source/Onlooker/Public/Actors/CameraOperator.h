@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Camera/CameraComponent.h>
+#include <Components/SplineComponent.h>
 #include <CoreMinimal.h>
 #include <GameFramework/Actor.h>
 #include <GameFramework/SpringArmComponent.h>
@@ -14,8 +15,8 @@ UCLASS(Blueprintable, BlueprintType)
 class ONLOOKER_API ACameraOperator : public AActor
 {
 	GENERATED_BODY()
-	
-public:	
+
+public:
 	ACameraOperator();
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Onlooker")
@@ -27,16 +28,70 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Onlooker")
 	UCameraComponent* Camera;
 
+	// the path of a Spline point of interest, relative to the operator; the spring arm travels along it
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Onlooker")
+	USplineComponent* Spline;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Onlooker")
 	bool EnabledInMenu = true;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Onlooker")
 	FPointOfInterest Settings;
 
+	// starts the operator's movement from the beginning, or stops it; called by UCameraOperatorSubsystem, only the active operator ticks
+	void SetOperatorActive(bool InIsActive);
+
+	UFUNCTION(BlueprintPure, Category = "Onlooker")
+	bool IsOperatorActive() const;
+
+	// rebuilds the spline's sample table, needed after its points change at runtime
+	UFUNCTION(BlueprintCallable, Category = "Onlooker")
+	void BuildSplineSamples();
+
+	// the spring arm's transform at a distance along the spline, relative to the operator, read from the sample table
+	FTransform SampleSpline(float Distance) const;
+
+	// where the camera will be once the operator is made active, before it has moved
+	FTransform GetStartViewTransform() const;
+
+	// asks texture and mesh streaming to load for the start view for the next Duration seconds, ahead of a cut to it
+	UFUNCTION(BlueprintCallable, Category = "Onlooker")
+	void PrefetchStartView(float Duration) const;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-public:	
+public:
 	virtual void Tick(float DeltaTime) override;
 
+private:
+	enum class ESplinePhase : uint8
+	{
+		Travelling,
+		WaitingAtEnd,
+		Transitioning,
+		WaitingAfterTransition
+	};
+
+	void TickSpline(float DeltaTime);
+
+	// puts the spring arm back where the point of interest starts
+	void ResetMovement();
+
+	bool IsActive = false;
+
+	// the spring arm's transform at evenly spaced distances along the spline, from its start to its end inclusive
+	TArray<FTransform> SplineSamples;
+	float SplineLength = 0.0f;
+	float SampleDistance = 0.0f;
+
+	ESplinePhase SplinePhase = ESplinePhase::Travelling;
+	float PhaseTime = 0.0f;
+	// set once the view the chain cuts to has been asked for
+	bool IsNextViewPrefetched = false;
+	// ping-pong travels back from the end every other time
+	bool IsTravellingBack = false;
+	// a fade to the start has cut to it behind the fade
+	bool HasCutToStart = false;
 };
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Subsystems/WorldSubsystem.h>
+
+#include "CameraOperatorSubsystem.generated.h"
+
+class ACameraOperator;
+
+
+// keeps track of the world's camera operators and lets only the current one tick
+UCLASS()
+class ONLOOKER_API UCameraOperatorSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterOperator(ACameraOperator* Operator);
+	void UnregisterOperator(ACameraOperator* Operator);
+
+	// stops the current operator and starts Operator from the beginning; null just stops the current one
+	UFUNCTION(BlueprintCallable, Category = "Onlooker")
+	void SetActiveOperator(ACameraOperator* Operator);
+
+	UFUNCTION(BlueprintPure, Category = "Onlooker")
+	ACameraOperator* GetActiveOperator() const;
+
+	// every operator in play, or only those enabled in the menu
+	UFUNCTION(BlueprintPure, Category = "Onlooker")
+	TArray<ACameraOperator*> GetOperators(bool OnlyEnabledInMenu) const;
+
+private:
+	UPROPERTY()
+	TArray<ACameraOperator*> Operators;
+
+	TWeakObjectPtr<ACameraOperator> ActiveOperator;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Containers/Ticker.h>
+#include <CoreMinimal.h>
+#include <Tasks/Task.h>
+#include <UObject/WeakObjectPtr.h>
+
+
+// saves config objects once their edits go quiet instead of on every change, and writes the ini files on a background task
+// a slider drag raises a change event per frame; each only marks the object, the ini is written IdleSeconds after the last one
+class ONLOOKER_API FDebouncedConfigSaver
+{
+public:
+	explicit FDebouncedConfigSaver(float InIdleSeconds = 0.5f);
+	~FDebouncedConfigSaver();
+
+	// marks the object's config properties as changed; Filename is the ini to write, empty for the object's own config file
+	void RequestSave(UObject* Object, const FString& Filename = FString());
+
+	// writes everything still pending and waits for the writes in flight, for module shutdown
+	void Flush();
+
+private:
+	struct FPendingSave
+	{
+		TWeakObjectPtr<UObject> Object;
+		FString Filename;
+	};
+
+	bool Tick(float DeltaTime);
+
+	// copies the objects into the config cache and hands the files' text to a background write
+	void SavePending();
+
+	float IdleSeconds;
+	double LastRequestTime = 0.0;
+	TArray<FPendingSave> Pending;
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	// one write at a time, so an older text never lands after a newer one
+	UE::Tasks::FTask Write;
+};
@@ -3,6 +3,7 @@
 #include <CoreMinimal.h>
 #include <Modules/ModuleInterface.h>
 
+#include "DebouncedConfigSaver.h"
 #include "OnlookerSettings.h"
 
 class FOnlookerModule : public IModuleInterface
@@ -17,6 +18,7 @@ private:
 	UOnlookerSettings* OnlookerSettings = nullptr;
 	FString PluginDirectory;
 	FString GlobalSettingsFile;
+	FDebouncedConfigSaver SettingsSaver;
 
 	void ReloadConfiguration(UObject* Object, struct FPropertyChangedEvent& Property);
 };
@@ -44,6 +44,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Onlooker|Rotation", meta = (EditCondition = "RotationEnabled", EditConditionHides))
     float TimeFor360 = 20.0f;
 
+    // seconds from one end of the spline to the other, at constant speed
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Onlooker|Spline", meta = (EditCondition = "Type == EPointOfInterestType::Spline", EditConditionHides, ClampMin = "0.1"))
+    float TravelTime = 10.0f;
+
+    // distance between two precomputed samples of the spline; the camera moves on straight lines between them
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Onlooker|Spline", AdvancedDisplay, meta = (EditCondition = "Type == EPointOfInterestType::Spline", EditConditionHides, ClampMin = "1.0"))
+    float SampleSpacing = 25.0f;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Onlooker|Spline", meta = (EditCondition = "Type == EPointOfInterestType::Spline", EditConditionHides))
     float WaitAtEnd = 2.0f;
 
@@ -61,4 +69,8 @@ public:
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Onlooker|Spline", meta = (EditCondition = "Type == EPointOfInterestType::Spline && TransitionType == EPointOfInterestTransitionType::ChainToNext", EditConditionHides))
     class ACameraOperator* NextPointOfInterest;
+
+    // how much longer than WaitAtEnd the chain may hold on the end while the next view's textures and meshes still stream in
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Onlooker|Spline", meta = (EditCondition = "Type == EPointOfInterestType::Spline && TransitionType == EPointOfInterestTransitionType::ChainToNext", EditConditionHides, ClampMin = "0.0"))
+    float MaxStreamingWait = 1.0f;
 };
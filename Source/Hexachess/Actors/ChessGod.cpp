@@ -1,16 +1,80 @@
 #include "ChessGod.h"
 
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+#include "Actors/HexaGrid.h"
+#include "Chess/BitboardEngine.h"
+#include "Chess/CellIndex.h"
 #include "Chess/ChessEngine.h"
+#include "Chess/PositionCodec.h"
+#include "Chess/SpectatorLog.h"
+#include "Chess/StaticExchange.h"
+#include "Core/HexaGameInstance.h"
+#include "Core/HexaSaveGame.h"
+#include "Search/OpeningBook.h"
+
+// the move sets and attacks of one position, computed on a worker for RequestLegalityAsync and RequestCellUnderAttackAsync
+struct FLegalityJob
+{
+    PackedBoard Position;
+    std::atomic<bool> IsDone{false};
+
+    // written by the worker, read on the game thread once IsDone is set
+    TMap<FIntPoint, TArray<FIntPoint>> Moves[2];
+    bool IsInCheck[2] = {};
+    AttackMap Attacks;
+
+    // requests that came in while the job was running, only touched on the game thread
+    bool IsSideRequested[2] = {};
+    TArray<FIntPoint> RequestedCells;
+
+    bool IsCellUnderAttack(const FIntPoint InPosition) const
+    {
+        const int32 Index = ToCellIndex(InPosition);
+        if (Index < 0)
+        {
+            return false;
+        }
+        // the same question can_be_captured answers: is the piece's opponent attacking it
+        const Cell::PieceColor Opponent = Position.get_square(Index).get_opposite_color();
+        return Opponent != Cell::PieceColor::absent && Attacks.is_attacked(Index, PackedBoard::side_of(Opponent));
+    }
+};
 
 
 AChessGod::AChessGod(const FObjectInitializer& ObjectInitializer)
 {
     MinimaxAIComponent = CreateDefaultSubobject<UMinimaxAIComponent>(TEXT("MinimaxAIComponent"));
+    MctsAIComponent = CreateDefaultSubobject<UMctsAIComponent>(TEXT("MctsAIComponent"));
+
+    // the tick drains the AI's search progress
+    PrimaryActorTick.bCanEverTick = true;
 }
 
 void AChessGod::BeginPlay()
 {
     Super::BeginPlay();
+
+    // the book is optional, without it every move is searched
+    OpeningBook = new FOpeningBook();
+    if (!OpeningBookPath.IsEmpty() && !OpeningBook->Open(FPaths::ProjectContentDir() / OpeningBookPath))
+    {
+        UE_LOG(LogTemp, Log, TEXT("No opening book at %s"), *OpeningBookPath);
+    }
+    CopycatBook = new FOpeningBook();
+    if (!CopycatBookPath.IsEmpty() && !CopycatBook->Open(FPaths::ProjectContentDir() / CopycatBookPath))
+    {
+        UE_LOG(LogTemp, Log, TEXT("No copycat book at %s"), *CopycatBookPath);
+    }
+    Spectators = new SpectatorLog(SpectatorKeyframeInterval);
+    PrewarmPiecePool();
+    if (PrewarmAIOnBeginPlay)
+    {
+        PrewarmAI();
+    }
 }
 
 void AChessGod::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -18,6 +82,24 @@ void AChessGod::EndPlay(const EEndPlayReason::Type EndPlayReason)
     Super::EndPlay(EndPlayReason);
 
     EndGame();
+    delete OpeningBook;
+    OpeningBook = nullptr;
+    delete CopycatBook;
+    CopycatBook = nullptr;
+    delete Spectators;
+    Spectators = nullptr;
+}
+
+void AChessGod::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    MinimaxAIComponent->DispatchSearchProgress();
+    // the heatmap needs a job for every position, started here once the position stopped changing for the frame
+    if (ThreatHeatmapGrid != nullptr && !LegalityJob.IsValid())
+    {
+        GetLegalityJob();
+    }
 }
 
 void AChessGod::StartGame()
@@ -27,19 +109,182 @@ void AChessGod::StartGame()
 
 void AChessGod::EndGame()
 {
-    if (ActiveBoard != nullptr)
+    // the search works on its own snapshot, but its move would be for a game that no longer exists
+    MinimaxAIComponent->CancelSearch();
+    MctsAIComponent->CancelSearch();
+    RecordGame();
+    ReleaseLogicalBoard();
+    InvalidateLegalMoveSets();
+}
+
+void AChessGod::ResetToStartingPosition(AHexaGrid* Grid)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ChessGod_ResetToStartingPosition);
+    if (ActiveBoard == nullptr || UseBitboardEngine != (ActiveBitboard != nullptr))
     {
-        delete ActiveBoard;
-        ActiveBoard = nullptr;
+        EndGame();
+        StartGame();
+        RegisterStartingPieces();
+    }
+    else
+    {
+        RecordGame();
+        ResetAIForNewGame();
+        // the same boards and caches, only the cells and the move history start over
+        ReplacePosition(Board::starting_position());
+    }
+    if (Grid != nullptr)
+    {
+        PlaceStartingPieces(Grid);
+    }
+}
+
+void AChessGod::RecordGame() const
+{
+    if (!RecordGames || ActiveBoard == nullptr)
+    {
+        return;
+    }
+    const TArray<uint8> MoveRecord = GetMoveRecord();
+    const FString RecordPath = FPaths::ProjectSavedDir() / TEXT("Games") / FString::Printf(TEXT("%s.hxgame"), *FDateTime::Now().ToString());
+    if (MoveRecord.Num() > 0 && !FFileHelper::SaveArrayToFile(MoveRecord, *RecordPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Could not record the game to %s"), *RecordPath);
+    }
+}
+
+void AChessGod::ResetAIForNewGame()
+{
+    MinimaxAIComponent->CancelSearch();
+    MctsAIComponent->CancelSearch();
+    // a replayed game must see the same random picks and the same search state as the first time
+    AIRandom.Initialize(AISeed != 0 ? AISeed : FMath::Rand());
+    if (UseNodeBudgets)
+    {
+        MinimaxAIComponent->ClearSearchState();
     }
 }
 
 void AChessGod::CreateLogicalBoard()
 {
-    ActiveBoard = new Board();
+    ResetAIForNewGame();
+    InvalidateLegalMoveSets();
+    // a restart hands the previous game's board back before taking one, so a rematch gets the same board again
+    ReleaseLogicalBoard();
+    UHexaGameInstance* GameInstance = GetGameInstance<UHexaGameInstance>();
+    ActiveBoard = GameInstance != nullptr ? GameInstance->AcquireBoard() : new Board();
+    if (UseBitboardEngine)
+    {
+        ActiveBitboard = new BitboardPosition();
+        ActiveBitboard->load(ActiveBoard->packed_board);
+    }
+    // the new game's setup goes into the stream once its pieces are registered
+    IsSpectatorKeyframeDue = true;
+}
+
+void AChessGod::ReleaseLogicalBoard()
+{
+    if (ActiveBoard == nullptr)
+    {
+        return;
+    }
+    if (UHexaGameInstance* GameInstance = GetGameInstance<UHexaGameInstance>())
+    {
+        GameInstance->ReleaseBoard(ActiveBoard);
+    }
+    else
+    {
+        delete ActiveBoard;
+    }
+    ActiveBoard = nullptr;
+    delete ActiveBitboard;
+    ActiveBitboard = nullptr;
 }
 
 void AChessGod::RegisterPiece(FPieceInfo PieceInfo)
+{
+    // a piece registered before CreateLogicalBoard has no board to go on
+    if (ActiveBoard == nullptr)
+    {
+        return;
+    }
+    PlacePiece(ActiveBoard, PieceInfo);
+    ReloadBitboard();
+    InvalidateLegalMoveSets();
+    IsSpectatorKeyframeDue = true;
+}
+
+void AChessGod::RegisterPieces(const TArray<FPieceInfo>& Pieces)
+{
+    if (ActiveBoard == nullptr)
+    {
+        return;
+    }
+    for (const FPieceInfo& PieceInfo : Pieces)
+    {
+        PlacePiece(ActiveBoard, PieceInfo);
+    }
+    ReloadBitboard();
+    InvalidateLegalMoveSets();
+    IsSpectatorKeyframeDue = true;
+}
+
+void AChessGod::RegisterStartingPieces()
+{
+    if (ActiveBoard == nullptr)
+    {
+        return;
+    }
+    ReplacePosition(Board::starting_position());
+}
+
+TArray<FPieceInfo> AChessGod::GetStartingPieces()
+{
+    return GetPositionPieces(Board::starting_position());
+}
+
+TArray<FPieceInfo> AChessGod::GetPositionPieces(const PackedBoard& InPosition)
+{
+    TArray<FPieceInfo> Result;
+    for (int32 Index = 0; Index < PackedBoard::cell_count; Index++)
+    {
+        const Square Piece = InPosition.get_square(Index);
+        if (!Piece.has_piece())
+        {
+            continue;
+        }
+        const FIntPoint CellPosition = CellIndexToPosition(Index);
+        FPieceInfo PieceInfo;
+        PieceInfo.X = CellPosition.X;
+        PieceInfo.Y = CellPosition.Y;
+        PieceInfo.TeamID = Piece.get_piece_color() == Cell::PieceColor::white ? 0 : 1;
+        switch (Piece.get_piece_type())
+        {
+        case Cell::PieceType::knight:
+            PieceInfo.Type = EPieceType::Knight;
+            break;
+        case Cell::PieceType::bishop:
+            PieceInfo.Type = EPieceType::Bishop;
+            break;
+        case Cell::PieceType::rook:
+            PieceInfo.Type = EPieceType::Rook;
+            break;
+        case Cell::PieceType::queen:
+            PieceInfo.Type = EPieceType::Queen;
+            break;
+        case Cell::PieceType::king:
+            PieceInfo.Type = EPieceType::King;
+            break;
+        default:
+            PieceInfo.Type = EPieceType::Pawn;
+            break;
+        }
+        Result.Add(PieceInfo);
+    }
+    return Result;
+}
+
+void AChessGod::PlacePiece(Board* InBoard, const FPieceInfo& PieceInfo)
 {
     const auto PieceType = [&]()
     {
@@ -62,132 +307,1083 @@ void AChessGod::RegisterPiece(FPieceInfo PieceInfo)
         }
     }();
 
-    // crashes here:
     Position PiecePosition = Position{PieceInfo.X, PieceInfo.Y};
-    ActiveBoard->set_piece(PiecePosition, PieceType, PieceInfo.TeamID == 0 ? Cell::PieceColor::white : Cell::PieceColor::black);
+    InBoard->set_piece(PiecePosition, PieceType, PieceInfo.TeamID == 0 ? Cell::PieceColor::white : Cell::PieceColor::black);
 }
 
 TArray<FIntPoint> AChessGod::GetMovesForCell(FIntPoint InPosition)
 {
-    TArray<FIntPoint> Result;
-
-    Position PiecePosition = Position{InPosition.X, InPosition.Y};
-    list<Position> Moves = ActiveBoard->get_valid_moves(PiecePosition);
+    const TArray<FIntPoint>* Moves = FindMovesForCell(InPosition);
+    return Moves != nullptr ? *Moves : TArray<FIntPoint>();
+}
 
-    for (const auto& Move : Moves)
+void AChessGod::FillMovesForCell(FIntPoint InPosition, TArray<FIntPoint>& Moves)
+{
+    // Reset keeps the caller's allocation
+    Moves.Reset();
+    if (const TArray<FIntPoint>* CellMoves = FindMovesForCell(InPosition))
     {
-        Result.Add(FIntPoint{Move.x, Move.y});
+        Moves.Append(*CellMoves);
     }
+}
 
-    return Result;
+const TArray<FIntPoint>* AChessGod::FindMovesForCell(FIntPoint InPosition)
+{
+    const int32 Index = ToCellIndex(InPosition);
+    if (ActiveBoard == nullptr || Index < 0 || !ActiveBoard->packed_board.get_square(Index).has_piece())
+    {
+        return nullptr;
+    }
+    const bool IsWhitePiece = ActiveBoard->packed_board.get_square(Index).get_piece_color() == Cell::PieceColor::white;
+    return ComputeLegalMoveSet(IsWhitePiece).Find(InPosition);
 }
 
-void AChessGod::MovePiece(FIntPoint From, FIntPoint To)
+bool AChessGod::MovePiece(FIntPoint From, FIntPoint To)
 {
+    // the board plays whatever it is given, so every caller's move is checked here; a cell off the board has no moves
+    const TArray<FIntPoint>* LegalTargets = FindMovesForCell(From);
+    if (LegalTargets == nullptr || !LegalTargets->Contains(To))
+    {
+        return false;
+    }
     Position FromPosition = Position{From.X, From.Y};
     Position ToPosition = Position{To.X, To.Y};
+    const int32 FromIndex = ToCellIndex(From);
+    const int32 ToIndex = ToCellIndex(To);
+    const int32 EnPassantVictim = ActiveBoard->packed_board.get_en_passant_victim(FromIndex, ToIndex);
+    if (IsSpectatorKeyframeDue)
+    {
+        WriteSpectatorKeyframe();
+    }
 
     ActiveBoard->move_piece(FromPosition, ToPosition);
+    if (ActiveBitboard != nullptr)
+    {
+        ActiveBitboard->move_piece(FromPosition, ToPosition);
+    }
+    if (Spectators != nullptr)
+    {
+        Spectators->write_move(FromIndex, ToIndex, ActiveBoard->packed_board);
+    }
+    InvalidateLegalMoveSets();
+    if (EnPassantVictim >= 0)
+    {
+        OnPawnTakenEnPassant.Broadcast(CellIndexToPosition(EnPassantVictim));
+    }
+    // any change of the position makes a running search stale; after the AI's own move it starts pondering instead
+    MinimaxAIComponent->NotifyMovePlayed(ActiveBoard, From, To);
+    MctsAIComponent->CancelSearch();
+    return true;
+}
+
+bool AChessGod::UndoMove()
+{
+    if (ActiveBoard == nullptr || !ActiveBoard->undo_move())
+    {
+        return false;
+    }
+    OnPositionReplaced();
+    return true;
+}
+
+bool AChessGod::RedoMove()
+{
+    if (ActiveBoard == nullptr || !ActiveBoard->redo_move())
+    {
+        return false;
+    }
+    OnPositionReplaced();
+    return true;
+}
+
+TArray<uint8> AChessGod::GetMoveRecord() const
+{
+    if (ActiveBoard == nullptr)
+    {
+        return TArray<uint8>();
+    }
+    const vector<uint8> Record = ActiveBoard->serialize_history();
+    return TArray<uint8>(Record.data(), static_cast<int32>(Record.size()));
+}
+
+bool AChessGod::LoadMoveRecord(const TArray<uint8>& MoveRecord)
+{
+    if (ActiveBoard == nullptr)
+    {
+        return false;
+    }
+    const vector<uint8> Moves(MoveRecord.GetData(), MoveRecord.GetData() + MoveRecord.Num());
+    // as in LoadSaveGame, a record with a move that is not legal is refused before the game's board is touched
+    Board Replay;
+    Replay.set_position(ActiveBoard->get_history_start());
+    if (!Replay.load_history(Moves))
+    {
+        return false;
+    }
+    ActiveBoard->load_history(Moves);
+    OnPositionReplaced();
+    return true;
+}
+
+int32 AChessGod::GetRepetitionCount() const
+{
+    return ActiveBoard != nullptr ? ActiveBoard->count_repetitions() : 0;
+}
+
+int32 AChessGod::GetReversiblePlies() const
+{
+    return ActiveBoard != nullptr ? ActiveBoard->count_reversible_plies() : 0;
+}
+
+EGameOutcome AChessGod::GetDrawOutcome() const
+{
+    if (GetRepetitionCount() >= 2)
+    {
+        return EGameOutcome::Repetition;
+    }
+    if (FiftyMovePlies > 0 && GetReversiblePlies() >= FiftyMovePlies)
+    {
+        return EGameOutcome::FiftyMoves;
+    }
+    return EGameOutcome::None;
+}
+
+const PackedBoard* AChessGod::GetPosition() const
+{
+    return ActiveBoard != nullptr ? &ActiveBoard->packed_board : nullptr;
+}
+
+int32 AChessGod::GetPlayedMoveCount() const
+{
+    return ActiveBoard != nullptr ? ActiveBoard->get_history_position() : 0;
+}
+
+bool AChessGod::SyncPosition(const PackedBoard& InPosition)
+{
+    if (ActiveBoard == nullptr || !Board::is_valid_shadow(InPosition, InPosition.shadow_cell))
+    {
+        return false;
+    }
+    ReplacePosition(InPosition);
+    return true;
+}
+
+TArray<uint8> AChessGod::SavePosition() const
+{
+    if (ActiveBoard == nullptr)
+    {
+        return TArray<uint8>();
+    }
+    EncodedPosition Encoded;
+    PositionCodec::encode(ActiveBoard->packed_board, Encoded);
+    return TArray<uint8>(Encoded.bytes, EncodedPosition::size);
+}
+
+bool AChessGod::LoadPosition(const TArray<uint8>& PositionBytes)
+{
+    if (ActiveBoard == nullptr || PositionBytes.Num() != EncodedPosition::size)
+    {
+        return false;
+    }
+    EncodedPosition Encoded;
+    FMemory::Memcpy(Encoded.bytes, PositionBytes.GetData(), EncodedPosition::size);
+    PackedBoard Decoded;
+    if (!PositionCodec::decode(Encoded, Decoded))
+    {
+        return false;
+    }
+    ReplacePosition(Decoded);
+    return true;
+}
+
+FString AChessGod::SavePositionText() const
+{
+    if (ActiveBoard == nullptr)
+    {
+        return FString();
+    }
+    return FString(PositionCodec::to_text(ActiveBoard->packed_board).c_str());
+}
+
+bool AChessGod::LoadPositionText(const FString& PositionText)
+{
+    PackedBoard Decoded;
+    if (ActiveBoard == nullptr || !PositionCodec::from_text(TCHAR_TO_ANSI(*PositionText), Decoded))
+    {
+        return false;
+    }
+    ReplacePosition(Decoded);
+    return true;
+}
+
+TArray<uint8> AChessGod::ReadSpectatorStream(int32 FromOffset, int32& OutNextOffset)
+{
+    OutNextOffset = FMath::Max(FromOffset, 0);
+    if (Spectators == nullptr)
+    {
+        return TArray<uint8>();
+    }
+    if (IsSpectatorKeyframeDue)
+    {
+        WriteSpectatorKeyframe();
+    }
+    const vector<uint8>& Bytes = Spectators->get_bytes();
+    const int32 Start = FromOffset < 0 ? static_cast<int32>(Spectators->get_join_offset()) : FMath::Min(FromOffset, static_cast<int32>(Bytes.size()));
+    OutNextOffset = static_cast<int32>(Bytes.size());
+    return TArray<uint8>(Bytes.data() + Start, OutNextOffset - Start);
+}
+
+void AChessGod::WriteSpectatorKeyframe()
+{
+    if (Spectators == nullptr || ActiveBoard == nullptr)
+    {
+        return;
+    }
+    Spectators->write_keyframe(ActiveBoard->packed_board, static_cast<uint32>(ActiveBoard->get_history_position()));
+    IsSpectatorKeyframeDue = false;
+}
+
+UHexaSaveGame* AChessGod::CreateSaveGame() const
+{
+    if (ActiveBoard == nullptr)
+    {
+        return nullptr;
+    }
+    UHexaSaveGame* SaveGame = Cast<UHexaSaveGame>(UGameplayStatics::CreateSaveGameObject(UHexaSaveGame::StaticClass()));
+    EncodedPosition Encoded;
+    const PackedBoard Start = ActiveBoard->get_history_start();
+    PositionCodec::encode(Start, Encoded);
+    SaveGame->StartPosition = TArray<uint8>(Encoded.bytes, EncodedPosition::size);
+    SaveGame->StartShadowCell = Start.shadow_cell;
+    SaveGame->MoveRecord = GetMoveRecord();
+    SaveGame->SavedAt = FDateTime::UtcNow();
+    return SaveGame;
+}
+
+bool AChessGod::LoadSaveGame(const UHexaSaveGame* SaveGame)
+{
+    if (ActiveBoard == nullptr || SaveGame == nullptr || SaveGame->Version != UHexaSaveGame::CurrentVersion || SaveGame->StartPosition.Num() != EncodedPosition::size)
+    {
+        return false;
+    }
+    EncodedPosition Encoded;
+    FMemory::Memcpy(Encoded.bytes, SaveGame->StartPosition.GetData(), EncodedPosition::size);
+    PackedBoard Start;
+    if (!PositionCodec::decode(Encoded, Start) || !Board::is_valid_shadow(Start, SaveGame->StartShadowCell))
+    {
+        return false;
+    }
+    Start.set_shadow(SaveGame->StartShadowCell);
+    const vector<uint8> Moves(SaveGame->MoveRecord.GetData(), SaveGame->MoveRecord.GetData() + SaveGame->MoveRecord.Num());
+    // a save with a move that is not legal is refused before the game's board is touched
+    Board Replay;
+    Replay.set_position(Start);
+    if (!Replay.load_history(Moves))
+    {
+        return false;
+    }
+    // the moves are replayed on the board alone, the caches and the AI only hear about the final position
+    ActiveBoard->set_position(Start);
+    ActiveBoard->load_history(Moves);
+    OnPositionReplaced();
+    return true;
+}
+
+void AChessGod::SaveGameAsync(const FString& SlotName, int32 UserIndex)
+{
+    UHexaSaveGame* SaveGame = CreateSaveGame();
+    if (SaveGame == nullptr)
+    {
+        OnGameSaved.Broadcast(SlotName, false);
+        return;
+    }
+    // the save game is serialized before this returns, only the write waits for the disk
+    const TWeakObjectPtr<AChessGod> WeakThis(this);
+    UGameplayStatics::AsyncSaveGameToSlot(SaveGame, SlotName, UserIndex, FAsyncSaveGameToSlotDelegate::CreateLambda([WeakThis](const FString& SavedSlotName, const int32, bool IsSaved)
+    {
+        if (WeakThis.IsValid())
+        {
+            WeakThis->OnGameSaved.Broadcast(SavedSlotName, IsSaved);
+        }
+    }));
+}
+
+void AChessGod::LoadGameAsync(const FString& SlotName, int32 UserIndex)
+{
+    const TWeakObjectPtr<AChessGod> WeakThis(this);
+    UGameplayStatics::AsyncLoadGameFromSlot(SlotName, UserIndex, FAsyncLoadGameFromSlotDelegate::CreateLambda([WeakThis](const FString& LoadedSlotName, const int32, USaveGame* SaveGame)
+    {
+        // called on the game thread, the board may have gone with its world in the meantime
+        if (WeakThis.IsValid())
+        {
+            const bool IsLoaded = WeakThis->LoadSaveGame(Cast<UHexaSaveGame>(SaveGame));
+            WeakThis->OnGameLoaded.Broadcast(LoadedSlotName, IsLoaded);
+        }
+    }));
+}
+
+void AChessGod::ReplacePosition(const PackedBoard& InPosition)
+{
+    ActiveBoard->set_position(InPosition);
+    OnPositionReplaced();
+}
+
+void AChessGod::ReloadBitboard()
+{
+    if (ActiveBitboard != nullptr)
+    {
+        ActiveBitboard->load(ActiveBoard->packed_board);
+    }
+}
+
+void AChessGod::OnPositionReplaced()
+{
+    // the bitboard only plays moves forward, an undo or a new position is copied over whole
+    ReloadBitboard();
+    InvalidateLegalMoveSets();
+    WriteSpectatorKeyframe();
+    // neither a search nor a ponder is about this position
+    MinimaxAIComponent->CancelSearch();
+    MctsAIComponent->CancelSearch();
 }
 
 bool AChessGod::IsCellUnderAttack(FIntPoint InPosition)
 {
+    TRACE_CPUPROFILER_EVENT_SCOPE(ChessGod_IsCellUnderAttack);
     Position PiecePosition = Position{InPosition.X, InPosition.Y};
+    if (ActiveBitboard != nullptr)
+    {
+        return ActiveBitboard->can_be_captured(PiecePosition);
+    }
     return ActiveBoard->can_be_captured(PiecePosition);
 }
 
 bool AChessGod::AreThereValidMovesForPlayer(bool IsWhitePlayer)
 {
-    return ActiveBoard->are_there_valid_moves(IsWhitePlayer ? Cell::PieceColor::white : Cell::PieceColor::black);
+    return ComputeLegalMoveSet(IsWhitePlayer).Num() > 0;
 }
 
 TArray<FIntPoint> AChessGod::GetValidMovesForPlayer(bool IsWhitePlayer)
 {
     TArray<FIntPoint> Result;
+    FillValidMovesForPlayer(IsWhitePlayer, Result);
+    return Result;
+}
 
-    list<int32> MoveKeys = ActiveBoard->get_all_piece_move_keys(IsWhitePlayer ? Cell::PieceColor::white : Cell::PieceColor::black);
-    for (const auto& Move : MoveKeys)
+void AChessGod::FillValidMovesForPlayer(bool IsWhitePlayer, TArray<FIntPoint>& Moves)
+{
+    Moves.Reset();
+    for (const TPair<FIntPoint, TArray<FIntPoint>>& Pair : ComputeLegalMoveSet(IsWhitePlayer))
     {
-        Position MovePosition = ActiveBoard->to_position(Move);
-        Result.Add(FIntPoint{MovePosition.x, MovePosition.y});
+        Moves.Append(Pair.Value);
     }
+}
 
+bool AChessGod::IsPlayerInCheck(bool IsWhitePlayer)
+{
+    ComputeLegalMoveSet(IsWhitePlayer);
+    return LegalMoveSets[IsWhitePlayer ? 0 : 1].IsInCheck;
+}
+
+TArray<FIntPoint> AChessGod::GetMovableCellsForPlayer(bool IsWhitePlayer)
+{
+    TArray<FIntPoint> Result;
+    FillMovableCellsForPlayer(IsWhitePlayer, Result);
     return Result;
 }
 
+void AChessGod::FillMovableCellsForPlayer(bool IsWhitePlayer, TArray<FIntPoint>& Cells)
+{
+    // GetKeys allocates a set of the keys it has seen on every call, a map has each key once anyway
+    Cells.Reset();
+    for (const TPair<FIntPoint, TArray<FIntPoint>>& Pair : ComputeLegalMoveSet(IsWhitePlayer))
+    {
+        Cells.Add(Pair.Key);
+    }
+}
+
+const TMap<FIntPoint, TArray<FIntPoint>>& AChessGod::ComputeLegalMoveSet(bool IsWhite)
+{
+    FLegalMoveSet& MoveSet = LegalMoveSets[IsWhite ? 0 : 1];
+    LegalityQueryStats.Count++;
+    if (MoveSet.IsValid || ActiveBoard == nullptr)
+    {
+        return MoveSet.Moves;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE(ChessGod_ComputeLegalMoveSet);
+    const double StartTime = FPlatformTime::Seconds();
+
+    // one pass of the filtered generator for the whole side, instead of one per hovered piece
+    const Cell::PieceColor Color = IsWhite ? Cell::PieceColor::white : Cell::PieceColor::black;
+    const Cell::PieceColor Opponent = IsWhite ? Cell::PieceColor::black : Cell::PieceColor::white;
+    MoveList Moves;
+    if (ActiveBitboard != nullptr)
+    {
+        ActiveBitboard->generate_legal_moves(Color, Moves);
+    }
+    else
+    {
+        ActiveBoard->generate_legal_moves(Color, Moves);
+    }
+    MoveSet.Moves.Reset();
+    for (const Move& LegalMove : Moves)
+    {
+        MoveSet.Moves.FindOrAdd(CellIndexToPosition(LegalMove.from)).Add(CellIndexToPosition(LegalMove.to));
+    }
+    const int32 KingCell = ActiveBoard->packed_board.get_king_cell(Color);
+    MoveSet.IsInCheck = ActiveBitboard != nullptr ? ActiveBitboard->is_in_check(Color)
+        : KingCell >= 0 && ActiveBoard->is_attacked(ActiveBoard->packed_board, KingCell, Opponent);
+    MoveSet.IsValid = true;
+    LegalityQueryStats.Misses++;
+    LegalityQueryStats.Seconds += FPlatformTime::Seconds() - StartTime;
+    return MoveSet.Moves;
+}
+
+void AChessGod::InvalidateLegalMoveSets()
+{
+    for (FLegalMoveSet& MoveSet : LegalMoveSets)
+    {
+        MoveSet.IsValid = false;
+    }
+    // a running job finishes for nothing, its requests were about a position that is gone
+    LegalityJob.Reset();
+}
+
+void AChessGod::RequestLegalityAsync(bool IsWhitePlayer)
+{
+    const int32 Side = IsWhitePlayer ? 0 : 1;
+    if (LegalMoveSets[Side].IsValid)
+    {
+        OnLegalityComputed.Broadcast(IsWhitePlayer, LegalMoveSets[Side].Moves.Num() > 0, LegalMoveSets[Side].IsInCheck);
+        return;
+    }
+    if (FLegalityJob* Job = GetLegalityJob())
+    {
+        Job->IsSideRequested[Side] = true;
+    }
+}
+
+void AChessGod::RequestCellUnderAttackAsync(FIntPoint InPosition)
+{
+    FLegalityJob* Job = GetLegalityJob();
+    if (Job == nullptr)
+    {
+        return;
+    }
+    if (Job->IsDone)
+    {
+        OnCellAttackComputed.Broadcast(InPosition, Job->IsCellUnderAttack(InPosition));
+        return;
+    }
+    Job->RequestedCells.AddUnique(InPosition);
+}
+
+FLegalityJob* AChessGod::GetLegalityJob()
+{
+    if (ActiveBoard == nullptr)
+    {
+        return nullptr;
+    }
+    if (LegalityJob.IsValid())
+    {
+        return LegalityJob.Get();
+    }
+    if (!LegalityRules.IsValid())
+    {
+        LegalityRules = MakeShared<Board, ESPMode::ThreadSafe>();
+    }
+
+    const TSharedRef<FLegalityJob, ESPMode::ThreadSafe> Job = MakeShared<FLegalityJob, ESPMode::ThreadSafe>();
+    Job->Position = ActiveBoard->packed_board;
+    LegalityJob = Job;
+
+    const TWeakObjectPtr<AChessGod> WeakThis(this);
+    AsyncTask(ENamedThreads::AnyThread, [WeakThis, Job, Rules = LegalityRules.ToSharedRef()]()
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(ChessGod_LegalityJob);
+        // both sides at once, a hover over either side's piece is then answered from the same job
+        for (int32 Side = 0; Side < 2; Side++)
+        {
+            const Cell::PieceColor Color = Side == 0 ? Cell::PieceColor::white : Cell::PieceColor::black;
+            MoveList Moves;
+            Rules->generate_legal_moves(Job->Position, Color, Moves);
+            for (const Move& LegalMove : Moves)
+            {
+                Job->Moves[Side].FindOrAdd(CellIndexToPosition(LegalMove.from)).Add(CellIndexToPosition(LegalMove.to));
+            }
+            const int32 KingCell = Job->Position.get_king_cell(Color);
+            Job->IsInCheck[Side] = KingCell >= 0 && Rules->is_attacked(Job->Position, KingCell, Side == 0 ? Cell::PieceColor::black : Cell::PieceColor::white);
+        }
+        Rules->build_attack_map(Job->Position, Job->Attacks);
+        Job->IsDone = true;
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, Job]()
+        {
+            // a job replaced by a newer position is only kept alive by this task
+            if (WeakThis.IsValid() && WeakThis->LegalityJob == Job)
+            {
+                WeakThis->FinishLegalityJob();
+            }
+        });
+    });
+    return LegalityJob.Get();
+}
+
+void AChessGod::SetThreatHeatmapGrid(AHexaGrid* Grid)
+{
+    if (ThreatHeatmapGrid != nullptr && ThreatHeatmapGrid != Grid)
+    {
+        ThreatHeatmapGrid->ClearAttackerCounts();
+    }
+    ThreatHeatmapGrid = Grid;
+    if (ThreatHeatmapGrid != nullptr && LegalityJob.IsValid() && LegalityJob->IsDone)
+    {
+        ThreatHeatmapGrid->ApplyAttackMap(LegalityJob->Attacks);
+    }
+}
+
+void AChessGod::FinishLegalityJob()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ChessGod_FinishLegalityJob);
+    FLegalityJob& Job = *LegalityJob;
+    if (ThreatHeatmapGrid != nullptr)
+    {
+        ThreatHeatmapGrid->ApplyAttackMap(Job.Attacks);
+    }
+    for (int32 Side = 0; Side < 2; Side++)
+    {
+        FLegalMoveSet& MoveSet = LegalMoveSets[Side];
+        if (!MoveSet.IsValid)
+        {
+            MoveSet.Moves = MoveTemp(Job.Moves[Side]);
+            MoveSet.IsInCheck = Job.IsInCheck[Side];
+            MoveSet.IsValid = true;
+        }
+    }
+
+    // a listener may move a piece and so replace the job, the requests are copied out first
+    const bool IsSideRequested[2] = {Job.IsSideRequested[0], Job.IsSideRequested[1]};
+    const TArray<FIntPoint> RequestedCells = MoveTemp(Job.RequestedCells);
+    const TSharedPtr<FLegalityJob, ESPMode::ThreadSafe> FinishedJob = LegalityJob;
+    for (int32 Side = 0; Side < 2; Side++)
+    {
+        if (IsSideRequested[Side] && LegalityJob == FinishedJob)
+        {
+            OnLegalityComputed.Broadcast(Side == 0, LegalMoveSets[Side].Moves.Num() > 0, LegalMoveSets[Side].IsInCheck);
+        }
+    }
+    for (const FIntPoint& RequestedCell : RequestedCells)
+    {
+        if (LegalityJob == FinishedJob)
+        {
+            OnCellAttackComputed.Broadcast(RequestedCell, FinishedJob->IsCellUnderAttack(RequestedCell));
+        }
+    }
+}
+
 TArray<FIntPoint> AChessGod::MakeAIMove(bool IsWhiteAI, EAIType AIType, EAIDifficulty AIDifficulty)
 {
     TArray<FIntPoint> Result;
+    FillAIMove(IsWhiteAI, AIType, AIDifficulty, Result);
+    return Result;
+}
+
+void AChessGod::FillAIMove(bool IsWhiteAI, EAIType AIType, EAIDifficulty AIDifficulty, TArray<FIntPoint>& Move)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ChessGod_FillAIMove);
+    Move.Reset();
+    // before CreateLogicalBoard there is no position to move in
+    if (ActiveBoard == nullptr)
+    {
+        return;
+    }
 
     // this is a very naive implementation, but it should work for now
     switch(AIType)
     {
         case EAIType::Random:
-            Result = CalculateRandomAIMove(IsWhiteAI);
+            CalculateRandomAIMove(IsWhiteAI, Move);
             break;
         case EAIType::Copycat:
-            Result = CalculateCopycatAIMove(IsWhiteAI);
+            CalculateCopycatAIMove(IsWhiteAI, Move);
             break;
         case EAIType::MinMax:
-            Result = CalculateMinMaxAIMove(IsWhiteAI, AIDifficulty);
+            CalculateMinMaxAIMove(IsWhiteAI, AIDifficulty, EParallelSearch::LazySMP, Move);
+            break;
+        case EAIType::MinMaxSplitPoints:
+            CalculateMinMaxAIMove(IsWhiteAI, AIDifficulty, EParallelSearch::YoungBrothersWait, Move);
+            break;
+        case EAIType::MonteCarlo:
+            CalculateMctsAIMove(IsWhiteAI, AIDifficulty);
             break;
     }
+}
 
-    return Result;
+void AChessGod::GetAIDifficultyLimits(EAIDifficulty AIDifficulty, int32& OutMaxDepth, int32& OutTimeBudgetMs)
+{
+    // difficulty is a think time plus a depth cap, the search deepens until either runs out
+    static const int32 AIDifficultyMaxDepths[] = {2, 4, 6};
+    static const int32 AIDifficultyTimeBudgetsMs[] = {250, 1000, 2500};
+    OutMaxDepth = AIDifficultyMaxDepths[static_cast<int32>(AIDifficulty)];
+    OutTimeBudgetMs = AIDifficultyTimeBudgetsMs[static_cast<int32>(AIDifficulty)];
 }
 
-TArray<FIntPoint> AChessGod::CalculateRandomAIMove(bool IsWhiteAI)
+int64 AChessGod::GetAIDifficultyNodeBudget(EAIDifficulty AIDifficulty)
 {
-    TArray<FIntPoint> Result;
+    // about the nodes the time budgets above buy on a desktop thread
+    static const int64 AIDifficultyNodeBudgets[] = {20000, 150000, 600000};
+    return AIDifficultyNodeBudgets[static_cast<int32>(AIDifficulty)];
+}
 
-    list<int32> PieceKeys = ActiveBoard->get_piece_keys(IsWhiteAI ? Cell::PieceColor::white : Cell::PieceColor::black);
-    list<int32> PieceKeysWithValidMoves;
+void AChessGod::CalculateRandomAIMove(bool IsWhiteAI, TArray<FIntPoint>& OutMove)
+{
+    // one pick among all legal moves of the side, from the move set the board's queries share
+    const TMap<FIntPoint, TArray<FIntPoint>>& MoveSet = ComputeLegalMoveSet(IsWhiteAI);
+    int32 MoveCount = 0;
+    for (const TPair<FIntPoint, TArray<FIntPoint>>& Pair : MoveSet)
+    {
+        MoveCount += Pair.Value.Num();
+    }
+    if (MoveCount == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Random AI has no legal move"));
+        return;
+    }
 
-    if (PieceKeys.size() == 0)
+    int32 Pick = AIRandom.RandRange(0, MoveCount - 1);
+    for (const TPair<FIntPoint, TArray<FIntPoint>>& Pair : MoveSet)
     {
-        UE_LOG(LogTemp, Error, TEXT("No pieces found for Random AI"));
-        return Result;
+        if (Pick < Pair.Value.Num())
+        {
+            OutMove.Add(Pair.Key);
+            OutMove.Add(Pair.Value[Pick]);
+            break;
+        }
+        Pick -= Pair.Value.Num();
+    }
+
+    OnAIFinishedCalculatingMove.Broadcast(OutMove[0], OutMove[1]);
+}
+
+void AChessGod::CalculateCopycatAIMove(bool IsWhiteAI, TArray<FIntPoint>& OutMove)
+{
+    // what the recorded players most often did here, and a shallow search where none of them has been
+    if (FindBookMove(CopycatBook, IsWhiteAI, true, OutMove))
+    {
+        MinimaxAIComponent->CancelSearch();
+        MctsAIComponent->CancelSearch();
+        OnAIFinishedCalculatingMove.Broadcast(OutMove[0], OutMove[1]);
+        return;
+    }
+    CalculateMinMaxAIMove(IsWhiteAI, EAIDifficulty::Easy, EParallelSearch::LazySMP, OutMove);
+}
+
+void AChessGod::CalculateMinMaxAIMove(bool IsWhiteAI, EAIDifficulty AIDifficulty, EParallelSearch ParallelSearch, TArray<FIntPoint>& OutMove)
+{
+    int32 MaxDepth = 0;
+    int32 TimeBudgetMs = 0;
+    GetAIDifficultyLimits(AIDifficulty, MaxDepth, TimeBudgetMs);
+    // a node budget alone, the clock would make the move depend on the machine again
+    const int64 NodeBudget = UseNodeBudgets ? GetAIDifficultyNodeBudget(AIDifficulty) : 0;
+    if (UseNodeBudgets)
+    {
+        TimeBudgetMs = 0;
+    }
+
+    UEvaluationWeights* const* EvaluationWeights = AIEvaluationWeights.Find(AIDifficulty);
+
+    // a book move is known before any search could finish, so it is played right away
+    if (AIDifficulty >= OpeningBookMinDifficulty && FindBookMove(OpeningBook, IsWhiteAI, false, OutMove))
+    {
+        MinimaxAIComponent->CancelSearch();
+        OnAIFinishedCalculatingMove.Broadcast(OutMove[0], OutMove[1]);
+        return;
     }
 
-    bool foundValidMove = false;
-    while (!foundValidMove) {
-        int32 RandomIndex = FMath::RandRange(0, PieceKeys.size() - 1);
-        int32 RandomPieceKey = *std::next(PieceKeys.begin(), RandomIndex);
-        auto PieceMoves = ActiveBoard->get_valid_moves(RandomPieceKey);
-        if (PieceMoves.size() > 0)
+    MctsAIComponent->CancelSearch();
+    MinimaxAIComponent->StartCalculatingMove(ActiveBoard, IsWhiteAI, MaxDepth, TimeBudgetMs, ParallelSearch, EvaluationWeights != nullptr ? *EvaluationWeights : nullptr, AIDifficulty, NodeBudget);
+}
+
+void AChessGod::CalculateMctsAIMove(bool IsWhiteAI, EAIDifficulty AIDifficulty)
+{
+    // the same think time as the minimax AI, the tree search has no depth to cap
+    int32 MaxDepth = 0;
+    int32 TimeBudgetMs = 0;
+    GetAIDifficultyLimits(AIDifficulty, MaxDepth, TimeBudgetMs);
+
+    UEvaluationWeights* const* EvaluationWeights = AIEvaluationWeights.Find(AIDifficulty);
+
+    // only one AI thinks at a time
+    MinimaxAIComponent->CancelSearch();
+    MctsAIComponent->StartCalculatingMove(ActiveBoard, IsWhiteAI, AIDifficulty, TimeBudgetMs, EvaluationWeights != nullptr ? *EvaluationWeights : nullptr, AIRandom.RandRange(1, MAX_int32));
+}
+
+bool AChessGod::FindBookMove(const FOpeningBook* Book, bool IsWhiteAI, bool IsMostWeighted, TArray<FIntPoint>& OutMove) const
+{
+    if (Book == nullptr || !Book->IsOpen() || ActiveBoard == nullptr)
+    {
+        return false;
+    }
+
+    PackedBoard Position = ActiveBoard->to_packed_board();
+    Position.set_white_to_move(IsWhiteAI);
+    const TConstArrayView<FOpeningBookEntry> Entries = Book->Find(Position.hash);
+    if (Entries.Num() == 0)
+    {
+        return false;
+    }
+
+    // a hash collision or a book built with other rules could suggest an illegal move, only legal ones are picked
+    MoveList Moves;
+    ActiveBoard->generate_legal_moves(Position, IsWhiteAI ? Cell::PieceColor::white : Cell::PieceColor::black, Moves);
+    TArray<const FOpeningBookEntry*, TInlineAllocator<16>> LegalEntries;
+    int32 TotalWeight = 0;
+    for (const FOpeningBookEntry& Entry : Entries)
+    {
+        const int32 From = PackedBoard::to_index(Entry.FromKey);
+        const int32 To = PackedBoard::to_index(Entry.ToKey);
+        for (const Move& Candidate : Moves)
         {
-            foundValidMove = true;
-            int32 RandomMoveIndex = FMath::RandRange(0, PieceMoves.size() - 1);
-            int32 RandomMoveKey = *std::next(PieceMoves.begin(), RandomMoveIndex);
-            Position FromPosition = ActiveBoard->to_position(RandomPieceKey);
-            Position ToPosition = ActiveBoard->to_position(RandomMoveKey);
+            if (Entry.Weight > 0 && Candidate.from == From && Candidate.to == To)
+            {
+                LegalEntries.Add(&Entry);
+                TotalWeight += Entry.Weight;
+                break;
+            }
+        }
+    }
+    if (TotalWeight == 0)
+    {
+        return false;
+    }
 
-            // ActiveBoard->move_piece(FromPosition, ToPosition);
+    if (IsMostWeighted)
+    {
+        const FOpeningBookEntry* Best = LegalEntries[0];
+        for (const FOpeningBookEntry* Entry : LegalEntries)
+        {
+            Best = Entry->Weight > Best->Weight ? Entry : Best;
+        }
+        OutMove.Add(KeyToCellPosition(Best->FromKey));
+        OutMove.Add(KeyToCellPosition(Best->ToKey));
+        return true;
+    }
 
-            Result.Add(FIntPoint{FromPosition.x, FromPosition.y});
-            Result.Add(FIntPoint{ToPosition.x, ToPosition.y});
+    int32 Pick = AIRandom.RandRange(0, TotalWeight - 1);
+    for (const FOpeningBookEntry* Entry : LegalEntries)
+    {
+        Pick -= Entry->Weight;
+        if (Pick < 0)
+        {
+            OutMove.Add(KeyToCellPosition(Entry->FromKey));
+            OutMove.Add(KeyToCellPosition(Entry->ToKey));
+            return true;
         }
     }
+    return false;
+}
+
+void AChessGod::RequestHint(bool IsWhitePlayer)
+{
+    if (ActiveBoard == nullptr || !AreThereValidMovesForPlayer(IsWhitePlayer))
+    {
+        return;
+    }
 
-    OnAIFinishedCalculatingMove.Broadcast(Result[0], Result[1]);
+    // the AI usually searched this position already, as a reply to its own move
+    FIntPoint From;
+    FIntPoint To;
+    if (MinimaxAIComponent->FindKnownMove(ActiveBoard, IsWhitePlayer, From, To))
+    {
+        OnHintReady.Broadcast(From, To);
+        return;
+    }
+    MinimaxAIComponent->StartHintSearch(ActiveBoard, IsWhitePlayer, HintTimeBudgetMs);
+}
 
+void AChessGod::PrewarmAI()
+{
+    // mapped at BeginPlay, but their pages are only read from disk by the first lookups
+    for (const FOpeningBook* Book : {OpeningBook, CopycatBook})
+    {
+        if (Book != nullptr && Book->IsOpen())
+        {
+            Book->Prefetch();
+        }
+    }
+
+    // the position every game starts from, the table keeps what the warm-up found about it
+    UHexaGameInstance* GameInstance = GetGameInstance<UHexaGameInstance>();
+    Board* WarmupBoard = GameInstance != nullptr ? GameInstance->AcquireBoard() : new Board();
+    WarmupBoard->set_position(Board::starting_position());
+    const EAIDifficulty Difficulty = GameInstance != nullptr ? GameInstance->AIDifficulty : EAIDifficulty::Hard;
+    const bool IsStarted = MinimaxAIComponent->StartPrewarm(WarmupBoard, true, Difficulty, PrewarmTimeBudgetMs);
+    if (GameInstance != nullptr)
+    {
+        GameInstance->ReleaseBoard(WarmupBoard);
+    }
+    else
+    {
+        delete WarmupBoard;
+    }
+    // a search already running warms everything the same way
+    if (!IsStarted)
+    {
+        OnAIPrewarmed.Broadcast();
+    }
+}
+
+TArray<FIntPoint> AChessGod::GetAttackedPieces(bool IsWhitePlayer)
+{
+    TArray<FIntPoint> Result;
+    FindAttackedPieces(IsWhitePlayer).GetKeys(Result);
     return Result;
 }
 
-TArray<FIntPoint> AChessGod::CalculateCopycatAIMove(bool IsWhiteAI)
+TArray<FIntPoint> AChessGod::GetHangingPieces(bool IsWhitePlayer)
 {
     TArray<FIntPoint> Result;
+    if (ActiveBoard == nullptr)
+    {
+        return Result;
+    }
+    const StaticExchange Exchange;
+    const int32 OpponentSide = IsWhitePlayer ? 1 : 0;
+    // the legal captures say which pieces can be taken at all, the exchange whether taking them pays
+    for (const TPair<FIntPoint, int32>& Attacked : FindAttackedPieces(IsWhitePlayer))
+    {
+        const int32 Index = ToCellIndex(Attacked.Key);
+        if (ActiveBoard->packed_board.cells[Index].get_piece_type() == Cell::PieceType::king)
+        {
+            continue;
+        }
+        if (Exchange.evaluate_cell(ActiveBoard->packed_board, Index, OpponentSide) > 0)
+        {
+            Result.Add(Attacked.Key);
+        }
+    }
     return Result;
 }
 
-TArray<FIntPoint> AChessGod::CalculateMinMaxAIMove(bool IsWhiteAI, EAIDifficulty AIDifficulty)
+void AChessGod::HighlightMovesForCell(AHexaGrid* Grid, FIntPoint InPosition)
 {
-    TArray<int32> AIDifficultyDepths = {2, 3, 4};
-    int32 Depth = AIDifficultyDepths[static_cast<int32>(AIDifficulty)];
+    if (Grid == nullptr)
+    {
+        return;
+    }
 
-    TArray<FIntPoint> Result;
+    TMap<FIntPoint, ETileState> States;
+    const int32 Index = ToCellIndex(InPosition);
+    if (ActiveBoard != nullptr && Index >= 0 && ActiveBoard->packed_board.get_square(Index).has_piece())
+    {
+        if (const TArray<FIntPoint>* Moves = FindMovesForCell(InPosition))
+        {
+            States.Reserve(Moves->Num() + 1);
+            for (const FIntPoint& Target : *Moves)
+            {
+                const int32 TargetIndex = ToCellIndex(Target);
+                const bool IsCapture = TargetIndex >= 0 && ActiveBoard->packed_board.get_square(TargetIndex).has_piece();
+                States.Add(Target, IsCapture ? ETileState::Attacked : ETileState::Highlighted);
+            }
+        }
+        States.Add(InPosition, ETileState::Selected);
+    }
+    Grid->ApplyTileStates(States);
+}
+
+void AChessGod::PrewarmPiecePool()
+{
+    TMap<EPieceType, int32> MissingPieces;
+    for (const FPieceInfo& PieceInfo : GetStartingPieces())
+    {
+        MissingPieces.FindOrAdd(PieceInfo.Type)++;
+    }
+    for (const APieceBase* Piece : FreePieces)
+    {
+        MissingPieces.FindOrAdd(Piece->Type)--;
+    }
+    for (const APieceBase* Piece : ActivePieces)
+    {
+        MissingPieces.FindOrAdd(Piece->Type)--;
+    }
+
+    for (const TPair<EPieceType, int32>& Missing : MissingPieces)
+    {
+        for (int32 Count = 0; Count < Missing.Value; Count++)
+        {
+            APieceBase* Piece = SpawnPooledPiece(Missing.Key);
+            if (Piece == nullptr)
+            {
+                break;
+            }
+            FreePieces.Add(Piece);
+        }
+    }
+}
+
+APieceBase* AChessGod::AcquirePiece(FPieceInfo PieceInfo)
+{
+    const int32 FreeIndex = FreePieces.IndexOfByPredicate([&PieceInfo](const APieceBase* Piece) { return Piece->Type == PieceInfo.Type; });
+    APieceBase* Piece = FreeIndex != INDEX_NONE ? FreePieces[FreeIndex] : SpawnPooledPiece(PieceInfo.Type);
+    if (Piece == nullptr)
+    {
+        return nullptr;
+    }
+    if (FreeIndex != INDEX_NONE)
+    {
+        FreePieces.RemoveAtSwap(FreeIndex);
+    }
+
+    Piece->GridX = PieceInfo.X;
+    Piece->GridY = PieceInfo.Y;
+    Piece->ColorID = PieceInfo.TeamID;
+    Piece->SetColor(PieceInfo.TeamID);
+    Piece->SetPooled(false);
+    ActivePieces.Add(Piece);
+    return Piece;
+}
+
+void AChessGod::ReleasePiece(APieceBase* Piece)
+{
+    if (Piece == nullptr || ActivePieces.RemoveSwap(Piece) == 0)
+    {
+        return;
+    }
+    Piece->SetPooled(true);
+    FreePieces.Add(Piece);
+}
+
+void AChessGod::ReleaseAllPieces()
+{
+    for (APieceBase* Piece : ActivePieces)
+    {
+        Piece->SetPooled(true);
+    }
+    FreePieces.Append(ActivePieces);
+    ActivePieces.Reset();
+}
+
+void AChessGod::PlaceStartingPieces(AHexaGrid* Grid)
+{
+    // pieces already standing on their starting cell stay untouched; a second piece on a cell, one whose capture was still playing, is free to move
+    TMap<FIntPoint, APieceBase*> Standing;
+    TArray<APieceBase*, TInlineAllocator<64>> Unused;
+    for (APieceBase* Piece : ActivePieces)
+    {
+        const FIntPoint Cell(Piece->GridX, Piece->GridY);
+        if (Standing.Contains(Cell))
+        {
+            Unused.Add(Piece);
+        }
+        else
+        {
+            Standing.Add(Cell, Piece);
+        }
+    }
+    TArray<FPieceInfo, TInlineAllocator<64>> Missing;
+    for (const FPieceInfo& PieceInfo : GetStartingPieces())
+    {
+        const FIntPoint Cell(PieceInfo.X, PieceInfo.Y);
+        APieceBase* const* Kept = Standing.Find(Cell);
+        if (Kept != nullptr && (*Kept)->Type == PieceInfo.Type && (*Kept)->ColorID == PieceInfo.TeamID)
+        {
+            Standing.Remove(Cell);
+        }
+        else
+        {
+            Missing.Add(PieceInfo);
+        }
+    }
+    for (const TPair<FIntPoint, APieceBase*>& Moved : Standing)
+    {
+        Unused.Add(Moved.Value);
+    }
+
+    for (const FPieceInfo& PieceInfo : Missing)
+    {
+        // a piece of the same kind standing elsewhere moves over, the pool only covers the captured ones
+        const int32 UnusedIndex = Unused.IndexOfByPredicate([&PieceInfo](const APieceBase* Piece) { return Piece->Type == PieceInfo.Type && Piece->ColorID == PieceInfo.TeamID; });
+        APieceBase* Piece = nullptr;
+        if (UnusedIndex != INDEX_NONE)
+        {
+            Piece = Unused[UnusedIndex];
+            Unused.RemoveAtSwap(UnusedIndex);
+        }
+        else
+        {
+            Piece = AcquirePiece(PieceInfo);
+            if (Piece == nullptr)
+            {
+                continue;
+            }
+        }
+        const FIntPoint Tile(PieceInfo.X, PieceInfo.Y);
+        Piece->GridX = Tile.X;
+        Piece->GridY = Tile.Y;
+        Piece->SetActorLocation(Grid->GetTileWorldLocation(Tile));
+    }
 
-    MinimaxAIComponent->StartCalculatingMove(ActiveBoard, IsWhiteAI, Depth);
+    for (APieceBase* Piece : Unused)
+    {
+        ReleasePiece(Piece);
+    }
+}
 
+APieceBase* AChessGod::SpawnPooledPiece(EPieceType Type)
+{
+    const TSubclassOf<APieceBase>* PieceClass = PieceClasses.Find(Type);
+    if (PieceClass == nullptr || *PieceClass == nullptr)
+    {
+        return nullptr;
+    }
+
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.Owner = this;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    APieceBase* Piece = GetWorld()->SpawnActor<APieceBase>(*PieceClass, GetActorTransform(), SpawnParameters);
+    if (Piece == nullptr)
+    {
+        return nullptr;
+    }
+    Piece->Type = Type;
+    // parking creates the physics state now instead of at the first capture
+    Piece->SetPooled(true);
+    return Piece;
+}
+
+TMap<FIntPoint, int32> AChessGod::FindAttackedPieces(bool IsWhitePlayer)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ChessGod_FindAttackedPieces);
+    TMap<FIntPoint, int32> Result;
+    if (ActiveBoard == nullptr)
+    {
+        return Result;
+    }
+
+    // a pinned piece does not attack, so the opponent's legal moves say more than the attack maps would
+    const PackedBoard& Position = ActiveBoard->packed_board;
+    const Cell::PieceColor Player = IsWhitePlayer ? Cell::PieceColor::white : Cell::PieceColor::black;
+    for (const TPair<FIntPoint, TArray<FIntPoint>>& Pair : ComputeLegalMoveSet(!IsWhitePlayer))
+    {
+        const Cell::PieceType AttackerType = Position.cells[ToCellIndex(Pair.Key)].get_piece_type();
+        const int32 Value = Board::piece_values[AttackerType];
+        for (const FIntPoint& Target : Pair.Value)
+        {
+            const Square Victim = Position.cells[ToCellIndex(Target)];
+            if (!Victim.has_piece() || Victim.get_piece_color() != Player)
+            {
+                continue;
+            }
+            int32* Cheapest = Result.Find(Target);
+            if (Cheapest == nullptr)
+            {
+                Result.Add(Target, Value);
+            }
+            else
+            {
+                *Cheapest = FMath::Min(*Cheapest, Value);
+            }
+        }
+    }
     return Result;
 }
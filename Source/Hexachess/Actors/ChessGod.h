@@ -2,13 +2,24 @@
 
 #include "CoreMinimal.h"
 
+#include "Actors/PieceBase.h"
+#include "Chess/MctsAI.h"
 #include "Chess/MinimaxAI.h"
 #include "Types/PieceInfo.h"
 #include "Types/AIType.h"
+#include "Types/TurnState.h"
 
 #include "ChessGod.generated.h"
 
+class AHexaGrid;
 class Board;
+struct PackedBoard;
+class BitboardPosition;
+class FOpeningBook;
+class UHexaSaveGame;
+class SpectatorLog;
+class UEvaluationWeights;
+struct FLegalityJob;
 
 
 UCLASS(Blueprintable, BlueprintType)
@@ -23,8 +34,99 @@ public:
 	UPROPERTY(BlueprintReadWrite)
 	UMinimaxAIComponent* MinimaxAIComponent;
 
+	UPROPERTY(BlueprintReadWrite)
+	UMctsAIComponent* MctsAIComponent;
+
+	/*
+	 * Answers the synchronous move and attack queries (GetMovesForCell, IsCellUnderAttack, AreThereValidMovesForPlayer and
+	 * the rest built on the legal move sets) with the bitboard engine core instead of Board. Takes effect at the next game.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Engine")
+	bool UseBitboardEngine = false;
+
+	/*
+	 * Plies without a capture or pawn move after which the game is drawn, 100 for the fifty-move rule; 0 turns the rule off.
+	 * The minimax AI's search scores the positions the rule ends as draws too.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules", meta = (ClampMin = "0"))
+	int32 FiftyMovePlies = 100;
+
+	/*
+	 * Evaluation weights the minimax AI plays with at each difficulty; a difficulty without an asset uses the board's own evaluation.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	TMap<EAIDifficulty, UEvaluationWeights*> AIEvaluationWeights;
+
+	/*
+	 * Opening book the minimax AI plays from before it searches, relative to the content directory; built by the OpeningBook commandlet.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	FString OpeningBookPath = TEXT("Books/OpeningBook.hxbook");
+
+	/*
+	 * Lower difficulties always search, so the book does not make an easy AI play like a strong one.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	EAIDifficulty OpeningBookMinDifficulty = EAIDifficulty::Medium;
+
+	/*
+	 * Move frequencies of recorded games the copycat AI plays from, relative to the content directory; built by the CopycatBook commandlet.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	FString CopycatBookPath = TEXT("Books/CopycatBook.hxbook");
+
+	/*
+	 * Writes the move record of every game to Saved/Games when it ends, for the CopycatBook commandlet to learn from.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool RecordGames = false;
+
+	/*
+	 * The minimax AI's difficulty is a node budget instead of a think time: it plays the same moves on every machine, weak ones only take longer.
+	 * It searches on one thread, does not ponder and starts every game with a cold table then.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UseNodeBudgets = false;
+
+	/*
+	 * Seeds the AI's random picks (book moves, the random AI, tree search playouts) at the start of each game; 0 picks a new seed every game.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 AISeed = 0;
+
+	/*
+	 * Think time of the hint search, for the positions the AI's own searches know nothing about yet.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 HintTimeBudgetMs = 250;
+
+	/*
+	 * Calls PrewarmAI at BeginPlay, while a loading screen waiting for a manual stop is still up.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool PrewarmAIOnBeginPlay = true;
+
+	/*
+	 * Think time of the warm-up search; long enough for every search thread to start and the first depths to fill the table.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (ClampMin = "1"))
+	int32 PrewarmTimeBudgetMs = 200;
+
+	/*
+	 * Moves between two whole positions in the spectator stream; a spectator joining mid-game replays at most this many moves.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Spectators", meta = (ClampMin = "1"))
+	int32 SpectatorKeyframeInterval = 32;
+
+	/*
+	 * Actor class of each piece type; the pool spawns them when the actor begins play and hands the same ones out for every game.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pieces")
+	TMap<EPieceType, TSubclassOf<APieceBase>> PieceClasses;
+
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
 
     // main flow
 
@@ -34,6 +136,15 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual void EndGame();
 
+	/*
+	 * A rematch on the current game's boards: the starting position is copied onto them, the AI's table and the opening books
+	 * stay warm, and with a Grid the piece actors move to their starting cells, the ones already there untouched and the pool
+	 * covering what was captured. Nothing is allocated or spawned once the pool holds a full set.
+	 * Without a board, or with UseBitboardEngine changed since, it is EndGame, StartGame and RegisterStartingPieces.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void ResetToStartingPosition(AHexaGrid* Grid);
+
 	// game logic
 
 	UFUNCTION(BlueprintCallable)
@@ -42,11 +153,180 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual void RegisterPiece(FPieceInfo PieceInfo);
 
+	/*
+	 * RegisterPiece for a whole list of pieces, with one cache invalidation at the end.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void RegisterPieces(const TArray<FPieceInfo>& Pieces);
+
+	/*
+	 * Fills the logical board with the standard setup in one copy; the level still spawns the piece actors from GetStartingPieces.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void RegisterStartingPieces();
+
+	/*
+	 * The standard Glinski setup as a list of RegisterPiece calls, white (TeamID 0) at the bottom of each column.
+	 */
+	UFUNCTION(BlueprintPure)
+	static TArray<FPieceInfo> GetStartingPieces();
+
+	/*
+	 * Every piece of a position as RegisterPiece takes them, in cell order.
+	 */
+	static TArray<FPieceInfo> GetPositionPieces(const PackedBoard& InPosition);
+
+	/*
+	 * What RegisterPiece does to the logical board, for code that runs without a game (commandlets).
+	 */
+	static void PlacePiece(Board* InBoard, const FPieceInfo& PieceInfo);
+
 	UFUNCTION(BlueprintCallable)
 	virtual TArray<FIntPoint> GetMovesForCell(FIntPoint InPosition);
 
+	/*
+	 * GetMovesForCell into an array the caller keeps between calls, so a query on every hovered frame reuses its memory.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void FillMovesForCell(FIntPoint InPosition, UPARAM(ref) TArray<FIntPoint>& Moves);
+
+	/*
+	 * The cell's moves in the cached legal move set, without a copy; null for an empty cell or one without moves.
+	 * Valid until the position changes.
+	 */
+	const TArray<FIntPoint>* FindMovesForCell(FIntPoint InPosition);
+
+	/*
+	 * Plays a move of the cached legal move set; false, with nothing played, without a board or for a move that is not legal.
+	 */
 	UFUNCTION(BlueprintCallable )
-	virtual void MovePiece(FIntPoint From, FIntPoint To);
+	virtual bool MovePiece(FIntPoint From, FIntPoint To);
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPawnTakenEnPassant, FIntPoint, Cell);
+
+	/*
+	 * Raised by MovePiece when the move took a pawn en passant: the taken pawn stood on Cell, not on the move's target.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnPawnTakenEnPassant OnPawnTakenEnPassant;
+
+	/*
+	 * Takes back the last move played with MovePiece; it can be played again with RedoMove until another move is played.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual bool UndoMove();
+
+	UFUNCTION(BlueprintCallable)
+	virtual bool RedoMove();
+
+	/*
+	 * The moves played since the pieces were registered, two bytes per move; LoadMoveRecord replays them after a desync.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual TArray<uint8> GetMoveRecord() const;
+
+	/*
+	 * Takes back every played move and replays the record from the registered pieces; false, with the board untouched, if a move of it is not legal.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual bool LoadMoveRecord(const TArray<uint8>& MoveRecord);
+
+	/*
+	 * How often the current position, side to move included, was on the board before; 2 means a threefold repetition.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual int32 GetRepetitionCount() const;
+
+	/*
+	 * How many moves were played since the last capture or pawn move; only the moves of the current history count.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual int32 GetReversiblePlies() const;
+
+	/*
+	 * The draw the current position ends the game with: Repetition on its third occurrence, FiftyMoves once FiftyMovePlies
+	 * reversible plies were played, None otherwise. Checkmate and stalemate come from the legal moves, not from here.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual EGameOutcome GetDrawOutcome() const;
+
+	/*
+	 * The logical position, for code that keeps a copy of it in step such as the network move channel; null before CreateLogicalBoard.
+	 */
+	const PackedBoard* GetPosition() const;
+
+	/*
+	 * How many moves of the history are played; GetMoveRecord holds two bytes for each.
+	 */
+	int32 GetPlayedMoveCount() const;
+
+	/*
+	 * LoadPosition for a position that is already decoded, pawn shadow included; a new move history starts from it.
+	 * False, with the board untouched, when the shadow is not a cell a pawn of the side that just moved could have jumped over.
+	 */
+	bool SyncPosition(const PackedBoard& InPosition);
+
+	/*
+	 * The current position, side to move included, in 46 bytes; no move history is kept with it.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual TArray<uint8> SavePosition() const;
+
+	/*
+	 * Replaces the whole logical board with a position from SavePosition and starts a new move history; false if the bytes are not a position.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual bool LoadPosition(const TArray<uint8>& PositionBytes);
+
+	/*
+	 * The current position as text, a FEN-like column list readable by LoadPositionText.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual FString SavePositionText() const;
+
+	UFUNCTION(BlueprintCallable)
+	virtual bool LoadPositionText(const FString& PositionText);
+
+	/*
+	 * The current game as a save game: the position its move history starts from and the moves played since; null without a board.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual UHexaSaveGame* CreateSaveGame() const;
+
+	/*
+	 * Puts a saved game on the logical board in one go, with a single cache invalidation; false if it does not fit the board.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual bool LoadSaveGame(const UHexaSaveGame* SaveGame);
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGameSaved, const FString&, SlotName, bool, IsSaved);
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGameLoaded, const FString&, SlotName, bool, IsLoaded);
+
+	/*
+	 * Writes the current game to a save slot, answered through OnGameSaved; only the encoding runs on the game thread, the disk write does not.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void SaveGameAsync(const FString& SlotName, int32 UserIndex = 0);
+
+	/*
+	 * Reads a save slot off the game thread, then loads it with LoadSaveGame and answers through OnGameLoaded.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void LoadGameAsync(const FString& SlotName, int32 UserIndex = 0);
+
+	UPROPERTY(BlueprintAssignable)
+	FOnGameSaved OnGameSaved;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnGameLoaded OnGameLoaded;
+
+	/*
+	 * The spectator stream from FromOffset on: every move played, with the whole position after every SpectatorKeyframeInterval moves
+	 * and wherever the game jumps (a new game, an undo, a loaded position). A negative FromOffset joins at the last whole position.
+	 * OutNextOffset is where the next read carries on; the bytes are read back with SpectatorReader.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual TArray<uint8> ReadSpectatorStream(int32 FromOffset, int32& OutNextOffset);
 
 	UFUNCTION(BlueprintCallable)
 	virtual bool IsCellUnderAttack(FIntPoint InPosition);
@@ -57,6 +337,73 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual TArray<FIntPoint> GetValidMovesForPlayer(bool IsWhitePlayer);
 
+	UFUNCTION(BlueprintCallable)
+	virtual void FillValidMovesForPlayer(bool IsWhitePlayer, UPARAM(ref) TArray<FIntPoint>& Moves);
+
+	/*
+	 * Whether the side's king is attacked in the current position, from the same cache as the move queries.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual bool IsPlayerInCheck(bool IsWhitePlayer);
+
+	/*
+	 * The cells of the side's pieces that have at least one legal move, for highlighting what can be picked up.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual TArray<FIntPoint> GetMovableCellsForPlayer(bool IsWhitePlayer);
+
+	UFUNCTION(BlueprintCallable)
+	virtual void FillMovableCellsForPlayer(bool IsWhitePlayer, UPARAM(ref) TArray<FIntPoint>& Cells);
+
+	/*
+	 * Every legal move of a side by the cell it starts from, generated once per position and kept until the position changes;
+	 * GetMovesForCell, AreThereValidMovesForPlayer, GetValidMovesForPlayer and IsPlayerInCheck all read it.
+	 */
+	const TMap<FIntPoint, TArray<FIntPoint>>& ComputeLegalMoveSet(bool IsWhite);
+
+	// ComputeLegalMoveSet's calls, and the time of the ones that generated the move set, since they were last reset
+	struct FLegalityQueryStats
+	{
+		int32 Count = 0;
+		int32 Misses = 0;
+		double Seconds = 0.0;
+	};
+
+	/*
+	 * Counted on the game thread for the match capture, which reads and resets it every turn.
+	 */
+	FLegalityQueryStats LegalityQueryStats;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnLegalityComputed, bool, IsWhitePlayer, bool, HasValidMoves, bool, IsInCheck);
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnCellAttackComputed, FIntPoint, Cell, bool, IsUnderAttack);
+
+	/*
+	 * AreThereValidMovesForPlayer and IsPlayerInCheck computed on a worker, answered through OnLegalityComputed.
+	 * Answers at once when the position's move set is already cached; requests for a position that is already being computed share that computation.
+	 * A request is dropped without an answer when the position changes before it is done.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void RequestLegalityAsync(bool IsWhitePlayer);
+
+	/*
+	 * IsCellUnderAttack computed on a worker for the same position as RequestLegalityAsync, answered through OnCellAttackComputed.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void RequestCellUnderAttackAsync(FIntPoint InPosition);
+
+	UPROPERTY(BlueprintAssignable)
+	FOnLegalityComputed OnLegalityComputed;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnCellAttackComputed OnCellAttackComputed;
+
+	/*
+	 * Shows how many pieces of each side attack every tile on the grid, updated once per position with the attack map the
+	 * legality job builds on a worker anyway; null turns the heatmap off and clears the previous grid.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void SetThreatHeatmapGrid(AHexaGrid* Grid);
+
 	// ai logic
 
 	/*
@@ -65,6 +412,22 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual TArray<FIntPoint> MakeAIMove(bool IsWhiteAI, EAIType AIType, EAIDifficulty AIDifficulty);
 
+	/*
+	 * MakeAIMove into an array the caller keeps; it is left empty when the move comes later through OnAIFinishedCalculatingMove.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void FillAIMove(bool IsWhiteAI, EAIType AIType, EAIDifficulty AIDifficulty, UPARAM(ref) TArray<FIntPoint>& Move);
+
+	/*
+	 * How deep and how long the minimax AI searches at a difficulty; the search deepens until either runs out.
+	 */
+	static void GetAIDifficultyLimits(EAIDifficulty AIDifficulty, int32& OutMaxDepth, int32& OutTimeBudgetMs);
+
+	/*
+	 * The nodes the minimax AI searches at a difficulty when UseNodeBudgets is set; the depth cap of GetAIDifficultyLimits still applies.
+	 */
+	static int64 GetAIDifficultyNodeBudget(EAIDifficulty AIDifficulty);
+
 
 	// TODO: fix this flow!
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnAIFinishedCalculatingMove, FIntPoint, From, FIntPoint, To);
@@ -72,11 +435,180 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnAIFinishedCalculatingMove OnAIFinishedCalculatingMove;
 
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAIFinishedAnalysis, const TArray<FSearchLine>&, Lines);
+
+	/*
+	 * Raised by the minimax AI just before OnAIFinishedCalculatingMove: the principal variation of the move it chose,
+	 * then the best lines starting with other moves when its MultiPV asks for more than one.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnAIFinishedAnalysis OnAIFinishedAnalysis;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnAIPrewarmed);
+
+	/*
+	 * Pays the minimax AI's first-move costs up front: reads the books' pages, loads the network, maps the tablebase files and
+	 * runs a short search of the starting position on every search thread, which allocates the transposition table and the
+	 * evaluation caches and leaves the first move's lines in the table. OnAIPrewarmed follows once it is done; a level holding
+	 * its loading screen up can stop it then.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void PrewarmAI();
+
+	UPROPERTY(BlueprintAssignable)
+	FOnAIPrewarmed OnAIPrewarmed;
+
+	// analysis for the player
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHintReady, FIntPoint, From, FIntPoint, To);
+
+	/*
+	 * The best move for a player, answered through OnHintReady: at once when the minimax AI's table or ponder search already knows the position,
+	 * otherwise after a background search of HintTimeBudgetMs that fills the same table. Dropped when the position changes first.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void RequestHint(bool IsWhitePlayer);
+
+	UPROPERTY(BlueprintAssignable)
+	FOnHintReady OnHintReady;
+
+	/*
+	 * The player's pieces that one of the opponent's legal moves captures; read from the opponent's cached move set.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual TArray<FIntPoint> GetAttackedPieces(bool IsWhitePlayer);
+
+	/*
+	 * The attacked pieces the opponent wins material on by the static exchange evaluation, recaptures and x-ray attackers included. The king is never hanging.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual TArray<FIntPoint> GetHangingPieces(bool IsWhitePlayer);
+
+	/*
+	 * Shows the moves of the piece on InPosition on the grid: its cell selected, quiet moves highlighted and captures attacked; an empty cell clears the grid.
+	 * Reads the cached legal move set and only rewrites the tiles whose state changes, so it can run on every hover.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void HighlightMovesForCell(AHexaGrid* Grid, FIntPoint InPosition);
+
+	// piece pool
+
+	/*
+	 * Spawns the pieces of a full starting setup, parked, so neither a capture nor a rematch spawns an actor or builds a physics state mid-game.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void PrewarmPiecePool();
+
+	/*
+	 * A piece of the type and team of PieceInfo with its cell set, from the pool when it has one; the caller places it. Null when the type has no class.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual APieceBase* AcquirePiece(FPieceInfo PieceInfo);
+
+	/*
+	 * Parks a piece for the next game, once its capture destruction has played.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void ReleasePiece(APieceBase* Piece);
+
+	/*
+	 * ReleasePiece for every piece handed out, before setting up a rematch.
+	 */
+	UFUNCTION(BlueprintCallable)
+	virtual void ReleaseAllPieces();
+
 private:
 
-	TArray<FIntPoint> CalculateRandomAIMove(bool IsWhiteAI);
-	TArray<FIntPoint> CalculateCopycatAIMove(bool IsWhiteAI);
-	TArray<FIntPoint> CalculateMinMaxAIMove(bool IsWhiteAI, EAIDifficulty AIDifficulty);
+	// each adds the move to the empty OutMove when it is known at once, and leaves it empty when a search will report it
+	void CalculateRandomAIMove(bool IsWhiteAI, TArray<FIntPoint>& OutMove);
+	void CalculateCopycatAIMove(bool IsWhiteAI, TArray<FIntPoint>& OutMove);
+	void CalculateMinMaxAIMove(bool IsWhiteAI, EAIDifficulty AIDifficulty, EParallelSearch ParallelSearch, TArray<FIntPoint>& OutMove);
+	void CalculateMctsAIMove(bool IsWhiteAI, EAIDifficulty AIDifficulty);
+
+	// a weighted pick among the book's legal moves for the position, or its most weighted one; false when the book does not know the position
+	bool FindBookMove(const FOpeningBook* Book, bool IsWhiteAI, bool IsMostWeighted, TArray<FIntPoint>& OutMove) const;
+
+	// the player's attacked pieces with the value of the cheapest opponent piece that can capture each
+	TMap<FIntPoint, int32> FindAttackedPieces(bool IsWhitePlayer);
+
+	// one side's legal moves in the current position, built on first use
+	struct FLegalMoveSet
+	{
+		bool IsValid = false;
+		bool IsInCheck = false;
+		TMap<FIntPoint, TArray<FIntPoint>> Moves;
+	};
+
+	// hands the board back to the game instance's pool, or deletes it when there is no game instance; the bitboard is deleted
+	void ReleaseLogicalBoard();
+
+	// copies ActiveBoard's position onto the bitboard, when there is one
+	void ReloadBitboard();
+
+	// writes the game's moves to Saved/Games when RecordGames is set
+	void RecordGame() const;
+
+	// the AI state a new game starts with: no search running, the random picks reseeded, and a cleared table with node budgets
+	void ResetAIForNewGame();
+
+	// moves the handed out pieces to the starting setup on the grid, acquiring the missing ones and releasing the rest
+	void PlaceStartingPieces(AHexaGrid* Grid);
+
+	// called by everything that changes the position
+	void InvalidateLegalMoveSets();
+
+	// puts a decoded position on the logical boards
+	void ReplacePosition(const PackedBoard& InPosition);
+
+	// brings the caches and the AI in line after the position changed other than through MovePiece
+	void OnPositionReplaced();
+
+	// appends the current position to the spectator stream
+	void WriteSpectatorKeyframe();
+
+	// the job of the current position, started when there is none; null without a board
+	FLegalityJob* GetLegalityJob();
+
+	// copies a finished job's move sets into the cache and answers every request queued on it
+	void FinishLegalityJob();
 
 	Board* ActiveBoard = nullptr;
+	// a copy of ActiveBoard's position when UseBitboardEngine was set at CreateLogicalBoard, null otherwise
+	BitboardPosition* ActiveBitboard = nullptr;
+
+	// white's and black's, only the game thread reads or writes them
+	FLegalMoveSet LegalMoveSets[2];
+
+	// the async move sets and attacks of the current position, kept once finished to answer later requests
+	TSharedPtr<FLegalityJob, ESPMode::ThreadSafe> LegalityJob;
+
+	// move rules for the legality jobs, which own their positions; shared so a job can outlive the actor
+	TSharedPtr<Board, ESPMode::ThreadSafe> LegalityRules;
+
+	// while set, every position gets a legality job and its attack map is shown on this grid
+	UPROPERTY()
+	AHexaGrid* ThreatHeatmapGrid = nullptr;
+
+	// opened in BeginPlay and kept for every game the actor hosts
+	FOpeningBook* OpeningBook = nullptr;
+	FOpeningBook* CopycatBook = nullptr;
+
+	// the spectator stream of every game the actor hosts, opened in BeginPlay
+	SpectatorLog* Spectators = nullptr;
+
+	// pieces were registered one by one since the last keyframe, the stream gets the position once before it is read or played on
+	bool IsSpectatorKeyframeDue = false;
+
+	// the AI's random picks, seeded from AISeed when the logical board is created
+	FRandomStream AIRandom;
+
+	// a parked piece of the type, or null when the type has no class
+	APieceBase* SpawnPooledPiece(EPieceType Type);
+
+	// parked pieces, and the ones AcquirePiece handed out
+	UPROPERTY()
+	TArray<APieceBase*> FreePieces;
+
+	UPROPERTY()
+	TArray<APieceBase*> ActivePieces;
 };
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "HexaGrid.h"
+
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+
+#include "Chess/CellIndex.h"
+#include "Chess/ChessEngine.h"
+
+AHexaGrid::AHexaGrid()
+{
+    PrimaryActorTick.bCanEverTick = false;
+
+    TileInstances = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("TileInstances"));
+    // the tile state, then the white and the black attacker counts of the threat heatmap
+    TileInstances->NumCustomDataFloats = 3;
+    TileInstances->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+    RootComponent = TileInstances;
+}
+
+void AHexaGrid::OnConstruction(const FTransform& Transform)
+{
+    Super::OnConstruction(Transform);
+
+    GenerateGrid();
+}
+
+void AHexaGrid::GenerateGrid()
+{
+    TileInstances->ClearInstances();
+    TileInstances->SetStaticMesh(TileMesh);
+    // hover and clicks can pick with FindTileUnderCursor instead, then the tiles need no physics state at all
+    TileInstances->SetCollisionEnabled(UseTileCollision ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+
+    TileInstanceIds.Init(INDEX_NONE, Width * Height);
+    InstanceStates.Reset();
+    TileLocations.Init(FVector::ZeroVector, Width * Height);
+    PickingCells.Reset();
+
+    TArray<FTransform> Transforms;
+    TArray<FIntPoint> Tiles;
+    for (int32 Y = 0; Y < Height; Y++)
+    {
+        for (int32 X = 0; X < Width; X++)
+        {
+            const FIntPoint Tile(X, Y);
+            if (IsTileOnBoard(Tile))
+            {
+                const FVector Location = GetTileLocation(Tile);
+                TileLocations[Y * Width + X] = Location;
+                PickingCells.FindOrAdd(GetPickingCell(Location)).Add(Tile);
+                Transforms.Add(FTransform(Location));
+                Tiles.Add(Tile);
+            }
+        }
+    }
+
+    // added in one go so the instance tree is built once
+    const TArray<int32> InstanceIds = TileInstances->AddInstances(Transforms, true);
+    for (int32 Index = 0; Index < InstanceIds.Num(); Index++)
+    {
+        TileInstanceIds[Tiles[Index].Y * Width + Tiles[Index].X] = InstanceIds[Index];
+    }
+    InstanceStates.Init(ETileState::None, TileInstances->GetInstanceCount());
+    InstanceHeat.Init(0, TileInstances->GetInstanceCount());
+}
+
+bool AHexaGrid::IsTileOnBoard(FIntPoint Tile) const
+{
+    return ToCellIndex(Tile) >= 0;
+}
+
+FVector AHexaGrid::GetTileLocation(FIntPoint Tile) const
+{
+    // the columns get shorter away from the middle one, each step moves their bottom tile up by half a tile
+    const float ColumnOffset = FMath::Abs(Tile.X - HexIndexTable::columns / 2) * 0.5f;
+    return FVector(Tile.X * TileSize * UE_HALF_SQRT_3, (Tile.Y + ColumnOffset) * TileSize, 0.0f);
+}
+
+FVector AHexaGrid::GetTileWorldLocation(FIntPoint Tile) const
+{
+    // tiles off the table, or before the first GenerateGrid, fall back to the layout math
+    const bool IsInTable = GetTileInstance(Tile) != INDEX_NONE;
+    return GetActorTransform().TransformPosition(IsInTable ? TileLocations[Tile.Y * Width + Tile.X] : GetTileLocation(Tile));
+}
+
+bool AHexaGrid::FindTileAtWorldLocation(FVector WorldLocation, FIntPoint& OutTile) const
+{
+    return FindTileAtLocation(GetActorTransform().InverseTransformPosition(WorldLocation), OutTile);
+}
+
+bool AHexaGrid::FindTileUnderRay(FVector RayOrigin, FVector RayDirection, FIntPoint& OutTile) const
+{
+    // the tiles' centers lie on the grid's own XY plane
+    const FTransform& Transform = GetActorTransform();
+    const FVector Origin = Transform.InverseTransformPosition(RayOrigin);
+    const FVector Direction = Transform.InverseTransformVector(RayDirection);
+    if (FMath::IsNearlyZero(Direction.Z))
+    {
+        return false;
+    }
+    const float Distance = -Origin.Z / Direction.Z;
+    if (Distance < 0.0f)
+    {
+        return false;
+    }
+    return FindTileAtLocation(Origin + Direction * Distance, OutTile);
+}
+
+bool AHexaGrid::FindTileUnderCursor(const APlayerController* PlayerController, FIntPoint& OutTile) const
+{
+    FVector RayOrigin;
+    FVector RayDirection;
+    if (PlayerController == nullptr || !PlayerController->DeprojectMousePositionToWorld(RayOrigin, RayDirection))
+    {
+        return false;
+    }
+    return FindTileUnderRay(RayOrigin, RayDirection, OutTile);
+}
+
+bool AHexaGrid::FindTileAtLocation(const FVector& Location, FIntPoint& OutTile) const
+{
+    const FIntPoint Cell = GetPickingCell(Location);
+
+    // nearest center is the hex the point is in, as far out as the hex's corners
+    float BestDistanceSquared = FMath::Square(TileSize / UE_SQRT_3);
+    bool IsFound = false;
+    for (int32 CellY = Cell.Y - 1; CellY <= Cell.Y + 1; CellY++)
+    {
+        for (int32 CellX = Cell.X - 1; CellX <= Cell.X + 1; CellX++)
+        {
+            const TArray<FIntPoint>* Tiles = PickingCells.Find(FIntPoint(CellX, CellY));
+            if (Tiles == nullptr)
+            {
+                continue;
+            }
+            for (const FIntPoint& Tile : *Tiles)
+            {
+                const float DistanceSquared = FVector2D::DistSquared(FVector2D(Location), FVector2D(TileLocations[Tile.Y * Width + Tile.X]));
+                if (DistanceSquared <= BestDistanceSquared)
+                {
+                    BestDistanceSquared = DistanceSquared;
+                    OutTile = Tile;
+                    IsFound = true;
+                }
+            }
+        }
+    }
+    return IsFound;
+}
+
+FIntPoint AHexaGrid::GetPickingCell(const FVector& Location) const
+{
+    return FIntPoint(FMath::FloorToInt(Location.X / TileSize), FMath::FloorToInt(Location.Y / TileSize));
+}
+
+int32 AHexaGrid::GetTileInstance(FIntPoint Tile) const
+{
+    if (Tile.X < 0 || Tile.Y < 0 || Tile.X >= Width || Tile.Y >= Height || TileInstanceIds.Num() != Width * Height)
+    {
+        return INDEX_NONE;
+    }
+    return TileInstanceIds[Tile.Y * Width + Tile.X];
+}
+
+void AHexaGrid::SetTileState(FIntPoint Tile, ETileState State)
+{
+    if (WriteInstanceState(GetTileInstance(Tile), State))
+    {
+        TileInstances->MarkRenderStateDirty();
+    }
+}
+
+void AHexaGrid::SetTileStates(const TArray<FIntPoint>& Tiles, ETileState State)
+{
+    bool IsChanged = false;
+    for (const FIntPoint& Tile : Tiles)
+    {
+        IsChanged |= WriteInstanceState(GetTileInstance(Tile), State);
+    }
+    if (IsChanged)
+    {
+        TileInstances->MarkRenderStateDirty();
+    }
+}
+
+void AHexaGrid::ClearTileStates()
+{
+    ApplyTileStates(TMap<FIntPoint, ETileState>());
+}
+
+void AHexaGrid::ApplyTileStates(const TMap<FIntPoint, ETileState>& States)
+{
+    TArray<ETileState, TInlineAllocator<128>> NewStates;
+    NewStates.Init(ETileState::None, InstanceStates.Num());
+    for (const TPair<FIntPoint, ETileState>& Pair : States)
+    {
+        const int32 InstanceId = GetTileInstance(Pair.Key);
+        if (InstanceId != INDEX_NONE)
+        {
+            NewStates[InstanceId] = Pair.Value;
+        }
+    }
+
+    bool IsChanged = false;
+    for (int32 InstanceId = 0; InstanceId < NewStates.Num(); InstanceId++)
+    {
+        IsChanged |= WriteInstanceState(InstanceId, NewStates[InstanceId]);
+    }
+    if (IsChanged)
+    {
+        TileInstances->MarkRenderStateDirty();
+    }
+}
+
+void AHexaGrid::ApplyAttackMap(const AttackMap& Attacks)
+{
+    bool IsChanged = false;
+    for (int32 Index = 0; Index < PackedBoard::cell_count; Index++)
+    {
+        IsChanged |= WriteInstanceHeat(GetTileInstance(CellIndexToPosition(Index)), Attacks.counts[0][Index], Attacks.counts[1][Index]);
+    }
+    if (IsChanged)
+    {
+        TileInstances->MarkRenderStateDirty();
+    }
+}
+
+void AHexaGrid::ClearAttackerCounts()
+{
+    bool IsChanged = false;
+    for (int32 InstanceId = 0; InstanceId < InstanceHeat.Num(); InstanceId++)
+    {
+        IsChanged |= WriteInstanceHeat(InstanceId, 0, 0);
+    }
+    if (IsChanged)
+    {
+        TileInstances->MarkRenderStateDirty();
+    }
+}
+
+bool AHexaGrid::WriteInstanceHeat(int32 InstanceId, uint8 WhiteCount, uint8 BlackCount)
+{
+    const uint16 Heat = WhiteCount | (BlackCount << 8);
+    if (!InstanceHeat.IsValidIndex(InstanceId) || InstanceHeat[InstanceId] == Heat)
+    {
+        return false;
+    }
+    InstanceHeat[InstanceId] = Heat;
+    TileInstances->SetCustomDataValue(InstanceId, 1, static_cast<float>(WhiteCount), false);
+    TileInstances->SetCustomDataValue(InstanceId, 2, static_cast<float>(BlackCount), false);
+    return true;
+}
+
+bool AHexaGrid::WriteInstanceState(int32 InstanceId, ETileState State)
+{
+    if (!InstanceStates.IsValidIndex(InstanceId) || InstanceStates[InstanceId] == State)
+    {
+        return false;
+    }
+    InstanceStates[InstanceId] = State;
+    TileInstances->SetCustomDataValue(InstanceId, 0, static_cast<float>(State), false);
+    return true;
+}
@@ -2,13 +2,22 @@
 
 #include <CoreMinimal.h>
 
+#include "Types/TileState.h"
+
 #include "HexaGrid.generated.h"
 
+struct AttackMap;
+class APlayerController;
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+
 UCLASS()
 class AHexaGrid : public AActor
 {
     GENERATED_BODY()
 
+    AHexaGrid();
+
 public:
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
@@ -17,7 +26,124 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
     int32 Height = 22;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+    UStaticMesh* TileMesh = nullptr;
+
+    /*
+     * Distance between the centers of two tiles of the same column.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+    float TileSize = 100.0f;
+
+    /*
+     * Off once every pick goes through FindTileUnderCursor or FindTileUnderRay; the tiles then have no physics state and
+     * line traces no longer hit them. Read by GenerateGrid.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+    bool UseTileCollision = true;
+
+    /*
+     * Every tile of the board is an instance of this one component, so the whole grid is drawn in a single call.
+     */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    UHierarchicalInstancedStaticMeshComponent* TileInstances;
+
+    virtual void OnConstruction(const FTransform& Transform) override;
+
+    UFUNCTION(BlueprintCallable)
+    virtual void GenerateGrid();
+
+    UFUNCTION(BlueprintPure)
+    virtual bool IsTileOnBoard(FIntPoint Tile) const;
+
+    /*
+     * Location of the tile's center relative to the grid; columns are flat-top hexes, row 0 at the bottom of each column.
+     */
+    UFUNCTION(BlueprintPure)
+    virtual FVector GetTileLocation(FIntPoint Tile) const;
+
+    /*
+     * World location of the tile's center, read from the table GenerateGrid builds.
+     */
+    UFUNCTION(BlueprintPure)
+    FVector GetTileWorldLocation(FIntPoint Tile) const;
+
+    /*
+     * The on-board tile whose center is nearest to the point, i.e. the hex it is in; for picking under the cursor without tracing every tile.
+     */
+    UFUNCTION(BlueprintPure)
+    bool FindTileAtWorldLocation(FVector WorldLocation, FIntPoint& OutTile) const;
+
+    /*
+     * The tile where the ray meets the grid's plane, without a trace; false when it misses the board or runs parallel to it.
+     */
+    UFUNCTION(BlueprintPure)
+    bool FindTileUnderRay(FVector RayOrigin, FVector RayDirection, FIntPoint& OutTile) const;
+
+    /*
+     * FindTileUnderRay for the player's mouse cursor, the per-frame hover test.
+     */
+    UFUNCTION(BlueprintPure)
+    bool FindTileUnderCursor(const APlayerController* PlayerController, FIntPoint& OutTile) const;
+
+    /*
+     * Instance of the tile in TileInstances, INDEX_NONE off the board.
+     */
+    UFUNCTION(BlueprintPure)
+    int32 GetTileInstance(FIntPoint Tile) const;
+
     UFUNCTION(BlueprintCallable)
-    virtual void GenerateGrid() {}
+    void SetTileState(FIntPoint Tile, ETileState State);
+
+    /*
+     * SetTileState for a list of tiles, with one render state update at the end.
+     */
+    UFUNCTION(BlueprintCallable)
+    void SetTileStates(const TArray<FIntPoint>& Tiles, ETileState State);
+
+    UFUNCTION(BlueprintCallable)
+    void ClearTileStates();
+
+    /*
+     * Makes the listed tiles show their state and every other tile none; only the tiles whose state changed are written.
+     */
+    UFUNCTION(BlueprintCallable)
+    void ApplyTileStates(const TMap<FIntPoint, ETileState>& States);
+
+    /*
+     * Writes how many white and black pieces attack every tile to its second and third custom data floats, for the tile
+     * material's threat heatmap; only the tiles whose counts changed are written, with one render state update.
+     */
+    void ApplyAttackMap(const AttackMap& Attacks);
+
+    UFUNCTION(BlueprintCallable)
+    void ClearAttackerCounts();
+
+private:
+
+    // instance of every (x, y) of the Width x Height grid, row by row
+    TArray<int32> TileInstanceIds;
+
+    // state last written to the custom data of each instance
+    TArray<ETileState> InstanceStates;
+
+    // GetTileLocation of every on-board (x, y), indexed like TileInstanceIds
+    TArray<FVector> TileLocations;
+
+    // on-board tiles by the TileSize square their center falls in, a location only has to check its square and the ones around it
+    TMap<FIntPoint, TArray<FIntPoint>> PickingCells;
+
+    FIntPoint GetPickingCell(const FVector& Location) const;
+
+    // FindTileAtWorldLocation for a location relative to the grid
+    bool FindTileAtLocation(const FVector& Location, FIntPoint& OutTile) const;
+
+    // false when the instance already had that state
+    bool WriteInstanceState(int32 InstanceId, ETileState State);
+
+    // attacker counts last written to each instance, white in the low byte
+    TArray<uint16> InstanceHeat;
+
+    bool WriteInstanceHeat(int32 InstanceId, uint8 WhiteCount, uint8 BlackCount);
 
 };
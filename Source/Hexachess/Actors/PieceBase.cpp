@@ -1,6 +1,18 @@
 #include "PieceBase.h"
 
+#include <GeometryCollection/GeometryCollectionComponent.h>
+
 APieceBase::APieceBase()
 {
     PrimaryActorTick.bCanEverTick = false;
 }
+
+void APieceBase::SetPooled(bool IsPooled)
+{
+    SetActorHiddenInGame(IsPooled);
+    SetActorEnableCollision(!IsPooled);
+    if (!IsPooled || !GetGeometryCollectionComponent()->IsPhysicsStateCreated())
+    {
+        GetGeometryCollectionComponent()->RecreatePhysicsState();
+    }
+}
@@ -39,4 +39,10 @@ public:
     UFUNCTION(BlueprintCallable)
     virtual void SetColor(int32 NewColorID) {}
 
+    /*
+     * Parks the piece hidden and without collision for the pool, or brings it back whole: a fractured collection gets its
+     * physics state rebuilt from the rest collection.
+     */
+    virtual void SetPooled(bool IsPooled);
+
 };
@@ -0,0 +1,152 @@
+#include "ReplayViewer.h"
+
+#include "Actors/ChessGod.h"
+#include "Actors/HexaGrid.h"
+#include "Actors/PieceBase.h"
+#include "Chess/CellIndex.h"
+#include "Chess/GameReplay.h"
+#include "Chess/PositionCodec.h"
+#include "Core/HexaSaveGame.h"
+
+
+void AReplayViewer::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Super::EndPlay(EndPlayReason);
+
+    CloseReplay();
+    delete Replay;
+    Replay = nullptr;
+}
+
+bool AReplayViewer::LoadReplay(const UHexaSaveGame* SaveGame)
+{
+    if (SaveGame == nullptr || SaveGame->StartPosition.Num() != EncodedPosition::size)
+    {
+        return false;
+    }
+    EncodedPosition Encoded;
+    FMemory::Memcpy(Encoded.bytes, SaveGame->StartPosition.GetData(), EncodedPosition::size);
+    PackedBoard Start;
+    if (!PositionCodec::decode(Encoded, Start))
+    {
+        return false;
+    }
+
+    if (Replay == nullptr)
+    {
+        Replay = new GameReplay();
+    }
+    const bool IsComplete = Replay->load(Start, vector<uint8>(SaveGame->MoveRecord.GetData(), SaveGame->MoveRecord.GetData() + SaveGame->MoveRecord.Num()), KeyframeInterval);
+    ShowCurrentPosition();
+    return IsComplete;
+}
+
+bool AReplayViewer::LoadCurrentGame()
+{
+    return ChessGod != nullptr && LoadReplay(ChessGod->CreateSaveGame());
+}
+
+void AReplayViewer::SeekToPly(int32 Ply)
+{
+    if (Replay == nullptr)
+    {
+        return;
+    }
+    Replay->seek(Ply);
+    ShowCurrentPosition();
+}
+
+int32 AReplayViewer::GetPlyCount() const
+{
+    return Replay != nullptr ? Replay->get_ply_count() : 0;
+}
+
+int32 AReplayViewer::GetCurrentPly() const
+{
+    return Replay != nullptr ? Replay->get_current_ply() : 0;
+}
+
+bool AReplayViewer::GetMoveAtPly(int32 Ply, FIntPoint& OutFrom, FIntPoint& OutTo) const
+{
+    int32 From = 0;
+    int32 To = 0;
+    if (Replay == nullptr || !Replay->get_move(Ply, From, To))
+    {
+        return false;
+    }
+    OutFrom = CellIndexToPosition(From);
+    OutTo = CellIndexToPosition(To);
+    return true;
+}
+
+void AReplayViewer::CloseReplay()
+{
+    if (ChessGod != nullptr)
+    {
+        for (const TPair<int32, APieceBase*>& Shown : ShownPieces)
+        {
+            ChessGod->ReleasePiece(Shown.Value);
+        }
+    }
+    ShownPieces.Reset();
+}
+
+void AReplayViewer::ShowCurrentPosition()
+{
+    if (ChessGod == nullptr || Grid == nullptr || Replay == nullptr)
+    {
+        return;
+    }
+
+    // pieces already standing on their tile stay untouched
+    TMap<int32, APieceBase*> Previous = MoveTemp(ShownPieces);
+    ShownPieces.Reset();
+    TArray<FPieceInfo, TInlineAllocator<64>> Missing;
+    for (const FPieceInfo& PieceInfo : AChessGod::GetPositionPieces(Replay->get_current()))
+    {
+        const int32 Index = ToCellIndex(FIntPoint(PieceInfo.X, PieceInfo.Y));
+        APieceBase* const* Kept = Previous.Find(Index);
+        if (Kept != nullptr && (*Kept)->Type == PieceInfo.Type && (*Kept)->ColorID == PieceInfo.TeamID)
+        {
+            ShownPieces.Add(Index, *Kept);
+            Previous.Remove(Index);
+        }
+        else
+        {
+            Missing.Add(PieceInfo);
+        }
+    }
+
+    for (const FPieceInfo& PieceInfo : Missing)
+    {
+        // a piece of the same kind that is no longer needed where it stands jumps over, the pool only covers the rest
+        int32 UnusedIndex = INDEX_NONE;
+        for (const TPair<int32, APieceBase*>& Unused : Previous)
+        {
+            if (Unused.Value->Type == PieceInfo.Type && Unused.Value->ColorID == PieceInfo.TeamID)
+            {
+                UnusedIndex = Unused.Key;
+                break;
+            }
+        }
+        APieceBase* Piece = UnusedIndex != INDEX_NONE ? Previous.FindAndRemoveChecked(UnusedIndex) : nullptr;
+        if (Piece == nullptr)
+        {
+            Piece = ChessGod->AcquirePiece(PieceInfo);
+            if (Piece == nullptr)
+            {
+                continue;
+            }
+        }
+        const FIntPoint Tile(PieceInfo.X, PieceInfo.Y);
+        Piece->GridX = Tile.X;
+        Piece->GridY = Tile.Y;
+        Piece->SetActorLocation(Grid->GetTileWorldLocation(Tile));
+        ShownPieces.Add(ToCellIndex(Tile), Piece);
+    }
+
+    for (const TPair<int32, APieceBase*>& Unused : Previous)
+    {
+        ChessGod->ReleasePiece(Unused.Value);
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "ReplayViewer.generated.h"
+
+class AChessGod;
+class AHexaGrid;
+class APieceBase;
+class GameReplay;
+class UHexaSaveGame;
+
+
+/*
+ * Shows a finished game at any ply for review. The game is replayed once when it is loaded, with a keyframe every
+ * KeyframeInterval plies, so a seek rebuilds the position from the nearest keyframe in a bounded number of moves.
+ * The pieces are taken from ChessGod's pool and put straight on their tiles, no move is animated; a piece already on
+ * the right tile stays, and one of the same kind elsewhere is moved there before a new one is taken.
+ */
+UCLASS()
+class AReplayViewer : public AActor
+{
+    GENERATED_BODY()
+
+public:
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // lends its piece pool to the replay
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+    AChessGod* ChessGod = nullptr;
+
+    // where the pieces stand
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
+    AHexaGrid* Grid = nullptr;
+
+    // plies between two kept positions; a seek plays at most this many moves less one
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (ClampMin = "1"))
+    int32 KeyframeInterval = 16;
+
+    // loads a saved game and shows its start; false if the game does not replay, what replayed up to the bad move is kept
+    UFUNCTION(BlueprintCallable)
+    bool LoadReplay(const UHexaSaveGame* SaveGame);
+
+    // the game on ChessGod's board, from the start of its history
+    UFUNCTION(BlueprintCallable)
+    bool LoadCurrentGame();
+
+    // shows the position after Ply moves, clamped to the game
+    UFUNCTION(BlueprintCallable)
+    void SeekToPly(int32 Ply);
+
+    UFUNCTION(BlueprintCallable)
+    void StepForward() { SeekToPly(GetCurrentPly() + 1); }
+
+    UFUNCTION(BlueprintCallable)
+    void StepBack() { SeekToPly(GetCurrentPly() - 1); }
+
+    UFUNCTION(BlueprintPure)
+    int32 GetPlyCount() const;
+
+    UFUNCTION(BlueprintPure)
+    int32 GetCurrentPly() const;
+
+    // the move that leads from Ply to Ply + 1, for highlighting it
+    UFUNCTION(BlueprintPure)
+    bool GetMoveAtPly(int32 Ply, FIntPoint& OutFrom, FIntPoint& OutTo) const;
+
+    // hands the shown pieces back to the pool
+    UFUNCTION(BlueprintCallable)
+    void CloseReplay();
+
+private:
+
+    // puts pieces on the tiles of the current position, reusing the shown ones where it can
+    void ShowCurrentPosition();
+
+    GameReplay* Replay = nullptr;
+
+    // the shown pieces by the dense cell index they stand on
+    UPROPERTY()
+    TMap<int32, APieceBase*> ShownPieces;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "Chess/ChessEngine.h"
+
+// conversions between the FIntPoint cells of the game and the engine's position keys ((x << 8) + y) and dense cell indices
+
+inline int32 CellPositionToKey(const FIntPoint InPosition)
+{
+    return (InPosition.X << 8) + InPosition.Y;
+}
+
+inline FIntPoint KeyToCellPosition(const int32 Key)
+{
+    return FIntPoint{Key >> 8, Key & 0xFF};
+}
+
+// dense index of the cell, -1 off the board
+inline int32 ToCellIndex(const FIntPoint InPosition)
+{
+    return PackedBoard::to_index(CellPositionToKey(InPosition));
+}
+
+inline FIntPoint CellIndexToPosition(const int32 Index)
+{
+    return KeyToCellPosition(PackedBoard::to_key(Index));
+}
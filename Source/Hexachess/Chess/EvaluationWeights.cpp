@@ -0,0 +1,114 @@
+#include "EvaluationWeights.h"
+
+#include "Chess/Evaluator.h"
+
+
+UEvaluationWeights::UEvaluationWeights()
+{
+    Pawn.OpeningValue = 100;
+    Pawn.EndgameValue = 120;
+    Pawn.OpeningAdvancement = 5;
+    Pawn.EndgameAdvancement = 15;
+
+    Knight.OpeningValue = 300;
+    Knight.EndgameValue = 280;
+    Knight.OpeningCentrality = 6;
+    Knight.EndgameCentrality = 4;
+    Knight.OpeningMobility = 2;
+    Knight.EndgameMobility = 2;
+    Knight.PhaseWeight = 1;
+
+    Bishop.OpeningValue = 300;
+    Bishop.EndgameValue = 310;
+    Bishop.OpeningCentrality = 4;
+    Bishop.EndgameCentrality = 3;
+    Bishop.OpeningMobility = 2;
+    Bishop.EndgameMobility = 3;
+    Bishop.PhaseWeight = 1;
+
+    Rook.OpeningValue = 500;
+    Rook.EndgameValue = 520;
+    Rook.OpeningCentrality = 2;
+    Rook.EndgameCentrality = 2;
+    Rook.OpeningMobility = 1;
+    Rook.EndgameMobility = 2;
+    Rook.PhaseWeight = 2;
+
+    Queen.OpeningValue = 900;
+    Queen.EndgameValue = 940;
+    Queen.OpeningCentrality = 1;
+    Queen.EndgameCentrality = 3;
+    Queen.OpeningMobility = 1;
+    Queen.EndgameMobility = 2;
+    Queen.PhaseWeight = 4;
+
+    // hide in the opening, walk to the middle once the board empties
+    King.OpeningCentrality = -4;
+    King.EndgameCentrality = 6;
+}
+
+void UEvaluationWeights::PostLoad()
+{
+    Super::PostLoad();
+
+    Compile();
+}
+
+#if WITH_EDITOR
+void UEvaluationWeights::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    Compile();
+}
+#endif
+
+TSharedPtr<const Evaluator, ESPMode::ThreadSafe> UEvaluationWeights::GetEvaluator()
+{
+    if (!CompiledEvaluator.IsValid())
+    {
+        Compile();
+    }
+    return CompiledEvaluator;
+}
+
+void UEvaluationWeights::Compile()
+{
+    const TPair<Cell::PieceType, const FPieceEvaluationWeights*> Sources[] = {
+        {Cell::PieceType::pawn, &Pawn},
+        {Cell::PieceType::knight, &Knight},
+        {Cell::PieceType::bishop, &Bishop},
+        {Cell::PieceType::rook, &Rook},
+        {Cell::PieceType::queen, &Queen},
+        {Cell::PieceType::king, &King},
+    };
+
+    PieceWeights Pieces[8];
+    for (const auto& [Type, Source] : Sources)
+    {
+        PieceWeights& Weights = Pieces[Type];
+        Weights.value[EvaluationTables::opening] = Source->OpeningValue;
+        Weights.value[EvaluationTables::endgame] = Source->EndgameValue;
+        Weights.centrality[EvaluationTables::opening] = Source->OpeningCentrality;
+        Weights.centrality[EvaluationTables::endgame] = Source->EndgameCentrality;
+        Weights.advancement[EvaluationTables::opening] = Source->OpeningAdvancement;
+        Weights.advancement[EvaluationTables::endgame] = Source->EndgameAdvancement;
+        Weights.mobility[EvaluationTables::opening] = Source->OpeningMobility;
+        Weights.mobility[EvaluationTables::endgame] = Source->EndgameMobility;
+        Weights.phase_weight = Source->PhaseWeight;
+        // a table of the wrong size is ignored rather than read out of bounds
+        if (Source->OpeningSquareBonus.Num() == PackedBoard::cell_count)
+        {
+            Weights.square_bonus[EvaluationTables::opening] = Source->OpeningSquareBonus.GetData();
+        }
+        if (Source->EndgameSquareBonus.Num() == PackedBoard::cell_count)
+        {
+            Weights.square_bonus[EvaluationTables::endgame] = Source->EndgameSquareBonus.GetData();
+        }
+    }
+
+    const int32 KingShelter[2] = {OpeningKingShelter, EndgameKingShelter};
+    const int32 KingZoneAttacker[2] = {OpeningKingZoneAttacker, EndgameKingZoneAttacker};
+    const int32 CheckPenalty[2] = {OpeningCheckPenalty, EndgameCheckPenalty};
+    CompiledEvaluator = MakeShared<TaperedEvaluator, ESPMode::ThreadSafe>(compile_evaluation_tables(Pieces, KingShelter, KingZoneAttacker, CheckPenalty));
+}
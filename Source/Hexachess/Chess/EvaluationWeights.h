@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "EvaluationWeights.generated.h"
+
+class Evaluator;
+
+
+USTRUCT(BlueprintType)
+struct FPieceEvaluationWeights
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Material")
+    int32 OpeningValue = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Material")
+    int32 EndgameValue = 0;
+
+    // bonus per ring closer to the middle of the board
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Squares")
+    int32 OpeningCentrality = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Squares")
+    int32 EndgameCentrality = 0;
+
+    // bonus per cell advanced from the starting row, meant for pawns
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Squares")
+    int32 OpeningAdvancement = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Squares")
+    int32 EndgameAdvancement = 0;
+
+    // hand made square tables: 91 bonuses from white's side, column by column from the bottom cell up;
+    // black uses the same table upside down; when filled they replace centrality and advancement
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Squares")
+    TArray<int32> OpeningSquareBonus;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Squares")
+    TArray<int32> EndgameSquareBonus;
+
+    // bonus per cell the piece attacks or can move to; ignored for pawns
+    // by far the most expensive term to evaluate, leaving it at zero for every piece skips it entirely
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mobility")
+    int32 OpeningMobility = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Mobility")
+    int32 EndgameMobility = 0;
+
+    // how much one piece of this type keeps the game in the opening
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Phase")
+    int32 PhaseWeight = 0;
+};
+
+/*
+ * Evaluation weights for the minimax AI, one asset per difficulty or style.
+ * All values are in evaluation units, a pawn is 100. Opening and endgame weights are blended by the material left on the board.
+ */
+UCLASS(BlueprintType)
+class HEXACHESS_API UEvaluationWeights : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+
+    UEvaluationWeights();
+
+    virtual void PostLoad() override;
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pieces")
+    FPieceEvaluationWeights Pawn;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pieces")
+    FPieceEvaluationWeights Knight;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pieces")
+    FPieceEvaluationWeights Bishop;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pieces")
+    FPieceEvaluationWeights Rook;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pieces")
+    FPieceEvaluationWeights Queen;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pieces")
+    FPieceEvaluationWeights King;
+
+    // bonus per own piece next to the king
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "King Safety")
+    int32 OpeningKingShelter = 12;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "King Safety")
+    int32 EndgameKingShelter = 0;
+
+    // penalty per enemy piece next to the king
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "King Safety")
+    int32 OpeningKingZoneAttacker = 20;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "King Safety")
+    int32 EndgameKingZoneAttacker = 10;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "King Safety")
+    int32 OpeningCheckPenalty = 10000;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "King Safety")
+    int32 EndgameCheckPenalty = 10000;
+
+    // the weights compiled to flat tables; compiled on load and after every edit, a running search keeps the one it started with
+    TSharedPtr<const Evaluator, ESPMode::ThreadSafe> GetEvaluator();
+
+private:
+
+    void Compile();
+
+    TSharedPtr<const Evaluator, ESPMode::ThreadSafe> CompiledEvaluator;
+};
@@ -0,0 +1,197 @@
+#include "MctsAI.h"
+
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/QueuedThreadPool.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+#include "Actors/ChessGod.h"
+#include "Chess/CellIndex.h"
+#include "Chess/ChessEngine.h"
+#include "Chess/EvaluationWeights.h"
+#include "Chess/Evaluator.h"
+#include "Core/HexaGameInstance.h"
+#include "Search/MctsSearch.h"
+
+// one move request: the position as it was when the move was asked for, and the token that cancels it
+struct FMctsSession
+{
+    FMctsRequest Request;
+    std::atomic<bool> IsCancelled{false};
+    // written by the search thread, read once RunSearchSession has returned
+    bool HasMove = false;
+    FIntPoint From = FIntPoint::ZeroValue;
+    FIntPoint To = FIntPoint::ZeroValue;
+};
+
+UMctsAIComponent::UMctsAIComponent()
+{
+    DifficultyIterations.Add(EAIDifficulty::Easy, 2000);
+    DifficultyIterations.Add(EAIDifficulty::Medium, 20000);
+    DifficultyIterations.Add(EAIDifficulty::Hard, 100000);
+}
+
+void UMctsAIComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    ChessGod = Cast<AChessGod>(GetOwner());
+}
+
+void UMctsAIComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Super::EndPlay(EndPlayReason);
+
+    ReleaseSearchState();
+}
+
+void UMctsAIComponent::BeginDestroy()
+{
+    ReleaseSearchState();
+
+    Super::BeginDestroy();
+}
+
+void UMctsAIComponent::ReleaseSearchState()
+{
+    // the search threads use the search's tree, let any running or queued search unwind first
+    CancelSearch();
+    while (PendingSearches.load() > 0)
+    {
+        FPlatformProcess::Sleep(0.001f);
+    }
+
+    delete Search;
+    Search = nullptr;
+}
+
+void UMctsAIComponent::StartCalculatingMove(Board* ActiveBoard, bool IsWhiteAI, EAIDifficulty Difficulty, int32 TimeBudgetMs, UEvaluationWeights* EvaluationWeights, int32 Seed)
+{
+    // a new request always wins, the previous search would only answer a stale position
+    CancelSearch();
+
+    // snapshot the position on the calling thread, the search never touches the game's board
+    const TSharedRef<FMctsSession, ESPMode::ThreadSafe> Session = MakeShared<FMctsSession, ESPMode::ThreadSafe>();
+    FMctsRequest& Request = Session->Request;
+    Request.Position = ActiveBoard->to_packed_board();
+    Request.Position.set_white_to_move(IsWhiteAI);
+    Request.IsWhiteAI = IsWhiteAI;
+    const int32* Iterations = DifficultyIterations.Find(Difficulty);
+    Request.Iterations = Iterations != nullptr ? FMath::Max(*Iterations, 1) : 0;
+    Request.TimeBudgetMs = TimeBudgetMs;
+    Request.ThreadCount = GetSearchThreadCount();
+    Request.ThreadPool = GetSearchThreadPool();
+    Request.Seed = Seed != 0 ? Seed : FMath::Rand();
+    if (EvaluationWeights != nullptr)
+    {
+        Request.Evaluation = EvaluationWeights->GetEvaluator();
+    }
+    Request.Settings.TreeSizeMB = TreeSizeMB;
+    Request.Settings.Exploration = Exploration;
+    Request.Settings.VirtualLoss = FMath::Max(VirtualLoss, 0);
+    Request.Settings.PlayoutDepth = FMath::Max(PlayoutDepth, 0);
+    Request.Settings.PlayoutScoreScale = PlayoutScoreScale;
+    Request.Settings.LeafBatchSize = FMath::Max(LeafBatchSize, 1);
+
+    if (Search == nullptr)
+    {
+        Search = new FMctsSearch();
+    }
+    CurrentSession = Session;
+    PendingSearches++;
+    auto RunSession = [this, Session]()
+    {
+        RunSearchSession(Session);
+        PendingSearches--;
+    };
+    if (FQueuedThreadPool* ThreadPool = Session->Request.ThreadPool)
+    {
+        AsyncPool(*ThreadPool, MoveTemp(RunSession));
+    }
+    else
+    {
+        AsyncTask(ENamedThreads::AnyThread, MoveTemp(RunSession));
+    }
+}
+
+void UMctsAIComponent::CancelSearch()
+{
+    if (CurrentSession.IsValid())
+    {
+        CurrentSession->IsCancelled = true;
+        CurrentSession.Reset();
+    }
+}
+
+bool UMctsAIComponent::IsCalculatingMove() const
+{
+    return CurrentSession.IsValid();
+}
+
+void UMctsAIComponent::RunSearchSession(const TSharedRef<FMctsSession, ESPMode::ThreadSafe>& Session)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(HexachessAI_MctsSearch);
+    const TWeakObjectPtr<UMctsAIComponent> WeakThis(this);
+
+    // one search at a time owns the tree; a cancelled one gives it up within one iteration per thread
+    const FMctsResult Result = Search->Run(Session->Request, Session->IsCancelled);
+    if (!Result.IsComplete)
+    {
+        return;
+    }
+    UE_LOG(LogTemp, Log, TEXT("MctsAI: %lld iterations, %d nodes, score %d"), Result.Iterations, Result.TreeNodes, Result.Move.Score);
+
+    Session->HasMove = Result.Move.FromKey != Result.Move.ToKey;
+    Session->From = KeyToCellPosition(Result.Move.FromKey);
+    Session->To = KeyToCellPosition(Result.Move.ToKey);
+
+    AsyncTask(ENamedThreads::GameThread, [WeakThis, Session]
+    {
+        // a search cancelled or replaced after it finished must not play its move either
+        if (!WeakThis.IsValid() || WeakThis->CurrentSession.Get() != &Session.Get())
+        {
+            return;
+        }
+        WeakThis->CurrentSession.Reset();
+        if (Session->HasMove && WeakThis->ChessGod.IsValid())
+        {
+            WeakThis->ChessGod->OnAIFinishedCalculatingMove.Broadcast(Session->From, Session->To);
+        }
+    });
+}
+
+int32 UMctsAIComponent::GetSearchThreadCount() const
+{
+    int32 ThreadCount = 0;
+    if (const UWorld* World = GetWorld())
+    {
+        if (const UHexaGameInstance* GameInstance = World->GetGameInstance<UHexaGameInstance>())
+        {
+            ThreadCount = GameInstance->AIThreadCount;
+        }
+    }
+    if (ThreadCount <= 0)
+    {
+        // the task graph workers plus the thread that starts the search
+        ThreadCount = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    }
+    // the search starts on a pool thread too, the helpers must all fit next to it
+    if (const FQueuedThreadPool* ThreadPool = GetSearchThreadPool())
+    {
+        ThreadCount = FMath::Min(ThreadCount, ThreadPool->GetNumThreads());
+    }
+    return FMath::Clamp(ThreadCount, 1, 64);
+}
+
+FQueuedThreadPool* UMctsAIComponent::GetSearchThreadPool() const
+{
+    if (const UWorld* World = GetWorld())
+    {
+        if (const UHexaGameInstance* GameInstance = World->GetGameInstance<UHexaGameInstance>())
+        {
+            return GameInstance->GetAIThreadPool();
+        }
+    }
+    return nullptr;
+}
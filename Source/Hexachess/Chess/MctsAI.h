@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+
+#include "Types/AIType.h"
+
+#include "MctsAI.generated.h"
+
+class AChessGod;
+class Board;
+class FMctsSearch;
+class FQueuedThreadPool;
+class UEvaluationWeights;
+struct FMctsSession;
+
+
+UCLASS()
+class HEXACHESS_API UMctsAIComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+
+	UMctsAIComponent();
+
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	void BeginDestroy() override;
+
+    // grows a search tree from the position until the difficulty's iterations or TimeBudgetMs run out, then plays the most visited move
+    // EvaluationWeights scores the playouts, without it the board's own evaluation is used
+    // Seed drives the playouts, 0 picks a new one; the search is only repeatable on one thread and without a time budget
+    // the position is copied before this returns, and a search still running for an earlier request is cancelled
+    void StartCalculatingMove(Board* ActiveBoard, bool IsWhiteAI, EAIDifficulty Difficulty, int32 TimeBudgetMs, UEvaluationWeights* EvaluationWeights = nullptr, int32 Seed = 0);
+
+    // drops the current search, its move is never reported; call it whenever the position it was started for goes away
+    UFUNCTION(BlueprintCallable)
+    void CancelSearch();
+
+    UFUNCTION(BlueprintCallable)
+    bool IsCalculatingMove() const;
+
+	TWeakObjectPtr<AChessGod> ChessGod;
+
+	// iterations summed over all search threads at each difficulty; the difficulty's time budget still stops the search early
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	TMap<EAIDifficulty, int32> DifficultyIterations;
+
+	// memory budget of the node pool; once it is full the tree stops growing
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 TreeSizeMB = 64;
+
+	// the UCT exploration constant, higher tries unvisited moves more often
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	float Exploration = 1.4f;
+
+	// visits a thread adds to every node on its path while its playout runs, so the other threads pick different paths
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 VirtualLoss = 3;
+
+	// random plies played out from a new leaf before the evaluation scores where the playout ended
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 PlayoutDepth = 16;
+
+	// the evaluation lead, in evaluation units, that counts as ten to one odds when a playout is scored
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 PlayoutScoreScale = 400;
+
+	// iterations a search thread gathers before their playouts are evaluated in one call; worth 32 and more with a network evaluation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 LeafBatchSize = 1;
+
+private:
+
+	// runs on a background thread; waits for an earlier cancelled search to let go of the tree first
+	void RunSearchSession(const TSharedRef<FMctsSession, ESPMode::ThreadSafe>& Session);
+
+	// waits for the searches still running, then frees the search and its tree
+	void ReleaseSearchState();
+
+	// AIThreadCount from the game instance, 0 there means one per task graph worker; never more than the AI thread pool has
+	int32 GetSearchThreadCount() const;
+
+	// the game instance's AI thread pool, nullptr when it has none
+	FQueuedThreadPool* GetSearchThreadPool() const;
+
+	// the request the game thread is waiting on; only the game thread touches it
+	TSharedPtr<FMctsSession, ESPMode::ThreadSafe> CurrentSession;
+
+	// searches started but not yet returned, EndPlay waits for them
+	std::atomic<int32> PendingSearches{0};
+
+	// the search itself, with the node pool it keeps between moves
+	FMctsSearch* Search = nullptr;
+};
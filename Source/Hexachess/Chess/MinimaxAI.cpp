@@ -1,116 +1,709 @@
 #include "MinimaxAI.h"
 
+#include "Engine/World.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/QueuedThreadPool.h"
+
 #include "Actors/ChessGod.h"
+#include "Chess/CellIndex.h"
 #include "Chess/ChessEngine.h"
+#include "Chess/EvaluationWeights.h"
+#include "Chess/Evaluator.h"
+#include "Chess/Nnue.h"
+#include "Chess/SpscQueue.h"
+#include "Core/HexaGameInstance.h"
+#include "Search/MinimaxSearch.h"
+#include "Search/Tablebase.h"
+
+// one move request: the position as it was when the move was asked for, and the token that cancels it
+struct FSearchSession
+{
+    FMinimaxRequest Request;
+    EAIDifficulty Difficulty = EAIDifficulty::Easy;
+    std::atomic<bool> IsCancelled{false};
+    // set while the session searches on the opponent's time, the ponder hit clears it and starts the clock
+    std::atomic<bool> IsPondering{false};
+    // false for SearchNow, whose caller reads the results below instead of waiting for the game thread
+    bool ReportsToGameThread = true;
+    // a hint search reports its move through OnHintReady and is never played
+    bool IsHint = false;
+    // a warm-up search only fills the table and the caches, its end is reported through OnAIPrewarmed
+    bool IsPrewarm = false;
+    // written by the search thread, read once RunSearchSession has returned
+    TArray<FSearchProgress> Depths;
+    FIntPoint From = FIntPoint::ZeroValue;
+    FIntPoint To = FIntPoint::ZeroValue;
+    FEvaluationCacheStats CacheStats;
+    // the reply the search expects to its move, pondering starts from it
+    bool HasPonderMove = false;
+    FIntPoint PonderFrom = FIntPoint::ZeroValue;
+    FIntPoint PonderTo = FIntPoint::ZeroValue;
+    // the principal variation, then the other MultiPV lines
+    TArray<FSearchLine> Lines;
+    // game thread only: a pondering session that finished before the expected reply was played holds its move back until it is
+    bool HasFinished = false;
+};
+
+// one finished depth on its way to the game thread, with the session it belongs to
+struct FSearchProgressEvent
+{
+    TSharedPtr<FSearchSession, ESPMode::ThreadSafe> Session;
+    FSearchProgress Progress;
+};
 
+// the searches run one at a time under the search's lock, so there is only ever one producer
+// 64 depths is more than any search reports between two game thread ticks
+struct FSearchProgressQueue : SpscQueue<FSearchProgressEvent, 64>
+{
+};
 
 void UMinimaxAIComponent::BeginPlay()
 {
     Super::BeginPlay();
 
     ChessGod = Cast<AChessGod>(GetOwner());
+
+    TemperatureChangeHandle = FCoreDelegates::OnTemperatureChange.AddWeakLambda(this, [this](ETemperatureSeverity Severity)
+    {
+        TemperatureSeverity = static_cast<uint8>(Severity);
+    });
+    LowPowerModeHandle = FCoreDelegates::OnLowPowerMode.AddWeakLambda(this, [this](bool IsEnabled)
+    {
+        IsLowPowerMode = IsEnabled;
+    });
+}
+
+void UMinimaxAIComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Super::EndPlay(EndPlayReason);
+
+    FCoreDelegates::OnTemperatureChange.Remove(TemperatureChangeHandle);
+    FCoreDelegates::OnLowPowerMode.Remove(LowPowerModeHandle);
+    ReleaseSearchState();
 }
 
-void UMinimaxAIComponent::StartCalculatingMove(Board* ActiveBoard, bool IsWhiteAI, int32 Depth)
+void UMinimaxAIComponent::BeginDestroy()
 {
-    const auto CompleteCallback = [this](TArray<FIntPoint>& Result)
+    // components that never began play, like the benchmark's, still own search state
+    ReleaseSearchState();
+
+    Super::BeginDestroy();
+}
+
+void UMinimaxAIComponent::ReleaseSearchState()
+{
+    // the search threads use the search's table and workers, let any running or queued search unwind first
+    CancelSearch();
+    while (PendingSearches.load() > 0)
     {
-        AsyncTask(ENamedThreads::GameThread, [this, Result]
+        FPlatformProcess::Sleep(0.001f);
+    }
+
+    delete Search;
+    Search = nullptr;
+    delete ProgressQueue;
+    ProgressQueue = nullptr;
+}
+
+FMinimaxSettings UMinimaxAIComponent::MakeSearchSettings() const
+{
+    FMinimaxSettings Settings;
+    Settings.TranspositionTableSizeMB = TranspositionTableSizeMB;
+    Settings.EvaluationCacheSizeKB = EvaluationCacheSizeKB;
+    Settings.UsePrincipalVariation = SearchMode == ESearchMode::PrincipalVariation;
+    Settings.AspirationWindow = AspirationWindow;
+    Settings.UseQuiescence = UseQuiescence;
+    Settings.QuiescenceDepth = QuiescenceDepth;
+    Settings.QuiescenceDeltaMargin = QuiescenceDeltaMargin;
+    Settings.UseExchangePruning = UseExchangePruning;
+    Settings.SplitMinDepth = SplitMinDepth;
+    Settings.UseNullMove = UseNullMove;
+    Settings.NullMoveReduction = NullMoveReduction;
+    Settings.UseLateMoveReductions = UseLateMoveReductions;
+    Settings.LateMoveMinDepth = LateMoveMinDepth;
+    Settings.LateMoveMinIndex = LateMoveMinIndex;
+    Settings.MultiPV = FMath::Max(MultiPV, 1);
+    return Settings;
+}
+
+const TSharedPtr<const FTablebase, ESPMode::ThreadSafe>& UMinimaxAIComponent::GetTablebase()
+{
+    if (!HasLookedForTablebase)
+    {
+        HasLookedForTablebase = true;
+        // only the file names are read here, each table is mapped the first time a search reaches its material
+        const TSharedRef<FTablebase, ESPMode::ThreadSafe> Tables = MakeShared<FTablebase, ESPMode::ThreadSafe>();
+        const FString Directory = FPaths::ProjectContentDir() / TablebaseDirectory;
+        const int32 MaterialCount = Tables->Open(Directory);
+        if (MaterialCount > 0)
         {
-            if (ChessGod.IsValid())
-            {
-                ChessGod->OnAIFinishedCalculatingMove.Broadcast(Result[0], Result[1]);
-            }
-        });
+            Tablebase = Tables;
+            UE_LOG(LogTemp, Log, TEXT("MinimaxAI: %d tablebase materials of up to %d pieces in %s"), MaterialCount, Tables->GetMaxPieces(), *Directory);
+        }
+    }
+    return Tablebase;
+}
+
+const TSharedPtr<const Evaluator, ESPMode::ThreadSafe>& UMinimaxAIComponent::GetNetwork()
+{
+    if (!HasLookedForNetwork)
+    {
+        HasLookedForNetwork = true;
+        const FString Path = FPaths::ProjectContentDir() / NetworkFile;
+        TArray<uint8> Bytes;
+        NnueNetwork Weights;
+        if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+        {
+            UE_LOG(LogTemp, Log, TEXT("MinimaxAI: no network at %s"), *Path);
+        }
+        else if (!Weights.load(Bytes.GetData(), Bytes.Num()))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("MinimaxAI: %s is not a network of this version and size"), *Path);
+        }
+        else
+        {
+            Network = MakeShared<NnueEvaluator, ESPMode::ThreadSafe>(Weights);
+            UE_LOG(LogTemp, Log, TEXT("MinimaxAI: network loaded from %s"), *Path);
+        }
+    }
+    return Network;
+}
+
+TSharedRef<FSearchSession, ESPMode::ThreadSafe> UMinimaxAIComponent::MakeSession(Board* ActiveBoard, bool IsWhiteAI, int32 MaxDepth, int32 TimeBudgetMs, EParallelSearch ParallelSearch, UEvaluationWeights* EvaluationWeights, EAIDifficulty Difficulty, int64 NodeBudget)
+{
+    // snapshot the position on the calling thread, the search never touches the game's board
+    const TSharedRef<FSearchSession, ESPMode::ThreadSafe> Session = MakeShared<FSearchSession, ESPMode::ThreadSafe>();
+    FMinimaxRequest& Request = Session->Request;
+    Request.Position = ActiveBoard->to_packed_board();
+    Request.Position.set_white_to_move(IsWhiteAI);
+    // the game's positions since its last capture or pawn move, so the search sees the draws the game would call
+    const vector<uint64> History = ActiveBoard->get_reversible_hashes();
+    Request.History.Append(History.data(), History.size());
+    Request.FiftyMovePlies = ChessGod.IsValid() ? ChessGod->FiftyMovePlies : Request.FiftyMovePlies;
+    Request.IsWhiteAI = IsWhiteAI;
+    Request.MaxDepth = FMath::Max(MaxDepth, 1);
+    Request.TimeBudgetMs = TimeBudgetMs;
+    Request.NodeBudget = FMath::Max<int64>(NodeBudget, 0);
+    Request.UseSplitPoints = ParallelSearch == EParallelSearch::YoungBrothersWait;
+    // the helpers' share of the work depends on the scheduler, a node budget is only reproducible on one thread
+    Request.ThreadCount = Request.NodeBudget > 0 ? 1 : GetSearchThreadCount();
+    Request.ThreadPool = GetSearchThreadPool();
+    if (EvaluationWeights != nullptr)
+    {
+        Request.Evaluation = EvaluationWeights->GetEvaluator();
+    }
+    // the network outranks the weights at the difficulties it is meant for
+    if (UseNetwork && Difficulty >= NetworkMinDifficulty && GetNetwork().IsValid())
+    {
+        Request.Evaluation = GetNetwork();
+    }
+    if (UseTablebase)
+    {
+        Request.Tablebase = GetTablebase();
+    }
+    Request.Settings = MakeSearchSettings();
+    Session->Difficulty = Difficulty;
+    return Session;
+}
+
+void UMinimaxAIComponent::StartCalculatingMove(Board* ActiveBoard, bool IsWhiteAI, int32 MaxDepth, int32 TimeBudgetMs, EParallelSearch ParallelSearch, UEvaluationWeights* EvaluationWeights, EAIDifficulty Difficulty, int64 NodeBudget)
+{
+    const TSharedRef<FSearchSession, ESPMode::ThreadSafe> Session = MakeSession(ActiveBoard, IsWhiteAI, MaxDepth, TimeBudgetMs, ParallelSearch, EvaluationWeights, Difficulty, NodeBudget);
+    ApplySearchGovernor(*Session);
+
+    // ponder hit: the search already running on this position becomes the move's search, with the depths it has done so far
+    // unless the power mode changed since it started, a ponder search on every thread would keep a hot device busy
+    if (PonderSession.IsValid() && PonderSession->Request.Position == Session->Request.Position && PonderSession->Request.IsWhiteAI == IsWhiteAI
+        && PonderSession->Request.MaxDepth == Session->Request.MaxDepth && PonderSession->Request.TimeBudgetMs == Session->Request.TimeBudgetMs && PonderSession->Difficulty == Difficulty
+        && PonderSession->Request.ThreadCount == Session->Request.ThreadCount && PonderSession->Request.NodeBudget == Session->Request.NodeBudget)
+    {
+        const TSharedRef<FSearchSession, ESPMode::ThreadSafe> Pondered = PonderSession.ToSharedRef();
+        PonderSession.Reset();
+        CancelSearch();
+        CurrentSession = Pondered;
+        Pondered->IsPondering = false;
+        if (Pondered->HasFinished)
+        {
+            FinishSession(Pondered);
+        }
+        return;
+    }
+
+    // a new request always wins, the previous search would only answer a stale position; a missed ponder still leaves its table behind
+    CancelSearch();
+    CurrentSession = Session;
+    LaunchSession(Session);
+}
+
+void UMinimaxAIComponent::NotifyMovePlayed(Board* ActiveBoard, FIntPoint From, FIntPoint To)
+{
+    // any change of the position makes a running search stale
+    if (CurrentSession.IsValid())
+    {
+        CurrentSession->IsCancelled = true;
+        CurrentSession.Reset();
+    }
+    if (HintSession.IsValid())
+    {
+        HintSession->IsCancelled = true;
+        HintSession.Reset();
+    }
+    const TSharedPtr<FSearchSession, ESPMode::ThreadSafe> Played = LastSession;
+    LastSession.Reset();
+
+    if (PonderSession.IsValid())
+    {
+        // the expected reply keeps the ponder search going until StartCalculatingMove takes it over
+        if (PonderSession->PonderFrom == From && PonderSession->PonderTo == To)
+        {
+            return;
+        }
+        PonderSession->IsCancelled = true;
+        PonderSession.Reset();
+    }
+
+    // the AI's own move: think about the position after the reply it expects while the opponent thinks
+    // a node budget search does not, what the table holds would then depend on how long the opponent took
+    if (UsePondering && Played.IsValid() && Played->Request.NodeBudget == 0 && Played->HasPonderMove && Played->From == From && Played->To == To)
+    {
+        StartPondering(ActiveBoard, *Played);
+    }
+}
+
+void UMinimaxAIComponent::StartPondering(Board* ActiveBoard, const FSearchSession& Played)
+{
+    const TSharedRef<FSearchSession, ESPMode::ThreadSafe> Session = MakeShared<FSearchSession, ESPMode::ThreadSafe>();
+    Session->Difficulty = Played.Difficulty;
+    Session->PonderFrom = Played.PonderFrom;
+    Session->PonderTo = Played.PonderTo;
+    FMinimaxRequest& Request = Session->Request;
+    Request = Played.Request;
+    Request.Position = ActiveBoard->to_packed_board();
+    // the AI's move is on the board, the opponent is to move
+    Request.Position.set_white_to_move(!Request.IsWhiteAI);
+    const vector<uint64> History = ActiveBoard->get_reversible_hashes();
+    Request.History.Reset();
+    Request.History.Append(History.data(), History.size());
+
+    // the expected reply came from the search's table, make sure it is still a move of this position
+    const int32 From = ToCellIndex(Played.PonderFrom);
+    const int32 To = ToCellIndex(Played.PonderTo);
+    MoveList Replies;
+    ActiveBoard->generate_legal_moves(Request.Position, Request.IsWhiteAI ? Cell::PieceColor::black : Cell::PieceColor::white, Replies);
+    bool IsLegal = false;
+    for (const Move& Reply : Replies)
+    {
+        IsLegal = IsLegal || (Reply.from == From && Reply.to == To);
+    }
+    if (!IsLegal)
+    {
+        return;
+    }
+    Request.Position.make_move(From, To);
+    Request.IsPondering = &Session->IsPondering;
+    Session->IsPondering = true;
+
+    PonderSession = Session;
+    LaunchSession(Session);
+}
+
+void UMinimaxAIComponent::LaunchSession(const TSharedRef<FSearchSession, ESPMode::ThreadSafe>& Session)
+{
+    if (Search == nullptr)
+    {
+        Search = new FMinimaxSearch();
+    }
+    if (ProgressQueue == nullptr)
+    {
+        ProgressQueue = new FSearchProgressQueue();
+    }
+
+    PendingSearches++;
+    auto RunSession = [this, Session]()
+    {
+        RunSearchSession(Session);
+        PendingSearches--;
     };
+    if (FQueuedThreadPool* ThreadPool = Session->Request.ThreadPool)
+    {
+        AsyncPool(*ThreadPool, MoveTemp(RunSession));
+    }
+    else
+    {
+        // a governed search starts on a background worker too, not only its helpers
+        AsyncTask(Session->Request.UseBackgroundThreads ? ENamedThreads::AnyBackgroundThreadNormalTask : ENamedThreads::AnyThread, MoveTemp(RunSession));
+    }
+}
 
-    AsyncTask(ENamedThreads::AnyThread, [this, ActiveBoard, IsWhiteAI, CompleteCallback, Depth]
+void UMinimaxAIComponent::FinishSession(const TSharedRef<FSearchSession, ESPMode::ThreadSafe>& Session)
+{
+    CurrentSession.Reset();
+    LastSession = Session;
+    FEvaluationCacheStats& Stats = EvaluationCacheStats.FindOrAdd(Session->Difficulty);
+    Stats.Probes += Session->CacheStats.Probes;
+    Stats.Hits += Session->CacheStats.Hits;
+    if (ChessGod.IsValid())
     {
-        TArray<FIntPoint> Result;
+        // the lines first, so an analysis overlay is up to date when the move is played
+        ChessGod->OnAIFinishedAnalysis.Broadcast(Session->Lines);
+        ChessGod->OnAIFinishedCalculatingMove.Broadcast(Session->From, Session->To);
+    }
+}
 
-        map<int32, Cell*> board = ActiveBoard->board_map;
-        MoveResult ai_result = MiniMax(ActiveBoard, board, Depth, IsWhiteAI, -9000.f, 9000.f);
+FSearchReport UMinimaxAIComponent::SearchNow(Board* ActiveBoard, bool IsWhiteAI, int32 MaxDepth, int32 TimeBudgetMs, EParallelSearch ParallelSearch, UEvaluationWeights* EvaluationWeights, int32 ThreadCount)
+{
+    const TSharedRef<FSearchSession, ESPMode::ThreadSafe> Session = MakeSession(ActiveBoard, IsWhiteAI, MaxDepth, TimeBudgetMs, ParallelSearch, EvaluationWeights, EAIDifficulty::Easy);
+    Session->ReportsToGameThread = false;
+    if (ThreadCount > 0)
+    {
+        Session->Request.ThreadCount = ThreadCount;
+    }
+    if (Search == nullptr)
+    {
+        Search = new FMinimaxSearch();
+    }
+    RunSearchSession(Session);
 
-        Position FromPosition = ActiveBoard->to_position(ai_result.FromKey);
-        Position ToPosition = ActiveBoard->to_position(ai_result.ToKey);
+    FSearchReport Report;
+    Report.Depths = Session->Depths;
+    Report.From = Session->From;
+    Report.To = Session->To;
+    Report.Lines = Session->Lines;
+    return Report;
+}
 
-        Result.Add(FIntPoint{FromPosition.x, FromPosition.y});
-        Result.Add(FIntPoint{ToPosition.x, ToPosition.y});
+void UMinimaxAIComponent::ClearSearchState()
+{
+    if (Search != nullptr)
+    {
+        Search->Clear();
+    }
+}
 
-        CompleteCallback(Result);
-    });
+bool UMinimaxAIComponent::FindKnownMove(Board* ActiveBoard, bool IsWhitePlayer, FIntPoint& OutFrom, FIntPoint& OutTo) const
+{
+    PackedBoard Position = ActiveBoard->to_packed_board();
+    Position.set_white_to_move(IsWhitePlayer);
+    TArray<MoveResult> Line;
+    if (Search != nullptr && Search->ProbeLine(ActiveBoard, Position, 1, Line))
+    {
+        OutFrom = KeyToCellPosition(Line[0].FromKey);
+        OutTo = KeyToCellPosition(Line[0].ToKey);
+        return true;
+    }
+
+    // the ponder search may have overwritten the entry, but it started from the reply the AI expected in this very position
+    if (PonderSession.IsValid() && PonderSession->Request.IsWhiteAI != IsWhitePlayer)
+    {
+        const int32 From = ToCellIndex(PonderSession->PonderFrom);
+        const int32 To = ToCellIndex(PonderSession->PonderTo);
+        if (From >= 0 && To >= 0 && Position.cells[From].has_piece())
+        {
+            Position.make_move(From, To);
+            if (Position == PonderSession->Request.Position)
+            {
+                OutFrom = PonderSession->PonderFrom;
+                OutTo = PonderSession->PonderTo;
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
-MoveResult UMinimaxAIComponent::MiniMax(Board* ActiveBoard, map<int32, Cell*>& in_board_map, int32 Depth, bool IsWhitePlayer, int32 Alpha, int32 Beta)
+void UMinimaxAIComponent::StartHintSearch(Board* ActiveBoard, bool IsWhitePlayer, int32 TimeBudgetMs)
 {
-    if (Depth == 0)
+    if (HintSession.IsValid())
     {
-        return MoveResult(0, 0, ActiveBoard->evaluate(in_board_map));
+        HintSession->IsCancelled = true;
+        HintSession.Reset();
     }
+    // the search runs one request at a time; a ponder that has nothing on this position in the table is worth less than the hint
+    if (PonderSession.IsValid())
+    {
+        PonderSession->IsCancelled = true;
+        PonderSession.Reset();
+    }
+
+    // the strongest evaluation and no depth cap, the time budget alone bounds it
+    const TSharedRef<FSearchSession, ESPMode::ThreadSafe> Session = MakeSession(ActiveBoard, IsWhitePlayer, 64, FMath::Max(TimeBudgetMs, 1), EParallelSearch::LazySMP, nullptr, EAIDifficulty::Hard);
+    Session->IsHint = true;
+    Session->Request.ThreadCount = 1;
+    Session->Request.Settings.MultiPV = 1;
+    HintSession = Session;
+    LaunchSession(Session);
+}
 
-    MoveResult Result;
-    if (IsWhitePlayer)
+bool UMinimaxAIComponent::StartPrewarm(Board* ActiveBoard, bool IsWhiteAI, EAIDifficulty Difficulty, int32 TimeBudgetMs)
+{
+    if (CurrentSession.IsValid() || PonderSession.IsValid() || HintSession.IsValid() || PrewarmSession.IsValid())
+    {
+        return false;
+    }
+    // whatever the difficulty, a later game may want them; the tablebase files are mapped on the search thread
+    if (UseNetwork)
+    {
+        GetNetwork();
+    }
+    if (UseTablebase)
     {
-        int32 MaxEval = -9000;
-        list<int32> PieceKeys = ActiveBoard->get_piece_keys(in_board_map, Cell::PieceColor::white);
-        for (int32 piece : PieceKeys) {
-            list<int32> MoveKeys = ActiveBoard->get_valid_moves(in_board_map, piece);
-            for (int32 move : MoveKeys) {
-                auto board_copy = ActiveBoard->copy_board_map(in_board_map);
-                Position start = ActiveBoard->to_position(piece);
-                Position goal = ActiveBoard->to_position(move);
-                ActiveBoard->move_piece(board_copy, start, goal);
-                MoveResult child_result = MiniMax(ActiveBoard, board_copy, Depth - 1, false, Alpha, Beta);
+        GetTablebase();
+    }
+    // every thread, so each pool thread has started and each worker's evaluation cache is allocated
+    const TSharedRef<FSearchSession, ESPMode::ThreadSafe> Session = MakeSession(ActiveBoard, IsWhiteAI, 64, FMath::Max(TimeBudgetMs, 1), EParallelSearch::LazySMP, nullptr, Difficulty);
+    Session->IsPrewarm = true;
+    PrewarmSession = Session;
+    LaunchSession(Session);
+    return true;
+}
 
-                ActiveBoard->clear_board_map(board_copy);
-                if (child_result.Score > MaxEval)
-                {
-                    Result.FromKey = piece;
-                    Result.ToKey = move;
-                }
-                MaxEval = FMath::Max(MaxEval, child_result.Score);
+void UMinimaxAIComponent::CancelSearch()
+{
+    if (HintSession.IsValid())
+    {
+        HintSession->IsCancelled = true;
+        HintSession.Reset();
+    }
+    if (CurrentSession.IsValid())
+    {
+        CurrentSession->IsCancelled = true;
+        CurrentSession.Reset();
+    }
+    if (PonderSession.IsValid())
+    {
+        PonderSession->IsCancelled = true;
+        PonderSession.Reset();
+    }
+    if (PrewarmSession.IsValid())
+    {
+        PrewarmSession->IsCancelled = true;
+        PrewarmSession.Reset();
+    }
+    LastSession.Reset();
+}
 
-                // pruning
-                Alpha = FMath::Max(Alpha, child_result.Score);
-                if (Beta <= Alpha)
-                {
-                    break;
-                }
+void UMinimaxAIComponent::DispatchSearchProgress()
+{
+    if (ProgressQueue == nullptr)
+    {
+        return;
+    }
+    FSearchProgressEvent Event;
+    while (ProgressQueue->try_pop(Event))
+    {
+        // depths of a search cancelled or replaced since are dropped, as are a ponder search's until the ponder hit
+        if (Event.Session.IsValid() && CurrentSession == Event.Session)
+        {
+            OnSearchProgress.Broadcast(Event.Progress);
+        }
+    }
+}
+
+bool UMinimaxAIComponent::IsCalculatingMove() const
+{
+    return CurrentSession.IsValid();
+}
+
+float UMinimaxAIComponent::GetEvaluationCacheHitRate(EAIDifficulty Difficulty) const
+{
+    const FEvaluationCacheStats* Stats = EvaluationCacheStats.Find(Difficulty);
+    return Stats != nullptr ? Stats->GetHitRate() : 0.0f;
+}
+
+void UMinimaxAIComponent::RunSearchSession(const TSharedRef<FSearchSession, ESPMode::ThreadSafe>& Session)
+{
+    const TWeakObjectPtr<UMinimaxAIComponent> WeakThis(this);
+
+    if (Session->IsPrewarm && Session->Request.Tablebase.IsValid())
+    {
+        Session->Request.Tablebase->Prefetch();
+    }
+
+    // one search at a time owns the table and the workers; a cancelled one gives them up within a few thousand nodes
+    FSearchProgressQueue* Queue = ProgressQueue;
+    const FMinimaxResult Result = Search->Run(Session->Request, Session->IsCancelled, [&Session, Queue](const FMinimaxDepthReport& Report)
+    {
+        FSearchProgress Progress;
+        Progress.Depth = Report.Depth;
+        Progress.Score = Report.Score;
+        Progress.Nodes = Report.Nodes;
+        Progress.ElapsedSeconds = static_cast<float>(Report.ElapsedSeconds);
+        Progress.NodesPerSecond = Report.ElapsedSeconds > 0.0 ? static_cast<int64>(Report.Nodes / Report.ElapsedSeconds) : 0;
+        Progress.TableProbes = Report.TableProbes;
+        Progress.TableHits = Report.TableHits;
+        Progress.EvaluationCache.Probes = Report.EvaluationProbes;
+        Progress.EvaluationCache.Hits = Report.EvaluationHits;
+        UE_LOG(LogTemp, Log, TEXT("MinimaxAI: depth %d, score %d, %lld nodes, %lld nps, evaluation cache hit rate %.1f%%"), Progress.Depth, Progress.Score, Progress.Nodes, Progress.NodesPerSecond, Progress.EvaluationCache.GetHitRate() * 100.0f);
+        Session->Depths.Add(Progress);
+        // no task per depth: ChessGod's tick drains the queue; a full queue only loses the progress display, Depths keeps every depth
+        if (Session->ReportsToGameThread && !Queue->try_push(FSearchProgressEvent{Session, Progress}))
+        {
+            UE_LOG(LogTemp, Verbose, TEXT("MinimaxAI: progress queue full, depth %d not reported"), Progress.Depth);
+        }
+    });
+
+    if (Session->IsPrewarm)
+    {
+        // the table, the caches and the threads are warm whether it finished or a real search cancelled it
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, Session]
+        {
+            if (!WeakThis.IsValid())
+            {
+                return;
+            }
+            if (WeakThis->PrewarmSession.Get() == &Session.Get())
+            {
+                WeakThis->PrewarmSession.Reset();
+            }
+            if (WeakThis->ChessGod.IsValid())
+            {
+                WeakThis->ChessGod->OnAIPrewarmed.Broadcast();
             }
+        });
+        return;
+    }
+    if (!Result.IsComplete)
+    {
+        return;
+    }
+
+    Session->From = KeyToCellPosition(Result.Move.FromKey);
+    Session->To = KeyToCellPosition(Result.Move.ToKey);
+    Session->CacheStats.Probes = Result.EvaluationProbes;
+    Session->CacheStats.Hits = Result.EvaluationHits;
+    Session->HasPonderMove = Result.PonderMove.FromKey != Result.PonderMove.ToKey;
+    Session->PonderFrom = KeyToCellPosition(Result.PonderMove.FromKey);
+    Session->PonderTo = KeyToCellPosition(Result.PonderMove.ToKey);
+    for (const FMinimaxLine& Line : Result.Lines)
+    {
+        FSearchLine& SearchLine = Session->Lines.AddDefaulted_GetRef();
+        SearchLine.Score = Line.Score;
+        for (const MoveResult& Move : Line.Moves)
+        {
+            SearchLine.Moves.Add(KeyToCellPosition(Move.FromKey));
+            SearchLine.Moves.Add(KeyToCellPosition(Move.ToKey));
         }
-        Result.Score = MaxEval;
     }
-    else
+    if (!Session->ReportsToGameThread)
     {
-        int32 MinEval = 9000;
-        list<int32> PieceKeys = ActiveBoard->get_piece_keys(in_board_map, Cell::PieceColor::black);
-        for (int32 piece : PieceKeys) {
-            list<int32> MoveKeys = ActiveBoard->get_valid_moves(in_board_map, piece);
-            for (int32 move : MoveKeys) {
-                auto board_copy = ActiveBoard->copy_board_map(in_board_map);
-                Position start = ActiveBoard->to_position(piece);
-                Position goal = ActiveBoard->to_position(move);
-                ActiveBoard->move_piece(board_copy, start, goal);
-                MoveResult child_result = MiniMax(ActiveBoard, board_copy, Depth - 1, true, Alpha, Beta);
-
-                ActiveBoard->clear_board_map(board_copy);
-                if (child_result.Score < MinEval)
-                {
-                    Result.FromKey = piece;
-                    Result.ToKey = move;
-                }
-                MinEval = FMath::Min(MinEval, child_result.Score);
+        return;
+    }
 
-                // pruning
-                Beta = FMath::Min(Beta, child_result.Score);
-                if (Beta <= Alpha)
+    AsyncTask(ENamedThreads::GameThread, [WeakThis, Session]
+    {
+        if (!WeakThis.IsValid())
+        {
+            return;
+        }
+        // the session's last depths are still queued, report them before its move
+        WeakThis->DispatchSearchProgress();
+        if (Session->IsHint)
+        {
+            if (WeakThis->HintSession.Get() == &Session.Get())
+            {
+                WeakThis->HintSession.Reset();
+                if (WeakThis->ChessGod.IsValid())
                 {
-                    break;
+                    WeakThis->ChessGod->OnHintReady.Broadcast(Session->From, Session->To);
                 }
             }
+            return;
+        }
+        // still pondering: the move is only played once the opponent makes the expected reply
+        if (WeakThis->PonderSession.Get() == &Session.Get())
+        {
+            Session->HasFinished = true;
+            return;
+        }
+        // a search cancelled or replaced after it finished must not play its move either
+        if (WeakThis->CurrentSession.Get() == &Session.Get())
+        {
+            WeakThis->FinishSession(Session);
+        }
+    });
+}
+
+int32 UMinimaxAIComponent::GetSearchThreadCount() const
+{
+    int32 ThreadCount = 0;
+    if (const UWorld* World = GetWorld())
+    {
+        if (const UHexaGameInstance* GameInstance = World->GetGameInstance<UHexaGameInstance>())
+        {
+            ThreadCount = GameInstance->AIThreadCount;
         }
-        Result.Score = MinEval;
     }
+    if (ThreadCount <= 0)
+    {
+        // the task graph workers plus the thread that starts the search
+        ThreadCount = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    }
+    // the search starts on a pool thread too, the helpers must all fit next to it
+    if (const FQueuedThreadPool* ThreadPool = GetSearchThreadPool())
+    {
+        ThreadCount = FMath::Min(ThreadCount, ThreadPool->GetNumThreads());
+    }
+    return FMath::Clamp(ThreadCount, 1, 64);
+}
+
+FQueuedThreadPool* UMinimaxAIComponent::GetSearchThreadPool() const
+{
+    if (const UWorld* World = GetWorld())
+    {
+        if (const UHexaGameInstance* GameInstance = World->GetGameInstance<UHexaGameInstance>())
+        {
+            return GameInstance->GetAIThreadPool();
+        }
+    }
+    return nullptr;
+}
 
-    return Result;
+ESearchPowerMode UMinimaxAIComponent::GetSearchPowerMode() const
+{
+    if (!UseSearchGovernor)
+    {
+        return ESearchPowerMode::Full;
+    }
+    const ETemperatureSeverity Temperature = static_cast<ETemperatureSeverity>(TemperatureSeverity.load());
+    // -1 on platforms that do not know, and plugged in the battery does not matter
+    const int32 BatteryLevel = FPlatformMisc::IsRunningOnBattery() ? FPlatformMisc::GetBatteryLevel() : -1;
+    if (Temperature >= ETemperatureSeverity::Serious || IsLowPowerMode || (BatteryLevel >= 0 && BatteryLevel <= SaverBatteryLevel))
+    {
+        return ESearchPowerMode::Saver;
+    }
+    if (Temperature == ETemperatureSeverity::Bad || (BatteryLevel >= 0 && BatteryLevel <= BalancedBatteryLevel))
+    {
+        return ESearchPowerMode::Balanced;
+    }
+    return ESearchPowerMode::Full;
+}
+
+void UMinimaxAIComponent::ApplySearchGovernor(FSearchSession& Session) const
+{
+    FMinimaxRequest& Request = Session.Request;
+    switch (GetSearchPowerMode())
+    {
+    case ESearchPowerMode::Balanced:
+        // lazy SMP gains far less than linearly from its helpers, half of them cost little strength
+        Request.ThreadCount = FMath::Max(Request.ThreadCount / 2, 1);
+        Request.UseBackgroundThreads = true;
+        break;
+    case ESearchPowerMode::Saver:
+        Request.ThreadCount = 1;
+        Request.UseBackgroundThreads = true;
+        // one slow thread would finish far fewer depths on the usual clock; the difficulty's node budget keeps its strength,
+        // the longer clock only stops a search the device is too slow to finish
+        if (Request.NodeBudget == 0)
+        {
+            Request.NodeBudget = AChessGod::GetAIDifficultyNodeBudget(Session.Difficulty);
+            Request.TimeBudgetMs = FMath::CeilToInt(Request.TimeBudgetMs * SaverTimeScale);
+        }
+        break;
+    default:
+        break;
+    }
 }
@@ -1,13 +1,16 @@
 #pragma once
 
-#include <map>
+#include <atomic>
 
 #include "Async/Async.h"
 #include "CoreMinimal.h"
 
 #include "Types/AIType.h"
-#include "Types/MoveResult.h"
+#include "Types/EvaluationCacheStats.h"
 #include "Types/PieceInfo.h"
+#include "Types/SearchLine.h"
+#include "Types/SearchProgress.h"
+#include "Types/SearchReport.h"
 
 #include "MinimaxAI.generated.h"
 
@@ -15,7 +18,16 @@ using namespace std;
 
 class AChessGod;
 class Board;
-class Cell;
+class Evaluator;
+class FMinimaxSearch;
+class FQueuedThreadPool;
+class FTablebase;
+struct FMinimaxSettings;
+class UEvaluationWeights;
+struct FSearchProgressQueue;
+struct FSearchSession;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSearchProgress, const FSearchProgress&, Progress);
 
 
 UCLASS()
@@ -26,17 +38,238 @@ class HEXACHESS_API UMinimaxAIComponent : public UActorComponent
 public:
 
 	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	void BeginDestroy() override;
+
+    // searches depth 1, 2, ... up to MaxDepth until TimeBudgetMs runs out, then plays the best move of the deepest finished depth
+    // ParallelSearch picks how the search threads share the work
+    // EvaluationWeights scores the leaves, without it the board's own evaluation is used
+    // Difficulty only says which entry of EvaluationCacheStats the search is counted under
+    // NodeBudget above 0 also stops the search once it has visited that many nodes; such a search runs on one thread and never ponders,
+    // so with a TimeBudgetMs of 0 it plays the same move for the same game on any machine
+    // the position is copied before this returns, and a search still running for an earlier request is cancelled
+    void StartCalculatingMove(Board* ActiveBoard, bool IsWhiteAI, int32 MaxDepth, int32 TimeBudgetMs, EParallelSearch ParallelSearch = EParallelSearch::LazySMP, UEvaluationWeights* EvaluationWeights = nullptr, EAIDifficulty Difficulty = EAIDifficulty::Easy, int64 NodeBudget = 0);
+
+    // the same search as StartCalculatingMove, run to the end on the calling thread; nothing is broadcast
+    // for tools without a game thread loop, such as the search benchmark; ThreadCount 0 means the usual count
+    FSearchReport SearchNow(Board* ActiveBoard, bool IsWhiteAI, int32 MaxDepth, int32 TimeBudgetMs, EParallelSearch ParallelSearch = EParallelSearch::LazySMP, UEvaluationWeights* EvaluationWeights = nullptr, int32 ThreadCount = 0);
+
+    // tells the AI a move was played on the board, call it once the board has the move; cancels the search for the old position
+    // the AI's own move starts pondering on the reply it expects, and that reply keeps the ponder search alive for StartCalculatingMove
+    void NotifyMovePlayed(Board* ActiveBoard, FIntPoint From, FIntPoint To);
+
+    // forgets the transposition table, the move ordering history and the evaluation caches, so the next search starts cold
+    void ClearSearchState();
+
+    // the best move of a side in the board's position as far as the AI's searches already know it, without searching:
+    // the transposition table's move for the position, or the reply a ponder search running on it expects
+    bool FindKnownMove(Board* ActiveBoard, bool IsWhitePlayer, FIntPoint& OutFrom, FIntPoint& OutTo) const;
+
+    // a short search of the position on one thread for a hint, sharing the AI's table; its move goes to ChessGod's OnHintReady
+    // a ponder search is stopped for it, and it is dropped like the AI's own searches when the position changes
+    void StartHintSearch(Board* ActiveBoard, bool IsWhitePlayer, int32 TimeBudgetMs);
+
+    // loads the network and the tablebase files and runs a short search of the position on every thread, so the first move
+    // of a game does not pay for them; ChessGod's OnAIPrewarmed follows once it ends, finished or cancelled by a real search
+    // false when a search is already running, nothing is started then
+    bool StartPrewarm(Board* ActiveBoard, bool IsWhiteAI, EAIDifficulty Difficulty, int32 TimeBudgetMs);
 
-    void StartCalculatingMove(Board* ActiveBoard, bool IsWhiteAI, int32 Depth);
+    // drops the current search, any pondering, hint or warm-up search, their progress and moves are never reported; call it whenever the position it was started for goes away
+    UFUNCTION(BlueprintCallable)
+    void CancelSearch();
 
-    // minmax algorithm
-    // - we need to get all the possible moves for the AI
-    // - for each move, we need to get all the possible moves for the player
-    // - repeat the recursion until the depth limit is reached
-    // - evaluate the board state for all bottom nodes (it's recursion exit point)
-    // - keep going up taking other min or max values among the siblings' values
-    // - last step should give you the best move; return it
-	MoveResult MiniMax(Board* ActiveBoard, map<int32, Cell*>& in_board, int32 Depth, bool IsWhitePlayer, int32 Alpha, int32 Beta);
+    UFUNCTION(BlueprintCallable)
+    bool IsCalculatingMove() const;
+
+    // Saver when the device is seriously hot, in low power mode or on a nearly empty battery, Balanced when it is warm or
+    // its battery is half empty, Full otherwise and always without UseSearchGovernor; only StartCalculatingMove follows it
+    UFUNCTION(BlueprintCallable)
+    ESearchPowerMode GetSearchPowerMode() const;
+
+    // broadcasts the depths the searches finished since the last call; ChessGod calls it every tick
+    void DispatchSearchProgress();
+
+    // raised on the game thread after every finished depth of the current search, at the next tick
+    UPROPERTY(BlueprintAssignable)
+    FOnSearchProgress OnSearchProgress;
+
+    // evaluation cache use summed over every finished search, per difficulty; only the game thread writes it
+    UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "AI")
+    TMap<EAIDifficulty, FEvaluationCacheStats> EvaluationCacheStats;
+
+    UFUNCTION(BlueprintCallable)
+    float GetEvaluationCacheHitRate(EAIDifficulty Difficulty) const;
 
 	TWeakObjectPtr<AChessGod> ChessGod;
+
+	// memory budget of the transposition table, rounded down to a power-of-two number of entries
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 TranspositionTableSizeMB = 16;
+
+	// memory budget of each search thread's evaluation cache, small enough to stay in the core's L2
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 EvaluationCacheSizeKB = 256;
+
+	// plain alpha-beta, or principal variation search (null windows after the first move) with aspiration windows at the root
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	ESearchMode SearchMode = ESearchMode::PrincipalVariation;
+
+	// half width of the root aspiration window, in evaluation units (a pawn is 100)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 AspirationWindow = 25;
+
+	// resolve captures at the leaves instead of evaluating them as they stand
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UseQuiescence = true;
+
+	// how many captures deep the quiescence search may go
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 QuiescenceDepth = 8;
+
+	// safety margin on top of the captured piece's value before a capture is skipped by delta pruning
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 QuiescenceDeltaMargin = 200;
+
+	// skip the quiescence captures the static exchange evaluation says lose material
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UseExchangePruning = true;
+
+	// young brothers wait only shares the siblings of nodes with at least this much depth left
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 SplitMinDepth = 3;
+
+	// null-move pruning: a position still above beta after passing the move is cut off without searching its moves
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UseNullMove = true;
+
+	// how much shallower the null move's reply is searched
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 NullMoveReduction = 2;
+
+	// late move reductions: quiet moves late in the ordering are searched shallower first, and again at full depth if they beat alpha
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UseLateMoveReductions = true;
+
+	// nodes with less depth left, and the first moves of every node, are never reduced
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 LateMoveMinDepth = 3;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 LateMoveMinIndex = 3;
+
+	// how many of the best moves get a line in OnAIFinishedAnalysis; every line after the first costs another search at the final depth
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (ClampMin = "1"))
+	int32 MultiPV = 1;
+
+	// search the position after the expected reply while the opponent thinks; when the reply comes, the search just carries on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UsePondering = true;
+
+	// endings with few enough pieces are looked up in the tablebase files instead of searched
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UseTablebase = true;
+
+	// where the tablebase files are, relative to the content directory; generated by the Tablebase commandlet
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	FString TablebaseDirectory = TEXT("Tablebases");
+
+	// difficulties from NetworkMinDifficulty up evaluate with the neural network instead of their evaluation weights
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UseNetwork = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	EAIDifficulty NetworkMinDifficulty = EAIDifficulty::Hard;
+
+	// where the network's weights are, relative to the content directory; without the file every difficulty keeps its weights
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	FString NetworkFile = TEXT("Networks/Hexachess.hxnn");
+
+	// throttles the AI's move searches on a hot device or a draining battery, see GetSearchPowerMode
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool UseSearchGovernor = true;
+
+	// battery percentages, while running on battery, at or below which the searches turn Balanced and Saver
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (ClampMin = "0", ClampMax = "100"))
+	int32 BalancedBatteryLevel = 50;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (ClampMin = "0", ClampMax = "100"))
+	int32 SaverBatteryLevel = 20;
+
+	// a Saver search may take this many times the difficulty's time budget to reach its node budget before the clock stops it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (ClampMin = "1"))
+	float SaverTimeScale = 4.0f;
+
+private:
+
+	// the UPROPERTY knobs, as the search takes them
+	FMinimaxSettings MakeSearchSettings() const;
+
+	// copies the position and the request into a new session
+	TSharedRef<FSearchSession, ESPMode::ThreadSafe> MakeSession(Board* ActiveBoard, bool IsWhiteAI, int32 MaxDepth, int32 TimeBudgetMs, EParallelSearch ParallelSearch, UEvaluationWeights* EvaluationWeights, EAIDifficulty Difficulty, int64 NodeBudget = 0);
+
+	// starts the session's search on a background thread
+	void LaunchSession(const TSharedRef<FSearchSession, ESPMode::ThreadSafe>& Session);
+
+	// searches the position after Played's move and its expected reply, with Played's limits
+	void StartPondering(Board* ActiveBoard, const FSearchSession& Played);
+
+	// counts the session's cache use and plays its move
+	void FinishSession(const TSharedRef<FSearchSession, ESPMode::ThreadSafe>& Session);
+
+	// runs on a background thread; waits for an earlier cancelled search to let go of the workers first
+	void RunSearchSession(const TSharedRef<FSearchSession, ESPMode::ThreadSafe>& Session);
+
+	// waits for the searches still running, then frees the search and what it keeps between moves
+	void ReleaseSearchState();
+
+	// AIThreadCount from the game instance, 0 there means one per task graph worker; never more than the AI thread pool has
+	int32 GetSearchThreadCount() const;
+
+	// the game instance's AI thread pool, nullptr when it has none
+	FQueuedThreadPool* GetSearchThreadPool() const;
+
+	// cuts a move search's threads, priority and clock down to the power mode; a search with its own node budget keeps it
+	void ApplySearchGovernor(FSearchSession& Session) const;
+
+	// the platform reports these on whatever thread it likes, the game thread reads them when a search starts
+	std::atomic<uint8> TemperatureSeverity{0};
+	std::atomic<bool> IsLowPowerMode{false};
+	FDelegateHandle TemperatureChangeHandle;
+	FDelegateHandle LowPowerModeHandle;
+
+	// the request the game thread is waiting on; only the game thread touches it
+	TSharedPtr<FSearchSession, ESPMode::ThreadSafe> CurrentSession;
+
+	// the search running on the opponent's time, and the session whose move was played last that it would ponder after
+	TSharedPtr<FSearchSession, ESPMode::ThreadSafe> PonderSession;
+	TSharedPtr<FSearchSession, ESPMode::ThreadSafe> LastSession;
+
+	// the hint search the game thread is waiting on
+	TSharedPtr<FSearchSession, ESPMode::ThreadSafe> HintSession;
+
+	// the warm-up search, its move is never reported
+	TSharedPtr<FSearchSession, ESPMode::ThreadSafe> PrewarmSession;
+
+	// searches started but not yet returned, EndPlay waits for them
+	std::atomic<int32> PendingSearches{0};
+
+	// the finished depths the search thread publishes and DispatchSearchProgress drains, without a task graph task per depth
+	FSearchProgressQueue* ProgressQueue = nullptr;
+
+	// finds the tablebase files the first time a search wants them; null when there are none
+	const TSharedPtr<const FTablebase, ESPMode::ThreadSafe>& GetTablebase();
+
+	// shared with the searches that probe it, so it outlives the component if a search is still running
+	TSharedPtr<const FTablebase, ESPMode::ThreadSafe> Tablebase;
+	bool HasLookedForTablebase = false;
+
+	// loads the network the first time a search wants it; null when there is no valid file
+	const TSharedPtr<const Evaluator, ESPMode::ThreadSafe>& GetNetwork();
+
+	// shared with the searches that evaluate with it, like the tablebase
+	TSharedPtr<const Evaluator, ESPMode::ThreadSafe> Network;
+	bool HasLookedForNetwork = false;
+
+	// the search itself, with the transposition table and per-thread state it keeps between moves
+	FMinimaxSearch* Search = nullptr;
 };
@@ -0,0 +1,213 @@
+#include "AISearchBenchmarkCommandlet.h"
+
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+
+#include "Actors/ChessGod.h"
+#include "Chess/ChessEngine.h"
+#include "Chess/MinimaxAI.h"
+#include "Commandlets/BenchmarkBaseline.h"
+
+namespace
+{
+    struct FBenchmarkPosition
+    {
+        const TCHAR* Name;
+        bool IsWhiteToMove;
+        // pieces as letter and x,y position, upper case white and lower case black; empty for the starting position
+        const TCHAR* Pieces;
+    };
+
+    // taken from self-play, from the opening to a thin endgame, so both wide and narrow trees are covered
+    const FBenchmarkPosition BenchmarkPositions[] = {
+        {TEXT("Start"), true, TEXT("")},
+        {TEXT("Opening"), true, TEXT("R1,0 p1,5 P2,1 N2,3 p2,6 n2,7 P3,2 p3,6 r3,8 Q4,0 p4,5 q4,9 B5,0 B5,1 B5,2 P5,4 b5,9 b5,10 K6,0 P6,3 p6,6 k6,9 R7,0 P7,2 p7,6 r7,8 N8,0 P8,1 p8,6 P9,0 n9,2 p9,6")},
+        {TEXT("Middlegame"), true, TEXT("P1,1 p1,6 P2,2 p2,6 n2,7 R3,0 P3,2 p3,4 b3,7 r3,8 Q4,0 P4,3 p4,6 B5,0 B5,2 P5,4 p5,5 k5,9 K6,0 P6,3 p6,6 P7,2 r7,6 N8,0 n8,7 P9,0 p9,4")},
+        {TEXT("Tactical"), true, TEXT("R0,3 b1,0 N1,2 p1,6 P2,1 p2,6 R3,0 P3,2 p3,6 P4,4 r4,9 B5,0 B5,1 p5,6 b5,9 b5,10 K6,0 P6,3 p6,6 k6,9 P7,2 p7,4 r7,8 p8,6 n8,7 P9,0 N9,4 p9,5 n10,3")},
+        {TEXT("LateMiddlegame"), true, TEXT("N0,1 P1,1 p1,5 P2,2 p2,6 p3,4 r3,8 R4,2 P4,3 P5,4 p5,5 p5,6 Q6,0 K6,1 N6,3 n6,5 k6,9 P7,3 p7,6 r7,7 B8,4 p9,6")},
+        {TEXT("Endgame"), true, TEXT("P1,1 B1,6 n2,5 p2,6 Q4,0 B5,0 N5,2 P5,4 r5,10 K6,0 P6,3 p6,6 P7,2 p7,6 p8,6 n8,7 p9,3 k10,4")},
+        {TEXT("RookEndgame"), true, TEXT("R3,0 P5,4 K6,0 p4,6 k6,9")},
+    };
+
+    bool ParsePieces(const TCHAR* Pieces, Board& OutBoard)
+    {
+        TArray<FString> Tokens;
+        FString(Pieces).ParseIntoArrayWS(Tokens);
+        for (const FString& Token : Tokens)
+        {
+            FString X;
+            FString Y;
+            if (Token.Len() < 4 || !Token.RightChop(1).Split(TEXT(","), &X, &Y))
+            {
+                return false;
+            }
+            const TCHAR Letter = Token[0];
+            const Cell::PieceColor Color = FChar::IsUpper(Letter) ? Cell::PieceColor::white : Cell::PieceColor::black;
+            Cell::PieceType Type = Cell::PieceType::none;
+            switch (FChar::ToUpper(Letter))
+            {
+            case TEXT('P'):
+                Type = Cell::PieceType::pawn;
+                break;
+            case TEXT('N'):
+                Type = Cell::PieceType::knight;
+                break;
+            case TEXT('B'):
+                Type = Cell::PieceType::bishop;
+                break;
+            case TEXT('R'):
+                Type = Cell::PieceType::rook;
+                break;
+            case TEXT('Q'):
+                Type = Cell::PieceType::queen;
+                break;
+            case TEXT('K'):
+                Type = Cell::PieceType::king;
+                break;
+            default:
+                return false;
+            }
+            Position PiecePosition = Position{FCString::Atoi(*X), FCString::Atoi(*Y)};
+            if (!OutBoard.set_piece(PiecePosition, Type, Color))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+UAISearchBenchmarkCommandlet::UAISearchBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UAISearchBenchmarkCommandlet::Main(const FString& Params)
+{
+    int32 MaxDepth = 5;
+    int32 TimeBudgetMs = 30000;
+    int32 ThreadCount = 0;
+    FString ParallelName = TEXT("lazysmp");
+    FString PositionFilter;
+    FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("AISearchBenchmark.csv");
+    FString JsonPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("AISearchBenchmark.json");
+    FParse::Value(*Params, TEXT("depth="), MaxDepth);
+    FParse::Value(*Params, TEXT("time="), TimeBudgetMs);
+    FParse::Value(*Params, TEXT("threads="), ThreadCount);
+    FParse::Value(*Params, TEXT("parallel="), ParallelName);
+    FParse::Value(*Params, TEXT("position="), PositionFilter);
+    FParse::Value(*Params, TEXT("csv="), CsvPath);
+    FParse::Value(*Params, TEXT("json="), JsonPath);
+    const EParallelSearch ParallelSearch = ParallelName == TEXT("ybw") ? EParallelSearch::YoungBrothersWait : EParallelSearch::LazySMP;
+
+    UMinimaxAIComponent* Search = NewObject<UMinimaxAIComponent>(GetTransientPackage());
+
+    FString Csv = TEXT("Position,Depth,Score,Nodes,DepthNodes,NodesPerSecond,Seconds,TableHitRate,EvaluationCacheHitRate,BranchingFactor,Move\n");
+    TArray<TSharedPtr<FJsonValue>> JsonPositions;
+    FBenchmarkBaseline Metrics;
+    int32 Result = 0;
+
+    for (const FBenchmarkPosition& BenchmarkPosition : BenchmarkPositions)
+    {
+        if (!PositionFilter.IsEmpty() && PositionFilter != BenchmarkPosition.Name)
+        {
+            continue;
+        }
+
+        Board PositionBoard;
+        if (BenchmarkPosition.Pieces[0] == 0)
+        {
+            PositionBoard.set_position(Board::starting_position());
+        }
+        else if (!ParsePieces(BenchmarkPosition.Pieces, PositionBoard))
+        {
+            UE_LOG(LogTemp, Error, TEXT("AISearchBenchmark: %s has a malformed piece list"), BenchmarkPosition.Name);
+            Result = 1;
+            continue;
+        }
+
+        Search->ClearSearchState();
+        const FSearchReport Report = Search->SearchNow(&PositionBoard, BenchmarkPosition.IsWhiteToMove, MaxDepth, TimeBudgetMs, ParallelSearch, nullptr, ThreadCount);
+        const FString Move = FString::Printf(TEXT("(%d %d)-(%d %d)"), Report.From.X, Report.From.Y, Report.To.X, Report.To.Y);
+
+        TArray<TSharedPtr<FJsonValue>> JsonDepths;
+        int64 PreviousNodes = 0;
+        int64 PreviousDepthNodes = 0;
+        for (int32 Index = 0; Index < Report.Depths.Num(); Index++)
+        {
+            const FSearchProgress& Progress = Report.Depths[Index];
+            // node counts add up over the iterations, the nodes of one depth are the difference
+            const int64 DepthNodes = Progress.Nodes - PreviousNodes;
+            const double BranchingFactor = PreviousDepthNodes > 0 ? static_cast<double>(DepthNodes) / PreviousDepthNodes : 0.0;
+            const double TableHitRate = Progress.TableProbes > 0 ? static_cast<double>(Progress.TableHits) / Progress.TableProbes : 0.0;
+            const bool IsDeepest = Index == Report.Depths.Num() - 1;
+            PreviousNodes = Progress.Nodes;
+            PreviousDepthNodes = DepthNodes;
+
+            Csv += FString::Printf(TEXT("%s,%d,%d,%lld,%lld,%lld,%.4f,%.4f,%.4f,%.3f,%s\n"), BenchmarkPosition.Name, Progress.Depth, Progress.Score, Progress.Nodes, DepthNodes,
+                Progress.NodesPerSecond, Progress.ElapsedSeconds, TableHitRate, Progress.EvaluationCache.GetHitRate(), BranchingFactor, IsDeepest ? *Move : TEXT(""));
+
+            const TSharedPtr<FJsonObject> JsonDepth = MakeShared<FJsonObject>();
+            JsonDepth->SetNumberField(TEXT("depth"), Progress.Depth);
+            JsonDepth->SetNumberField(TEXT("score"), Progress.Score);
+            JsonDepth->SetNumberField(TEXT("nodes"), static_cast<double>(Progress.Nodes));
+            JsonDepth->SetNumberField(TEXT("depthNodes"), static_cast<double>(DepthNodes));
+            JsonDepth->SetNumberField(TEXT("nodesPerSecond"), static_cast<double>(Progress.NodesPerSecond));
+            JsonDepth->SetNumberField(TEXT("seconds"), Progress.ElapsedSeconds);
+            JsonDepth->SetNumberField(TEXT("tableHitRate"), TableHitRate);
+            JsonDepth->SetNumberField(TEXT("evaluationCacheHitRate"), Progress.EvaluationCache.GetHitRate());
+            JsonDepth->SetNumberField(TEXT("branchingFactor"), BranchingFactor);
+            JsonDepths.Add(MakeShared<FJsonValueObject>(JsonDepth));
+        }
+
+        if (Report.Depths.Num() > 0)
+        {
+            const FSearchProgress& Deepest = Report.Depths.Last();
+            UE_LOG(LogTemp, Display, TEXT("AISearchBenchmark: %s, depth %d, score %d, %lld nodes, %lld nps, %.3f s, move %s"),
+                BenchmarkPosition.Name, Deepest.Depth, Deepest.Score, Deepest.Nodes, Deepest.NodesPerSecond, Deepest.ElapsedSeconds, *Move);
+
+            // a search cut short by the time budget reaches a shallower depth, which its nodes and time would hide
+            Metrics.Add(FString::Printf(TEXT("%s.depth"), BenchmarkPosition.Name), Deepest.Depth, FBenchmarkBaseline::EDirection::HigherIsBetter);
+            Metrics.Add(FString::Printf(TEXT("%s.nodes"), BenchmarkPosition.Name), static_cast<double>(Deepest.Nodes), FBenchmarkBaseline::EDirection::LowerIsBetter);
+            Metrics.Add(FString::Printf(TEXT("%s.seconds"), BenchmarkPosition.Name), Deepest.ElapsedSeconds, FBenchmarkBaseline::EDirection::LowerIsBetter);
+        }
+
+        const TSharedPtr<FJsonObject> JsonPosition = MakeShared<FJsonObject>();
+        JsonPosition->SetStringField(TEXT("name"), BenchmarkPosition.Name);
+        JsonPosition->SetStringField(TEXT("move"), Move);
+        JsonPosition->SetArrayField(TEXT("depths"), JsonDepths);
+        JsonPositions.Add(MakeShared<FJsonValueObject>(JsonPosition));
+    }
+
+    const TSharedPtr<FJsonObject> Json = MakeShared<FJsonObject>();
+    Json->SetNumberField(TEXT("maxDepth"), MaxDepth);
+    Json->SetNumberField(TEXT("timeBudgetMs"), TimeBudgetMs);
+    Json->SetNumberField(TEXT("threads"), ThreadCount);
+    Json->SetStringField(TEXT("parallelSearch"), ParallelSearch == EParallelSearch::YoungBrothersWait ? TEXT("ybw") : TEXT("lazysmp"));
+    Json->SetArrayField(TEXT("positions"), JsonPositions);
+    Json->SetObjectField(TEXT("metrics"), Metrics.ToJson());
+    FString JsonText;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+    FJsonSerializer::Serialize(Json.ToSharedRef(), Writer);
+
+    if (!FFileHelper::SaveStringToFile(Csv, *CsvPath) || !FFileHelper::SaveStringToFile(JsonText, *JsonPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("AISearchBenchmark: could not write %s or %s"), *CsvPath, *JsonPath);
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("AISearchBenchmark: wrote %s and %s"), *CsvPath, *JsonPath);
+
+    if (!Metrics.Run(Params, TEXT("AISearchBenchmark")))
+    {
+        Result = 1;
+    }
+    return Result;
+}
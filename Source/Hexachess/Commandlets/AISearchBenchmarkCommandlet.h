@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "AISearchBenchmarkCommandlet.generated.h"
+
+
+// runs the minimax search over a fixed set of positions and writes what it did at every depth, to compare builds
+// UnrealEditor-Cmd Hexachess.uproject -run=AISearchBenchmark -depth=5 -time=30000 [-threads=N] [-parallel=ybw] [-position=Name] [-csv=Path] [-json=Path] [-baseline=Path [-tolerance=0.1] [-writebaseline]]
+// - the time budget is per position and large by default, so the run is decided by depth and stays comparable
+// - every position starts from a cleared transposition table and history
+// - the reports go to Saved/Benchmarks unless -csv or -json say otherwise
+// - each position's deepest depth, nodes and time fail the run when they fall behind a baseline (see FBenchmarkBaseline)
+UCLASS()
+class HEXACHESS_API UAISearchBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UAISearchBenchmarkCommandlet();
+
+    int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,108 @@
+#include "BenchmarkBaseline.h"
+
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+void FBenchmarkBaseline::Add(const FString& Name, double Value, EDirection Direction)
+{
+    Metrics.Add({Name, Value, Direction});
+}
+
+TSharedRef<FJsonObject> FBenchmarkBaseline::ToJson() const
+{
+    const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+    for (const FMetric& Metric : Metrics)
+    {
+        Json->SetNumberField(Metric.Name, Metric.Value);
+    }
+    return Json;
+}
+
+bool FBenchmarkBaseline::Run(const FString& Params, const TCHAR* LogName) const
+{
+    FString Path;
+    if (!FParse::Value(*Params, TEXT("baseline="), Path))
+    {
+        return true;
+    }
+    double Tolerance = 0.1;
+    FParse::Value(*Params, TEXT("tolerance="), Tolerance);
+
+    return FParse::Param(*Params, TEXT("writebaseline")) ? Write(Path, Tolerance, LogName) : Check(Path, Tolerance, LogName);
+}
+
+bool FBenchmarkBaseline::Write(const FString& Path, double Tolerance, const TCHAR* LogName) const
+{
+    const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+    Json->SetNumberField(TEXT("tolerance"), Tolerance);
+    Json->SetObjectField(TEXT("metrics"), ToJson());
+    FString JsonText;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+    FJsonSerializer::Serialize(Json, Writer);
+
+    if (!FFileHelper::SaveStringToFile(JsonText, *Path))
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s: could not write the baseline %s"), LogName, *Path);
+        return false;
+    }
+    UE_LOG(LogTemp, Display, TEXT("%s: wrote %d metrics as the baseline %s"), LogName, Metrics.Num(), *Path);
+    return true;
+}
+
+bool FBenchmarkBaseline::Check(const FString& Path, double Tolerance, const TCHAR* LogName) const
+{
+    FString JsonText;
+    TSharedPtr<FJsonObject> Json;
+    if (!FFileHelper::LoadFileToString(JsonText, *Path) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonText), Json) || !Json.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s: could not read the baseline %s"), LogName, *Path);
+        return false;
+    }
+    // a noisy benchmark keeps a wider tolerance in its baseline than the default
+    Json->TryGetNumberField(TEXT("tolerance"), Tolerance);
+    const TSharedPtr<FJsonObject>* BaselineMetrics = nullptr;
+    if (!Json->TryGetObjectField(TEXT("metrics"), BaselineMetrics))
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s: the baseline %s has no metrics"), LogName, *Path);
+        return false;
+    }
+
+    int32 Regressions = 0;
+    int32 Checked = 0;
+    for (const FMetric& Metric : Metrics)
+    {
+        double Baseline = 0.0;
+        // a metric the baseline does not know yet, such as a new position, is only checked from the next baseline on
+        if (!(*BaselineMetrics)->TryGetNumberField(Metric.Name, Baseline))
+        {
+            continue;
+        }
+        Checked++;
+
+        bool IsRegression = false;
+        switch (Metric.Direction)
+        {
+        case EDirection::LowerIsBetter:
+            IsRegression = Metric.Value > Baseline * (1.0 + Tolerance);
+            break;
+        case EDirection::HigherIsBetter:
+            IsRegression = Metric.Value < Baseline * (1.0 - Tolerance);
+            break;
+        case EDirection::Exact:
+            IsRegression = Metric.Value != Baseline;
+            break;
+        }
+        if (IsRegression)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: %s is %.4g, the baseline is %.4g"), LogName, *Metric.Name, Metric.Value, Baseline);
+            Regressions++;
+        }
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("%s: %d of %d metrics checked against %s with a %.0f%% tolerance, %d regressed"), LogName, Checked, Metrics.Num(), *Path,
+        Tolerance * 100.0, Regressions);
+    return Regressions == 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+
+
+/*
+ * The named metrics of one benchmark run, checked against the metrics of an earlier run kept as its baseline, so a
+ * build machine running the benchmark commandlets fails on a slowdown instead of someone having to read the numbers.
+ * The commandlets take the same switches for it:
+ * -baseline=Path      the JSON file of the earlier run; no baseline, nothing is checked
+ * -tolerance=0.1      how much worse than the baseline a metric may get, 10% by default; the file may set its own
+ * -writebaseline      writes this run's metrics as the new baseline instead of checking them
+ */
+class FBenchmarkBaseline
+{
+public:
+
+    enum class EDirection : uint8
+    {
+        LowerIsBetter,
+        HigherIsBetter,
+        // counts that only change when the benchmarked behaviour does, such as perft nodes
+        Exact
+    };
+
+    void Add(const FString& Name, double Value, EDirection Direction);
+
+    // the metrics as a JSON object, for the commandlet's own report
+    TSharedRef<FJsonObject> ToJson() const;
+
+    // checks or writes the baseline as the params say; false on a regression or a baseline that could not be read or written
+    bool Run(const FString& Params, const TCHAR* LogName) const;
+
+private:
+
+    struct FMetric
+    {
+        FString Name;
+        double Value = 0.0;
+        EDirection Direction = EDirection::LowerIsBetter;
+    };
+
+    bool Write(const FString& Path, double Tolerance, const TCHAR* LogName) const;
+
+    bool Check(const FString& Path, double Tolerance, const TCHAR* LogName) const;
+
+    TArray<FMetric> Metrics;
+};
@@ -0,0 +1,94 @@
+#include "CopycatBookCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Chess/ChessEngine.h"
+#include "Search/OpeningBook.h"
+
+UCopycatBookCommandlet::UCopycatBookCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UCopycatBookCommandlet::Main(const FString& Params)
+{
+    FString GamesDir = FPaths::ProjectSavedDir() / TEXT("Games");
+    int32 MaxPlies = 60;
+    int32 MinCount = 1;
+    FString OutPath = FPaths::ProjectContentDir() / TEXT("Books") / TEXT("CopycatBook.hxbook");
+    FParse::Value(*Params, TEXT("games="), GamesDir);
+    FParse::Value(*Params, TEXT("plies="), MaxPlies);
+    FParse::Value(*Params, TEXT("mincount="), MinCount);
+    FParse::Value(*Params, TEXT("out="), OutPath);
+
+    TArray<FString> RecordPaths;
+    IFileManager::Get().FindFilesRecursive(RecordPaths, *GamesDir, TEXT("*.hxgame"), true, false);
+    if (RecordPaths.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("CopycatBook: no recorded games under %s"), *GamesDir);
+        return 1;
+    }
+
+    Board StartBoard;
+    const PackedBoard& StartPosition = Board::starting_position();
+
+    // how often each move was played from each position
+    TMap<TTuple<uint64, int32, int32>, int32> MoveCounts;
+    int32 GameCount = 0;
+    for (const FString& RecordPath : RecordPaths)
+    {
+        TArray<uint8> Record;
+        if (!FFileHelper::LoadFileToArray(Record, *RecordPath))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("CopycatBook: could not read %s"), *RecordPath);
+            continue;
+        }
+        GameCount++;
+
+        // a record is two cell indices per move, as Board::serialize_history writes it
+        PackedBoard Position = StartPosition;
+        for (int32 Ply = 0; Ply < MaxPlies && Ply * 2 + 1 < Record.Num(); Ply++)
+        {
+            const int32 From = Record[Ply * 2];
+            const int32 To = Record[Ply * 2 + 1];
+            MoveList Moves;
+            StartBoard.generate_legal_moves(Position, Position.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white, Moves);
+            const bool IsLegal = std::any_of(Moves.begin(), Moves.end(), [From, To](const Move& Candidate) { return Candidate.from == From && Candidate.to == To; });
+            if (!IsLegal)
+            {
+                // a game from a loaded position, or one recorded with other rules
+                break;
+            }
+            MoveCounts.FindOrAdd(MakeTuple(Position.hash, PackedBoard::to_key(From), PackedBoard::to_key(To)))++;
+            Position.make_move(From, To);
+        }
+    }
+
+    TArray<FOpeningBookEntry> Entries;
+    for (const TPair<TTuple<uint64, int32, int32>, int32>& Pair : MoveCounts)
+    {
+        if (Pair.Value < MinCount)
+        {
+            continue;
+        }
+        FOpeningBookEntry& Entry = Entries.AddDefaulted_GetRef();
+        Entry.Hash = Pair.Key.Get<0>();
+        Entry.FromKey = static_cast<uint16>(Pair.Key.Get<1>());
+        Entry.ToKey = static_cast<uint16>(Pair.Key.Get<2>());
+        Entry.Weight = static_cast<uint16>(FMath::Clamp(Pair.Value, 1, 65535));
+    }
+
+    if (!FOpeningBook::Write(OutPath, Entries))
+    {
+        UE_LOG(LogTemp, Error, TEXT("CopycatBook: could not write %s"), *OutPath);
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("CopycatBook: wrote %d moves from %d games to %s"), Entries.Num(), GameCount, *OutPath);
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "CopycatBookCommandlet.generated.h"
+
+
+// builds the book the copycat AI plays from, out of the move records AChessGod writes when RecordGames is set
+// UnrealEditor-Cmd Hexachess.uproject -run=CopycatBook [-games=Dir] [-plies=60] [-mincount=1] [-out=Path]
+// - every *.hxgame under -games (Saved/Games by default) is replayed from the standard setup, a record stops at its first illegal move
+// - the moves of the first -plies plies are counted per position, a move must be played -mincount times to be kept
+// - the book goes to Content/Books/CopycatBook.hxbook unless -out says otherwise
+UCLASS()
+class HEXACHESS_API UCopycatBookCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UCopycatBookCommandlet();
+
+    int32 Main(const FString& Params) override;
+};
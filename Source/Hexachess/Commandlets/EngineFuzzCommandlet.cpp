@@ -0,0 +1,52 @@
+#include "EngineFuzzCommandlet.h"
+
+#include "HAL/PlatformTime.h"
+
+#include "Chess/EngineFuzzer.h"
+
+UEngineFuzzCommandlet::UEngineFuzzCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UEngineFuzzCommandlet::Main(const FString& Params)
+{
+    int32 GameCount = 1000;
+    int32 MaxPlies = 120;
+    int32 Seed = 1;
+    int32 MaxFailures = 10;
+    FParse::Value(*Params, TEXT("games="), GameCount);
+    FParse::Value(*Params, TEXT("plies="), MaxPlies);
+    FParse::Value(*Params, TEXT("seed="), Seed);
+    FParse::Value(*Params, TEXT("maxfailures="), MaxFailures);
+
+    const double StartTime = FPlatformTime::Seconds();
+    EngineFuzzer Fuzzer(static_cast<uint32>(Seed));
+    int32 Failures = 0;
+    int32 Game = 0;
+    for (; Game < GameCount && Failures < MaxFailures; Game++)
+    {
+        FuzzDivergence Divergence;
+        if (!Fuzzer.run_game(MaxPlies, Divergence))
+        {
+            continue;
+        }
+        Failures++;
+
+        FString Moves;
+        for (const std::pair<int32, int32>& Move : Divergence.moves)
+        {
+            Moves += FString::Printf(TEXT("%s%s-%s"), Moves.IsEmpty() ? TEXT("") : TEXT(" "),
+                UTF8_TO_TCHAR(EngineFuzzer::key_to_string(Move.first).c_str()), UTF8_TO_TCHAR(EngineFuzzer::key_to_string(Move.second).c_str()));
+        }
+        const FString Cell = Divergence.key >= 0 ? FString::Printf(TEXT(" at %s"), UTF8_TO_TCHAR(EngineFuzzer::key_to_string(Divergence.key).c_str())) : FString();
+        UE_LOG(LogTemp, Error, TEXT("EngineFuzz: game %d, %s%s after %d moves: map %s, packed %s; moves %s"), Game, UTF8_TO_TCHAR(EngineFuzzer::get_check_name(Divergence.check)), *Cell,
+            static_cast<int32>(Divergence.moves.size()), UTF8_TO_TCHAR(Divergence.map_answer.c_str()), UTF8_TO_TCHAR(Divergence.packed_answer.c_str()), Moves.IsEmpty() ? TEXT("(none)") : *Moves);
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("EngineFuzz: %d games of up to %d plies in %.1f s, %d diverged"), Game, MaxPlies, FPlatformTime::Seconds() - StartTime, Failures);
+    return Failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "EngineFuzzCommandlet.generated.h"
+
+
+// plays random legal games and checks that the legacy map board and the packed board agree after every ply
+// UnrealEditor-Cmd Hexachess.uproject -run=EngineFuzz [-games=1000] [-plies=120] [-seed=1] [-maxfailures=10]
+// - cells, the legal moves of the side to move, can_be_captured of every piece and the evaluation are compared
+// - every divergence is minimized and logged with its moves, ready to paste into a replay
+// - fails when any game diverged
+UCLASS()
+class HEXACHESS_API UEngineFuzzCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UEngineFuzzCommandlet();
+
+    int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,119 @@
+#include "OpeningBookCommandlet.h"
+
+#include "Misc/Paths.h"
+
+#include "Actors/ChessGod.h"
+#include "Chess/ChessEngine.h"
+#include "Search/OpeningBook.h"
+#include "Search/SelfPlay.h"
+
+namespace
+{
+    // how often a move was played from a position and the points its mover scored with it
+    struct FBookMoveStats
+    {
+        int32 Count = 0;
+        double Points = 0.0;
+    };
+}
+
+UOpeningBookCommandlet::UOpeningBookCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UOpeningBookCommandlet::Main(const FString& Params)
+{
+    FString DifficultyName = TEXT("Hard");
+    FParse::Value(*Params, TEXT("difficulty="), DifficultyName);
+    const int64 DifficultyValue = StaticEnum<EAIDifficulty>()->GetValueByNameString(DifficultyName);
+    if (DifficultyValue == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Error, TEXT("OpeningBook: %s is not a difficulty"), *DifficultyName);
+        return 1;
+    }
+
+    // the same search the book will stand in for
+    FSelfPlayPlayer Player;
+    AChessGod::GetAIDifficultyLimits(static_cast<EAIDifficulty>(DifficultyValue), Player.MaxDepth, Player.TimeBudgetMs);
+    FParse::Value(*Params, TEXT("depth="), Player.MaxDepth);
+    FParse::Value(*Params, TEXT("time="), Player.TimeBudgetMs);
+
+    int32 GameCount = 64;
+    int32 RandomPlies = 3;
+    int32 BookPlies = 16;
+    int32 MinCount = 2;
+    FString OutPath = FPaths::ProjectContentDir() / TEXT("Books") / TEXT("OpeningBook.hxbook");
+    FSelfPlayConfig Config;
+    FParse::Value(*Params, TEXT("games="), GameCount);
+    FParse::Value(*Params, TEXT("randomplies="), RandomPlies);
+    FParse::Value(*Params, TEXT("bookplies="), BookPlies);
+    FParse::Value(*Params, TEXT("mincount="), MinCount);
+    FParse::Value(*Params, TEXT("concurrency="), Config.Concurrency);
+    FParse::Value(*Params, TEXT("seed="), Config.Seed);
+    FParse::Value(*Params, TEXT("out="), OutPath);
+    // only the opening is kept, the rest of a game just has to end somewhere
+    Config.MaxPlies = FMath::Max(BookPlies * 4, 80);
+
+    TMap<TTuple<uint64, int32, int32>, FBookMoveStats> MoveStats;
+    const std::atomic<bool> IsCancelled{false};
+    for (int32 Plies = 0; Plies <= RandomPlies; Plies++)
+    {
+        // without random moves every pair plays the same game, one pair is enough
+        Config.OpeningPlies = Plies;
+        Config.GameCount = Plies == 0 ? 2 : GameCount;
+        FSelfPlayRunner Runner;
+        const FSelfPlayStats Stats = Runner.Run(Config, Player, Player, IsCancelled);
+        UE_LOG(LogTemp, Display, TEXT("OpeningBook: %d random plies, %d games, +%d =%d -%d for the first player"), Plies, Stats.GetGameCount(), Stats.Wins, Stats.Draws, Stats.Losses);
+
+        for (const FSelfPlayGame& Game : Runner.GetGames())
+        {
+            if (Game.Ending == ESelfPlayEnding::Unfinished)
+            {
+                continue;
+            }
+            PackedBoard Position = Config.StartPosition;
+            for (int32 Ply = 0; Ply < Game.Moves.Num() && Ply < BookPlies; Ply++)
+            {
+                const TPair<int32, int32>& Move = Game.Moves[Ply];
+                if (Ply >= Plies)
+                {
+                    const bool IsWhiteMover = !Position.black_to_move;
+                    const double Points = Game.Outcome == ESelfPlayOutcome::Draw ? 0.5 : (Game.Outcome == ESelfPlayOutcome::WhiteWins) == IsWhiteMover ? 1.0 : 0.0;
+                    FBookMoveStats& Played = MoveStats.FindOrAdd(MakeTuple(Position.hash, Move.Key, Move.Value));
+                    Played.Count++;
+                    Played.Points += Points;
+                }
+                Position.make_move(PackedBoard::to_index(Move.Key), PackedBoard::to_index(Move.Value));
+            }
+        }
+    }
+
+    TArray<FOpeningBookEntry> Entries;
+    for (const TPair<TTuple<uint64, int32, int32>, FBookMoveStats>& Pair : MoveStats)
+    {
+        const FBookMoveStats& Played = Pair.Value;
+        const double AveragePoints = Played.Points / Played.Count;
+        if (Played.Count < MinCount || AveragePoints < 0.25)
+        {
+            continue;
+        }
+        FOpeningBookEntry& Entry = Entries.AddDefaulted_GetRef();
+        Entry.Hash = Pair.Key.Get<0>();
+        Entry.FromKey = static_cast<uint16>(Pair.Key.Get<1>());
+        Entry.ToKey = static_cast<uint16>(Pair.Key.Get<2>());
+        Entry.Weight = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Played.Count * (0.5 + AveragePoints)), 1, 65535));
+    }
+
+    if (!FOpeningBook::Write(OutPath, Entries))
+    {
+        UE_LOG(LogTemp, Error, TEXT("OpeningBook: could not write %s"), *OutPath);
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("OpeningBook: wrote %d moves of %d played to %s"), Entries.Num(), MoveStats.Num(), *OutPath);
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "OpeningBookCommandlet.generated.h"
+
+
+// builds the opening book the minimax AI plays from, out of self-play games of one difficulty against itself
+// UnrealEditor-Cmd Hexachess.uproject -run=OpeningBook [-difficulty=Hard] [-depth=N] [-time=Ms] [-games=64] [-randomplies=3] [-bookplies=16] [-mincount=2] [-concurrency=N] [-seed=1] [-out=Path]
+// - the games start with 0, 1, ... -randomplies random moves so the book branches; random moves themselves never go in the book
+// - every searched move of the first -bookplies plies is counted, a move must be played -mincount times to be kept
+// - a move the mover mostly lost with is dropped, the others are weighted by how often they were played and how well they scored
+// - the book goes to Content/Books/OpeningBook.hxbook unless -out says otherwise
+UCLASS()
+class HEXACHESS_API UOpeningBookCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UOpeningBookCommandlet();
+
+    int32 Main(const FString& Params) override;
+};
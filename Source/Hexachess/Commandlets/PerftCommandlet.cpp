@@ -0,0 +1,89 @@
+#include "PerftCommandlet.h"
+
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#include "Chess/BitboardEngine.h"
+#include "Chess/ChessEngine.h"
+#include "Commandlets/BenchmarkBaseline.h"
+
+UPerftCommandlet::UPerftCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UPerftCommandlet::Main(const FString& Params)
+{
+    int32 MaxDepth = 4;
+    FParse::Value(*Params, TEXT("depth="), MaxDepth);
+    MaxDepth = FMath::Max(MaxDepth, 1);
+    const bool ShouldDivide = FParse::Param(*Params, TEXT("divide"));
+    const bool ShouldCompare = FParse::Param(*Params, TEXT("bitboard"));
+    FString JsonPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("Perft.json");
+    FParse::Value(*Params, TEXT("json="), JsonPath);
+
+    Board StartBoard;
+    // perft plays its moves on this copy and takes them back
+    PackedBoard StartPosition = Board::starting_position();
+    StartBoard.set_position(StartPosition);
+    BitboardPosition StartBitboard;
+    StartBitboard.load(StartPosition);
+
+    FBenchmarkBaseline Metrics;
+    int32 Result = 0;
+    for (int32 Depth = 1; Depth <= MaxDepth; Depth++)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        const uint64 Nodes = StartBoard.perft(StartPosition, Depth, Cell::PieceColor::white);
+        const double Seconds = FPlatformTime::Seconds() - StartTime;
+        const uint64 NodesPerSecond = Seconds > 0.0 ? static_cast<uint64>(Nodes / Seconds) : 0;
+        UE_LOG(LogTemp, Display, TEXT("Perft: depth %d, %llu nodes, %.3f s, %llu nps"), Depth, Nodes, Seconds, NodesPerSecond);
+        Metrics.Add(FString::Printf(TEXT("depth%d.nodes"), Depth), static_cast<double>(Nodes), FBenchmarkBaseline::EDirection::Exact);
+        // the shallow depths run too briefly for their speed to mean anything
+        if (Seconds >= 0.1)
+        {
+            Metrics.Add(FString::Printf(TEXT("depth%d.nodesPerSecond"), Depth), static_cast<double>(NodesPerSecond), FBenchmarkBaseline::EDirection::HigherIsBetter);
+        }
+
+        if (ShouldCompare)
+        {
+            const uint64 BitboardNodes = StartBitboard.perft(Depth, Cell::PieceColor::white);
+            if (BitboardNodes != Nodes)
+            {
+                UE_LOG(LogTemp, Error, TEXT("Perft: depth %d, bitboard engine counts %llu nodes"), Depth, BitboardNodes);
+                Result = 1;
+            }
+        }
+    }
+
+    if (ShouldDivide)
+    {
+        for (const auto& [RootMove, Nodes] : StartBoard.perft_divide(StartPosition, MaxDepth, Cell::PieceColor::white))
+        {
+            const Position From = StartBoard.to_position(PackedBoard::to_key(RootMove.from));
+            const Position To = StartBoard.to_position(PackedBoard::to_key(RootMove.to));
+            UE_LOG(LogTemp, Display, TEXT("Perft: (%d, %d) -> (%d, %d): %llu"), From.x, From.y, To.x, To.y, Nodes);
+        }
+    }
+
+    FString JsonText;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+    FJsonSerializer::Serialize(Metrics.ToJson(), Writer);
+    if (!FFileHelper::SaveStringToFile(JsonText, *JsonPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Perft: could not write %s"), *JsonPath);
+        return 1;
+    }
+
+    if (!Metrics.Run(Params, TEXT("Perft")))
+    {
+        Result = 1;
+    }
+    return Result;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "PerftCommandlet.generated.h"
+
+
+// counts the legal move tree from the standard starting position, to check and time the move generator
+// UnrealEditor-Cmd Hexachess.uproject -run=Perft -depth=5 [-divide] [-bitboard] [-json=Path] [-baseline=Path [-tolerance=0.1] [-writebaseline]]
+// - every depth up to -depth is reported with its node count, time and nodes per second
+// - -divide splits the deepest count by root move, to find where two generators disagree
+// - -bitboard counts every depth again with the bitboard engine and fails on any difference
+// - the counts and speeds go to Saved/Benchmarks/Perft.json, and fail the run when they fall behind a baseline (see FBenchmarkBaseline)
+UCLASS()
+class HEXACHESS_API UPerftCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UPerftCommandlet();
+
+    int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,98 @@
+#include "PuzzleCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+#include "Actors/ChessGod.h"
+#include "Chess/ChessEngine.h"
+#include "Search/PuzzleGenerator.h"
+#include "Search/SelfPlay.h"
+
+UPuzzleCommandlet::UPuzzleCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UPuzzleCommandlet::Main(const FString& Params)
+{
+    FString DifficultyName = TEXT("Medium");
+    FParse::Value(*Params, TEXT("difficulty="), DifficultyName);
+    const int64 DifficultyValue = StaticEnum<EAIDifficulty>()->GetValueByNameString(DifficultyName);
+    if (DifficultyValue == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Puzzle: %s is not a difficulty"), *DifficultyName);
+        return 1;
+    }
+    FSelfPlayPlayer Player;
+    Player.Name = DifficultyName;
+    AChessGod::GetAIDifficultyLimits(static_cast<EAIDifficulty>(DifficultyValue), Player.MaxDepth, Player.TimeBudgetMs);
+
+    FSelfPlayConfig Config;
+    Config.GameCount = 200;
+    // a few more random plies than a match, the puzzles should not all come from the same openings
+    Config.OpeningPlies = 6;
+    FParse::Value(*Params, TEXT("games="), Config.GameCount);
+    FParse::Value(*Params, TEXT("openingplies="), Config.OpeningPlies);
+    FParse::Value(*Params, TEXT("seed="), Config.Seed);
+    FParse::Value(*Params, TEXT("concurrency="), Config.Concurrency);
+
+    FPuzzleConfig PuzzleConfig;
+    PuzzleConfig.Concurrency = Config.Concurrency;
+    FParse::Value(*Params, TEXT("minply="), PuzzleConfig.MinPly);
+    FParse::Value(*Params, TEXT("matemoves="), PuzzleConfig.MaxMateMoves);
+    FParse::Value(*Params, TEXT("matenodes="), PuzzleConfig.MateNodeBudget);
+    FParse::Value(*Params, TEXT("screendepth="), PuzzleConfig.ScreenDepth);
+    FParse::Value(*Params, TEXT("screennodes="), PuzzleConfig.ScreenNodeBudget);
+    PuzzleConfig.FindCaptures = !FParse::Param(*Params, TEXT("nocaptures"));
+    FString OutPath = FPaths::ProjectContentDir() / TEXT("Puzzles") / TEXT("Puzzles.hxpuzzles");
+    FParse::Value(*Params, TEXT("out="), OutPath);
+
+    const std::atomic<bool> IsCancelled{false};
+    double StartTime = FPlatformTime::Seconds();
+    FSelfPlayRunner Runner;
+    const FSelfPlayStats Stats = Runner.Run(Config, Player, Player, IsCancelled);
+    UE_LOG(LogTemp, Display, TEXT("Puzzle: played %d games at %s in %.1f s"), Stats.GetGameCount(), *Player.Name, FPlatformTime::Seconds() - StartTime);
+
+    const TArray<PackedBoard> Positions = FPuzzleGenerator::CollectPositions(Runner.GetGames(), Config.StartPosition, PuzzleConfig.MinPly);
+    UE_LOG(LogTemp, Display, TEXT("Puzzle: checking %d distinct positions"), Positions.Num());
+
+    StartTime = FPlatformTime::Seconds();
+    const FPuzzleGenerator Generator;
+    const TArray<FPuzzleEntry> Puzzles = Generator.Generate(Positions, PuzzleConfig, IsCancelled, [&Positions](const int32 Checked, const int32 Found)
+    {
+        if (Checked % 1000 == 0 || Checked == Positions.Num())
+        {
+            UE_LOG(LogTemp, Display, TEXT("Puzzle: %d of %d positions checked, %d puzzles"), Checked, Positions.Num(), Found);
+        }
+    });
+
+    int32 MateCounts[FPuzzleEntry::MaxSolutionPlies + 1] = {};
+    int32 CaptureCount = 0;
+    for (const FPuzzleEntry& Puzzle : Puzzles)
+    {
+        if (Puzzle.Kind == static_cast<uint8>(EPuzzleKind::Mate))
+        {
+            MateCounts[FMath::Clamp<int32>(Puzzle.Value, 0, FPuzzleEntry::MaxSolutionPlies)]++;
+        }
+        else
+        {
+            CaptureCount++;
+        }
+    }
+    UE_LOG(LogTemp, Display, TEXT("Puzzle: %d puzzles in %.1f s: mate in 1/2/3/4 %d/%d/%d/%d, %d winning captures"), Puzzles.Num(), FPlatformTime::Seconds() - StartTime,
+        MateCounts[1], MateCounts[2], MateCounts[3], MateCounts[4], CaptureCount);
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(OutPath), true);
+    if (!FPuzzleGenerator::WritePack(OutPath, Puzzles))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Puzzle: could not write %s"), *OutPath);
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("Puzzle: wrote %s"), *OutPath);
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "PuzzleCommandlet.generated.h"
+
+
+// plays the minimax AI against itself and turns the tactical positions of the games into a puzzle pack
+// UnrealEditor-Cmd Hexachess.uproject -run=Puzzle [-games=200] [-difficulty=Medium] [-openingplies=6] [-seed=1] [-concurrency=N]
+//     [-minply=8] [-matemoves=3] [-matenodes=2000000] [-screendepth=4] [-screennodes=200000] [-nocaptures] [-out=Path]
+// - the games run like the SelfPlay commandlet's, both sides at -difficulty, several at once
+// - every position is screened, mates of up to -matemoves moves are proven against every defence and kept when their first move is the only one
+// - a winning capture is kept when it beats every other move by a wide margin
+// - the pack goes to Content/Puzzles/Puzzles.hxpuzzles unless -out says otherwise
+UCLASS()
+class HEXACHESS_API UPuzzleCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UPuzzleCommandlet();
+
+    int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,194 @@
+#include "SelfPlayCommandlet.h"
+
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#include "Actors/ChessGod.h"
+#include "Chess/ChessEngine.h"
+#include "Chess/EvaluationWeights.h"
+#include "Search/SelfPlay.h"
+
+namespace
+{
+    // reads -difficultyA / -depthA / -timeA / -nodesA / -weightsA / -parallelA (or the B ones) into a player
+    bool ParsePlayer(const FString& Params, const TCHAR* Side, FSelfPlayPlayer& OutPlayer)
+    {
+        FString DifficultyName = TEXT("Medium");
+        FParse::Value(*Params, *FString::Printf(TEXT("difficulty%s="), Side), DifficultyName);
+        const int64 DifficultyValue = StaticEnum<EAIDifficulty>()->GetValueByNameString(DifficultyName);
+        if (DifficultyValue == INDEX_NONE)
+        {
+            UE_LOG(LogTemp, Error, TEXT("SelfPlay: %s is not a difficulty"), *DifficultyName);
+            return false;
+        }
+        const EAIDifficulty Difficulty = static_cast<EAIDifficulty>(DifficultyValue);
+        AChessGod::GetAIDifficultyLimits(Difficulty, OutPlayer.MaxDepth, OutPlayer.TimeBudgetMs);
+        FParse::Value(*Params, *FString::Printf(TEXT("depth%s="), Side), OutPlayer.MaxDepth);
+        FParse::Value(*Params, *FString::Printf(TEXT("time%s="), Side), OutPlayer.TimeBudgetMs);
+        FParse::Value(*Params, *FString::Printf(TEXT("nodes%s="), Side), OutPlayer.NodeBudget);
+
+        FString ParallelName;
+        FParse::Value(*Params, *FString::Printf(TEXT("parallel%s="), Side), ParallelName);
+        OutPlayer.UseSplitPoints = ParallelName == TEXT("ybw");
+
+        FString WeightsPath;
+        FParse::Value(*Params, *FString::Printf(TEXT("weights%s="), Side), WeightsPath);
+        if (!WeightsPath.IsEmpty())
+        {
+            UEvaluationWeights* Weights = LoadObject<UEvaluationWeights>(nullptr, *WeightsPath);
+            if (Weights == nullptr)
+            {
+                UE_LOG(LogTemp, Error, TEXT("SelfPlay: could not load evaluation weights %s"), *WeightsPath);
+                return false;
+            }
+            OutPlayer.Evaluation = Weights->GetEvaluator();
+        }
+
+        OutPlayer.Name = FString::Printf(TEXT("%s (depth %d, %d ms%s%s%s)"), *DifficultyName, OutPlayer.MaxDepth, OutPlayer.TimeBudgetMs,
+            OutPlayer.NodeBudget > 0 ? *FString::Printf(TEXT(", %lld nodes"), OutPlayer.NodeBudget) : TEXT(""),
+            OutPlayer.UseSplitPoints ? TEXT(", ybw") : TEXT(""), WeightsPath.IsEmpty() ? TEXT("") : *FString::Printf(TEXT(", %s"), *FPaths::GetBaseFilename(WeightsPath)));
+        return true;
+    }
+
+    const TCHAR* GetEndingName(const ESelfPlayEnding Ending)
+    {
+        switch (Ending)
+        {
+        case ESelfPlayEnding::Checkmate:
+            return TEXT("Checkmate");
+        case ESelfPlayEnding::Stalemate:
+            return TEXT("Stalemate");
+        case ESelfPlayEnding::Repetition:
+            return TEXT("Repetition");
+        case ESelfPlayEnding::FiftyMoves:
+            return TEXT("FiftyMoves");
+        case ESelfPlayEnding::MaxPlies:
+            return TEXT("MaxPlies");
+        default:
+            return TEXT("Unfinished");
+        }
+    }
+
+    const TCHAR* GetOutcomeName(const ESelfPlayOutcome Outcome)
+    {
+        switch (Outcome)
+        {
+        case ESelfPlayOutcome::WhiteWins:
+            return TEXT("1-0");
+        case ESelfPlayOutcome::BlackWins:
+            return TEXT("0-1");
+        default:
+            return TEXT("1/2-1/2");
+        }
+    }
+}
+
+USelfPlayCommandlet::USelfPlayCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 USelfPlayCommandlet::Main(const FString& Params)
+{
+    FSelfPlayPlayer PlayerA;
+    FSelfPlayPlayer PlayerB;
+    if (!ParsePlayer(Params, TEXT("A"), PlayerA) || !ParsePlayer(Params, TEXT("B"), PlayerB))
+    {
+        return 1;
+    }
+
+    FSelfPlayConfig Config;
+    FParse::Value(*Params, TEXT("games="), Config.GameCount);
+    FParse::Value(*Params, TEXT("concurrency="), Config.Concurrency);
+    FParse::Value(*Params, TEXT("threads="), Config.ThreadsPerGame);
+    FParse::Value(*Params, TEXT("openingplies="), Config.OpeningPlies);
+    FParse::Value(*Params, TEXT("seed="), Config.Seed);
+    FParse::Value(*Params, TEXT("maxplies="), Config.MaxPlies);
+    Config.UseSprt = FParse::Param(*Params, TEXT("sprt"));
+    FParse::Value(*Params, TEXT("elo0="), Config.SprtElo0);
+    FParse::Value(*Params, TEXT("elo1="), Config.SprtElo1);
+    FParse::Value(*Params, TEXT("alpha="), Config.SprtAlpha);
+    FParse::Value(*Params, TEXT("beta="), Config.SprtBeta);
+    FString CsvPath = FPaths::ProjectSavedDir() / TEXT("SelfPlay") / TEXT("SelfPlay.csv");
+    FString JsonPath = FPaths::ProjectSavedDir() / TEXT("SelfPlay") / TEXT("SelfPlay.json");
+    FParse::Value(*Params, TEXT("csv="), CsvPath);
+    FParse::Value(*Params, TEXT("json="), JsonPath);
+
+    UE_LOG(LogTemp, Display, TEXT("SelfPlay: %s against %s, %d games"), *PlayerA.Name, *PlayerB.Name, Config.GameCount);
+
+    const double StartTime = FPlatformTime::Seconds();
+    const std::atomic<bool> IsCancelled{false};
+    FSelfPlayRunner Runner;
+    const FSelfPlayStats Stats = Runner.Run(Config, PlayerA, PlayerB, IsCancelled, [](const FSelfPlayGame& Game, const FSelfPlayStats& Totals)
+    {
+        UE_LOG(LogTemp, Display, TEXT("SelfPlay: game %d, A plays %s, %s by %s after %d plies; +%d =%d -%d, Elo %.1f +/- %.1f"), Game.Index, Game.IsPlayerAWhite ? TEXT("white") : TEXT("black"),
+            GetOutcomeName(Game.Outcome), GetEndingName(Game.Ending), Game.Plies, Totals.Wins, Totals.Draws, Totals.Losses, Totals.GetElo(), Totals.GetEloMargin());
+    });
+    const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+    FString Csv = TEXT("Game,AIsWhite,Result,Ending,Plies,Seconds,Moves\n");
+    for (const FSelfPlayGame& Game : Runner.GetGames())
+    {
+        if (Game.Ending == ESelfPlayEnding::Unfinished)
+        {
+            continue;
+        }
+        FString Moves;
+        for (const TPair<int32, int32>& Move : Game.Moves)
+        {
+            Moves += FString::Printf(TEXT("%s%d,%d-%d,%d"), Moves.IsEmpty() ? TEXT("") : TEXT(" "), Move.Key >> 8, Move.Key & 0xFF, Move.Value >> 8, Move.Value & 0xFF);
+        }
+        Csv += FString::Printf(TEXT("%d,%d,%s,%s,%d,%.3f,\"%s\"\n"), Game.Index, Game.IsPlayerAWhite ? 1 : 0, GetOutcomeName(Game.Outcome), GetEndingName(Game.Ending), Game.Plies, Game.Seconds, *Moves);
+    }
+
+    const double Llr = Stats.GetSprtLlr(Config.SprtElo0, Config.SprtElo1);
+    const ESprtDecision Decision = Runner.GetSprtDecision();
+    const TCHAR* DecisionName = Decision == ESprtDecision::AcceptH1 ? TEXT("H1") : Decision == ESprtDecision::AcceptH0 ? TEXT("H0") : TEXT("none");
+
+    const TSharedPtr<FJsonObject> Json = MakeShared<FJsonObject>();
+    Json->SetStringField(TEXT("playerA"), PlayerA.Name);
+    Json->SetStringField(TEXT("playerB"), PlayerB.Name);
+    Json->SetNumberField(TEXT("games"), Stats.GetGameCount());
+    Json->SetNumberField(TEXT("wins"), Stats.Wins);
+    Json->SetNumberField(TEXT("draws"), Stats.Draws);
+    Json->SetNumberField(TEXT("losses"), Stats.Losses);
+    Json->SetNumberField(TEXT("score"), Stats.GetScore());
+    // json has no infinity, a one-sided result reports as the largest double instead
+    Json->SetNumberField(TEXT("elo"), FMath::Clamp(Stats.GetElo(), -DBL_MAX, DBL_MAX));
+    Json->SetNumberField(TEXT("eloMargin"), FMath::Min(Stats.GetEloMargin(), DBL_MAX));
+    Json->SetNumberField(TEXT("seconds"), Seconds);
+    Json->SetNumberField(TEXT("seed"), Config.Seed);
+    Json->SetNumberField(TEXT("openingPlies"), Config.OpeningPlies);
+    if (Config.UseSprt)
+    {
+        Json->SetNumberField(TEXT("elo0"), Config.SprtElo0);
+        Json->SetNumberField(TEXT("elo1"), Config.SprtElo1);
+        Json->SetNumberField(TEXT("llr"), Llr);
+        Json->SetStringField(TEXT("accepted"), DecisionName);
+    }
+    FString JsonText;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+    FJsonSerializer::Serialize(Json.ToSharedRef(), Writer);
+
+    UE_LOG(LogTemp, Display, TEXT("SelfPlay: %d games in %.1f s, +%d =%d -%d, score %.3f, Elo %.1f +/- %.1f"), Stats.GetGameCount(), Seconds, Stats.Wins, Stats.Draws, Stats.Losses,
+        Stats.GetScore(), Stats.GetElo(), Stats.GetEloMargin());
+    if (Config.UseSprt)
+    {
+        UE_LOG(LogTemp, Display, TEXT("SelfPlay: SPRT [%.1f, %.1f], LLR %.3f, accepted %s"), Config.SprtElo0, Config.SprtElo1, Llr, DecisionName);
+    }
+
+    if (!FFileHelper::SaveStringToFile(Csv, *CsvPath) || !FFileHelper::SaveStringToFile(JsonText, *JsonPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("SelfPlay: could not write %s or %s"), *CsvPath, *JsonPath);
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("SelfPlay: wrote %s and %s"), *CsvPath, *JsonPath);
+
+    return 0;
+}
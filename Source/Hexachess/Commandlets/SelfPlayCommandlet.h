@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "SelfPlayCommandlet.generated.h"
+
+
+// plays the minimax AI against itself from randomized openings and reports the match as Elo, to measure AI changes by results
+// UnrealEditor-Cmd Hexachess.uproject -run=SelfPlay -games=200 [-difficultyA=Medium] [-difficultyB=Medium] [-depthA=N] [-timeA=Ms] [-nodesA=N] [-weightsA=Path] [-parallelA=ybw] (the same for B)
+//     [-concurrency=N] [-threads=N] [-openingplies=4] [-seed=1] [-maxplies=300] [-sprt -elo0=0 -elo1=10 -alpha=0.05 -beta=0.05] [-csv=Path] [-json=Path]
+// - -difficultyA and -difficultyB pick a difficulty, with the depth and time MakeAIMove gives it; -depth and -time override either
+// - -nodes adds a node budget; with -time=0 and -threads=1 a player then makes the same moves on any machine
+// - -weights is the object path of an evaluation weights asset, the board's own evaluation is used without one
+// - games run in pairs with colors swapped on the same random opening, as many at once as there are task graph workers by default
+// - with -sprt the match stops as soon as the test accepts either Elo bound
+// - every game goes to the csv, the totals to the json, both under Saved/SelfPlay unless -csv or -json say otherwise
+UCLASS()
+class HEXACHESS_API USelfPlayCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    USelfPlayCommandlet();
+
+    int32 Main(const FString& Params) override;
+};
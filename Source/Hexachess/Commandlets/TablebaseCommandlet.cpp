@@ -0,0 +1,81 @@
+#include "TablebaseCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+#include "Search/Tablebase.h"
+
+UTablebaseCommandlet::UTablebaseCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UTablebaseCommandlet::Main(const FString& Params)
+{
+    FString MaterialNames = TEXT("KQvK,KRvK,KBvK,KNvK,KPvK");
+    FString OutDirectory = FPaths::ProjectContentDir() / TEXT("Tablebases");
+    FParse::Value(*Params, TEXT("material="), MaterialNames, false);
+    FParse::Value(*Params, TEXT("out="), OutDirectory);
+
+    TArray<FString> Names;
+    MaterialNames.ParseIntoArray(Names, TEXT(","));
+    TArray<FTablebaseMaterial> Materials;
+    for (const FString& Name : Names)
+    {
+        FTablebaseMaterial& Material = Materials.AddDefaulted_GetRef();
+        if (!FTablebaseMaterial::Parse(Name, Material))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Tablebase: %s is not a material of up to %d pieces with one king per side"), *Name, FTablebaseMaterial::MaxPieces);
+            return 1;
+        }
+    }
+    IFileManager::Get().MakeDirectory(*OutDirectory, true);
+
+    // one generator for all of them, the smaller tables are shared between the materials that capture into them
+    FTablebaseGenerator Generator;
+    TSet<uint32> Written;
+    for (const FTablebaseMaterial& Material : Materials)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        Generator.Generate(Material, [](const FString& Name, const int32 Plies, const int64 Decided)
+        {
+            UE_LOG(LogTemp, Display, TEXT("Tablebase: %s pass %d, %lld positions decided"), *Name, Plies, Decided);
+        });
+        UE_LOG(LogTemp, Display, TEXT("Tablebase: %s generated in %.1f s"), *Material.GetName(), FPlatformTime::Seconds() - StartTime);
+    }
+
+    // every generated table, the materials a capture leads to included
+    for (const FTablebaseMaterial& Requested : Materials)
+    {
+        TArray<FTablebaseMaterial> Pending = {Requested};
+        while (Pending.Num() > 0)
+        {
+            bool IsFlipped = false;
+            const FTablebaseMaterial Material = Pending.Pop().GetCanonical(IsFlipped);
+            if (Written.Contains(Material.GetKey()))
+            {
+                continue;
+            }
+            Written.Add(Material.GetKey());
+            if (!Generator.Write(Material, OutDirectory))
+            {
+                UE_LOG(LogTemp, Error, TEXT("Tablebase: could not write %s to %s"), *Material.GetName(), *OutDirectory);
+                return 1;
+            }
+            int64 Wins = 0;
+            int64 Draws = 0;
+            int64 Losses = 0;
+            int32 MaxPliesToMate = 0;
+            Generator.GetCounts(Material, Wins, Draws, Losses, MaxPliesToMate);
+            UE_LOG(LogTemp, Display, TEXT("Tablebase: wrote %s, %lld wins, %lld draws, %lld losses for the side to move, longest mate %d plies"), *Material.GetName(), Wins, Draws, Losses, MaxPliesToMate);
+
+            Pending.Append(Material.GetCaptures());
+        }
+    }
+
+    return 0;
+}
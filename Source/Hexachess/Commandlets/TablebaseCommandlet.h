@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "TablebaseCommandlet.generated.h"
+
+
+// generates the endgame tablebase files the minimax AI probes, by retrograde analysis
+// UnrealEditor-Cmd Hexachess.uproject -run=Tablebase [-material=KQvK,KRvK,KBvK,KNvK,KPvK] [-out=Path]
+// - every material a capture leads to is generated and written as well, so KQvKR also writes KQvK and KRvK
+// - materials of up to four pieces; four-piece tables take a few hundred MB of memory while they are generated
+// - a .hxwdl (win/draw/loss) and a .hxdtm (distance to mate) file per material go to Content/Tablebases unless -out says otherwise
+UCLASS()
+class HEXACHESS_API UTablebaseCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UTablebaseCommandlet();
+
+    int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,193 @@
+#include "AISearchService.h"
+
+#include "Async/Async.h"
+
+#include "Chess/ChessEngine.h"
+
+
+FAISearchService::FAISearchService(int32 InSlotCount)
+{
+    const int32 SlotCount = FMath::Clamp(InSlotCount, 1, 64);
+    Slots.Reserve(SlotCount);
+    for (int32 SlotIndex = 0; SlotIndex < SlotCount; ++SlotIndex)
+    {
+        Slots.Add(MakeUnique<FSlot>());
+    }
+}
+
+FAISearchService::~FAISearchService()
+{
+    // the slots' searches belong to this object, let every running one unwind before they go
+    CancelAllJobs();
+    while (PendingSearches.load() > 0)
+    {
+        FPlatformProcess::Sleep(0.001f);
+    }
+}
+
+int32 FAISearchService::SubmitJob(Board* ActiveBoard, bool IsWhiteAI, int32 MaxDepth, int32 TimeBudgetMs, int64 NodeBudget, EAISearchPriority Priority,
+    TFunction<void(const FMinimaxResult&)> OnFinished, TSharedPtr<const Evaluator, ESPMode::ThreadSafe> Evaluation)
+{
+    check(IsInGameThread());
+
+    const TSharedRef<FJob, ESPMode::ThreadSafe> Job = MakeShared<FJob, ESPMode::ThreadSafe>();
+    Job->Id = NextJobId++;
+    Job->Priority = Priority;
+    Job->OnFinished = MoveTemp(OnFinished);
+
+    // snapshot the position now, the search never touches the caller's board
+    FMinimaxRequest& Request = Job->Request;
+    Request.Position = ActiveBoard->to_packed_board();
+    Request.Position.set_white_to_move(IsWhiteAI);
+    // the game's positions since its last capture or pawn move, lines back into them are draws
+    const vector<uint64> History = ActiveBoard->get_reversible_hashes();
+    Request.History.Append(History.data(), History.size());
+    Request.IsWhiteAI = IsWhiteAI;
+    Request.MaxDepth = FMath::Max(MaxDepth, 1);
+    Request.TimeBudgetMs = FMath::Max(TimeBudgetMs, 0);
+    Request.NodeBudget = FMath::Max<int64>(NodeBudget, 0);
+    // the slots are the parallelism, a job never asks the task graph for helpers
+    Request.ThreadCount = 1;
+    Request.Evaluation = Evaluation;
+
+    Enqueue(Job);
+    PumpQueue();
+    return Job->Id;
+}
+
+void FAISearchService::CancelJob(int32 JobId)
+{
+    check(IsInGameThread());
+
+    if (Queue.RemoveAll([JobId](const TSharedRef<FJob, ESPMode::ThreadSafe>& Job) { return Job->Id == JobId; }) > 0)
+    {
+        return;
+    }
+    for (const TUniquePtr<FSlot>& Slot : Slots)
+    {
+        if (Slot->Job.IsValid() && Slot->Job->Id == JobId)
+        {
+            // the slot stays busy until the search has unwound, FinishJob drops the result
+            Slot->Job->IsCancelled = true;
+            Slot->Job->IsPreempted = false;
+            Slot->Job->OnFinished = nullptr;
+            return;
+        }
+    }
+}
+
+void FAISearchService::CancelAllJobs()
+{
+    Queue.Empty();
+    for (const TUniquePtr<FSlot>& Slot : Slots)
+    {
+        if (Slot->Job.IsValid())
+        {
+            Slot->Job->IsCancelled = true;
+            Slot->Job->IsPreempted = false;
+            Slot->Job->OnFinished = nullptr;
+        }
+    }
+}
+
+int32 FAISearchService::GetRunningJobCount() const
+{
+    int32 Count = 0;
+    for (const TUniquePtr<FSlot>& Slot : Slots)
+    {
+        Count += Slot->Job.IsValid() ? 1 : 0;
+    }
+    return Count;
+}
+
+void FAISearchService::PumpQueue()
+{
+    for (int32 SlotIndex = 0; SlotIndex < Slots.Num() && Queue.Num() > 0; ++SlotIndex)
+    {
+        if (!Slots[SlotIndex]->Job.IsValid())
+        {
+            const TSharedRef<FJob, ESPMode::ThreadSafe> Job = Queue[0];
+            Queue.RemoveAt(0, 1, false);
+            LaunchJob(SlotIndex, Job);
+        }
+    }
+
+    // every slot is busy: each waiting job above background may take the slot of one running background job
+    int32 Preemptions = 0;
+    for (const TSharedRef<FJob, ESPMode::ThreadSafe>& Waiting : Queue)
+    {
+        if (Waiting->Priority > EAISearchPriority::Background)
+        {
+            ++Preemptions;
+        }
+    }
+    for (const TUniquePtr<FSlot>& Slot : Slots)
+    {
+        if (Preemptions == 0)
+        {
+            break;
+        }
+        // a job already unwinding frees its slot soon enough
+        if (Slot->Job.IsValid() && Slot->Job->Priority == EAISearchPriority::Background && !Slot->Job->IsCancelled)
+        {
+            Slot->Job->IsCancelled = true;
+            Slot->Job->IsPreempted = true;
+            --Preemptions;
+        }
+    }
+}
+
+void FAISearchService::LaunchJob(int32 SlotIndex, const TSharedRef<FJob, ESPMode::ThreadSafe>& Job)
+{
+    FSlot* Slot = Slots[SlotIndex].Get();
+    Slot->Job = Job;
+    const TWeakPtr<FAISearchService, ESPMode::ThreadSafe> WeakThis = AsShared();
+
+    PendingSearches++;
+    AsyncTask(ENamedThreads::AnyThread, [this, Slot, Job, SlotIndex, WeakThis]()
+    {
+        Job->Result = Slot->Search.Run(Job->Request, Job->IsCancelled);
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotIndex]()
+        {
+            // the service may have been shut down while the search unwound
+            if (const TSharedPtr<FAISearchService, ESPMode::ThreadSafe> Service = WeakThis.Pin())
+            {
+                Service->FinishJob(SlotIndex);
+            }
+        });
+        PendingSearches--;
+    });
+}
+
+void FAISearchService::FinishJob(int32 SlotIndex)
+{
+    const TSharedPtr<FJob, ESPMode::ThreadSafe> Job = Slots[SlotIndex]->Job;
+    Slots[SlotIndex]->Job.Reset();
+
+    if (Job.IsValid())
+    {
+        if (Job->IsPreempted)
+        {
+            // starts over once a slot frees up; the slot's table keeps most of what it had found
+            Job->IsCancelled = false;
+            Job->IsPreempted = false;
+            Enqueue(Job.ToSharedRef());
+        }
+        else if (Job->Result.IsComplete && Job->OnFinished)
+        {
+            Job->OnFinished(Job->Result);
+        }
+    }
+
+    PumpQueue();
+}
+
+void FAISearchService::Enqueue(const TSharedRef<FJob, ESPMode::ThreadSafe>& Job)
+{
+    int32 Index = 0;
+    while (Index < Queue.Num() && Queue[Index]->Priority >= Job->Priority)
+    {
+        ++Index;
+    }
+    Queue.Insert(Job, Index);
+}
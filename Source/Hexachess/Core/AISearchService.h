@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+
+#include "Search/MinimaxSearch.h"
+#include "Types/AIType.h"
+
+class Board;
+
+
+/*
+ * Runs minimax searches for any number of boards on a fixed number of slots, so concurrent games, puzzles and
+ * analysis share the machine instead of each starting its own threads. Every slot keeps its own FMinimaxSearch,
+ * and with it its transposition table, from one job to the next; a job searches on its slot's thread alone.
+ * Jobs wait in a queue, highest priority first and oldest first within a priority. Only the game thread may call in,
+ * and the callbacks come back on it.
+ */
+class FAISearchService : public TSharedFromThis<FAISearchService, ESPMode::ThreadSafe>
+{
+public:
+
+    explicit FAISearchService(int32 InSlotCount);
+
+    // cancels every job and waits for the running ones to unwind
+    ~FAISearchService();
+
+    FAISearchService(const FAISearchService&) = delete;
+    FAISearchService& operator=(const FAISearchService&) = delete;
+
+    /*
+     * Queues a search of the board's position for the side IsWhiteAI plays; the position is copied, the board can change right away.
+     * The job stops at whichever of MaxDepth, TimeBudgetMs and NodeBudget comes first (0 for no clock, no node limit).
+     * OnFinished gets the result on the game thread; it is not called for a cancelled job.
+     * Returns the job's id for CancelJob.
+     */
+    int32 SubmitJob(Board* ActiveBoard, bool IsWhiteAI, int32 MaxDepth, int32 TimeBudgetMs, int64 NodeBudget, EAISearchPriority Priority,
+        TFunction<void(const FMinimaxResult&)> OnFinished, TSharedPtr<const Evaluator, ESPMode::ThreadSafe> Evaluation = nullptr);
+
+    // drops a queued job, or makes a running one unwind; unknown and finished ids are ignored
+    void CancelJob(int32 JobId);
+
+    void CancelAllJobs();
+
+    int32 GetQueuedJobCount() const { return Queue.Num(); }
+
+    int32 GetRunningJobCount() const;
+
+    int32 GetSlotCount() const { return Slots.Num(); }
+
+private:
+
+    struct FJob
+    {
+        int32 Id = 0;
+        EAISearchPriority Priority = EAISearchPriority::Normal;
+        FMinimaxRequest Request;
+        TFunction<void(const FMinimaxResult&)> OnFinished;
+        // raised on the game thread, read by the slot's search
+        std::atomic<bool> IsCancelled = false;
+        // set by the game thread when a higher priority job took the slot; the job goes back in the queue instead of finishing
+        bool IsPreempted = false;
+        // written by the slot's thread before it hands the job back to the game thread
+        FMinimaxResult Result;
+    };
+
+    struct FSlot
+    {
+        FMinimaxSearch Search;
+        TSharedPtr<FJob, ESPMode::ThreadSafe> Job;
+    };
+
+    // starts queued jobs on the idle slots, then preempts background jobs for any higher priority job still waiting
+    void PumpQueue();
+
+    void LaunchJob(int32 SlotIndex, const TSharedRef<FJob, ESPMode::ThreadSafe>& Job);
+
+    // on the game thread once the slot's search has returned
+    void FinishJob(int32 SlotIndex);
+
+    // keeps the queue sorted by priority, a job goes behind the ones of its own priority
+    void Enqueue(const TSharedRef<FJob, ESPMode::ThreadSafe>& Job);
+
+    // only the game thread touches the queue and the slots' Job pointers
+    TArray<TSharedRef<FJob, ESPMode::ThreadSafe>> Queue;
+    TArray<TUniquePtr<FSlot>> Slots;
+
+    int32 NextJobId = 1;
+
+    // searches started on a task graph thread and not returned yet
+    std::atomic<int32> PendingSearches = 0;
+};
@@ -1,5 +1,14 @@
 #include "HexaGameInstance.h"
 
+#include "Async/TaskGraphInterfaces.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/QueuedThreadPool.h"
+
+#include "AsyncLoadingScreenLibrary.h"
+
+#include "Chess/ChessEngine.h"
+#include "Core/AISearchService.h"
+
 
 UHexaGameInstance::UHexaGameInstance(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
@@ -9,4 +18,103 @@ UHexaGameInstance::UHexaGameInstance(const FObjectInitializer& ObjectInitializer
 void UHexaGameInstance::Init()
 {
     Super::Init();
-}
\ No newline at end of file
+
+    const int32 SlotCount = AISearchSlotCount > 0 ? AISearchSlotCount : FTaskGraphInterface::Get().GetNumWorkerThreads();
+    AISearchService = MakeShared<FAISearchService, ESPMode::ThreadSafe>(SlotCount);
+
+    if (UseAIThreadPool)
+    {
+        int32 ThreadCount = AIThreadPoolSize > 0 ? AIThreadPoolSize : AIThreadCount;
+        if (ThreadCount <= 0)
+        {
+            ThreadCount = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+        }
+        const EThreadPriority Priority = AIThreadPriority == EAIThreadPriority::Lowest ? TPri_Lowest
+            : AIThreadPriority == EAIThreadPriority::BelowNormal ? TPri_BelowNormal : TPri_Normal;
+        AIThreadPool = FQueuedThreadPool::Allocate();
+        if (!AIThreadPool->Create(FMath::Clamp(ThreadCount, 1, 64), FMath::Max(AIThreadStackSizeKB, 128) * 1024, Priority, TEXT("HexachessAIThreadPool")))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Could not create the AI thread pool, the AI searches on the task graph"));
+            delete AIThreadPool;
+            AIThreadPool = nullptr;
+        }
+    }
+}
+
+void UHexaGameInstance::Shutdown()
+{
+    // waits for the running searches, their results are dropped
+    AISearchService.Reset();
+
+    // the AI components waited for their searches when their world ended play
+    if (AIThreadPool != nullptr)
+    {
+        AIThreadPool->Destroy();
+        delete AIThreadPool;
+        AIThreadPool = nullptr;
+    }
+
+    for (Board* FreeBoard : FreeBoards)
+    {
+        delete FreeBoard;
+    }
+    FreeBoards.Empty();
+
+    Super::Shutdown();
+}
+
+FAISearchService& UHexaGameInstance::GetAISearchService() const
+{
+    check(AISearchService.IsValid());
+    return *AISearchService;
+}
+
+void UHexaGameInstance::OpenMatchLevel(FName LevelName)
+{
+    // a second click while the match loads opens it once
+    const bool bAlreadyLoading = !PendingMatchLevel.IsNone();
+    PendingMatchLevel = LevelName;
+    if (bAlreadyLoading)
+    {
+        return;
+    }
+
+    FOnLevelPreloaded OnPreloaded;
+    OnPreloaded.BindDynamic(this, &UHexaGameInstance::OnMatchLevelPreloaded);
+    UAsyncLoadingScreenLibrary::PreloadLevel(LevelName, MatchPreloadAssets, OnPreloaded);
+}
+
+float UHexaGameInstance::GetMatchLoadProgress() const
+{
+    return PendingMatchLevel.IsNone() ? 1.0f : UAsyncLoadingScreenLibrary::GetPreloadProgress();
+}
+
+void UHexaGameInstance::OnMatchLevelPreloaded()
+{
+    const FName LevelName = PendingMatchLevel;
+    PendingMatchLevel = NAME_None;
+    if (!LevelName.IsNone())
+    {
+        UGameplayStatics::OpenLevel(this, LevelName);
+    }
+}
+
+Board* UHexaGameInstance::AcquireBoard()
+{
+    if (FreeBoards.Num() > 0)
+    {
+        return FreeBoards.Pop(false);
+    }
+    return new Board();
+}
+
+void UHexaGameInstance::ReleaseBoard(Board* InBoard)
+{
+    if (InBoard == nullptr)
+    {
+        return;
+    }
+    // reset on the way in, so AcquireBoard hands out a board in the state new Board() would
+    InBoard->reset();
+    FreeBoards.Add(InBoard);
+}
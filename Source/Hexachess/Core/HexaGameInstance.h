@@ -6,6 +6,10 @@
 
 #include "HexaGameInstance.generated.h"
 
+class Board;
+class FAISearchService;
+class FQueuedThreadPool;
+
 
 UCLASS()
 class HEXACHESS_API UHexaGameInstance : public UGameInstance
@@ -17,6 +21,36 @@ public:
     UHexaGameInstance(const FObjectInitializer& ObjectInitializer);
 
     virtual void Init() override;
+    virtual void Shutdown() override;
+
+    /*
+     * An empty board from the pool, allocated only when the pool has none; hand it back with ReleaseBoard.
+     * Boards outlive the worlds that use them, so rematches and menu previews reuse the same cells.
+     */
+    Board* AcquireBoard();
+
+    void ReleaseBoard(Board* InBoard);
+
+    // the searches of every game, puzzle and analysis board share its slots; only valid between Init and Shutdown
+    FAISearchService& GetAISearchService() const;
+
+    // the threads the AI components search on, nullptr without UseAIThreadPool; only valid between Init and Shutdown
+    FQueuedThreadPool* GetAIThreadPool() const { return AIThreadPool; }
+
+    /*
+     * Loads the match level and MatchPreloadAssets in the background while the menu keeps running, then opens the level;
+     * the loading screen only shows for what is left. LevelName is a long package name, e.g. /Game/Maps/Match.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Loading")
+    void OpenMatchLevel(FName LevelName);
+
+    // what OpenMatchLevel has loaded of the level and its assets, from 0 to 1
+    UFUNCTION(BlueprintPure, Category = "Loading")
+    float GetMatchLoadProgress() const;
+
+    // the chess set loaded with a match: the piece blueprints with their geometry collections, the tile materials and the board meshes
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Loading")
+    TArray<FSoftObjectPath> MatchPreloadAssets;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gameplay")
     bool IsPlayingAgainstAI = false;
@@ -29,4 +63,43 @@ public:
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gameplay")
     bool IsAIPlayingWhite = false;
+
+    // number of threads the minimax AI searches with, 0 uses every task graph worker
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gameplay")
+    int32 AIThreadCount = 0;
+
+    // searches the AI search service runs at once, each on one thread; 0 uses one per task graph worker
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gameplay")
+    int32 AISearchSlotCount = 0;
+
+    // the minimax and Monte Carlo searches run on threads of their own instead of the task graph's,
+    // so a long search never holds up the renderer's and the streaming's tasks; read once in Init
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gameplay")
+    bool UseAIThreadPool = true;
+
+    // threads of the AI thread pool, a search uses at most this many; 0 uses AIThreadCount, or one per task graph worker plus one
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gameplay", meta = (ClampMin = "0", ClampMax = "64"))
+    int32 AIThreadPoolSize = 0;
+
+    // the search recurses once per ply with its move lists on the stack, deeper than the pools' small default stacks allow
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gameplay", meta = (ClampMin = "128"))
+    int32 AIThreadStackSizeKB = 1024;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gameplay")
+    EAIThreadPriority AIThreadPriority = EAIThreadPriority::BelowNormal;
+
+private:
+
+    UFUNCTION()
+    void OnMatchLevelPreloaded();
+
+    // the level OpenMatchLevel opens once it is preloaded, None when no match is loading
+    FName PendingMatchLevel;
+
+    // boards handed back with ReleaseBoard, already reset; only the game thread touches them
+    TArray<Board*> FreeBoards;
+
+    TSharedPtr<FAISearchService, ESPMode::ThreadSafe> AISearchService;
+
+    FQueuedThreadPool* AIThreadPool = nullptr;
 };
@@ -1 +1,253 @@
 #include "HexaGameState.h"
+
+#include "Kismet/GameplayStatics.h"
+
+#include "Actors/ChessGod.h"
+#include "Chess/ChessEngine.h"
+#include "Core/HexaGameInstance.h"
+
+
+void AHexaGameState::RestartGame(AHexaGrid* Grid)
+{
+    if (ChessGod == nullptr)
+    {
+        ChessGod = Cast<AChessGod>(UGameplayStatics::GetActorOfClass(this, AChessGod::StaticClass()));
+    }
+    if (ChessGod == nullptr)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No chess god to restart the game on"));
+        return;
+    }
+    ChessGod->ResetToStartingPosition(Grid);
+    StartTurns();
+}
+
+void AHexaGameState::PauseGame()
+{
+    if (TurnState == ETurnState::Idle || TurnState == ETurnState::Paused || TurnState == ETurnState::GameOver)
+    {
+        return;
+    }
+    // a search cannot be suspended, but one started again on the same position finds most of its work in the table
+    if (TurnState == ETurnState::AIThinking)
+    {
+        ChessGod->MinimaxAIComponent->CancelSearch();
+        ChessGod->MctsAIComponent->CancelSearch();
+    }
+    PausedTurnState = TurnState;
+    SetTurnState(ETurnState::Paused);
+}
+
+void AHexaGameState::ResumeGame()
+{
+    if (TurnState != ETurnState::Paused)
+    {
+        return;
+    }
+    SetTurnState(PausedTurnState);
+    if (TurnState == ETurnState::AIThinking)
+    {
+        StartAISearch();
+    }
+    else if (TurnState == ETurnState::Animating)
+    {
+        // the animation or the legality may have finished while paused
+        TryStartTurn();
+    }
+}
+
+void AHexaGameState::StartTurns()
+{
+    if (ChessGod == nullptr)
+    {
+        ChessGod = Cast<AChessGod>(UGameplayStatics::GetActorOfClass(this, AChessGod::StaticClass()));
+    }
+    if (ChessGod == nullptr || ChessGod->GetPosition() == nullptr)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No board to start the turns on"));
+        return;
+    }
+    ChessGod->OnAIFinishedCalculatingMove.AddUniqueDynamic(this, &AHexaGameState::HandleAIMove);
+    ChessGod->OnLegalityComputed.AddUniqueDynamic(this, &AHexaGameState::HandleLegalityComputed);
+
+    if (const UHexaGameInstance* GameInstance = GetGameInstance<UHexaGameInstance>())
+    {
+        IsPlayingAgainstAI = GameInstance->IsPlayingAgainstAI;
+        IsAIPlayingWhite = GameInstance->IsAIPlayingWhite;
+        AIType = GameInstance->AIType;
+        AIDifficulty = GameInstance->AIDifficulty;
+    }
+    Outcome = EGameOutcome::None;
+
+    // a game left for a new one is written as far as it went
+    MatchCapture.Reset();
+    if (FHexaMatchCapture::ConsumeArmed())
+    {
+        MatchCapture = MakeUnique<FHexaMatchCapture>();
+        ChessGod->LegalityQueryStats = AChessGod::FLegalityQueryStats();
+    }
+
+    // nothing animates before the first turn, it only waits for its legal moves
+    IsMoveAnimating = false;
+    IsLegalityKnown = false;
+    SetTurnState(ETurnState::Animating);
+    ChessGod->RequestLegalityAsync(IsWhiteTurn());
+}
+
+bool AHexaGameState::SubmitMove(FIntPoint From, FIntPoint To)
+{
+    if (TurnState != ETurnState::AwaitingPlayer)
+    {
+        return false;
+    }
+    // the turn only started once this move set was known, reading it costs nothing
+    const TArray<FIntPoint>* Targets = ChessGod->ComputeLegalMoveSet(IsWhiteTurn()).Find(From);
+    if (Targets == nullptr || !Targets->Contains(To))
+    {
+        return false;
+    }
+    PlayMove(From, To);
+    return true;
+}
+
+void AHexaGameState::FinishMoveAnimation()
+{
+    if (MatchCapture.IsValid())
+    {
+        MatchCapture->AnimationFinished();
+    }
+    IsMoveAnimating = false;
+    TryStartTurn();
+}
+
+bool AHexaGameState::IsWhiteTurn() const
+{
+    const PackedBoard* Position = ChessGod != nullptr ? ChessGod->GetPosition() : nullptr;
+    return Position == nullptr || !Position->black_to_move;
+}
+
+void AHexaGameState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    MatchCapture.Reset();
+    Super::EndPlay(EndPlayReason);
+}
+
+void AHexaGameState::SetTurnState(ETurnState InTurnState)
+{
+    TurnState = InTurnState;
+    OnTurnStateChanged.Broadcast(TurnState);
+}
+
+void AHexaGameState::PlayMove(FIntPoint From, FIntPoint To)
+{
+    const bool IsWhiteMove = IsWhiteTurn();
+    if (!ChessGod->MovePiece(From, To))
+    {
+        return;
+    }
+    if (MatchCapture.IsValid())
+    {
+        MatchCapture->MovePlayed();
+    }
+
+    IsMoveAnimating = WaitForMoveAnimations;
+    IsLegalityKnown = false;
+    SetTurnState(ETurnState::Animating);
+    OnMovePlayed.Broadcast(From, To, IsWhiteMove);
+
+    // generated on a worker while the piece moves, the next turn rarely waits for it
+    ChessGod->RequestLegalityAsync(IsWhiteTurn());
+}
+
+void AHexaGameState::TryStartTurn()
+{
+    if (TurnState != ETurnState::Animating || IsMoveAnimating || !IsLegalityKnown)
+    {
+        return;
+    }
+
+    const bool IsWhite = IsWhiteTurn();
+    if (!NextHasValidMoves)
+    {
+        EndWith(!NextIsInCheck ? EGameOutcome::Stalemate : IsWhite ? EGameOutcome::BlackWins : EGameOutcome::WhiteWins);
+        return;
+    }
+    const EGameOutcome Draw = ChessGod->GetDrawOutcome();
+    if (Draw != EGameOutcome::None)
+    {
+        EndWith(Draw);
+        return;
+    }
+
+    const bool IsAI = IsAITurn();
+    if (MatchCapture.IsValid())
+    {
+        FlushLegalityQueries();
+        MatchCapture->BeginTurn(IsWhite, IsAI);
+    }
+    SetTurnState(IsAI ? ETurnState::AIThinking : ETurnState::AwaitingPlayer);
+    OnTurnStarted.Broadcast(IsWhite, NextIsInCheck);
+    // a handler may have paused the game or restarted it
+    if (IsAI && TurnState == ETurnState::AIThinking)
+    {
+        StartAISearch();
+    }
+}
+
+void AHexaGameState::StartAISearch()
+{
+    // the move comes back through OnAIFinishedCalculatingMove, right away for a book or random move
+    ChessGod->MakeAIMove(IsWhiteTurn(), AIType, AIDifficulty);
+}
+
+bool AHexaGameState::IsAITurn() const
+{
+    return IsPlayingAgainstAI && IsWhiteTurn() == IsAIPlayingWhite;
+}
+
+void AHexaGameState::EndWith(EGameOutcome InOutcome)
+{
+    Outcome = InOutcome;
+    if (MatchCapture.IsValid())
+    {
+        FlushLegalityQueries();
+        MatchCapture->Finish(Outcome);
+        MatchCapture.Reset();
+    }
+    SetTurnState(ETurnState::GameOver);
+    OnGameOver.Broadcast(Outcome);
+}
+
+void AHexaGameState::FlushLegalityQueries()
+{
+    AChessGod::FLegalityQueryStats& Stats = ChessGod->LegalityQueryStats;
+    MatchCapture->AddLegalityQueries(Stats.Count, Stats.Misses, Stats.Seconds);
+    Stats = AChessGod::FLegalityQueryStats();
+}
+
+void AHexaGameState::HandleAIMove(FIntPoint From, FIntPoint To)
+{
+    // a move the level asked for itself, outside of the turns
+    if (TurnState != ETurnState::AIThinking || !IsAITurn())
+    {
+        return;
+    }
+    PlayMove(From, To);
+}
+
+void AHexaGameState::HandleLegalityComputed(bool IsWhitePlayer, bool HasValidMoves, bool IsInCheck)
+{
+    const bool IsWaiting = TurnState == ETurnState::Animating || (TurnState == ETurnState::Paused && PausedTurnState == ETurnState::Animating);
+    if (!IsWaiting || IsWhitePlayer != IsWhiteTurn())
+    {
+        return;
+    }
+    IsLegalityKnown = true;
+    if (MatchCapture.IsValid())
+    {
+        MatchCapture->LegalityKnown();
+    }
+    NextHasValidMoves = HasValidMoves;
+    NextIsInCheck = IsInCheck;
+    TryStartTurn();
+}
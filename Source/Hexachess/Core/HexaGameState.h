@@ -3,11 +3,25 @@
 #include "CoreMinimal.h"
 #include "GameFramework/GameStateBase.h"
 
+#include "Core/HexaMatchCapture.h"
+#include "Types/AIType.h"
+#include "Types/TurnState.h"
+
 #include "HexaGameState.generated.h"
 
+class AChessGod;
+class AHexaGrid;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTurnStateChanged, ETurnState, TurnState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnTurnStarted, bool, IsWhiteTurn, bool, IsInCheck);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnTurnMovePlayed, FIntPoint, From, FIntPoint, To, bool, IsWhiteMove);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGameOver, EGameOutcome, Outcome);
+
 
 /**
- * 
+ * Drives the turns of a game on ChessGod's board: whose turn it is, starting the AI's search, and check, mate, stalemate
+ * and repetition after every move, so Blueprint only reacts to the events instead of polling the board.
+ * While a played move animates, the next side's legal moves are generated on a worker; the turn starts once both are done.
  */
 UCLASS()
 class HEXACHESS_API AHexaGameState : public AGameStateBase
@@ -16,14 +30,108 @@ class HEXACHESS_API AHexaGameState : public AGameStateBase
 
 public:
 
-	// session boilerplate for later
+	// a new game from the starting position, with the AI settings of the game instance
+	// the previous game's boards and AI state are reused; with a Grid its piece actors are put back on their starting cells too
+	UFUNCTION(BlueprintCallable)
+	virtual void RestartGame(AHexaGrid* Grid = nullptr);
 
+	// an AI search in flight is cancelled, and started again by ResumeGame; its transposition table keeps what it found
 	UFUNCTION(BlueprintCallable)
-	virtual void RestartGame() {}
+	virtual void PauseGame();
 
 	UFUNCTION(BlueprintCallable)
-	virtual void PauseGame() {}
+	virtual void ResumeGame();
 
+	// starts the turns on the position ChessGod holds, for a game set up or loaded by other means than RestartGame
 	UFUNCTION(BlueprintCallable)
-	virtual void ResumeGame() {}
+	virtual void StartTurns();
+
+	// plays a player's move; false when it is not a player's turn or the move is not legal
+	UFUNCTION(BlueprintCallable)
+	virtual bool SubmitMove(FIntPoint From, FIntPoint To);
+
+	// the level calls it once the piece of OnMovePlayed has arrived; the next turn starts then
+	UFUNCTION(BlueprintCallable)
+	virtual void FinishMoveAnimation();
+
+	UFUNCTION(BlueprintPure)
+	ETurnState GetTurnState() const { return TurnState; }
+
+	UFUNCTION(BlueprintPure)
+	EGameOutcome GetOutcome() const { return Outcome; }
+
+	UFUNCTION(BlueprintPure)
+	bool IsWhiteTurn() const;
+
+	// a game captured with Hexachess.CaptureMatch writes what it recorded when the level ends before the game does
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnTurnStateChanged OnTurnStateChanged;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnTurnStarted OnTurnStarted;
+
+	// raised for the players' and the AI's moves alike, after the move is on the board
+	UPROPERTY(BlueprintAssignable)
+	FOnTurnMovePlayed OnMovePlayed;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnGameOver OnGameOver;
+
+	// found in the level when it is not set
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gameplay")
+	AChessGod* ChessGod = nullptr;
+
+	// without animations a move starts the next turn as soon as its legal moves are known, FinishMoveAnimation is not needed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gameplay")
+	bool WaitForMoveAnimations = true;
+
+private:
+
+	void SetTurnState(ETurnState InTurnState);
+
+	// plays the move on ChessGod's board and asks for the next side's legal moves while it animates
+	void PlayMove(FIntPoint From, FIntPoint To);
+
+	// starts the next turn once the move animated and the side's legal moves are known
+	void TryStartTurn();
+
+	void StartAISearch();
+
+	bool IsAITurn() const;
+
+	void EndWith(EGameOutcome InOutcome);
+
+	// hands the board's legality query counters of the turn to the capture
+	void FlushLegalityQueries();
+
+	UFUNCTION()
+	void HandleAIMove(FIntPoint From, FIntPoint To);
+
+	UFUNCTION()
+	void HandleLegalityComputed(bool IsWhitePlayer, bool HasValidMoves, bool IsInCheck);
+
+	ETurnState TurnState = ETurnState::Idle;
+
+	// the state PauseGame left, ResumeGame goes back to it
+	ETurnState PausedTurnState = ETurnState::Idle;
+
+	EGameOutcome Outcome = EGameOutcome::None;
+
+	// copied from the game instance when the turns start
+	bool IsPlayingAgainstAI = false;
+	bool IsAIPlayingWhite = false;
+	EAIType AIType = EAIType::Random;
+	EAIDifficulty AIDifficulty = EAIDifficulty::Easy;
+
+	// the next turn's legality, answered by the worker while the move animates
+	bool IsLegalityKnown = false;
+	bool NextHasValidMoves = false;
+	bool NextIsInCheck = false;
+
+	bool IsMoveAnimating = false;
+
+	// set for the game the console armed, until it ends
+	TUniquePtr<FHexaMatchCapture> MatchCapture;
 };
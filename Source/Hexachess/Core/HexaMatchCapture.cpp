@@ -0,0 +1,185 @@
+#include "HexaMatchCapture.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "ProfilingDebugging/TraceAuxiliary.h"
+
+namespace HexaMatchCapture
+{
+    // the memory allocation channel can only be turned on at startup, the CSV's memory columns stand in for it
+    const TCHAR* TraceChannels = TEXT("cpu,frame,bookmark,stats,task");
+
+    bool IsCommandLineChecked = false;
+
+    FAutoConsoleCommand CaptureMatchCommand(
+        TEXT("Hexachess.CaptureMatch"),
+        TEXT("Captures the next game: an Insights trace and a CSV of its turn timings and memory, in Saved/Profiling/Hexachess."),
+        FConsoleCommandDelegate::CreateStatic(&FHexaMatchCapture::Arm));
+
+    double ToMs(double From, double To)
+    {
+        return (To - From) * 1000.0;
+    }
+
+    double ToMB(uint64 Bytes)
+    {
+        return Bytes / (1024.0 * 1024.0);
+    }
+}
+
+bool FHexaMatchCapture::IsArmed = false;
+
+void FHexaMatchCapture::Arm()
+{
+    IsArmed = true;
+    UE_LOG(LogTemp, Display, TEXT("CaptureMatch: the next game is captured"));
+}
+
+bool FHexaMatchCapture::ConsumeArmed()
+{
+    if (!HexaMatchCapture::IsCommandLineChecked)
+    {
+        HexaMatchCapture::IsCommandLineChecked = true;
+        IsArmed |= FParse::Param(FCommandLine::Get(), TEXT("CaptureMatch"));
+    }
+    const bool WasArmed = IsArmed;
+    IsArmed = false;
+    return WasArmed;
+}
+
+FHexaMatchCapture::FHexaMatchCapture()
+{
+    BaseName = FPaths::ProfilingDir() / TEXT("Hexachess") / FString::Printf(TEXT("Match-%s"), *FDateTime::Now().ToString());
+
+    // a trace the user already runs, from the command line or the console, gets the game's bookmarks instead
+    if (!FTraceAuxiliary::IsConnected())
+    {
+        const FString TracePath = BaseName + TEXT(".utrace");
+        IsTracing = FTraceAuxiliary::Start(FTraceAuxiliary::EConnectionType::File, *TracePath, HexaMatchCapture::TraceChannels);
+        if (!IsTracing)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("CaptureMatch: could not start a trace to %s, only the CSV is written"), *TracePath);
+        }
+    }
+    TRACE_BOOKMARK(TEXT("Match start"));
+
+    Csv = TEXT("Turn,Side,Mover,ThinkMs,LegalityWaitMs,LegalityQueries,LegalityQueryMisses,LegalityQueryMs,AnimationMs,TurnMs,UsedPhysicalMB,PeakUsedPhysicalMB\n");
+}
+
+FHexaMatchCapture::~FHexaMatchCapture()
+{
+    Finish(EGameOutcome::None);
+}
+
+void FHexaMatchCapture::BeginTurn(bool IsWhite, bool IsAI)
+{
+    if (IsFinished)
+    {
+        return;
+    }
+    EndTurn();
+
+    const int32 Index = Turn.Index + 1;
+    Turn = FTurn();
+    Turn.Index = Index;
+    Turn.IsWhite = IsWhite;
+    Turn.IsAI = IsAI;
+    Turn.StartTime = FPlatformTime::Seconds();
+    HasTurn = true;
+    TRACE_BOOKMARK(TEXT("Turn %d %s"), Index, IsAI ? TEXT("AI") : TEXT("player"));
+}
+
+void FHexaMatchCapture::MovePlayed()
+{
+    if (HasTurn && Turn.MoveTime == 0.0)
+    {
+        Turn.MoveTime = FPlatformTime::Seconds();
+    }
+}
+
+void FHexaMatchCapture::LegalityKnown()
+{
+    if (HasTurn && Turn.MoveTime != 0.0 && Turn.LegalityTime == 0.0)
+    {
+        Turn.LegalityTime = FPlatformTime::Seconds();
+    }
+}
+
+void FHexaMatchCapture::AnimationFinished()
+{
+    if (HasTurn && Turn.MoveTime != 0.0 && Turn.AnimationTime == 0.0)
+    {
+        Turn.AnimationTime = FPlatformTime::Seconds();
+    }
+}
+
+void FHexaMatchCapture::AddLegalityQueries(int32 Count, int32 Misses, double Seconds)
+{
+    if (HasTurn)
+    {
+        Turn.LegalityQueries += Count;
+        Turn.LegalityMisses += Misses;
+        Turn.LegalityQuerySeconds += Seconds;
+    }
+}
+
+void FHexaMatchCapture::Finish(EGameOutcome Outcome)
+{
+    if (IsFinished)
+    {
+        return;
+    }
+    IsFinished = true;
+    EndTurn();
+    TRACE_BOOKMARK(TEXT("Match end"));
+
+    if (IsTracing)
+    {
+        FTraceAuxiliary::Stop();
+    }
+
+    const FString CsvPath = BaseName + TEXT(".csv");
+    if (!FFileHelper::SaveStringToFile(Csv, *CsvPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("CaptureMatch: could not write %s"), *CsvPath);
+        return;
+    }
+    UE_LOG(LogTemp, Display, TEXT("CaptureMatch: %d turns, outcome %s, peak physical memory %.1f MB, written to %s"), Turn.Index,
+        *UEnum::GetValueAsString(Outcome), HexaMatchCapture::ToMB(PeakUsedPhysical), *CsvPath);
+}
+
+void FHexaMatchCapture::EndTurn()
+{
+    if (!HasTurn)
+    {
+        return;
+    }
+    HasTurn = false;
+
+    const double EndTime = FPlatformTime::Seconds();
+    const FPlatformMemoryStats Memory = FPlatformMemory::GetStats();
+    PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, Memory.PeakUsedPhysical);
+
+    // an event that did not happen, such as the animation of the game's last move, leaves its column empty
+    auto Elapsed = [](double From, double To)
+    {
+        return From != 0.0 && To != 0.0 ? FString::Printf(TEXT("%.2f"), HexaMatchCapture::ToMs(From, To)) : FString();
+    };
+    Csv += FString::Printf(TEXT("%d,%s,%s,%s,%s,%d,%d,%.2f,%s,%.2f,%.1f,%.1f\n"),
+        Turn.Index,
+        Turn.IsWhite ? TEXT("white") : TEXT("black"),
+        Turn.IsAI ? TEXT("AI") : TEXT("player"),
+        *Elapsed(Turn.StartTime, Turn.MoveTime),
+        *Elapsed(Turn.MoveTime, Turn.LegalityTime),
+        Turn.LegalityQueries,
+        Turn.LegalityMisses,
+        Turn.LegalityQuerySeconds * 1000.0,
+        *Elapsed(Turn.MoveTime, Turn.AnimationTime),
+        HexaMatchCapture::ToMs(Turn.StartTime, EndTime),
+        HexaMatchCapture::ToMB(Memory.UsedPhysical),
+        HexaMatchCapture::ToMB(Memory.PeakUsedPhysical));
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Types/TurnState.h"
+
+
+/*
+ * Records one game for a performance report: an Insights trace of the game (AI search, move generation and the board
+ * queries of the UI), and a CSV with a line per turn of its timings and the process memory at its end.
+ * Armed from the console with `Hexachess.CaptureMatch` or with -CaptureMatch on the command line; the next game
+ * AHexaGameState starts is captured, and the files are written to Saved/Profiling/Hexachess when it ends.
+ * Turn timings include any time the game spent paused.
+ */
+class FHexaMatchCapture
+{
+public:
+
+    // the next game started is captured
+    static void Arm();
+
+    // true once per Arm; the game that asks first gets the capture
+    static bool ConsumeArmed();
+
+    FHexaMatchCapture();
+
+    // writes what was recorded so far when the game did not reach its end
+    ~FHexaMatchCapture();
+
+    FHexaMatchCapture(const FHexaMatchCapture&) = delete;
+    FHexaMatchCapture& operator=(const FHexaMatchCapture&) = delete;
+
+    // a side's turn started, the AI's or a player's; ends the previous turn's line
+    void BeginTurn(bool IsWhite, bool IsAI);
+
+    // the turn's move is on the board, its animation and the next side's legality start
+    void MovePlayed();
+
+    // the next side's legal moves came back from the worker
+    void LegalityKnown();
+
+    // the level reported the move's piece arrived
+    void AnimationFinished();
+
+    // the board's synchronous legality queries of the turn, read from AChessGod's counters
+    void AddLegalityQueries(int32 Count, int32 Misses, double Seconds);
+
+    // ends the last turn, stops the trace and writes the CSV; nothing is recorded after it
+    void Finish(EGameOutcome Outcome);
+
+private:
+
+    struct FTurn
+    {
+        int32 Index = 0;
+        bool IsWhite = true;
+        bool IsAI = false;
+        double StartTime = 0.0;
+        // 0 until the event happened
+        double MoveTime = 0.0;
+        double LegalityTime = 0.0;
+        double AnimationTime = 0.0;
+        int32 LegalityQueries = 0;
+        int32 LegalityMisses = 0;
+        double LegalityQuerySeconds = 0.0;
+    };
+
+    void EndTurn();
+
+    static bool IsArmed;
+
+    FString BaseName;
+    bool IsTracing = false;
+    bool IsFinished = false;
+    bool HasTurn = false;
+    FTurn Turn;
+    FString Csv;
+    uint64 PeakUsedPhysical = 0;
+};
@@ -0,0 +1 @@
+#include "HexaSaveGame.h"
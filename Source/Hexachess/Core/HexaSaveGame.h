@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+
+#include "HexaSaveGame.generated.h"
+
+
+/**
+ * A game in progress as AChessGod::SaveGameAsync writes it: the position its move history starts from, encoded like
+ * SavePosition with its pawn shadow beside it, and the played moves, encoded like GetMoveRecord. A game of 60 moves
+ * takes under 200 bytes.
+ */
+UCLASS()
+class HEXACHESS_API UHexaSaveGame : public USaveGame
+{
+    GENERATED_BODY()
+
+public:
+
+    // bumped whenever the encoding of the fields below changes, older saves are then refused
+    static constexpr int32 CurrentVersion = 2;
+
+    UPROPERTY()
+    int32 Version = CurrentVersion;
+
+    UPROPERTY()
+    TArray<uint8> StartPosition;
+
+    // the cell a pawn jumped over just before the start position, -1 for none; the encoding has no room for it
+    UPROPERTY()
+    int32 StartShadowCell = -1;
+
+    UPROPERTY()
+    TArray<uint8> MoveRecord;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Save")
+    FDateTime SavedAt;
+};
@@ -12,8 +12,8 @@ public class Hexachess : ModuleRules
 
 		PublicIncludePaths.AddRange(new string[] { "Hexachess" });
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "Sockets", "Json", "JsonUtilities", "HTTP", "GeometryCollectionEngine"});
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "Sockets", "Json", "JsonUtilities", "HTTP", "GeometryCollectionEngine", "HexachessEngine"});
 
-		PrivateDependencyModuleNames.AddRange(new string[] { "Hexachess" });
+		PrivateDependencyModuleNames.AddRange(new string[] { "Hexachess", "AsyncLoadingScreen" });
 	}
 }
@@ -1,44 +1,283 @@
 ﻿#include "HexConnection.h"
 
+#include "Async/Async.h"
+#include "IPAddress.h"
+#include "Sockets.h"
 #include "SocketSubsystem.h"
 #include "HttpModule.h"
 #include "Http.h"
+#include "Serialization/JsonSerializer.h"
+
+#include "Actors/ChessGod.h"
+#include "Chess/CellIndex.h"
+#include "Chess/ChessEngine.h"
+#include "Chess/PositionCodec.h"
+
+namespace
+{
+	// every packet starts with its type and the ply it is about, little-endian
+	enum class EMovePacket : uint8
+	{
+		// then the move's from and to cell indices, and the hash of the position it leads to (0 when the sender has not kept it), 8 bytes
+		Move = 1,
+		// then the position hash, 8 bytes
+		Checksum = 2,
+		// then the encoded position and its pawn shadow cell, host only
+		Position = 3,
+		// the ply is the receiver's received ply count; answers every move, repeated ones included
+		Ack = 4,
+		// sent until the peer's first packet arrives, to open both NATs
+		Punch = 5,
+		// then the sender's clock in milliseconds, 4 bytes, which the pong sends back
+		Ping = 6,
+		Pong = 7,
+	};
+
+	constexpr int32 HeaderSize = 3;
+	constexpr int32 MovePacketSize = HeaderSize + 2 + 8;
+	constexpr int32 ChecksumPacketSize = HeaderSize + 8;
+	constexpr int32 PositionPacketSize = HeaderSize + EncodedPosition::size + 1;
+	constexpr int32 PingPacketSize = HeaderSize + 4;
+
+	uint32 GetClockMs()
+	{
+		return static_cast<uint32>(FPlatformTime::Seconds() * 1000.0);
+	}
+
+	void WriteHeader(uint8* Out, EMovePacket Type, int32 Ply)
+	{
+		Out[0] = static_cast<uint8>(Type);
+		Out[1] = static_cast<uint8>(Ply & 0xFF);
+		Out[2] = static_cast<uint8>((Ply >> 8) & 0xFF);
+	}
+
+	void WriteHash(uint8* Out, uint64 Hash)
+	{
+		for (int32 i = 0; i < 8; i++)
+		{
+			Out[i] = static_cast<uint8>(Hash >> (i * 8));
+		}
+	}
+
+	uint64 ReadHash(const uint8* Data)
+	{
+		uint64 Hash = 0;
+		for (int32 i = 0; i < 8; i++)
+		{
+			Hash |= static_cast<uint64>(Data[i]) << (i * 8);
+		}
+		return Hash;
+	}
+
+	// the last discovered public address, shared by every connection; only the game thread touches it
+	FString CachedPublicIP;
+	double CachedPublicIPTime = 0.0;
+
+	bool IsIPv4Address(const FString& Text)
+	{
+		TArray<FString> Octets;
+		Text.ParseIntoArray(Octets, TEXT("."), false);
+		if (Octets.Num() != 4)
+		{
+			return false;
+		}
+		for (const FString& Octet : Octets)
+		{
+			if (Octet.IsEmpty() || Octet.Len() > 3 || !Octet.IsNumeric() || FCString::Atoi(*Octet) > 255)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// the address in an endpoint's answer, or empty; runs on any thread
+	FString ParsePublicIP(const FString& ResponseStr)
+	{
+		FString Candidate = ResponseStr.TrimStartAndEnd();
+		TSharedPtr<FJsonObject> JsonObject;
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseStr);
+		if (Candidate.StartsWith(TEXT("{")) && FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
+		{
+			if (!JsonObject->TryGetStringField(TEXT("origin"), Candidate))
+			{
+				JsonObject->TryGetStringField(TEXT("ip"), Candidate);
+			}
+			// httpbin lists every proxy hop, the first one is the client
+			Candidate.Split(TEXT(","), &Candidate, nullptr);
+			Candidate.TrimStartAndEndInline();
+		}
+		return IsIPv4Address(Candidate) ? Candidate : FString();
+	}
+}
+
+struct FPublicIPDiscovery
+{
+	TArray<TSharedRef<IHttpRequest>> Requests;
+	// endpoints that have neither failed nor had their answer parsed yet
+	int32 Outstanding = 0;
+};
+
+AHexConnection::AHexConnection()
+{
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void AHexConnection::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (Socket == nullptr || !ChessGod.IsValid() || ChessGod->GetPosition() == nullptr)
+	{
+		return;
+	}
+	ReceivePackets();
+	SendNewMoves();
+
+	const double Now = FPlatformTime::Seconds();
+	if (!HasPeerConnection)
+	{
+		if (Now - LastPunchTime >= PunchInterval)
+		{
+			LastPunchTime = Now;
+			SendControl(static_cast<uint8>(EMovePacket::Punch), GetPly());
+		}
+		if (PunchDeadline > 0.0 && Now > PunchDeadline)
+		{
+			PunchDeadline = 0.0;
+			UE_LOG(LogTemp, Warning, TEXT("The move channel peer did not answer."));
+			OnPeerConnectionChanged.Broadcast(false);
+		}
+		return;
+	}
+	if (Now - LastReceiveTime > PeerTimeoutSeconds)
+	{
+		HasPeerConnection = false;
+		PunchDeadline = Now + PeerTimeoutSeconds;
+		UE_LOG(LogTemp, Warning, TEXT("Lost the move channel peer."));
+		OnPeerConnectionChanged.Broadcast(false);
+		return;
+	}
+
+	if (IsLastMoveLocal && PeerAckedPly < SentPly && Now - LastMoveSendTime >= GetRetransmitDelay())
+	{
+		SendMove(SentPly - 1);
+	}
+	SinceChecksum += DeltaSeconds;
+	if (SinceChecksum >= ChecksumInterval)
+	{
+		SinceChecksum = 0.0f;
+		SendChecksum();
+		SendPing();
+	}
+}
+
+void AHexConnection::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	CloseMoveChannel();
+}
 
 void AHexConnection::GetPublicIPAddress()
 {
-	TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
-	Request->OnProcessRequestComplete().BindUObject(this, &AHexConnection::OnIPAddressResponseReceived);
-	Request->SetURL(TEXT("https://httpbin.org/ip")); // Replace with the appropriate API endpoint
-	Request->SetVerb("GET");
-	Request->ProcessRequest();
+	if (!CachedPublicIP.IsEmpty() && FPlatformTime::Seconds() - CachedPublicIPTime < PublicIPCacheSeconds)
+	{
+		MyIP = CachedPublicIP;
+		OnPublicIPReady.Broadcast(MyIP);
+		return;
+	}
+	// the running discovery answers this request too
+	if (Discovery.IsValid())
+	{
+		return;
+	}
+
+	Discovery = MakeShared<FPublicIPDiscovery>();
+	for (const FString& Endpoint : PublicIPEndpoints)
+	{
+		TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
+		Request->OnProcessRequestComplete().BindUObject(this, &AHexConnection::OnIPAddressResponseReceived);
+		Request->SetURL(Endpoint);
+		Request->SetVerb("GET");
+		Request->SetTimeout(PublicIPTimeoutSeconds);
+		Discovery->Requests.Add(Request);
+		Discovery->Outstanding++;
+	}
+	for (const TSharedRef<IHttpRequest>& Request : Discovery->Requests)
+	{
+		Request->ProcessRequest();
+	}
+	if (Discovery->Outstanding == 0)
+	{
+		Discovery.Reset();
+		OnPublicIPReady.Broadcast(FString());
+	}
 }
 
 void AHexConnection::OnIPAddressResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
 {
-	if (bWasSuccessful && Response.IsValid())
+	if (!Discovery.IsValid())
 	{
-		FString ResponseStr = Response->GetContentAsString();
-		// Parse the JSON response to extract the public IP address.
-		// The JSON structure may vary depending on the API used.
-		// In the case of httpbin.org, it returns something like: {"origin": "x.x.x.x"}
-        
-		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseStr);
-		if (FJsonSerializer::Deserialize(Reader, JsonObject))
+		return;
+	}
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		OnIPAddressParsed(Discovery.ToSharedRef(), FString());
+		return;
+	}
+
+	// the answer is copied out, the response stays on the game thread
+	const TWeakObjectPtr<AHexConnection> WeakThis(this);
+	const TSharedRef<FPublicIPDiscovery> Running = Discovery.ToSharedRef();
+	AsyncTask(ENamedThreads::AnyThread, [WeakThis, Running, ResponseStr = Response->GetContentAsString()]()
+	{
+		const FString IP = ParsePublicIP(ResponseStr);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Running, IP]()
 		{
-			FString PublicIPAddress = JsonObject->GetStringField("origin");
-			MyIP = PublicIPAddress;
-			UE_LOG(LogTemp, Warning, TEXT("Public IP Address: %s"), *PublicIPAddress);
-		}
-		else
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnIPAddressParsed(Running, IP);
+			}
+		});
+	});
+}
+
+void AHexConnection::OnIPAddressParsed(const TSharedRef<FPublicIPDiscovery>& Parsed, const FString& IP)
+{
+	// a late answer of a discovery that already finished
+	if (Discovery.Get() != &Parsed.Get())
+	{
+		return;
+	}
+	Parsed->Outstanding--;
+	if (IP.IsEmpty())
+	{
+		if (Parsed->Outstanding > 0)
 		{
-			UE_LOG(LogTemp, Error, TEXT("Failed to parse JSON response."));
+			return;
 		}
+		UE_LOG(LogTemp, Error, TEXT("Failed to retrieve public IP address."));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to retrieve public IP address."));
+		MyIP = IP;
+		CachedPublicIP = IP;
+		CachedPublicIPTime = FPlatformTime::Seconds();
+		UE_LOG(LogTemp, Log, TEXT("Public IP Address: %s"), *IP);
 	}
+
+	// the slower endpoints are no longer needed
+	Discovery.Reset();
+	for (const TSharedRef<IHttpRequest>& Request : Parsed->Requests)
+	{
+		Request->OnProcessRequestComplete().Unbind();
+		if (!EHttpRequestStatus::IsFinished(Request->GetStatus()))
+		{
+			Request->CancelRequest();
+		}
+	}
+	OnPublicIPReady.Broadcast(IP);
 }
 
 FString AHexConnection::GetIP()
@@ -104,4 +343,375 @@ FString AHexConnection::RetrieveIpWithUTCKey(const FString& EncodedIp)
 	FString HexValue = EncodedIp.Right(8);
     
 	return HexToIp(HexValue, Key);
-}
\ No newline at end of file
+}
+
+bool AHexConnection::OpenMoveChannel(AChessGod* InChessGod, int32 LocalPort, const FString& PeerIp, int32 PeerPort, bool IsHost)
+{
+	CloseMoveChannel();
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (InChessGod == nullptr || SocketSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	Socket = SocketSubsystem->CreateSocket(NAME_DGram, TEXT("HexMoveChannel"), false);
+	if (Socket == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to create the move channel socket."));
+		return false;
+	}
+	const TSharedRef<FInternetAddr> LocalAddress = SocketSubsystem->CreateInternetAddr();
+	LocalAddress->SetAnyAddress();
+	LocalAddress->SetPort(LocalPort);
+	Socket->SetNonBlocking(true);
+	Socket->SetReuseAddr(true);
+	if (!Socket->Bind(*LocalAddress))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to bind the move channel to port %d."), LocalPort);
+		CloseMoveChannel();
+		return false;
+	}
+
+	if (!PeerIp.IsEmpty())
+	{
+		bool IsValidIp = false;
+		PeerAddress = SocketSubsystem->CreateInternetAddr();
+		PeerAddress->SetIp(*PeerIp, IsValidIp);
+		PeerAddress->SetPort(PeerPort);
+		if (!IsValidIp)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Invalid move channel peer address %s."), *PeerIp);
+			CloseMoveChannel();
+			return false;
+		}
+	}
+
+	ChessGod = InChessGod;
+	IsChannelHost = IsHost;
+	IsPeerWhite = IsHost != IsHostWhite;
+	PlyBase = 0;
+	SentPly = GetPly();
+	IsLastMoveLocal = false;
+	PendingRemotePly = -1;
+	PeerAckedPly = SentPly;
+	HasPeerConnection = false;
+	LastPunchTime = 0.0;
+	PunchDeadline = FPlatformTime::Seconds() + PeerTimeoutSeconds;
+	SmoothedRttMs = 0.0f;
+	SinceChecksum = 0.0f;
+	return true;
+}
+
+bool AHexConnection::JoinRoom(AChessGod* InChessGod, const FString& PeerRoomCode, bool IsHost)
+{
+	const FString PeerIp = RetrieveIpWithUTCKey(PeerRoomCode);
+	if (!IsIPv4Address(PeerIp))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Invalid room code %s."), *PeerRoomCode);
+		return false;
+	}
+	return OpenMoveChannel(InChessGod, MoveChannelPort, PeerIp, MoveChannelPort, IsHost);
+}
+
+void AHexConnection::CloseMoveChannel()
+{
+	if (Socket != nullptr)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+	PeerAddress.Reset();
+	ChessGod.Reset();
+	HasPeerConnection = false;
+}
+
+int32 AHexConnection::GetPly() const
+{
+	return ChessGod.IsValid() ? PlyBase + ChessGod->GetPlayedMoveCount() : PlyBase;
+}
+
+void AHexConnection::SendNewMoves()
+{
+	const int32 Ply = GetPly();
+	// a move taken back; the checksums sort out which position is right
+	if (Ply < SentPly)
+	{
+		SentPly = Ply;
+		PendingRemotePly = -1;
+	}
+	for (; SentPly < Ply; SentPly++)
+	{
+		IsLastMoveLocal = SentPly != PendingRemotePly;
+		if (IsLastMoveLocal)
+		{
+			SendMove(SentPly);
+		}
+		else
+		{
+			// the position the peer's move reached here has to be the one it reached there
+			if (SentPly + 1 == Ply)
+			{
+				CheckRemoteHash();
+			}
+			PendingRemotePly = -1;
+		}
+	}
+}
+
+void AHexConnection::CheckRemoteHash()
+{
+	if (PendingRemoteHash == 0 || PendingRemoteHash == ChessGod->GetPosition()->hash)
+	{
+		return;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("Move channel position differs from the peer's at ply %d."), GetPly());
+	// the host's position wins; a peer's checksum of the same ply makes the host send it at once
+	if (IsChannelHost)
+	{
+		SendPosition();
+	}
+	else
+	{
+		SendChecksum();
+	}
+}
+
+bool AHexConnection::IsLegalRemoteMove(int32 From, int32 To) const
+{
+	const PackedBoard& Position = *ChessGod->GetPosition();
+	const Square Mover = Position.cells[From];
+	// the peer only ever moves its own color, and only on its own turn
+	if (Position.black_to_move == IsPeerWhite || !Mover.has_piece() || (Mover.get_piece_color() == Cell::PieceColor::black) != Position.black_to_move)
+	{
+		return false;
+	}
+	const TArray<FIntPoint>* Moves = ChessGod->FindMovesForCell(CellIndexToPosition(From));
+	return Moves != nullptr && Moves->Contains(CellIndexToPosition(To));
+}
+
+void AHexConnection::RejectRemoteMove(int32 Ply)
+{
+	UE_LOG(LogTemp, Warning, TEXT("Move channel peer sent an illegal move at ply %d."), Ply);
+	// the host's position wins, the peer is put back on it
+	if (IsChannelHost)
+	{
+		SendPosition();
+		return;
+	}
+	// the host itself played it, there is no position to go back to
+	CloseMoveChannel();
+	OnPeerConnectionChanged.Broadcast(false);
+}
+
+void AHexConnection::SendMove(int32 Ply)
+{
+	const TArray<uint8> Record = ChessGod->GetMoveRecord();
+	const int32 Offset = (Ply - PlyBase) * 2;
+	if (Offset < 0 || Offset + 1 >= Record.Num())
+	{
+		return;
+	}
+	uint8 Packet[MovePacketSize];
+	WriteHeader(Packet, EMovePacket::Move, Ply);
+	Packet[HeaderSize] = Record[Offset];
+	Packet[HeaderSize + 1] = Record[Offset + 1];
+	// only the position after the last move is at hand, an older move leaves the check to the periodic checksum
+	WriteHash(Packet + HeaderSize + 2, Ply + 1 == GetPly() ? ChessGod->GetPosition()->hash : 0);
+	SendPacket(Packet, MovePacketSize);
+	LastMoveSendTime = FPlatformTime::Seconds();
+}
+
+void AHexConnection::SendChecksum()
+{
+	uint8 Packet[ChecksumPacketSize];
+	WriteHeader(Packet, EMovePacket::Checksum, GetPly());
+	WriteHash(Packet + HeaderSize, ChessGod->GetPosition()->hash);
+	SendPacket(Packet, ChecksumPacketSize);
+}
+
+void AHexConnection::SendPosition()
+{
+	const PackedBoard& Position = *ChessGod->GetPosition();
+	EncodedPosition Encoded;
+	PositionCodec::encode(Position, Encoded);
+	uint8 Packet[PositionPacketSize];
+	WriteHeader(Packet, EMovePacket::Position, GetPly());
+	FMemory::Memcpy(Packet + HeaderSize, Encoded.bytes, EncodedPosition::size);
+	Packet[PositionPacketSize - 1] = static_cast<uint8>(Position.shadow_cell);
+	SendPacket(Packet, PositionPacketSize);
+}
+
+void AHexConnection::SendPing()
+{
+	uint8 Packet[PingPacketSize];
+	WriteHeader(Packet, EMovePacket::Ping, 0);
+	const uint32 ClockMs = GetClockMs();
+	FMemory::Memcpy(Packet + HeaderSize, &ClockMs, sizeof(ClockMs));
+	SendPacket(Packet, PingPacketSize);
+}
+
+void AHexConnection::SendControl(uint8 Type, int32 Ply)
+{
+	uint8 Packet[HeaderSize];
+	WriteHeader(Packet, static_cast<EMovePacket>(Type), Ply);
+	SendPacket(Packet, HeaderSize);
+}
+
+int32 AHexConnection::GetReceivedPly() const
+{
+	return PendingRemotePly != -1 ? FMath::Max(GetPly(), PendingRemotePly + 1) : GetPly();
+}
+
+double AHexConnection::GetRetransmitDelay() const
+{
+	return SmoothedRttMs > 0.0f ? FMath::Clamp(2.0 * SmoothedRttMs / 1000.0, 0.05, 1.0) : 0.25;
+}
+
+void AHexConnection::SendPacket(const uint8* Data, int32 Size)
+{
+	// the host learns its peer from the first packet it receives
+	if (!PeerAddress.IsValid())
+	{
+		return;
+	}
+	int32 BytesSent = 0;
+	Socket->SendTo(Data, Size, BytesSent, *PeerAddress);
+}
+
+void AHexConnection::ReceivePackets()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	uint32 PendingSize = 0;
+	while (Socket != nullptr && Socket->HasPendingData(PendingSize))
+	{
+		uint8 Buffer[PositionPacketSize];
+		int32 BytesRead = 0;
+		const TSharedRef<FInternetAddr> Sender = SocketSubsystem->CreateInternetAddr();
+		if (!Socket->RecvFrom(Buffer, sizeof(Buffer), BytesRead, *Sender))
+		{
+			break;
+		}
+		// a NAT may map the peer to another port than the one it was asked to use, the address alone has to match
+		if (PeerAddress.IsValid() && !(*Sender == *PeerAddress))
+		{
+			if (Sender->ToString(false) != PeerAddress->ToString(false))
+			{
+				continue;
+			}
+		}
+		PeerAddress = Sender;
+		HandlePacket(Buffer, BytesRead);
+	}
+}
+
+void AHexConnection::HandlePacket(const uint8* Data, int32 Size)
+{
+	if (Size < HeaderSize)
+	{
+		return;
+	}
+	const EMovePacket Type = static_cast<EMovePacket>(Data[0]);
+	const int32 Ply = Data[1] | (Data[2] << 8);
+
+	LastReceiveTime = FPlatformTime::Seconds();
+	if (!HasPeerConnection)
+	{
+		HasPeerConnection = true;
+		PunchDeadline = 0.0;
+		// the peer may still be punching, any packet lets it through
+		SendControl(static_cast<uint8>(EMovePacket::Punch), GetPly());
+		UE_LOG(LogTemp, Log, TEXT("Move channel peer connected."));
+		OnPeerConnectionChanged.Broadcast(true);
+	}
+
+	if (Type == EMovePacket::Move && Size == MovePacketSize)
+	{
+		// only the move of the ply the board is at; a duplicate is older, and a gap is found by the checksums
+		const int32 From = Data[HeaderSize];
+		const int32 To = Data[HeaderSize + 1];
+		const bool IsNextMove = Ply == GetPly() && PendingRemotePly == -1;
+		if (IsNextMove && From < PackedBoard::cell_count && To < PackedBoard::cell_count)
+		{
+			// MovePiece refuses an illegal move but not one out of turn; a move the peer may not play is rejected here, before it is acknowledged
+			if (!IsLegalRemoteMove(From, To))
+			{
+				RejectRemoteMove(Ply);
+				return;
+			}
+			PendingRemotePly = Ply;
+			PendingRemoteHash = ReadHash(Data + HeaderSize + 2);
+			OnRemoteMove.Broadcast(CellIndexToPosition(From), CellIndexToPosition(To));
+		}
+		SendControl(static_cast<uint8>(EMovePacket::Ack), GetReceivedPly());
+	}
+	else if (Type == EMovePacket::Ack && Size == HeaderSize)
+	{
+		PeerAckedPly = FMath::Max(PeerAckedPly, Ply);
+	}
+	else if (Type == EMovePacket::Ping && Size == PingPacketSize)
+	{
+		uint8 Packet[PingPacketSize];
+		FMemory::Memcpy(Packet, Data, PingPacketSize);
+		Packet[0] = static_cast<uint8>(EMovePacket::Pong);
+		SendPacket(Packet, PingPacketSize);
+	}
+	else if (Type == EMovePacket::Pong && Size == PingPacketSize)
+	{
+		uint32 SentMs = 0;
+		FMemory::Memcpy(&SentMs, Data + HeaderSize, sizeof(SentMs));
+		const float SampleMs = static_cast<float>(GetClockMs() - SentMs);
+		SmoothedRttMs = SmoothedRttMs > 0.0f ? SmoothedRttMs * 0.875f + SampleMs * 0.125f : SampleMs;
+	}
+	else if (Type == EMovePacket::Checksum && Size == ChecksumPacketSize)
+	{
+		HandleChecksum(Ply, ReadHash(Data + HeaderSize));
+	}
+	else if (Type == EMovePacket::Position && Size == PositionPacketSize && !IsChannelHost)
+	{
+		EncodedPosition Encoded;
+		FMemory::Memcpy(Encoded.bytes, Data + HeaderSize, EncodedPosition::size);
+		PackedBoard Decoded;
+		const int8 Shadow = static_cast<int8>(Data[PositionPacketSize - 1]);
+		// a shadow no jump could have left is refused with the rest of the position
+		if (!PositionCodec::decode(Encoded, Decoded) || !Board::is_valid_shadow(Decoded, Shadow))
+		{
+			return;
+		}
+		Decoded.set_shadow(Shadow);
+		ChessGod->SyncPosition(Decoded);
+		PlyBase = Ply;
+		SentPly = Ply;
+		PeerAckedPly = Ply;
+		IsLastMoveLocal = false;
+		PendingRemotePly = -1;
+		OnPositionResynced.Broadcast();
+	}
+}
+
+void AHexConnection::HandleChecksum(int32 PeerPly, uint64 PeerHash)
+{
+	const int32 Ply = GetPly();
+	if (PeerPly == Ply)
+	{
+		if (PeerHash != ChessGod->GetPosition()->hash && IsChannelHost)
+		{
+			SendPosition();
+		}
+		return;
+	}
+	// our last move, lost on the way or not played there yet
+	if (PeerPly == Ply - 1 && IsLastMoveLocal)
+	{
+		if (PeerAckedPly < Ply)
+		{
+			SendMove(Ply - 1);
+		}
+		return;
+	}
+	// further behind than one lost move, or on a line of its own
+	if (PeerPly < Ply && IsChannelHost)
+	{
+		SendPosition();
+	}
+}
@@ -5,6 +5,10 @@
 
 #include "HexConnection.generated.h"
 
+class AChessGod;
+class FInternetAddr;
+class FSocket;
+struct FPublicIPDiscovery;
 
 UCLASS()
 class AHexConnection : public AActor
@@ -14,6 +18,11 @@ class AHexConnection : public AActor
 
 public:
 
+	AHexConnection();
+
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION(BlueprintCallable)
 	FString GetIP();
 
@@ -29,15 +38,185 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "IP Conversion")
 	static FString HexToIp(const FString& HexValue, const FString& Key);
 
+	/*
+	 * Asks every PublicIPEndpoints address at once and keeps the first answer that holds an IPv4 address; the answers are parsed off the game thread.
+	 * The address is cached for PublicIPCacheSeconds across all connections, a request within that time answers at once.
+	 * Answered through OnPublicIPReady, with an empty address when every endpoint failed or timed out.
+	 */
 	UFUNCTION(BlueprintCallable)
 	void GetPublicIPAddress();
 
 	UFUNCTION(BlueprintCallable)
 	FString GetMyIP() { return MyIP; }
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPublicIPReady, const FString&, IP);
+
+	UPROPERTY(BlueprintAssignable)
+	FOnPublicIPReady OnPublicIPReady;
+
+	// queried in parallel; each may answer with plain text or a JSON object holding "origin" or "ip"
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IP Discovery")
+	TArray<FString> PublicIPEndpoints = { TEXT("https://api.ipify.org"), TEXT("https://checkip.amazonaws.com"), TEXT("https://icanhazip.com"), TEXT("https://httpbin.org/ip") };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IP Discovery")
+	float PublicIPTimeoutSeconds = 3.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IP Discovery")
+	float PublicIPCacheSeconds = 300.0f;
+
+	// move replication
+
+	/*
+	 * Opens a UDP channel on LocalPort that keeps InChessGod's board in step with the peer's.
+	 * Moves played on the board are sent as they happen, thirteen bytes each: the packet type, the ply, the two cell indices and
+	 * the Zobrist hash of the position the move leads to. The receiver compares it once it played the move, so a misapplied
+	 * move is caught at once. Every move is acknowledged and sent again after about two round trips until it is, and moves are only played in ply order.
+	 * A checksum of the position also goes out every ChecksumInterval seconds, for dropped moves; only when the hashes disagree does the host send its whole position.
+	 * The host may leave PeerIp empty, it answers whoever sends first.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Move Replication")
+	bool OpenMoveChannel(AChessGod* InChessGod, int32 LocalPort, const FString& PeerIp, int32 PeerPort, bool IsHost);
+
+	/*
+	 * OpenMoveChannel with the peer's room code from ConvertIpWithUTCKey; both sides listen and send on MoveChannelPort.
+	 * Until the peer's first packet arrives both sides keep sending to each other, which opens the way through both NATs.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Move Replication")
+	bool JoinRoom(AChessGod* InChessGod, const FString& PeerRoomCode, bool IsHost);
+
+	UFUNCTION(BlueprintCallable, Category = "Move Replication")
+	void CloseMoveChannel();
+
+	UFUNCTION(BlueprintCallable, Category = "Move Replication")
+	bool IsPeerConnected() const { return HasPeerConnection; }
+
+	/*
+	 * The smoothed round trip time to the peer from the heartbeat pings, 0 before the first answer.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Move Replication")
+	float GetPeerRttMs() const { return SmoothedRttMs; }
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Move Replication")
+	int32 MoveChannelPort = 7777;
+
+	// the host plays white when set and black otherwise, the peer the other color; read when the channel opens
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Move Replication")
+	bool IsHostWhite = true;
+
+	// the checksum and the round trip ping go out this often, and their answers keep the connection alive
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Move Replication")
+	float ChecksumInterval = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Move Replication")
+	float PunchInterval = 0.2f;
+
+	// how long punching goes on before the connection is given up, and how long the peer may stay silent once connected
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Move Replication")
+	float PeerTimeoutSeconds = 10.0f;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPeerConnectionChanged, bool, IsConnected);
+
+	/*
+	 * Raised when the peer's first packet arrives, and when it went silent or never answered; punching starts again after a loss.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnPeerConnectionChanged OnPeerConnectionChanged;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRemoteMove, FIntPoint, From, FIntPoint, To);
+
+	/*
+	 * The peer's move, to be played with the ChessGod's MovePiece like an AI move.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnRemoteMove OnRemoteMove;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnPositionResynced);
+
+	/*
+	 * The host's position replaced the board after the checksums disagreed; the piece actors have to be placed again.
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnPositionResynced OnPositionResynced;
 	
 private:
 	
 	void OnIPAddressResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful);
+
+	// back on the game thread with one endpoint's parsed answer, empty when it held no address
+	void OnIPAddressParsed(const TSharedRef<FPublicIPDiscovery>& Parsed, const FString& IP);
+
+	// the requests of the running discovery, null when none is running
+	TSharedPtr<FPublicIPDiscovery> Discovery;
+
+	// the plies played since the game started: the history of the board plus where it started after a resync
+	int32 GetPly() const;
+
+	// sends the board's moves played since the last call, except the peer's own
+	void SendNewMoves();
+
+	// the move that took the game from ply Ply to the next one, read back from the board's record
+	void SendMove(int32 Ply);
+	void SendChecksum();
+	void SendPosition();
+	void SendPing();
+	// a packet with nothing but its type and ply
+	void SendControl(uint8 Type, int32 Ply);
+	void SendPacket(const uint8* Data, int32 Size);
+
+	// the plies received so far, the peer's move that is still to be played included
+	int32 GetReceivedPly() const;
+
+	// how long an unacknowledged move waits before it is sent again, about twice the round trip
+	double GetRetransmitDelay() const;
+
+	void ReceivePackets();
+	void HandlePacket(const uint8* Data, int32 Size);
+	void HandleChecksum(int32 PeerPly, uint64 PeerHash);
+
+	// compares the position after the peer's move with the hash its packet carried, and starts a resync when they differ
+	void CheckRemoteHash();
+
+	// whether the peer's move is a legal move of the side to move on the board, and that side is the peer's
+	bool IsLegalRemoteMove(int32 From, int32 To) const;
+
+	// an illegal move is never played: the host resyncs the peer to its position, a peer drops a host that sent one
+	void RejectRemoteMove(int32 Ply);
 	
 	FString MyIP;
+
+	TWeakObjectPtr<AChessGod> ChessGod;
+	FSocket* Socket = nullptr;
+	TSharedPtr<FInternetAddr> PeerAddress;
+	bool IsChannelHost = false;
+
+	// the color the peer moves, fixed when the channel opens
+	bool IsPeerWhite = false;
+
+	// ply of the board's first history move; the host's position resets the history to its own ply
+	int32 PlyBase = 0;
+
+	// plies already sent or received, the moves after it are new
+	int32 SentPly = 0;
+
+	// whether the last move was played here rather than received
+	bool IsLastMoveLocal = false;
+
+	// the ply of the peer's move announced through OnRemoteMove and not played yet, -1 for none
+	int32 PendingRemotePly = -1;
+
+	// the hash the peer's move led to on its board, 0 when it did not send one
+	uint64 PendingRemoteHash = 0;
+
+	// plies the peer acknowledged; the last local move is sent again until it is covered
+	int32 PeerAckedPly = 0;
+	double LastMoveSendTime = 0.0;
+
+	bool HasPeerConnection = false;
+	double LastReceiveTime = 0.0;
+	double LastPunchTime = 0.0;
+	// when punching gives up, 0 once that was reported
+	double PunchDeadline = 0.0;
+
+	float SmoothedRttMs = 0.0f;
+	float SinceChecksum = 0.0f;
 };
\ No newline at end of file
@@ -8,8 +8,13 @@ UENUM(BlueprintType)
 enum class EAIType : uint8
 {
     Random,
+    // the move recorded games most often played in the position, an easy minimax search where they never were
     Copycat,
-    MinMax
+    MinMax,
+    // minmax with the young brothers wait split point search in place of lazy SMP
+    MinMaxSplitPoints,
+    // Monte Carlo tree search with random playouts, its strength follows the difficulty's iteration and time budgets
+    MonteCarlo
 };
 
 UENUM(BlueprintType)
@@ -18,4 +23,51 @@ enum class EAIDifficulty : uint8
     Easy,
     Medium,
     Hard
-};
\ No newline at end of file
+};
+
+UENUM(BlueprintType)
+enum class ESearchMode : uint8
+{
+    AlphaBeta,
+    PrincipalVariation
+};
+
+UENUM(BlueprintType)
+enum class EParallelSearch : uint8
+{
+    LazySMP,
+    YoungBrothersWait
+};
+
+// the order the AI search service starts queued searches in
+UENUM(BlueprintType)
+enum class EAISearchPriority : uint8
+{
+    // puzzles, analysis and hints nobody waits on; a waiting search of a higher priority takes their slot
+    Background,
+    Normal,
+    // a move a player is waiting for
+    Interactive
+};
+
+// how hard the minimax AI may work the device, from its temperature and battery
+UENUM(BlueprintType)
+enum class ESearchPowerMode : uint8
+{
+    // every search thread, at normal priority
+    Full,
+    // half the search threads, at background priority
+    Balanced,
+    // one background thread searching the difficulty's node budget, so it plays as strong as on the clock with every thread
+    Saver
+};
+
+// the OS priority of the AI thread pool's threads
+UENUM(BlueprintType)
+enum class EAIThreadPriority : uint8
+{
+    Lowest,
+    // below the game, render and task graph threads, so a search only gets the cores they leave idle
+    BelowNormal,
+    Normal
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "EvaluationCacheStats.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FEvaluationCacheStats
+{
+    GENERATED_BODY()
+
+    // leaf evaluations asked of the cache
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int64 Probes = 0;
+
+    // of those, the ones answered without evaluating
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int64 Hits = 0;
+
+    float GetHitRate() const
+    {
+        return Probes > 0 ? static_cast<float>(Hits) / Probes : 0.0f;
+    }
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "SearchLine.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FSearchLine
+{
+    GENERATED_BODY()
+
+    // the score of the line's first move, for the side the AI plays (a pawn is 100)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 Score = 0;
+
+    // the moves the search expects, two cells each like MakeAIMove returns them: from, then to
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FIntPoint> Moves;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "EvaluationCacheStats.h"
+
+#include "SearchProgress.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FSearchProgress
+{
+    GENERATED_BODY()
+
+    // the deepest fully searched depth
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 Depth = 0;
+
+    // the score of the best move at that depth, for the side the AI plays
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 Score = 0;
+
+    // nodes visited by all search threads so far
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int64 Nodes = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int64 NodesPerSecond = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float ElapsedSeconds = 0.0f;
+
+    // transposition table lookups of all search threads so far, and how many found the position
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int64 TableProbes = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int64 TableHits = 0;
+
+    // evaluation cache use of all search threads so far
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FEvaluationCacheStats EvaluationCache;
+};
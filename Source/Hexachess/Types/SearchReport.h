@@ -0,0 +1,30 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "SearchLine.h"
+#include "SearchProgress.h"
+
+#include "SearchReport.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FSearchReport
+{
+    GENERATED_BODY()
+
+    // one entry per finished depth, in order; ElapsedSeconds of each is the time to reach it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FSearchProgress> Depths;
+
+    // the move the search chose
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FIntPoint From = FIntPoint::ZeroValue;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FIntPoint To = FIntPoint::ZeroValue;
+
+    // the principal variation first, then the other lines MultiPV asked for, best first
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FSearchLine> Lines;
+};
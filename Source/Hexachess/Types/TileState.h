@@ -0,0 +1,15 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "TileState.generated.h"
+
+// written to the first custom data float of a tile instance, the tile material picks its look from it
+UENUM(BlueprintType)
+enum class ETileState : uint8
+{
+    None,
+    Highlighted,
+    Selected,
+    Attacked
+};
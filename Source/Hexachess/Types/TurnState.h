@@ -0,0 +1,34 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+#include "TurnState.generated.h"
+
+// where AHexaGameState's turn flow is
+UENUM(BlueprintType)
+enum class ETurnState : uint8
+{
+    // no game, or StartTurns was not called yet
+    Idle,
+    // a player's turn, waiting for SubmitMove
+    AwaitingPlayer,
+    // the AI's search is running
+    AIThinking,
+    // a move was played, waiting for FinishMoveAnimation while the next turn's moves are generated on a worker
+    Animating,
+    Paused,
+    GameOver
+};
+
+UENUM(BlueprintType)
+enum class EGameOutcome : uint8
+{
+    None,
+    WhiteWins,
+    BlackWins,
+    Stalemate,
+    // the same position, side to move included, for the third time
+    Repetition,
+    // AChessGod::FiftyMovePlies plies without a capture or pawn move
+    FiftyMoves
+};
@@ -0,0 +1,16 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// the rules, evaluation and search of the game without any UObject, so tools can use them without booting the engine
+public class HexachessEngine : ModuleRules
+{
+	public HexachessEngine(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		bLegacyPublicIncludePaths = false;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}
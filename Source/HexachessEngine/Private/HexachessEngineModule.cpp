@@ -0,0 +1,9 @@
+#include "Modules/ModuleManager.h"
+
+#include "Chess/HexTypes.h"
+
+LLM_DEFINE_TAG(HexachessEngine);
+LLM_DEFINE_TAG(HexachessAI);
+LLM_DEFINE_TAG(HexachessTT);
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, HexachessEngine);
@@ -0,0 +1,361 @@
+#include "Search/MctsSearch.h"
+
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/ScopeLock.h"
+
+#include "Chess/Evaluator.h"
+#include "Search/SearchWorkers.h"
+
+// results are summed in thousandths, a float sum would need a compare-exchange loop per node
+static constexpr int32 RewardScale = 1000;
+
+// how many iterations go by between two looks at the clock
+static constexpr int64 ClockInterval = 64;
+
+// a node no thread has claimed yet, one a thread is filling with children, and one whose side to move has no moves
+static constexpr int32 Unexpanded = -1;
+static constexpr int32 Expanding = -2;
+static constexpr int32 Terminal = -3;
+
+// one position of the tree; its children are ChildCount consecutive nodes of the pool
+struct FMctsNode
+{
+    // the move that leads here from the parent
+    Move NodeMove = Move(0, 0);
+    // written once, before FirstChild is published
+    int32 ChildCount = 0;
+    std::atomic<int32> FirstChild{Unexpanded};
+    // real visits plus the virtual losses of the threads whose playouts run below this node
+    std::atomic<int32> Visits{0};
+    // the results of the playouts through this node for the side that moved into it, in thousandths
+    std::atomic<int64> Reward{0};
+};
+
+// one iteration of a batch, waiting for its result to be backpropagated
+struct FMctsLeaf
+{
+    // where its nodes, root first, start in the worker's Paths
+    int32 PathStart = 0;
+    int32 PathLength = 0;
+    // white's result, once known; a playout that did not end the game waits for the batch's evaluation
+    float WhiteResult = 0.0f;
+    int32 PendingIndex = INDEX_NONE;
+};
+
+// everything one search thread writes to besides the shared tree
+struct FMctsWorker
+{
+    PackedBoard Board;
+    FRandomStream Random;
+    // the iterations of the current batch and the nodes they passed
+    TArray<FMctsLeaf> Leaves;
+    TArray<int32> Paths;
+    // the playout ends the batch's evaluation scores together, and their scores
+    TArray<PackedBoard> PendingBoards;
+    TArray<int32> PendingScores;
+    int64 Iterations = 0;
+};
+
+FMctsSearch::~FMctsSearch()
+{
+    FScopeLock Lock(&SearchLock);
+    delete[] Nodes;
+    delete RulesBoard;
+}
+
+FMctsResult FMctsSearch::Run(const FMctsRequest& Request, const std::atomic<bool>& IsCancelled)
+{
+    // one search at a time owns the tree
+    FScopeLock Lock(&SearchLock);
+    HEXACHESS_LLM_SCOPE(HexachessAI);
+    FMctsResult Result;
+    if (IsCancelled)
+    {
+        return Result;
+    }
+
+    Settings = Request.Settings;
+    const int32 Capacity = FMath::Max(static_cast<int32>(static_cast<int64>(Settings.TreeSizeMB) * 1024 * 1024 / sizeof(FMctsNode)), 1);
+    if (Capacity != NodeCapacity)
+    {
+        delete[] Nodes;
+        Nodes = new FMctsNode[Capacity];
+        NodeCapacity = Capacity;
+    }
+    if (RulesBoard == nullptr)
+    {
+        RulesBoard = new Board();
+    }
+    RunningEvaluator = Request.Evaluation.Get();
+    RunningCancel = &IsCancelled;
+    RootPosition = Request.Position;
+
+    // a fresh tree, the previous request's nodes are simply overwritten
+    FMctsNode& Root = Nodes[0];
+    Root.ChildCount = 0;
+    Root.FirstChild = Unexpanded;
+    Root.Visits = 0;
+    Root.Reward = 0;
+    NextNode = 1;
+
+    IterationsStarted = 0;
+    IterationLimit = Request.Iterations;
+    SearchDeadline = Request.TimeBudgetMs > 0 ? FPlatformTime::Seconds() + Request.TimeBudgetMs / 1000.0 : 0.0;
+    IsSearchStopped = false;
+
+    const int32 ThreadCount = FMath::Max(Request.ThreadCount, 1);
+    TArray<FMctsWorker> Workers;
+    Workers.SetNum(ThreadCount);
+    RunSearchWorkers(ThreadCount, Request.ThreadPool, false, [this, &Workers, &Request](int32 Index)
+    {
+        HEXACHESS_LLM_SCOPE(HexachessAI);
+        FMctsWorker& Worker = Workers[Index];
+        Worker.Random.Initialize(Request.Seed * 7919 + Index * 104729);
+        while (RunBatch(Worker))
+        {
+        }
+    });
+    RunningEvaluator = nullptr;
+    RunningCancel = nullptr;
+
+    if (IsCancelled)
+    {
+        return Result;
+    }
+
+    // the most visited move is the most trusted one, a high average over few visits may just be luck
+    const int32 FirstChild = Root.FirstChild.load();
+    int32 BestVisits = -1;
+    for (int32 i = 0; FirstChild >= 0 && i < Root.ChildCount; i++)
+    {
+        const FMctsNode& Child = Nodes[FirstChild + i];
+        const int32 Visits = Child.Visits.load();
+        if (Visits > BestVisits)
+        {
+            BestVisits = Visits;
+            const int32 Score = Visits > 0 ? static_cast<int32>(Child.Reward.load() / Visits) : 0;
+            Result.Move = MoveResult(PackedBoard::to_key(Child.NodeMove.from), PackedBoard::to_key(Child.NodeMove.to), Score);
+        }
+    }
+    Result.IsComplete = true;
+    for (const FMctsWorker& Worker : Workers)
+    {
+        Result.Iterations += Worker.Iterations;
+    }
+    Result.TreeNodes = FMath::Min(NextNode.load(), NodeCapacity);
+    return Result;
+}
+
+bool FMctsSearch::RunBatch(FMctsWorker& Worker)
+{
+    // the leaves of one batch keep their virtual losses until the batch is backpropagated, so they spread over the tree
+    Worker.Leaves.Reset();
+    Worker.Paths.Reset();
+    Worker.PendingBoards.Reset();
+    const int32 BatchSize = FMath::Max(Settings.LeafBatchSize, 1);
+    while (Worker.Leaves.Num() < BatchSize && StartIteration(Worker))
+    {
+    }
+    if (Worker.Leaves.Num() == 0)
+    {
+        return false;
+    }
+
+    // one call for every playout of the batch that needs the evaluation
+    Worker.PendingScores.SetNumUninitialized(Worker.PendingBoards.Num());
+    if (Worker.PendingBoards.Num() > 0)
+    {
+        if (RunningEvaluator != nullptr)
+        {
+            RunningEvaluator->evaluate_batch(*RulesBoard, Worker.PendingBoards.GetData(), Worker.PendingBoards.Num(), Worker.PendingScores.GetData());
+        }
+        else
+        {
+            for (int32 i = 0; i < Worker.PendingBoards.Num(); i++)
+            {
+                Worker.PendingScores[i] = RulesBoard->evaluate(Worker.PendingBoards[i]);
+            }
+        }
+    }
+
+    // backpropagation: the virtual losses become one real visit, each node takes the result of the side that moved into it
+    for (const FMctsLeaf& Leaf : Worker.Leaves)
+    {
+        const float WhiteResult = Leaf.PendingIndex != INDEX_NONE ? ScoreEvaluation(Worker.PendingScores[Leaf.PendingIndex]) : Leaf.WhiteResult;
+        const int64 WhiteReward = FMath::RoundToInt(WhiteResult * RewardScale);
+        bool IsWhiteMover = RootPosition.black_to_move;
+        for (int32 i = 0; i < Leaf.PathLength; i++)
+        {
+            FMctsNode& Node = Nodes[Worker.Paths[Leaf.PathStart + i]];
+            Node.Reward += IsWhiteMover ? WhiteReward : RewardScale - WhiteReward;
+            Node.Visits += 1 - Settings.VirtualLoss;
+            IsWhiteMover = !IsWhiteMover;
+        }
+    }
+    Worker.Iterations += Worker.Leaves.Num();
+    return true;
+}
+
+bool FMctsSearch::StartIteration(FMctsWorker& Worker)
+{
+    if (IsSearchStopped || RunningCancel->load())
+    {
+        return false;
+    }
+    const int64 Started = IterationsStarted.fetch_add(1);
+    if (IterationLimit > 0 && Started >= IterationLimit)
+    {
+        return false;
+    }
+    // the first iterations always run, so even a tiny budget expands the root
+    if (SearchDeadline > 0.0 && Started > 0 && Started % ClockInterval == 0 && FPlatformTime::Seconds() >= SearchDeadline)
+    {
+        IsSearchStopped = true;
+        return false;
+    }
+
+    // selection: follow the best bound down to a node without children, adding a virtual loss to every node passed
+    FMctsLeaf& Leaf = Worker.Leaves.AddDefaulted_GetRef();
+    Leaf.PathStart = Worker.Paths.Num();
+    Worker.Board = RootPosition;
+    int32 NodeIndex = 0;
+    Nodes[0].Visits += Settings.VirtualLoss;
+    Worker.Paths.Add(0);
+    int32 FirstChild = Nodes[0].FirstChild.load(std::memory_order_acquire);
+    while (FirstChild >= 0)
+    {
+        NodeIndex = SelectChild(Nodes[NodeIndex]);
+        FMctsNode& Child = Nodes[NodeIndex];
+        Child.Visits += Settings.VirtualLoss;
+        Worker.Paths.Add(NodeIndex);
+        Worker.Board.make_move(Child.NodeMove.from, Child.NodeMove.to);
+        FirstChild = Child.FirstChild.load(std::memory_order_acquire);
+    }
+
+    // expansion: a leaf gets its children once a playout has been through it, the root right away
+    const bool IsVisited = NodeIndex == 0 || Nodes[NodeIndex].Visits.load() > Settings.VirtualLoss;
+    if (FirstChild == Unexpanded && IsVisited && Expand(Worker, NodeIndex))
+    {
+        FirstChild = Nodes[NodeIndex].FirstChild.load(std::memory_order_acquire);
+        if (FirstChild >= 0)
+        {
+            NodeIndex = SelectChild(Nodes[NodeIndex]);
+            FMctsNode& Child = Nodes[NodeIndex];
+            Child.Visits += Settings.VirtualLoss;
+            Worker.Paths.Add(NodeIndex);
+            Worker.Board.make_move(Child.NodeMove.from, Child.NodeMove.to);
+        }
+    }
+    Leaf.PathLength = Worker.Paths.Num() - Leaf.PathStart;
+
+    // playout, unless the game is already over here; a playout that does not end the game waits for the evaluation
+    if (FirstChild == Terminal)
+    {
+        Leaf.WhiteResult = ScoreEnding(Worker.Board);
+    }
+    else if (!Playout(Worker, Leaf.WhiteResult))
+    {
+        Leaf.PendingIndex = Worker.PendingBoards.Add(Worker.Board);
+    }
+    return true;
+}
+
+int32 FMctsSearch::SelectChild(const FMctsNode& Parent) const
+{
+    const int32 FirstChild = Parent.FirstChild.load(std::memory_order_acquire);
+    const float LogParentVisits = FMath::Loge(static_cast<float>(FMath::Max(Parent.Visits.load(), 1)));
+    int32 BestChild = FirstChild;
+    float BestBound = -1.0f;
+    for (int32 i = 0; i < Parent.ChildCount; i++)
+    {
+        const FMctsNode& Child = Nodes[FirstChild + i];
+        const int32 Visits = Child.Visits.load(std::memory_order_relaxed);
+        // an unvisited move is tried before any visited one is tried again
+        if (Visits <= 0)
+        {
+            return FirstChild + i;
+        }
+        const float Average = static_cast<float>(Child.Reward.load(std::memory_order_relaxed)) / (Visits * RewardScale);
+        const float Bound = Average + Settings.Exploration * FMath::Sqrt(LogParentVisits / Visits);
+        if (Bound > BestBound)
+        {
+            BestBound = Bound;
+            BestChild = FirstChild + i;
+        }
+    }
+    return BestChild;
+}
+
+bool FMctsSearch::Expand(FMctsWorker& Worker, int32 NodeIndex)
+{
+    FMctsNode& Node = Nodes[NodeIndex];
+    int32 Expected = Unexpanded;
+    if (NextNode.load(std::memory_order_relaxed) >= NodeCapacity || !Node.FirstChild.compare_exchange_strong(Expected, Expanding))
+    {
+        return false;
+    }
+
+    PackedBoard& in_board = Worker.Board;
+    MoveList Moves;
+    RulesBoard->generate_legal_moves(in_board, in_board.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white, Moves);
+    if (Moves.empty())
+    {
+        Node.FirstChild.store(Terminal, std::memory_order_release);
+        return true;
+    }
+    const int32 FirstChild = NextNode.fetch_add(Moves.size());
+    if (FirstChild + Moves.size() > NodeCapacity)
+    {
+        // the pool ran out between the check and the claim; the node stays a leaf for good
+        Node.FirstChild.store(Unexpanded, std::memory_order_release);
+        return false;
+    }
+    for (int32 i = 0; i < Moves.size(); i++)
+    {
+        FMctsNode& Child = Nodes[FirstChild + i];
+        Child.NodeMove = Moves[i];
+        Child.ChildCount = 0;
+        Child.FirstChild.store(Unexpanded, std::memory_order_relaxed);
+        Child.Visits.store(0, std::memory_order_relaxed);
+        Child.Reward.store(0, std::memory_order_relaxed);
+    }
+    Node.ChildCount = Moves.size();
+    Node.FirstChild.store(FirstChild, std::memory_order_release);
+    return true;
+}
+
+bool FMctsSearch::Playout(FMctsWorker& Worker, float& OutWhiteResult)
+{
+    PackedBoard& in_board = Worker.Board;
+    MoveList Moves;
+    for (int32 Ply = 0; Ply < Settings.PlayoutDepth; Ply++)
+    {
+        RulesBoard->generate_legal_moves(in_board, in_board.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white, Moves);
+        if (Moves.empty())
+        {
+            OutWhiteResult = ScoreEnding(in_board);
+            return true;
+        }
+        const Move& Picked = Moves[Worker.Random.RandRange(0, Moves.size() - 1)];
+        in_board.make_move(Picked.from, Picked.to);
+    }
+    return false;
+}
+
+float FMctsSearch::ScoreEvaluation(int32 Score) const
+{
+    // the evaluation turned into white's expected result, the way Elo turns a rating difference into one
+    return 1.0f / (1.0f + FMath::Pow(10.0f, -static_cast<float>(Score) / FMath::Max(Settings.PlayoutScoreScale, 1)));
+}
+
+float FMctsSearch::ScoreEnding(PackedBoard& in_board) const
+{
+    const Cell::PieceColor Mover = in_board.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white;
+    const Cell::PieceColor Opponent = in_board.black_to_move ? Cell::PieceColor::white : Cell::PieceColor::black;
+    const int32 KingCell = in_board.get_king_cell(Mover);
+    const bool IsInCheck = KingCell >= 0 && RulesBoard->is_attacked(in_board, KingCell, Opponent);
+    // Glinski scores a stalemate 3/4 for the stalemating side
+    const float MoverResult = IsInCheck ? 0.0f : 0.25f;
+    return Mover == Cell::PieceColor::white ? MoverResult : 1.0f - MoverResult;
+}
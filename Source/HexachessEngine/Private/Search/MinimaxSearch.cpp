@@ -0,0 +1,1060 @@
+#include "Search/MinimaxSearch.h"
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+#include "Chess/EvaluationCache.h"
+#include "Chess/Evaluator.h"
+#include "Chess/MoveOrdering.h"
+#include "Chess/Nnue.h"
+#include "Chess/RepetitionHistory.h"
+#include "Chess/SearchArena.h"
+#include "Chess/TranspositionTable.h"
+#include "Search/SearchStats.h"
+#include "Search/SearchWorkers.h"
+#include "Search/Tablebase.h"
+
+// larger than any evaluation; a side left without moves scores minus it plus the plies from the root, so a nearer mate scores higher
+static constexpr int32 ScoreInfinity = 1000000;
+
+// a tablebase win, less the plies to it: above any evaluation, below a mate the search saw itself
+static constexpr int32 ScoreTablebaseWin = 100000;
+
+// mate and tablebase scores count plies from the root, the table keeps them counted from the node so a transposition at another ply reads them right
+static int32 ScoreToTable(const int32 Score, const int32 Ply)
+{
+    return Score >= ScoreTablebaseWin / 2 ? Score + Ply : Score <= -ScoreTablebaseWin / 2 ? Score - Ply : Score;
+}
+
+static int32 ScoreFromTable(const int32 Score, const int32 Ply)
+{
+    return Score >= ScoreTablebaseWin / 2 ? Score - Ply : Score <= -ScoreTablebaseWin / 2 ? Score + Ply : Score;
+}
+
+// the deadline of a search that is pondering, it is set for real once the ponder ends
+static constexpr double PonderDeadline = TNumericLimits<double>::Max();
+
+// a node whose younger siblings are open to other workers once its eldest child has been searched
+struct FSplitPoint
+{
+    // the split point the owner was itself searching under, cancelling it cancels this one too
+    FSplitPoint* Parent = nullptr;
+    // the node's position, a joining worker copies it to its own board
+    PackedBoard Board;
+    // the owner's path down to the node, the owner only pushes above its first HistorySize entries until the split point closes
+    const RepetitionHistory* History = nullptr;
+    int32 HistorySize = 0;
+    // the owner's ordered move list, it outlives the split point since the owner waits for its helpers
+    const MoveList* Moves = nullptr;
+    int32 Depth = 0;
+    int32 Ply = 0;
+    bool IsWhitePlayer = true;
+    // the siblings' reductions depend on it
+    bool IsInCheck = false;
+    int32 Beta = 0;
+    std::atomic<int32> NextMove{0};
+    std::atomic<int32> Alpha{0};
+    std::atomic<int32> Helpers{0};
+    // set on a beta cutoff, every worker below this node unwinds
+    std::atomic<bool> IsCancelled{false};
+    FCriticalSection ResultLock;
+    int32 BestScore = 0;
+    Move BestMove = Move(0, 0);
+};
+
+// everything one search thread writes to: its own board copy, move ordering tables, evaluation cache and node count
+struct FSearchWorker
+{
+    int32 Index = 0;
+    PackedBoard Board;
+    MoveOrdering Ordering;
+    EvaluationCache Evaluations;
+    // the positions on the way to the board's, the game's since its last irreversible move first
+    RepetitionHistory History;
+    // the move lists of the nodes on this worker's current path, one per ply
+    SearchArena Arena;
+    // the network's accumulators along the same path, when the request evaluates with one
+    NnueAccumulatorStack Accumulators;
+    // the last tablebase blocks this worker decompressed
+    FTablebaseCache TablebaseCache;
+    // what the evaluation cache was filled with, it is cleared when a request evaluates differently
+    TSharedPtr<const Evaluator, ESPMode::ThreadSafe> CachedEvaluation;
+    // only this worker writes them, the progress report reads all workers' counts
+    std::atomic<int64> Nodes{0};
+    std::atomic<int64> QuiescenceNodes{0};
+    std::atomic<int64> Cutoffs{0};
+    std::atomic<int64> TableProbes{0};
+    std::atomic<int64> TableHits{0};
+    // set when a lazy SMP helper runs out of time; helpers never stop the main worker
+    bool IsStopped = false;
+    // set while the reply to a null move is searched, two null moves in a row would prove nothing
+    bool IsAfterNullMove = false;
+    // the split point this worker is searching siblings of, null at the root
+    FSplitPoint* ActiveSplit = nullptr;
+    // multi-PV: root moves that already have a line, the root search leaves them out
+    TArray<Move> ExcludedRootMoves;
+    // the split points this worker owns, pushed and popped at the back by the owner and stolen from the front
+    FCriticalSection SplitLock;
+    TArray<FSplitPoint*> OpenSplits;
+};
+
+FMinimaxSearch::~FMinimaxSearch()
+{
+    FScopeLock Lock(&SearchLock);
+    delete Table;
+    delete RulesBoard;
+    for (FSearchWorker* Worker : Workers)
+    {
+        delete Worker;
+    }
+}
+
+void FMinimaxSearch::Clear()
+{
+    FScopeLock Lock(&SearchLock);
+    if (Table != nullptr)
+    {
+        Table->clear();
+    }
+    for (FSearchWorker* Worker : Workers)
+    {
+        Worker->Ordering.clear();
+        Worker->Evaluations.clear();
+    }
+}
+
+FMinimaxResult FMinimaxSearch::Run(const FMinimaxRequest& Request, const std::atomic<bool>& IsCancelled, const TFunction<void(const FMinimaxDepthReport&)>& OnDepth)
+{
+    // one search at a time owns the table and the workers; a cancelled one gives them up within a few thousand nodes
+    FScopeLock Lock(&SearchLock);
+    TRACE_CPUPROFILER_EVENT_SCOPE(HexachessAI_Search);
+    HEXACHESS_LLM_SCOPE(HexachessAI);
+    FMinimaxResult Result;
+    if (IsCancelled)
+    {
+        return Result;
+    }
+
+    // the buffers this request had to allocate; once the tables, workers and arenas are warm a search allocates none of its own
+    int64 Allocations = 0;
+    Settings = Request.Settings;
+    if (Table == nullptr)
+    {
+        HEXACHESS_LLM_SCOPE(HexachessTT);
+        Table = new TranspositionTable(Settings.TranspositionTableSizeMB);
+        Allocations++;
+    }
+    // the search only asks the board for rules and evaluation of packed positions, never for its own cells
+    if (RulesBoard == nullptr)
+    {
+        RulesBoard = new Board();
+        Allocations++;
+    }
+    Board* ActiveBoard = RulesBoard;
+
+    const bool IsWhiteAI = Request.IsWhiteAI;
+    const int32 MaxDepth = FMath::Max(Request.MaxDepth, 1);
+
+    // one worker per search thread, kept between moves so their history tables carry over
+    const int32 ThreadCount = FMath::Max(Request.ThreadCount, 1);
+    // every ply takes at most one move list: MaxDepth full-width plies, then the captures of the quiescence plies
+    const size_t ArenaBytes = (MaxDepth + FMath::Max(Settings.QuiescenceDepth, 0) + 2) * sizeof(MoveList);
+    while (Workers.Num() < ThreadCount)
+    {
+        Workers.Add(new FSearchWorker());
+        Allocations++;
+    }
+    while (Workers.Num() > ThreadCount)
+    {
+        delete Workers.Pop();
+    }
+    for (int32 Index = 0; Index < Workers.Num(); Index++)
+    {
+        FSearchWorker& Worker = *Workers[Index];
+        Worker.Index = Index;
+        Worker.Board = Request.Position;
+        Worker.History.load(Request.History.GetData(), Request.History.Num());
+        Worker.Nodes = 0;
+        Worker.QuiescenceNodes = 0;
+        Worker.Cutoffs = 0;
+        Worker.TableProbes = 0;
+        Worker.TableHits = 0;
+        Worker.IsStopped = false;
+        Worker.IsAfterNullMove = false;
+        Worker.ActiveSplit = nullptr;
+        Worker.ExcludedRootMoves.Reset();
+        Allocations += Worker.Arena.reserve(ArenaBytes) ? 1 : 0;
+        Worker.Ordering.age();
+        // cached scores stay valid between moves as long as the evaluation is the same
+        if (Worker.Evaluations.get_size_kb() != Settings.EvaluationCacheSizeKB)
+        {
+            Worker.Evaluations.resize(Settings.EvaluationCacheSizeKB);
+            Allocations++;
+        }
+        else if (Worker.CachedEvaluation != Request.Evaluation)
+        {
+            Worker.Evaluations.clear();
+        }
+        Worker.Evaluations.reset_counters();
+        Worker.CachedEvaluation = Request.Evaluation;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    TimeBudgetSeconds = Request.TimeBudgetMs / 1000.0;
+    RunningPonder = Request.IsPondering;
+    NodeBudget = FMath::Max<int64>(Request.NodeBudget, 0);
+    // a node budget alone runs without a clock, the deadline that only pondering ends is never reached without pondering
+    const bool HasClock = Request.TimeBudgetMs > 0 || NodeBudget == 0;
+    SearchDeadline = RunningPonder != nullptr || !HasClock ? PonderDeadline : StartTime + TimeBudgetSeconds;
+    IsSearchAborted = false;
+    CanAbortSearch = false;
+    UseSplitPoints = Request.UseSplitPoints;
+    FiftyMovePlies = FMath::Max(Request.FiftyMovePlies, 0);
+    RunningCancel = &IsCancelled;
+    RunningEvaluator = Request.Evaluation.Get();
+    RunningTablebase = Request.Tablebase.Get();
+    RunningNetwork = RunningEvaluator != nullptr ? RunningEvaluator->get_network() : nullptr;
+    if (RunningNetwork != nullptr)
+    {
+        for (FSearchWorker* Worker : Workers)
+        {
+            Allocations += Worker->Accumulators.reserve(MaxDepth + FMath::Max(Settings.QuiescenceDepth, 0) + 2) ? 1 : 0;
+            Worker->Accumulators.reset(*RunningNetwork, Worker->Board);
+        }
+    }
+
+    // a known ending needs no search at all
+    if (RunningTablebase != nullptr && FindTablebaseMove(ActiveBoard, *Workers[0], IsWhiteAI, Result.Move))
+    {
+        RunningCancel = nullptr;
+        RunningEvaluator = nullptr;
+        RunningNetwork = nullptr;
+        RunningTablebase = nullptr;
+        RunningPonder = nullptr;
+        Result.IsComplete = true;
+        FMinimaxLine& Line = Result.Lines.AddDefaulted_GetRef();
+        Line.Score = Result.Move.Score;
+        Line.Moves.Add(Result.Move);
+        return Result;
+    }
+
+    // lazy SMP: every worker runs its own iterative deepening on the shared transposition table,
+    // the helpers mostly fill it with results the main worker then picks up; only the main worker's move is played
+    // young brothers wait: only the main worker deepens, the helpers join its split points until it is done
+    MoveResult ai_result;
+    TArray<MoveResult> ai_lines;
+    int32 ai_depth = 0;
+    RunSearchWorkers(Workers.Num(), Request.ThreadPool, Request.UseBackgroundThreads, [this, ActiveBoard, IsWhiteAI, MaxDepth, StartTime, Allocations, &IsCancelled, &OnDepth, &ai_result, &ai_lines, &ai_depth](int32 Index)
+    {
+        // the scope is per thread, the helpers need their own
+        HEXACHESS_LLM_SCOPE(HexachessAI);
+        FSearchWorker& Worker = *Workers[Index];
+        const bool IsMainWorker = Index == 0;
+        if (!IsMainWorker && UseSplitPoints)
+        {
+            // index 0 always runs on the calling thread, so the main worker is always running
+            HelpSplitPoints(ActiveBoard, Worker);
+            return;
+        }
+        MoveResult worker_result;
+        // odd helpers start one ply deeper so the threads do not all search the same depth at the same time
+        for (int32 Depth = 1 + (IsMainWorker ? 0 : Index % 2); Depth <= MaxDepth; Depth++)
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE(HexachessAI_SearchDepth);
+            MoveResult depth_result = SearchRoot(ActiveBoard, Worker, Depth, IsWhiteAI, worker_result.Score);
+            if (IsSearchAborted || Worker.IsStopped || IsCancelled)
+            {
+                break;
+            }
+            if (!IsMainWorker)
+            {
+                worker_result = depth_result;
+                continue;
+            }
+
+            // a depth counts once all of its lines are in, otherwise the previous depth's move and lines stand
+            TArray<MoveResult> depth_lines;
+            depth_lines.Add(depth_result);
+            if (!SearchOtherLines(ActiveBoard, Worker, Depth, IsWhiteAI, depth_lines))
+            {
+                break;
+            }
+            worker_result = depth_result;
+            ai_lines = MoveTemp(depth_lines);
+            ai_depth = Depth;
+
+            FMinimaxDepthReport Report;
+            Report.Depth = Depth;
+            Report.Score = worker_result.Score;
+            Report.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+            Report.Allocations = Allocations;
+            for (const FSearchWorker* Other : Workers)
+            {
+                Report.Nodes += Other->Nodes.load(std::memory_order_relaxed);
+                Report.QuiescenceNodes += Other->QuiescenceNodes.load(std::memory_order_relaxed);
+                Report.Cutoffs += Other->Cutoffs.load(std::memory_order_relaxed);
+                Report.TableProbes += Other->TableProbes.load(std::memory_order_relaxed);
+                Report.TableHits += Other->TableHits.load(std::memory_order_relaxed);
+                Report.EvaluationProbes += Other->Evaluations.get_probes();
+                Report.EvaluationHits += Other->Evaluations.get_hits();
+            }
+            SetSearchStats(Report);
+            if (OnDepth)
+            {
+                OnDepth(Report);
+            }
+
+            // depth 1 always completes so there is a move to play even with a tiny budget
+            CanAbortSearch = true;
+            if (IsPastDeadline() || IsOverNodeBudget(Worker))
+            {
+                break;
+            }
+        }
+        if (IsMainWorker)
+        {
+            ai_result = worker_result;
+            // the main worker is done, the helpers have nothing left to contribute
+            IsSearchAborted = true;
+        }
+    });
+    RunningCancel = nullptr;
+    RunningEvaluator = nullptr;
+    RunningNetwork = nullptr;
+    RunningTablebase = nullptr;
+    RunningPonder = nullptr;
+
+    if (IsCancelled)
+    {
+        return Result;
+    }
+
+    Result.IsComplete = true;
+    Result.Move = ai_result;
+    Result.PonderMove = FindPonderMove(ActiveBoard, Request.Position, ai_result);
+    for (const MoveResult& Root : ai_lines)
+    {
+        FMinimaxLine& Line = Result.Lines.AddDefaulted_GetRef();
+        Line.Score = Root.Score;
+        ExtractLine(ActiveBoard, Request.Position, Root, ai_depth, Line.Moves);
+    }
+    for (const FSearchWorker* Worker : Workers)
+    {
+        Result.EvaluationProbes += Worker->Evaluations.get_probes();
+        Result.EvaluationHits += Worker->Evaluations.get_hits();
+    }
+    return Result;
+}
+
+MoveList& FMinimaxSearch::AllocateMoveList(FSearchWorker& Worker)
+{
+    MoveList* Moves = Worker.Arena.allocate<MoveList>();
+    // Run sizes the arena for the deepest path the request can reach
+    check(Moves != nullptr);
+    return *Moves;
+}
+
+bool FMinimaxSearch::FindTablebaseMove(Board* ActiveBoard, FSearchWorker& Worker, const bool IsWhitePlayer, MoveResult& OutMove) const
+{
+    PackedBoard& in_board = Worker.Board;
+    if (in_board.piece_count[0] + in_board.piece_count[1] > RunningTablebase->GetMaxPieces())
+    {
+        return false;
+    }
+
+    const SearchArenaScope Scratch(Worker.Arena);
+    MoveList& Moves = AllocateMoveList(Worker);
+    ActiveBoard->generate_legal_moves(in_board, IsWhitePlayer ? Cell::PieceColor::white : Cell::PieceColor::black, Moves);
+    bool IsFound = false;
+    for (const Move& move : Moves)
+    {
+        // the reply's result for the opponent, turned into this side's score with the plies to mate counted from here
+        const UndoRecord Undo = in_board.make_move(move.from, move.to);
+        FTablebaseProbe Probe;
+        const bool IsKnown = RunningTablebase->ProbeDtm(in_board, Worker.TablebaseCache, Probe);
+        in_board.unmake_move(Undo);
+        if (!IsKnown)
+        {
+            return false;
+        }
+        const int32 Plies = Probe.PliesToMate + 1;
+        const int32 Score = Probe.Wdl == ETablebaseWdl::Loss ? ScoreTablebaseWin - Plies : Probe.Wdl == ETablebaseWdl::Win ? Plies - ScoreTablebaseWin : 0;
+        if (!IsFound || Score > OutMove.Score)
+        {
+            OutMove = MoveResult(PackedBoard::to_key(move.from), PackedBoard::to_key(move.to), Score);
+            IsFound = true;
+        }
+    }
+    return IsFound;
+}
+
+MoveResult FMinimaxSearch::NegaMax(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, int32 Alpha, int32 Beta, int32 Ply)
+{
+    PackedBoard& in_board = Worker.Board;
+    // a position that occurred before, or one the fifty-move rule ends, is a draw whatever its moves are; the root still needs a move
+    if (Ply > 0 && (Worker.History.is_repetition(in_board.hash) || (FiftyMovePlies > 0 && Worker.History.get_reversible_plies() >= FiftyMovePlies)))
+    {
+        return MoveResult(0, 0, 0);
+    }
+
+    // the root still needs a move, below it a tablebase position is worth exactly what the table says
+    if (Ply > 0 && RunningTablebase != nullptr && in_board.piece_count[0] + in_board.piece_count[1] <= RunningTablebase->GetMaxPieces())
+    {
+        FTablebaseProbe Probe;
+        if (RunningTablebase->ProbeWdl(in_board, Worker.TablebaseCache, Probe))
+        {
+            const int32 Score = Probe.Wdl == ETablebaseWdl::Win ? ScoreTablebaseWin - Ply : Probe.Wdl == ETablebaseWdl::Loss ? Ply - ScoreTablebaseWin : 0;
+            return MoveResult(0, 0, Score);
+        }
+    }
+
+    if (Depth == 0)
+    {
+        if (Settings.UseQuiescence)
+        {
+            return MoveResult(0, 0, Quiesce(ActiveBoard, Worker, Settings.QuiescenceDepth, IsWhitePlayer, Alpha, Beta, Ply));
+        }
+        // evaluate scores for white, negamax wants the score of the side to move
+        const int32 Score = Evaluate(ActiveBoard, Worker);
+        return MoveResult(0, 0, IsWhitePlayer ? Score : -Score);
+    }
+
+    if (ShouldStopSearch(Worker))
+    {
+        return MoveResult();
+    }
+
+    // transposition table: reuse a deep enough result, otherwise at least try its best move first
+    // a root with moves left out is not the position the table knows, it is neither cut off nor stored
+    const bool IsExcludingMoves = Ply == 0 && Worker.ExcludedRootMoves.Num() > 0;
+    const uint64 Hash = ActiveBoard->position_hash(in_board);
+    TTEntry Entry;
+    Move HashMove(0, 0);
+    bool IsTableHit = false;
+    if (Table != nullptr)
+    {
+        HEXACHESS_TRACE_SCOPE(HexachessAI_ProbeTable);
+        Worker.TableProbes.store(Worker.TableProbes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        IsTableHit = Table->probe(Hash, Entry);
+        if (IsTableHit)
+        {
+            Worker.TableHits.store(Worker.TableHits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+    if (IsTableHit && Entry.has_best_move())
+    {
+        if (Entry.depth >= Depth && !IsExcludingMoves)
+        {
+            const int32 StoredScore = ScoreFromTable(Entry.score, Ply);
+            const MoveResult Stored(PackedBoard::to_key(Entry.best_move.from), PackedBoard::to_key(Entry.best_move.to), StoredScore);
+            if (Entry.bound == TTBound::exact)
+            {
+                return Stored;
+            }
+            if (Entry.bound == TTBound::lower)
+            {
+                Alpha = FMath::Max(Alpha, StoredScore);
+            }
+            else if (Entry.bound == TTBound::upper)
+            {
+                Beta = FMath::Min(Beta, StoredScore);
+            }
+            if (Beta <= Alpha)
+            {
+                return Stored;
+            }
+        }
+        HashMove = Entry.best_move;
+    }
+    const int32 WindowAlpha = Alpha;
+    const int32 WindowBeta = Beta;
+
+    const Cell::PieceColor Mover = IsWhitePlayer ? Cell::PieceColor::white : Cell::PieceColor::black;
+    const Cell::PieceColor Opponent = IsWhitePlayer ? Cell::PieceColor::black : Cell::PieceColor::white;
+    const int32 KingCell = in_board.get_king_cell(Mover);
+    const bool IsInCheck = KingCell >= 0 && ActiveBoard->is_attacked(in_board, KingCell, Opponent);
+
+    // null move: if passing still leaves the opponent unable to get below beta, a real move would do at least as well
+    // not in check, where passing is illegal, and not with only king and pawns left, where every move may be a worse one (zugzwang)
+    const bool IsAfterNullMove = Worker.IsAfterNullMove;
+    Worker.IsAfterNullMove = false;
+    const int32 Side = PackedBoard::side_of(Mover);
+    const bool HasPieces = in_board.type_count[Side][Cell::PieceType::knight] + in_board.type_count[Side][Cell::PieceType::bishop]
+        + in_board.type_count[Side][Cell::PieceType::rook] + in_board.type_count[Side][Cell::PieceType::queen] > 0;
+    if (Settings.UseNullMove && Ply > 0 && !IsAfterNullMove && !IsInCheck && HasPieces && Depth > Settings.NullMoveReduction
+        && FMath::Abs(Beta) < ScoreTablebaseWin / 2 && IsNullMoveCutoff(ActiveBoard, Worker, Depth, IsWhitePlayer, Beta, Ply))
+    {
+        return MoveResult(0, 0, Beta);
+    }
+    if (IsUnwinding(Worker))
+    {
+        return MoveResult();
+    }
+
+    // one list for the whole side, so the ordering can put the best candidates of any piece first
+    // it comes from the worker's arena and goes back when the node returns; a split point's helpers read it until then
+    const SearchArenaScope Scratch(Worker.Arena);
+    MoveList& Moves = AllocateMoveList(Worker);
+    ActiveBoard->generate_legal_moves(in_board, Mover, Moves);
+    if (IsExcludingMoves)
+    {
+        int32 Kept = 0;
+        for (const Move& move : Moves)
+        {
+            if (!Worker.ExcludedRootMoves.ContainsByPredicate([&move](const Move& Excluded) { return Excluded.from == move.from && Excluded.to == move.to; }))
+            {
+                Moves[Kept++] = move;
+            }
+        }
+        Moves.count = Kept;
+    }
+    Worker.Ordering.order_moves(in_board, Moves, HashMove, Ply);
+
+    // fail-soft: the returned score may lie outside the window, which gives the table tighter bounds
+    // with no legal move the side is mated here, any move's score is above it
+    MoveResult Result;
+    Result.Score = -ScoreInfinity + Ply;
+    Move BestMove(0, 0);
+    for (int32 i = 0; i < Moves.size(); i++)
+    {
+        const Move& move = Moves[i];
+        const int32 Reduction = GetLateMoveReduction(Worker, move, i, Depth, Ply, IsInCheck);
+        const int32 Score = SearchChild(ActiveBoard, Worker, move, i == 0, Reduction, Depth, IsWhitePlayer, Alpha, Beta, Ply);
+        if (IsUnwinding(Worker))
+        {
+            return Result;
+        }
+
+        if (Score > Result.Score)
+        {
+            Result.Score = Score;
+            Result.FromKey = PackedBoard::to_key(move.from);
+            Result.ToKey = PackedBoard::to_key(move.to);
+            BestMove = move;
+        }
+        Alpha = FMath::Max(Alpha, Score);
+
+        // pruning: the opponent already has a better line elsewhere, none of the remaining moves matter
+        if (Alpha >= Beta)
+        {
+            Worker.Ordering.record_cutoff(in_board, move, Depth, Ply);
+            Worker.Cutoffs.store(Worker.Cutoffs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            break;
+        }
+
+        // young brothers wait: the eldest child set the window, its younger siblings may now be searched in parallel
+        if (i == 0 && CanSplit(Depth, Moves.size()))
+        {
+            SearchSplitPoint(ActiveBoard, Worker, Moves, Depth, IsWhitePlayer, IsInCheck, Alpha, Beta, Ply, Result, BestMove);
+            if (IsUnwinding(Worker))
+            {
+                return Result;
+            }
+            break;
+        }
+    }
+
+    if (Table != nullptr && !IsExcludingMoves)
+    {
+        const TTBound Bound = Result.Score <= WindowAlpha ? TTBound::upper : Result.Score >= WindowBeta ? TTBound::lower : TTBound::exact;
+        Table->store(Hash, Depth, Bound, ScoreToTable(Result.Score, Ply), BestMove);
+    }
+
+    return Result;
+}
+
+int32 FMinimaxSearch::Quiesce(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, int32 Alpha, int32 Beta, int32 Ply)
+{
+    PackedBoard& in_board = Worker.Board;
+    if (ShouldStopSearch(Worker))
+    {
+        return 0;
+    }
+    Worker.QuiescenceNodes.store(Worker.QuiescenceNodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // stand pat: the side to move is never forced to capture, so the static score is already a lower bound
+    const int32 Evaluation = Evaluate(ActiveBoard, Worker);
+    const int32 StandPat = IsWhitePlayer ? Evaluation : -Evaluation;
+    if (StandPat >= Beta || Depth <= 0)
+    {
+        return StandPat;
+    }
+    Alpha = FMath::Max(Alpha, StandPat);
+
+    const SearchArenaScope Scratch(Worker.Arena);
+    MoveList& Captures = AllocateMoveList(Worker);
+    ActiveBoard->generate_legal_captures(in_board, IsWhitePlayer ? Cell::PieceColor::white : Cell::PieceColor::black, Captures);
+    Worker.Ordering.order_moves(in_board, Captures, Move(0, 0), Ply);
+
+    int32 BestScore = StandPat;
+    for (const Move& move : Captures)
+    {
+        // delta pruning: even winning the captured piece for free cannot lift the score to alpha
+        const Cell::PieceType Victim = (move.flags & Move::Flags::en_passant) != 0 ? Cell::PieceType::pawn : in_board.cells[move.to].get_piece_type();
+        if (StandPat + Worker.Ordering.get_piece_value(Victim) + Settings.QuiescenceDeltaMargin <= Alpha)
+        {
+            continue;
+        }
+        // a capture that loses material once the other side takes back cannot raise the stand pat score
+        if (Settings.UseExchangePruning && Worker.Ordering.is_losing_capture(in_board, move))
+        {
+            continue;
+        }
+
+        UndoRecord undo = in_board.make_move(move.from, move.to);
+        PushAccumulator(Worker, undo);
+        const int32 Score = -Quiesce(ActiveBoard, Worker, Depth - 1, !IsWhitePlayer, -Beta, -Alpha, Ply + 1);
+        PopAccumulator(Worker);
+        in_board.unmake_move(undo);
+        if (IsUnwinding(Worker))
+        {
+            return BestScore;
+        }
+
+        BestScore = FMath::Max(BestScore, Score);
+        Alpha = FMath::Max(Alpha, Score);
+        if (Alpha >= Beta)
+        {
+            Worker.Cutoffs.store(Worker.Cutoffs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    return BestScore;
+}
+
+MoveResult FMinimaxSearch::SearchRoot(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, int32 PreviousScore)
+{
+    if (!Settings.UsePrincipalVariation || Depth == 1 || Settings.AspirationWindow <= 0)
+    {
+        return NegaMax(ActiveBoard, Worker, Depth, IsWhitePlayer, -ScoreInfinity, ScoreInfinity);
+    }
+
+    // aspiration window: expect the score near the previous iteration's, widen the failing side until it fits
+    int32 LowerMargin = Settings.AspirationWindow;
+    int32 UpperMargin = Settings.AspirationWindow;
+    while (true)
+    {
+        const int32 Alpha = FMath::Max(PreviousScore - LowerMargin, -ScoreInfinity);
+        const int32 Beta = FMath::Min(PreviousScore + UpperMargin, ScoreInfinity);
+        MoveResult Result = NegaMax(ActiveBoard, Worker, Depth, IsWhitePlayer, Alpha, Beta);
+        if (IsUnwinding(Worker))
+        {
+            return Result;
+        }
+        if (Result.Score <= Alpha && Alpha > -ScoreInfinity)
+        {
+            LowerMargin *= 4;
+        }
+        else if (Result.Score >= Beta && Beta < ScoreInfinity)
+        {
+            UpperMargin *= 4;
+        }
+        else
+        {
+            return Result;
+        }
+    }
+}
+
+bool FMinimaxSearch::SearchOtherLines(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, TArray<MoveResult>& Lines)
+{
+    bool IsComplete = true;
+    while (Lines.Num() < Settings.MultiPV)
+    {
+        const MoveResult& Previous = Lines.Last();
+        Worker.ExcludedRootMoves.Add(Move(PackedBoard::to_index(Previous.FromKey), PackedBoard::to_index(Previous.ToKey)));
+        // a full window, the lines are compared by their exact scores
+        const MoveResult Line = NegaMax(ActiveBoard, Worker, Depth, IsWhitePlayer, -ScoreInfinity, ScoreInfinity);
+        if (IsUnwinding(Worker))
+        {
+            IsComplete = false;
+            break;
+        }
+        // every root move has its line
+        if (Line.FromKey == Line.ToKey)
+        {
+            break;
+        }
+        Lines.Add(Line);
+    }
+    Worker.ExcludedRootMoves.Reset();
+    return IsComplete;
+}
+
+int32 FMinimaxSearch::SearchChild(Board* ActiveBoard, FSearchWorker& Worker, const Move& move, bool IsEldest, int32 Reduction, int32 Depth, bool IsWhitePlayer, int32 Alpha, int32 Beta, int32 Ply)
+{
+    PackedBoard& in_board = Worker.Board;
+    const uint64 HashBefore = in_board.hash;
+    UndoRecord undo = in_board.make_move(move.from, move.to);
+    PushAccumulator(Worker, undo);
+    Worker.History.push(HashBefore, undo.captured.has_piece() || undo.moved.get_piece_type() == Cell::PieceType::pawn);
+    int32 Score = 0;
+    bool IsSearched = false;
+    // late move reduction: a shallower null window search first, a move that still beats alpha gets the full depth after all
+    // a move that gives check is never reduced, the reply is forced and often the point of the move
+    if (Reduction > 0)
+    {
+        const Cell::PieceColor Opponent = IsWhitePlayer ? Cell::PieceColor::black : Cell::PieceColor::white;
+        const int32 KingCell = in_board.get_king_cell(Opponent);
+        if (KingCell < 0 || !ActiveBoard->is_attacked(in_board, KingCell, IsWhitePlayer ? Cell::PieceColor::white : Cell::PieceColor::black))
+        {
+            Score = -NegaMax(ActiveBoard, Worker, Depth - 1 - Reduction, !IsWhitePlayer, -Alpha - 1, -Alpha, Ply + 1).Score;
+            IsSearched = Score <= Alpha || IsUnwinding(Worker);
+        }
+    }
+    // the reduced search may already have shown the move is no better than alpha
+    if (!IsSearched && (!Settings.UsePrincipalVariation || IsEldest))
+    {
+        Score = -NegaMax(ActiveBoard, Worker, Depth - 1, !IsWhitePlayer, -Beta, -Alpha, Ply + 1).Score;
+    }
+    else if (!IsSearched)
+    {
+        // principal variation search: prove the move is no better than the first one with a null window,
+        // and only search it properly if that proof fails
+        Score = -NegaMax(ActiveBoard, Worker, Depth - 1, !IsWhitePlayer, -Alpha - 1, -Alpha, Ply + 1).Score;
+        if (Score > Alpha && Score < Beta && !IsUnwinding(Worker))
+        {
+            Score = -NegaMax(ActiveBoard, Worker, Depth - 1, !IsWhitePlayer, -Beta, -Alpha, Ply + 1).Score;
+        }
+    }
+    Worker.History.pop();
+    PopAccumulator(Worker);
+    in_board.unmake_move(undo);
+    return Score;
+}
+
+int32 FMinimaxSearch::GetLateMoveReduction(const FSearchWorker& Worker, const Move& move, int32 MoveIndex, int32 Depth, int32 Ply, bool IsInCheck) const
+{
+    // the root's moves are all searched fully, so are captures, killers and every move out of check
+    if (!Settings.UseLateMoveReductions || Ply == 0 || IsInCheck || Depth < Settings.LateMoveMinDepth || MoveIndex < Settings.LateMoveMinIndex
+        || move.is_capture() || Worker.Ordering.is_killer(move, Ply))
+    {
+        return 0;
+    }
+    int32 Reduction = MoveIndex >= Settings.LateMoveMinIndex * 3 && Depth >= 5 ? 2 : 1;
+    // a move that caused cutoffs elsewhere in the tree lately is less likely to be as bad as its place in the list says
+    if (Worker.Ordering.get_history(Worker.Board, move) >= Depth * Depth)
+    {
+        Reduction--;
+    }
+    // leave at least one ply for the reduced search
+    return FMath::Min(Reduction, Depth - 2);
+}
+
+bool FMinimaxSearch::IsNullMoveCutoff(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, int32 Beta, int32 Ply)
+{
+    PackedBoard& in_board = Worker.Board;
+    // passing drops the pawn shadow, it comes back with the move
+    const int8 Shadow = in_board.shadow_cell;
+    // no line through a pass repeats a real position, and the fifty-move count starts over below it
+    Worker.History.push(in_board.hash, true);
+    in_board.flip_side_to_move();
+    if (RunningNetwork != nullptr)
+    {
+        Worker.Accumulators.push_null();
+    }
+    Worker.IsAfterNullMove = true;
+    const int32 Score = -NegaMax(ActiveBoard, Worker, Depth - 1 - Settings.NullMoveReduction, !IsWhitePlayer, -Beta, -Beta + 1, Ply + 1).Score;
+    Worker.IsAfterNullMove = false;
+    PopAccumulator(Worker);
+    Worker.History.pop();
+    in_board.flip_side_to_move();
+    in_board.set_shadow(Shadow);
+    return Score >= Beta && !IsUnwinding(Worker);
+}
+
+bool FMinimaxSearch::CanSplit(int32 Depth, int32 MoveCount) const
+{
+    // shallow nodes cost less than sharing them, and a single remaining sibling leaves nothing to share
+    return UseSplitPoints && Workers.Num() > 1 && Depth >= Settings.SplitMinDepth && MoveCount > 2;
+}
+
+void FMinimaxSearch::SearchSplitPoint(Board* ActiveBoard, FSearchWorker& Worker, const MoveList& Moves, int32 Depth, bool IsWhitePlayer, bool IsInCheck, int32& Alpha, int32 Beta, int32 Ply, MoveResult& Result, Move& BestMove)
+{
+    FSplitPoint SplitPoint;
+    SplitPoint.Parent = Worker.ActiveSplit;
+    SplitPoint.Board = Worker.Board;
+    SplitPoint.History = &Worker.History;
+    SplitPoint.HistorySize = Worker.History.size();
+    SplitPoint.Moves = &Moves;
+    SplitPoint.Depth = Depth;
+    SplitPoint.Ply = Ply;
+    SplitPoint.IsWhitePlayer = IsWhitePlayer;
+    SplitPoint.IsInCheck = IsInCheck;
+    SplitPoint.Beta = Beta;
+    SplitPoint.NextMove = 1;
+    SplitPoint.Alpha = Alpha;
+    SplitPoint.BestScore = Result.Score;
+    SplitPoint.BestMove = BestMove;
+
+    {
+        FScopeLock Lock(&Worker.SplitLock);
+        Worker.OpenSplits.Add(&SplitPoint);
+    }
+    Worker.ActiveSplit = &SplitPoint;
+    SearchSplitMoves(ActiveBoard, Worker, SplitPoint);
+    Worker.ActiveSplit = SplitPoint.Parent;
+    {
+        FScopeLock Lock(&Worker.SplitLock);
+        Worker.OpenSplits.Remove(&SplitPoint);
+    }
+
+    // the split point and the move list live in this frame, wait for the helpers still searching siblings
+    while (SplitPoint.Helpers.load() > 0)
+    {
+        FPlatformProcess::Sleep(0.0f);
+    }
+
+    Alpha = SplitPoint.Alpha;
+    Result.Score = SplitPoint.BestScore;
+    Result.FromKey = PackedBoard::to_key(SplitPoint.BestMove.from);
+    Result.ToKey = PackedBoard::to_key(SplitPoint.BestMove.to);
+    BestMove = SplitPoint.BestMove;
+}
+
+void FMinimaxSearch::SearchSplitMoves(Board* ActiveBoard, FSearchWorker& Worker, FSplitPoint& SplitPoint)
+{
+    const MoveList& Moves = *SplitPoint.Moves;
+    while (!IsUnwinding(Worker))
+    {
+        const int32 Index = SplitPoint.NextMove.fetch_add(1);
+        if (Index >= Moves.size())
+        {
+            return;
+        }
+
+        const Move& move = Moves[Index];
+        const int32 Reduction = GetLateMoveReduction(Worker, move, Index, SplitPoint.Depth, SplitPoint.Ply, SplitPoint.IsInCheck);
+        const int32 Score = SearchChild(ActiveBoard, Worker, move, false, Reduction, SplitPoint.Depth, SplitPoint.IsWhitePlayer, SplitPoint.Alpha.load(), SplitPoint.Beta, SplitPoint.Ply);
+        if (IsUnwinding(Worker))
+        {
+            return;
+        }
+
+        FScopeLock Lock(&SplitPoint.ResultLock);
+        if (Score > SplitPoint.BestScore)
+        {
+            SplitPoint.BestScore = Score;
+            SplitPoint.BestMove = move;
+        }
+        if (Score > SplitPoint.Alpha)
+        {
+            SplitPoint.Alpha = Score;
+        }
+        if (Score >= SplitPoint.Beta)
+        {
+            // the siblings still being searched by other workers no longer matter
+            Worker.Ordering.record_cutoff(Worker.Board, move, SplitPoint.Depth, SplitPoint.Ply);
+            SplitPoint.IsCancelled = true;
+            return;
+        }
+    }
+}
+
+void FMinimaxSearch::HelpSplitPoints(Board* ActiveBoard, FSearchWorker& Worker)
+{
+    // the main worker raises the abort flag once it has its move, there is nothing left to help with then
+    while (!IsSearchAborted)
+    {
+        FSplitPoint* SplitPoint = StealSplitPoint(Worker);
+        if (SplitPoint == nullptr)
+        {
+            FPlatformProcess::Sleep(0.0f);
+            continue;
+        }
+        Worker.Board = SplitPoint->Board;
+        Worker.History.copy_from(*SplitPoint->History, SplitPoint->HistorySize);
+        if (RunningNetwork != nullptr)
+        {
+            Worker.Accumulators.reset(*RunningNetwork, Worker.Board);
+        }
+        Worker.ActiveSplit = SplitPoint;
+        SearchSplitMoves(ActiveBoard, Worker, *SplitPoint);
+        Worker.ActiveSplit = nullptr;
+        SplitPoint->Helpers--;
+    }
+}
+
+FSplitPoint* FMinimaxSearch::StealSplitPoint(FSearchWorker& Thief)
+{
+    for (int32 Offset = 1; Offset < Workers.Num(); Offset++)
+    {
+        FSearchWorker& Victim = *Workers[(Thief.Index + Offset) % Workers.Num()];
+        FScopeLock Lock(&Victim.SplitLock);
+        // the oldest split point is the shallowest, its siblings are the largest pieces of work
+        for (FSplitPoint* SplitPoint : Victim.OpenSplits)
+        {
+            if (!SplitPoint->IsCancelled && SplitPoint->NextMove.load() < SplitPoint->Moves->size())
+            {
+                // joined under the victim's lock, so the owner cannot stop waiting before this helper leaves
+                SplitPoint->Helpers++;
+                return SplitPoint;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool FMinimaxSearch::IsUnwinding(const FSearchWorker& Worker) const
+{
+    if (IsSearchAborted || Worker.IsStopped || (RunningCancel != nullptr && RunningCancel->load()))
+    {
+        return true;
+    }
+    // a beta cutoff at any split point above this worker makes its current subtree pointless
+    for (const FSplitPoint* SplitPoint = Worker.ActiveSplit; SplitPoint != nullptr; SplitPoint = SplitPoint->Parent)
+    {
+        if (SplitPoint->IsCancelled)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int32 FMinimaxSearch::Evaluate(Board* ActiveBoard, FSearchWorker& Worker) const
+{
+    HEXACHESS_TRACE_SCOPE(HexachessAI_Evaluate);
+    PackedBoard& in_board = Worker.Board;
+    const uint64 Hash = ActiveBoard->position_hash(in_board);
+    int32 Score = 0;
+    if (Worker.Evaluations.probe(Hash, Score))
+    {
+        return Score;
+    }
+    if (RunningNetwork != nullptr)
+    {
+        Score = Worker.Accumulators.evaluate(*RunningNetwork, in_board);
+    }
+    else
+    {
+        Score = RunningEvaluator != nullptr ? RunningEvaluator->evaluate(*ActiveBoard, in_board) : ActiveBoard->evaluate(in_board);
+    }
+    Worker.Evaluations.store(Hash, Score);
+    return Score;
+}
+
+void FMinimaxSearch::PushAccumulator(FSearchWorker& Worker, const UndoRecord& Undo) const
+{
+    if (RunningNetwork != nullptr)
+    {
+        Worker.Accumulators.push(Undo);
+    }
+}
+
+void FMinimaxSearch::PopAccumulator(FSearchWorker& Worker) const
+{
+    if (RunningNetwork != nullptr)
+    {
+        Worker.Accumulators.pop();
+    }
+}
+
+bool FMinimaxSearch::IsPastDeadline()
+{
+    double Deadline = SearchDeadline.load(std::memory_order_relaxed);
+    if (Deadline != PonderDeadline)
+    {
+        return FPlatformTime::Seconds() >= Deadline;
+    }
+    if (RunningPonder == nullptr || RunningPonder->load())
+    {
+        return false;
+    }
+    // the expected move was played, the search now has its budget from here; whichever thread sees it first sets it
+    SearchDeadline.compare_exchange_strong(Deadline, FPlatformTime::Seconds() + TimeBudgetSeconds);
+    return false;
+}
+
+void FMinimaxSearch::ExtractLine(Board* ActiveBoard, PackedBoard Position, const MoveResult& FirstMove, int32 MaxLength, TArray<MoveResult>& OutLine) const
+{
+    OutLine.Reset();
+    const int32 From = PackedBoard::to_index(FirstMove.FromKey);
+    const int32 To = PackedBoard::to_index(FirstMove.ToKey);
+    if (From < 0 || To < 0 || From == To)
+    {
+        return;
+    }
+    OutLine.Add(FirstMove);
+    Position.make_move(From, To);
+    TTEntry Entry;
+    while (Table != nullptr && OutLine.Num() < MaxLength && Table->probe(ActiveBoard->position_hash(Position), Entry) && Entry.has_best_move())
+    {
+        // a hash collision could hand back a move of some other position
+        MoveList Replies;
+        ActiveBoard->generate_legal_moves(Position, Position.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white, Replies);
+        const Move* Reply = Replies.begin();
+        while (Reply != Replies.end() && (Reply->from != Entry.best_move.from || Reply->to != Entry.best_move.to))
+        {
+            Reply++;
+        }
+        if (Reply == Replies.end())
+        {
+            return;
+        }
+        OutLine.Add(MoveResult(PackedBoard::to_key(Reply->from), PackedBoard::to_key(Reply->to), Entry.score));
+        Position.make_move(Reply->from, Reply->to);
+    }
+}
+
+bool FMinimaxSearch::ProbeLine(Board* ActiveBoard, const PackedBoard& Position, int32 MaxLength, TArray<MoveResult>& OutLine) const
+{
+    OutLine.Reset();
+    TTEntry Entry;
+    if (Table == nullptr || !Table->probe(ActiveBoard->position_hash(Position), Entry) || !Entry.has_best_move())
+    {
+        return false;
+    }
+    // a hash collision could hand back a move of some other position
+    PackedBoard in_board = Position;
+    MoveList Moves;
+    ActiveBoard->generate_legal_moves(in_board, in_board.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white, Moves);
+    for (const Move& Candidate : Moves)
+    {
+        if (Candidate.from == Entry.best_move.from && Candidate.to == Entry.best_move.to)
+        {
+            ExtractLine(ActiveBoard, Position, MoveResult(PackedBoard::to_key(Candidate.from), PackedBoard::to_key(Candidate.to), Entry.score), MaxLength, OutLine);
+            return OutLine.Num() > 0;
+        }
+    }
+    return false;
+}
+
+MoveResult FMinimaxSearch::FindPonderMove(Board* ActiveBoard, PackedBoard Position, const MoveResult& BestMove) const
+{
+    TArray<MoveResult> Line;
+    ExtractLine(ActiveBoard, Position, BestMove, 2, Line);
+    return Line.Num() > 1 ? Line[1] : MoveResult();
+}
+
+bool FMinimaxSearch::ShouldStopSearch(FSearchWorker& Worker)
+{
+    // reading the clock on every node is too costly, look at it every few thousand
+    const int64 Nodes = Worker.Nodes.load(std::memory_order_relaxed) + 1;
+    Worker.Nodes.store(Nodes, std::memory_order_relaxed);
+    if ((Nodes & 2047) == 0 && IsPastDeadline())
+    {
+        // split point helpers search the main worker's tree, only the search as a whole can stop them
+        if (Worker.Index != 0 && !UseSplitPoints)
+        {
+            Worker.IsStopped = true;
+        }
+        else if (CanAbortSearch)
+        {
+            IsSearchAborted = true;
+        }
+    }
+    if (CanAbortSearch && IsOverNodeBudget(Worker))
+    {
+        IsSearchAborted = true;
+    }
+    return IsUnwinding(Worker);
+}
+
+bool FMinimaxSearch::IsOverNodeBudget(const FSearchWorker& Worker) const
+{
+    // only the main worker's nodes count, they are the same on every run where the helpers' depend on the scheduler
+    return NodeBudget > 0 && Worker.Index == 0 && Worker.Nodes.load(std::memory_order_relaxed) >= NodeBudget;
+}
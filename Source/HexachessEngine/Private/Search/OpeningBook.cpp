@@ -0,0 +1,123 @@
+#include "Search/OpeningBook.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+FOpeningBook::~FOpeningBook()
+{
+    Close();
+}
+
+bool FOpeningBook::Open(const FString& Path)
+{
+    Close();
+
+    const uint8* Data = nullptr;
+    int64 Size = 0;
+    // a file inside a compressed pak cannot be mapped, it is read once instead
+    MappedFile = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path);
+    if (MappedFile != nullptr)
+    {
+        MappedRegion = MappedFile->MapRegion(0, MappedFile->GetFileSize());
+    }
+    if (MappedRegion != nullptr)
+    {
+        Data = MappedRegion->GetMappedPtr();
+        Size = MappedRegion->GetMappedSize();
+    }
+    else if (FFileHelper::LoadFileToArray(LoadedFile, *Path, FILEREAD_Silent))
+    {
+        Data = LoadedFile.GetData();
+        Size = LoadedFile.Num();
+    }
+
+    FOpeningBookHeader Header;
+    if (Data == nullptr || Size < static_cast<int64>(sizeof(Header)))
+    {
+        Close();
+        return false;
+    }
+    FMemory::Memcpy(&Header, Data, sizeof(Header));
+    // the count is checked against what fits in the file by dividing, a crafted count must not overflow the product;
+    // Num() hands it out as an int32
+    const uint64 MaxEntryCount = static_cast<uint64>(Size - sizeof(Header)) / sizeof(FOpeningBookEntry);
+    if (Header.Magic != FOpeningBookHeader::FileMagic || Header.Version != FOpeningBookHeader::FileVersion
+        || Header.EntryCount > static_cast<uint64>(MAX_int32) || Header.EntryCount > MaxEntryCount)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("OpeningBook: %s is not a version %u book"), *Path, FOpeningBookHeader::FileVersion);
+        Close();
+        return false;
+    }
+
+    Entries = reinterpret_cast<const FOpeningBookEntry*>(Data + sizeof(Header));
+    EntryCount = static_cast<int64>(Header.EntryCount);
+    return true;
+}
+
+void FOpeningBook::Close()
+{
+    Entries = nullptr;
+    EntryCount = 0;
+    delete MappedRegion;
+    MappedRegion = nullptr;
+    delete MappedFile;
+    MappedFile = nullptr;
+    LoadedFile.Empty();
+}
+
+void FOpeningBook::Prefetch() const
+{
+    const uint8* Bytes = reinterpret_cast<const uint8*>(Entries);
+    const int64 Size = EntryCount * static_cast<int64>(sizeof(FOpeningBookEntry));
+    const int64 PageSize = FPlatformMemory::GetConstants().PageSize;
+    uint8 Sum = 0;
+    for (int64 Offset = 0; Offset < Size; Offset += PageSize)
+    {
+        Sum += Bytes[Offset];
+    }
+    // a load the compiler can see no use of would not fault the page in
+    volatile uint8 Sink = Sum;
+    (void)Sink;
+}
+
+TConstArrayView<FOpeningBookEntry> FOpeningBook::Find(const uint64 Hash) const
+{
+    // first entry not below the hash, then the run of entries with exactly that hash
+    int64 First = 0;
+    int64 Count = EntryCount;
+    while (Count > 0)
+    {
+        const int64 Half = Count / 2;
+        if (Entries[First + Half].Hash < Hash)
+        {
+            First += Half + 1;
+            Count -= Half + 1;
+        }
+        else
+        {
+            Count = Half;
+        }
+    }
+    int64 Last = First;
+    while (Last < EntryCount && Entries[Last].Hash == Hash)
+    {
+        Last++;
+    }
+    return TConstArrayView<FOpeningBookEntry>(Entries + First, static_cast<int32>(Last - First));
+}
+
+bool FOpeningBook::Write(const FString& Path, TArray<FOpeningBookEntry> Entries)
+{
+    Entries.Sort([](const FOpeningBookEntry& A, const FOpeningBookEntry& B)
+    {
+        return A.Hash != B.Hash ? A.Hash < B.Hash : A.Weight > B.Weight;
+    });
+
+    FOpeningBookHeader Header;
+    Header.EntryCount = Entries.Num();
+    TArray<uint8> Bytes;
+    Bytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+    Bytes.Append(reinterpret_cast<const uint8*>(Entries.GetData()), Entries.Num() * sizeof(FOpeningBookEntry));
+    return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
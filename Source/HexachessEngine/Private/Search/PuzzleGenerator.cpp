@@ -0,0 +1,387 @@
+#include "Search/PuzzleGenerator.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+
+#include "Search/SelfPlay.h"
+
+// the exhaustive mate search of one position: an and/or tree over every legal move, with a node budget
+struct FMateProver
+{
+    Board& Rules;
+    int64 Nodes = 0;
+    int64 MaxNodes = 0;
+    const std::atomic<bool>& IsCancelled;
+    // set once the budget ran out or the search was cancelled; every answer after that is no
+    bool IsAborted = false;
+
+    FMateProver(Board& InRules, const int64 InMaxNodes, const std::atomic<bool>& InIsCancelled)
+        : Rules(InRules), MaxNodes(InMaxNodes), IsCancelled(InIsCancelled)
+    {
+    }
+
+    static Cell::PieceColor GetSideToMove(const PackedBoard& Position)
+    {
+        return Position.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white;
+    }
+
+    bool IsInCheck(const PackedBoard& Position) const
+    {
+        const Cell::PieceColor Side = GetSideToMove(Position);
+        const int32 King = Position.get_king_cell(Side);
+        return King >= 0 && Rules.is_attacked(Position, King, Side == Cell::PieceColor::white ? Cell::PieceColor::black : Cell::PieceColor::white);
+    }
+
+    // the side to move mates within Moves of its own moves, whatever the other side replies
+    bool CanForceMate(PackedBoard& Position, const int32 Moves)
+    {
+        if (Moves <= 0 || IsOverBudget())
+        {
+            return false;
+        }
+        MoveList Candidates;
+        Rules.generate_legal_moves(Position, GetSideToMove(Position), Candidates);
+        for (const Move& Candidate : Candidates)
+        {
+            const UndoRecord Undo = Position.make_move(Candidate.from, Candidate.to);
+            const bool IsMate = IsMatedWithin(Position, Moves - 1);
+            Position.unmake_move(Undo);
+            if (IsMate)
+            {
+                return true;
+            }
+            if (IsAborted)
+            {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // the side to move is mated already, or within Moves more moves of the other side whatever it plays
+    bool IsMatedWithin(PackedBoard& Position, const int32 Moves)
+    {
+        // the last move has to give check, looking for the king's attackers is much cheaper than generating the replies
+        const bool IsChecked = IsInCheck(Position);
+        if (Moves <= 0 && !IsChecked)
+        {
+            return false;
+        }
+        MoveList Replies;
+        Rules.generate_legal_moves(Position, GetSideToMove(Position), Replies);
+        if (Replies.empty())
+        {
+            // a stalemate is no mate
+            return IsChecked;
+        }
+        if (Moves <= 0)
+        {
+            return false;
+        }
+        for (const Move& Reply : Replies)
+        {
+            const UndoRecord Undo = Position.make_move(Reply.from, Reply.to);
+            const bool IsMate = CanForceMate(Position, Moves);
+            Position.unmake_move(Undo);
+            if (!IsMate)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the fewest moves the side to move needs to mate, up to MaxMoves; 0 when it cannot
+    int32 GetShortestMate(PackedBoard& Position, const int32 MaxMoves)
+    {
+        for (int32 Moves = 1; Moves <= MaxMoves && !IsAborted; Moves++)
+        {
+            if (CanForceMate(Position, Moves))
+            {
+                return Moves;
+            }
+        }
+        return 0;
+    }
+
+    // the mating line of a proven mate in Moves: the fastest mating move, then the reply that holds out longest
+    void AppendLine(PackedBoard& Position, const int32 Moves, FPuzzleEntry& OutEntry)
+    {
+        if (Moves <= 0 || OutEntry.SolutionPlies >= FPuzzleEntry::MaxSolutionPlies)
+        {
+            return;
+        }
+        MoveList Candidates;
+        Rules.generate_legal_moves(Position, GetSideToMove(Position), Candidates);
+        for (int32 Length = 1; Length <= Moves; Length++)
+        {
+            for (const Move& Candidate : Candidates)
+            {
+                UndoRecord Undo = Position.make_move(Candidate.from, Candidate.to);
+                if (!IsMatedWithin(Position, Length - 1))
+                {
+                    Position.unmake_move(Undo);
+                    continue;
+                }
+                AddPly(Candidate, OutEntry);
+
+                MoveList Replies;
+                Rules.generate_legal_moves(Position, GetSideToMove(Position), Replies);
+                int32 LongestReply = -1;
+                int32 LongestMoves = 0;
+                for (int32 Index = 0; Index < Replies.size(); Index++)
+                {
+                    const UndoRecord ReplyUndo = Position.make_move(Replies[Index].from, Replies[Index].to);
+                    const int32 ReplyMoves = GetShortestMate(Position, Length - 1);
+                    Position.unmake_move(ReplyUndo);
+                    if (ReplyMoves > LongestMoves)
+                    {
+                        LongestReply = Index;
+                        LongestMoves = ReplyMoves;
+                    }
+                }
+                if (LongestReply >= 0 && OutEntry.SolutionPlies < FPuzzleEntry::MaxSolutionPlies)
+                {
+                    AddPly(Replies[LongestReply], OutEntry);
+                    const UndoRecord ReplyUndo = Position.make_move(Replies[LongestReply].from, Replies[LongestReply].to);
+                    AppendLine(Position, LongestMoves, OutEntry);
+                    Position.unmake_move(ReplyUndo);
+                }
+                Position.unmake_move(Undo);
+                return;
+            }
+        }
+    }
+
+    static void AddPly(const Move& Played, FPuzzleEntry& OutEntry)
+    {
+        OutEntry.Solution[OutEntry.SolutionPlies][0] = static_cast<uint16>(PackedBoard::to_key(Played.from));
+        OutEntry.Solution[OutEntry.SolutionPlies][1] = static_cast<uint16>(PackedBoard::to_key(Played.to));
+        OutEntry.SolutionPlies++;
+    }
+
+    bool IsOverBudget()
+    {
+        // the cancel flag is shared between threads, only look at it every few thousand nodes
+        if (++Nodes > MaxNodes || ((Nodes & 4095) == 0 && IsCancelled))
+        {
+            IsAborted = true;
+        }
+        return IsAborted;
+    }
+};
+
+TArray<PackedBoard> FPuzzleGenerator::CollectPositions(const TArray<FSelfPlayGame>& Games, const PackedBoard& StartPosition, const int32 MinPly)
+{
+    TArray<PackedBoard> Positions;
+    TSet<uint64> Seen;
+    for (const FSelfPlayGame& Game : Games)
+    {
+        if (Game.Ending == ESelfPlayEnding::Unfinished)
+        {
+            continue;
+        }
+        PackedBoard Position = StartPosition;
+        for (int32 Ply = 0; Ply <= Game.Moves.Num(); Ply++)
+        {
+            bool IsAlreadySeen = false;
+            if (Ply >= MinPly)
+            {
+                Seen.Add(Position.hash, &IsAlreadySeen);
+                if (!IsAlreadySeen)
+                {
+                    Positions.Add(Position);
+                }
+            }
+            if (Ply < Game.Moves.Num())
+            {
+                Position.make_move(PackedBoard::to_index(Game.Moves[Ply].Key), PackedBoard::to_index(Game.Moves[Ply].Value));
+            }
+        }
+    }
+    return Positions;
+}
+
+TArray<FPuzzleEntry> FPuzzleGenerator::Generate(const TArray<PackedBoard>& Positions, const FPuzzleConfig& Config, const std::atomic<bool>& IsCancelled,
+    const TFunction<void(int32, int32)>& OnProgress) const
+{
+    const int32 MaxMateMoves = FMath::Clamp(Config.MaxMateMoves, 0, (FPuzzleEntry::MaxSolutionPlies + 1) / 2);
+    int32 Concurrency = Config.Concurrency > 0 ? Config.Concurrency : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    Concurrency = FMath::Clamp(Concurrency, 1, FMath::Max(Positions.Num(), 1));
+
+    // one result per position, so the pack keeps the order of the games whichever thread found a puzzle first
+    TArray<FPuzzleEntry> Results;
+    TArray<bool> IsPuzzle;
+    Results.SetNum(Positions.Num());
+    IsPuzzle.SetNumZeroed(Positions.Num());
+
+    FCriticalSection ProgressLock;
+    std::atomic<int32> NextPosition{0};
+    std::atomic<int32> Checked{0};
+    std::atomic<int32> Found{0};
+
+    // one slot per thread, each with its own rules board and screening search, reused for all of its positions
+    ParallelFor(Concurrency, [&](int32 Slot)
+    {
+        Board Rules;
+        FMinimaxSearch Screen;
+
+        FMinimaxRequest Request;
+        Request.MaxDepth = FMath::Max(Config.ScreenDepth, 1);
+        Request.NodeBudget = FMath::Max<int64>(Config.ScreenNodeBudget, 1);
+        Request.ThreadCount = 1;
+        // cleared for every position, a small table is cheaper to clear and plenty for a few hundred thousand nodes
+        Request.Settings.TranspositionTableSizeMB = 1;
+        Request.Settings.MultiPV = 2;
+
+        while (!IsCancelled)
+        {
+            const int32 Index = NextPosition++;
+            if (Index >= Positions.Num())
+            {
+                break;
+            }
+
+            PackedBoard Position = Positions[Index];
+            Request.Position = Position;
+            Request.IsWhiteAI = !Position.black_to_move;
+            // the same position must screen the same on any thread, whatever the slot searched before
+            Screen.Clear();
+            const FMinimaxResult Result = Screen.Run(Request, IsCancelled);
+            if (!Result.IsComplete)
+            {
+                continue;
+            }
+
+            const int32 Score = Result.Lines.Num() > 0 ? Result.Lines[0].Score : 0;
+            const int32 MateMoves = Score >= Config.MateScreenScore ? MaxMateMoves : FMath::Min(MaxMateMoves, 1);
+            FPuzzleEntry& Entry = Results[Index];
+            if (FindMate(Rules, Position, Config, MateMoves, IsCancelled, Entry) || (Config.FindCaptures && FindCapture(Position, Config, Result, Entry)))
+            {
+                IsPuzzle[Index] = true;
+                Found++;
+            }
+
+            const int32 CheckedCount = ++Checked;
+            if (OnProgress)
+            {
+                FScopeLock Lock(&ProgressLock);
+                OnProgress(CheckedCount, Found.load());
+            }
+        }
+    });
+
+    TArray<FPuzzleEntry> Puzzles;
+    for (int32 Index = 0; Index < Results.Num(); Index++)
+    {
+        if (IsPuzzle[Index])
+        {
+            Puzzles.Add(Results[Index]);
+        }
+    }
+    return Puzzles;
+}
+
+bool FPuzzleGenerator::FindMate(Board& Rules, PackedBoard& Position, const FPuzzleConfig& Config, const int32 MaxMoves, const std::atomic<bool>& IsCancelled, FPuzzleEntry& OutEntry) const
+{
+    if (MaxMoves <= 0)
+    {
+        return false;
+    }
+    FMateProver Prover(Rules, Config.MateNodeBudget, IsCancelled);
+    const int32 Moves = Prover.GetShortestMate(Position, MaxMoves);
+    if (Moves == 0)
+    {
+        return false;
+    }
+
+    // a puzzle has one answer: no other first move may mate as fast
+    MoveList Candidates;
+    Rules.generate_legal_moves(Position, FMateProver::GetSideToMove(Position), Candidates);
+    int32 MatingMoves = 0;
+    for (const Move& Candidate : Candidates)
+    {
+        const UndoRecord Undo = Position.make_move(Candidate.from, Candidate.to);
+        MatingMoves += Prover.IsMatedWithin(Position, Moves - 1) ? 1 : 0;
+        Position.unmake_move(Undo);
+        if (MatingMoves > 1 || Prover.IsAborted)
+        {
+            return false;
+        }
+    }
+
+    OutEntry = FPuzzleEntry();
+    PositionCodec::encode(Position, OutEntry.Position);
+    OutEntry.Kind = static_cast<uint8>(EPuzzleKind::Mate);
+    OutEntry.Value = static_cast<int16>(Moves);
+    Prover.AppendLine(Position, Moves, OutEntry);
+    // the line repeats searches the proof already finished, it only runs out of budget if the proof barely fit
+    return !Prover.IsAborted;
+}
+
+bool FPuzzleGenerator::FindCapture(const PackedBoard& Position, const FPuzzleConfig& Config, const FMinimaxResult& Screen, FPuzzleEntry& OutEntry) const
+{
+    if (Screen.Lines.Num() < 2 || Screen.Lines[0].Moves.Num() == 0)
+    {
+        return false;
+    }
+    const FMinimaxLine& Best = Screen.Lines[0];
+    const int32 To = PackedBoard::to_index(Best.Moves[0].ToKey);
+    if (To < 0 || !Position.get_square(To).has_piece())
+    {
+        return false;
+    }
+    if (Best.Score < Config.CaptureMinScore || Best.Score - Screen.Lines[1].Score < Config.CaptureMargin)
+    {
+        return false;
+    }
+
+    OutEntry = FPuzzleEntry();
+    PositionCodec::encode(Position, OutEntry.Position);
+    OutEntry.Kind = static_cast<uint8>(EPuzzleKind::WinningCapture);
+    OutEntry.Value = static_cast<int16>(FMath::Clamp(Best.Score, -32767, 32767));
+    // the capture, the reply and the follow-up are the puzzle, the rest of the line is only the search's guess
+    const int32 Plies = FMath::Min(Best.Moves.Num(), 3);
+    for (int32 Ply = 0; Ply < Plies; Ply++)
+    {
+        OutEntry.Solution[Ply][0] = static_cast<uint16>(Best.Moves[Ply].FromKey);
+        OutEntry.Solution[Ply][1] = static_cast<uint16>(Best.Moves[Ply].ToKey);
+    }
+    OutEntry.SolutionPlies = static_cast<uint8>(Plies);
+    return true;
+}
+
+bool FPuzzleGenerator::WritePack(const FString& Path, const TArray<FPuzzleEntry>& Entries)
+{
+    FPuzzlePackHeader Header;
+    Header.EntryCount = Entries.Num();
+    TArray<uint8> Bytes;
+    Bytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+    Bytes.Append(reinterpret_cast<const uint8*>(Entries.GetData()), Entries.Num() * sizeof(FPuzzleEntry));
+    return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FPuzzleGenerator::ReadPack(const FString& Path, TArray<FPuzzleEntry>& OutEntries)
+{
+    OutEntries.Reset();
+    TArray<uint8> Bytes;
+    FPuzzlePackHeader Header;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent) || Bytes.Num() < static_cast<int32>(sizeof(Header)))
+    {
+        return false;
+    }
+    FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+    // the count is checked against what fits in the file by dividing, a crafted count must not overflow the product
+    const uint64 MaxEntryCount = (Bytes.Num() - sizeof(Header)) / sizeof(FPuzzleEntry);
+    if (Header.Magic != FPuzzlePackHeader::FileMagic || Header.Version != FPuzzlePackHeader::FileVersion
+        || Header.EntryCount > static_cast<uint64>(MAX_int32) || Header.EntryCount > MaxEntryCount)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("PuzzleGenerator: %s is not a version %u puzzle pack"), *Path, FPuzzlePackHeader::FileVersion);
+        return false;
+    }
+    OutEntries.SetNumUninitialized(static_cast<int32>(Header.EntryCount));
+    FMemory::Memcpy(OutEntries.GetData(), Bytes.GetData() + sizeof(Header), OutEntries.Num() * sizeof(FPuzzleEntry));
+    return true;
+}
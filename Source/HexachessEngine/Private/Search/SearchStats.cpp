@@ -0,0 +1,26 @@
+#include "Search/SearchStats.h"
+
+#include "Search/MinimaxSearch.h"
+
+DEFINE_STAT(STAT_HexachessAI_Depth);
+DEFINE_STAT(STAT_HexachessAI_Nodes);
+DEFINE_STAT(STAT_HexachessAI_NodesPerSecond);
+DEFINE_STAT(STAT_HexachessAI_QuiescenceNodes);
+DEFINE_STAT(STAT_HexachessAI_Cutoffs);
+DEFINE_STAT(STAT_HexachessAI_TableProbes);
+DEFINE_STAT(STAT_HexachessAI_TableHits);
+DEFINE_STAT(STAT_HexachessAI_EvaluationHits);
+DEFINE_STAT(STAT_HexachessAI_Allocations);
+
+void SetSearchStats(const FMinimaxDepthReport& Report)
+{
+    SET_DWORD_STAT(STAT_HexachessAI_Depth, Report.Depth);
+    SET_DWORD_STAT(STAT_HexachessAI_Nodes, Report.Nodes);
+    SET_DWORD_STAT(STAT_HexachessAI_NodesPerSecond, Report.ElapsedSeconds > 0.0 ? static_cast<int64>(Report.Nodes / Report.ElapsedSeconds) : 0);
+    SET_DWORD_STAT(STAT_HexachessAI_QuiescenceNodes, Report.QuiescenceNodes);
+    SET_DWORD_STAT(STAT_HexachessAI_Cutoffs, Report.Cutoffs);
+    SET_DWORD_STAT(STAT_HexachessAI_TableProbes, Report.TableProbes);
+    SET_DWORD_STAT(STAT_HexachessAI_TableHits, Report.TableHits);
+    SET_DWORD_STAT(STAT_HexachessAI_EvaluationHits, Report.EvaluationHits);
+    SET_DWORD_STAT(STAT_HexachessAI_Allocations, Report.Allocations);
+}
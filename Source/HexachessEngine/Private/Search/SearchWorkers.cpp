@@ -0,0 +1,58 @@
+#include "Search/SearchWorkers.h"
+
+#include "Async/AsyncWork.h"
+#include "Async/ParallelFor.h"
+#include "Misc/QueuedThreadPool.h"
+
+namespace
+{
+    class FSearchWorkerTask : public FNonAbandonableTask
+    {
+    public:
+
+        FSearchWorkerTask(TFunctionRef<void(int32)> InBody, int32 InIndex)
+            : Body(InBody)
+            , Index(InIndex)
+        {
+        }
+
+        void DoWork()
+        {
+            Body(Index);
+        }
+
+        FORCEINLINE TStatId GetStatId() const
+        {
+            RETURN_QUICK_DECLARE_CYCLE_STAT(FSearchWorkerTask, STATGROUP_ThreadPoolAsyncTasks);
+        }
+
+    private:
+
+        TFunctionRef<void(int32)> Body;
+        int32 Index;
+    };
+}
+
+void RunSearchWorkers(int32 Count, FQueuedThreadPool* ThreadPool, bool UseBackgroundThreads, TFunctionRef<void(int32)> Body)
+{
+    if (ThreadPool == nullptr || Count <= 1)
+    {
+        // parallel for hands out the lowest index first, so the main worker is always running
+        ParallelFor(Count, Body, UseBackgroundThreads ? EParallelForFlags::BackgroundPriority : EParallelForFlags::None);
+        return;
+    }
+
+    TArray<TUniquePtr<FAsyncTask<FSearchWorkerTask>>> Helpers;
+    Helpers.Reserve(Count - 1);
+    for (int32 Index = 1; Index < Count; Index++)
+    {
+        Helpers.Add(MakeUnique<FAsyncTask<FSearchWorkerTask>>(Body, Index));
+        Helpers.Last()->StartBackgroundTask(ThreadPool);
+    }
+    Body(0);
+    for (const TUniquePtr<FAsyncTask<FSearchWorkerTask>>& Helper : Helpers)
+    {
+        // a helper still queued behind another search is retracted and returns at once here
+        Helper->EnsureCompletion(true);
+    }
+}
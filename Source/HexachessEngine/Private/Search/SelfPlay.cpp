@@ -0,0 +1,296 @@
+#include "Search/SelfPlay.h"
+
+#include <limits>
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/ScopeLock.h"
+
+double FSelfPlayGame::GetScoreOfA() const
+{
+    if (Outcome == ESelfPlayOutcome::Draw)
+    {
+        return 0.5;
+    }
+    return (Outcome == ESelfPlayOutcome::WhiteWins) == IsPlayerAWhite ? 1.0 : 0.0;
+}
+
+void FSelfPlayStats::Add(const FSelfPlayGame& Game)
+{
+    const double Score = Game.GetScoreOfA();
+    if (Score > 0.75)
+    {
+        Wins++;
+    }
+    else if (Score < 0.25)
+    {
+        Losses++;
+    }
+    else
+    {
+        Draws++;
+    }
+}
+
+int32 FSelfPlayStats::GetGameCount() const
+{
+    return Wins + Draws + Losses;
+}
+
+double FSelfPlayStats::GetScore() const
+{
+    const int32 Games = GetGameCount();
+    return Games > 0 ? (Wins + 0.5 * Draws) / Games : 0.5;
+}
+
+// the Elo difference that makes the stronger side expect Score points per game
+static double ScoreToElo(const double Score)
+{
+    if (Score <= 0.0)
+    {
+        return -std::numeric_limits<double>::infinity();
+    }
+    if (Score >= 1.0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return -400.0 * FMath::LogX(10.0, 1.0 / Score - 1.0);
+}
+
+static double EloToScore(const double Elo)
+{
+    return 1.0 / (1.0 + FMath::Pow(10.0, -Elo / 400.0));
+}
+
+double FSelfPlayStats::GetElo() const
+{
+    return ScoreToElo(GetScore());
+}
+
+double FSelfPlayStats::GetEloMargin() const
+{
+    const int32 Games = GetGameCount();
+    if (Games < 2)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    const double Score = GetScore();
+    const double Variance = (Wins * FMath::Square(1.0 - Score) + Draws * FMath::Square(0.5 - Score) + Losses * FMath::Square(Score)) / Games;
+    const double Deviation = FMath::Sqrt(Variance / Games);
+    // 1.96 standard deviations either side, mapped through the logistic curve
+    return (ScoreToElo(Score + 1.96 * Deviation) - ScoreToElo(Score - 1.96 * Deviation)) / 2.0;
+}
+
+double FSelfPlayStats::GetSprtLlr(const double Elo0, const double Elo1) const
+{
+    const int32 Games = GetGameCount();
+    if (Wins == 0 || Losses == 0)
+    {
+        // without both a win and a loss the variance says nothing yet
+        return 0.0;
+    }
+    const double Score = GetScore();
+    const double Variance = (Wins * FMath::Square(1.0 - Score) + Draws * FMath::Square(0.5 - Score) + Losses * FMath::Square(Score)) / Games;
+    const double Score0 = EloToScore(Elo0);
+    const double Score1 = EloToScore(Elo1);
+    // the normal approximation of the generalized SPRT
+    return 0.5 * Games * (Score1 - Score0) * (2.0 * Score - Score0 - Score1) / Variance;
+}
+
+ESprtDecision DecideSprt(const double Llr, const double Alpha, const double Beta)
+{
+    if (Llr >= FMath::Loge((1.0 - Beta) / Alpha))
+    {
+        return ESprtDecision::AcceptH1;
+    }
+    if (Llr <= FMath::Loge(Beta / (1.0 - Alpha)))
+    {
+        return ESprtDecision::AcceptH0;
+    }
+    return ESprtDecision::Continue;
+}
+
+FSelfPlayStats FSelfPlayRunner::Run(const FSelfPlayConfig& Config, const FSelfPlayPlayer& PlayerA, const FSelfPlayPlayer& PlayerB, const std::atomic<bool>& IsCancelled, const TFunction<void(const FSelfPlayGame&, const FSelfPlayStats&)>& OnGame)
+{
+    const int32 GameCount = FMath::Max(Config.GameCount, 0);
+    Games.Reset();
+    Games.SetNum(GameCount);
+    SprtDecision = ESprtDecision::Continue;
+
+    int32 Concurrency = Config.Concurrency > 0 ? Config.Concurrency : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+    Concurrency = FMath::Clamp(Concurrency, 1, FMath::Max(GameCount, 1));
+
+    FSelfPlayStats Stats;
+    FCriticalSection StatsLock;
+    std::atomic<int32> NextGame{0};
+    // set once the test is decided, games already running finish but no new game starts
+    std::atomic<bool> IsDecided{false};
+
+    // one slot per concurrent game, each with its own rules board and one search per player, reused for all of its games
+    ParallelFor(Concurrency, [&](int32 Slot)
+    {
+        Board Rules;
+        FMinimaxSearch SearchA;
+        FMinimaxSearch SearchB;
+        while (!IsCancelled && !IsDecided)
+        {
+            const int32 Index = NextGame++;
+            if (Index >= GameCount)
+            {
+                break;
+            }
+
+            FSelfPlayGame& Game = Games[Index];
+            Game.Index = Index;
+            Game.IsPlayerAWhite = Index % 2 == 0;
+            // a game must not play on what the previous game left in the tables
+            SearchA.Clear();
+            SearchB.Clear();
+            PlayGame(Rules, SearchA, SearchB, Config, PlayerA, PlayerB, IsCancelled, Game);
+            if (Game.Ending == ESelfPlayEnding::Unfinished)
+            {
+                break;
+            }
+
+            FScopeLock Lock(&StatsLock);
+            Stats.Add(Game);
+            if (Config.UseSprt && !IsDecided)
+            {
+                const ESprtDecision Decision = DecideSprt(Stats.GetSprtLlr(Config.SprtElo0, Config.SprtElo1), Config.SprtAlpha, Config.SprtBeta);
+                if (Decision != ESprtDecision::Continue)
+                {
+                    SprtDecision = Decision;
+                    IsDecided = true;
+                }
+            }
+            if (OnGame)
+            {
+                OnGame(Game, Stats);
+            }
+        }
+    });
+
+    return Stats;
+}
+
+void FSelfPlayRunner::PlayOpening(Board& Rules, const FSelfPlayConfig& Config, const int32 PairIndex, PackedBoard& OutPosition, TArray<TPair<int32, int32>>& OutMoves) const
+{
+    for (int32 Attempt = 0; ; Attempt++)
+    {
+        FRandomStream Random(Config.Seed * 7919 + PairIndex * 104729 + Attempt);
+        OutPosition = Config.StartPosition;
+        OutMoves.Reset();
+        bool IsPlayable = true;
+        MoveList Moves;
+        for (int32 Ply = 0; Ply < Config.OpeningPlies; Ply++)
+        {
+            Rules.generate_legal_moves(OutPosition, OutPosition.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white, Moves);
+            if (Moves.empty())
+            {
+                IsPlayable = false;
+                break;
+            }
+            const Move& Picked = Moves[Random.RandRange(0, Moves.size() - 1)];
+            OutMoves.Emplace(PackedBoard::to_key(Picked.from), PackedBoard::to_key(Picked.to));
+            OutPosition.make_move(Picked.from, Picked.to);
+        }
+        // four random plies never end a game from the usual start, the cap only guards odd start positions
+        if (IsPlayable || Attempt >= 16)
+        {
+            return;
+        }
+    }
+}
+
+void FSelfPlayRunner::PlayGame(Board& Rules, FMinimaxSearch& SearchA, FMinimaxSearch& SearchB, const FSelfPlayConfig& Config, const FSelfPlayPlayer& PlayerA, const FSelfPlayPlayer& PlayerB, const std::atomic<bool>& IsCancelled, FSelfPlayGame& Game)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    Game.Moves.Reset(Config.OpeningPlies + Config.MaxPlies);
+
+    PackedBoard Position;
+    PlayOpening(Rules, Config, Game.Index / 2, Position, Game.Moves);
+
+    // hashes since the last capture or pawn move, only those positions can repeat
+    TArray<uint64> History;
+    History.Reserve(Config.FiftyMovePlies + 1);
+    History.Add(Position.hash);
+
+    FMinimaxRequest Request;
+    Request.ThreadCount = FMath::Max(Config.ThreadsPerGame, 1);
+
+    MoveList Moves;
+    for (int32 Ply = 0; ; Ply++)
+    {
+        const bool IsWhiteToMove = !Position.black_to_move;
+        const Cell::PieceColor SideToMove = IsWhiteToMove ? Cell::PieceColor::white : Cell::PieceColor::black;
+        Rules.generate_legal_moves(Position, SideToMove, Moves);
+        if (Moves.empty())
+        {
+            const int32 King = Position.get_king_cell(SideToMove);
+            const bool IsInCheck = King >= 0 && Rules.is_attacked(Position, King, IsWhiteToMove ? Cell::PieceColor::black : Cell::PieceColor::white);
+            // Glinski scores a stalemate 3/4 for the stalemating side, this runner keeps to whole and half points and calls it a draw
+            Game.Ending = IsInCheck ? ESelfPlayEnding::Checkmate : ESelfPlayEnding::Stalemate;
+            Game.Outcome = !IsInCheck ? ESelfPlayOutcome::Draw : IsWhiteToMove ? ESelfPlayOutcome::BlackWins : ESelfPlayOutcome::WhiteWins;
+            break;
+        }
+        if (Ply >= Config.MaxPlies)
+        {
+            Game.Ending = ESelfPlayEnding::MaxPlies;
+            break;
+        }
+        if (History.Num() > Config.FiftyMovePlies)
+        {
+            Game.Ending = ESelfPlayEnding::FiftyMoves;
+            break;
+        }
+        int32 Repeats = 0;
+        for (int32 Index = History.Num() - 1; Index >= 0; Index -= 2)
+        {
+            Repeats += History[Index] == Position.hash ? 1 : 0;
+        }
+        if (Repeats >= 3)
+        {
+            Game.Ending = ESelfPlayEnding::Repetition;
+            break;
+        }
+
+        // the same request MakeAIMove builds for a difficulty, on this game's own search
+        const bool IsPlayerA = IsWhiteToMove == Game.IsPlayerAWhite;
+        const FSelfPlayPlayer& Player = IsPlayerA ? PlayerA : PlayerB;
+        FMinimaxSearch& Search = IsPlayerA ? SearchA : SearchB;
+        Request.Position = Position;
+        Request.IsWhiteAI = IsWhiteToMove;
+        Request.MaxDepth = Player.MaxDepth;
+        Request.TimeBudgetMs = Player.TimeBudgetMs;
+        Request.NodeBudget = Player.NodeBudget;
+        Request.UseSplitPoints = Player.UseSplitPoints;
+        Request.Evaluation = Player.Evaluation;
+        Request.Tablebase = Player.Tablebase;
+        Request.Settings = Player.Settings;
+        // every position but the current one, with the same fifty-move limit the runner ends the game at
+        Request.History.Reset();
+        Request.History.Append(History.GetData(), History.Num() - 1);
+        Request.FiftyMovePlies = Config.FiftyMovePlies;
+        const FMinimaxResult Result = Search.Run(Request, IsCancelled);
+        if (!Result.IsComplete)
+        {
+            return;
+        }
+
+        const int32 From = PackedBoard::to_index(Result.Move.FromKey);
+        const int32 To = PackedBoard::to_index(Result.Move.ToKey);
+        const bool IsIrreversible = Position.get_square(To).has_piece() || Position.get_square(From).get_piece_type() == Cell::PieceType::pawn;
+        Position.make_move(From, To);
+        Game.Moves.Emplace(Result.Move.FromKey, Result.Move.ToKey);
+        Game.Plies = Ply + 1;
+        if (IsIrreversible)
+        {
+            History.Reset();
+        }
+        History.Add(Position.hash);
+    }
+
+    Game.Seconds = FPlatformTime::Seconds() - StartTime;
+}
@@ -0,0 +1,757 @@
+#include "Search/Tablebase.h"
+
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    constexpr int32 CellCount = PackedBoard::cell_count;
+
+    // the cell on the other side of the board's middle row, where black's pieces stand when the colors are swapped
+    struct FMirrorTable
+    {
+        int32 Cells[CellCount] = {};
+
+        FMirrorTable()
+        {
+            for (int32 Index = 0; Index < CellCount; Index++)
+            {
+                const int32 Key = PackedBoard::to_key(Index);
+                const int32 X = Key >> 8;
+                const int32 Y = Key & 0xFF;
+                Cells[Index] = PackedBoard::to_index((X << 8) + hex_column_height(X) - 1 - Y);
+            }
+        }
+    };
+
+    const FMirrorTable MirrorTable;
+
+    // white before black, then kings first and pawns last, the order pieces have in a table index
+    bool IsBefore(const Cell::PieceColor ColorA, const Cell::PieceType TypeA, const Cell::PieceColor ColorB, const Cell::PieceType TypeB)
+    {
+        return ColorA != ColorB ? ColorA == Cell::PieceColor::white : TypeA > TypeB;
+    }
+
+    Cell::PieceColor GetOtherColor(const Cell::PieceColor Color)
+    {
+        return Color == Cell::PieceColor::white ? Cell::PieceColor::black : Cell::PieceColor::white;
+    }
+
+    const TCHAR* GetPieceLetter(const Cell::PieceType Type)
+    {
+        switch (Type)
+        {
+        case Cell::PieceType::king:
+            return TEXT("K");
+        case Cell::PieceType::queen:
+            return TEXT("Q");
+        case Cell::PieceType::rook:
+            return TEXT("R");
+        case Cell::PieceType::bishop:
+            return TEXT("B");
+        case Cell::PieceType::knight:
+            return TEXT("N");
+        default:
+            return TEXT("P");
+        }
+    }
+
+    // entries one pass of the generator hands to a task at a time
+    constexpr int64 GenerationChunk = 16384;
+
+    const TCHAR* const FileExtensions[2] = {TEXT(".hxwdl"), TEXT(".hxdtm")};
+}
+
+static void SortPieces(FTablebaseMaterial& Material)
+{
+    for (int32 i = 1; i < Material.PieceCount; i++)
+    {
+        for (int32 j = i; j > 0 && IsBefore(Material.Colors[j], Material.Types[j], Material.Colors[j - 1], Material.Types[j - 1]); j--)
+        {
+            Swap(Material.Types[j], Material.Types[j - 1]);
+            Swap(Material.Colors[j], Material.Colors[j - 1]);
+        }
+    }
+}
+
+bool FTablebaseMaterial::Parse(const FString& Name, FTablebaseMaterial& OutMaterial)
+{
+    OutMaterial = FTablebaseMaterial();
+    Cell::PieceColor Color = Cell::PieceColor::white;
+    int32 Kings[3] = {};
+    for (const TCHAR Letter : Name)
+    {
+        if (Letter == TEXT('v') && Color == Cell::PieceColor::white)
+        {
+            Color = Cell::PieceColor::black;
+            continue;
+        }
+        Cell::PieceType Type = Cell::PieceType::none;
+        switch (Letter)
+        {
+        case TEXT('K'):
+            Type = Cell::PieceType::king;
+            break;
+        case TEXT('Q'):
+            Type = Cell::PieceType::queen;
+            break;
+        case TEXT('R'):
+            Type = Cell::PieceType::rook;
+            break;
+        case TEXT('B'):
+            Type = Cell::PieceType::bishop;
+            break;
+        case TEXT('N'):
+            Type = Cell::PieceType::knight;
+            break;
+        case TEXT('P'):
+            Type = Cell::PieceType::pawn;
+            break;
+        default:
+            return false;
+        }
+        if (OutMaterial.PieceCount == MaxPieces)
+        {
+            return false;
+        }
+        Kings[Color] += Type == Cell::PieceType::king ? 1 : 0;
+        OutMaterial.Types[OutMaterial.PieceCount] = Type;
+        OutMaterial.Colors[OutMaterial.PieceCount] = Color;
+        OutMaterial.PieceCount++;
+    }
+    SortPieces(OutMaterial);
+    return Color == Cell::PieceColor::black && Kings[Cell::PieceColor::white] == 1 && Kings[Cell::PieceColor::black] == 1;
+}
+
+bool FTablebaseMaterial::FromPosition(const PackedBoard& Position, FTablebaseMaterial& OutMaterial, bool& OutIsFlipped)
+{
+    FTablebaseMaterial Material;
+    Material.PieceCount = Position.piece_count[0] + Position.piece_count[1];
+    if (Material.PieceCount > MaxPieces)
+    {
+        return false;
+    }
+    int32 Piece = 0;
+    for (int32 Side = 0; Side < 2; Side++)
+    {
+        for (int32 Slot = 0; Slot < Position.piece_count[Side]; Slot++)
+        {
+            const Square Occupant = Position.cells[Position.piece_cells[Side][Slot]];
+            Material.Types[Piece] = Occupant.get_piece_type();
+            Material.Colors[Piece] = Occupant.get_piece_color();
+            Piece++;
+        }
+    }
+    SortPieces(Material);
+    OutMaterial = Material.GetCanonical(OutIsFlipped);
+    return true;
+}
+
+FTablebaseMaterial FTablebaseMaterial::GetCanonical(bool& OutIsFlipped) const
+{
+    // the side with more pieces is the stronger one; with as many pieces, the one whose strongest differing piece is stronger
+    int32 Counts[3] = {};
+    Cell::PieceType Sides[3][MaxPieces] = {};
+    for (int32 Piece = 0; Piece < PieceCount; Piece++)
+    {
+        Sides[Colors[Piece]][Counts[Colors[Piece]]++] = Types[Piece];
+    }
+    const int32 White = Cell::PieceColor::white;
+    const int32 Black = Cell::PieceColor::black;
+    OutIsFlipped = Counts[Black] > Counts[White];
+    if (Counts[Black] == Counts[White])
+    {
+        for (int32 Piece = 0; Piece < Counts[White]; Piece++)
+        {
+            if (Sides[White][Piece] != Sides[Black][Piece])
+            {
+                OutIsFlipped = Sides[Black][Piece] > Sides[White][Piece];
+                break;
+            }
+        }
+    }
+
+    FTablebaseMaterial Result = *this;
+    if (OutIsFlipped)
+    {
+        for (int32 Piece = 0; Piece < PieceCount; Piece++)
+        {
+            Result.Colors[Piece] = GetOtherColor(Colors[Piece]);
+        }
+        SortPieces(Result);
+    }
+    return Result;
+}
+
+TArray<FTablebaseMaterial> FTablebaseMaterial::GetCaptures() const
+{
+    TArray<FTablebaseMaterial> Captures;
+    for (int32 Captured = 0; Captured < PieceCount; Captured++)
+    {
+        if (Types[Captured] == Cell::PieceType::king)
+        {
+            continue;
+        }
+        FTablebaseMaterial& Child = Captures.AddDefaulted_GetRef();
+        for (int32 Piece = 0; Piece < PieceCount; Piece++)
+        {
+            if (Piece != Captured)
+            {
+                Child.Types[Child.PieceCount] = Types[Piece];
+                Child.Colors[Child.PieceCount] = Colors[Piece];
+                Child.PieceCount++;
+            }
+        }
+    }
+    return Captures;
+}
+
+FString FTablebaseMaterial::GetName() const
+{
+    FString Name;
+    for (int32 Piece = 0; Piece < PieceCount; Piece++)
+    {
+        if (Piece > 0 && Colors[Piece] != Colors[Piece - 1])
+        {
+            Name += TEXT("v");
+        }
+        Name += GetPieceLetter(Types[Piece]);
+    }
+    return Name;
+}
+
+uint32 FTablebaseMaterial::GetKey() const
+{
+    uint32 Key = static_cast<uint32>(PieceCount) << 28;
+    for (int32 Piece = 0; Piece < PieceCount; Piece++)
+    {
+        const uint32 Code = (Colors[Piece] == Cell::PieceColor::black ? 8 : 0) | Types[Piece];
+        Key |= Code << (4 * Piece);
+    }
+    return Key;
+}
+
+int64 FTablebaseMaterial::GetPositionCount() const
+{
+    int64 Count = 2;
+    for (int32 Piece = 0; Piece < PieceCount; Piece++)
+    {
+        Count *= CellCount;
+    }
+    return Count;
+}
+
+int64 FTablebaseMaterial::GetIndex(const PackedBoard& Position, const bool IsFlipped) const
+{
+    // the position's pieces in table order, with the colors swapped and the board mirrored for a flipped lookup
+    Cell::PieceColor PieceColors[MaxPieces];
+    Cell::PieceType PieceTypes[MaxPieces];
+    int32 PieceCells[MaxPieces];
+    int32 Count = 0;
+    for (int32 Side = 0; Side < 2; Side++)
+    {
+        for (int32 Slot = 0; Slot < Position.piece_count[Side] && Count < MaxPieces; Slot++)
+        {
+            const int32 Index = Position.piece_cells[Side][Slot];
+            const Square Occupant = Position.cells[Index];
+            PieceColors[Count] = IsFlipped ? GetOtherColor(Occupant.get_piece_color()) : Occupant.get_piece_color();
+            PieceTypes[Count] = Occupant.get_piece_type();
+            PieceCells[Count] = IsFlipped ? MirrorTable.Cells[Index] : Index;
+            for (int32 j = Count; j > 0 && IsBefore(PieceColors[j], PieceTypes[j], PieceColors[j - 1], PieceTypes[j - 1]); j--)
+            {
+                Swap(PieceColors[j], PieceColors[j - 1]);
+                Swap(PieceTypes[j], PieceTypes[j - 1]);
+                Swap(PieceCells[j], PieceCells[j - 1]);
+            }
+            Count++;
+        }
+    }
+
+    int64 Result = Position.black_to_move != IsFlipped ? 1 : 0;
+    for (int32 Piece = 0; Piece < Count; Piece++)
+    {
+        Result = Result * CellCount + PieceCells[Piece];
+    }
+    return Result;
+}
+
+bool FTablebaseMaterial::GetPosition(int64 Index, PackedBoard& OutPosition) const
+{
+    int32 PieceCells[MaxPieces];
+    for (int32 Piece = PieceCount - 1; Piece >= 0; Piece--)
+    {
+        PieceCells[Piece] = static_cast<int32>(Index % CellCount);
+        Index /= CellCount;
+        for (int32 Other = Piece + 1; Other < PieceCount; Other++)
+        {
+            if (PieceCells[Other] == PieceCells[Piece])
+            {
+                return false;
+            }
+        }
+    }
+
+    OutPosition = PackedBoard();
+    for (int32 Piece = 0; Piece < PieceCount; Piece++)
+    {
+        OutPosition.set_cell(PieceCells[Piece], Types[Piece], Colors[Piece]);
+    }
+    if (Index == 1)
+    {
+        OutPosition.flip_side_to_move();
+    }
+    return true;
+}
+
+FTablebase::~FTablebase()
+{
+    for (int32 Kind = 0; Kind < 2; Kind++)
+    {
+        for (const TPair<uint32, FTableFile*>& Pair : Files[Kind])
+        {
+            delete Pair.Value->MappedRegion;
+            delete Pair.Value->MappedFile;
+            delete Pair.Value;
+        }
+    }
+}
+
+int32 FTablebase::Open(const FString& Directory)
+{
+    TSet<uint32> Materials;
+    for (uint32 Kind = 0; Kind < 2; Kind++)
+    {
+        TArray<FString> Names;
+        IFileManager::Get().FindFiles(Names, *(Directory / FString(TEXT("*")) + FileExtensions[Kind]), true, false);
+        for (const FString& Name : Names)
+        {
+            FTablebaseMaterial Material;
+            if (!FTablebaseMaterial::Parse(FPaths::GetBaseFilename(Name), Material) || Files[Kind].Contains(Material.GetKey()))
+            {
+                continue;
+            }
+            FTableFile* File = new FTableFile();
+            File->Path = Directory / Name;
+            Files[Kind].Add(Material.GetKey(), File);
+            Materials.Add(Material.GetKey());
+            MaxPieces = FMath::Max(MaxPieces, Material.PieceCount);
+        }
+    }
+    return Materials.Num();
+}
+
+FString FTablebase::GetFileName(const FTablebaseMaterial& Material, const uint32 Kind)
+{
+    return Material.GetName() + FileExtensions[Kind];
+}
+
+bool FTablebase::EnsureOpen(FTableFile& File) const
+{
+    const int32 State = File.State.load(std::memory_order_acquire);
+    if (State != 0)
+    {
+        return State > 0;
+    }
+
+    FScopeLock Lock(&File.OpenLock);
+    if (File.State.load(std::memory_order_relaxed) != 0)
+    {
+        return File.State.load(std::memory_order_relaxed) > 0;
+    }
+
+    // a file inside a compressed pak cannot be mapped, it is read once instead
+    File.MappedFile = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*File.Path);
+    if (File.MappedFile != nullptr)
+    {
+        File.MappedRegion = File.MappedFile->MapRegion(0, File.MappedFile->GetFileSize());
+    }
+    if (File.MappedRegion != nullptr)
+    {
+        File.Data = File.MappedRegion->GetMappedPtr();
+        File.Size = File.MappedRegion->GetMappedSize();
+    }
+    else if (FFileHelper::LoadFileToArray(File.LoadedFile, *File.Path, FILEREAD_Silent))
+    {
+        File.Data = File.LoadedFile.GetData();
+        File.Size = File.LoadedFile.Num();
+    }
+
+    bool IsUsable = File.Data != nullptr && File.Size >= static_cast<int64>(sizeof(FTablebaseFileHeader));
+    if (IsUsable)
+    {
+        FMemory::Memcpy(&File.Header, File.Data, sizeof(FTablebaseFileHeader));
+        const int64 OffsetsEnd = sizeof(FTablebaseFileHeader) + (static_cast<int64>(File.Header.BlockCount) + 1) * sizeof(uint64);
+        IsUsable = File.Header.Magic == FTablebaseFileHeader::FileMagic && File.Header.Version == FTablebaseFileHeader::FileVersion
+            && File.Header.UncompressedBlockSize == FTablebaseFileHeader::BlockSize && File.Size >= OffsetsEnd;
+        if (IsUsable)
+        {
+            File.BlockOffsets = reinterpret_cast<const uint64*>(File.Data + sizeof(FTablebaseFileHeader));
+            IsUsable = File.BlockOffsets[File.Header.BlockCount] <= static_cast<uint64>(File.Size);
+        }
+    }
+    if (!IsUsable)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Tablebase: %s is not a version %u table"), *File.Path, FTablebaseFileHeader::FileVersion);
+    }
+    File.State.store(IsUsable ? 1 : -1, std::memory_order_release);
+    return IsUsable;
+}
+
+int32 FTablebase::Prefetch() const
+{
+    const int64 PageSize = FPlatformMemory::GetConstants().PageSize;
+    int32 UsableCount = 0;
+    uint8 Sum = 0;
+    for (uint32 Kind = 0; Kind < 2; Kind++)
+    {
+        for (const TPair<uint32, FTableFile*>& Pair : Files[Kind])
+        {
+            FTableFile& File = *Pair.Value;
+            if (!EnsureOpen(File))
+            {
+                continue;
+            }
+            UsableCount++;
+            const uint8* Offsets = reinterpret_cast<const uint8*>(File.BlockOffsets);
+            const int64 OffsetsSize = (static_cast<int64>(File.Header.BlockCount) + 1) * sizeof(uint64);
+            for (int64 Offset = 0; Offset < OffsetsSize; Offset += PageSize)
+            {
+                Sum += Offsets[Offset];
+            }
+        }
+    }
+    // a load the compiler can see no use of would not fault the page in
+    volatile uint8 Sink = Sum;
+    (void)Sink;
+    return UsableCount;
+}
+
+const uint8* FTablebase::GetBlock(FTableFile& File, const uint32 Kind, const int64 Block, FTablebaseCache& Cache) const
+{
+    if (Cache.Keys[Kind] == File.Header.MaterialKey && Cache.Blocks[Kind] == Block)
+    {
+        return Cache.Data[Kind].GetData();
+    }
+    if (Block >= File.Header.BlockCount)
+    {
+        return nullptr;
+    }
+
+    const int64 EntryBytes = Kind == 0 ? (static_cast<int64>(File.Header.PositionCount) + 3) / 4 : static_cast<int64>(File.Header.PositionCount) * 2;
+    const int32 UncompressedSize = static_cast<int32>(FMath::Min<int64>(FTablebaseFileHeader::BlockSize, EntryBytes - Block * FTablebaseFileHeader::BlockSize));
+    const uint64 Offset = File.BlockOffsets[Block];
+    const int32 CompressedSize = static_cast<int32>(File.BlockOffsets[Block + 1] - Offset);
+    // sized once per thread, every block fits
+    Cache.Data[Kind].SetNumUninitialized(FTablebaseFileHeader::BlockSize, false);
+    Cache.Blocks[Kind] = -1;
+    if (!FCompression::UncompressMemory(NAME_Zlib, Cache.Data[Kind].GetData(), UncompressedSize, File.Data + Offset, CompressedSize))
+    {
+        return nullptr;
+    }
+    Cache.Keys[Kind] = File.Header.MaterialKey;
+    Cache.Blocks[Kind] = Block;
+    return Cache.Data[Kind].GetData();
+}
+
+bool FTablebase::Probe(const PackedBoard& Position, const uint32 Kind, FTablebaseCache& Cache, FTablebaseProbe& OutProbe) const
+{
+    FTablebaseMaterial Material;
+    bool IsFlipped = false;
+    if (Position.piece_count[0] + Position.piece_count[1] > MaxPieces || !FTablebaseMaterial::FromPosition(Position, Material, IsFlipped))
+    {
+        return false;
+    }
+    FTableFile* const* File = Files[Kind].Find(Material.GetKey());
+    if (File == nullptr || !EnsureOpen(**File))
+    {
+        return false;
+    }
+
+    const int64 Index = Material.GetIndex(Position, IsFlipped);
+    const int64 Byte = Kind == 0 ? Index / 4 : Index * 2;
+    const uint8* Block = GetBlock(**File, Kind, Byte / FTablebaseFileHeader::BlockSize, Cache);
+    if (Block == nullptr)
+    {
+        return false;
+    }
+    const int64 Offset = Byte % FTablebaseFileHeader::BlockSize;
+
+    if (Kind == 0)
+    {
+        const uint8 Code = (Block[Offset] >> ((Index & 3) * 2)) & 3;
+        if (Code == 3)
+        {
+            return false;
+        }
+        OutProbe.Wdl = Code == 1 ? ETablebaseWdl::Win : Code == 2 ? ETablebaseWdl::Loss : ETablebaseWdl::Draw;
+        OutProbe.PliesToMate = 0;
+        return true;
+    }
+
+    const uint16 Value = static_cast<uint16>(Block[Offset] | (Block[Offset + 1] << 8));
+    if (Value == TablebaseValue::Invalid || Value == TablebaseValue::Unresolved)
+    {
+        return false;
+    }
+    OutProbe.Wdl = TablebaseValue::IsWin(Value) ? ETablebaseWdl::Win : TablebaseValue::IsLoss(Value) ? ETablebaseWdl::Loss : ETablebaseWdl::Draw;
+    OutProbe.PliesToMate = TablebaseValue::IsDecided(Value) ? TablebaseValue::GetPliesToMate(Value) : 0;
+    return true;
+}
+
+bool FTablebase::ProbeWdl(const PackedBoard& Position, FTablebaseCache& Cache, FTablebaseProbe& OutProbe) const
+{
+    return Probe(Position, 0, Cache, OutProbe);
+}
+
+bool FTablebase::ProbeDtm(const PackedBoard& Position, FTablebaseCache& Cache, FTablebaseProbe& OutProbe) const
+{
+    return Probe(Position, 1, Cache, OutProbe);
+}
+
+bool FTablebase::WriteFile(const FString& Path, const FTablebaseMaterial& Material, const uint32 Kind, const TArray<uint8>& Bytes, const uint32 MaxPliesToMate)
+{
+    FTablebaseFileHeader Header;
+    Header.Kind = Kind;
+    Header.MaterialKey = Material.GetKey();
+    Header.PositionCount = Material.GetPositionCount();
+    Header.BlockCount = static_cast<uint32>((Bytes.Num() + FTablebaseFileHeader::BlockSize - 1) / FTablebaseFileHeader::BlockSize);
+    Header.MaxPliesToMate = MaxPliesToMate;
+
+    TArray<uint64> Offsets;
+    Offsets.SetNumZeroed(Header.BlockCount + 1);
+    TArray<uint8> Blocks;
+    TArray<uint8> Compressed;
+    const int64 DataStart = sizeof(Header) + Offsets.Num() * sizeof(uint64);
+    for (uint32 Block = 0; Block < Header.BlockCount; Block++)
+    {
+        const int32 Start = Block * FTablebaseFileHeader::BlockSize;
+        const int32 Size = FMath::Min<int32>(FTablebaseFileHeader::BlockSize, Bytes.Num() - Start);
+        int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Size);
+        Compressed.SetNumUninitialized(CompressedSize, false);
+        if (!FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Bytes.GetData() + Start, Size))
+        {
+            return false;
+        }
+        Offsets[Block] = DataStart + Blocks.Num();
+        Blocks.Append(Compressed.GetData(), CompressedSize);
+    }
+    Offsets[Header.BlockCount] = DataStart + Blocks.Num();
+
+    TArray<uint8> FileBytes;
+    FileBytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+    FileBytes.Append(reinterpret_cast<const uint8*>(Offsets.GetData()), Offsets.Num() * sizeof(uint64));
+    FileBytes.Append(Blocks);
+    return FFileHelper::SaveArrayToFile(FileBytes, *Path);
+}
+
+uint16 FTablebaseGenerator::GetChildValue(const FTablebaseMaterial& Material, const TArray<uint16>& Values, const PackedBoard& Child) const
+{
+    // a quiet move stays in the material being generated, a capture lands in a smaller one generated before it
+    if (Child.piece_count[0] + Child.piece_count[1] == Material.PieceCount)
+    {
+        return Values[Material.GetIndex(Child, false)];
+    }
+    FTablebaseMaterial ChildMaterial;
+    bool IsFlipped = false;
+    FTablebaseMaterial::FromPosition(Child, ChildMaterial, IsFlipped);
+    const TArray<uint16>& ChildValues = Tables.FindChecked(ChildMaterial.GetKey());
+    return ChildValues[ChildMaterial.GetIndex(Child, IsFlipped)];
+}
+
+void FTablebaseGenerator::Generate(const FTablebaseMaterial& InMaterial, const TFunction<void(const FString&, int32, int64)>& OnPass)
+{
+    bool IsFlipped = false;
+    const FTablebaseMaterial Material = InMaterial.GetCanonical(IsFlipped);
+    if (Tables.Contains(Material.GetKey()))
+    {
+        return;
+    }
+
+    // every capture leads to a material with one piece less
+    int32 MaxChildPlies = 0;
+    for (const FTablebaseMaterial& Child : Material.GetCaptures())
+    {
+        Generate(Child, OnPass);
+        int64 Wins = 0;
+        int64 Draws = 0;
+        int64 Losses = 0;
+        int32 ChildPlies = 0;
+        GetCounts(Child.GetCanonical(IsFlipped), Wins, Draws, Losses, ChildPlies);
+        MaxChildPlies = FMath::Max(MaxChildPlies, ChildPlies);
+    }
+
+    const int64 PositionCount = Material.GetPositionCount();
+    const int32 ChunkCount = static_cast<int32>((PositionCount + GenerationChunk - 1) / GenerationChunk);
+    TArray<uint16> Values;
+    Values.SetNumUninitialized(static_cast<int32>(PositionCount));
+    std::atomic<int64> Decided{0};
+
+    // mates and stalemates; a position where the side not to move stands in check can never be reached
+    ParallelFor(ChunkCount, [&](int32 Chunk)
+    {
+        int64 ChunkDecided = 0;
+        PackedBoard Position;
+        MoveList Moves;
+        const int64 End = FMath::Min(PositionCount, (Chunk + 1) * GenerationChunk);
+        for (int64 Index = Chunk * GenerationChunk; Index < End; Index++)
+        {
+            if (!Material.GetPosition(Index, Position))
+            {
+                Values[Index] = TablebaseValue::Invalid;
+                continue;
+            }
+            const Cell::PieceColor SideToMove = Position.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white;
+            const Cell::PieceColor Opponent = GetOtherColor(SideToMove);
+            if (Rules.is_attacked(Position, Position.get_king_cell(Opponent), SideToMove))
+            {
+                Values[Index] = TablebaseValue::Invalid;
+                continue;
+            }
+            Rules.generate_legal_moves(Position, SideToMove, Moves);
+            if (!Moves.empty())
+            {
+                Values[Index] = TablebaseValue::Unresolved;
+                continue;
+            }
+            const bool IsInCheck = Rules.is_attacked(Position, Position.get_king_cell(SideToMove), Opponent);
+            Values[Index] = IsInCheck ? TablebaseValue::FromPliesToMate(0) : TablebaseValue::Draw;
+            ChunkDecided++;
+        }
+        Decided += ChunkDecided;
+    });
+    if (OnPass)
+    {
+        OnPass(Material.GetName(), 0, Decided.load());
+    }
+
+    // pass n decides the wins in n plies (a move to a loss in n - 1) and the losses in n plies (every move to a win in at most n - 1)
+    // a pass reads the previous pass's values and writes the next ones, so the tasks never see each other's writes
+    TArray<uint16> NextValues = Values;
+    for (int32 Plies = 1; ; Plies++)
+    {
+        std::atomic<int64> PassDecided{0};
+        ParallelFor(ChunkCount, [&](int32 Chunk)
+        {
+            int64 ChunkDecided = 0;
+            PackedBoard Position;
+            MoveList Moves;
+            const int64 End = FMath::Min(PositionCount, (Chunk + 1) * GenerationChunk);
+            for (int64 Index = Chunk * GenerationChunk; Index < End; Index++)
+            {
+                if (Values[Index] != TablebaseValue::Unresolved)
+                {
+                    continue;
+                }
+                Material.GetPosition(Index, Position);
+                Rules.generate_legal_moves(Position, Position.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white, Moves);
+                bool IsWin = false;
+                bool IsLoss = true;
+                for (const Move& Candidate : Moves)
+                {
+                    const UndoRecord Undo = Position.make_move(Candidate.from, Candidate.to);
+                    const uint16 ChildValue = GetChildValue(Material, Values, Position);
+                    Position.unmake_move(Undo);
+                    if (TablebaseValue::IsLoss(ChildValue) && TablebaseValue::GetPliesToMate(ChildValue) == Plies - 1)
+                    {
+                        IsWin = true;
+                        break;
+                    }
+                    IsLoss = IsLoss && TablebaseValue::IsWin(ChildValue) && TablebaseValue::GetPliesToMate(ChildValue) <= Plies - 1;
+                }
+                if (IsWin || IsLoss)
+                {
+                    NextValues[Index] = TablebaseValue::FromPliesToMate(Plies);
+                    ChunkDecided++;
+                }
+            }
+            PassDecided += ChunkDecided;
+        });
+        Values = NextValues;
+        Decided += PassDecided.load();
+        if (OnPass)
+        {
+            OnPass(Material.GetName(), Plies, Decided.load());
+        }
+        // a capture can still lead to a mate later than anything decided so far, so stop only past the smaller tables' longest mate
+        if (PassDecided.load() == 0 && Plies > MaxChildPlies + 1)
+        {
+            break;
+        }
+    }
+
+    // nothing forces a mate from what is left
+    for (uint16& Value : Values)
+    {
+        if (Value == TablebaseValue::Unresolved)
+        {
+            Value = TablebaseValue::Draw;
+        }
+    }
+    Tables.Add(Material.GetKey(), MoveTemp(Values));
+}
+
+const TArray<uint16>* FTablebaseGenerator::Find(const FTablebaseMaterial& Material) const
+{
+    return Tables.Find(Material.GetKey());
+}
+
+void FTablebaseGenerator::GetCounts(const FTablebaseMaterial& Material, int64& OutWins, int64& OutDraws, int64& OutLosses, int32& OutMaxPliesToMate) const
+{
+    OutWins = 0;
+    OutDraws = 0;
+    OutLosses = 0;
+    OutMaxPliesToMate = 0;
+    const TArray<uint16>* Values = Find(Material);
+    if (Values == nullptr)
+    {
+        return;
+    }
+    for (const uint16 Value : *Values)
+    {
+        OutWins += TablebaseValue::IsWin(Value) ? 1 : 0;
+        OutLosses += TablebaseValue::IsLoss(Value) ? 1 : 0;
+        OutDraws += Value == TablebaseValue::Draw ? 1 : 0;
+        if (TablebaseValue::IsDecided(Value))
+        {
+            OutMaxPliesToMate = FMath::Max(OutMaxPliesToMate, TablebaseValue::GetPliesToMate(Value));
+        }
+    }
+}
+
+bool FTablebaseGenerator::Write(const FTablebaseMaterial& InMaterial, const FString& Directory) const
+{
+    bool IsFlipped = false;
+    const FTablebaseMaterial Material = InMaterial.GetCanonical(IsFlipped);
+    const TArray<uint16>* Values = Find(Material);
+    if (Values == nullptr)
+    {
+        return false;
+    }
+
+    TArray<uint8> WdlBytes;
+    WdlBytes.SetNumZeroed((Values->Num() + 3) / 4);
+    TArray<uint8> DtmBytes;
+    DtmBytes.SetNumUninitialized(Values->Num() * 2);
+    int32 MaxPliesToMate = 0;
+    for (int64 Index = 0; Index < Values->Num(); Index++)
+    {
+        const uint16 Value = (*Values)[Index];
+        const uint8 Code = Value == TablebaseValue::Invalid ? 3 : TablebaseValue::IsWin(Value) ? 1 : TablebaseValue::IsLoss(Value) ? 2 : 0;
+        WdlBytes[Index / 4] |= Code << ((Index & 3) * 2);
+        DtmBytes[Index * 2] = static_cast<uint8>(Value & 0xFF);
+        DtmBytes[Index * 2 + 1] = static_cast<uint8>(Value >> 8);
+        if (TablebaseValue::IsDecided(Value))
+        {
+            MaxPliesToMate = FMath::Max(MaxPliesToMate, TablebaseValue::GetPliesToMate(Value));
+        }
+    }
+
+    return FTablebase::WriteFile(Directory / FTablebase::GetFileName(Material, 0), Material, 0, WdlBytes, MaxPliesToMate)
+        && FTablebase::WriteFile(Directory / FTablebase::GetFileName(Material, 1), Material, 1, DtmBytes, MaxPliesToMate);
+}
@@ -0,0 +1,525 @@
+#pragma once
+
+#include <bit>
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @brief 128-bit set of cells, bit i is the cell with dense index i (0..90).
+ */
+struct Bitboard128 {
+    uint64 lo = 0;
+    uint64 hi = 0;
+
+    Bitboard128() {}
+    Bitboard128(uint64 lo, uint64 hi): lo(lo), hi(hi) {}
+
+    static inline Bitboard128 from_index(const int32 index) {
+        return index < 64 ? Bitboard128(uint64(1) << index, 0) : Bitboard128(0, uint64(1) << (index - 64));
+    }
+
+    inline Bitboard128 operator&(const Bitboard128& other) const { return Bitboard128(lo & other.lo, hi & other.hi); }
+    inline Bitboard128 operator|(const Bitboard128& other) const { return Bitboard128(lo | other.lo, hi | other.hi); }
+    inline Bitboard128 operator^(const Bitboard128& other) const { return Bitboard128(lo ^ other.lo, hi ^ other.hi); }
+    inline Bitboard128 operator~() const { return Bitboard128(~lo, ~hi); }
+    inline Bitboard128& operator&=(const Bitboard128& other) { lo &= other.lo; hi &= other.hi; return *this; }
+    inline Bitboard128& operator|=(const Bitboard128& other) { lo |= other.lo; hi |= other.hi; return *this; }
+    inline Bitboard128& operator^=(const Bitboard128& other) { lo ^= other.lo; hi ^= other.hi; return *this; }
+    inline bool operator==(const Bitboard128& other) const { return lo == other.lo && hi == other.hi; }
+
+    inline bool empty() const { return (lo | hi) == 0; }
+    inline bool test(const int32 index) const { return !(*this & from_index(index)).empty(); }
+    inline void set(const int32 index) { *this |= from_index(index); }
+    inline void reset(const int32 index) { *this &= ~from_index(index); }
+
+    inline int32 count() const {
+        return std::popcount(lo) + std::popcount(hi);
+    }
+
+    // index of the lowest set bit, the board must not be empty
+    inline int32 lsb() const {
+        return lo != 0 ? std::countr_zero(lo) : 64 + std::countr_zero(hi);
+    }
+
+    // index of the highest set bit, the board must not be empty
+    inline int32 msb() const {
+        return hi != 0 ? 127 - std::countl_zero(hi) : 63 - std::countl_zero(lo);
+    }
+
+    inline int32 pop_lsb() {
+        const int32 index = lsb();
+        reset(index);
+        return index;
+    }
+};
+
+/**
+ * @brief Attack masks for every cell, derived once from Board::move_tables().
+ *
+ * Cell indices increase with x and, inside a column, with y, so every hex ray is monotonic in index.
+ * That lets slider attacks use the classical "ray minus ray behind the first blocker" lookup.
+ */
+struct BitboardTables {
+    Bitboard128 king[HexIndexTable::cell_count];
+    Bitboard128 knight[HexIndexTable::cell_count];
+    Bitboard128 rays[HexIndexTable::cell_count][HexMoveTables::direction_count];
+    bool ray_increasing[HexMoveTables::direction_count] = {};
+
+    // pawn_takes[side][cell] are the cells a pawn of that side attacks,
+    // pawn_attackers[side][cell] the cells a pawn of that side attacks the cell from
+    Bitboard128 pawn_takes[2][HexIndexTable::cell_count];
+    Bitboard128 pawn_attackers[2][HexIndexTable::cell_count];
+
+    static const BitboardTables& get() {
+        static const BitboardTables tables = build();
+        return tables;
+    }
+
+private:
+    static BitboardTables build() {
+        const HexMoveTables& moves = Board::move_tables();
+        BitboardTables tables;
+        for (int32 index = 0; index < HexIndexTable::cell_count; index++) {
+            for (const int8* target = moves.king_targets[index]; *target != HexMoveTables::sentinel; target++) {
+                tables.king[index].set(*target);
+            }
+            for (const int8* target = moves.knight_targets[index]; *target != HexMoveTables::sentinel; target++) {
+                tables.knight[index].set(*target);
+            }
+            for (int32 direction = 0; direction < HexMoveTables::direction_count; direction++) {
+                const int8* ray = moves.rays[index][direction];
+                for (const int8* target = ray; *target != HexMoveTables::sentinel; target++) {
+                    tables.rays[index][direction].set(*target);
+                }
+                if (ray[0] != HexMoveTables::sentinel) {
+                    tables.ray_increasing[direction] = ray[0] > index;
+                }
+            }
+            for (int32 side = 0; side < 2; side++) {
+                for (const int8 take : moves.pawn_takes[side][index]) {
+                    if (take != HexMoveTables::sentinel) {
+                        tables.pawn_takes[side][index].set(take);
+                        tables.pawn_attackers[side][take].set(index);
+                    }
+                }
+            }
+        }
+        return tables;
+    }
+};
+
+/**
+ * @class BitboardPosition
+ * @brief Alternative engine core storing the position as 128-bit bitboards.
+ *
+ * Keeps one bitboard per side and piece type plus per-side occupancy, and a packed mailbox for cell lookups.
+ * The mailbox also holds the pawn shadow, hashed like the packed board's, so a pawn may take the jumper en passant.
+ * It answers the same queries as Board (get_valid_moves, can_be_captured, are_there_valid_moves) with set-wise
+ * attack generation instead of generating every enemy move.
+ */
+class BitboardPosition {
+public:
+
+    BitboardPosition() {}
+
+    /**
+     * @brief Loads the position from a packed board.
+     *
+     * @param in_board The packed board to copy.
+     */
+    void load(const PackedBoard& in_board) {
+        *this = BitboardPosition();
+        for (int32 index = 0; index < PackedBoard::cell_count; index++) {
+            Cell cell = in_board.get_cell(index);
+            if (cell.has_piece()) {
+                put_piece(index, cell.get_piece_type(), cell.get_piece_color());
+            }
+        }
+        mailbox.set_white_to_move(!in_board.black_to_move);
+        mailbox.set_shadow(in_board.shadow_cell);
+    }
+
+    /**
+     * @brief Sets a piece at a given position, replacing whatever was there.
+     *
+     * @param pos The position to set the piece at.
+     * @param pt The type of the piece.
+     * @param pc The color of the piece.
+     * @return true if the piece was set successfully, false otherwise.
+     */
+    bool set_piece(Position& pos, Cell::PieceType pt, Cell::PieceColor pc) {
+        const int32 index = PackedBoard::to_index((pos.x << 8) + pos.y);
+        if (index < 0) {
+            return false;
+        }
+        remove_piece(index);
+        if (pt != Cell::PieceType::none && pc != Cell::PieceColor::absent) {
+            put_piece(index, pt, pc);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Moves a piece from a start position to a goal position.
+     *
+     * @param start The start position.
+     * @param goal The goal position.
+     * @return true if the move was successful, false otherwise.
+     */
+    bool move_piece(Position& start, Position& goal) {
+        const int32 from = PackedBoard::to_index((start.x << 8) + start.y);
+        const int32 to = PackedBoard::to_index((goal.x << 8) + goal.y);
+        if (from >= 0 && to >= 0) {
+            make_move(from, to);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Gets a list of valid moves for a given position key.
+     *
+     * @param key The position key for which to generate valid moves.
+     * @param skip_filter Whether to skip the filtering step to check if the move leaves the king in check.
+     * @return A list of valid moves as position keys.
+     */
+    list<int32> get_valid_moves(int32 key, bool skip_filter = false) {
+        list<int32> l = {};
+        const int32 index = PackedBoard::to_index(key);
+        if (index < 0 || !mailbox.get_cell(index).has_piece()) {
+            return l;
+        }
+        const int32 side = side_of(mailbox.get_cell(index).get_piece_color());
+        Bitboard128 targets = get_move_targets(index);
+        while (!targets.empty()) {
+            const int32 to = targets.pop_lsb();
+            if (skip_filter || is_legal(index, to, side)) {
+                l.push_front(PackedBoard::to_key(to));
+            }
+        }
+        return l;
+    }
+
+    /**
+     * @brief Gets a list of valid moves for a given position.
+     *
+     * @param pos The position for which to generate valid moves.
+     * @return A list of valid moves as positions.
+     */
+    list<Position> get_valid_moves(Position& pos) {
+        list<Position> pos_list = {};
+        for (const int32 k : get_valid_moves((pos.x << 8) + pos.y)) {
+            pos_list.push_front(Position{k >> 8, k & 0xFF});
+        }
+        return pos_list;
+    }
+
+    /**
+     * @brief Checks if a piece at a given position can be captured by an opponent.
+     *
+     * @param pos The position of the piece.
+     * @return true if the piece can be captured, false otherwise.
+     */
+    bool can_be_captured(Position& pos) {
+        const int32 index = PackedBoard::to_index((pos.x << 8) + pos.y);
+        if (index < 0) {
+            return false;
+        }
+        Cell cell = mailbox.get_cell(index);
+        if (!cell.has_piece()) {
+            return false;
+        }
+        return is_attacked(index, 1 - side_of(cell.get_piece_color()));
+    }
+
+    /**
+     * @brief Checks if there are any valid moves for a given color.
+     *
+     * @param pc The color of the pieces.
+     * @return true if there are valid moves, false otherwise.
+     */
+    bool are_there_valid_moves(Cell::PieceColor pc) {
+        const int32 side = side_of(pc);
+        Bitboard128 pieces = occupancy[side];
+        while (!pieces.empty()) {
+            const int32 from = pieces.pop_lsb();
+            Bitboard128 targets = get_move_targets(from);
+            while (!targets.empty()) {
+                if (is_legal(from, targets.pop_lsb(), side)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Generates every legal move of one side into a caller-owned buffer, flagged like Board's.
+     *
+     * @param pc The color of the side to move.
+     * @param out The buffer to fill; it is cleared first.
+     */
+    void generate_legal_moves(Cell::PieceColor pc, MoveList& out) {
+        out.clear();
+        const int32 side = side_of(pc);
+        Bitboard128 own = occupancy[side];
+        while (!own.empty()) {
+            const int32 from = own.pop_lsb();
+            Cell moved = mailbox.get_cell(from);
+            const bool is_pawn = moved.get_piece_type() == Cell::PieceType::pawn;
+            Bitboard128 targets = get_move_targets(from);
+            while (!targets.empty()) {
+                const int32 to = targets.pop_lsb();
+                if (!is_legal(from, to, side)) {
+                    continue;
+                }
+                uint8 flags = occupancy[1 - side].test(to) ? Move::Flags::capture : Move::Flags::quiet;
+                if (is_pawn && get_en_passant_victim(to, moved) >= 0) {
+                    flags = Move::Flags::capture | Move::Flags::en_passant;
+                }
+                else if (is_pawn && (to - from == 2 || from - to == 2)) {
+                    flags = Move::Flags::pawn_jump;
+                }
+                out.add(from, to, flags);
+            }
+        }
+    }
+
+    /**
+     * @brief Checks whether the king of the given color is attacked.
+     *
+     * @param pc The color of the king.
+     * @return true if the king is in check, false otherwise or if the side has no king.
+     */
+    bool is_in_check(Cell::PieceColor pc) const {
+        const int32 side = side_of(pc);
+        const Bitboard128 king = pieces[side][Cell::PieceType::king];
+        return !king.empty() && is_attacked(king.lsb(), 1 - side);
+    }
+
+    /**
+     * @brief Checks whether a cell is attacked by any piece of the given side.
+     *
+     * @param index The dense index of the cell.
+     * @param by_side The attacking side (0 white, 1 black).
+     * @return true if the cell is attacked, false otherwise.
+     */
+    bool is_attacked(const int32 index, const int32 by_side) const {
+        const BitboardTables& tables = BitboardTables::get();
+        const Bitboard128 (&enemy)[7] = pieces[by_side];
+        if (!(tables.knight[index] & enemy[Cell::PieceType::knight]).empty()
+            || !(tables.king[index] & enemy[Cell::PieceType::king]).empty()
+            || !(tables.pawn_attackers[by_side][index] & enemy[Cell::PieceType::pawn]).empty()) {
+            return true;
+        }
+        const Bitboard128 diagonal = enemy[Cell::PieceType::bishop] | enemy[Cell::PieceType::queen];
+        if (!diagonal.empty() && !(bishop_attacks(index) & diagonal).empty()) {
+            return true;
+        }
+        const Bitboard128 straight = enemy[Cell::PieceType::rook] | enemy[Cell::PieceType::queen];
+        return !straight.empty() && !(rook_attacks(index) & straight).empty();
+    }
+
+    /**
+     * @brief Counts the leaf nodes of the legal move tree, an independent check on Board::perft.
+     *
+     * @param depth The number of plies to expand.
+     * @param pc The color of the side to move.
+     * @return The number of move sequences of exactly depth plies.
+     */
+    uint64 perft(int32 depth, Cell::PieceColor pc) {
+        if (depth <= 0) {
+            return 1;
+        }
+        const int32 side = side_of(pc);
+        const Cell::PieceColor enemy = side == 0 ? Cell::PieceColor::black : Cell::PieceColor::white;
+        uint64 nodes = 0;
+        Bitboard128 own = occupancy[side];
+        while (!own.empty()) {
+            const int32 from = own.pop_lsb();
+            Bitboard128 targets = get_move_targets(from);
+            while (!targets.empty()) {
+                const int32 to = targets.pop_lsb();
+                if (!is_legal(from, to, side)) {
+                    continue;
+                }
+                if (depth == 1) {
+                    nodes++;
+                    continue;
+                }
+                const UndoRecord undo = make_move(from, to);
+                nodes += perft(depth - 1, enemy);
+                unmake_move(undo);
+            }
+        }
+        return nodes;
+    }
+
+    inline Bitboard128 bishop_attacks(const int32 index) const {
+        return slider_attacks(index, HexMoveTables::first_bishop_direction, HexMoveTables::first_rook_direction);
+    }
+
+    inline Bitboard128 rook_attacks(const int32 index) const {
+        return slider_attacks(index, HexMoveTables::first_rook_direction, HexMoveTables::direction_count);
+    }
+
+    /**
+     * @brief Gets the pseudo-legal target cells of the piece on a cell.
+     *
+     * @param index The dense index of the piece.
+     * @return The target cells, empty if the cell has no piece.
+     */
+    Bitboard128 get_move_targets(const int32 index) const {
+        const BitboardTables& tables = BitboardTables::get();
+        Cell cell = mailbox.get_cell(index);
+        const int32 side = side_of(cell.get_piece_color());
+        const Bitboard128 not_own = ~occupancy[side];
+        switch (cell.get_piece_type()) {
+            case Cell::PieceType::pawn:
+                return get_pawn_targets(index, side);
+            case Cell::PieceType::knight:
+                return tables.knight[index] & not_own;
+            case Cell::PieceType::bishop:
+                return bishop_attacks(index) & not_own;
+            case Cell::PieceType::rook:
+                return rook_attacks(index) & not_own;
+            case Cell::PieceType::queen:
+                return (bishop_attacks(index) | rook_attacks(index)) & not_own;
+            case Cell::PieceType::king:
+                return tables.king[index] & not_own;
+            default:
+                return Bitboard128();
+        }
+    }
+
+    Bitboard128 pieces[2][7];
+    Bitboard128 occupancy[2];
+    Bitboard128 all;
+    PackedBoard mailbox;
+
+private:
+
+    static inline int32 side_of(Cell::PieceColor pc) {
+        return pc == Cell::PieceColor::black ? 1 : 0;
+    }
+
+    inline void put_piece(const int32 index, Cell::PieceType pt, Cell::PieceColor pc) {
+        const Bitboard128 bit = Bitboard128::from_index(index);
+        const int32 side = side_of(pc);
+        pieces[side][pt] |= bit;
+        occupancy[side] |= bit;
+        all |= bit;
+        mailbox.set_cell(index, pt, pc);
+    }
+
+    inline void remove_piece(const int32 index) {
+        Cell cell = mailbox.get_cell(index);
+        if (!cell.has_piece()) {
+            return;
+        }
+        const Bitboard128 bit = ~Bitboard128::from_index(index);
+        const int32 side = side_of(cell.get_piece_color());
+        pieces[side][cell.get_piece_type()] &= bit;
+        occupancy[side] &= bit;
+        all &= bit;
+        mailbox.clear_cell(index);
+    }
+
+    inline UndoRecord make_move(const int32 from, const int32 to) {
+        UndoRecord undo;
+        undo.from = static_cast<uint8>(from);
+        undo.to = static_cast<uint8>(to);
+        undo.moved = mailbox.cells[from];
+        undo.shadow_before = mailbox.shadow_cell;
+        Cell moved = mailbox.get_cell(from);
+        const int32 victim = get_en_passant_victim(to, moved);
+        const int32 captured_cell = victim >= 0 ? victim : to;
+        undo.captured_cell = static_cast<uint8>(captured_cell);
+        undo.captured = mailbox.cells[captured_cell];
+        remove_piece(captured_cell);
+        remove_piece(from);
+        put_piece(to, moved.get_piece_type(), moved.get_piece_color());
+        mailbox.flip_side_to_move();
+        // the only pawn move that stays in its column for two cells is the jump
+        if (moved.get_piece_type() == Cell::PieceType::pawn && (to - from == 2 || from - to == 2)) {
+            mailbox.set_shadow((from + to) / 2);
+        }
+        return undo;
+    }
+
+    inline void unmake_move(const UndoRecord& undo) {
+        mailbox.flip_side_to_move();
+        mailbox.set_shadow(undo.shadow_before);
+        remove_piece(undo.to);
+        Cell moved = PackedBoard::decode(undo.moved);
+        Cell captured = PackedBoard::decode(undo.captured);
+        put_piece(undo.from, moved.get_piece_type(), moved.get_piece_color());
+        if (captured.has_piece()) {
+            put_piece(undo.captured_cell, captured.get_piece_type(), captured.get_piece_color());
+        }
+    }
+
+    /**
+     * @brief The cell of the pawn a move onto the shadow takes en passant, -1 if the move is not such a capture.
+     *
+     * The side to move is not tracked here, so the jumper is told apart by its color: an enemy pawn right behind the shadow.
+     */
+    inline int32 get_en_passant_victim(const int32 to, Cell moved) const {
+        if (to != mailbox.shadow_cell || moved.get_piece_type() != Cell::PieceType::pawn) {
+            return -1;
+        }
+        // cells of a column have consecutive indices, bottom to top; the jumper moved away from the capturing side
+        const bool is_black = moved.get_piece_color() == Cell::PieceColor::black;
+        const int32 victim = is_black ? to + 1 : to - 1;
+        Cell jumper = mailbox.get_cell(victim);
+        const bool is_enemy_pawn = jumper.get_piece_type() == Cell::PieceType::pawn && jumper.get_piece_color() != moved.get_piece_color();
+        return is_enemy_pawn ? victim : -1;
+    }
+
+    /**
+     * @brief Checks that a move does not leave the mover's king attacked.
+     */
+    bool is_legal(const int32 from, const int32 to, const int32 side) {
+        if (pieces[side][Cell::PieceType::king].empty()) {
+            return true;
+        }
+        UndoRecord undo = make_move(from, to);
+        const bool legal = !is_attacked(pieces[side][Cell::PieceType::king].lsb(), 1 - side);
+        unmake_move(undo);
+        return legal;
+    }
+
+    Bitboard128 get_pawn_targets(const int32 index, const int32 side) const {
+        const HexMoveTables& moves = Board::move_tables();
+        Bitboard128 targets = BitboardTables::get().pawn_takes[side][index] & occupancy[1 - side];
+        const int32 shadow = mailbox.shadow_cell;
+        if (shadow >= 0 && BitboardTables::get().pawn_takes[side][index].test(shadow)
+            && get_en_passant_victim(shadow, mailbox.get_cell(index)) >= 0) {
+            targets.set(shadow);
+        }
+        const int32 push = moves.pawn_push[side][index];
+        if (push != HexMoveTables::sentinel && !all.test(push)) {
+            targets.set(push);
+            const int32 jump = moves.pawn_push[side][push];
+            if (moves.pawn_initial[side][index] && jump != HexMoveTables::sentinel && !all.test(jump)) {
+                targets.set(jump);
+            }
+        }
+        return targets;
+    }
+
+    Bitboard128 slider_attacks(const int32 index, const int32 first_direction, const int32 last_direction) const {
+        const BitboardTables& tables = BitboardTables::get();
+        Bitboard128 attacks;
+        for (int32 direction = first_direction; direction < last_direction; direction++) {
+            const Bitboard128& ray = tables.rays[index][direction];
+            const Bitboard128 blockers = ray & all;
+            if (blockers.empty()) {
+                attacks |= ray;
+            } else {
+                const int32 blocker = tables.ray_increasing[direction] ? blockers.lsb() : blockers.msb();
+                attacks |= ray ^ tables.rays[blocker][direction];
+            }
+        }
+        return attacks;
+    }
+};
@@ -0,0 +1,3108 @@
+#pragma once
+
+#include <map>
+#include <list>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+#include "Chess/HexTypes.h"
+
+using namespace std;
+
+struct Position {
+
+    Position() {}
+    Position(int32 x, int32 y): x(x), y(y) {}
+
+    int32 x, y;
+};
+
+class Cell {
+public:
+    enum PieceType {
+        none, pawn, knight, bishop, rook, queen, king
+    };
+
+    enum PieceColor {
+        absent, white, black
+    };
+
+    Cell() {}
+    Cell(PieceType pt, PieceColor pc): piece(pt), piece_color(pc) {}
+    Cell(Cell& other): piece(other.piece), piece_color(other.piece_color) {}
+
+    void set_piece(PieceType pt, PieceColor pc) {
+        piece = pt;
+        piece_color = pc;
+    }
+
+    void remove_piece() {
+        piece = PieceType::none;
+        piece_color = PieceColor::absent;
+    }
+
+    bool has_piece() {
+        return piece != PieceType::none;
+    }
+
+    bool has_white_piece() {
+        return piece != PieceType::none && piece_color == PieceColor::white;
+    }
+
+    bool has_black_piece() {
+        return piece != PieceType::none && piece_color == PieceColor::black;
+    }
+
+    bool has_piece_of_same_color(Cell* cell) {
+        PieceColor other_color = cell->get_piece_color();
+        return piece != PieceType::none
+               && piece_color != PieceColor::absent
+               && other_color != PieceColor::absent
+               && piece_color == other_color;
+    }
+
+    bool has_piece_of_opposite_color(Cell* cell) {
+        PieceColor other_color = cell->get_piece_color();
+        return piece != PieceType::none
+               && piece_color != PieceColor::absent
+               && other_color != PieceColor::absent
+               && piece_color != other_color;
+    }
+
+    PieceType get_piece_type() {
+        return piece;
+    }
+
+    PieceColor get_piece_color() {
+        return piece_color;
+    }
+    
+    PieceColor get_opposite_color() {
+        switch (piece_color) {
+            case PieceColor::white:
+                return PieceColor::black;
+            case PieceColor::black:
+                return PieceColor::white;
+        }
+        return PieceColor::absent;
+    }
+    
+private:
+    PieceType piece = PieceType::none;
+    PieceColor piece_color = PieceColor::absent;
+};
+
+/**
+ * @brief One-byte value form of a Cell: the piece type in the low 3 bits and the piece color in the next 2 bits.
+ *
+ * Unlike Cell it is never held by pointer, so boards built from it can be copied, compared and hashed as plain bytes.
+ */
+struct Square {
+    uint8 value = 0;
+
+    constexpr Square() = default;
+    constexpr explicit Square(const uint8 value): value(value) {}
+    constexpr Square(Cell::PieceType pt, Cell::PieceColor pc): value(static_cast<uint8>((pc << 3) | pt)) {}
+
+    constexpr Cell::PieceType get_piece_type() const {
+        return static_cast<Cell::PieceType>(value & 0x7);
+    }
+
+    constexpr Cell::PieceColor get_piece_color() const {
+        return static_cast<Cell::PieceColor>((value >> 3) & 0x3);
+    }
+
+    constexpr Cell::PieceColor get_opposite_color() const {
+        return get_piece_color() == Cell::PieceColor::white ? Cell::PieceColor::black
+               : get_piece_color() == Cell::PieceColor::black ? Cell::PieceColor::white
+               : Cell::PieceColor::absent;
+    }
+
+    constexpr bool has_piece() const {
+        return get_piece_type() != Cell::PieceType::none;
+    }
+
+    constexpr bool has_white_piece() const {
+        return has_piece() && get_piece_color() == Cell::PieceColor::white;
+    }
+
+    constexpr bool has_black_piece() const {
+        return has_piece() && get_piece_color() == Cell::PieceColor::black;
+    }
+
+    constexpr bool has_piece_of_same_color(const Square other) const {
+        return has_piece()
+               && get_piece_color() != Cell::PieceColor::absent
+               && other.get_piece_color() != Cell::PieceColor::absent
+               && get_piece_color() == other.get_piece_color();
+    }
+
+    constexpr bool has_piece_of_opposite_color(const Square other) const {
+        return has_piece()
+               && get_piece_color() != Cell::PieceColor::absent
+               && other.get_piece_color() != Cell::PieceColor::absent
+               && get_piece_color() != other.get_piece_color();
+    }
+
+    constexpr bool operator==(const Square other) const { return value == other.value; }
+    constexpr bool operator!=(const Square other) const { return value != other.value; }
+
+    inline Cell to_cell() const {
+        return Cell(get_piece_type(), get_piece_color());
+    }
+};
+
+static_assert(sizeof(Square) == 1, "Square must stay one byte");
+
+/**
+ * @brief Shape of a hexagonal board of the given radius (cells from the center to an edge), all of it known at compile time.
+ *
+ * Columns run left to right and cells bottom to top; the middle column is the tallest and every step away from it loses a cell.
+ */
+template <int32 Radius>
+struct HexGeometry {
+    static_assert(Radius > 0, "A board needs at least one ring around its center");
+
+    // position keys keep y in the low byte and the index table has 16 rows per column
+    static_assert(2 * Radius + 1 <= 16, "Columns taller than 16 cells do not fit the position keys");
+
+    static constexpr int32 radius = Radius;
+    static constexpr int32 median = Radius;
+    static constexpr int32 max = 2 * Radius;
+    static constexpr int32 columns = 2 * Radius + 1;
+    static constexpr int32 key_rows = 16;
+    static constexpr int32 cell_count = 3 * Radius * (Radius + 1) + 1;
+    static constexpr int32 step_x = 1 << 8;
+
+    static constexpr int32 column_height(const int32 x) {
+        return columns - (x < median ? median - x : x - median);
+    }
+};
+
+// the 91 cell board of Glinski's chess, the one the whole engine plays on
+using GlinskiGeometry = HexGeometry<5>;
+
+/**
+ * @brief Lookup tables between sparse position keys ((x << 8) + y) and dense cell indices (0..cell_count - 1).
+ *
+ * Cells are numbered column by column, bottom to top, the same order the Board constructor creates them in.
+ */
+template <typename Geometry>
+struct BasicHexIndexTable {
+    static constexpr int32 columns = Geometry::columns;
+    static constexpr int32 cell_count = Geometry::cell_count;
+
+    int8 key_to_index[columns][Geometry::key_rows] = {};
+    int32 index_to_key[cell_count] = {};
+};
+
+using HexIndexTable = BasicHexIndexTable<GlinskiGeometry>;
+
+template <typename Geometry>
+constexpr BasicHexIndexTable<Geometry> make_hex_index_table() {
+    BasicHexIndexTable<Geometry> table = {};
+    int32 index = 0;
+    for (int32 x = 0; x < Geometry::columns; x++) {
+        for (int32 y = 0; y < Geometry::key_rows; y++) {
+            table.key_to_index[x][y] = -1;
+        }
+        for (int32 y = 0; y < Geometry::column_height(x); y++) {
+            table.key_to_index[x][y] = static_cast<int8>(index);
+            table.index_to_key[index] = (x << 8) + y;
+            index++;
+        }
+    }
+    return table;
+}
+
+inline constexpr HexIndexTable hex_index_table = make_hex_index_table<GlinskiGeometry>();
+static_assert(HexIndexTable::cell_count == 91, "The Glinski board has 91 cells");
+
+/**
+ * @brief Axial coordinates of a cell, centered on the middle cell; s is the third cube coordinate, q + r + s == 0.
+ *
+ * q is the column from the middle one; r grows up the column, and every step along the six rook lines changes two of q, r and s by one.
+ */
+struct AxialCoord {
+    int8 q = 0;
+    int8 r = 0;
+
+    constexpr int8 s() const { return static_cast<int8>(-q - r); }
+    constexpr bool operator==(const AxialCoord other) const { return q == other.q && r == other.r; }
+
+    // cells between two cells along the shortest path of neighbor steps
+    constexpr int32 distance(const AxialCoord other) const {
+        const int32 dq = q > other.q ? q - other.q : other.q - q;
+        const int32 dr = r > other.r ? r - other.r : other.r - r;
+        const int32 ds = s() > other.s() ? s() - other.s() : other.s() - s();
+        return (dq + dr + ds) / 2;
+    }
+};
+
+template <typename Geometry>
+constexpr AxialCoord key_to_axial(const int32 key) {
+    const int32 q = (key >> 8) - Geometry::median;
+    return AxialCoord{static_cast<int8>(q), static_cast<int8>((key & 0xFF) - Geometry::radius - (q < 0 ? q : 0))};
+}
+
+template <typename Geometry>
+constexpr int32 axial_to_key(const AxialCoord coord) {
+    return ((coord.q + Geometry::median) << 8) + coord.r + Geometry::radius + (coord.q < 0 ? coord.q : 0);
+}
+
+template <typename Geometry>
+constexpr bool is_axial_on_board(const AxialCoord coord) {
+    const int32 radius = Geometry::radius;
+    return coord.q >= -radius && coord.q <= radius && coord.r >= -radius && coord.r <= radius && coord.s() >= -radius && coord.s() <= radius;
+}
+
+/**
+ * @brief Axial coordinates of every dense cell index, and the cell index back from them.
+ */
+template <typename Geometry>
+struct BasicHexAxialTable {
+    static constexpr int32 span = 2 * Geometry::radius + 1;
+
+    AxialCoord index_to_axial[Geometry::cell_count] = {};
+
+    // [q + radius][r + radius], -1 off the board
+    int8 axial_to_index[span][span] = {};
+
+    constexpr int32 to_index(const AxialCoord coord) const {
+        return is_axial_on_board<Geometry>(coord) ? axial_to_index[coord.q + Geometry::radius][coord.r + Geometry::radius] : -1;
+    }
+};
+
+template <typename Geometry>
+constexpr BasicHexAxialTable<Geometry> make_hex_axial_table(const BasicHexIndexTable<Geometry>& index_table) {
+    BasicHexAxialTable<Geometry> table = {};
+    for (int32 q = 0; q < BasicHexAxialTable<Geometry>::span; q++) {
+        for (int32 r = 0; r < BasicHexAxialTable<Geometry>::span; r++) {
+            table.axial_to_index[q][r] = -1;
+        }
+    }
+    for (int32 index = 0; index < Geometry::cell_count; index++) {
+        const AxialCoord coord = key_to_axial<Geometry>(index_table.index_to_key[index]);
+        table.index_to_axial[index] = coord;
+        table.axial_to_index[coord.q + Geometry::radius][coord.r + Geometry::radius] = static_cast<int8>(index);
+    }
+    return table;
+}
+
+using HexAxialTable = BasicHexAxialTable<GlinskiGeometry>;
+
+inline constexpr HexAxialTable hex_axial_table = make_hex_axial_table<GlinskiGeometry>(hex_index_table);
+static_assert(hex_axial_table.to_index(AxialCoord{0, 0}) == 45, "The middle cell of the Glinski board is cell 45");
+static_assert(hex_axial_table.to_index(AxialCoord{5, -5}) >= 0 && hex_axial_table.to_index(AxialCoord{5, 1}) == -1, "Corners are on the board, past them is not");
+
+/**
+ * @brief Zobrist keys: one random 64-bit key per (cell, color, piece type), one for black to move and one per pawn shadow cell.
+ */
+struct ZobristKeys {
+    uint64 pieces[HexIndexTable::cell_count][2][6] = {};
+    uint64 black_to_move = 0;
+    uint64 shadows[HexIndexTable::cell_count] = {};
+};
+
+constexpr uint64 next_zobrist_key(uint64& state) {
+    // splitmix64, so the keys are fixed at compile time and identical on every platform
+    uint64 z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys make_zobrist_keys() {
+    ZobristKeys keys = {};
+    uint64 state = 0x48657861636865ull;
+    for (int32 index = 0; index < HexIndexTable::cell_count; index++) {
+        for (int32 side = 0; side < 2; side++) {
+            for (int32 type = 0; type < 6; type++) {
+                keys.pieces[index][side][type] = next_zobrist_key(state);
+            }
+        }
+    }
+    keys.black_to_move = next_zobrist_key(state);
+    // drawn last, so the keys above are the same as before shadows were hashed
+    for (int32 index = 0; index < HexIndexTable::cell_count; index++) {
+        keys.shadows[index] = next_zobrist_key(state);
+    }
+    return keys;
+}
+
+inline constexpr ZobristKeys zobrist_keys = make_zobrist_keys();
+
+/**
+ * @brief Positional bonus of every (side, piece type, cell), in evaluation units (a pawn is 100).
+ *
+ * Black entries are stored negated, so a position's positional score (white minus black) is a plain sum.
+ */
+struct PieceSquareTables {
+    int16 values[2][8][HexIndexTable::cell_count] = {};
+};
+
+constexpr int32 hex_column_height(const int32 x) {
+    return x <= 5 ? 6 + x : 16 - x;
+}
+
+constexpr int32 hex_center_distance(const int32 x, const int32 y) {
+    // axial coordinates centred on the middle cell: column q, and r counted up the column from its lowest cell
+    const int32 q = x - 5;
+    const int32 r = (q < 0 ? -5 - q : -5) + y;
+    const int32 s = q + r;
+    return ((q < 0 ? -q : q) + (r < 0 ? -r : r) + (s < 0 ? -s : s)) / 2;
+}
+
+constexpr PieceSquareTables make_piece_square_tables() {
+    PieceSquareTables tables = {};
+    // indexed by how many pushes the pawn still needs to promote
+    constexpr int16 pawn_advance[11] = {0, 60, 40, 25, 15, 8, 4, 0, 0, 0, 0};
+    for (int32 index = 0; index < HexIndexTable::cell_count; index++) {
+        const int32 key = hex_index_table.index_to_key[index];
+        const int32 x = key >> 8;
+        const int32 y = key & 0xFF;
+        const int32 centrality = 5 - hex_center_distance(x, y);
+        for (int32 side = 0; side < 2; side++) {
+            // white pawns promote at the top of their column, black pawns at the bottom
+            const int32 pushes_left = side == 0 ? hex_column_height(x) - 1 - y : y;
+            const int32 sign = side == 0 ? 1 : -1;
+            tables.values[side][Cell::PieceType::pawn][index] = static_cast<int16>(sign * (pawn_advance[pushes_left] + (centrality > 3 ? 5 : 0)));
+            tables.values[side][Cell::PieceType::knight][index] = static_cast<int16>(sign * centrality * 6);
+            tables.values[side][Cell::PieceType::bishop][index] = static_cast<int16>(sign * centrality * 4);
+            tables.values[side][Cell::PieceType::rook][index] = static_cast<int16>(sign * centrality * 2);
+            tables.values[side][Cell::PieceType::queen][index] = static_cast<int16>(sign * centrality * 2);
+            // the king is safer away from the middle of the board
+            tables.values[side][Cell::PieceType::king][index] = static_cast<int16>(sign * (5 - centrality) * 3);
+        }
+    }
+    return tables;
+}
+
+inline constexpr PieceSquareTables piece_square_tables = make_piece_square_tables();
+
+/**
+ * @brief Everything needed to take back a move played with make_move.
+ */
+struct UndoRecord {
+    uint8 from = 0;
+    uint8 to = 0;
+    Square moved;
+    Square captured;
+    uint8 captured_slot = 0;
+    // where the captured piece stood: the target cell, or the jumped pawn's cell for an en passant capture
+    uint8 captured_cell = 0;
+    int8 shadow_before = -1;
+};
+
+/**
+ * @class PackedBoard
+ * @brief Value-type board: 91 one-byte Squares in a contiguous array.
+ *
+ * Copying a position is a single memcpy, so search can branch without touching the allocator.
+ *
+ * Alongside the cells the board keeps a piece list per side and the square of each king, so
+ * enumerating pieces costs O(pieces) and finding the king O(1). Every write that goes through
+ * set_cell, clear_cell, make_move or unmake_move keeps them in sync.
+ *
+ * The same writes update a Zobrist hash of the position. make_move and unmake_move also flip the side to move,
+ * so the hash tells apart the same pieces with a different player on turn.
+ *
+ * They also keep the evaluation terms that only depend on where pieces stand: how many pieces of each type
+ * a side has, and the piece-square table sum. Evaluating a position then costs a handful of additions.
+ *
+ * A pawn's two-cell first move leaves a shadow on the cell it passed over, for the next ply only. An enemy pawn that
+ * could take on that cell may move there and capture the jumped pawn (en passant). The shadow is part of the hash.
+ */
+struct PackedBoard {
+    static constexpr int32 cell_count = HexIndexTable::cell_count;
+
+    Square cells[cell_count] = {};
+
+    // cell indices of each side's pieces (0 = white, 1 = black), in no particular order
+    uint8 piece_cells[2][cell_count] = {};
+    uint8 piece_count[2] = {};
+    // position of each occupied cell in its side's piece list
+    uint8 piece_slot[cell_count] = {};
+    int8 king_cell[2] = { -1, -1 };
+
+    uint64 hash = 0;
+    bool black_to_move = false;
+    // the cell the last move's pawn jumped over, -1 when the last move was not a pawn jump
+    int8 shadow_cell = -1;
+
+    // pieces of each type per side, indexed by Cell::PieceType
+    uint8 type_count[2][8] = {};
+    // sum of piece_square_tables over all pieces, white minus black
+    int32 positional_score = 0;
+
+    /**
+     * @brief Converts a position key to a dense cell index.
+     *
+     * @param key The position key.
+     * @return The cell index, or -1 if the key is not on the board.
+     */
+    static inline int32 to_index(const int32 key) {
+        const uint32 x = static_cast<uint32>(key) >> 8;
+        const uint32 y = static_cast<uint32>(key) & 0xFF;
+        if (x >= HexIndexTable::columns || y >= GlinskiGeometry::key_rows) {
+            return -1;
+        }
+        return hex_index_table.key_to_index[x][y];
+    }
+
+    /**
+     * @brief Converts a dense cell index back to a position key.
+     */
+    static inline int32 to_key(const int32 index) {
+        return hex_index_table.index_to_key[index];
+    }
+
+    static constexpr Square encode(Cell::PieceType pt, Cell::PieceColor pc) {
+        return Square(pt, pc);
+    }
+
+    static inline Cell decode(const Square square) {
+        return square.to_cell();
+    }
+
+    static constexpr int32 side_of(const Cell::PieceColor pc) {
+        return pc == Cell::PieceColor::black ? 1 : 0;
+    }
+
+    inline Cell get_cell(const int32 index) const {
+        return decode(cells[index]);
+    }
+
+    inline Square get_square(const int32 index) const {
+        return cells[index];
+    }
+
+    inline void set_cell(const int32 index, Cell::PieceType pt, Cell::PieceColor pc) {
+        remove_piece(index);
+        cells[index] = encode(pt, pc);
+        if (is_listed(cells[index])) {
+            add_piece(index);
+        }
+    }
+
+    inline void clear_cell(const int32 index) {
+        remove_piece(index);
+        cells[index] = Square();
+    }
+
+    /**
+     * @brief Compares the pieces and side to move of two boards; the piece lists and hash follow from them and are not compared.
+     */
+    inline bool operator==(const PackedBoard& other) const {
+        return black_to_move == other.black_to_move && shadow_cell == other.shadow_cell && memcmp(cells, other.cells, sizeof(cells)) == 0;
+    }
+
+    inline bool operator!=(const PackedBoard& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief Gets the cell of a side's king.
+     *
+     * @param pc The color of the king.
+     * @return The cell index, or -1 if that side has no king.
+     */
+    inline int32 get_king_cell(const Cell::PieceColor pc) const {
+        return king_cell[side_of(pc)];
+    }
+
+    /**
+     * @brief Hands the move to the other side without moving a piece; the pawn shadow does not survive the pass.
+     */
+    inline void flip_side_to_move() {
+        set_shadow(-1);
+        black_to_move = !black_to_move;
+        hash ^= zobrist_keys.black_to_move;
+    }
+
+    /**
+     * @brief Makes a side the one to move. A position copied off a board is searched or looked up for a given side, and the
+     * hash only agrees with that side once it is the one to move.
+     *
+     * @param is_white Whether white is to move.
+     */
+    inline void set_white_to_move(const bool is_white) {
+        if (black_to_move == is_white) {
+            flip_side_to_move();
+        }
+    }
+
+    /**
+     * @brief Replaces the pawn shadow, keeping the hash in step.
+     *
+     * @param index The cell a pawn of the side that just moved jumped over, or -1 for none.
+     */
+    inline void set_shadow(const int32 index) {
+        if (shadow_cell >= 0) {
+            hash ^= zobrist_keys.shadows[shadow_cell];
+        }
+        shadow_cell = static_cast<int8>(index);
+        if (shadow_cell >= 0) {
+            hash ^= zobrist_keys.shadows[shadow_cell];
+        }
+    }
+
+    /**
+     * @brief Finds the pawn a move would take en passant.
+     *
+     * @param from The cell index the piece moves from.
+     * @param to The cell index the piece moves to.
+     * @return The cell index of the jumped pawn, or -1 if the move is not an en passant capture.
+     */
+    inline int32 get_en_passant_victim(const int32 from, const int32 to) const {
+        if (to != shadow_cell || cells[from].get_piece_type() != Cell::PieceType::pawn) {
+            return -1;
+        }
+        // cells of a column have consecutive indices, bottom to top; the jumper moved away from the side now to move
+        return black_to_move ? to + 1 : to - 1;
+    }
+
+    /**
+     * @brief Recomputes the Zobrist hash from scratch; the incremental hash must always equal it.
+     */
+    inline uint64 compute_hash() const {
+        uint64 result = black_to_move ? zobrist_keys.black_to_move : 0;
+        if (shadow_cell >= 0) {
+            result ^= zobrist_keys.shadows[shadow_cell];
+        }
+        for (int32 index = 0; index < cell_count; index++) {
+            if (is_listed(cells[index])) {
+                result ^= piece_key(index, cells[index]);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Recomputes the piece-square table sum from scratch; the incremental sum must always equal it.
+     */
+    inline int32 compute_positional_score() const {
+        int32 result = 0;
+        for (int32 index = 0; index < cell_count; index++) {
+            if (is_listed(cells[index])) {
+                result += piece_square_value(index, cells[index]);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Plays a move in place.
+     *
+     * @param from The cell index the piece moves from.
+     * @param to The cell index the piece moves to.
+     * @return The record to pass to unmake_move to restore the position.
+     */
+    inline UndoRecord make_move(const int32 from, const int32 to) {
+        UndoRecord undo;
+        undo.from = static_cast<uint8>(from);
+        undo.to = static_cast<uint8>(to);
+        undo.moved = cells[from];
+        undo.shadow_before = shadow_cell;
+        const int32 victim = get_en_passant_victim(from, to);
+        const int32 captured_cell = victim >= 0 ? victim : to;
+        undo.captured_cell = static_cast<uint8>(captured_cell);
+        undo.captured = cells[captured_cell];
+        if (is_listed(undo.captured)) {
+            undo.captured_slot = piece_slot[captured_cell];
+            remove_piece(captured_cell);
+            cells[captured_cell] = Square();
+        }
+        relocate_piece(from, to);
+        cells[to] = cells[from];
+        cells[from] = Square();
+        flip_side_to_move();
+        // the only pawn move that stays in its column for two cells is the jump
+        if (undo.moved.get_piece_type() == Cell::PieceType::pawn && (to - from == 2 || from - to == 2)) {
+            set_shadow((from + to) / 2);
+        }
+        return undo;
+    }
+
+    /**
+     * @brief Restores the position from before the matching make_move.
+     *
+     * @param undo The record returned by make_move.
+     */
+    inline void unmake_move(const UndoRecord& undo) {
+        flip_side_to_move();
+        set_shadow(undo.shadow_before);
+        relocate_piece(undo.to, undo.from);
+        cells[undo.from] = undo.moved;
+        cells[undo.to] = Square();
+        cells[undo.captured_cell] = undo.captured;
+        if (is_listed(undo.captured)) {
+            add_piece(undo.captured_cell);
+            // put the captured piece back into its old slot so piece order survives make/unmake
+            const int32 side = side_of(undo.captured.get_piece_color());
+            const int32 last = piece_count[side] - 1;
+            if (undo.captured_slot != last) {
+                const uint8 displaced = piece_cells[side][undo.captured_slot];
+                piece_cells[side][undo.captured_slot] = undo.captured_cell;
+                piece_cells[side][last] = displaced;
+                piece_slot[undo.captured_cell] = undo.captured_slot;
+                piece_slot[displaced] = static_cast<uint8>(last);
+            }
+        }
+    }
+
+private:
+    static inline bool is_listed(const Square square) {
+        return square.has_white_piece() || square.has_black_piece();
+    }
+
+    static inline bool is_king(const Square square) {
+        return square.get_piece_type() == Cell::PieceType::king;
+    }
+
+    static inline uint64 piece_key(const int32 index, const Square square) {
+        return zobrist_keys.pieces[index][side_of(square.get_piece_color())][square.get_piece_type() - 1];
+    }
+
+    static inline int32 piece_square_value(const int32 index, const Square square) {
+        return piece_square_tables.values[side_of(square.get_piece_color())][square.get_piece_type()][index];
+    }
+
+    inline void add_piece(const int32 index) {
+        const Square square = cells[index];
+        const int32 side = side_of(square.get_piece_color());
+        piece_slot[index] = piece_count[side];
+        piece_cells[side][piece_count[side]++] = static_cast<uint8>(index);
+        hash ^= piece_key(index, square);
+        type_count[side][square.get_piece_type()]++;
+        positional_score += piece_square_value(index, square);
+        if (is_king(square)) {
+            king_cell[side] = static_cast<int8>(index);
+        }
+    }
+
+    inline void remove_piece(const int32 index) {
+        const Square square = cells[index];
+        if (!is_listed(square)) {
+            return;
+        }
+        const int32 side = side_of(square.get_piece_color());
+        const uint8 slot = piece_slot[index];
+        const uint8 last = piece_cells[side][--piece_count[side]];
+        piece_cells[side][slot] = last;
+        piece_slot[last] = slot;
+        hash ^= piece_key(index, square);
+        type_count[side][square.get_piece_type()]--;
+        positional_score -= piece_square_value(index, square);
+        if (is_king(square) && king_cell[side] == index) {
+            king_cell[side] = -1;
+        }
+    }
+
+    inline void relocate_piece(const int32 from, const int32 to) {
+        const Square square = cells[from];
+        if (!is_listed(square)) {
+            return;
+        }
+        const int32 side = side_of(square.get_piece_color());
+        const uint8 slot = piece_slot[from];
+        piece_cells[side][slot] = static_cast<uint8>(to);
+        piece_slot[to] = slot;
+        hash ^= piece_key(from, square) ^ piece_key(to, square);
+        positional_score += piece_square_value(to, square) - piece_square_value(from, square);
+        if (is_king(square)) {
+            king_cell[side] = static_cast<int8>(to);
+        }
+    }
+};
+
+/**
+ * @brief A move between two dense cell indices, packed into three bytes.
+ */
+struct Move {
+    enum Flags : uint8 {
+        quiet = 0,
+        capture = 1 << 0,
+        pawn_jump = 1 << 1,
+        // always set together with capture; the captured pawn is not on the target cell
+        en_passant = 1 << 2
+    };
+
+    uint8 from;
+    uint8 to;
+    uint8 flags;
+
+    Move() = default;
+    Move(int32 from, int32 to, uint8 flags = Flags::quiet): from(static_cast<uint8>(from)), to(static_cast<uint8>(to)), flags(flags) {}
+
+    inline bool is_capture() const { return (flags & Flags::capture) != 0; }
+};
+
+/**
+ * @brief Fixed-capacity, caller-owned move buffer; lives on the stack and never allocates.
+ */
+struct MoveList {
+    static constexpr int32 capacity = 256;
+
+    Move moves[capacity];
+    int32 count = 0;
+
+    inline void add(const int32 from, const int32 to, const uint8 flags = Move::Flags::quiet) {
+        if (count < capacity) {
+            moves[count++] = Move(from, to, flags);
+        }
+    }
+
+    inline void clear() { count = 0; }
+    inline int32 size() const { return count; }
+    inline bool empty() const { return count == 0; }
+    inline Move& operator[](const int32 i) { return moves[i]; }
+    inline const Move& operator[](const int32 i) const { return moves[i]; }
+    inline Move* begin() { return moves; }
+    inline Move* end() { return moves + count; }
+    inline const Move* begin() const { return moves; }
+    inline const Move* end() const { return moves + count; }
+};
+
+/**
+ * @brief Fixed-capacity list of dense cell indices, large enough for every cell of the board.
+ */
+struct CellList {
+    static constexpr int32 capacity = HexIndexTable::cell_count;
+
+    uint8 cells[capacity];
+    int32 count = 0;
+
+    inline void add(const int32 index) {
+        if (count < capacity) {
+            cells[count++] = static_cast<uint8>(index);
+        }
+    }
+
+    inline void clear() { count = 0; }
+    inline int32 size() const { return count; }
+    inline bool empty() const { return count == 0; }
+    inline uint8 operator[](const int32 i) const { return cells[i]; }
+    inline const uint8* begin() const { return cells; }
+    inline const uint8* end() const { return cells + count; }
+};
+
+/**
+ * @brief Precomputed move geometry for every cell of the board, indexed by dense cell index.
+ *
+ * Directions 0..5 are the bishop diagonals and 6..11 the rook lines, in the order the legacy generators walk them.
+ * Every list ends with a -1 sentinel so generation is a plain table walk without geometry branches or lookups.
+ */
+struct HexMoveTables {
+    static constexpr int32 direction_count = 12;
+    static constexpr int32 first_bishop_direction = 0;
+    static constexpr int32 first_rook_direction = 6;
+    static constexpr int32 max_ray_length = 10;
+    static constexpr int32 max_step_targets = 12;
+    static constexpr int8 sentinel = -1;
+
+    // neighbors[cell][direction], -1 if the step leaves the board
+    int8 neighbors[HexIndexTable::cell_count][direction_count];
+
+    // rays[cell][direction] lists every cell along the direction until the edge
+    int8 rays[HexIndexTable::cell_count][direction_count][max_ray_length + 1];
+
+    int8 king_targets[HexIndexTable::cell_count][max_step_targets + 1];
+    int8 knight_targets[HexIndexTable::cell_count][max_step_targets + 1];
+
+    // pawn tables per color (0 white, 1 black)
+    int8 pawn_push[2][HexIndexTable::cell_count];
+    int8 pawn_takes[2][HexIndexTable::cell_count][2];
+    bool pawn_initial[2][HexIndexTable::cell_count];
+
+    // pawn_attackers[side][cell] are the cells a pawn of that side would capture the cell from
+    int8 pawn_attackers[2][HexIndexTable::cell_count][2];
+};
+
+/**
+ * @brief Per-side attacker counts for every cell of a position.
+ *
+ * Built once per position with Board::build_attack_map, after which "is this cell attacked" is a single load.
+ */
+struct AttackMap {
+    uint8 counts[2][HexIndexTable::cell_count] = {};
+
+    inline bool is_attacked(const int32 index, const int32 by_side) const {
+        return counts[by_side][index] != 0;
+    }
+};
+
+/**
+ * @brief Checkers and pins of one side's king, found once per position by Board::analyze_legality.
+ */
+struct LegalityInfo {
+    // cell index of the king, -1 when the side has no king (no legality filtering then)
+    int32 king = -1;
+    int32 checker_count = 0;
+
+    // cells a non-king move must land on to resolve a single check: the checker and the cells between
+    bool evasion[HexIndexTable::cell_count] = {};
+
+    // ray direction a pinned piece is pinned along, -1 if not pinned
+    int8 pin_direction[HexIndexTable::cell_count];
+
+    // bit d is set for the cells between the king and the pinner on direction d, pinner included
+    uint16 pin_lines[HexIndexTable::cell_count] = {};
+};
+
+/**
+ * @brief One piece of a side's standard Glinski setup, by column and by height from the side's own edge.
+ */
+struct StartingPiece {
+    int8 x;
+    int8 y;
+    Cell::PieceType type;
+};
+
+// black mirrors every piece to the top of its column
+inline constexpr StartingPiece starting_layout[] = {
+    {4, 0, Cell::PieceType::queen}, {6, 0, Cell::PieceType::king},
+    {5, 0, Cell::PieceType::bishop}, {5, 1, Cell::PieceType::bishop}, {5, 2, Cell::PieceType::bishop},
+    {2, 0, Cell::PieceType::knight}, {8, 0, Cell::PieceType::knight},
+    {3, 0, Cell::PieceType::rook}, {7, 0, Cell::PieceType::rook},
+    {1, 0, Cell::PieceType::pawn}, {2, 1, Cell::PieceType::pawn}, {3, 2, Cell::PieceType::pawn}, {4, 3, Cell::PieceType::pawn}, {5, 4, Cell::PieceType::pawn},
+    {6, 3, Cell::PieceType::pawn}, {7, 2, Cell::PieceType::pawn}, {8, 1, Cell::PieceType::pawn}, {9, 0, Cell::PieceType::pawn},
+};
+
+/**
+ * @brief Position keys of one side's pawns in the starting layout, the cells a pawn may still jump two from.
+ */
+template <typename Geometry>
+inline vector<int32> make_pawn_start_keys(const int32 side) {
+    vector<int32> keys;
+    for (const StartingPiece& piece : starting_layout) {
+        if (piece.type == Cell::PieceType::pawn) {
+            const int32 y = side == 0 ? piece.y : Geometry::column_height(piece.x) - 1 - piece.y;
+            keys.push_back(piece.x * Geometry::step_x + y);
+        }
+    }
+    return keys;
+}
+
+/**
+ * @brief The value of each piece type, a flat table indexed by Cell::PieceType; reading it is one load, it never inserts.
+ */
+struct PieceValueTable {
+    int32 values[8] = {};
+
+    constexpr int32 operator[](const int32 type) const {
+        return values[type];
+    }
+};
+
+/**
+ * @brief The piece values every board, the static exchange evaluation and the move ordering score with.
+ *
+ * In evaluation units, a pawn is 100 so the piece-square tables can express fractions of it; the king's value is the
+ * penalty for being in check. Searches that want other weights go through an Evaluator.
+ */
+inline constexpr PieceValueTable make_piece_value_table() {
+    PieceValueTable table;
+    table.values[Cell::PieceType::pawn] = 100;
+    table.values[Cell::PieceType::knight] = 300;
+    table.values[Cell::PieceType::bishop] = 300;
+    table.values[Cell::PieceType::rook] = 500;
+    table.values[Cell::PieceType::queen] = 900;
+    table.values[Cell::PieceType::king] = 10000;
+    return table;
+}
+
+/**
+ * @class Board
+ * @brief Represents the chess board and its operations.
+ * 
+ * The Board class is responsible for managing the chess board and performing various operations on it,
+ * such as moving pieces, evaluating the board state, and generating valid moves.
+ * It also stores the piece values used for scoring and evaluation.
+ */
+class Board {
+public:
+
+    // shared by every board and fixed at compile time, see make_piece_value_table
+    static constexpr PieceValueTable piece_values = make_piece_value_table();
+
+    /**
+     * @brief Constructor for the Board class.
+     * 
+     * Initializes the chess board and creates the cells for each position.
+     */
+    Board() {
+        HEXACHESS_LLM_SCOPE(HexachessEngine);
+        for (int32 x = 0; x <= max; x++) {
+            int32 y_max = median + x;
+            if (y_max > max) {
+                y_max = max - y_max % max;
+            }
+            for (int32 y = 0; y <= y_max; y++) {
+                int32 pos = to_position_key(x, y);
+                Cell* cell = new Cell();
+                board_map[pos] = cell;
+            }
+        }
+    }
+
+    /**
+     * @brief Empties every cell and forgets the history, so a board can be reused for a new game without reallocating its cells.
+     */
+    void reset() {
+        for (const auto& [key, cell] : board_map) {
+            cell->remove_piece();
+        }
+        packed_board = PackedBoard();
+        clear_history();
+    }
+
+    /**
+     * @brief Checks if a given position is a valid position on the board.
+     * 
+     * @param x The x-coordinate of the position.
+     * @param y The y-coordinate of the position.
+     * @return true if the position is valid, false otherwise.
+     */
+    bool is_valid_position(int32 x, int32 y) {
+        int32 pos = to_position_key(x, y);
+        return is_valid_position(pos);
+    }
+
+    /**
+     * @brief Gets a list of valid moves for a given position.
+     * 
+     * @param pos The position for which to generate valid moves.
+     * @return A list of valid moves as positions.
+     */
+    list<Position> get_valid_moves(Position& pos) {
+        auto key = to_position_key(pos);
+        auto moves = get_valid_moves(key);
+        list<Position> pos_list = {};
+        for (const int32 k : moves) {
+            Position p = this->to_position(k);
+            pos_list.push_front(p);
+        }
+        return pos_list;
+    }
+
+    /**
+     * @brief Gets a list of valid moves for a given position key.
+     * 
+     * @param key The position key for which to generate valid moves.
+     * @return A list of valid moves as position keys.
+     */
+    list<int32> get_valid_moves(int32 key) {
+        return get_valid_moves(packed_board, key);
+    }
+
+    /**
+     * @brief Gets a list of valid moves for a given position key in a specific board configuration.
+     * 
+     * @param in_board The board configuration to use.
+     * @param key The position key for which to generate valid moves.
+     * @param skip_filter Whether to skip the filtering step to check if the move leaves the king in check.
+     * @return A list of valid moves as position keys.
+     */
+    list<int32> get_valid_moves(map<int32, Cell*>& in_board, int32 key, bool skip_filter = false) {
+        if (!is_valid_position(in_board, key)) {
+            return {};
+        }
+        Cell* cell = in_board[key];
+        list<int32> l = {};
+        add_piece_moves(in_board, l, key, cell);
+
+        list<int32> filtered_list = {};
+        auto color_pieces = get_piece_keys(in_board, cell->get_piece_color());
+        int32 king_key = -1;
+        for (auto piece_key : color_pieces) {
+            if (in_board[piece_key]->get_piece_type() == Cell::PieceType::king) {
+                king_key = piece_key;
+                break;
+            }
+        }
+        if (skip_filter || king_key == -1) {
+            return l;
+        }
+        for (int32 k : l) {
+            auto board_copy = copy_board_map(in_board);
+            Position start = to_position(key);
+            Position goal = to_position(k);
+
+            move_piece(board_copy, start, goal);
+            auto final_king_key = king_key;
+            if (cell->get_piece_type() == Cell::PieceType::king) {
+                final_king_key = k;
+            }
+            if (!can_be_captured(board_copy, final_king_key)) {
+                filtered_list.push_front(k);
+            }
+
+            clear_board_map(board_copy);
+        }
+        return filtered_list;
+    }
+
+    /**
+     * @brief Gets a list of valid moves for a given position key on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param key The position key for which to generate valid moves.
+     * @param skip_filter Whether to skip the filtering step to check if the move leaves the king in check.
+     * @return A list of valid moves as position keys.
+     */
+    list<int32> get_valid_moves(PackedBoard& in_board, int32 key, bool skip_filter = false) {
+        MoveList moves;
+        get_valid_moves(in_board, key, moves, skip_filter);
+        list<int32> l = {};
+        for (const Move& move : moves) {
+            l.push_front(PackedBoard::to_key(move.to));
+        }
+        return l;
+    }
+
+    /**
+     * @brief Gets the valid moves for a given position key on a packed board into a caller-owned buffer.
+     * 
+     * @param in_board The packed board to use.
+     * @param key The position key for which to generate valid moves.
+     * @param out The buffer to fill; it is cleared first.
+     * @param skip_filter Whether to skip the filtering step to check if the move leaves the king in check.
+     */
+    void get_valid_moves(PackedBoard& in_board, int32 key, MoveList& out, bool skip_filter = false) {
+        out.clear();
+        const int32 from = PackedBoard::to_index(key);
+        if (from < 0) {
+            return;
+        }
+        const Square square = in_board.get_square(from);
+        if (!square.has_piece()) {
+            return;
+        }
+        if (skip_filter) {
+            add_piece_moves(in_board, out, from, square);
+            return;
+        }
+        MoveList moves;
+        add_piece_moves(in_board, moves, from, square);
+        LegalityInfo info;
+        analyze_legality(in_board, square.get_piece_color(), info);
+        for (const Move& move : moves) {
+            if (is_legal_move(in_board, info, move)) {
+                out.moves[out.count++] = move;
+            }
+        }
+    }
+
+    /**
+     * @brief Generates every legal move of one side into a caller-owned buffer.
+     * 
+     * The side's piece list is walked once and checkers and pins are found once for the whole side,
+     * so this is the call to use instead of get_valid_moves per piece.
+     * 
+     * @param in_board The packed board to use.
+     * @param pc The color of the side to move.
+     * @param out The buffer to fill; it is cleared first.
+     */
+    void generate_legal_moves(PackedBoard& in_board, Cell::PieceColor pc, MoveList& out) {
+        HEXACHESS_TRACE_SCOPE(Hexachess_GenerateMoves);
+        out.clear();
+        MoveList pseudo_moves;
+        add_side_moves(in_board, pc, pseudo_moves);
+        HEXACHESS_TRACE_SCOPE(Hexachess_FilterLegalMoves);
+        LegalityInfo info;
+        analyze_legality(in_board, pc, info);
+        for (const Move& move : pseudo_moves) {
+            if (is_legal_move(in_board, info, move)) {
+                out.moves[out.count++] = move;
+            }
+        }
+    }
+
+    /**
+     * @brief Generates the legal captures of one side into a caller-owned buffer, for quiescence search.
+     * 
+     * @param in_board The packed board to use.
+     * @param pc The color of the side to move.
+     * @param out The buffer to fill; it is cleared first.
+     */
+    void generate_legal_captures(PackedBoard& in_board, Cell::PieceColor pc, MoveList& out) {
+        MoveList moves;
+        generate_legal_moves(in_board, pc, moves);
+        out.clear();
+        for (const Move& move : moves) {
+            if (move.is_capture()) {
+                out.moves[out.count++] = move;
+            }
+        }
+    }
+
+    /**
+     * @brief Generates every legal move of one side on the main board.
+     * 
+     * @param pc The color of the side to move.
+     * @param out The buffer to fill; it is cleared first.
+     */
+    void generate_legal_moves(Cell::PieceColor pc, MoveList& out) {
+        generate_legal_moves(packed_board, pc, out);
+    }
+
+    /**
+     * @brief Checks if a move is one of the legal moves of the side to move on the main board.
+     * 
+     * @param from The dense index of the cell the move starts from.
+     * @param to The dense index of the cell the move ends on.
+     * @return true if the side to move may play it, false otherwise.
+     */
+    bool is_legal_move(const int32 from, const int32 to) {
+        MoveList moves;
+        generate_legal_moves(packed_board.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white, moves);
+        for (const Move& move : moves) {
+            if (move.from == from && move.to == to) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Checks whether a cell could be the pawn shadow of a position, for positions that come from outside the game.
+     * 
+     * @param in_board The position, with the side to move set.
+     * @param index The cell to check, -1 for no shadow.
+     * @return true for -1, or for an empty cell a pawn of the side that just moved jumped over: the pawn right past it
+     *         and the pawn's starting cell right before it, now empty.
+     */
+    static bool is_valid_shadow(const PackedBoard& in_board, const int32 index) {
+        if (index == -1) {
+            return true;
+        }
+        if (index < 0 || index >= PackedBoard::cell_count || in_board.cells[index].has_piece()) {
+            return false;
+        }
+        const HexMoveTables& moves = move_tables();
+        const int32 side = in_board.black_to_move ? 0 : 1;
+        const int32 jumper = moves.pawn_push[side][index];
+        const int32 origin = moves.pawn_push[1 - side][index];
+        const Square pawn = Square(Cell::PieceType::pawn, side == 0 ? Cell::PieceColor::white : Cell::PieceColor::black);
+        return jumper != HexMoveTables::sentinel && origin != HexMoveTables::sentinel && moves.pawn_initial[side][origin]
+               && in_board.cells[jumper] == pawn && !in_board.cells[origin].has_piece();
+    }
+
+    /**
+     * @brief Counts the leaf nodes of the legal move tree, the reference number for checking move generation.
+     * 
+     * The last ply is counted from the move list without playing the moves.
+     * 
+     * @param in_board The packed board to use; it is back in its starting state on return.
+     * @param depth The number of plies to expand.
+     * @param pc The color of the side to move.
+     * @return The number of move sequences of exactly depth plies.
+     */
+    uint64 perft(PackedBoard& in_board, int32 depth, Cell::PieceColor pc) {
+        if (depth <= 0) {
+            return 1;
+        }
+        MoveList moves;
+        generate_legal_moves(in_board, pc, moves);
+        if (depth == 1) {
+            return moves.count;
+        }
+        const Cell::PieceColor enemy = pc == Cell::PieceColor::white ? Cell::PieceColor::black : Cell::PieceColor::white;
+        uint64 nodes = 0;
+        for (const Move& move : moves) {
+            const UndoRecord undo = in_board.make_move(move.from, move.to);
+            nodes += perft(in_board, depth - 1, enemy);
+            in_board.unmake_move(undo);
+        }
+        return nodes;
+    }
+
+    /**
+     * @brief Splits perft by root move, to find the move whose subtree disagrees with a reference count.
+     * 
+     * @param in_board The packed board to use; it is back in its starting state on return.
+     * @param depth The number of plies to expand, the root move included.
+     * @param pc The color of the side to move.
+     * @return Every legal root move with the leaf count below it, in generation order.
+     */
+    vector<pair<Move, uint64>> perft_divide(PackedBoard& in_board, int32 depth, Cell::PieceColor pc) {
+        vector<pair<Move, uint64>> result;
+        MoveList moves;
+        generate_legal_moves(in_board, pc, moves);
+        const Cell::PieceColor enemy = pc == Cell::PieceColor::white ? Cell::PieceColor::black : Cell::PieceColor::white;
+        for (const Move& move : moves) {
+            const UndoRecord undo = in_board.make_move(move.from, move.to);
+            result.emplace_back(move, perft(in_board, depth - 1, enemy));
+            in_board.unmake_move(undo);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Finds the checkers of a side's king and the pieces pinned to it.
+     * 
+     * Walks the 12 rays out of the king once; together with is_legal_move this replaces playing every
+     * pseudo-legal move and testing the king afterwards.
+     * 
+     * @param in_board The packed board to use.
+     * @param pc The color of the king.
+     * @param out The legality info to fill.
+     */
+    void analyze_legality(const PackedBoard& in_board, Cell::PieceColor pc, LegalityInfo& out) {
+        const HexMoveTables& tables = move_tables();
+        out = LegalityInfo();
+        for (int8& direction : out.pin_direction) {
+            direction = -1;
+        }
+        out.king = in_board.get_king_cell(pc);
+        if (out.king == -1) {
+            return;
+        }
+
+        const Cell::PieceColor enemy = pc == Cell::PieceColor::white ? Cell::PieceColor::black : Cell::PieceColor::white;
+        const int32 enemy_side = enemy == Cell::PieceColor::black ? 1 : 0;
+        const int32 king = out.king;
+        const auto add_checker = [&out](const int32 index) {
+            out.checker_count++;
+            out.evasion[index] = true;
+        };
+
+        for (const int8 from : tables.pawn_attackers[enemy_side][king]) {
+            if (from != HexMoveTables::sentinel && in_board.cells[from] == PackedBoard::encode(Cell::PieceType::pawn, enemy)) {
+                add_checker(from);
+            }
+        }
+        for (const int8* target = tables.knight_targets[king]; *target != HexMoveTables::sentinel; target++) {
+            if (in_board.cells[*target] == PackedBoard::encode(Cell::PieceType::knight, enemy)) {
+                add_checker(*target);
+            }
+        }
+        for (const int8* target = tables.king_targets[king]; *target != HexMoveTables::sentinel; target++) {
+            if (in_board.cells[*target] == PackedBoard::encode(Cell::PieceType::king, enemy)) {
+                add_checker(*target);
+            }
+        }
+
+        const Square queen = PackedBoard::encode(Cell::PieceType::queen, enemy);
+        for (int32 direction = 0; direction < HexMoveTables::direction_count; direction++) {
+            const Square slider = PackedBoard::encode(direction < HexMoveTables::first_rook_direction ? Cell::PieceType::bishop : Cell::PieceType::rook, enemy);
+            const int8* ray = tables.rays[king][direction];
+            int32 pinned = -1;
+            for (int32 i = 0; ray[i] != HexMoveTables::sentinel; i++) {
+                const Square square = in_board.cells[ray[i]];
+                if (!square.has_piece()) {
+                    continue;
+                }
+                const bool is_enemy_slider = square == slider || square == queen;
+                if (pinned == -1 && square.get_piece_color() == pc) {
+                    pinned = ray[i];
+                    continue;
+                }
+                if (is_enemy_slider) {
+                    for (int32 j = 0; j <= i; j++) {
+                        if (pinned == -1) {
+                            out.evasion[ray[j]] = true;
+                        } else {
+                            out.pin_lines[ray[j]] |= static_cast<uint16>(1 << direction);
+                        }
+                    }
+                    if (pinned == -1) {
+                        out.checker_count++;
+                    } else {
+                        out.pin_direction[pinned] = static_cast<int8>(direction);
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Checks a pseudo-legal move against the checkers and pins found by analyze_legality.
+     * 
+     * King moves are tested directly, with the king lifted off the board so it cannot hide behind itself.
+     * 
+     * @param in_board The packed board to use.
+     * @param info The legality info of the moving side.
+     * @param from The cell index the piece moves from.
+     * @param to The cell index the piece moves to.
+     * @return true if the move does not leave the king attacked.
+     */
+    bool is_legal_move(PackedBoard& in_board, const LegalityInfo& info, const int32 from, const int32 to) {
+        if (info.king == -1) {
+            return true;
+        }
+        if (from == info.king) {
+            const Square king = in_board.cells[from];
+            const Cell::PieceColor enemy = king.get_opposite_color();
+            in_board.cells[from] = Square();
+            const bool attacked = is_attacked(in_board, to, enemy);
+            in_board.cells[from] = king;
+            return !attacked;
+        }
+        if (info.checker_count > 1) {
+            return false;
+        }
+        if (info.checker_count == 1 && !info.evasion[to]) {
+            return false;
+        }
+        const int8 pin = info.pin_direction[from];
+        return pin == -1 || (info.pin_lines[to] & (1 << pin)) != 0;
+    }
+
+    /**
+     * @brief Checks a pseudo-legal move, en passant captures included, against the checkers and pins found by analyze_legality.
+     * 
+     * An en passant capture also empties the jumped pawn's cell, which the checkers and pins do not account for,
+     * so it is played and the king tested directly.
+     * 
+     * @param in_board The packed board to use.
+     * @param info The legality info of the moving side.
+     * @param move The move to check.
+     * @return true if the move does not leave the king attacked.
+     */
+    bool is_legal_move(PackedBoard& in_board, const LegalityInfo& info, const Move& move) {
+        if ((move.flags & Move::Flags::en_passant) == 0 || info.king == -1) {
+            return is_legal_move(in_board, info, move.from, move.to);
+        }
+        const Cell::PieceColor enemy = in_board.cells[info.king].get_opposite_color();
+        const UndoRecord undo = in_board.make_move(move.from, move.to);
+        const bool attacked = is_attacked(in_board, info.king, enemy);
+        in_board.unmake_move(undo);
+        return !attacked;
+    }
+
+    /**
+     * @brief Gets a list of position keys for all pieces of a given color.
+     * 
+     * @param pc The color of the pieces.
+     * @return A list of position keys for all pieces of the given color.
+     */
+    list<int32> get_piece_keys(Cell::PieceColor pc) {
+        return get_piece_keys(packed_board, pc);
+    }
+
+    /**
+     * @brief Gets a list of position keys for all pieces of a given color in a specific board configuration.
+     * 
+     * @param in_board The board configuration to use.
+     * @param pc The color of the pieces.
+     * @return A list of position keys for all pieces of the given color.
+     */
+    list<int32> get_piece_keys(map<int32, Cell*>& in_board, Cell::PieceColor pc) {
+        list<int32> l = {};
+        for(const auto& [key, cell] : in_board) {
+            if (cell->get_piece_color() == pc) {
+                l.push_front(key);
+            }
+        }
+        return l;
+    }
+
+    /**
+     * @brief Gets a list of position keys for all pieces of a given color on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param pc The color of the pieces.
+     * @return A list of position keys for all pieces of the given color.
+     */
+    list<int32> get_piece_keys(PackedBoard& in_board, Cell::PieceColor pc) {
+        CellList cells;
+        get_piece_cells(in_board, pc, cells);
+        list<int32> l = {};
+        for (const uint8 index : cells) {
+            l.push_front(PackedBoard::to_key(index));
+        }
+        return l;
+    }
+
+    /**
+     * @brief Gets the cell indices of all pieces of a given color on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param pc The color of the pieces.
+     * @param out The buffer to fill; it is cleared first.
+     */
+    void get_piece_cells(const PackedBoard& in_board, Cell::PieceColor pc, CellList& out) {
+        out.clear();
+        if (pc != Cell::PieceColor::white && pc != Cell::PieceColor::black) {
+            return;
+        }
+        const int32 side = PackedBoard::side_of(pc);
+        for (int32 i = 0; i < in_board.piece_count[side]; i++) {
+            out.add(in_board.piece_cells[side][i]);
+        }
+    }
+
+    /**
+     * @brief Gets a list of position keys for all pieces of a given color that have valid moves.
+     * 
+     * @param pc The color of the pieces.
+     * @param skip_filter Whether to skip the filtering step to check if the move leaves the king in check.
+     * @return A list of position keys for all pieces of the given color that have valid moves.
+     */
+    list<int32> get_all_piece_move_keys(Cell::PieceColor pc, bool skip_filter = false) {
+        return get_all_piece_move_keys(packed_board, pc, skip_filter);
+    }
+
+    /**
+     * @brief Gets a list of position keys for all pieces of a given color that can move to a specific target position.
+     * 
+     * @param target The target position key.
+     * @param pc The color of the pieces.
+     * @return A list of position keys for all pieces of the given color that can move to the target position.
+     */
+    list<int32> get_possible_move_sources(int32 target, Cell::PieceColor pc) {
+        CellList sources;
+        get_possible_move_sources(packed_board, target, pc, sources);
+        list<int32> l = {};
+        for (const uint8 index : sources) {
+            l.push_front(PackedBoard::to_key(index));
+        }
+        return l;
+    }
+
+    /**
+     * @brief Gets a list of position keys for all pieces of a given color that can move to a specific target position.
+     * 
+     * @param in_board The map representing the chessboard.
+     * @param target The target position key.
+     * @param pc The color of the pieces.
+     * @return A list of position keys for all pieces of the given color that can move to the target position.
+     */
+    list<int32> get_possible_move_sources(map<int32, Cell*>& in_board, int32 target, Cell::PieceColor pc) {
+        list<int32> l = {};
+        auto piece_keys = get_piece_keys(in_board, pc);
+        for (auto piece : piece_keys) {
+            auto moves = get_valid_moves(in_board, piece, true);
+            auto k = find(begin(moves), end(moves), target);
+            if (k != end(moves)) {
+                l.push_front(piece);
+            }
+        }
+        return l;
+    }
+
+    /**
+     * @brief Gets the cells of all pieces of a given color that can move to a specific target position on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param target The target position key.
+     * @param pc The color of the pieces.
+     * @param out The buffer to fill; it is cleared first.
+     */
+    void get_possible_move_sources(PackedBoard& in_board, int32 target, Cell::PieceColor pc, CellList& out) {
+        out.clear();
+        const int32 target_index = PackedBoard::to_index(target);
+        MoveList moves;
+        get_all_piece_moves(in_board, pc, moves, true);
+        for (const Move& move : moves) {
+            if (move.to == target_index) {
+                out.add(move.from);
+            }
+        }
+    }
+
+    /**
+     * @brief Converts a position key to a Position object.
+     * 
+     * @param key The position key to convert.
+     * @return The Position object corresponding to the position key.
+     */
+    Position to_position(int32 key) {
+        Position pos = Position{get_x(key), get_y(key)};
+        return pos;
+    }
+
+    /**
+     * @brief Checks if there are any valid moves for a given color.
+     * 
+     * @param pc The color of the pieces.
+     * @return true if there are valid moves, false otherwise.
+     */
+    bool are_there_valid_moves(Cell::PieceColor pc) {
+        return are_there_valid_moves(packed_board, pc);
+    }
+
+    /**
+     * @brief Checks if there are any valid moves for a given color.
+     * 
+     * @param in_board The map representing the chessboard.
+     * @param pc The color of the pieces.
+     * @return true if there are valid moves, false otherwise.
+     */
+    bool are_there_valid_moves(map<int32, Cell*>& in_board, Cell::PieceColor pc) {
+        auto all_moves = get_all_piece_move_keys(in_board, pc);
+        return all_moves.size() > 0;
+    }
+
+    /**
+     * @brief Checks if there are any valid moves for a given color on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param pc The color of the pieces.
+     * @return true if there are valid moves, false otherwise.
+     */
+    bool are_there_valid_moves(PackedBoard& in_board, Cell::PieceColor pc) {
+        MoveList moves;
+        generate_legal_moves(in_board, pc, moves);
+        return !moves.empty();
+    }
+
+    /**
+     * @brief Moves a piece from a start position to a goal position.
+     * 
+     * @param start The start position.
+     * @param goal The goal position.
+     * @return true if the move was successful, false otherwise.
+     */
+    bool move_piece(Position& start, Position& goal) {
+        const int32 from = PackedBoard::to_index(to_position_key(start));
+        const int32 to = PackedBoard::to_index(to_position_key(goal));
+        if (from >= 0 && to >= 0 && from != to) {
+            // the packed board knows about en passant, the map only follows it
+            record_move(from, to);
+            sync_board_map(history.back().undo);
+            return true;
+        }
+        return move_piece(board_map, start, goal);
+    }
+
+    /**
+     * @brief Moves a piece from a start position to a goal position.
+     * 
+     * @param in_board The map representing the chessboard.
+     * @param start The start position.
+     * @param goal The goal position.
+     * @return true if the move was successful, false otherwise.
+     */
+    bool move_piece(map<int32, Cell*>& in_board, Position& start, Position& goal) {
+        bool is_main_board = &in_board == &board_map;
+
+        #if WITH_EDITOR
+        // disabled for now, might be costly
+        // UE_LOG(LogChessEngine, Log, TEXT("%s: Move piece from (%d, %d) to (%d, %d)"), is_main_board ? TEXT("MAIN") : TEXT("INNER"), start.x, start.y, goal.x, goal.y);
+        #endif
+
+        int32 sp = to_position_key(start);
+        if (is_valid_position(in_board, sp) && is_valid_position(in_board, goal)) {
+            Cell::PieceType pt = in_board[sp]->get_piece_type();
+            Cell::PieceColor pc = in_board[sp]->get_piece_color();
+            in_board[sp]->remove_piece();
+            set_piece(in_board, goal, pt, pc);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Moves a piece from a start position to a goal position on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param start The start position.
+     * @param goal The goal position.
+     * @return true if the move was successful, false otherwise.
+     */
+    bool move_piece(PackedBoard& in_board, Position& start, Position& goal) {
+        int32 from = PackedBoard::to_index(to_position_key(start));
+        int32 to = PackedBoard::to_index(to_position_key(goal));
+        if (from >= 0 && to >= 0 && from != to) {
+            in_board.make_move(from, to);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Plays a move in place on a packed board.
+     * 
+     * Unlike move_piece this keeps what is needed to restore the position, so search and legality checks
+     * can run on a single mutable board.
+     * 
+     * @param in_board The packed board to use.
+     * @param start_key The key of the start position.
+     * @param goal_key The key of the goal position.
+     * @return The undo record for unmake_move.
+     */
+    UndoRecord make_move(PackedBoard& in_board, int32 start_key, int32 goal_key) {
+        return in_board.make_move(PackedBoard::to_index(start_key), PackedBoard::to_index(goal_key));
+    }
+
+    /**
+     * @brief Takes back a move played with make_move.
+     * 
+     * @param in_board The packed board to use.
+     * @param undo The undo record returned by make_move.
+     */
+    void unmake_move(PackedBoard& in_board, const UndoRecord& undo) {
+        in_board.unmake_move(undo);
+    }
+
+    /**
+     * @brief Takes back the last move played on the main board with move_piece.
+     * 
+     * The move stays in the history and can be played again with redo_move until another move is played.
+     * 
+     * @return true if a move was taken back, false if there was none.
+     */
+    bool undo_move() {
+        if (history_position == 0) {
+            return false;
+        }
+        const UndoRecord& undo = history[--history_position].undo;
+        packed_board.unmake_move(undo);
+        sync_board_map(undo);
+        return true;
+    }
+
+    /**
+     * @brief Plays again the last move taken back with undo_move.
+     * 
+     * @return true if a move was played, false if there was none.
+     */
+    bool redo_move() {
+        if (history_position == static_cast<int32>(history.size())) {
+            return false;
+        }
+        HistoryEntry& entry = history[history_position++];
+        entry.undo = packed_board.make_move(entry.undo.from, entry.undo.to);
+        sync_board_map(entry.undo);
+        return true;
+    }
+
+    /**
+     * @brief Gets how many moves of the history have been played on the main board; undo_move can take back that many.
+     */
+    int32 get_history_position() const {
+        return history_position;
+    }
+
+    /**
+     * @brief Gets how many moves the history holds, including the ones taken back and not played again.
+     */
+    int32 get_history_size() const {
+        return static_cast<int32>(history.size());
+    }
+
+    /**
+     * @brief Gets the position the history starts from, the one load_history replays its moves on.
+     */
+    PackedBoard get_history_start() const {
+        PackedBoard start = packed_board;
+        for (int32 i = history_position - 1; i >= 0; i--) {
+            start.unmake_move(history[i].undo);
+        }
+        return start;
+    }
+
+    /**
+     * @brief Forgets every recorded move; the current position becomes the start of the history.
+     */
+    void clear_history() {
+        history.clear();
+        history_position = 0;
+    }
+
+    /**
+     * @brief Counts how often the current position, side to move included, occurred before in the played history.
+     * 
+     * Compares position hashes only, and stops at the last capture or pawn move since nothing before it can occur again.
+     * 
+     * @return The number of earlier occurrences; 2 means the position is on the board for the third time.
+     */
+    int32 count_repetitions() const {
+        int32 count = 0;
+        for (int32 i = history_position - 1; i >= 0; i--) {
+            const HistoryEntry& entry = history[i];
+            if (entry.undo.captured.has_piece() || entry.undo.moved.get_piece_type() == Cell::PieceType::pawn) {
+                break;
+            }
+            if (entry.hash_before == packed_board.hash) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Counts the moves played since the last capture or pawn move, for the fifty-move rule.
+     * 
+     * Only the recorded history counts, a position set up with set_piece starts at 0.
+     */
+    int32 count_reversible_plies() const {
+        int32 count = 0;
+        for (int32 i = history_position - 1; i >= 0; i--) {
+            const HistoryEntry& entry = history[i];
+            if (entry.undo.captured.has_piece() || entry.undo.moved.get_piece_type() == Cell::PieceType::pawn) {
+                break;
+            }
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Gets the hashes of the positions the last count_reversible_plies moves were played from, oldest first.
+     * 
+     * A search loads them into its RepetitionHistory, so lines back into the game's past are recognised as repetitions.
+     */
+    vector<uint64> get_reversible_hashes() const {
+        const int32 count = count_reversible_plies();
+        vector<uint64> result;
+        result.reserve(count);
+        for (int32 i = history_position - count; i < history_position; i++) {
+            result.push_back(history[i].hash_before);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Writes the played moves of the history as two bytes each, the dense from and to cell indices.
+     * 
+     * @return The move list, to be replayed from the start of the history by load_history.
+     */
+    vector<uint8> serialize_history() const {
+        vector<uint8> result;
+        result.reserve(history_position * 2);
+        for (int32 i = 0; i < history_position; i++) {
+            result.push_back(history[i].undo.from);
+            result.push_back(history[i].undo.to);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Takes back every played move, then plays a move list written by serialize_history.
+     * 
+     * Replay stops at the first move that is not a legal move of the side to move, so a corrupted list never leaves the
+     * board in a position the rules could not reach.
+     * 
+     * @param moves The move list.
+     * @return true if every move was played, false otherwise.
+     */
+    bool load_history(const vector<uint8>& moves) {
+        while (undo_move()) {
+        }
+        history.clear();
+        for (size_t i = 0; i + 1 < moves.size(); i += 2) {
+            const int32 from = moves[i];
+            const int32 to = moves[i + 1];
+            if (from >= PackedBoard::cell_count || to >= PackedBoard::cell_count || !is_legal_move(from, to)) {
+                return false;
+            }
+            record_move(from, to);
+            sync_board_map(history.back().undo);
+        }
+        return moves.size() % 2 == 0;
+    }
+
+    /**
+     * @brief Sets a piece at a given position.
+     * 
+     * @param pos The position to set the piece at.
+     * @param pt The type of the piece.
+     * @param pc The color of the piece.
+     * @return true if the piece was set successfully, false otherwise.
+     */
+    bool set_piece(Position& pos, Cell::PieceType pt, Cell::PieceColor pc) {
+        // the recorded moves no longer lead to this position
+        clear_history();
+        set_piece(packed_board, pos, pt, pc);
+        return set_piece(board_map, pos, pt, pc);
+    }
+
+    /**
+     * @brief Sets a piece at a given position.
+     * 
+     * @param in_board The map representing the chessboard.
+     * @param pos The position to set the piece at.
+     * @param pt The type of the piece.
+     * @param pc The color of the piece.
+     * @return true if the piece was set successfully, false otherwise.
+     */
+    bool set_piece(map<int32, Cell*>& in_board, Position& pos, Cell::PieceType pt, Cell::PieceColor pc) {
+        int32 key = to_position_key(pos);
+        if (!is_valid_position(in_board, key)) {
+            return false;
+        }
+        in_board[key]->set_piece(pt, pc);
+        return false;
+    }
+
+    /**
+     * @brief Sets a piece at a given position on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param pos The position to set the piece at.
+     * @param pt The type of the piece.
+     * @param pc The color of the piece.
+     * @return true if the piece was set successfully, false otherwise.
+     */
+    bool set_piece(PackedBoard& in_board, Position& pos, Cell::PieceType pt, Cell::PieceColor pc) {
+        int32 index = PackedBoard::to_index(to_position_key(pos));
+        if (index < 0) {
+            return false;
+        }
+        in_board.set_cell(index, pt, pc);
+        return true;
+    }
+
+    /**
+     * @brief Replaces the whole main board, side to move included, with a packed position.
+     * 
+     * Like set_piece it starts a new history.
+     * 
+     * @param in_board The position to copy.
+     */
+    void set_position(const PackedBoard& in_board) {
+        clear_history();
+        packed_board = in_board;
+        for (int32 index = 0; index < PackedBoard::cell_count; index++) {
+            const Square square = packed_board.get_square(index);
+            board_map[PackedBoard::to_key(index)]->set_piece(square.get_piece_type(), square.get_piece_color());
+        }
+    }
+
+    /**
+     * @brief Gets the standard starting position, white at the bottom of each column and white to move; built on first use.
+     * 
+     * @return The position, to copy onto a board with set_position.
+     */
+    static const PackedBoard& starting_position() {
+        static const PackedBoard position = build_starting_position();
+        return position;
+    }
+
+    /**
+     * @brief Checks if a piece at a given position can be captured by an opponent.
+     * 
+     * @param pos The position of the piece.
+     * @return true if the piece can be captured, false otherwise.
+     */
+    bool can_be_captured(Position& pos) {
+        return can_be_captured(packed_board, pos);
+    }
+
+    /**
+     * @brief Checks if a piece at a given position can be captured by an opponent.
+     * 
+     * @param in_board The map representing the chessboard.
+     * @param pos The position of the piece.
+     * @return true if the piece can be captured, false otherwise.
+     */
+    bool can_be_captured(map<int32, Cell*>& in_board, Position& pos) {
+        int32 key = to_position_key(pos);
+        return can_be_captured(in_board, key);
+    }
+
+    /**
+     * @brief Checks if a piece at a given position can be captured by an opponent on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param pos The position of the piece.
+     * @return true if the piece can be captured, false otherwise.
+     */
+    bool can_be_captured(PackedBoard& in_board, Position& pos) {
+        int32 key = to_position_key(pos);
+        return can_be_captured(in_board, key);
+    }
+
+    /**
+     * @brief Evaluates the current board state and returns a score.
+     * 
+     * @return The score of the current board state.
+     */
+    int32 evaluate() {
+        return evaluate(packed_board);
+    }
+
+    /**
+     * @brief Evaluates the target board state and returns a score.
+     * 
+     * @param in_board The map representing the chessboard.
+     * @return The score of the current board state.
+     */
+    int32 evaluate(map<int32, Cell*>& in_board)
+    {
+        return evaluate_board(in_board);
+    }
+
+    /**
+     * @brief Evaluates the target packed board state and returns a score.
+     *
+     * Material and piece-square terms come from the counters the packed board keeps up to date on every move,
+     * only the check term looks at the board, and only from the two kings' cells outward.
+     *
+     * @param in_board The packed board to use.
+     * @return The score of the current board state, positive when white is better.
+     */
+    int32 evaluate(PackedBoard& in_board)
+    {
+        HEXACHESS_TRACE_SCOPE(Hexachess_Evaluate);
+        int32 score = in_board.positional_score;
+        for (int32 type = Cell::PieceType::pawn; type < Cell::PieceType::king; type++) {
+            score += (in_board.type_count[0][type] - in_board.type_count[1][type]) * piece_values[type];
+        }
+
+        // check is severely punished
+        const int32 white_king = in_board.get_king_cell(Cell::PieceColor::white);
+        if (white_king >= 0 && is_attacked(in_board, white_king, Cell::PieceColor::black)) {
+            score -= piece_values[Cell::PieceType::king];
+        }
+        const int32 black_king = in_board.get_king_cell(Cell::PieceColor::black);
+        if (black_king >= 0 && is_attacked(in_board, black_king, Cell::PieceColor::white)) {
+            score += piece_values[Cell::PieceType::king];
+        }
+        return score;
+    }
+
+    /**
+     * @brief Builds a packed copy of the main board.
+     * 
+     * @return The packed board.
+     */
+    PackedBoard to_packed_board() {
+        return packed_board;
+    }
+
+    /**
+     * @brief Gets the Zobrist hash of the main board, including the side to move.
+     * 
+     * @return The position hash.
+     */
+    uint64 position_hash() const {
+        return packed_board.hash;
+    }
+
+    /**
+     * @brief Gets the Zobrist hash of a packed board, including the side to move.
+     * 
+     * @param in_board The packed board to use.
+     * @return The position hash.
+     */
+    uint64 position_hash(const PackedBoard& in_board) const {
+        return in_board.hash;
+    }
+
+    /**
+     * @brief Builds a packed copy of the target board.
+     * 
+     * @param in_board The map representing the chessboard.
+     * @return The packed board.
+     */
+    PackedBoard to_packed_board(map<int32, Cell*>& in_board) {
+        PackedBoard packed;
+        for (const auto& [key, cell] : in_board) {
+            packed.set_cell(PackedBoard::to_index(key), cell->get_piece_type(), cell->get_piece_color());
+        }
+        return packed;
+    }
+
+    /**
+     * @brief Gets the move tables shared by all boards, built on first use.
+     * 
+     * @return The precomputed neighbor, ray, knight and pawn tables.
+     */
+    static const HexMoveTables& move_tables() {
+        static const HexMoveTables tables = build_move_tables();
+        return tables;
+    }
+
+    map<int32, Cell*> copy_board_map() {
+        HEXACHESS_LLM_SCOPE(HexachessEngine);
+        map<int32, Cell*> board_map_copy = {};
+        for (const auto& [key, cell] : this->board_map) {
+            board_map_copy[key] = new Cell(*cell);
+        }
+        return board_map_copy;
+    }
+
+    map<int32, Cell*> copy_board_map(map<int32, Cell*>& in_board) {
+        // one cell per position on every call, the map board's legality filter makes one copy per candidate move
+        HEXACHESS_LLM_SCOPE(HexachessEngine);
+        map<int32, Cell*> board_map_copy = {};
+        for (const auto& [key, cell] : in_board) {
+            board_map_copy[key] = new Cell(*cell);
+        }
+        return board_map_copy;
+    }
+
+    void clear_board_map(std::map<int32, Cell*>& in_board) {
+        for (auto& pair : in_board) {
+            delete pair.second;  // Deletes the pointer
+        }
+        in_board.clear();  // Clears the map
+    }
+
+    map<int32, Cell*> board_map;
+
+    // packed mirror of board_map, kept in sync by set_piece and move_piece on the main board
+    PackedBoard packed_board;
+
+private:
+    // one move of the main board's history and the hash of the position it was played from
+    struct HistoryEntry {
+        UndoRecord undo;
+        uint64 hash_before = 0;
+    };
+
+    // moves played with move_piece since the last set_piece; the ones past history_position were taken back
+    vector<HistoryEntry> history;
+    int32 history_position = 0;
+
+    // plays a move on packed_board and records it, dropping the moves that were taken back
+    void record_move(const int32 from, const int32 to) {
+        HEXACHESS_LLM_SCOPE(HexachessEngine);
+        history.resize(history_position);
+        HistoryEntry entry;
+        entry.hash_before = packed_board.hash;
+        entry.undo = packed_board.make_move(from, to);
+        history.push_back(entry);
+        history_position++;
+    }
+
+    // copies the cells a move changed from packed_board to board_map after the packed board played or took it back
+    void sync_board_map(const UndoRecord& undo) {
+        for (const int32 index : {undo.from, undo.to, undo.captured_cell}) {
+            const Square square = packed_board.get_square(index);
+            board_map[PackedBoard::to_key(index)]->set_piece(square.get_piece_type(), square.get_piece_color());
+        }
+    }
+
+    using TMoveFn = int32 (*)(const int32);
+
+    static constexpr int32 median = GlinskiGeometry::median;
+    static constexpr int32 max = GlinskiGeometry::max;
+    static constexpr int32 step_x = GlinskiGeometry::step_x;
+    static inline const vector<int32> white_pawn_cell_keys = make_pawn_start_keys<GlinskiGeometry>(0);
+    static inline const vector<int32> black_pawn_cell_keys = make_pawn_start_keys<GlinskiGeometry>(1);
+
+    /**
+     * @brief Converts x and y coordinates to a position key.
+     * 
+     * @param x The x-coordinate.
+     * @param y The y-coordinate.
+     * @return The position key.
+     */
+    inline int32 to_position_key(int32 x, int32 y) {
+        return (x << 8) + y;
+    }
+
+    /**
+     * @brief Converts a Position object to a position key.
+     * 
+     * @param pos The Position object.
+     * @return The position key.
+     */
+    inline int32 to_position_key(Position pos) {
+        return to_position_key(pos.x, pos.y);
+    }
+
+    /**
+     * @brief Checks if a given position key is a valid position on the board.
+     * 
+     * @param key The position key.
+     * @return true if the position is valid, false otherwise.
+     */
+    inline bool is_valid_position(int32 key) {
+        return is_valid_position(board_map, key);
+    }
+
+    /**
+     * @brief Checks if a given position key is a valid position on a specific board configuration.
+     * 
+     * @param in_board The board configuration to use.
+     * @param key The position key.
+     * @return true if the position is valid, false otherwise.
+     */
+    inline bool is_valid_position(map<int32, Cell*>& in_board, int32 key) {
+        return in_board.find(key) != in_board.end();
+    }
+
+    /**
+     * @brief Checks if a given position is a valid position on the board.
+     * 
+     * @param pos The position to check.
+     * @return true if the position is valid, false otherwise.
+     */
+    inline bool is_valid_position(Position& pos) {
+        return is_valid_position(board_map, pos);
+    }
+
+    /**
+     * @brief Checks if the given position is a valid position on the board.
+     *
+     * This function checks if the given position is a valid position on the board.
+     *
+     * @param in_board The map representing the chessboard.
+     * @param pos The position to check.
+     * @return True if the position is valid, false otherwise.
+     */
+    inline bool is_valid_position(map<int32, Cell*>& in_board, Position& pos) {
+        return is_valid_position(in_board, to_position_key(pos));
+    }
+
+    /**
+     * @brief Material and check scoring of the map board, without the piece-square terms of the packed evaluation.
+     * 
+     * @param in_board The board to evaluate.
+     * @return The score of the board state.
+     */
+    template <typename TBoard>
+    int32 evaluate_board(TBoard& in_board)
+    {
+        // set up some scoring for figures
+        int32 score = 0;
+
+        // get all pieces
+        auto white_pieces = get_piece_keys(in_board, Cell::PieceColor::white);
+        auto black_pieces = get_piece_keys(in_board, Cell::PieceColor::black);
+
+        // count each piece with modifier based on its type
+        // whites are positive while blacks are negative
+        // check is severely punished
+        for (auto piece_key : white_pieces)
+        {
+            if (cell_at(in_board, piece_key).get_piece_type() == Cell::PieceType::king)
+            {
+                if (can_be_captured(in_board, piece_key))
+                {
+                    score -= piece_values[Cell::PieceType::king];
+                }
+            }
+            else
+            {
+                score += piece_values[cell_at(in_board, piece_key).get_piece_type()];
+            }
+        }
+        for (auto piece_key : black_pieces)
+        {
+            if (cell_at(in_board, piece_key).get_piece_type() == Cell::PieceType::king)
+            {
+                if (can_be_captured(in_board, piece_key))
+                {
+                    score += piece_values[Cell::PieceType::king];
+                }
+            }
+            else
+            {
+                score -= piece_values[cell_at(in_board, piece_key).get_piece_type()];
+            }
+        }
+
+        return score;
+    }
+
+    inline Cell cell_at(map<int32, Cell*>& in_board, const int32 key) {
+        return *in_board[key];
+    }
+
+    inline Cell cell_at(PackedBoard& in_board, const int32 key) {
+        return in_board.get_cell(PackedBoard::to_index(key));
+    }
+
+    // the shadow a pawn of the given color may take en passant, -1 if there is none; map boards keep no shadow
+    inline int32 shadow_key_at(map<int32, Cell*>&, Cell::PieceColor) {
+        return -1;
+    }
+
+    inline int32 shadow_key_at(PackedBoard& in_board, Cell::PieceColor pc) {
+        if (in_board.shadow_cell < 0 || in_board.black_to_move != (pc == Cell::PieceColor::black)) {
+            return -1;
+        }
+        return PackedBoard::to_key(in_board.shadow_cell);
+    }
+
+    /**
+     * @brief Checks if a given position key is a valid position on a packed board.
+     * 
+     * @param key The position key.
+     * @return true if the position is valid, false otherwise.
+     */
+    inline bool is_valid_position(PackedBoard&, int32 key) {
+        return PackedBoard::to_index(key) >= 0;
+    }
+
+    /**
+     * @brief Dispatches move generation on the piece type of the given cell.
+     *
+     * @param in_board The board to generate moves on.
+     * @param l The list to which the moves will be added.
+     * @param key The key position of the piece.
+     * @param cell The cell object representing the piece.
+     */
+    template <typename TBoard>
+    void add_piece_moves(TBoard& in_board, list<int32>& l, int32 key, Cell* cell) {
+        switch (cell->get_piece_type()) {
+            case Cell::PieceType::none:
+                break;
+            case Cell::PieceType::pawn:
+                add_pawn_moves(in_board, l, key, cell);
+                break;
+            case Cell::PieceType::bishop:
+                add_bishop_moves(in_board, l, key, cell);
+                break;
+            case Cell::PieceType::knight:
+                add_knight_moves(in_board, l, key, cell);
+                break;
+            case Cell::PieceType::rook:
+                add_rook_moves(in_board, l, key, cell);
+                break;
+            case Cell::PieceType::queen:
+                add_queen_moves(in_board, l, key, cell);
+                break;
+            case Cell::PieceType::king:
+                add_king_moves(in_board, l, key, cell);
+                break;
+        }
+    }
+
+    /**
+     * @brief Table driven move generation for packed boards.
+     *
+     * Mirrors the templated generators below but walks the precomputed HexMoveTables instead of the move functions.
+     * The color is resolved once here, the generators for each color and piece type are instantiated separately.
+     *
+     * @param in_board The packed board.
+     * @param l The list to which the moves will be added.
+     * @param index The cell index of the piece.
+     * @param piece The piece to move.
+     */
+    void add_piece_moves(PackedBoard& in_board, MoveList& l, int32 index, const Square piece) {
+        switch (piece.get_piece_color()) {
+            case Cell::PieceColor::white:
+                add_piece_moves<Cell::PieceColor::white>(in_board, l, index, piece.get_piece_type());
+                break;
+            case Cell::PieceColor::black:
+                add_piece_moves<Cell::PieceColor::black>(in_board, l, index, piece.get_piece_type());
+                break;
+            default:
+                break;
+        }
+    }
+
+    template <Cell::PieceColor Color>
+    void add_piece_moves(PackedBoard& in_board, MoveList& l, int32 index, Cell::PieceType type) {
+        switch (type) {
+            case Cell::PieceType::none:
+                break;
+            case Cell::PieceType::pawn:
+                generate<Color, Cell::PieceType::pawn>(in_board, l, index);
+                break;
+            case Cell::PieceType::bishop:
+                generate<Color, Cell::PieceType::bishop>(in_board, l, index);
+                break;
+            case Cell::PieceType::knight:
+                generate<Color, Cell::PieceType::knight>(in_board, l, index);
+                break;
+            case Cell::PieceType::rook:
+                generate<Color, Cell::PieceType::rook>(in_board, l, index);
+                break;
+            case Cell::PieceType::queen:
+                generate<Color, Cell::PieceType::queen>(in_board, l, index);
+                break;
+            case Cell::PieceType::king:
+                generate<Color, Cell::PieceType::king>(in_board, l, index);
+                break;
+        }
+    }
+
+    void add_side_moves(PackedBoard& in_board, Cell::PieceColor pc, MoveList& l) {
+        switch (pc) {
+            case Cell::PieceColor::white:
+                add_side_moves<Cell::PieceColor::white>(in_board, l);
+                break;
+            case Cell::PieceColor::black:
+                add_side_moves<Cell::PieceColor::black>(in_board, l);
+                break;
+            default:
+                break;
+        }
+    }
+
+    template <Cell::PieceColor Color>
+    void add_side_moves(PackedBoard& in_board, MoveList& l) {
+        constexpr int32 side = PackedBoard::side_of(Color);
+        for (int32 i = 0; i < in_board.piece_count[side]; i++) {
+            const uint8 index = in_board.piece_cells[side][i];
+            add_piece_moves<Color>(in_board, l, index, in_board.cells[index].get_piece_type());
+        }
+    }
+
+    /**
+     * @brief The moves of one piece of a known color and type.
+     *
+     * The pawn direction, the ray directions and the color of the pieces that can be taken are all compile time constants,
+     * so each instantiation is a straight walk over the piece's tables.
+     *
+     * @param in_board The packed board.
+     * @param l The list to which the moves will be added.
+     * @param index The cell index of the piece.
+     */
+    template <Cell::PieceColor Color, Cell::PieceType Type>
+    void generate(PackedBoard& in_board, MoveList& l, int32 index) {
+        constexpr Cell::PieceColor enemy = Color == Cell::PieceColor::white ? Cell::PieceColor::black : Cell::PieceColor::white;
+        const HexMoveTables& tables = move_tables();
+        if constexpr (Type == Cell::PieceType::pawn) {
+            constexpr int32 side = PackedBoard::side_of(Color);
+            const int32 move = tables.pawn_push[side][index];
+            if (move != HexMoveTables::sentinel && !in_board.cells[move].has_piece()) {
+                l.add(index, move);
+                const int32 jump = tables.pawn_push[side][move];
+                if (tables.pawn_initial[side][index] && jump != HexMoveTables::sentinel && !in_board.cells[jump].has_piece()) {
+                    l.add(index, jump, Move::Flags::pawn_jump);
+                }
+            }
+            for (const int8 take : tables.pawn_takes[side][index]) {
+                if (take == HexMoveTables::sentinel) {
+                    continue;
+                }
+                const Square square = in_board.cells[take];
+                if (square.has_piece() && square.get_piece_color() == enemy) {
+                    l.add(index, take, Move::Flags::capture);
+                } else if (take == in_board.shadow_cell && in_board.black_to_move == (side == 1)) {
+                    l.add(index, take, Move::Flags::capture | Move::Flags::en_passant);
+                }
+            }
+        } else if constexpr (Type == Cell::PieceType::knight || Type == Cell::PieceType::king) {
+            const int8* targets = Type == Cell::PieceType::knight ? tables.knight_targets[index] : tables.king_targets[index];
+            for (; *targets != HexMoveTables::sentinel; targets++) {
+                const Square square = in_board.cells[*targets];
+                if (!square.has_piece()) {
+                    l.add(index, *targets);
+                } else if (square.get_piece_color() == enemy) {
+                    l.add(index, *targets, Move::Flags::capture);
+                }
+            }
+        } else {
+            constexpr int32 first_direction = Type == Cell::PieceType::rook ? HexMoveTables::first_rook_direction : HexMoveTables::first_bishop_direction;
+            constexpr int32 last_direction = Type == Cell::PieceType::bishop ? HexMoveTables::first_rook_direction : HexMoveTables::direction_count;
+            const auto& rays = tables.rays[index];
+            for (int32 direction = first_direction; direction < last_direction; direction++) {
+                for (const int8* target = rays[direction]; *target != HexMoveTables::sentinel; target++) {
+                    const Square square = in_board.cells[*target];
+                    if (square.has_piece()) {
+                        if (square.get_piece_color() == enemy) {
+                            l.add(index, *target, Move::Flags::capture);
+                        }
+                        break;
+                    }
+                    l.add(index, *target);
+                }
+            }
+        }
+    }
+
+    static PackedBoard build_starting_position() {
+        PackedBoard position;
+        for (const StartingPiece& piece : starting_layout) {
+            position.set_cell(PackedBoard::to_index((piece.x << 8) + piece.y), piece.type, Cell::PieceColor::white);
+            const int32 black_y = hex_column_height(piece.x) - 1 - piece.y;
+            position.set_cell(PackedBoard::to_index((piece.x << 8) + black_y), piece.type, Cell::PieceColor::black);
+        }
+        return position;
+    }
+
+    /**
+     * @brief Builds the HexMoveTables by running the legacy move functions once for every cell.
+     *
+     * Generating the tables from the same functions keeps both generators in exact agreement.
+     *
+     * @return The filled tables.
+     */
+    static HexMoveTables build_move_tables() {
+        HexMoveTables tables;
+        const TMoveFn directions[HexMoveTables::direction_count] = { &move_diagonally_top_right
+                                                                   , &move_diagonally_top_left
+                                                                   , &move_diagonally_bottom_right
+                                                                   , &move_diagonally_bottom_left
+                                                                   , &move_diagonally_right
+                                                                   , &move_diagonally_left
+                                                                   , &move_horizontally_top_right
+                                                                   , &move_horizontally_top_left
+                                                                   , &move_horizontally_bottom_right
+                                                                   , &move_horizontally_bottom_left
+                                                                   , &move_vertically_up
+                                                                   , &move_vertically_down
+                                                                   };
+        const auto fill_targets = [](int8* out, const vector<int32>& keys) {
+            int32 count = 0;
+            for (const int32 k : keys) {
+                const int32 target = PackedBoard::to_index(k);
+                if (target >= 0) {
+                    out[count++] = static_cast<int8>(target);
+                }
+            }
+            out[count] = HexMoveTables::sentinel;
+        };
+
+        for (int32 index = 0; index < HexIndexTable::cell_count; index++) {
+            const int32 key = PackedBoard::to_key(index);
+
+            for (int32 direction = 0; direction < HexMoveTables::direction_count; direction++) {
+                const TMoveFn fn = directions[direction];
+                tables.neighbors[index][direction] = static_cast<int8>(PackedBoard::to_index(fn(key)));
+
+                int32 length = 0;
+                for (int32 current = PackedBoard::to_index(fn(key)); current >= 0; current = PackedBoard::to_index(fn(PackedBoard::to_key(current)))) {
+                    tables.rays[index][direction][length++] = static_cast<int8>(current);
+                }
+                tables.rays[index][direction][length] = HexMoveTables::sentinel;
+            }
+
+            // same order as add_king_moves
+            fill_targets(tables.king_targets[index], {
+                move_vertically_up(key), move_vertically_down(key),
+                move_horizontally_top_right(key), move_horizontally_top_left(key),
+                move_horizontally_bottom_right(key), move_horizontally_bottom_left(key),
+                move_diagonally_top_right(key), move_diagonally_top_left(key),
+                move_diagonally_bottom_right(key), move_diagonally_bottom_left(key),
+                move_diagonally_right(key), move_diagonally_left(key)
+            });
+
+            // same order as add_knight_moves
+            const int32 up = move_vertically_up(move_vertically_up(key));
+            const int32 down = move_vertically_down(move_vertically_down(key));
+            const int32 top_right = move_horizontally_top_right(move_horizontally_top_right(key));
+            const int32 bottom_right = move_horizontally_bottom_right(move_horizontally_bottom_right(key));
+            const int32 bottom_left = move_horizontally_bottom_left(move_horizontally_bottom_left(key));
+            const int32 top_left = move_horizontally_top_left(move_horizontally_top_left(key));
+            fill_targets(tables.knight_targets[index], {
+                move_horizontally_top_right(up), move_horizontally_top_left(up),
+                move_horizontally_bottom_right(down), move_horizontally_bottom_left(down),
+                move_vertically_up(top_right), move_horizontally_bottom_right(top_right),
+                move_vertically_down(bottom_right), move_horizontally_top_right(bottom_right),
+                move_vertically_down(bottom_left), move_horizontally_top_left(bottom_left),
+                move_vertically_up(top_left), move_horizontally_bottom_left(top_left)
+            });
+
+            tables.pawn_push[0][index] = static_cast<int8>(PackedBoard::to_index(move_vertically_up(key)));
+            tables.pawn_push[1][index] = static_cast<int8>(PackedBoard::to_index(move_vertically_down(key)));
+            tables.pawn_takes[0][index][0] = static_cast<int8>(PackedBoard::to_index(move_horizontally_top_left(key)));
+            tables.pawn_takes[0][index][1] = static_cast<int8>(PackedBoard::to_index(move_horizontally_top_right(key)));
+            tables.pawn_takes[1][index][0] = static_cast<int8>(PackedBoard::to_index(move_horizontally_bottom_left(key)));
+            tables.pawn_takes[1][index][1] = static_cast<int8>(PackedBoard::to_index(move_horizontally_bottom_right(key)));
+            tables.pawn_initial[0][index] = find(begin(white_pawn_cell_keys), end(white_pawn_cell_keys), key) != end(white_pawn_cell_keys);
+            tables.pawn_initial[1][index] = find(begin(black_pawn_cell_keys), end(black_pawn_cell_keys), key) != end(black_pawn_cell_keys);
+            tables.pawn_attackers[0][index][0] = tables.pawn_attackers[0][index][1] = HexMoveTables::sentinel;
+            tables.pawn_attackers[1][index][0] = tables.pawn_attackers[1][index][1] = HexMoveTables::sentinel;
+        }
+        for (int32 side = 0; side < 2; side++) {
+            for (int32 index = 0; index < HexIndexTable::cell_count; index++) {
+                for (const int8 take : tables.pawn_takes[side][index]) {
+                    if (take != HexMoveTables::sentinel) {
+                        int8* attackers = tables.pawn_attackers[side][take];
+                        attackers[attackers[0] == HexMoveTables::sentinel ? 0 : 1] = static_cast<int8>(index);
+                    }
+                }
+            }
+        }
+        return tables;
+    }
+
+    /**
+     * @brief Adds all possible moves for a pawn to the given list of cells.
+     *
+     * This function calculates all possible moves for a pawn from the given key position and adds them to the provided list of cells.
+     *
+     * @param in_board The map representing the chessboard.
+     * @param l The list of cells to which the pawn moves will be added.
+     * @param key The key position from which the pawn moves will be calculated.
+     * @param cell The cell object representing the pawn.
+     */
+    template <typename TBoard>
+    void add_pawn_moves(TBoard& in_board, list<int32>& l, int32 key, Cell* cell) {
+        TMoveFn fn_move, fn_take_1, fn_take_2;
+        switch (cell->get_piece_color()) {
+            case Cell::PieceColor::white:
+                fn_move = &Board::move_vertically_up;
+                fn_take_1 = &Board::move_horizontally_top_left;
+                fn_take_2 = &Board::move_horizontally_top_right;
+                break;
+            case Cell::PieceColor::black:
+                fn_move = &Board::move_vertically_down;
+                fn_take_1 = &Board::move_horizontally_bottom_left;
+                fn_take_2 = &Board::move_horizontally_bottom_right;
+                break;
+            default:
+                return;
+        }
+        int32 move = fn_move(key);
+        if (is_valid_position(in_board, move)) {
+            add_if_valid(in_board, l, move, cell, false);
+            if (!cell_at(in_board, move).has_piece() && is_initial_pawn_cell(key, cell)) {
+                add_if_valid(in_board, l, fn_move(move), cell, false);
+            }
+        }
+        int32 take = fn_take_1(key);
+        add_pawn_take_if_valid(in_board, l, take, cell);
+        take = fn_take_2(key);
+        add_pawn_take_if_valid(in_board, l, take, cell);
+    }
+
+    /**
+     * @brief Adds a pawn take move to the given list of cells if it is a valid move.
+     *
+     * This function adds a pawn take move to the given list of cells if it is a valid move.
+     *
+     * @param in_board The map representing the chessboard.
+     * @param l The list of cells to which the pawn take move will be added.
+     * @param key The key position of the take move.
+     * @param cell The cell object representing the pawn.
+     */
+    template <typename TBoard>
+    void add_pawn_take_if_valid(TBoard& in_board, list<int32>& l, int32 key, Cell* cell) {
+        if (!is_valid_position(in_board, key)) {
+            return;
+        }
+        if (cell_at(in_board, key).has_piece_of_opposite_color(cell) || key == shadow_key_at(in_board, cell->get_piece_color())) {
+            l.push_front(key);
+        }
+    }
+
+    /**
+     * @brief Checks if the given key represents an initial pawn cell.
+     *
+     * This function checks if the given key represents an initial pawn cell.
+     *
+     * @param key The key position to check.
+     * @param cell The cell object representing the pawn.
+     * @return True if the key represents an initial pawn cell, false otherwise.
+     */
+    bool is_initial_pawn_cell(const int32 key, Cell* cell) {
+        const vector<int32>* cell_keys;
+        switch (cell->get_piece_color()) {
+            case Cell::PieceColor::white:
+                cell_keys = &white_pawn_cell_keys;
+                break;
+            case Cell::PieceColor::black:
+                cell_keys = &black_pawn_cell_keys;
+                break;
+            default:
+                return false;
+        }
+        auto arr_end = end(*cell_keys);
+        auto k = find(begin(*cell_keys), arr_end, key);
+        return k != arr_end;
+    }
+
+    /**
+     * @brief Adds all possible moves for a bishop to the given list of cells.
+     *
+     * This function calculates all possible moves for a bishop from the given key position and adds them to the provided list of cells.
+     *
+     * @param in_board The map representing the chessboard.
+     * @param l The list of cells to which the bishop moves will be added.
+     * @param key The key position from which the bishop moves will be calculated.
+     * @param cell The cell object representing the bishop.
+     */
+    template <typename TBoard>
+    void add_bishop_moves(TBoard& in_board, list<int32>& l, int32 key, Cell* cell) {
+        TMoveFn fns[6] = { &move_diagonally_top_right
+                         , &move_diagonally_top_left
+                         , &move_diagonally_bottom_right
+                         , &move_diagonally_bottom_left
+                         , &move_diagonally_right
+                         , &move_diagonally_left
+                         };
+        add_valid_moves(in_board, l, key, fns, 6, cell);
+    }
+
+    /**
+     * @brief Adds all possible knight moves to the given list of cells.
+     *
+     * This function calculates all possible knight moves from the given key position and adds them to the provided list of cells.
+     *
+     * @param in_board The map representing the chessboard.
+     * @param l The list of cells to which the knight moves will be added.
+     * @param key The key position from which the knight moves will be calculated.
+     * @param cell The cell object representing the knight.
+     */
+    template <typename TBoard>
+    void add_knight_moves(TBoard& in_board, list<int32>& l, int32 key, Cell* cell) {
+        int32 pos;
+        pos = move_vertically_up(move_vertically_up(key));
+        add_if_valid(in_board, l, move_horizontally_top_right(pos), cell, true);
+        add_if_valid(in_board, l, move_horizontally_top_left(pos), cell, true);
+
+        pos = move_vertically_down(move_vertically_down(key));
+        add_if_valid(in_board, l, move_horizontally_bottom_right(pos), cell, true);
+        add_if_valid(in_board, l, move_horizontally_bottom_left(pos), cell, true);
+
+        pos = move_horizontally_top_right(move_horizontally_top_right(key));
+        add_if_valid(in_board, l, move_vertically_up(pos), cell, true);
+        add_if_valid(in_board, l, move_horizontally_bottom_right(pos), cell, true);
+
+        pos = move_horizontally_bottom_right(move_horizontally_bottom_right(key));
+        add_if_valid(in_board, l, move_vertically_down(pos), cell, true);
+        add_if_valid(in_board, l, move_horizontally_top_right(pos), cell, true);
+
+        pos = move_horizontally_bottom_left(move_horizontally_bottom_left(key));
+        add_if_valid(in_board, l, move_vertically_down(pos), cell, true);
+        add_if_valid(in_board, l, move_horizontally_top_left(pos), cell, true);
+
+        pos = move_horizontally_top_left(move_horizontally_top_left(key));
+        add_if_valid(in_board, l, move_vertically_up(pos), cell, true);
+        add_if_valid(in_board, l, move_horizontally_bottom_left(pos), cell, true);
+    }
+
+    /**
+     * @brief Adds all possible moves for a rook to the given list of cells.
+     *
+     * This function calculates all possible moves for a rook from the given key position and adds them to the provided list of cells.
+     *
+     * @param in_board The map representing the chessboard.
+     * @param l The list of cells to which the rook moves will be added.
+     * @param key The key position from which the rook moves will be calculated.
+     * @param cell The cell object representing the rook.
+     */
+    template <typename TBoard>
+    void add_rook_moves(TBoard& in_board, list<int32>& l, int32 key, Cell* cell) {
+        TMoveFn fns[6] = { &move_horizontally_top_right
+                         , &move_horizontally_top_left
+                         , &move_horizontally_bottom_right
+                         , &move_horizontally_bottom_left
+                         , &move_vertically_up
+                         , &move_vertically_down
+                         };
+        add_valid_moves(in_board, l, key, fns, 6, cell);
+    }
+
+    /**
+     * @brief Adds all possible moves for a queen to the given list of cells.
+     *
+     * This function calculates all possible moves for a queen from the given key position and adds them to the provided list of cells.
+     *
+     * @param in_board The map representing the chessboard.
+     * @param l The list of cells to which the queen moves will be added.
+     * @param key The key position from which the queen moves will be calculated.
+     * @param cell The cell object representing the queen.
+     */
+    template <typename TBoard>
+    void add_queen_moves(TBoard& in_board, list<int32>& l, int32 key, Cell* cell) {
+        add_bishop_moves(in_board, l, key, cell);
+        add_rook_moves(in_board, l, key, cell);
+    }
+
+    /**
+     * @brief Adds all possible moves for a king to the given list of cells.
+     *
+     * This function calculates all possible moves for a king from the given key position and adds them to the provided list of cells.
+     *
+     * @param in_board The map representing the chessboard.
+     * @param l The list of cells to which the king moves will be added.
+     * @param key The key position from which the king moves will be calculated.
+     * @param cell The cell object representing the king.
+     */
+    template <typename TBoard>
+    void add_king_moves(TBoard& in_board, list<int32>& l, int32 key, Cell* cell) {
+        add_if_valid(in_board, l, move_vertically_up(key), cell, true);
+        add_if_valid(in_board, l, move_vertically_down(key), cell, true);
+        add_if_valid(in_board, l, move_horizontally_top_right(key), cell, true);
+        add_if_valid(in_board, l, move_horizontally_top_left(key), cell, true);
+        add_if_valid(in_board, l, move_horizontally_bottom_right(key), cell, true);
+        add_if_valid(in_board, l, move_horizontally_bottom_left(key), cell, true);
+        add_if_valid(in_board, l, move_diagonally_top_right(key), cell, true);
+        add_if_valid(in_board, l, move_diagonally_top_left(key), cell, true);
+        add_if_valid(in_board, l, move_diagonally_bottom_right(key), cell, true);
+        add_if_valid(in_board, l, move_diagonally_bottom_left(key), cell, true);
+        add_if_valid(in_board, l, move_diagonally_right(key), cell, true);
+        add_if_valid(in_board, l, move_diagonally_left(key), cell, true);
+    }
+
+    /**
+     * @brief Adds valid moves to the given list based on the provided move functions.
+     * 
+     * This function iterates through the given move functions and generates valid moves
+     * for the given key on the chessboard. It checks each move position and determines
+     * whether it is a valid move or not based on the current state of the board.
+     * 
+     * @param in_board The chessboard represented as a map of cell positions to cell objects.
+     * @param l The list to which the valid move positions will be added.
+     * @param key The key representing the current position on the chessboard.
+     * @param fns An array of move functions that generate the next position based on the current position.
+     * @param fns_count The number of move functions in the array.
+     * @param cell The cell object representing the current position on the chessboard.
+     */
+    template <typename TBoard>
+    void add_valid_moves(TBoard& in_board, list<int32>& l, const int32 key, TMoveFn fns[], int32 fns_count, Cell* cell) {
+        int32 current_pos;
+        for (int32 i = 0; i < fns_count; i++) {
+            TMoveFn fn = fns[i];
+            current_pos = fn(key);
+            while (is_valid_position(in_board, current_pos)) {
+                Cell c = cell_at(in_board, current_pos);
+                if (c.has_piece()) {
+                    if (c.has_piece_of_same_color(cell)) {
+                        // cannot take a piece of the same color and cannot move further
+                        break;
+                    } else {
+                        // can take a piece of the opposite color but cannot move further
+                        l.push_front(current_pos);
+                        break;
+                    }
+                } else {
+                    // empty cell, can continue moving
+                    l.push_front(current_pos);
+                    current_pos = fn(current_pos);
+                }
+            }
+        }
+    }
+
+    /**
+     * Adds a valid position to the given list if it satisfies certain conditions.
+     *
+     * @param in_board The map representing the chess board.
+     * @param l The list to which the valid position will be added.
+     * @param key The key representing the position on the board.
+     * @param cell The cell object representing the current cell.
+     * @param can_take A boolean indicating whether the current cell can take a piece.
+     */
+    template <typename TBoard>
+    inline void add_if_valid(TBoard& in_board, list<int32>& l, int32 key, Cell* cell, bool can_take) {
+        if (is_valid_position(in_board, key)) {
+            Cell c = cell_at(in_board, key);
+            if (c.has_piece()) {
+                if (c.has_piece_of_opposite_color(cell) && can_take) {
+                    l.push_front(key);
+                }
+            } else {
+                l.push_front(key);
+            }
+        }
+    }
+
+    static inline int32 move_vertically_up(const int32 key) {
+        return key + 1; // x, y+1
+    }
+
+    static inline int32 move_vertically_down(const int32 key) {
+        return key - 1; // x, y-1
+    }
+
+    static int32 move_horizontally_top_right(const int32 key) {
+        if (get_x(key) < median) {
+            return key + step_x + 1; // x+1, y+1
+        } else {
+            return key + step_x; // x+1, y
+        }
+    }
+
+    static int32 move_horizontally_top_left(const int32 key) {
+        if (get_x(key) > median) {
+            return key - step_x + 1; // x-1, y+1
+        } else {
+            return key - step_x; // x-1, y
+        }
+    }
+
+    static int32 move_horizontally_bottom_right(const int32 key) {
+        if (get_x(key) < median) {
+            return key + step_x; // x+1, y
+        } else {
+            return key + step_x - 1; // x+1, y-1
+        }
+    }
+
+    static int32 move_horizontally_bottom_left(const int32 key) {
+        if (get_x(key) > median) {
+            return key - step_x; // x-1, y
+        } else {
+            return key - step_x - 1; // x-1, y-1
+        }
+    }
+
+    static int32 move_diagonally_top_right(const int32 key) {
+        if (get_x(key) < median) {
+            return key + step_x + 2; // x+1, y+2
+        } else {
+            return key + step_x + 1; // x+1, y+1
+        }
+    }
+
+    static int32 move_diagonally_top_left(const int32 key) {
+        if (get_x(key) > median) {
+            return key - step_x + 2; // x-1, y+2
+        } else {
+            return key - step_x + 1; // x-1, y+1
+        }
+    }
+
+    static int32 move_diagonally_bottom_right(const int32 key) {
+        if (get_x(key) < median) {
+            return key + step_x - 1; // x+1, y-1
+        } else {
+            return key + step_x - 2; // x+1, y-2
+        }
+    }
+
+    static int32 move_diagonally_bottom_left(const int32 key) {
+        if (get_x(key) > median) {
+            return key - step_x - 1; // x-1, y-1
+        } else {
+            return key - step_x - 2; // x-1, y-2
+        }
+    }
+
+    static int32 move_diagonally_right(const int32 key) {
+        int32 x = get_x(key);
+        if (x % 2 == 0) {
+            if (x == median - 1) {
+                return key + step_x*2; // x+2, y
+            } else if (x < median) {
+                return key + step_x*2 + 1; // x+2, y+1
+            } else {
+                return key + step_x*2 - 1; // x+2, y-1
+            }
+        } else {
+            if (x < median) {
+                return key + step_x*2 + 1; // x+2, y+1
+            } else {
+                return key + step_x*2 - 1; // x+2, y-1
+            }
+        }
+    }
+
+    static int32 move_diagonally_left(const int32 key) {
+        int32 x = get_x(key);
+        if (x % 2 == 0) {
+            if (x == median + 1) {
+                return key - step_x*2; // x-2, y
+            } else if (x < median) {
+                return key - step_x*2 - 1; // x-2, y-1
+            } else {
+                return key - step_x*2 + 1; // x-2, y+1
+            }
+        } else {
+            if (x <= median) {
+                return key - step_x*2 - 1; // x-2, y-1
+            } else {
+                return key - step_x*2 + 1; // x-2, y+1
+            }
+        }
+    }
+
+    static int32 ping(const int32 key) {
+        return key;
+    }
+
+    static inline int32 get_x(const int32 key) {
+        return key >> 8;
+    }
+
+    static inline int32 get_y(const int32 key) {
+        return key & 0xFF;
+    }
+
+    /**
+     * Retrieves all possible move keys for a given piece color on the chess board.
+     * 
+     * @param in_board The chess board represented as a map of cell keys to cell pointers.
+     * @param pc The piece color for which to retrieve the move keys.
+     * @param skip_filter Flag indicating whether to skip the move filter.
+     * @return A list of all possible move keys for the given piece color.
+     */
+    list<int32> get_all_piece_move_keys(map<int32, Cell*>& in_board, Cell::PieceColor pc, bool skip_filter = false) {
+        list<int32> all_moves = {};
+        auto all_piece_keys = get_piece_keys(in_board, pc);
+        for (int32 key : all_piece_keys) {
+            auto moves = get_valid_moves(in_board, key, skip_filter);
+            all_moves.insert(all_moves.end(), moves.begin(), moves.end());
+        }
+        return all_moves;
+    }
+
+    /**
+     * Retrieves all possible move keys for a given piece color on a packed board.
+     * 
+     * @param in_board The packed board to use.
+     * @param pc The piece color for which to retrieve the move keys.
+     * @param skip_filter Flag indicating whether to skip the move filter.
+     * @return A list of all possible move keys for the given piece color.
+     */
+    list<int32> get_all_piece_move_keys(PackedBoard& in_board, Cell::PieceColor pc, bool skip_filter = false) {
+        MoveList moves;
+        get_all_piece_moves(in_board, pc, moves, skip_filter);
+        list<int32> all_moves = {};
+        for (const Move& move : moves) {
+            all_moves.push_back(PackedBoard::to_key(move.to));
+        }
+        return all_moves;
+    }
+
+    /**
+     * Retrieves all possible moves for a given piece color on a packed board into a caller-owned buffer.
+     * 
+     * @param in_board The packed board to use.
+     * @param pc The piece color for which to retrieve the moves.
+     * @param out The buffer to fill; it is cleared first.
+     * @param skip_filter Flag indicating whether to skip the move filter.
+     */
+    void get_all_piece_moves(PackedBoard& in_board, Cell::PieceColor pc, MoveList& out, bool skip_filter = false) {
+        if (!skip_filter) {
+            generate_legal_moves(in_board, pc, out);
+            return;
+        }
+        out.clear();
+        add_side_moves(in_board, pc, out);
+    }
+
+    /**
+     * Determines whether a chess piece with the given key can be captured.
+     *
+     * @param key The key of the chess piece.
+     * @return True if the chess piece can be captured, false otherwise.
+     */
+    bool can_be_captured(const int32 key) {
+        return can_be_captured(packed_board, key);
+    }
+
+    /**
+     * Checks if a chess piece can be captured by the opponent.
+     *
+     * @param in_board The chess board represented as a map of cell keys to cell pointers.
+     * @param key The key of the cell representing the chess piece to be checked.
+     * @return True if the chess piece can be captured, false otherwise.
+     */
+    bool can_be_captured(map<int32, Cell*>& in_board, const int32 key) {
+        Cell::PieceColor pc = in_board[key]->get_opposite_color();
+        auto all_moves = get_all_piece_move_keys(in_board, pc, true);
+        auto k = find(begin(all_moves), end(all_moves), key);
+        return k != end(all_moves);
+    }
+
+    /**
+     * Checks if a chess piece can be captured by the opponent on a packed board.
+     *
+     * @param in_board The packed board to use.
+     * @param key The key of the cell representing the chess piece to be checked.
+     * @return True if the chess piece can be captured, false otherwise.
+     */
+    bool can_be_captured(PackedBoard& in_board, const int32 key) {
+        const int32 index = PackedBoard::to_index(key);
+        Cell::PieceColor pc = in_board.get_square(index).get_opposite_color();
+        if (pc == Cell::PieceColor::absent) {
+            return false;
+        }
+        return is_attacked(in_board, index, pc);
+    }
+
+public:
+
+    /**
+     * Checks whether a cell is attacked by any piece of the given color.
+     *
+     * Looks outward from the cell through the move tables (knight and king targets, pawn attackers and the
+     * first piece on every ray) instead of generating the opponent's moves.
+     *
+     * @param in_board The packed board to use.
+     * @param index The dense index of the cell.
+     * @param by_color The color of the attacking side.
+     * @return True if the cell is attacked, false otherwise.
+     */
+    bool is_attacked(const PackedBoard& in_board, const int32 index, Cell::PieceColor by_color) {
+        const HexMoveTables& tables = move_tables();
+        const int32 side = by_color == Cell::PieceColor::black ? 1 : 0;
+        const Square pawn = PackedBoard::encode(Cell::PieceType::pawn, by_color);
+        const Square knight = PackedBoard::encode(Cell::PieceType::knight, by_color);
+        const Square bishop = PackedBoard::encode(Cell::PieceType::bishop, by_color);
+        const Square rook = PackedBoard::encode(Cell::PieceType::rook, by_color);
+        const Square queen = PackedBoard::encode(Cell::PieceType::queen, by_color);
+        const Square king = PackedBoard::encode(Cell::PieceType::king, by_color);
+
+        for (const int8 from : tables.pawn_attackers[side][index]) {
+            if (from != HexMoveTables::sentinel && in_board.cells[from] == pawn) {
+                return true;
+            }
+        }
+        for (const int8* target = tables.knight_targets[index]; *target != HexMoveTables::sentinel; target++) {
+            if (in_board.cells[*target] == knight) {
+                return true;
+            }
+        }
+        for (const int8* target = tables.king_targets[index]; *target != HexMoveTables::sentinel; target++) {
+            if (in_board.cells[*target] == king) {
+                return true;
+            }
+        }
+        for (int32 direction = 0; direction < HexMoveTables::direction_count; direction++) {
+            const Square slider = direction < HexMoveTables::first_rook_direction ? bishop : rook;
+            for (const int8* target = tables.rays[index][direction]; *target != HexMoveTables::sentinel; target++) {
+                const Square square = in_board.cells[*target];
+                if (square.has_piece()) {
+                    if (square == slider || square == queen) {
+                        return true;
+                    }
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Counts, for both sides, how many pieces attack every cell of the board.
+     *
+     * Meant to be computed once per node and reused for all "is this cell attacked" questions about it.
+     *
+     * @param in_board The packed board to use.
+     * @param out The attack map to fill.
+     */
+    void build_attack_map(const PackedBoard& in_board, AttackMap& out) {
+        const HexMoveTables& tables = move_tables();
+        out = AttackMap();
+        for (int32 index = 0; index < PackedBoard::cell_count; index++) {
+            const Square square = in_board.cells[index];
+            if (!square.has_piece()) {
+                continue;
+            }
+            const int32 side = PackedBoard::side_of(square.get_piece_color());
+            uint8* counts = out.counts[side];
+            switch (square.get_piece_type()) {
+                case Cell::PieceType::pawn:
+                    for (const int8 take : tables.pawn_takes[side][index]) {
+                        if (take != HexMoveTables::sentinel) {
+                            counts[take]++;
+                        }
+                    }
+                    break;
+                case Cell::PieceType::knight:
+                    for (const int8* target = tables.knight_targets[index]; *target != HexMoveTables::sentinel; target++) {
+                        counts[*target]++;
+                    }
+                    break;
+                case Cell::PieceType::king:
+                    for (const int8* target = tables.king_targets[index]; *target != HexMoveTables::sentinel; target++) {
+                        counts[*target]++;
+                    }
+                    break;
+                default: {
+                    const int32 first = square.get_piece_type() == Cell::PieceType::rook ? HexMoveTables::first_rook_direction : 0;
+                    const int32 last = square.get_piece_type() == Cell::PieceType::bishop ? HexMoveTables::first_rook_direction : HexMoveTables::direction_count;
+                    for (int32 direction = first; direction < last; direction++) {
+                        for (const int8* target = tables.rays[index][direction]; *target != HexMoveTables::sentinel; target++) {
+                            counts[*target]++;
+                            if (in_board.cells[*target].has_piece()) {
+                                break;
+                            }
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * Builds the attack map of a packed board.
+     *
+     * @param in_board The packed board to use.
+     * @return The attack map.
+     */
+    AttackMap get_attack_map(const PackedBoard& in_board) {
+        AttackMap attack_map;
+        build_attack_map(in_board, attack_map);
+        return attack_map;
+    }
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @brief The query the two board representations answered differently.
+ */
+enum class FuzzCheck : uint8 {
+    // the pieces are not on the same cells after playing the same moves
+    cells,
+    legal_moves,
+    can_be_captured,
+    evaluation
+};
+
+/**
+ * @brief A disagreement between the map board and the packed board, with the moves that lead to it.
+ */
+struct FuzzDivergence {
+    FuzzCheck check = FuzzCheck::cells;
+    // from and to position keys of every move from the starting position
+    std::vector<std::pair<int32, int32>> moves;
+    // the cell the two boards disagree about, -1 for the evaluation
+    int32 key = -1;
+    std::string map_answer;
+    std::string packed_answer;
+};
+
+/**
+ * @class EngineFuzzer
+ * @brief Plays random legal games and checks after every ply that the legacy map board agrees with the packed board.
+ *
+ * Both boards play the same moves, the map board through move_piece and the packed one through make_move. After every ply
+ * it compares the cells, the legal moves of every piece of the side to move, can_be_captured for every piece and the
+ * evaluation (the packed one without its piece-square terms, which the map evaluation never had).
+ *
+ * Map boards keep no en passant shadow: en passant captures are never played and left out of the packed move lists.
+ * A divergence is minimized before it is reported: the game is cut at the first ply the boards disagree at, then pairs
+ * of plies are dropped for as long as the shorter game stays legal and still diverges.
+ */
+class EngineFuzzer {
+public:
+
+    explicit EngineFuzzer(const uint32 seed) : random(seed) {
+        start.set_position(Board::starting_position());
+    }
+
+    ~EngineFuzzer() {
+        rules.clear_board_map(legacy);
+    }
+
+    EngineFuzzer(const EngineFuzzer&) = delete;
+    EngineFuzzer& operator=(const EngineFuzzer&) = delete;
+
+    /**
+     * @brief Plays one random game from the starting position and compares the boards after every ply.
+     *
+     * @param max_plies The game stops after this many plies if no side ran out of moves before.
+     * @param out The minimized divergence, when there is one.
+     * @return true if the boards disagreed.
+     */
+    bool run_game(const int32 max_plies, FuzzDivergence& out) {
+        std::vector<std::pair<int32, int32>> moves;
+        reset();
+        if (compare(out)) {
+            minimize(out);
+            return true;
+        }
+        MoveList legal;
+        for (int32 ply = 0; ply < max_plies; ply++) {
+            generate_playable_moves(legal);
+            if (legal.empty()) {
+                break;
+            }
+            std::uniform_int_distribution<int32> pick(0, legal.size() - 1);
+            const Move& move = legal[pick(random)];
+            moves.emplace_back(PackedBoard::to_key(move.from), PackedBoard::to_key(move.to));
+            play(moves.back());
+            if (compare(out)) {
+                out.moves = moves;
+                minimize(out);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Replays moves from the starting position and compares the boards after every ply.
+     *
+     * @param moves From and to position keys of every move.
+     * @param out The divergence at the first ply the boards disagree at, with the moves cut there.
+     * @return true if the boards disagreed before a move turned out illegal or the moves ran out.
+     */
+    bool replay(const std::vector<std::pair<int32, int32>>& moves, FuzzDivergence& out) {
+        reset();
+        if (compare(out)) {
+            out.moves.clear();
+            return true;
+        }
+        MoveList legal;
+        for (size_t ply = 0; ply < moves.size(); ply++) {
+            generate_playable_moves(legal);
+            const int32 from = PackedBoard::to_index(moves[ply].first);
+            const int32 to = PackedBoard::to_index(moves[ply].second);
+            const bool is_legal = std::any_of(legal.begin(), legal.end(), [from, to](const Move& move) { return move.from == from && move.to == to; });
+            if (!is_legal) {
+                return false;
+            }
+            play(moves[ply]);
+            if (compare(out)) {
+                out.moves.assign(moves.begin(), moves.begin() + ply + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Shortens a divergence's moves for as long as the boards still disagree.
+     *
+     * Plies are dropped in pairs, so the same side stays to move at the end. A shorter game only has its last position
+     * compared, the slow map queries on every ply before it would make minimizing a long game take minutes.
+     *
+     * @param divergence The divergence to minimize, replaced by the shortest one found.
+     */
+    void minimize(FuzzDivergence& divergence) {
+        bool is_shorter = true;
+        while (is_shorter) {
+            is_shorter = false;
+            for (size_t ply = 0; ply + 1 < divergence.moves.size(); ply++) {
+                std::vector<std::pair<int32, int32>> candidate = divergence.moves;
+                candidate.erase(candidate.begin() + ply, candidate.begin() + ply + 2);
+                FuzzDivergence found;
+                if (diverges_after(candidate, found)) {
+                    found.moves = std::move(candidate);
+                    divergence = found;
+                    is_shorter = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    static const char* get_check_name(const FuzzCheck check) {
+        switch (check) {
+        case FuzzCheck::cells:
+            return "cells";
+        case FuzzCheck::legal_moves:
+            return "legal moves";
+        case FuzzCheck::can_be_captured:
+            return "can_be_captured";
+        default:
+            return "evaluation";
+        }
+    }
+
+    /**
+     * @brief Writes a position key as "x,y", like the self-play move lists.
+     */
+    static std::string key_to_string(const int32 key) {
+        return std::to_string(key >> 8) + "," + std::to_string(key & 0xFF);
+    }
+
+private:
+
+    // plays the moves without comparing on the way, false if one of them is illegal or the final position agrees
+    bool diverges_after(const std::vector<std::pair<int32, int32>>& moves, FuzzDivergence& out) {
+        reset();
+        MoveList legal;
+        for (const std::pair<int32, int32>& move : moves) {
+            generate_playable_moves(legal);
+            const int32 from = PackedBoard::to_index(move.first);
+            const int32 to = PackedBoard::to_index(move.second);
+            if (!std::any_of(legal.begin(), legal.end(), [from, to](const Move& legal_move) { return legal_move.from == from && legal_move.to == to; })) {
+                return false;
+            }
+            play(move);
+        }
+        return compare(out);
+    }
+
+    void reset() {
+        rules.clear_board_map(legacy);
+        legacy = rules.copy_board_map(start.board_map);
+        packed = Board::starting_position();
+    }
+
+    void play(const std::pair<int32, int32>& move) {
+        Position from = rules.to_position(move.first);
+        Position to = rules.to_position(move.second);
+        rules.move_piece(legacy, from, to);
+        packed.make_move(PackedBoard::to_index(move.first), PackedBoard::to_index(move.second));
+    }
+
+    Cell::PieceColor get_side_to_move() const {
+        return packed.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white;
+    }
+
+    // the packed board's legal moves the map board can play too, en passant left out
+    void generate_playable_moves(MoveList& out) {
+        MoveList all;
+        rules.generate_legal_moves(packed, get_side_to_move(), all);
+        out.clear();
+        for (const Move& move : all) {
+            if ((move.flags & Move::Flags::en_passant) == 0) {
+                out.moves[out.count++] = move;
+            }
+        }
+    }
+
+    bool compare(FuzzDivergence& out) {
+        out = FuzzDivergence();
+        for (int32 index = 0; index < PackedBoard::cell_count; index++) {
+            const int32 key = PackedBoard::to_key(index);
+            Cell map_cell = *legacy[key];
+            Cell packed_cell = packed.get_cell(index);
+            if (map_cell.get_piece_type() != packed_cell.get_piece_type() || map_cell.get_piece_color() != packed_cell.get_piece_color()) {
+                return diverge(FuzzCheck::cells, key, cell_to_string(map_cell), cell_to_string(packed_cell), out);
+            }
+        }
+
+        const Cell::PieceColor side = get_side_to_move();
+        MoveList packed_moves;
+        for (int32 index = 0; index < PackedBoard::cell_count; index++) {
+            const Square square = packed.get_square(index);
+            if (!square.has_piece()) {
+                continue;
+            }
+            const int32 key = PackedBoard::to_key(index);
+            if (square.get_piece_color() == side) {
+                std::vector<int32> map_targets;
+                for (const int32 target : rules.get_valid_moves(legacy, key)) {
+                    map_targets.push_back(target);
+                }
+                std::vector<int32> packed_targets;
+                rules.get_valid_moves(packed, key, packed_moves);
+                for (const Move& move : packed_moves) {
+                    if ((move.flags & Move::Flags::en_passant) == 0) {
+                        packed_targets.push_back(PackedBoard::to_key(move.to));
+                    }
+                }
+                std::sort(map_targets.begin(), map_targets.end());
+                std::sort(packed_targets.begin(), packed_targets.end());
+                if (map_targets != packed_targets) {
+                    return diverge(FuzzCheck::legal_moves, key, keys_to_string(map_targets), keys_to_string(packed_targets), out);
+                }
+            }
+
+            Position position = rules.to_position(key);
+            const bool map_captured = rules.can_be_captured(legacy, position);
+            const bool packed_captured = rules.can_be_captured(packed, position);
+            if (map_captured != packed_captured) {
+                return diverge(FuzzCheck::can_be_captured, key, map_captured ? "true" : "false", packed_captured ? "true" : "false", out);
+            }
+        }
+
+        const int32 map_score = rules.evaluate(legacy);
+        const int32 packed_score = rules.evaluate(packed) - packed.positional_score;
+        if (map_score != packed_score) {
+            return diverge(FuzzCheck::evaluation, -1, std::to_string(map_score), std::to_string(packed_score), out);
+        }
+        return false;
+    }
+
+    static bool diverge(const FuzzCheck check, const int32 key, const std::string& map_answer, const std::string& packed_answer, FuzzDivergence& out) {
+        out.check = check;
+        out.key = key;
+        out.map_answer = map_answer;
+        out.packed_answer = packed_answer;
+        return true;
+    }
+
+    static std::string cell_to_string(Cell cell) {
+        if (cell.get_piece_type() == Cell::PieceType::none) {
+            return "empty";
+        }
+        static const char* const types = " pnbrqk";
+        const char type = types[cell.get_piece_type()];
+        return std::string(1, cell.get_piece_color() == Cell::PieceColor::white ? static_cast<char>(type - 'a' + 'A') : type);
+    }
+
+    static std::string keys_to_string(const std::vector<int32>& keys) {
+        std::string text = "[";
+        for (const int32 key : keys) {
+            text += (text.size() > 1 ? " " : "") + key_to_string(key);
+        }
+        return text + "]";
+    }
+
+    // move rules only, its own board is never played on
+    Board rules;
+    // the starting position the legacy map is copied from
+    Board start;
+    map<int32, Cell*> legacy;
+    PackedBoard packed;
+    std::mt19937 random;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @class EvaluationCache
+ * @brief Small direct-mapped table of static evaluations keyed by Zobrist hash, sized to stay in a core's L2.
+ *
+ * Each slot is one 64-bit word: the upper half of the hash as a tag and the score. A new score always replaces
+ * the old one. The cache belongs to one search thread, so the slots need no atomics; only the counters are atomic,
+ * so that another thread may read them while the owner searches.
+ */
+class EvaluationCache {
+public:
+    explicit EvaluationCache(int32 size_kb = 256) {
+        resize(size_kb);
+    }
+
+    /**
+     * @brief Reallocates the cache to the largest power-of-two slot count that fits in the budget, and clears it.
+     *
+     * @param size_kb The memory budget in kilobytes.
+     */
+    void resize(int32 size_kb) {
+        budget_kb = size_kb < 1 ? 1 : size_kb;
+        const uint64 budget = static_cast<uint64>(budget_kb) * 1024;
+        uint64 count = 1;
+        while (count * 2 * sizeof(uint64) <= budget) {
+            count *= 2;
+        }
+        slots.reset(new uint64[count]);
+        slot_count = count;
+        clear();
+    }
+
+    /**
+     * @brief Forgets every stored score and resets the counters, needed whenever the evaluation itself changes.
+     */
+    void clear() {
+        for (uint64 i = 0; i < slot_count; i++) {
+            slots[i] = 0;
+        }
+        reset_counters();
+    }
+
+    void reset_counters() {
+        probes.store(0, std::memory_order_relaxed);
+        hits.store(0, std::memory_order_relaxed);
+    }
+
+    inline int32 get_size_kb() const {
+        return budget_kb;
+    }
+
+    inline uint64 get_probes() const {
+        return probes.load(std::memory_order_relaxed);
+    }
+
+    inline uint64 get_hits() const {
+        return hits.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Looks a position's score up.
+     *
+     * @param hash The Zobrist hash of the position.
+     * @param out The score to fill on a hit.
+     * @return true if the cache holds the position's score.
+     */
+    inline bool probe(const uint64 hash, int32& out) {
+        probes.store(probes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        const uint64 slot = slots[hash & (slot_count - 1)];
+        if (static_cast<uint32>(slot >> 32) != tag_of(hash)) {
+            return false;
+        }
+        hits.store(hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        out = static_cast<int32>(static_cast<uint32>(slot));
+        return true;
+    }
+
+    /**
+     * @brief Stores a position's score over whatever the slot held.
+     *
+     * @param hash The Zobrist hash of the position.
+     * @param score The score.
+     */
+    inline void store(const uint64 hash, const int32 score) {
+        slots[hash & (slot_count - 1)] = static_cast<uint64>(tag_of(hash)) << 32 | static_cast<uint32>(score);
+    }
+
+private:
+    // the lowest tag bit is always set so an empty slot never matches
+    static inline uint32 tag_of(const uint64 hash) {
+        return static_cast<uint32>(hash >> 32) | 1u;
+    }
+
+    std::unique_ptr<uint64[]> slots;
+    uint64 slot_count = 0;
+    int32 budget_kb = 0;
+    std::atomic<uint64> probes{0};
+    std::atomic<uint64> hits{0};
+};
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "Chess/BitboardEngine.h"
+#include "Chess/ChessEngine.h"
+
+// the piece-square kernel gathers straight from the cell array where AVX2 is guaranteed; UE builds say so through
+// PLATFORM_ALWAYS_HAS_AVX_2, standalone builds through the compiler's own macro
+#if (defined(PLATFORM_ALWAYS_HAS_AVX_2) && PLATFORM_ALWAYS_HAS_AVX_2) || defined(__AVX2__)
+#define HEXACHESS_EVALUATION_AVX2 1
+#include <immintrin.h>
+#else
+#define HEXACHESS_EVALUATION_AVX2 0
+#endif
+
+class NnueNetwork;
+
+/**
+ * @class Evaluator
+ * @brief Scores packed positions for the search; an alternative to Board::evaluate with its own weights.
+ *
+ * Implementations must be safe to call from several search threads at once, so they keep no per-call state.
+ */
+class Evaluator {
+public:
+    virtual ~Evaluator() = default;
+
+    /**
+     * @brief Scores a position.
+     *
+     * @param rules The board whose move tables and attack queries to use; its own cells are not read.
+     * @param in_board The position to score.
+     * @return The score in evaluation units (a pawn is 100), positive when white is better.
+     */
+    virtual int32 evaluate(Board& rules, const PackedBoard& in_board) const = 0;
+
+    /**
+     * @brief Scores several positions in one call, for searches that gather their leaves; evaluate on each by default.
+     *
+     * @param rules The board whose move tables and attack queries to use; its own cells are not read.
+     * @param positions The positions to score.
+     * @param count How many there are.
+     * @param out_scores One score per position, as evaluate would give it.
+     */
+    virtual void evaluate_batch(Board& rules, const PackedBoard* positions, const int32 count, int32* out_scores) const {
+        for (int32 i = 0; i < count; i++) {
+            out_scores[i] = evaluate(rules, positions[i]);
+        }
+    }
+
+    /**
+     * @brief The network behind the evaluator, if it is one; a search that has it keeps the accumulators up to date
+     * move by move instead of calling evaluate.
+     */
+    virtual const NnueNetwork* get_network() const {
+        return nullptr;
+    }
+};
+
+/**
+ * @brief The weights of one piece type, separately for the opening and the endgame.
+ */
+struct PieceWeights {
+    int32 value[2] = {};
+    // bonus per ring closer to the middle of the board
+    int32 centrality[2] = {};
+    // bonus per push away from the pawn's own edge, meant for pawns
+    int32 advancement[2] = {};
+    // bonus per cell the piece attacks or can move to, pawns excluded
+    int32 mobility[2] = {};
+    // how much one piece of this type counts towards the opening side of the phase
+    int32 phase_weight = 0;
+    // optional per-cell bonus in dense cell order from white's side, mirrored for black; replaces centrality and advancement
+    const int32* square_bonus[2] = {nullptr, nullptr};
+};
+
+/**
+ * @brief Evaluation weights compiled to flat arrays, indexed [phase] with 0 the opening and 1 the endgame.
+ */
+struct EvaluationTables {
+    static constexpr int32 opening = 0;
+    static constexpr int32 endgame = 1;
+
+    // cells padded to a whole number of vector lanes
+    static constexpr int32 padded_cell_count = 96;
+
+    // piece value plus square bonus, indexed by Square value and cell, opening and endgame side by side so one 32-bit
+    // load fetches both; black entries are negated, empty squares and padding are zero
+    int16 piece_square[32][padded_cell_count][2] = {};
+    int32 mobility[2][8] = {};
+    // per own piece next to the king
+    int32 king_shelter[2] = {};
+    // per enemy piece next to the king
+    int32 king_zone_attacker[2] = {};
+    int32 check_penalty[2] = {};
+    int32 phase_weights[8] = {};
+    int32 max_phase = 1;
+    // skips the ray walks entirely when no piece type has a mobility weight
+    bool use_mobility = false;
+};
+
+/**
+ * @brief Builds the flat tables from per-piece weights.
+ *
+ * @param pieces The weights, indexed by Cell::PieceType.
+ * @param king_shelter The bonus per own piece next to the king, opening and endgame.
+ * @param king_zone_attacker The penalty per enemy piece next to the king, opening and endgame.
+ * @param check_penalty The penalty for being in check, opening and endgame.
+ * @return The compiled tables.
+ */
+inline EvaluationTables compile_evaluation_tables(const PieceWeights (&pieces)[8], const int32 (&king_shelter)[2], const int32 (&king_zone_attacker)[2], const int32 (&check_penalty)[2]) {
+    EvaluationTables tables;
+    int32 max_phase = 0;
+    for (int32 type = Cell::PieceType::pawn; type <= Cell::PieceType::king; type++) {
+        const PieceWeights& weights = pieces[type];
+        tables.phase_weights[type] = weights.phase_weight;
+        for (int32 phase = 0; phase < 2; phase++) {
+            tables.mobility[phase][type] = type == Cell::PieceType::pawn ? 0 : weights.mobility[phase];
+            tables.use_mobility |= tables.mobility[phase][type] != 0;
+        }
+        for (int32 index = 0; index < HexIndexTable::cell_count; index++) {
+            const int32 key = PackedBoard::to_key(index);
+            const int32 x = key >> 8;
+            const int32 y = key & 0xFF;
+            const int32 height = hex_column_height(x);
+            const int32 centrality = 5 - hex_center_distance(x, y);
+            for (int32 side = 0; side < 2; side++) {
+                // black sees the board upside down: its own edge is the top of every column
+                const int32 own_y = side == 0 ? y : height - 1 - y;
+                const int32 own_index = PackedBoard::to_index((x << 8) + own_y);
+                // pawns start one cell in from the edge of the middle columns and further in towards the sides
+                const int32 start_y = x <= 5 ? x - 1 : 9 - x;
+                const int32 pushes = own_y - start_y > 0 ? own_y - start_y : 0;
+                const int32 sign = side == 0 ? 1 : -1;
+                for (int32 phase = 0; phase < 2; phase++) {
+                    const int32 bonus = weights.square_bonus[phase] != nullptr
+                                        ? weights.square_bonus[phase][own_index]
+                                        : centrality * weights.centrality[phase] + pushes * weights.advancement[phase];
+                    const int32 value = sign * (weights.value[phase] + bonus);
+                    const Square square(static_cast<Cell::PieceType>(type), side == 0 ? Cell::PieceColor::white : Cell::PieceColor::black);
+                    tables.piece_square[square.value][index][phase] = static_cast<int16>(value < -32767 ? -32767 : value > 32767 ? 32767 : value);
+                }
+            }
+        }
+    }
+    // both starting armies are the opening, every piece traded moves the score towards the endgame weights
+    constexpr int32 starting_count[8] = {0, 9, 2, 3, 2, 1, 1, 0};
+    for (int32 type = Cell::PieceType::pawn; type <= Cell::PieceType::king; type++) {
+        max_phase += 2 * starting_count[type] * tables.phase_weights[type];
+    }
+    for (int32 phase = 0; phase < 2; phase++) {
+        tables.king_shelter[phase] = king_shelter[phase];
+        tables.king_zone_attacker[phase] = king_zone_attacker[phase];
+        tables.check_penalty[phase] = check_penalty[phase];
+    }
+    tables.max_phase = max_phase > 0 ? max_phase : 1;
+    return tables;
+}
+
+#if HEXACHESS_EVALUATION_AVX2
+/**
+ * @brief The AVX2 half of sum_piece_square: looks every cell up, eight per gather, occupied or not.
+ */
+inline void sum_piece_square_gather(const EvaluationTables& tables, const PackedBoard& in_board, int32 (&out)[2]) {
+    alignas(32) uint8 cells[EvaluationTables::padded_cell_count] = {};
+    memcpy(cells, in_board.cells, sizeof(in_board.cells));
+    const int32* pairs = reinterpret_cast<const int32*>(tables.piece_square);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i row = _mm256_set1_epi32(EvaluationTables::padded_cell_count);
+    __m256i sum = _mm256_setzero_si256();
+    for (int32 chunk = 0; chunk < EvaluationTables::padded_cell_count; chunk += 8) {
+        const __m256i squares = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cells + chunk)));
+        const __m256i offsets = _mm256_add_epi32(_mm256_mullo_epi32(squares, row), _mm256_add_epi32(lane, _mm256_set1_epi32(chunk)));
+        // each lane holds one cell's (opening, endgame) pair; one piece per cell keeps the 16-bit halves from overflowing
+        sum = _mm256_add_epi16(sum, _mm256_i32gather_epi32(pairs, offsets, 4));
+    }
+    const __m256i opening = _mm256_madd_epi16(sum, _mm256_set1_epi32(0x00000001));
+    const __m256i endgame = _mm256_madd_epi16(sum, _mm256_set1_epi32(0x00010000));
+    const __m256i both = _mm256_hadd_epi32(opening, endgame);
+    const __m128i halves = _mm_add_epi32(_mm256_castsi256_si128(both), _mm256_extracti128_si256(both, 1));
+    out[EvaluationTables::opening] = _mm_extract_epi32(halves, 0) + _mm_extract_epi32(halves, 1);
+    out[EvaluationTables::endgame] = _mm_extract_epi32(halves, 2) + _mm_extract_epi32(halves, 3);
+}
+#endif
+
+/**
+ * @brief Sums the piece-square table over a position, opening and endgame in one pass.
+ *
+ * With AVX2 every cell is looked up at once, eight per gather, with no branch on whether it holds a piece. The
+ * gathers cost the same however many pieces are left, about what the piece-list walk costs for a full board, so
+ * they only run above gather_piece_count. Elsewhere the occupied cells are always walked through the piece lists;
+ * a compare-and-mask pass over all 91 cells for each of the 12 piece codes does more work than that, so SSE4 and
+ * NEON builds use the scalar loop too.
+ *
+ * @param tables The compiled tables.
+ * @param in_board The position.
+ * @param out The opening and endgame sums, white minus black.
+ */
+inline void sum_piece_square(const EvaluationTables& tables, const PackedBoard& in_board, int32 (&out)[2]) {
+#if HEXACHESS_EVALUATION_AVX2
+    constexpr int32 gather_piece_count = 32;
+    if (in_board.piece_count[0] + in_board.piece_count[1] > gather_piece_count) {
+        sum_piece_square_gather(tables, in_board, out);
+        return;
+    }
+#endif
+    int32 opening = 0;
+    int32 endgame = 0;
+    for (int32 side = 0; side < 2; side++) {
+        for (int32 slot = 0; slot < in_board.piece_count[side]; slot++) {
+            const int32 index = in_board.piece_cells[side][slot];
+            const int16* pair = tables.piece_square[in_board.cells[index].value][index];
+            opening += pair[EvaluationTables::opening];
+            endgame += pair[EvaluationTables::endgame];
+        }
+    }
+    out[EvaluationTables::opening] = opening;
+    out[EvaluationTables::endgame] = endgame;
+}
+
+/**
+ * @class TaperedEvaluator
+ * @brief Material, piece-square, mobility and king safety terms, blended between opening and endgame weights
+ * by how much material is left on the board.
+ */
+class TaperedEvaluator : public Evaluator {
+public:
+    explicit TaperedEvaluator(const EvaluationTables& in_tables): tables(in_tables) {}
+
+    int32 evaluate(Board& rules, const PackedBoard& in_board) const override {
+        const HexMoveTables& moves = Board::move_tables();
+        Bitboard128 occupancy[2];
+        if (tables.use_mobility) {
+            for (int32 side = 0; side < 2; side++) {
+                for (int32 slot = 0; slot < in_board.piece_count[side]; slot++) {
+                    occupancy[side].set(in_board.piece_cells[side][slot]);
+                }
+            }
+        }
+
+        int32 score[2];
+        sum_piece_square(tables, in_board, score);
+
+        int32 phase = 0;
+        for (int32 type = Cell::PieceType::pawn; type <= Cell::PieceType::king; type++) {
+            phase += (in_board.type_count[0][type] + in_board.type_count[1][type]) * tables.phase_weights[type];
+        }
+
+        for (int32 side = 0; side < 2; side++) {
+            const int32 sign = side == 0 ? 1 : -1;
+            if (tables.use_mobility) {
+                const Bitboard128 all = occupancy[0] | occupancy[1];
+                for (int32 slot = 0; slot < in_board.piece_count[side]; slot++) {
+                    const int32 index = in_board.piece_cells[side][slot];
+                    const int32 type = in_board.cells[index].get_piece_type();
+                    if (type == Cell::PieceType::pawn) {
+                        continue;
+                    }
+                    const int32 reach = (reach_of(index, type, all) & ~occupancy[side]).count();
+                    score[EvaluationTables::opening] += sign * reach * tables.mobility[EvaluationTables::opening][type];
+                    score[EvaluationTables::endgame] += sign * reach * tables.mobility[EvaluationTables::endgame][type];
+                }
+            }
+
+            const int32 king = in_board.king_cell[side];
+            if (king < 0) {
+                continue;
+            }
+            int32 shelter = 0;
+            int32 attackers = 0;
+            for (const int8* target = moves.king_targets[king]; *target != HexMoveTables::sentinel; target++) {
+                const Square square = in_board.cells[*target];
+                if (square.has_piece()) {
+                    (PackedBoard::side_of(square.get_piece_color()) == side ? shelter : attackers)++;
+                }
+            }
+            const bool in_check = rules.is_attacked(in_board, king, side == 0 ? Cell::PieceColor::black : Cell::PieceColor::white);
+            for (int32 p = 0; p < 2; p++) {
+                score[p] += sign * (shelter * tables.king_shelter[p] - attackers * tables.king_zone_attacker[p] - (in_check ? tables.check_penalty[p] : 0));
+            }
+        }
+
+        if (phase > tables.max_phase) {
+            phase = tables.max_phase;
+        }
+        return (score[EvaluationTables::opening] * phase + score[EvaluationTables::endgame] * (tables.max_phase - phase)) / tables.max_phase;
+    }
+
+    const EvaluationTables& get_tables() const {
+        return tables;
+    }
+
+private:
+    /**
+     * @brief The cells a piece attacks or moves to on an empty path, own pieces included; legality is not checked.
+     */
+    static Bitboard128 reach_of(const int32 index, const int32 type, const Bitboard128& all) {
+        const BitboardTables& masks = BitboardTables::get();
+        if (type == Cell::PieceType::knight) {
+            return masks.knight[index];
+        }
+        if (type == Cell::PieceType::king) {
+            return masks.king[index];
+        }
+        const int32 first = type == Cell::PieceType::rook ? HexMoveTables::first_rook_direction : 0;
+        const int32 last = type == Cell::PieceType::bishop ? HexMoveTables::first_rook_direction : HexMoveTables::direction_count;
+        Bitboard128 reach;
+        for (int32 direction = first; direction < last; direction++) {
+            const Bitboard128& ray = masks.rays[index][direction];
+            const Bitboard128 blockers = ray & all;
+            if (blockers.empty()) {
+                reach |= ray;
+            } else {
+                const int32 blocker = masks.ray_increasing[direction] ? blockers.lsb() : blockers.msb();
+                reach |= ray ^ masks.rays[blocker][direction];
+            }
+        }
+        return reach;
+    }
+
+    EvaluationTables tables;
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @class GameReplay
+ * @brief A finished game's positions at any ply, from keyframes every keyframe_interval plies and the moves between them.
+ *
+ * load plays the whole game once and keeps a copy of the position every keyframe_interval plies. Seeking copies the
+ * keyframe at or before the ply and plays at most keyframe_interval - 1 moves from it, so a seek costs the same at ply 5
+ * as at ply 500. Stepping one ply forward from the last seek plays a single move.
+ */
+class GameReplay {
+public:
+
+    /**
+     * @brief Replays a game and keeps its keyframes; the current position is the start afterwards.
+     *
+     * @param start The position the game started from.
+     * @param moves The moves as Board::serialize_history writes them, two dense cell indices each.
+     * @param in_keyframe_interval Plies between two keyframes; memory grows as it shrinks, seek time as it grows.
+     * @return false if a move does not fit the board, the replay then ends before it.
+     */
+    bool load(const PackedBoard& start, const std::vector<uint8>& moves, const int32 in_keyframe_interval = 16) {
+        keyframe_interval = in_keyframe_interval < 1 ? 1 : in_keyframe_interval;
+        keyframes.clear();
+        this->moves.clear();
+        this->moves.reserve(moves.size() / 2);
+
+        PackedBoard board = start;
+        keyframes.push_back(board);
+        bool is_complete = moves.size() % 2 == 0;
+        for (size_t i = 0; i + 1 < moves.size(); i += 2) {
+            const int32 from = moves[i];
+            const int32 to = moves[i + 1];
+            if (from >= PackedBoard::cell_count || to >= PackedBoard::cell_count || from == to || !board.get_square(from).has_piece()) {
+                is_complete = false;
+                break;
+            }
+            board.make_move(from, to);
+            this->moves.push_back(ReplayMove{static_cast<uint8>(from), static_cast<uint8>(to)});
+            if (this->moves.size() % keyframe_interval == 0) {
+                keyframes.push_back(board);
+            }
+        }
+        current = start;
+        current_ply = 0;
+        return is_complete;
+    }
+
+    /**
+     * @brief Gets how many plies the replay has; seek takes 0 to get_ply_count() inclusive.
+     */
+    inline int32 get_ply_count() const {
+        return static_cast<int32>(moves.size());
+    }
+
+    inline int32 get_current_ply() const {
+        return current_ply;
+    }
+
+    inline const PackedBoard& get_current() const {
+        return current;
+    }
+
+    /**
+     * @brief Gets the move played at a ply, from the position at ply to the one at ply + 1.
+     *
+     * @return false if there is no such ply.
+     */
+    bool get_move(const int32 ply, int32& out_from, int32& out_to) const {
+        if (ply < 0 || ply >= get_ply_count()) {
+            return false;
+        }
+        out_from = moves[ply].from;
+        out_to = moves[ply].to;
+        return true;
+    }
+
+    /**
+     * @brief Makes the position after a number of plies the current one.
+     *
+     * @param ply Clamped to 0 to get_ply_count().
+     * @return The position at the ply.
+     */
+    const PackedBoard& seek(int32 ply) {
+        ply = ply < 0 ? 0 : ply > get_ply_count() ? get_ply_count() : ply;
+        // stepping forward inside the same keyframe span is cheaper from where we are
+        const int32 keyframe = ply / keyframe_interval;
+        if (ply < current_ply || current_ply / keyframe_interval != keyframe) {
+            current = keyframes[keyframe];
+            current_ply = keyframe * keyframe_interval;
+        }
+        for (; current_ply < ply; current_ply++) {
+            current.make_move(moves[current_ply].from, moves[current_ply].to);
+        }
+        return current;
+    }
+
+private:
+
+    struct ReplayMove {
+        uint8 from;
+        uint8 to;
+    };
+
+    std::vector<PackedBoard> keyframes;
+    std::vector<ReplayMove> moves;
+    int32 keyframe_interval = 16;
+
+    PackedBoard current;
+    int32 current_ply = 0;
+};
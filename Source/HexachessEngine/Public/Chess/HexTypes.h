@@ -0,0 +1,46 @@
+#pragma once
+
+// the engine headers only need fixed-width integers; inside Unreal they come from Core, and a plain C++ build
+// (fuzzers, tools) defines HEXACHESS_STANDALONE to get the same names from the standard library
+#if defined(HEXACHESS_STANDALONE)
+#include <cstdint>
+
+typedef int8_t int8;
+typedef uint8_t uint8;
+typedef int16_t int16;
+typedef uint16_t uint16;
+typedef int32_t int32;
+typedef uint32_t uint32;
+typedef int64_t int64;
+typedef uint64_t uint64;
+#else
+#include "CoreTypes.h"
+#endif
+
+// Insights scopes around the per-node work of the search (move generation, legality, evaluation, table probes)
+// they fire millions of times a second, so they are compiled out unless a build sets HEXACHESS_SEARCH_TRACE to 1
+#ifndef HEXACHESS_SEARCH_TRACE
+#define HEXACHESS_SEARCH_TRACE 0
+#endif
+#if HEXACHESS_SEARCH_TRACE && !defined(HEXACHESS_STANDALONE)
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#define HEXACHESS_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE(Name)
+#else
+#define HEXACHESS_TRACE_SCOPE(Name)
+#endif
+
+// Low-Level Memory tracker tags, `stat LLMFULL` in game and the memory tracks in Insights
+// - HexachessEngine: boards and their cells, move history
+// - HexachessAI: the search's workers, arenas, evaluation caches and trees
+// - HexachessTT: the transposition tables
+// a scope tags every allocation its thread makes until it closes; plain C++ builds have no tracker
+#if !defined(HEXACHESS_STANDALONE)
+#include "HAL/LowLevelMemTracker.h"
+
+LLM_DECLARE_TAG_API(HexachessEngine, HEXACHESSENGINE_API);
+LLM_DECLARE_TAG_API(HexachessAI, HEXACHESSENGINE_API);
+LLM_DECLARE_TAG_API(HexachessTT, HEXACHESSENGINE_API);
+#define HEXACHESS_LLM_SCOPE(Tag) LLM_SCOPE_BYTAG(Tag)
+#else
+#define HEXACHESS_LLM_SCOPE(Tag)
+#endif
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @brief What a match server answers to a submitted move.
+ */
+enum class MatchVerdict : uint8 {
+    accepted,
+    // the piece cannot move there, or it is not the mover's piece
+    illegal,
+    // the mover is not the side to move
+    wrong_turn,
+    // the move was made for another ply than the match is at, usually a resend of a move already played
+    stale_ply,
+    unknown_match,
+    game_over
+};
+
+enum class MatchStatus : uint8 {
+    playing,
+    white_won,
+    black_won,
+    stalemate
+};
+
+/**
+ * @brief One move sent by a player, with the dense cell indices the clients already exchange.
+ */
+struct MatchMove {
+    int32 match = -1;
+    uint32 ply = 0;
+    uint8 from = 0;
+    uint8 to = 0;
+    bool is_black = false;
+};
+
+struct MatchResult {
+    MatchMove move;
+    MatchVerdict verdict = MatchVerdict::unknown_match;
+    // the match's status after the move, unchanged unless the move was accepted
+    MatchStatus status = MatchStatus::playing;
+};
+
+/**
+ * @class MatchValidator
+ * @brief Server side rules for many concurrent matches: one packed board per match, no engine or UObject involved.
+ *
+ * Moves may be submitted from any thread; they queue up and are checked against the legal move generator in one batch
+ * per tick, in submission order. Everything else, tick included, belongs to the one thread that runs the ticks.
+ *
+ * Match ids carry a generation next to their slot, so a move for a closed match never reaches the match that reuses its slot.
+ */
+class MatchValidator {
+public:
+    static constexpr int32 slot_bits = 20;
+    static constexpr int32 slot_mask = (1 << slot_bits) - 1;
+    // a slot past it would spill into the generation bits of the id
+    static constexpr int32 max_matches = 1 << slot_bits;
+
+    /**
+     * @brief Starts a match.
+     *
+     * @param start The position the match starts from, the standard setup by default.
+     * @return The match id for submit and close_match, or -1 when max_matches are open already.
+     */
+    int32 create_match(const PackedBoard& start = Board::starting_position()) {
+        int32 slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            if (static_cast<int32>(matches.size()) >= max_matches) {
+                return -1;
+            }
+            slot = static_cast<int32>(matches.size());
+            matches.emplace_back();
+        }
+        Match& match = matches[slot];
+        match.position = start;
+        match.ply = 0;
+        match.status = MatchStatus::playing;
+        match.is_open = true;
+        match_count++;
+        return make_id(slot, match.generation);
+    }
+
+    /**
+     * @brief Ends a match; moves still queued for it are answered with unknown_match.
+     */
+    void close_match(const int32 id) {
+        Match* match = find(id);
+        if (match == nullptr) {
+            return;
+        }
+        match->is_open = false;
+        // 11 bits are left for the generation above the slot, enough that a stale id would have to sit out 2048 reuses
+        match->generation = (match->generation + 1) & 0x7FF;
+        free_slots.push_back(id & slot_mask);
+        match_count--;
+    }
+
+    /**
+     * @brief Gets a match's current position, for resyncing a client.
+     *
+     * @return false if the match does not exist.
+     */
+    bool get_position(const int32 id, PackedBoard& out, uint32& out_ply) const {
+        const Match* match = find(id);
+        if (match == nullptr) {
+            return false;
+        }
+        out = match->position;
+        out_ply = match->ply;
+        return true;
+    }
+
+    inline int32 get_match_count() const {
+        return match_count;
+    }
+
+    /**
+     * @brief Queues a move for the next tick; safe from any thread.
+     */
+    void submit(const MatchMove& move) {
+        std::lock_guard<std::mutex> lock(queue_lock);
+        queue.push_back(move);
+    }
+
+    /**
+     * @brief Checks and plays every move queued since the last tick.
+     *
+     * @param out The verdict of every queued move, in submission order; it is cleared first.
+     */
+    void tick(std::vector<MatchResult>& out) {
+        out.clear();
+        {
+            std::lock_guard<std::mutex> lock(queue_lock);
+            batch.swap(queue);
+        }
+        out.reserve(batch.size());
+        for (const MatchMove& move : batch) {
+            out.push_back(validate(move));
+        }
+        batch.clear();
+    }
+
+private:
+    struct Match {
+        PackedBoard position;
+        uint32 ply = 0;
+        MatchStatus status = MatchStatus::playing;
+        bool is_open = false;
+        int32 generation = 0;
+    };
+
+    static inline int32 make_id(const int32 slot, const int32 generation) {
+        return (generation << slot_bits) | slot;
+    }
+
+    Match* find(const int32 id) {
+        const int32 slot = id & slot_mask;
+        if (id < 0 || slot >= static_cast<int32>(matches.size())) {
+            return nullptr;
+        }
+        Match& match = matches[slot];
+        return match.is_open && make_id(slot, match.generation) == id ? &match : nullptr;
+    }
+
+    const Match* find(const int32 id) const {
+        return const_cast<MatchValidator*>(this)->find(id);
+    }
+
+    MatchResult validate(const MatchMove& move) {
+        MatchResult result;
+        result.move = move;
+        Match* match = find(move.match);
+        if (match == nullptr) {
+            result.verdict = MatchVerdict::unknown_match;
+            return result;
+        }
+        result.status = match->status;
+        PackedBoard& position = match->position;
+        if (match->status != MatchStatus::playing) {
+            result.verdict = MatchVerdict::game_over;
+        } else if (move.ply != match->ply) {
+            result.verdict = MatchVerdict::stale_ply;
+        } else if (move.is_black != position.black_to_move) {
+            result.verdict = MatchVerdict::wrong_turn;
+        } else if (!is_legal(position, move)) {
+            result.verdict = MatchVerdict::illegal;
+        } else {
+            position.make_move(move.from, move.to);
+            match->ply++;
+            match->status = find_status(position);
+            result.verdict = MatchVerdict::accepted;
+            result.status = match->status;
+        }
+        return result;
+    }
+
+    bool is_legal(PackedBoard& position, const MatchMove& move) {
+        if (move.from >= PackedBoard::cell_count || move.to >= PackedBoard::cell_count) {
+            return false;
+        }
+        const Cell::PieceColor side = position.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white;
+        if (position.cells[move.from].get_piece_color() != side) {
+            return false;
+        }
+        rules.get_valid_moves(position, PackedBoard::to_key(move.from), moves);
+        for (const Move& legal : moves) {
+            if (legal.to == move.to) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    MatchStatus find_status(PackedBoard& position) {
+        const Cell::PieceColor side = position.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white;
+        rules.generate_legal_moves(position, side, moves);
+        if (!moves.empty()) {
+            return MatchStatus::playing;
+        }
+        const int32 king = position.get_king_cell(side);
+        const Cell::PieceColor enemy = position.black_to_move ? Cell::PieceColor::white : Cell::PieceColor::black;
+        if (king == -1 || !rules.is_attacked(position, king, enemy)) {
+            return MatchStatus::stalemate;
+        }
+        return position.black_to_move ? MatchStatus::white_won : MatchStatus::black_won;
+    }
+
+    // move rules only, its own board is never played on
+    Board rules;
+    MoveList moves;
+
+    std::vector<Match> matches;
+    std::vector<int32> free_slots;
+    int32 match_count = 0;
+
+    std::mutex queue_lock;
+    std::vector<MatchMove> queue;
+    // the moves of the running tick, swapped with queue so submitting never waits on validation
+    std::vector<MatchMove> batch;
+};
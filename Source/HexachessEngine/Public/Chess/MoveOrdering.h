@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Chess/ChessEngine.h"
+#include "Chess/StaticExchange.h"
+
+/**
+ * @class MoveOrdering
+ * @brief Sorts a node's moves so alpha-beta meets the likely refutation first.
+ *
+ * Order: the transposition table move, then captures by MVV-LVA (most valuable victim, least valuable attacker),
+ * then the two killer moves of the ply, then the remaining quiet moves by their history score, and last the captures
+ * the static exchange evaluation says lose material, the least losing first.
+ */
+class MoveOrdering {
+public:
+    static constexpr int32 max_ply = 64;
+
+    MoveOrdering() {
+        clear();
+    }
+
+    inline int32 get_piece_value(const Cell::PieceType type) const {
+        return piece_values[type];
+    }
+
+    void clear() {
+        for (auto& ply_killers : killers) {
+            ply_killers[0] = Move(0, 0);
+            ply_killers[1] = Move(0, 0);
+        }
+        memset(history, 0, sizeof(history));
+    }
+
+    /**
+     * @brief Halves the history scores and forgets the killers, so a new search leans on recent cutoffs without forgetting older ones.
+     */
+    void age() {
+        halve_history();
+        for (auto& ply_killers : killers) {
+            ply_killers[0] = Move(0, 0);
+            ply_killers[1] = Move(0, 0);
+        }
+    }
+
+    /**
+     * @brief Sorts a move list in place, best candidates first.
+     *
+     * @param in_board The board the moves are played on.
+     * @param moves The moves to sort.
+     * @param hash_move The transposition table move, or a move with from == to if there is none.
+     * @param ply The distance from the root.
+     */
+    void order_moves(const PackedBoard& in_board, MoveList& moves, const Move& hash_move, const int32 ply) {
+        const int32 side = in_board.black_to_move ? 1 : 0;
+        const Move* ply_killers = killers[ply < max_ply ? ply : max_ply - 1];
+        int32 scores[MoveList::capacity];
+        for (int32 i = 0; i < moves.count; i++) {
+            const Move& move = moves.moves[i];
+            if (move.from == hash_move.from && move.to == hash_move.to && hash_move.from != hash_move.to) {
+                scores[i] = hash_score;
+            } else if (move.is_capture()) {
+                // an en passant capture takes a pawn from beside the empty target cell
+                const int32 victim = (move.flags & Move::Flags::en_passant) != 0 ? piece_values[Cell::PieceType::pawn] : piece_values[in_board.cells[move.to].get_piece_type()];
+                const int32 attacker = piece_values[in_board.cells[move.from].get_piece_type()];
+                // a cheaper victim is only worth the exchange when nothing, or not enough, takes back
+                const int32 exchange_value = victim < attacker ? exchange.evaluate(in_board, move) : 0;
+                scores[i] = exchange_value < 0 ? losing_capture_score + exchange_value : capture_score + victim * 128 - attacker;
+            } else if (is_same(move, ply_killers[0])) {
+                scores[i] = killer_score + 1;
+            } else if (is_same(move, ply_killers[1])) {
+                scores[i] = killer_score;
+            } else {
+                scores[i] = history[side][move.from][move.to];
+            }
+        }
+        // insertion sort: move lists are short and often nearly ordered already
+        for (int32 i = 1; i < moves.count; i++) {
+            const Move move = moves.moves[i];
+            const int32 score = scores[i];
+            int32 j = i - 1;
+            while (j >= 0 && scores[j] < score) {
+                moves.moves[j + 1] = moves.moves[j];
+                scores[j + 1] = scores[j];
+                j--;
+            }
+            moves.moves[j + 1] = move;
+            scores[j + 1] = score;
+        }
+    }
+
+    /**
+     * @brief Remembers a quiet move that caused a beta cutoff.
+     *
+     * @param in_board The board the move was played on.
+     * @param move The move.
+     * @param depth The remaining depth of the node, deeper cutoffs weigh more.
+     * @param ply The distance from the root.
+     */
+    void record_cutoff(const PackedBoard& in_board, const Move& move, const int32 depth, const int32 ply) {
+        if (move.is_capture()) {
+            return;
+        }
+        Move* ply_killers = killers[ply < max_ply ? ply : max_ply - 1];
+        if (!is_same(move, ply_killers[0])) {
+            ply_killers[1] = ply_killers[0];
+            ply_killers[0] = move;
+        }
+        int32& score = history[in_board.black_to_move ? 1 : 0][move.from][move.to];
+        score += depth * depth;
+        // keep history below the killer band
+        if (score >= killer_score) {
+            halve_history();
+        }
+    }
+
+    /**
+     * @brief Tells whether a move is one of the two killers of its ply.
+     */
+    inline bool is_killer(const Move& move, const int32 ply) const {
+        const Move* ply_killers = killers[ply < max_ply ? ply : max_ply - 1];
+        return is_same(move, ply_killers[0]) || is_same(move, ply_killers[1]);
+    }
+
+    /**
+     * @brief Gets the history score of a quiet move, how often and how deep it caused cutoffs lately.
+     *
+     * @param in_board The board the move is played on.
+     * @param move The move.
+     */
+    inline int32 get_history(const PackedBoard& in_board, const Move& move) const {
+        return history[in_board.black_to_move ? 1 : 0][move.from][move.to];
+    }
+
+    /**
+     * @brief Whether a capture loses material once the exchange on its cell is played out.
+     */
+    inline bool is_losing_capture(const PackedBoard& in_board, const Move& move) const {
+        return exchange.is_losing(in_board, move);
+    }
+
+private:
+    static constexpr int32 hash_score = 1 << 30;
+    static constexpr int32 capture_score = 1 << 24;
+    static constexpr int32 killer_score = 1 << 20;
+    // below every quiet move, whose history score never goes negative
+    static constexpr int32 losing_capture_score = -(1 << 24);
+
+    static inline bool is_same(const Move& a, const Move& b) {
+        return a.from == b.from && a.to == b.to;
+    }
+
+    void halve_history() {
+        for (auto& side_history : history) {
+            for (auto& from_history : side_history) {
+                for (int32& score : from_history) {
+                    score /= 2;
+                }
+            }
+        }
+    }
+
+    static constexpr PieceValueTable piece_values = Board::piece_values;
+    StaticExchange exchange;
+    Move killers[max_ply][2];
+    int32 history[2][PackedBoard::cell_count][PackedBoard::cell_count];
+};
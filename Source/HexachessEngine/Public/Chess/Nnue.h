@@ -0,0 +1,453 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "Chess/ChessEngine.h"
+#include "Chess/Evaluator.h"
+
+/**
+ * @brief Layer sizes of the network and the scales its integer weights are quantized to.
+ *
+ * Every piece is one input feature per point of view: whose piece it is (own or opponent's), its type and its cell,
+ * with black's point of view seeing the board upside down. The feature transformer turns each point of view into
+ * hidden_size accumulator values, both are clipped to [0, 127] and concatenated side to move first, then a dense
+ * layer of dense_size clipped neurons and a single output give the score for the side to move.
+ */
+struct NnueLayout {
+    static constexpr int32 piece_types = 6;
+    static constexpr int32 feature_count = 2 * piece_types * HexIndexTable::cell_count;
+    static constexpr int32 hidden_size = 128;
+    static constexpr int32 input_size = 2 * hidden_size;
+    static constexpr int32 dense_size = 32;
+    static constexpr int32 activation_max = 127;
+    // the dense layer's sums are shifted down by this before they are clipped
+    static constexpr int32 dense_shift = 6;
+    // the output divided by this is in evaluation units
+    static constexpr int32 output_divisor = 16;
+};
+
+/**
+ * @brief The two points of view of the feature transformer, white's first.
+ */
+struct alignas(32) NnueAccumulator {
+    int16 values[2][NnueLayout::hidden_size];
+};
+
+/**
+ * @brief What a move changes in the feature set: the moved piece leaves its cell, a captured piece leaves the board,
+ * the moved piece arrives on its new cell. A null move changes nothing.
+ */
+struct NnueDelta {
+    struct Piece {
+        uint8 index;
+        Square square;
+    };
+
+    Piece removed[2];
+    Piece added[1];
+    int8 removed_count = 0;
+    int8 added_count = 0;
+
+    static inline NnueDelta from_move(const UndoRecord& undo) {
+        NnueDelta delta;
+        delta.removed[delta.removed_count++] = {undo.from, undo.moved};
+        if (undo.captured.has_white_piece() || undo.captured.has_black_piece()) {
+            delta.removed[delta.removed_count++] = {undo.captured_cell, undo.captured};
+        }
+        delta.added[delta.added_count++] = {undo.to, undo.moved};
+        return delta;
+    }
+};
+
+/**
+ * @class NnueNetwork
+ * @brief Quantized weights of an efficiently updatable neural network, and the integer inference over them.
+ *
+ * The binary form is the magic "HXNN", a uint32 version, then these little-endian arrays without padding:
+ * int16 feature_bias[hidden_size], int16 feature_weights[feature_count][hidden_size], int32 dense_bias[dense_size],
+ * int8 dense_weights[dense_size][input_size], int32 output_bias, int8 output_weights[dense_size].
+ */
+class NnueNetwork {
+public:
+    static constexpr uint32 magic = 'H' | ('X' << 8) | ('N' << 16) | ('N' << 24);
+    static constexpr uint32 version = 1;
+    static constexpr size_t file_size = 8 + sizeof(int16) * NnueLayout::hidden_size
+                                        + sizeof(int16) * NnueLayout::feature_count * NnueLayout::hidden_size
+                                        + sizeof(int32) * NnueLayout::dense_size + NnueLayout::dense_size * NnueLayout::input_size
+                                        + sizeof(int32) + NnueLayout::dense_size;
+
+    /**
+     * @brief Reads the weights from their binary form.
+     *
+     * @param data The file contents.
+     * @param size The size of the contents in bytes.
+     * @return true if the magic, the version and the size all match, false otherwise; the weights are left untouched then.
+     */
+    bool load(const uint8* data, const size_t size) {
+        uint32 header[2];
+        if (data == nullptr || size != file_size) {
+            return false;
+        }
+        memcpy(header, data, sizeof(header));
+        if (header[0] != magic || header[1] != version) {
+            return false;
+        }
+        const uint8* cursor = data + sizeof(header);
+        feature_weights.resize(static_cast<size_t>(NnueLayout::feature_count) * NnueLayout::hidden_size);
+        read(cursor, feature_bias, sizeof(feature_bias));
+        read(cursor, feature_weights.data(), feature_weights.size() * sizeof(int16));
+        read(cursor, dense_bias, sizeof(dense_bias));
+        read(cursor, dense_weights, sizeof(dense_weights));
+        read(cursor, &output_bias, sizeof(output_bias));
+        read(cursor, output_weights, sizeof(output_weights));
+        return true;
+    }
+
+    inline bool is_loaded() const {
+        return !feature_weights.empty();
+    }
+
+    /**
+     * @brief The input feature of a piece from one point of view.
+     *
+     * @param perspective 0 for white's point of view, 1 for black's.
+     * @param index The piece's dense cell index.
+     * @param square The piece.
+     */
+    static inline int32 feature_index(const int32 perspective, const int32 index, const Square square) {
+        const int32 owner = PackedBoard::side_of(square.get_piece_color()) == perspective ? 0 : 1;
+        const int32 cell = perspective == 0 ? index : mirrored_cells()[index];
+        return (owner * NnueLayout::piece_types + square.get_piece_type() - 1) * HexIndexTable::cell_count + cell;
+    }
+
+    /**
+     * @brief Computes both points of view of a position from scratch.
+     *
+     * @param in_board The position.
+     * @param out The accumulator to fill.
+     */
+    void refresh(const PackedBoard& in_board, NnueAccumulator& out) const {
+        for (int32 perspective = 0; perspective < 2; perspective++) {
+            int16* values = out.values[perspective];
+            memcpy(values, feature_bias, sizeof(feature_bias));
+            for (int32 side = 0; side < 2; side++) {
+                for (int32 slot = 0; slot < in_board.piece_count[side]; slot++) {
+                    const int32 index = in_board.piece_cells[side][slot];
+                    add_row(values, feature_index(perspective, index, in_board.cells[index]));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Computes a child position's accumulator from its parent's and the move between them.
+     *
+     * @param parent The parent position's accumulator.
+     * @param delta What the move changed.
+     * @param out The child's accumulator; may not be the parent's.
+     */
+    void update(const NnueAccumulator& parent, const NnueDelta& delta, NnueAccumulator& out) const {
+        for (int32 perspective = 0; perspective < 2; perspective++) {
+            int16* values = out.values[perspective];
+            memcpy(values, parent.values[perspective], sizeof(parent.values[perspective]));
+            for (int32 i = 0; i < delta.removed_count; i++) {
+                sub_row(values, feature_index(perspective, delta.removed[i].index, delta.removed[i].square));
+            }
+            for (int32 i = 0; i < delta.added_count; i++) {
+                add_row(values, feature_index(perspective, delta.added[i].index, delta.added[i].square));
+            }
+        }
+    }
+
+    /**
+     * @brief Runs the layers above the feature transformer.
+     *
+     * @param accumulator The position's accumulator.
+     * @param black_to_move Which point of view goes first.
+     * @return The score in evaluation units, positive when white is better.
+     */
+    int32 evaluate(const NnueAccumulator& accumulator, const bool black_to_move) const {
+        alignas(32) uint8 input[NnueLayout::input_size];
+        clip_input(accumulator, black_to_move, input);
+
+        int32 output = output_bias;
+        for (int32 neuron = 0; neuron < NnueLayout::dense_size; neuron++) {
+            output += activate(input, neuron) * output_weights[neuron];
+        }
+        const int32 score = output / NnueLayout::output_divisor;
+        return black_to_move ? -score : score;
+    }
+
+    /**
+     * @brief Scores several positions from scratch, a few at a time, so each dense row is read once for all of them.
+     *
+     * @param positions The positions to score.
+     * @param count How many there are.
+     * @param out_scores One score per position, the same as refresh followed by evaluate gives.
+     */
+    void evaluate_batch(const PackedBoard* positions, const int32 count, int32* out_scores) const {
+        constexpr int32 chunk_size = 8;
+        alignas(32) uint8 inputs[chunk_size][NnueLayout::input_size];
+        int32 outputs[chunk_size];
+        for (int32 first = 0; first < count; first += chunk_size) {
+            const int32 size = count - first < chunk_size ? count - first : chunk_size;
+            for (int32 i = 0; i < size; i++) {
+                NnueAccumulator accumulator;
+                refresh(positions[first + i], accumulator);
+                clip_input(accumulator, positions[first + i].black_to_move, inputs[i]);
+                outputs[i] = output_bias;
+            }
+            for (int32 neuron = 0; neuron < NnueLayout::dense_size; neuron++) {
+                for (int32 i = 0; i < size; i++) {
+                    outputs[i] += activate(inputs[i], neuron) * output_weights[neuron];
+                }
+            }
+            for (int32 i = 0; i < size; i++) {
+                const int32 score = outputs[i] / NnueLayout::output_divisor;
+                out_scores[first + i] = positions[first + i].black_to_move ? -score : score;
+            }
+        }
+    }
+
+private:
+    static inline void read(const uint8*& cursor, void* out, const size_t bytes) {
+        memcpy(out, cursor, bytes);
+        cursor += bytes;
+    }
+
+    /**
+     * @brief The dense layer's input: the side to move's half first, both clipped to bytes.
+     */
+    inline void clip_input(const NnueAccumulator& accumulator, const bool black_to_move, uint8* input) const {
+        clip_half(accumulator.values[black_to_move ? 1 : 0], input);
+        clip_half(accumulator.values[black_to_move ? 0 : 1], input + NnueLayout::hidden_size);
+    }
+
+    /**
+     * @brief One dense neuron's clipped activation.
+     */
+    inline int32 activate(const uint8* input, const int32 neuron) const {
+        const int32 sum = (dot(input, dense_weights[neuron]) + dense_bias[neuron]) >> NnueLayout::dense_shift;
+        return sum < 0 ? 0 : sum > NnueLayout::activation_max ? NnueLayout::activation_max : sum;
+    }
+
+    /**
+     * @brief Dense cell indices seen from black's side: every column upside down.
+     */
+    static const uint8* mirrored_cells() {
+        static const struct Mirror {
+            uint8 cells[HexIndexTable::cell_count];
+            Mirror() {
+                for (int32 index = 0; index < HexIndexTable::cell_count; index++) {
+                    const int32 key = PackedBoard::to_key(index);
+                    const int32 x = key >> 8;
+                    const int32 y = key & 0xFF;
+                    cells[index] = static_cast<uint8>(PackedBoard::to_index((x << 8) + hex_column_height(x) - 1 - y));
+                }
+            }
+        } mirror;
+        return mirror.cells;
+    }
+
+    inline void add_row(int16* values, const int32 feature) const {
+        const int16* row = feature_weights.data() + static_cast<size_t>(feature) * NnueLayout::hidden_size;
+#if HEXACHESS_EVALUATION_AVX2
+        for (int32 i = 0; i < NnueLayout::hidden_size; i += 16) {
+            const __m256i sum = _mm256_add_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(values + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values + i), sum);
+        }
+#else
+        for (int32 i = 0; i < NnueLayout::hidden_size; i++) {
+            values[i] = static_cast<int16>(values[i] + row[i]);
+        }
+#endif
+    }
+
+    inline void sub_row(int16* values, const int32 feature) const {
+        const int16* row = feature_weights.data() + static_cast<size_t>(feature) * NnueLayout::hidden_size;
+#if HEXACHESS_EVALUATION_AVX2
+        for (int32 i = 0; i < NnueLayout::hidden_size; i += 16) {
+            const __m256i difference = _mm256_sub_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(values + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values + i), difference);
+        }
+#else
+        for (int32 i = 0; i < NnueLayout::hidden_size; i++) {
+            values[i] = static_cast<int16>(values[i] - row[i]);
+        }
+#endif
+    }
+
+    /**
+     * @brief Clips one point of view to [0, 127] and narrows it to bytes.
+     */
+    static inline void clip_half(const int16* values, uint8* out) {
+#if HEXACHESS_EVALUATION_AVX2
+        const __m256i max = _mm256_set1_epi8(NnueLayout::activation_max);
+        for (int32 i = 0; i < NnueLayout::hidden_size; i += 32) {
+            const __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+            const __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i + 16));
+            // packing works per 128-bit lane, the permute puts the eight-byte groups back in order
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(out + i), _mm256_min_epu8(packed, max));
+        }
+#else
+        for (int32 i = 0; i < NnueLayout::hidden_size; i++) {
+            out[i] = static_cast<uint8>(values[i] < 0 ? 0 : values[i] > NnueLayout::activation_max ? NnueLayout::activation_max : values[i]);
+        }
+#endif
+    }
+
+    /**
+     * @brief The dot product of the clipped input with one neuron's weights.
+     */
+    static inline int32 dot(const uint8* input, const int8* weights) {
+#if HEXACHESS_EVALUATION_AVX2
+        // inputs are at most 127, so two products of a pair never saturate the 16-bit sum
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+        for (int32 i = 0; i < NnueLayout::input_size; i += 32) {
+            const __m256i pairs = _mm256_maddubs_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(input + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(pairs, ones));
+        }
+        const __m128i halves = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        const __m128i quarters = _mm_add_epi32(halves, _mm_shuffle_epi32(halves, 0x4E));
+        return _mm_cvtsi128_si32(_mm_add_epi32(quarters, _mm_shuffle_epi32(quarters, 0xB1)));
+#else
+        int32 sum = 0;
+        for (int32 i = 0; i < NnueLayout::input_size; i++) {
+            sum += input[i] * weights[i];
+        }
+        return sum;
+#endif
+    }
+
+    alignas(32) int16 feature_bias[NnueLayout::hidden_size] = {};
+    std::vector<int16> feature_weights;
+    int32 dense_bias[NnueLayout::dense_size] = {};
+    alignas(32) int8 dense_weights[NnueLayout::dense_size][NnueLayout::input_size] = {};
+    int32 output_bias = 0;
+    int8 output_weights[NnueLayout::dense_size] = {};
+};
+
+/**
+ * @class NnueAccumulatorStack
+ * @brief One accumulator per ply of a search path, brought up to date only when a position is evaluated.
+ *
+ * A move only records its delta; evaluation walks back to the last ply whose accumulator is computed and applies the
+ * deltas from there, so nodes cut off before they evaluate anything never pay for an update. Undoing a move is a pop.
+ */
+class NnueAccumulatorStack {
+public:
+
+    /**
+     * @brief Makes room for the given number of plies above the root.
+     *
+     * @return true if the stack had to grow.
+     */
+    bool reserve(const int32 plies) {
+        if (static_cast<int32>(entries.size()) < plies + 1) {
+            entries.resize(plies + 1);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Starts a new path at the given position.
+     */
+    void reset(const NnueNetwork& network, const PackedBoard& in_board) {
+        reserve(0);
+        top = 0;
+        network.refresh(in_board, entries[0].accumulator);
+        entries[0].is_computed = true;
+    }
+
+    /**
+     * @brief Records a move just made on the board.
+     *
+     * @param undo The record make_move returned.
+     */
+    inline void push(const UndoRecord& undo) {
+        push_delta(NnueDelta::from_move(undo));
+    }
+
+    /**
+     * @brief Records a null move: the pieces stay, only the side to move changes.
+     */
+    inline void push_null() {
+        push_delta(NnueDelta());
+    }
+
+    inline void pop() {
+        top--;
+    }
+
+    /**
+     * @brief Scores the position at the top of the stack.
+     *
+     * @param network The network the stack was reset with.
+     * @param in_board The position at the top of the stack.
+     * @return The score in evaluation units, positive when white is better.
+     */
+    int32 evaluate(const NnueNetwork& network, const PackedBoard& in_board) {
+        int32 computed = top;
+        while (!entries[computed].is_computed) {
+            computed--;
+        }
+        for (int32 ply = computed + 1; ply <= top; ply++) {
+            network.update(entries[ply - 1].accumulator, entries[ply].delta, entries[ply].accumulator);
+            entries[ply].is_computed = true;
+        }
+        return network.evaluate(entries[top].accumulator, in_board.black_to_move);
+    }
+
+private:
+    struct Entry {
+        NnueAccumulator accumulator;
+        NnueDelta delta;
+        bool is_computed = false;
+    };
+
+    inline void push_delta(const NnueDelta& delta) {
+        top++;
+        // the search reserves its deepest path up front, growing here only happens if it did not
+        if (top >= static_cast<int32>(entries.size())) {
+            entries.resize(top + 1);
+        }
+        entries[top].delta = delta;
+        entries[top].is_computed = false;
+    }
+
+    std::vector<Entry> entries;
+    int32 top = 0;
+};
+
+/**
+ * @class NnueEvaluator
+ * @brief The network behind the evaluator interface; every call computes the accumulator from scratch.
+ *
+ * Searches that know the network through get_network keep an NnueAccumulatorStack instead and only pay for the
+ * pieces a move changed.
+ */
+class NnueEvaluator : public Evaluator {
+public:
+    explicit NnueEvaluator(const NnueNetwork& in_network): network(in_network) {}
+
+    int32 evaluate(Board&, const PackedBoard& in_board) const override {
+        NnueAccumulator accumulator;
+        network.refresh(in_board, accumulator);
+        return network.evaluate(accumulator, in_board.black_to_move);
+    }
+
+    void evaluate_batch(Board&, const PackedBoard* positions, const int32 count, int32* out_scores) const override {
+        network.evaluate_batch(positions, count, out_scores);
+    }
+
+    const NnueNetwork* get_network() const override {
+        return &network;
+    }
+
+private:
+    NnueNetwork network;
+};
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <string>
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @brief A position in 46 bytes: one nibble per cell in dense index order, then one nibble for the side to move.
+ *
+ * A cell's nibble is its piece type (0 for empty) with bit 3 set for black pieces.
+ */
+struct EncodedPosition {
+    static constexpr int32 size = (PackedBoard::cell_count + 2) / 2;
+
+    uint8 bytes[size] = {};
+};
+
+static_assert(sizeof(EncodedPosition) == 46, "EncodedPosition must stay 46 bytes");
+
+/**
+ * @class PositionCodec
+ * @brief Converts positions to and from the compact binary form and a FEN-like text form.
+ *
+ * The text form lists the 11 columns from x = 0, each from its bottom cell up, separated by '/'.
+ * Pieces are PNBRQK for white and pnbrqk for black, a number stands for that many empty cells,
+ * and " w" or " b" after the last column gives the side to move. The starting position reads
+ * "6/P5p/NP4pn/R1P3p1r/Q2P2p2q/BBB1P1p1bbb/K2P2p2k/R1P3p1r/NP4pn/P5p/6 w". Neither form holds a move history.
+ */
+class PositionCodec {
+public:
+
+    /**
+     * @brief Encodes a position into its binary form.
+     *
+     * @param in_board The position to encode.
+     * @param out The encoded position.
+     */
+    static void encode(const PackedBoard& in_board, EncodedPosition& out) {
+        out = EncodedPosition();
+        for (int32 index = 0; index < PackedBoard::cell_count; index++) {
+            set_nibble(out, index, to_nibble(in_board.get_square(index)));
+        }
+        set_nibble(out, PackedBoard::cell_count, in_board.black_to_move ? 1 : 0);
+    }
+
+    /**
+     * @brief Decodes a binary position.
+     *
+     * @param in The encoded position.
+     * @param out The board to fill; it is left untouched if the encoding is invalid.
+     * @return true if every nibble held a piece or an empty cell, false otherwise.
+     */
+    static bool decode(const EncodedPosition& in, PackedBoard& out) {
+        PackedBoard result;
+        for (int32 index = 0; index < PackedBoard::cell_count; index++) {
+            const uint8 nibble = get_nibble(in, index);
+            const int32 type = nibble & 0x7;
+            if (type > Cell::PieceType::king || (type == Cell::PieceType::none && nibble != 0)) {
+                return false;
+            }
+            if (type != Cell::PieceType::none) {
+                result.set_cell(index, static_cast<Cell::PieceType>(type), (nibble & 0x8) != 0 ? Cell::PieceColor::black : Cell::PieceColor::white);
+            }
+        }
+        const uint8 side_to_move = get_nibble(in, PackedBoard::cell_count);
+        if (side_to_move > 1) {
+            return false;
+        }
+        if (side_to_move == 1) {
+            result.flip_side_to_move();
+        }
+        out = result;
+        return true;
+    }
+
+    /**
+     * @brief Writes a position in the text form.
+     *
+     * @param in_board The position to write.
+     * @return The text, at most a few dozen characters.
+     */
+    static std::string to_text(const PackedBoard& in_board) {
+        std::string result;
+        result.reserve(PackedBoard::cell_count + HexIndexTable::columns + 2);
+        int32 index = 0;
+        for (int32 x = 0; x < HexIndexTable::columns; x++) {
+            if (x > 0) {
+                result += '/';
+            }
+            int32 empty = 0;
+            for (int32 y = 0; y < hex_column_height(x); y++, index++) {
+                const Square square = in_board.get_square(index);
+                if (!square.has_piece()) {
+                    empty++;
+                    continue;
+                }
+                if (empty > 0) {
+                    result += std::to_string(empty);
+                    empty = 0;
+                }
+                result += to_letter(square);
+            }
+            if (empty > 0) {
+                result += std::to_string(empty);
+            }
+        }
+        result += in_board.black_to_move ? " b" : " w";
+        return result;
+    }
+
+    /**
+     * @brief Reads a position in the text form.
+     *
+     * @param text The text to read.
+     * @param out The board to fill; it is left untouched if the text is invalid.
+     * @return true if the text described every cell of every column, false otherwise.
+     */
+    static bool from_text(const std::string& text, PackedBoard& out) {
+        PackedBoard result;
+        size_t i = 0;
+        int32 index = 0;
+        for (int32 x = 0; x < HexIndexTable::columns; x++) {
+            if (x > 0 && (i >= text.size() || text[i++] != '/')) {
+                return false;
+            }
+            const int32 column_end = index + hex_column_height(x);
+            while (index < column_end) {
+                if (i >= text.size()) {
+                    return false;
+                }
+                const char c = text[i++];
+                if (c >= '0' && c <= '9') {
+                    int32 empty = c - '0';
+                    while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+                        empty = empty * 10 + (text[i++] - '0');
+                    }
+                    if (empty == 0 || index + empty > column_end) {
+                        return false;
+                    }
+                    index += empty;
+                    continue;
+                }
+                Cell::PieceType type;
+                Cell::PieceColor color;
+                if (!from_letter(c, type, color)) {
+                    return false;
+                }
+                result.set_cell(index++, type, color);
+            }
+        }
+        if (text.compare(i, std::string::npos, " b") == 0) {
+            result.flip_side_to_move();
+        } else if (text.compare(i, std::string::npos, " w") != 0) {
+            return false;
+        }
+        out = result;
+        return true;
+    }
+
+private:
+    static constexpr char letters[] = " pnbrqk";
+
+    static inline uint8 to_nibble(const Square square) {
+        if (!square.has_piece()) {
+            return 0;
+        }
+        return static_cast<uint8>(square.get_piece_type() | (square.get_piece_color() == Cell::PieceColor::black ? 0x8 : 0));
+    }
+
+    static inline uint8 get_nibble(const EncodedPosition& in, const int32 i) {
+        return (in.bytes[i / 2] >> ((i % 2) * 4)) & 0xF;
+    }
+
+    static inline void set_nibble(EncodedPosition& out, const int32 i, const uint8 nibble) {
+        out.bytes[i / 2] |= static_cast<uint8>(nibble << ((i % 2) * 4));
+    }
+
+    static inline char to_letter(const Square square) {
+        const char letter = letters[square.get_piece_type()];
+        return square.get_piece_color() == Cell::PieceColor::white ? static_cast<char>(letter - 'a' + 'A') : letter;
+    }
+
+    static inline bool from_letter(const char c, Cell::PieceType& out_type, Cell::PieceColor& out_color) {
+        const bool is_white = c >= 'A' && c <= 'Z';
+        const char letter = is_white ? static_cast<char>(c - 'A' + 'a') : c;
+        for (int32 type = Cell::PieceType::pawn; type <= Cell::PieceType::king; type++) {
+            if (letters[type] == letter) {
+                out_type = static_cast<Cell::PieceType>(type);
+                out_color = is_white ? Cell::PieceColor::white : Cell::PieceColor::black;
+                return true;
+            }
+        }
+        return false;
+    }
+};
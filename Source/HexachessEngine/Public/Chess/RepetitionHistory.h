@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @class RepetitionHistory
+ * @brief The hashes of the positions on the way to the current one, pushed and popped with make and unmake, so a search
+ * can tell in constant time that a position cannot be a repetition, and how many reversible plies lead up to it.
+ *
+ * Alongside the stack a small table counts how many stored hashes share each low-bit bucket. A position whose bucket is
+ * empty was never on the path; only a hit walks the stack, every second entry back to the last irreversible move, since
+ * the side to move is in the hash and nothing before a capture or a pawn move can occur again.
+ *
+ * The game's own moves since its last irreversible one are loaded first, so a line that goes back into the game's
+ * past is recognised too. The stack belongs to one search thread.
+ */
+class RepetitionHistory {
+public:
+    // the game's part is cut to half of it, the search path gets the other half
+    static constexpr int32 capacity = 1024;
+
+    /**
+     * @brief Forgets every position; the next push starts from a position with that many reversible plies behind it.
+     *
+     * @param in_reversible_plies The plies since the last capture or pawn move before the first pushed position.
+     */
+    void clear(const int32 in_reversible_plies = 0) {
+        count = 0;
+        base_reversible_plies = in_reversible_plies;
+        for (uint16& bucket : buckets) {
+            bucket = 0;
+        }
+    }
+
+    /**
+     * @brief Loads the game's positions before the current one since its last irreversible move, oldest first.
+     *
+     * @param in_hashes The hashes of those positions, side to move included; each one a move of the game was played from.
+     * @param in_count How many hashes there are, which is also the number of reversible plies behind the current position.
+     */
+    void load(const uint64* in_hashes, const int32 in_count) {
+        // only the most recent positions are kept, the ply count still covers all of them
+        const int32 kept = in_count < capacity / 2 ? in_count : capacity / 2;
+        clear(in_count - kept);
+        for (int32 i = in_count - kept; i < in_count; i++) {
+            push(in_hashes[i], false);
+        }
+    }
+
+    /**
+     * @brief Copies the first positions of another thread's history, the path down to a node that thread shares.
+     *
+     * Only those entries are read, the owner may keep pushing and popping above them meanwhile.
+     *
+     * @param other The history to copy from.
+     * @param in_count How many of its positions to copy, its size when the node was shared.
+     */
+    void copy_from(const RepetitionHistory& other, const int32 in_count) {
+        clear(other.base_reversible_plies);
+        for (int32 i = 0; i < in_count; i++) {
+            entries[i] = other.entries[i];
+            buckets[entries[i].hash & bucket_mask]++;
+        }
+        count = in_count;
+    }
+
+    /**
+     * @brief Records the position a move is played from, before it is made.
+     *
+     * @param hash The position's hash.
+     * @param is_irreversible Whether the move captures or moves a pawn; a null move counts as one too, a line through it
+     * proves nothing about repetitions.
+     */
+    void push(const uint64 hash, const bool is_irreversible) {
+        Entry& entry = entries[count];
+        entry.hash = hash;
+        entry.reversible_plies = is_irreversible ? 0 : get_reversible_plies() + 1;
+        buckets[hash & bucket_mask]++;
+        count++;
+    }
+
+    /**
+     * @brief Forgets the last pushed position, after its move was taken back.
+     */
+    void pop() {
+        count--;
+        buckets[entries[count].hash & bucket_mask]--;
+    }
+
+    /**
+     * @brief Whether a position already occurred on the path since the last irreversible move.
+     *
+     * @param hash The hash of the position after the last pushed move.
+     */
+    bool is_repetition(const uint64 hash) const {
+        if (buckets[hash & bucket_mask] == 0) {
+            return false;
+        }
+        // the position before the last move had the other side to move, and the one before the oldest reversible move is out of reach
+        const int32 oldest = count - get_reversible_plies();
+        for (int32 i = count - 2; i >= oldest && i >= 0; i -= 2) {
+            if (entries[i].hash == hash) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief The plies played since the last capture or pawn move, for the fifty-move rule.
+     */
+    int32 get_reversible_plies() const {
+        return count > 0 ? entries[count - 1].reversible_plies : base_reversible_plies;
+    }
+
+    int32 size() const {
+        return count;
+    }
+
+private:
+    struct Entry {
+        uint64 hash = 0;
+        int32 reversible_plies = 0;
+    };
+
+    static constexpr int32 bucket_count = 1024;
+    static constexpr uint64 bucket_mask = bucket_count - 1;
+
+    Entry entries[capacity];
+    // how many entries fall in each bucket, at most capacity so it has to count past 255
+    uint16 buckets[bucket_count] = {};
+    int32 count = 0;
+    int32 base_reversible_plies = 0;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @class SearchArena
+ * @brief Linear allocator for one search thread's per-node scratch: move lists and other buffers that live as long as a node.
+ *
+ * Allocation bumps an offset and freeing rewinds it, so scratch taken by a node is given back when the node returns
+ * and the whole arena is emptied with one reset at the root. The memory is allocated once per thread and only grows
+ * when a deeper search needs more, so the search never touches the global allocator.
+ */
+class SearchArena {
+public:
+    SearchArena() = default;
+
+    SearchArena(const SearchArena&) = delete;
+    SearchArena& operator=(const SearchArena&) = delete;
+
+    /**
+     * @brief Makes room for at least the given number of bytes, and empties the arena.
+     *
+     * @param bytes The capacity needed by the deepest search expected.
+     * @return true if the arena had to allocate.
+     */
+    bool reserve(const size_t bytes) {
+        used = 0;
+        if (bytes > capacity) {
+            memory.reset(new uint8[bytes]);
+            capacity = bytes;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Forgets every allocation; called at the start of every root search.
+     */
+    inline void reset() {
+        used = 0;
+    }
+
+    /**
+     * @brief Takes a default-constructed object from the arena.
+     *
+     * @return The object, or null when the arena is full.
+     */
+    template <typename T>
+    T* allocate() {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed, only rewound");
+        const size_t offset = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (offset + sizeof(T) > capacity) {
+            return nullptr;
+        }
+        used = offset + sizeof(T);
+        return new (memory.get() + offset) T();
+    }
+
+    inline size_t mark() const {
+        return used;
+    }
+
+    /**
+     * @brief Gives back everything allocated since the mark was taken.
+     */
+    inline void rewind(const size_t in_mark) {
+        used = in_mark;
+    }
+
+    inline size_t get_capacity() const {
+        return capacity;
+    }
+
+private:
+    std::unique_ptr<uint8[]> memory;
+    size_t capacity = 0;
+    size_t used = 0;
+};
+
+/**
+ * @brief Rewinds an arena to where it stood when the scope was opened.
+ */
+class SearchArenaScope {
+public:
+    explicit SearchArenaScope(SearchArena& in_arena): arena(in_arena), start(in_arena.mark()) {}
+    ~SearchArenaScope() {
+        arena.rewind(start);
+    }
+
+    SearchArenaScope(const SearchArenaScope&) = delete;
+    SearchArenaScope& operator=(const SearchArenaScope&) = delete;
+
+private:
+    SearchArena& arena;
+    const size_t start;
+};
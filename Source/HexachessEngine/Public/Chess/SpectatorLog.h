@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "Chess/PositionCodec.h"
+
+/**
+ * @class SpectatorLog
+ * @brief Append-only binary record of a live game for spectators: every move, and now and then the whole position.
+ *
+ * The log is a run of records, each starting with its kind:
+ * - a move: the kind, then the from and to cells as dense indices, 3 bytes;
+ * - a keyframe: the kind, the ply as 4 little-endian bytes, the encoded position and the pawn shadow cell (0xFF for none), 52 bytes.
+ *
+ * A keyframe follows every keyframe_interval-th move, and stands on its own wherever the game jumps instead of moving
+ * (a new game, an undo, a loaded position). A spectator joining mid-game reads from get_join_offset(), the last keyframe,
+ * so at most keyframe_interval moves are replayed however long the game has run. Bytes once written never change.
+ */
+class SpectatorLog {
+public:
+    enum RecordKind : uint8 {
+        move_record = 1,
+        keyframe_record = 2
+    };
+
+    static constexpr int32 move_size = 3;
+    static constexpr int32 keyframe_size = 1 + 4 + EncodedPosition::size + 1;
+
+    explicit SpectatorLog(const int32 in_keyframe_interval = 32) : keyframe_interval(in_keyframe_interval < 1 ? 1 : in_keyframe_interval) {
+    }
+
+    /**
+     * @brief Writes the whole position, for the start of a game and whenever the position changes other than by a move.
+     *
+     * @param in_board The position as it now stands.
+     * @param in_ply How many moves the game has played to reach it.
+     */
+    void write_keyframe(const PackedBoard& in_board, const uint32 in_ply) {
+        join_offset = bytes.size();
+        ply = in_ply;
+        moves_since_keyframe = 0;
+        bytes.push_back(keyframe_record);
+        for (int32 i = 0; i < 4; i++) {
+            bytes.push_back(static_cast<uint8>(ply >> (i * 8)));
+        }
+        EncodedPosition encoded;
+        PositionCodec::encode(in_board, encoded);
+        bytes.insert(bytes.end(), encoded.bytes, encoded.bytes + EncodedPosition::size);
+        bytes.push_back(static_cast<uint8>(in_board.shadow_cell));
+    }
+
+    /**
+     * @brief Writes a played move, followed by a keyframe when one is due.
+     *
+     * @param from The dense index the piece left.
+     * @param to The dense index it went to.
+     * @param after The position after the move, only read for the keyframe.
+     */
+    void write_move(const int32 from, const int32 to, const PackedBoard& after) {
+        bytes.push_back(move_record);
+        bytes.push_back(static_cast<uint8>(from));
+        bytes.push_back(static_cast<uint8>(to));
+        if (++moves_since_keyframe >= keyframe_interval) {
+            write_keyframe(after, ply + 1);
+        } else {
+            ply++;
+        }
+    }
+
+    /**
+     * @brief Where a spectator joining now starts reading: the last keyframe, or 0 before the first one.
+     */
+    inline size_t get_join_offset() const {
+        return join_offset;
+    }
+
+    inline const std::vector<uint8>& get_bytes() const {
+        return bytes;
+    }
+
+    inline bool is_empty() const {
+        return bytes.empty();
+    }
+
+private:
+    std::vector<uint8> bytes;
+    size_t join_offset = 0;
+    uint32 ply = 0;
+    int32 moves_since_keyframe = 0;
+    int32 keyframe_interval;
+};
+
+/**
+ * @class SpectatorReader
+ * @brief A spectator's copy of the game, kept in step by feeding it a SpectatorLog's bytes in order.
+ *
+ * Bytes may arrive in pieces of any size; a record split across two pieces is held back until it is whole.
+ * Moves before the first keyframe are skipped, so reading may start anywhere a record starts.
+ */
+class SpectatorReader {
+public:
+    /**
+     * @brief Reads the next bytes of the log.
+     *
+     * @param data The bytes, starting where the previous call left off.
+     * @param size How many there are.
+     * @return false if a record is not one a SpectatorLog writes; the reader has to start over from a keyframe then.
+     */
+    bool feed(const uint8* data, const size_t size) {
+        pending.insert(pending.end(), data, data + size);
+        size_t offset = 0;
+        bool is_valid = true;
+        while (offset < pending.size()) {
+            const uint8 kind = pending[offset];
+            const size_t record_size = kind == SpectatorLog::move_record ? SpectatorLog::move_size
+                : kind == SpectatorLog::keyframe_record ? SpectatorLog::keyframe_size : 0;
+            if (record_size == 0) {
+                is_valid = false;
+                break;
+            }
+            if (pending.size() - offset < record_size) {
+                break;
+            }
+            const uint8* record = pending.data() + offset;
+            if (!(kind == SpectatorLog::move_record ? read_move(record) : read_keyframe(record))) {
+                is_valid = false;
+                break;
+            }
+            offset += record_size;
+        }
+        if (!is_valid) {
+            reset();
+            return false;
+        }
+        pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(offset));
+        return true;
+    }
+
+    void reset() {
+        pending.clear();
+        has_keyframe = false;
+        ply = 0;
+        position = PackedBoard();
+    }
+
+    /**
+     * @brief false until the first keyframe is read; the position means nothing before that.
+     */
+    inline bool has_position() const {
+        return has_keyframe;
+    }
+
+    inline const PackedBoard& get_position() const {
+        return position;
+    }
+
+    inline uint32 get_ply() const {
+        return ply;
+    }
+
+private:
+    bool read_move(const uint8* record) {
+        if (!has_keyframe) {
+            return true;
+        }
+        const uint8 from = record[1];
+        const uint8 to = record[2];
+        if (from >= PackedBoard::cell_count || to >= PackedBoard::cell_count || from == to) {
+            return false;
+        }
+        const Cell::PieceColor side = position.black_to_move ? Cell::PieceColor::black : Cell::PieceColor::white;
+        if (position.cells[from].get_piece_color() != side) {
+            return false;
+        }
+        position.make_move(from, to);
+        ply++;
+        return true;
+    }
+
+    bool read_keyframe(const uint8* record) {
+        uint32 keyframe_ply = 0;
+        for (int32 i = 0; i < 4; i++) {
+            keyframe_ply |= static_cast<uint32>(record[1 + i]) << (i * 8);
+        }
+        EncodedPosition encoded;
+        memcpy(encoded.bytes, record + 5, EncodedPosition::size);
+        const int8 shadow = static_cast<int8>(record[SpectatorLog::keyframe_size - 1]);
+        PackedBoard decoded;
+        if (!PositionCodec::decode(encoded, decoded) || shadow < -1 || shadow >= PackedBoard::cell_count) {
+            return false;
+        }
+        decoded.set_shadow(shadow);
+        position = decoded;
+        ply = keyframe_ply;
+        has_keyframe = true;
+        return true;
+    }
+
+    std::vector<uint8> pending;
+    PackedBoard position;
+    uint32 ply = 0;
+    bool has_keyframe = false;
+};
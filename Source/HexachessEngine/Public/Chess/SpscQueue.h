@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "Chess/HexTypes.h"
+
+/**
+ * @class SpscQueue
+ * @brief Fixed size lock-free ring between exactly one producing thread and one consuming thread.
+ *
+ * Pushing and popping never allocate or wait: the producer only writes the tail, the consumer only writes the head,
+ * and each publishes its side with a release store the other reads with an acquire load. A full ring refuses the push,
+ * so the producer decides whether to drop or retry. The producer may change threads over time as long as
+ * something else orders the handover, like a lock both producers take.
+ *
+ * @tparam T Copied in and moved out; slots are default constructed up front.
+ * @tparam capacity Number of slots, a power of two.
+ */
+template <typename T, uint32 capacity>
+class SpscQueue {
+    static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    /**
+     * @brief Adds an item at the tail; producer thread only.
+     *
+     * @return false if the ring is full, the item is not added then.
+     */
+    bool try_push(const T& item) {
+        const uint32 tail = tail_index.load(std::memory_order_relaxed);
+        if (tail - cached_head >= capacity) {
+            cached_head = head_index.load(std::memory_order_acquire);
+            if (tail - cached_head >= capacity) {
+                return false;
+            }
+        }
+        slots[tail & mask] = item;
+        tail_index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes the item at the head; consumer thread only.
+     *
+     * @return false if the ring is empty.
+     */
+    bool try_pop(T& out) {
+        const uint32 head = head_index.load(std::memory_order_relaxed);
+        if (head == cached_tail) {
+            cached_tail = tail_index.load(std::memory_order_acquire);
+            if (head == cached_tail) {
+                return false;
+            }
+        }
+        out = std::move(slots[head & mask]);
+        head_index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Items waiting, exact on the consumer thread and a lower bound on the producer's.
+     */
+    inline uint32 size() const {
+        return tail_index.load(std::memory_order_acquire) - head_index.load(std::memory_order_acquire);
+    }
+
+    static constexpr uint32 get_capacity() {
+        return capacity;
+    }
+
+private:
+    // the indices run freely and wrap at 2^32, a multiple of the capacity, so tail - head is always the item count
+    static constexpr uint32 mask = capacity - 1;
+    static constexpr size_t line_size = 64;
+
+    // the consumer's line: its index and its last look at the producer's
+    alignas(line_size) std::atomic<uint32> head_index{0};
+    uint32 cached_tail = 0;
+
+    // the producer's line, so pushing and popping do not bounce one cache line between the cores
+    alignas(line_size) std::atomic<uint32> tail_index{0};
+    uint32 cached_head = 0;
+
+    alignas(line_size) T slots[capacity];
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @class StaticExchange
+ * @brief Static exchange evaluation: the material a capture wins or loses once both sides have kept recapturing on
+ * its cell with their least valuable attacker, for as long as recapturing pays.
+ *
+ * Only the cells and the move tables are read, nothing is played on the board. A piece that took part in the exchange
+ * leaves its cell, so a slider behind it on the same rook or bishop ray joins in next (x-ray attackers).
+ * Pins, checks and promotions are not considered; the king only captures onto a cell the other side no longer attacks.
+ */
+class StaticExchange {
+public:
+    /**
+     * @brief The material the side to move wins by playing a capture, negative when the capture loses material.
+     *
+     * @param in_board The board the capture is played on.
+     * @param move The capture.
+     */
+    int32 evaluate(const PackedBoard& in_board, const Move& move) const {
+        const Square attacker = in_board.cells[move.from];
+        // an en passant capture takes a pawn from beside the empty target cell
+        const Cell::PieceType victim = (move.flags & Move::Flags::en_passant) != 0 ? Cell::PieceType::pawn : in_board.cells[move.to].get_piece_type();
+        bool removed[PackedBoard::cell_count] = {};
+        return resolve(in_board, move.to, move.from, piece_values[victim], PackedBoard::side_of(attacker.get_piece_color()), removed);
+    }
+
+    /**
+     * @brief Whether a capture loses material; captures of a piece worth at least the capturing one are never checked.
+     *
+     * @param in_board The board the capture is played on.
+     * @param move The capture.
+     */
+    bool is_losing(const PackedBoard& in_board, const Move& move) const {
+        const Cell::PieceType victim = (move.flags & Move::Flags::en_passant) != 0 ? Cell::PieceType::pawn : in_board.cells[move.to].get_piece_type();
+        if (piece_values[victim] >= piece_values[in_board.cells[move.from].get_piece_type()]) {
+            return false;
+        }
+        return evaluate(in_board, move) < 0;
+    }
+
+    /**
+     * @brief The material a side wins by starting an exchange on a cell of the other side with its least valuable attacker.
+     *
+     * @param in_board The board to use.
+     * @param index The dense index of the cell, which holds a piece of the other side.
+     * @param by_side The side that captures first, 0 for white and 1 for black.
+     * @return The material won, 0 when the side cannot capture there and negative when every capture there loses material.
+     */
+    int32 evaluate_cell(const PackedBoard& in_board, const int32 index, const int32 by_side) const {
+        bool removed[PackedBoard::cell_count] = {};
+        const int32 attacker = find_least_valuable_attacker(in_board, index, by_side, removed);
+        if (attacker < 0 || !can_capture(in_board, index, attacker, by_side, removed)) {
+            return 0;
+        }
+        return resolve(in_board, index, attacker, piece_values[in_board.cells[index].get_piece_type()], by_side, removed);
+    }
+
+private:
+    // every piece on the board taking part, and the entry the first capture starts
+    static constexpr int32 max_exchange_length = 40;
+
+    /**
+     * @brief The swap list: each entry is what the side making that capture has won if nothing is taken back, then
+     * from the last capture to the first each side keeps the better of stopping and recapturing.
+     */
+    int32 resolve(const PackedBoard& in_board, const int32 target, const int32 first_attacker, const int32 victim_value, const int32 first_side, bool* removed) const {
+        int32 gain[max_exchange_length];
+        int32 depth = 0;
+        gain[0] = victim_value;
+        int32 on_target_value = piece_values[in_board.cells[first_attacker].get_piece_type()];
+        removed[first_attacker] = true;
+        int32 side = 1 - first_side;
+        while (depth + 1 < max_exchange_length) {
+            const int32 attacker = find_least_valuable_attacker(in_board, target, side, removed);
+            if (attacker < 0 || !can_capture(in_board, target, attacker, side, removed)) {
+                break;
+            }
+            depth++;
+            gain[depth] = on_target_value - gain[depth - 1];
+            // neither stopping nor going on can turn the result around any more
+            if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+                break;
+            }
+            on_target_value = piece_values[in_board.cells[attacker].get_piece_type()];
+            removed[attacker] = true;
+            side = 1 - side;
+        }
+        while (depth > 0) {
+            gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+            depth--;
+        }
+        return gain[0];
+    }
+
+    // only a king has to check the recapture, it may not step onto a cell the other side still attacks
+    bool can_capture(const PackedBoard& in_board, const int32 target, const int32 attacker, const int32 side, bool* removed) const {
+        if (in_board.cells[attacker].get_piece_type() != Cell::PieceType::king) {
+            return true;
+        }
+        removed[attacker] = true;
+        const bool is_defended = find_least_valuable_attacker(in_board, target, 1 - side, removed) >= 0;
+        removed[attacker] = false;
+        return !is_defended;
+    }
+
+    /**
+     * @brief The cell of the side's cheapest piece attacking the target, looking through the removed cells; -1 if there is none.
+     */
+    int32 find_least_valuable_attacker(const PackedBoard& in_board, const int32 target, const int32 side, const bool* removed) const {
+        const HexMoveTables& tables = Board::move_tables();
+        const Cell::PieceColor color = side == 0 ? Cell::PieceColor::white : Cell::PieceColor::black;
+        int32 best = -1;
+        int32 best_value = 0;
+        const auto consider = [&](const int32 from) {
+            const int32 value = piece_values[in_board.cells[from].get_piece_type()];
+            if (best < 0 || value < best_value) {
+                best = from;
+                best_value = value;
+            }
+        };
+
+        const Square pawn = PackedBoard::encode(Cell::PieceType::pawn, color);
+        for (const int8 from : tables.pawn_attackers[side][target]) {
+            if (from != HexMoveTables::sentinel && !removed[from] && in_board.cells[from] == pawn) {
+                // nothing is cheaper than a pawn
+                return from;
+            }
+        }
+        const Square knight = PackedBoard::encode(Cell::PieceType::knight, color);
+        for (const int8* from = tables.knight_targets[target]; *from != HexMoveTables::sentinel; from++) {
+            if (!removed[*from] && in_board.cells[*from] == knight) {
+                consider(*from);
+            }
+        }
+        const Square king = PackedBoard::encode(Cell::PieceType::king, color);
+        for (const int8* from = tables.king_targets[target]; *from != HexMoveTables::sentinel; from++) {
+            if (!removed[*from] && in_board.cells[*from] == king) {
+                consider(*from);
+            }
+        }
+        const Square bishop = PackedBoard::encode(Cell::PieceType::bishop, color);
+        const Square rook = PackedBoard::encode(Cell::PieceType::rook, color);
+        const Square queen = PackedBoard::encode(Cell::PieceType::queen, color);
+        for (int32 direction = 0; direction < HexMoveTables::direction_count; direction++) {
+            const Square slider = direction < HexMoveTables::first_rook_direction ? bishop : rook;
+            for (const int8* from = tables.rays[target][direction]; *from != HexMoveTables::sentinel; from++) {
+                const Square square = in_board.cells[*from];
+                if (removed[*from] || !square.has_piece()) {
+                    continue;
+                }
+                if (square == slider || square == queen) {
+                    consider(*from);
+                }
+                break;
+            }
+        }
+        return best;
+    }
+
+    static constexpr PieceValueTable piece_values = Board::piece_values;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "Chess/ChessEngine.h"
+
+/**
+ * @brief What a stored score says about the true value of the position.
+ */
+enum class TTBound : uint8 {
+    none,
+    exact,
+    lower,
+    upper
+};
+
+/**
+ * @brief The search result stored for one position.
+ */
+struct TTEntry {
+    int32 score = 0;
+    int32 depth = -1;
+    TTBound bound = TTBound::none;
+    Move best_move = Move(0, 0);
+
+    inline bool has_best_move() const {
+        return best_move.from != best_move.to;
+    }
+};
+
+/**
+ * @class TranspositionTable
+ * @brief Fixed-size, power-of-two hash table of search results keyed by Zobrist hash.
+ *
+ * Each slot is two 64-bit words: the packed entry and the hash xor-ed with it. A reader that sees a
+ * half-written slot gets a mismatching check word and treats it as a miss, so the table needs no locks.
+ */
+class TranspositionTable {
+public:
+    explicit TranspositionTable(int32 size_mb = 16) {
+        resize(size_mb);
+    }
+
+    /**
+     * @brief Reallocates the table to the largest power-of-two slot count that fits in the budget, and clears it.
+     *
+     * @param size_mb The memory budget in megabytes.
+     */
+    void resize(int32 size_mb) {
+        const uint64 budget = static_cast<uint64>(size_mb < 1 ? 1 : size_mb) * 1024 * 1024;
+        uint64 count = 1;
+        while (count * 2 * sizeof(Slot) <= budget) {
+            count *= 2;
+        }
+        slots.reset(new Slot[count]);
+        slot_count = count;
+        clear();
+    }
+
+    void clear() {
+        for (uint64 i = 0; i < slot_count; i++) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    inline uint64 size() const {
+        return slot_count;
+    }
+
+    /**
+     * @brief Looks a position up.
+     *
+     * @param hash The Zobrist hash of the position.
+     * @param out The entry to fill on a hit.
+     * @return true if the table holds an entry for the position.
+     */
+    bool probe(const uint64 hash, TTEntry& out) const {
+        const Slot& slot = slots[hash & (slot_count - 1)];
+        const uint64 data = slot.data.load(std::memory_order_relaxed);
+        const uint64 check = slot.check.load(std::memory_order_relaxed);
+        if (data == 0 || (check ^ data) != hash) {
+            return false;
+        }
+        out.score = static_cast<int32>(static_cast<uint32>(data));
+        out.best_move = Move(static_cast<int32>((data >> 32) & 0xFF), static_cast<int32>((data >> 40) & 0xFF));
+        out.depth = static_cast<int32>((data >> 48) & 0xFF);
+        out.bound = static_cast<TTBound>((data >> 56) & 0x3);
+        return true;
+    }
+
+    /**
+     * @brief Stores a search result, keeping a deeper result for the same position.
+     *
+     * @param hash The Zobrist hash of the position.
+     * @param depth The remaining depth the score was searched to.
+     * @param bound What the score says about the true value.
+     * @param score The score.
+     * @param best_move The best move found, or a move with from == to if there is none.
+     */
+    void store(const uint64 hash, const int32 depth, const TTBound bound, const int32 score, const Move best_move) {
+        Slot& slot = slots[hash & (slot_count - 1)];
+        const uint64 old_data = slot.data.load(std::memory_order_relaxed);
+        const uint64 old_check = slot.check.load(std::memory_order_relaxed);
+        if (old_data != 0 && (old_check ^ old_data) == hash && static_cast<int32>((old_data >> 48) & 0xFF) > depth) {
+            return;
+        }
+        const uint64 data = static_cast<uint64>(static_cast<uint32>(score))
+                            | static_cast<uint64>(best_move.from) << 32
+                            | static_cast<uint64>(best_move.to) << 40
+                            | static_cast<uint64>(depth < 0 ? 0 : depth > 0xFF ? 0xFF : depth) << 48
+                            | static_cast<uint64>(bound) << 56;
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.check.store(hash ^ data, std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64> check{0};
+        std::atomic<uint64> data{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    uint64 slot_count = 0;
+};
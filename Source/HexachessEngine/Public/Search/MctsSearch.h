@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include "Chess/ChessEngine.h"
+#include "Search/MoveResult.h"
+
+using namespace std;
+
+class Evaluator;
+class FQueuedThreadPool;
+struct FMctsNode;
+struct FMctsWorker;
+
+// the knobs of the tree search, copied in with every request
+struct FMctsSettings
+{
+    // memory budget of the node pool; once it is full the tree stops growing and the remaining iterations only refine the visit counts
+    int32 TreeSizeMB = 64;
+    // the UCT exploration constant, higher tries unvisited moves more often
+    float Exploration = 1.4f;
+    // visits a thread adds to every node on its path while its playout runs, so the other threads pick different paths
+    int32 VirtualLoss = 3;
+    // random plies played out from a new leaf before the evaluation scores where the playout ended
+    int32 PlayoutDepth = 16;
+    // the evaluation lead, in evaluation units, that counts as ten to one odds when a playout is scored
+    int32 PlayoutScoreScale = 400;
+    // iterations a thread runs before it backpropagates them, with their playout ends scored in one evaluation call
+    // worth raising to 32 and more with an evaluation that is cheaper per position in batches, such as the network
+    int32 LeafBatchSize = 1;
+};
+
+// one move request: the position, who to search for and how much
+struct FMctsRequest
+{
+    // the hash includes the side to move, it must agree with IsWhiteAI
+    PackedBoard Position;
+    bool IsWhiteAI = true;
+    // iterations summed over all threads, 0 for no limit; the search stops at whichever of the iteration and time budgets runs out first
+    int32 Iterations = 0;
+    int32 TimeBudgetMs = 0;
+    int32 ThreadCount = 1;
+    // runs the other threads on this pool instead of the task graph; it needs ThreadCount - 1 threads free to run them all at once
+    FQueuedThreadPool* ThreadPool = nullptr;
+    // scores the playouts, without it the board's own evaluation is used
+    TSharedPtr<const Evaluator, ESPMode::ThreadSafe> Evaluation;
+    int32 Seed = 1;
+    FMctsSettings Settings;
+};
+
+struct FMctsResult
+{
+    // false when the search was cancelled, the move means nothing then
+    bool IsComplete = false;
+    // the most visited root move; its score is its average result for the AI in thousandths, 1000 a sure win
+    MoveResult Move;
+    int64 Iterations = 0;
+    int32 TreeNodes = 0;
+};
+
+// Monte Carlo tree search over packed boards, on one or more threads; no UObject involved
+// - selection: from the root, follow the child with the best upper confidence bound (UCT) until a leaf
+// - expansion: the first thread to reach a leaf that was visited before gives it one child per legal move, from the node pool
+// - playout: random legal moves from the leaf, then the evaluation turned into a result between 0 and 1, for a batch of leaves at once
+// - backpropagation: every node on the path adds the result for the side that moved into it
+// the threads share one tree; virtual loss keeps them apart without locks
+class HEXACHESSENGINE_API FMctsSearch
+{
+public:
+
+    FMctsSearch() = default;
+    ~FMctsSearch();
+
+    FMctsSearch(const FMctsSearch&) = delete;
+    FMctsSearch& operator=(const FMctsSearch&) = delete;
+
+    // grows a new tree from the request's position on the calling thread plus ThreadCount - 1 task graph or pool workers
+    // one request runs at a time, a second caller waits for the first; raising IsCancelled from any thread makes the search stop
+    FMctsResult Run(const FMctsRequest& Request, const std::atomic<bool>& IsCancelled);
+
+private:
+
+    // up to LeafBatchSize iterations, evaluated and backpropagated together; false once the search should stop
+    bool RunBatch(FMctsWorker& Worker);
+
+    // selection, expansion and playout of one iteration of the worker's batch; false once the search should stop
+    bool StartIteration(FMctsWorker& Worker);
+
+    // the child of Parent with the best upper confidence bound, from the point of view of the side that moves into it
+    int32 SelectChild(const FMctsNode& Parent) const;
+
+    // gives the node a child for every legal move of the worker's board; false when another thread is doing it or the pool is full
+    bool Expand(FMctsWorker& Worker, int32 NodeIndex);
+
+    // plays random moves on the worker's board; true with white's result when the game ended, false when the board needs the evaluation
+    bool Playout(FMctsWorker& Worker, float& OutWhiteResult);
+
+    // an evaluation turned into white's result, between 0 and 1
+    float ScoreEvaluation(int32 Score) const;
+
+    // the result for white of a position whose side to move has no legal moves
+    float ScoreEnding(PackedBoard& in_board) const;
+
+    // held by the running search for its whole length, everything below is only touched under it
+    FCriticalSection SearchLock;
+
+    FMctsSettings Settings;
+
+    // the tree, node 0 is the root; allocation only ever moves NextNode forward, the tree is dropped as a whole
+    FMctsNode* Nodes = nullptr;
+    int32 NodeCapacity = 0;
+    std::atomic<int32> NextNode{0};
+
+    // rules and evaluation for the packed positions
+    Board* RulesBoard = nullptr;
+    const Evaluator* RunningEvaluator = nullptr;
+    const std::atomic<bool>* RunningCancel = nullptr;
+    PackedBoard RootPosition;
+
+    // shared budget: iterations are claimed one at a time, the clock is read every few of them
+    std::atomic<int64> IterationsStarted{0};
+    int64 IterationLimit = 0;
+    double SearchDeadline = 0.0;
+    std::atomic<bool> IsSearchStopped{false};
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include "Chess/ChessEngine.h"
+#include "Search/MoveResult.h"
+
+using namespace std;
+
+class TranspositionTable;
+class Evaluator;
+class FQueuedThreadPool;
+class NnueNetwork;
+class FTablebase;
+struct FSearchWorker;
+struct FSplitPoint;
+
+// the knobs of the search, copied in with every request
+struct FMinimaxSettings
+{
+    // memory budget of the transposition table, rounded down to a power-of-two number of entries
+    int32 TranspositionTableSizeMB = 16;
+    // memory budget of each search thread's evaluation cache, small enough to stay in the core's L2
+    int32 EvaluationCacheSizeKB = 256;
+    // principal variation search (null windows after the first move) with aspiration windows at the root, plain alpha-beta otherwise
+    bool UsePrincipalVariation = true;
+    // half width of the root aspiration window, in evaluation units (a pawn is 100)
+    int32 AspirationWindow = 25;
+    // resolve captures at the leaves instead of evaluating them as they stand
+    bool UseQuiescence = true;
+    // how many captures deep the quiescence search may go
+    int32 QuiescenceDepth = 8;
+    // safety margin on top of the captured piece's value before a capture is skipped by delta pruning
+    int32 QuiescenceDeltaMargin = 200;
+    // skip the quiescence captures the static exchange evaluation says lose material
+    bool UseExchangePruning = true;
+    // young brothers wait only shares the siblings of nodes with at least this much depth left
+    int32 SplitMinDepth = 3;
+    // null-move pruning: a position still above beta after passing the move is cut off without searching its moves
+    bool UseNullMove = true;
+    // how much shallower the null move's reply is searched
+    int32 NullMoveReduction = 2;
+    // late move reductions: quiet moves late in the ordering are searched shallower first, and again at full depth if they beat alpha
+    bool UseLateMoveReductions = true;
+    // nodes with less depth left, and the first moves of every node, are never reduced
+    int32 LateMoveMinDepth = 3;
+    int32 LateMoveMinIndex = 3;
+    // multi-PV: how many of the root's best moves get a line of their own; every line after the first is searched again at the final depth
+    int32 MultiPV = 1;
+};
+
+// one move request: the position, who to search for and how long
+struct FMinimaxRequest
+{
+    // the hash includes the side to move, it must agree with IsWhiteAI
+    PackedBoard Position;
+    // the hashes of the game's positions before Position since its last capture or pawn move, oldest first (Board::get_reversible_hashes)
+    // a line back to one of them is a draw by repetition, and their count is where the fifty-move rule starts counting
+    TArray<uint64> History;
+    // plies without a capture or pawn move after which a position is a draw, 0 to ignore the rule
+    int32 FiftyMovePlies = 100;
+    bool IsWhiteAI = true;
+    int32 MaxDepth = 1;
+    int32 TimeBudgetMs = 0;
+    // nodes the main worker may visit, 0 for no limit; the depth it runs out in is dropped like one the clock stops
+    // with a node budget a TimeBudgetMs of 0 means no clock at all, and on one thread the same request then always plays the same move
+    int64 NodeBudget = 0;
+    int32 ThreadCount = 1;
+    // young brothers wait split points instead of lazy SMP
+    bool UseSplitPoints = false;
+    // runs the workers at background priority, which mobile schedulers keep on the efficiency cores where they can
+    bool UseBackgroundThreads = false;
+    // runs the helpers on this pool instead of the task graph, UseBackgroundThreads is up to the pool's priority then;
+    // it needs ThreadCount - 1 threads free to run them all at once, a helper still queued when the search ends never runs
+    FQueuedThreadPool* ThreadPool = nullptr;
+    // scores the leaves, without it the board's own evaluation is used
+    TSharedPtr<const Evaluator, ESPMode::ThreadSafe> Evaluation;
+    // positions with few enough pieces are looked up instead of searched; the root move comes straight from the distance to mate
+    TSharedPtr<const FTablebase, ESPMode::ThreadSafe> Tablebase;
+    // pondering on the opponent's time: while it is set the clock does not run, TimeBudgetMs starts counting once it is cleared
+    const std::atomic<bool>* IsPondering = nullptr;
+    FMinimaxSettings Settings;
+};
+
+// what all search threads did up to one finished depth
+struct FMinimaxDepthReport
+{
+    int32 Depth = 0;
+    // the score of the best move at that depth, for the side the AI plays
+    int32 Score = 0;
+    int64 Nodes = 0;
+    // the part of Nodes searched by the capture-only search at the leaves
+    int64 QuiescenceNodes = 0;
+    // moves good enough to stop their node's move loop
+    int64 Cutoffs = 0;
+    double ElapsedSeconds = 0.0;
+    int64 TableProbes = 0;
+    int64 TableHits = 0;
+    int64 EvaluationProbes = 0;
+    int64 EvaluationHits = 0;
+    // buffers the search allocated for this request: its table, workers, arenas and caches when they were missing or too small
+    int64 Allocations = 0;
+};
+
+// a line the search expects to be played, the root move first, as far as the transposition table follows it
+struct FMinimaxLine
+{
+    // the root move's score for the side the AI plays
+    int32 Score = 0;
+    TArray<MoveResult> Moves;
+};
+
+struct FMinimaxResult
+{
+    // false when the search was cancelled, the move means nothing then
+    bool IsComplete = false;
+    MoveResult Move;
+    // the reply the search expects to Move, from the transposition table; both keys are 0 when it has none
+    // a pondering search starts from the position after both
+    MoveResult PonderMove;
+    // the principal variation first, then with MultiPV the best lines starting with other moves, best first
+    TArray<FMinimaxLine> Lines;
+    int64 EvaluationProbes = 0;
+    int64 EvaluationHits = 0;
+};
+
+// iterative deepening negamax over packed boards, on one or more threads; no UObject involved
+// the transposition table, the move ordering history and the evaluation caches are kept from one request to the next
+class HEXACHESSENGINE_API FMinimaxSearch
+{
+public:
+
+    FMinimaxSearch() = default;
+    ~FMinimaxSearch();
+
+    FMinimaxSearch(const FMinimaxSearch&) = delete;
+    FMinimaxSearch& operator=(const FMinimaxSearch&) = delete;
+
+    // searches depth 1, 2, ... up to MaxDepth until TimeBudgetMs runs out, on the calling thread plus ThreadCount - 1 task graph workers
+    // one request runs at a time, a second caller waits for the first; raising IsCancelled from any thread makes the search unwind
+    // OnDepth is called on a search thread after every depth the main worker finishes
+    FMinimaxResult Run(const FMinimaxRequest& Request, const std::atomic<bool>& IsCancelled, const TFunction<void(const FMinimaxDepthReport&)>& OnDepth = nullptr);
+
+    // forgets the transposition table, the move ordering history and the evaluation caches, so the next search starts cold
+    void Clear();
+
+    // the line the transposition table holds for a position, its best move first, as far as the table follows it; false when the table has no move for it
+    // safe while a search runs: the table is lock free and never reallocated once made
+    bool ProbeLine(Board* ActiveBoard, const PackedBoard& Position, int32 MaxLength, TArray<MoveResult>& OutLine) const;
+
+    // negamax alpha-beta search
+    // - generate all legal moves of the side to move into one list and order it
+    // - for each move, search the reply with the window negated and flipped
+    // - evaluate the board for all bottom nodes (it's recursion exit point), from the side to move's point of view
+    // - a child's score negated is the node's score for that move; keep the best
+    // - stop as soon as a move scores at least beta, the opponent will not allow this line
+    // - the root call gives you the best move; scores are relative to IsWhitePlayer
+    MoveResult NegaMax(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, int32 Alpha, int32 Beta, int32 Ply = 0);
+
+    // capture-only search below the horizon, so leaves are never scored in the middle of an exchange
+    int32 Quiesce(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, int32 Alpha, int32 Beta, int32 Ply);
+
+    // one iterative deepening step; in principal variation mode it is wrapped in an aspiration window around PreviousScore
+    MoveResult SearchRoot(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, int32 PreviousScore);
+
+private:
+
+    // the request's evaluator if it has one, Board::evaluate otherwise; white's point of view
+    // goes through the worker's evaluation cache first, a network is run on the worker's accumulators
+    int32 Evaluate(Board* ActiveBoard, FSearchWorker& Worker) const;
+
+    // tell the worker's network accumulators about a move made or taken back on its board; nothing without a network
+    void PushAccumulator(FSearchWorker& Worker, const UndoRecord& Undo) const;
+    void PopAccumulator(FSearchWorker& Worker) const;
+
+    // an empty move list from the worker's arena, valid until the caller's SearchArenaScope closes
+    static MoveList& AllocateMoveList(FSearchWorker& Worker);
+
+    // the move with the fastest win, else a draw, else the slowest loss, if every reply is in the distance to mate tables
+    bool FindTablebaseMove(Board* ActiveBoard, FSearchWorker& Worker, bool IsWhitePlayer, MoveResult& OutMove) const;
+
+    // makes the move, searches the reply (null window first for younger siblings in principal variation mode) and takes it back
+    // a reduced move is first searched Reduction plies shallower with a null window, unless it gives check
+    int32 SearchChild(Board* ActiveBoard, FSearchWorker& Worker, const Move& move, bool IsEldest, int32 Reduction, int32 Depth, bool IsWhitePlayer, int32 Alpha, int32 Beta, int32 Ply);
+
+    // how many plies the move at MoveIndex of a node's ordered moves is reduced by: more for later moves, less for moves with a good history
+    int32 GetLateMoveReduction(const FSearchWorker& Worker, const Move& move, int32 MoveIndex, int32 Depth, int32 Ply, bool IsInCheck) const;
+
+    // passes the move and searches the opponent's reply with a null window at beta; true when the side to move stays at or above beta
+    bool IsNullMoveCutoff(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, int32 Beta, int32 Ply);
+
+    // young brothers wait
+    // - a node splits once its eldest child is searched, it publishes its remaining moves on the worker's deque
+    // - idle workers steal the oldest split point of another worker and claim its moves one by one
+    // - a beta cutoff cancels the split point, and with it every subtree searched below it
+    // - the owner searches moves too, then waits for its helpers before it returns the node's result
+    bool CanSplit(int32 Depth, int32 MoveCount) const;
+    void SearchSplitPoint(Board* ActiveBoard, FSearchWorker& Worker, const MoveList& Moves, int32 Depth, bool IsWhitePlayer, bool IsInCheck, int32& Alpha, int32 Beta, int32 Ply, MoveResult& Result, Move& BestMove);
+    void SearchSplitMoves(Board* ActiveBoard, FSearchWorker& Worker, FSplitPoint& SplitPoint);
+    void HelpSplitPoints(Board* ActiveBoard, FSearchWorker& Worker);
+    FSplitPoint* StealSplitPoint(FSearchWorker& Thief);
+
+    // true once the worker's current subtree no longer matters: the search stopped or a split point above it was cut off
+    bool IsUnwinding(const FSearchWorker& Worker) const;
+
+    // counts the node and checks the clock and the node budget; true once this worker should unwind
+    bool ShouldStopSearch(FSearchWorker& Worker);
+
+    // true once the main worker has used up the request's node budget
+    bool IsOverNodeBudget(const FSearchWorker& Worker) const;
+
+    // false while pondering; the first check after the ponder ends starts the time budget
+    bool IsPastDeadline();
+
+    // multi-PV: searches the root again at Depth with the moves already in Lines left out, until Lines has MultiPV entries
+    // false when the search unwound before every line was found
+    bool SearchOtherLines(Board* ActiveBoard, FSearchWorker& Worker, int32 Depth, bool IsWhitePlayer, TArray<MoveResult>& Lines);
+
+    // FirstMove, then the transposition table's move of each position after it as long as it is legal there, at most MaxLength moves
+    void ExtractLine(Board* ActiveBoard, PackedBoard Position, const MoveResult& FirstMove, int32 MaxLength, TArray<MoveResult>& OutLine) const;
+
+    // the transposition table's move for the position after BestMove, if it is a legal reply; scored for the side that replies
+    MoveResult FindPonderMove(Board* ActiveBoard, PackedBoard Position, const MoveResult& BestMove) const;
+
+    // held by the running search for its whole length, everything below is only touched under it
+    FCriticalSection SearchLock;
+
+    FMinimaxSettings Settings;
+
+    // the request the search threads are working on, its cancel token is checked with the clock
+    const std::atomic<bool>* RunningCancel = nullptr;
+    const Evaluator* RunningEvaluator = nullptr;
+    // the evaluator's network, if it has one; the workers' accumulators follow their boards then
+    const NnueNetwork* RunningNetwork = nullptr;
+    const FTablebase* RunningTablebase = nullptr;
+    const std::atomic<bool>* RunningPonder = nullptr;
+
+    // kept between moves, positions from the previous search are often reached again; shared by all search threads
+    TranspositionTable* Table = nullptr;
+
+    // rules and evaluation for the packed positions
+    Board* RulesBoard = nullptr;
+
+    // per-thread search state (board copy, killers, history, evaluation cache), also kept between moves and aged at the start of each search
+    TArray<FSearchWorker*> Workers;
+
+    // search clock, shared by the search threads
+    std::atomic<double> SearchDeadline{0.0};
+    double TimeBudgetSeconds = 0.0;
+    int64 NodeBudget = 0;
+    std::atomic<bool> CanAbortSearch{false};
+    std::atomic<bool> IsSearchAborted{false};
+    bool UseSplitPoints = false;
+    int32 FiftyMovePlies = 0;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// one book move: the position's Zobrist hash (side to move included) and a move from it, as position keys
+// a file is a header followed by the entries sorted by hash, so one position's moves are next to each other
+// written and read little-endian, as every platform the game ships on is
+struct FOpeningBookEntry
+{
+    uint64 Hash = 0;
+    uint16 FromKey = 0;
+    uint16 ToKey = 0;
+    // how often the move should be picked relative to the position's other moves
+    uint16 Weight = 0;
+    uint16 Reserved = 0;
+};
+static_assert(sizeof(FOpeningBookEntry) == 16, "book entries are read straight from the file");
+
+struct FOpeningBookHeader
+{
+    static constexpr uint32 FileMagic = 0x4B425848; // "HXBK"
+    static constexpr uint32 FileVersion = 1;
+
+    uint32 Magic = FileMagic;
+    uint32 Version = FileVersion;
+    uint64 EntryCount = 0;
+};
+static_assert(sizeof(FOpeningBookHeader) == 16, "the entries after the header stay 8-byte aligned");
+
+// a read-only opening book, memory-mapped where the platform allows it and read into memory otherwise
+// lookups are a binary search over the mapped entries, nothing is allocated after Open
+class HEXACHESSENGINE_API FOpeningBook
+{
+public:
+
+    FOpeningBook() = default;
+    ~FOpeningBook();
+
+    FOpeningBook(const FOpeningBook&) = delete;
+    FOpeningBook& operator=(const FOpeningBook&) = delete;
+
+    // maps the book at Path; false when it is missing or not a book of this version, the book is then empty
+    bool Open(const FString& Path);
+    void Close();
+
+    bool IsOpen() const { return Entries != nullptr; }
+    int32 Num() const { return static_cast<int32>(EntryCount); }
+
+    // every book move of the position, empty when the book does not know it
+    TConstArrayView<FOpeningBookEntry> Find(uint64 Hash) const;
+
+    // reads one byte of every page of the entries, so the first lookups of a game do not wait on the disk
+    void Prefetch() const;
+
+    // sorts the entries by hash and writes them as a book file
+    static bool Write(const FString& Path, TArray<FOpeningBookEntry> Entries);
+
+private:
+
+    IMappedFileHandle* MappedFile = nullptr;
+    IMappedFileRegion* MappedRegion = nullptr;
+    // the whole file, when it could not be mapped
+    TArray<uint8> LoadedFile;
+
+    const FOpeningBookEntry* Entries = nullptr;
+    int64 EntryCount = 0;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+
+#include "CoreMinimal.h"
+
+#include "Chess/ChessEngine.h"
+#include "Chess/PositionCodec.h"
+#include "Search/MinimaxSearch.h"
+
+using namespace std;
+
+struct FSelfPlayGame;
+
+enum class EPuzzleKind : uint8
+{
+    // the side to move mates in Value moves, and only one first move does it that fast
+    Mate,
+    // the side to move wins material with a capture, Value is the search's score for it and no other move comes close
+    WinningCapture
+};
+
+// one puzzle of a pack file; a file is a header followed by the entries, written and read little-endian
+struct FPuzzleEntry
+{
+    // a mate in 4, the longest the generator looks for
+    static constexpr int32 MaxSolutionPlies = 7;
+
+    EncodedPosition Position;
+    uint8 Kind = 0;
+    // the side to move plays the even plies of the solution, the replies are the ones that hold out longest
+    uint8 SolutionPlies = 0;
+    // from and to position keys of every ply of the solution
+    uint16 Solution[MaxSolutionPlies][2] = {};
+    int16 Value = 0;
+    uint16 Reserved = 0;
+};
+static_assert(sizeof(FPuzzleEntry) == 80, "puzzle entries are read straight from the file");
+
+struct FPuzzlePackHeader
+{
+    static constexpr uint32 FileMagic = 0x5A505848; // "HXPZ"
+    static constexpr uint32 FileVersion = 1;
+
+    uint32 Magic = FileMagic;
+    uint32 Version = FileVersion;
+    uint64 EntryCount = 0;
+};
+static_assert(sizeof(FPuzzlePackHeader) == 16, "the entries after the header stay 8-byte aligned");
+
+struct FPuzzleConfig
+{
+    // positions of the first plies of a game come from the random opening, they are skipped
+    int32 MinPly = 8;
+    // positions checked at once, each on its own task graph thread; 0 means one per worker
+    int32 Concurrency = 0;
+    // longest mate looked for, in moves of the side to move; at most 4
+    int32 MaxMateMoves = 3;
+    // nodes the exhaustive mate search may visit per position and length before the position is given up
+    int64 MateNodeBudget = 2000000;
+    // a position is only searched for mates longer than one move when the screening search scores it at least this much
+    int32 MateScreenScore = 500;
+    bool FindCaptures = true;
+    // the screening search: two lines (multi-PV) on one thread, with a node budget so the pack does not depend on the machine
+    int32 ScreenDepth = 4;
+    int64 ScreenNodeBudget = 200000;
+    // a capture puzzle's line must score at least this much and beat the second best move by the margin
+    int32 CaptureMinScore = 300;
+    int32 CaptureMargin = 250;
+};
+
+// finds mate and winning capture puzzles in played games and proves them
+// - every position of the games is screened with a short two-line search
+// - mate in 1 is checked everywhere, longer mates only where the screen found a decisive advantage; a mate is proven
+//   by an exhaustive search of every defence, and kept when it is the shortest and only one first move achieves it
+// - a capture is kept when the screen's best line starts with it and it wins clearly more than any other move
+class HEXACHESSENGINE_API FPuzzleGenerator
+{
+public:
+
+    // the distinct positions the games went through from MinPly on, in game order; the games start from StartPosition
+    static TArray<PackedBoard> CollectPositions(const TArray<FSelfPlayGame>& Games, const PackedBoard& StartPosition, int32 MinPly);
+
+    // checks the positions on several threads; the puzzles come back in the order of their positions, whatever the thread count
+    // OnProgress is called from the checking threads, one call at a time, with the positions checked and the puzzles found so far
+    // raising IsCancelled from any thread stops within a position, the puzzles found until then are returned
+    TArray<FPuzzleEntry> Generate(const TArray<PackedBoard>& Positions, const FPuzzleConfig& Config, const std::atomic<bool>& IsCancelled,
+        const TFunction<void(int32, int32)>& OnProgress = nullptr) const;
+
+    static bool WritePack(const FString& Path, const TArray<FPuzzleEntry>& Entries);
+
+    // false when the file is missing or not a pack of this version
+    static bool ReadPack(const FString& Path, TArray<FPuzzleEntry>& OutEntries);
+
+private:
+
+    bool FindMate(Board& Rules, PackedBoard& Position, const FPuzzleConfig& Config, int32 MaxMoves, const std::atomic<bool>& IsCancelled, FPuzzleEntry& OutEntry) const;
+
+    bool FindCapture(const PackedBoard& Position, const FPuzzleConfig& Config, const FMinimaxResult& Screen, FPuzzleEntry& OutEntry) const;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+struct FMinimaxDepthReport;
+
+// the minimax AI's counters, `stat HexachessAI` in game and the stats tracks in Insights
+// they are set from the main search thread each time a depth finishes, for the search as a whole so far
+DECLARE_STATS_GROUP(TEXT("HexachessAI"), STATGROUP_HexachessAI, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Depth"), STAT_HexachessAI_Depth, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Nodes"), STAT_HexachessAI_Nodes, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Nodes per second"), STAT_HexachessAI_NodesPerSecond, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Quiescence nodes"), STAT_HexachessAI_QuiescenceNodes, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Beta cutoffs"), STAT_HexachessAI_Cutoffs, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Table probes"), STAT_HexachessAI_TableProbes, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Table hits"), STAT_HexachessAI_TableHits, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Evaluation cache hits"), STAT_HexachessAI_EvaluationHits, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Allocations"), STAT_HexachessAI_Allocations, STATGROUP_HexachessAI, HEXACHESSENGINE_API);
+
+// sets the group's counters from a depth report
+HEXACHESSENGINE_API void SetSearchStats(const FMinimaxDepthReport& Report);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FQueuedThreadPool;
+
+// runs Body for every index from 0 to Count - 1, index 0 on the calling thread and the others at once on other threads
+// with a pool the others run on its threads and never on the task graph's; without one they are a ParallelFor at
+// background priority or not; an index the pool has not started when the calling thread is done is taken back and run
+// on the calling thread, so Body must return at once for a helper that starts after the main worker finished
+HEXACHESSENGINE_API void RunSearchWorkers(int32 Count, FQueuedThreadPool* ThreadPool, bool UseBackgroundThreads, TFunctionRef<void(int32)> Body);
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+
+#include "CoreMinimal.h"
+
+#include "Chess/ChessEngine.h"
+#include "Search/MinimaxSearch.h"
+
+using namespace std;
+
+class Evaluator;
+class FTablebase;
+
+// how one side of a self-play match searches; the same limits MakeAIMove uses for a difficulty
+struct FSelfPlayPlayer
+{
+    FString Name;
+    int32 MaxDepth = 4;
+    int32 TimeBudgetMs = 1000;
+    // 0 for none; with a node budget and one thread per game the player's moves no longer depend on the machine
+    int64 NodeBudget = 0;
+    // young brothers wait split points instead of lazy SMP, only matters with more than one thread per game
+    bool UseSplitPoints = false;
+    // scores the leaves, without it the board's own evaluation is used
+    TSharedPtr<const Evaluator, ESPMode::ThreadSafe> Evaluation;
+    // endings with few pieces are played from the tables instead of searched
+    TSharedPtr<const FTablebase, ESPMode::ThreadSafe> Tablebase;
+    FMinimaxSettings Settings;
+};
+
+struct FSelfPlayConfig
+{
+    // the position every game starts from before the opening moves, white to move
+    PackedBoard StartPosition = Board::starting_position();
+    // games are played in pairs on the same opening, A is white in the first game of a pair and black in the second
+    int32 GameCount = 100;
+    // games running at once, each on its own task graph thread; 0 means one per worker
+    int32 Concurrency = 0;
+    // search threads of each game
+    int32 ThreadsPerGame = 1;
+    // random legal moves played from the start position before the engines take over, shared by both games of a pair
+    int32 OpeningPlies = 4;
+    int32 Seed = 1;
+    // a game that reaches this many plies is a draw
+    int32 MaxPlies = 300;
+    // plies without a capture or a pawn move before the game is a draw
+    int32 FiftyMovePlies = 100;
+    // stop early once the sequential probability ratio test accepts either hypothesis; elo0 < elo1, in Elo points of A over B
+    bool UseSprt = false;
+    double SprtElo0 = 0.0;
+    double SprtElo1 = 10.0;
+    double SprtAlpha = 0.05;
+    double SprtBeta = 0.05;
+};
+
+enum class ESelfPlayOutcome : uint8
+{
+    WhiteWins,
+    BlackWins,
+    Draw
+};
+
+enum class ESelfPlayEnding : uint8
+{
+    Checkmate,
+    Stalemate,
+    Repetition,
+    FiftyMoves,
+    MaxPlies,
+    // the runner stopped before the game ended
+    Unfinished
+};
+
+struct HEXACHESSENGINE_API FSelfPlayGame
+{
+    int32 Index = 0;
+    bool IsPlayerAWhite = true;
+    ESelfPlayOutcome Outcome = ESelfPlayOutcome::Draw;
+    ESelfPlayEnding Ending = ESelfPlayEnding::Unfinished;
+    int32 Plies = 0;
+    double Seconds = 0.0;
+    // every move of the game from the start position, as from and to position keys, the opening included
+    TArray<TPair<int32, int32>> Moves;
+
+    // 1 for a win of A, 0.5 for a draw, 0 for a loss
+    double GetScoreOfA() const;
+};
+
+// wins, draws and losses of A against B, and what they say about the difference in strength
+struct HEXACHESSENGINE_API FSelfPlayStats
+{
+    int32 Wins = 0;
+    int32 Draws = 0;
+    int32 Losses = 0;
+
+    void Add(const FSelfPlayGame& Game);
+    int32 GetGameCount() const;
+    // points per game of A, between 0 and 1
+    double GetScore() const;
+    // logistic Elo difference of A over B, infinite when A won or lost every game
+    double GetElo() const;
+    // half width of the 95% confidence interval around GetElo(), from the per-game variance of the score
+    double GetEloMargin() const;
+    // log likelihood ratio of elo1 against elo0, with the trinomial (win/draw/loss) variance
+    double GetSprtLlr(double Elo0, double Elo1) const;
+};
+
+enum class ESprtDecision : uint8
+{
+    Continue,
+    AcceptH0,
+    AcceptH1
+};
+
+// bounds of the sequential probability ratio test for the given error rates
+HEXACHESSENGINE_API ESprtDecision DecideSprt(double Llr, double Alpha, double Beta);
+
+// plays A against B from randomized openings, several games at once, each game with two searches on one thread
+// the searches keep their tables between the moves of a game and start cold at the next one, nothing else is allocated per move
+class HEXACHESSENGINE_API FSelfPlayRunner
+{
+public:
+
+    // plays the match; OnGame is called after every finished game, from the thread that played it, one call at a time
+    // raising IsCancelled from any thread stops the match within a move, unfinished games are not counted
+    FSelfPlayStats Run(const FSelfPlayConfig& Config, const FSelfPlayPlayer& PlayerA, const FSelfPlayPlayer& PlayerB, const std::atomic<bool>& IsCancelled, const TFunction<void(const FSelfPlayGame&, const FSelfPlayStats&)>& OnGame = nullptr);
+
+    // the games of the last Run, in game order; unfinished games keep the Unfinished ending
+    const TArray<FSelfPlayGame>& GetGames() const { return Games; }
+
+    // what the test decided about the last Run, Continue when it was off or did not reach a bound
+    ESprtDecision GetSprtDecision() const { return SprtDecision; }
+
+private:
+
+    // plays random legal moves from the start position, the same ones for both games of a pair
+    // an opening that runs into a side without moves is drawn again with the next seed
+    void PlayOpening(Board& Rules, const FSelfPlayConfig& Config, int32 PairIndex, PackedBoard& OutPosition, TArray<TPair<int32, int32>>& OutMoves) const;
+
+    void PlayGame(Board& Rules, FMinimaxSearch& SearchA, FMinimaxSearch& SearchB, const FSelfPlayConfig& Config, const FSelfPlayPlayer& PlayerA, const FSelfPlayPlayer& PlayerB, const std::atomic<bool>& IsCancelled, FSelfPlayGame& Game);
+
+    TArray<FSelfPlayGame> Games;
+    ESprtDecision SprtDecision = ESprtDecision::Continue;
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include "Chess/ChessEngine.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// the pieces of a tablebase, named like "KQvK": white's pieces, a v, then black's, each side king first and the rest in Q R B N P order
+// a table stores the stronger side as white; positions where black is stronger are looked up with the colors swapped and the board mirrored
+struct HEXACHESSENGINE_API FTablebaseMaterial
+{
+    // 91^4 positions per side to move is as much as the generator can hold
+    static constexpr int32 MaxPieces = 4;
+
+    int32 PieceCount = 0;
+    Cell::PieceType Types[MaxPieces] = {};
+    Cell::PieceColor Colors[MaxPieces] = {};
+
+    // false for names with more than MaxPieces pieces, unknown letters or a side without exactly one king
+    static bool Parse(const FString& Name, FTablebaseMaterial& OutMaterial);
+
+    // the material of a position, with the colors swapped when black is the stronger side; false with more than MaxPieces pieces
+    static bool FromPosition(const PackedBoard& Position, FTablebaseMaterial& OutMaterial, bool& OutIsFlipped);
+
+    // the same material with the stronger side as white and the pieces in table order; OutIsFlipped says whether the colors were swapped
+    FTablebaseMaterial GetCanonical(bool& OutIsFlipped) const;
+
+    // the materials left after a capture of each piece other than a king, not yet canonical
+    TArray<FTablebaseMaterial> GetCaptures() const;
+
+    FString GetName() const;
+
+    // packs the pieces into a number that tells materials apart, for lookups without strings
+    uint32 GetKey() const;
+
+    // both sides to move times every cell for every piece, overlapping pieces included
+    int64 GetPositionCount() const;
+
+    // the index of a position of this material; IsFlipped must be what FromPosition said for it
+    int64 GetIndex(const PackedBoard& Position, bool IsFlipped) const;
+
+    // the position at an index, false when two pieces share a cell
+    bool GetPosition(int64 Index, PackedBoard& OutPosition) const;
+};
+
+// what a position is worth for the side to move with perfect play
+enum class ETablebaseWdl : uint8
+{
+    Draw,
+    Win,
+    Loss
+};
+
+struct FTablebaseProbe
+{
+    ETablebaseWdl Wdl = ETablebaseWdl::Draw;
+    // plies until mate with the fastest win and the slowest loss; only set by a distance to mate probe
+    int32 PliesToMate = 0;
+};
+
+// one table entry while generating and in the distance to mate files
+// 0 is a draw and 1 a position that cannot happen; from 2 on the entry is 2 + plies to mate, even plies lose for the side to move, odd plies win
+namespace TablebaseValue
+{
+    constexpr uint16 Draw = 0;
+    constexpr uint16 Invalid = 1;
+    constexpr uint16 Unresolved = 0xFFFF;
+
+    constexpr uint16 FromPliesToMate(const int32 Plies) { return static_cast<uint16>(Plies + 2); }
+    constexpr int32 GetPliesToMate(const uint16 Value) { return Value - 2; }
+    constexpr bool IsDecided(const uint16 Value) { return Value >= 2 && Value != Unresolved; }
+    constexpr bool IsWin(const uint16 Value) { return IsDecided(Value) && (GetPliesToMate(Value) & 1) != 0; }
+    constexpr bool IsLoss(const uint16 Value) { return IsDecided(Value) && (GetPliesToMate(Value) & 1) == 0; }
+}
+
+// header of a tablebase file, followed by BlockCount + 1 block offsets from the start of the file and then the compressed blocks
+// win/draw/loss files hold 2 bits per position (0 draw, 1 win, 2 loss, 3 invalid), distance to mate files one TablebaseValue per position
+struct FTablebaseFileHeader
+{
+    static constexpr uint32 FileMagic = 0x42545848; // "HXTB"
+    static constexpr uint32 FileVersion = 1;
+    static constexpr uint32 BlockSize = 32768;
+
+    uint32 Magic = FileMagic;
+    uint32 Version = FileVersion;
+    // 0 for win/draw/loss, 1 for distance to mate
+    uint32 Kind = 0;
+    uint32 MaterialKey = 0;
+    uint64 PositionCount = 0;
+    // uncompressed bytes per block, the last block may be shorter
+    uint32 UncompressedBlockSize = BlockSize;
+    uint32 BlockCount = 0;
+    uint32 MaxPliesToMate = 0;
+    uint32 Reserved = 0;
+};
+static_assert(sizeof(FTablebaseFileHeader) == 40, "the block offsets after the header stay 8-byte aligned");
+
+// one search thread's last decompressed block of each kind, so neighbouring probes do not decompress again
+struct FTablebaseCache
+{
+    uint32 Keys[2] = {};
+    int64 Blocks[2] = {-1, -1};
+    TArray<uint8> Data[2];
+};
+
+// the tablebase files of a directory; a file is mapped the first time a search probes its material
+// probing is safe from any number of threads, each with its own cache
+class HEXACHESSENGINE_API FTablebase
+{
+public:
+
+    FTablebase() = default;
+    ~FTablebase();
+
+    FTablebase(const FTablebase&) = delete;
+    FTablebase& operator=(const FTablebase&) = delete;
+
+    // finds the .hxwdl and .hxdtm files of the directory without opening them; returns how many materials it found
+    int32 Open(const FString& Directory);
+
+    // positions with more pieces are never in the tablebase, checking this first saves the material lookup
+    int32 GetMaxPieces() const { return MaxPieces; }
+
+    // maps every file now and reads its block offsets, instead of the first probe of each material doing it mid-search;
+    // the compressed blocks stay on disk until a probe needs them; returns how many files are usable
+    int32 Prefetch() const;
+
+    // win, draw or loss for the side to move; false when the material has no win/draw/loss file
+    bool ProbeWdl(const PackedBoard& Position, FTablebaseCache& Cache, FTablebaseProbe& OutProbe) const;
+
+    // the same with the distance to mate; false when the material has no distance to mate file
+    bool ProbeDtm(const PackedBoard& Position, FTablebaseCache& Cache, FTablebaseProbe& OutProbe) const;
+
+    // the file name of a material's table of one kind, "KQvK.hxwdl" or "KQvK.hxdtm"
+    static FString GetFileName(const FTablebaseMaterial& Material, uint32 Kind);
+
+    // compresses the entries in blocks and writes them as a table file of the kind; Bytes holds 2-bit or 16-bit entries by kind
+    static bool WriteFile(const FString& Path, const FTablebaseMaterial& Material, uint32 Kind, const TArray<uint8>& Bytes, uint32 MaxPliesToMate);
+
+private:
+
+    struct FTableFile
+    {
+        FString Path;
+        FCriticalSection OpenLock;
+        // 0 not opened yet, 1 mapped or loaded, -1 unusable
+        std::atomic<int32> State{0};
+        IMappedFileHandle* MappedFile = nullptr;
+        IMappedFileRegion* MappedRegion = nullptr;
+        TArray<uint8> LoadedFile;
+        const uint8* Data = nullptr;
+        int64 Size = 0;
+        FTablebaseFileHeader Header;
+        const uint64* BlockOffsets = nullptr;
+    };
+
+    // maps the file on first use; false when it cannot be read
+    bool EnsureOpen(FTableFile& File) const;
+
+    // the uncompressed block holding a byte of the file's entries, through the cache
+    const uint8* GetBlock(FTableFile& File, uint32 Kind, int64 Block, FTablebaseCache& Cache) const;
+
+    bool Probe(const PackedBoard& Position, uint32 Kind, FTablebaseCache& Cache, FTablebaseProbe& OutProbe) const;
+
+    // by kind, then by material key
+    TMap<uint32, FTableFile*> Files[2];
+    int32 MaxPieces = 0;
+};
+
+// builds tables by retrograde analysis: mates and stalemates first, then every position all of whose moves are decided, one ply deeper per pass
+// the smaller materials a capture leads to are generated first and kept, so one generator can build a whole family of tables
+class HEXACHESSENGINE_API FTablebaseGenerator
+{
+public:
+
+    // generates the material and every material a capture leads to; OnPass reports the plies and the positions decided after every pass
+    void Generate(const FTablebaseMaterial& Material, const TFunction<void(const FString&, int32, int64)>& OnPass = nullptr);
+
+    // writes the win/draw/loss and the distance to mate file of a generated material into the directory
+    bool Write(const FTablebaseMaterial& Material, const FString& Directory) const;
+
+    // the generated table of a canonical material, one TablebaseValue per position; null before it was generated
+    const TArray<uint16>* Find(const FTablebaseMaterial& Material) const;
+
+    // counts of a generated table, for the log
+    void GetCounts(const FTablebaseMaterial& Material, int64& OutWins, int64& OutDraws, int64& OutLosses, int32& OutMaxPliesToMate) const;
+
+private:
+
+    // the value of a position after a move, from the point of view of the side to move there
+    uint16 GetChildValue(const FTablebaseMaterial& Material, const TArray<uint16>& Values, const PackedBoard& Child) const;
+
+    Board Rules;
+    TMap<uint32, TArray<uint16>> Tables;
+};